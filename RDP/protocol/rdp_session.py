@@ -16,11 +16,12 @@ import logging
 import os
 import time
 import struct
-import hashlib
 import secrets
 import json
 import ssl
 import socket
+import zlib
+from collections import deque
 from datetime import datetime, timezone, timedelta
 from pathlib import Path
 from typing import Dict, List, Optional, Any, Union, Set, Tuple, Callable
@@ -34,16 +35,41 @@ from cryptography.hazmat.backends import default_backend
 
 logger = logging.get_logger(__name__)
 
+# Native framing codec
+try:
+    import rdp_codec_native
+    RDP_CODEC_NATIVE_AVAILABLE = True
+except ImportError:
+    RDP_CODEC_NATIVE_AVAILABLE = False
+    logger.warning("Native RDP codec not available, using Python framing")
+
 # Configuration from environment
 RDP_PORT = int(os.getenv("RDP_PORT", "3389"))
 RDP_TIMEOUT = int(os.getenv("RDP_TIMEOUT", "30"))
 RDP_BUFFER_SIZE = int(os.getenv("RDP_BUFFER_SIZE", "8192"))
+RDP_RECEIVE_BUFFER_SIZE = int(os.getenv("RDP_RECEIVE_BUFFER_SIZE", "262144"))
 RDP_ENCRYPTION_LEVEL = os.getenv("RDP_ENCRYPTION_LEVEL", "high")
 RDP_COMPRESSION_ENABLED = os.getenv("RDP_COMPRESSION_ENABLED", "true").lower() == "true"
+RDP_COMPRESSION_LEVEL = int(os.getenv("RDP_COMPRESSION_LEVEL", "6"))
+RDP_COMPRESSION_MIN_SIZE = int(os.getenv("RDP_COMPRESSION_MIN_SIZE", "64"))
 RDP_CLIPBOARD_ENABLED = os.getenv("RDP_CLIPBOARD_ENABLED", "true").lower() == "true"
 RDP_AUDIO_ENABLED = os.getenv("RDP_AUDIO_ENABLED", "true").lower() == "true"
 RDP_PRINTER_ENABLED = os.getenv("RDP_PRINTER_ENABLED", "false").lower() == "true"
 
+# Wire framing: >HHHH (length incl. header, type word, channel, sequence).
+# The low byte of the type word is the packet type, the high bits are flags.
+RDP_HEADER_SIZE = 8
+RDP_MAX_PAYLOAD_SIZE = 0xFFFF - RDP_HEADER_SIZE
+RDP_PACKET_TYPE_MASK = 0x00FF
+RDP_FLAG_COMPRESSED = 0x4000
+RDP_FLAG_ENCRYPTED = 0x8000
+
+# Bulk compression: one raw deflate stream per channel and direction, each
+# packet ending on a sync flush whose 00 00 ff ff tail is not sent
+RDP_COMPRESSION_WINDOW_BITS = 15
+RDP_COMPRESSION_FLUSH_TAIL = b"\x00\x00\xff\xff"
+RDP_COMPRESSION_MAX_INPUT = RDP_MAX_PAYLOAD_SIZE - 256  # Room for deflate's worst-case expansion
+
 
 class RDPConnectionState(Enum):
     """RDP connection states"""
@@ -94,12 +120,34 @@ class RDPCapability(Enum):
     SMART_CARD = "smart_card"
 
 
+# Packet type codes carried in the low byte of the frame type word
+RDP_PACKET_TYPE_CODES = {
+    RDPPacketType.CONNECTION_REQUEST: 0x01,
+    RDPPacketType.CONNECTION_RESPONSE: 0x02,
+    RDPPacketType.AUTHENTICATION_REQUEST: 0x03,
+    RDPPacketType.AUTHENTICATION_RESPONSE: 0x04,
+    RDPPacketType.DATA: 0x05,
+    RDPPacketType.CONTROL: 0x06,
+    RDPPacketType.HEARTBEAT: 0x07,
+    RDPPacketType.DISCONNECT: 0x08,
+}
+RDP_PACKET_CODE_TYPES = {code: packet_type for packet_type, code in RDP_PACKET_TYPE_CODES.items()}
+
+# Channels whose traffic is bulk compressed; audio and video already carry codec-compressed data
+RDP_COMPRESSED_CHANNEL_TYPES = {
+    RDPChannelType.DATA,
+    RDPChannelType.CLIPBOARD,
+    RDPChannelType.PRINTER,
+    RDPChannelType.FILE_TRANSFER,
+}
+
+
 @dataclass
 class RDPPacket:
     """RDP protocol packet"""
     packet_type: RDPPacketType
     channel_id: int
-    data: bytes
+    data: Union[bytes, memoryview]  # Received payloads are views into the receive buffer
     sequence_number: int
     timestamp: datetime
     encrypted: bool = False
@@ -142,6 +190,86 @@ class RDPSession:
     metadata: Dict[str, Any] = field(default_factory=dict)
 
 
+class _FrameDecoder:
+    """Python stand-in for rdp_codec_native.FrameDecoder"""
+    
+    def __init__(self):
+        self.buffer = bytearray()
+        self.frames_decoded = 0
+    
+    @property
+    def pending(self) -> int:
+        return len(self.buffer)
+    
+    def feed(self, data: bytes) -> List[Tuple[int, int, int, memoryview]]:
+        self.buffer += data
+        frames = []
+        pos = 0
+        while len(self.buffer) - pos >= RDP_HEADER_SIZE:
+            length, frame_type, channel_id, sequence_number = struct.unpack_from(">HHHH", self.buffer, pos)
+            if length < RDP_HEADER_SIZE:
+                self.buffer.clear()
+                raise ValueError("Invalid RDP frame length")
+            if len(self.buffer) - pos < length:
+                break
+            payload = memoryview(bytes(self.buffer[pos + RDP_HEADER_SIZE:pos + length]))
+            frames.append((frame_type, channel_id, sequence_number, payload))
+            pos += length
+        del self.buffer[:pos]
+        self.frames_decoded += len(frames)
+        return frames
+    
+    def reset(self) -> None:
+        self.buffer.clear()
+
+
+class _BulkCompressor:
+    """Python stand-in for rdp_codec_native.BulkCompressor (same wire format)"""
+    
+    def __init__(self, level: int = RDP_COMPRESSION_LEVEL):
+        self.stream = zlib.compressobj(level, zlib.DEFLATED, -RDP_COMPRESSION_WINDOW_BITS)
+        self.packets = 0
+        self.bytes_in = 0
+        self.bytes_out = 0
+    
+    def compress(self, data: Union[bytes, memoryview]) -> bytes:
+        if len(data) == 0:
+            # First byte of an empty stored block; the decompressor's tail completes it
+            compressed = b"\x00"
+        else:
+            compressed = self.stream.compress(data) + self.stream.flush(zlib.Z_SYNC_FLUSH)
+            if compressed.endswith(RDP_COMPRESSION_FLUSH_TAIL):
+                compressed = compressed[:-len(RDP_COMPRESSION_FLUSH_TAIL)]
+        self.packets += 1
+        self.bytes_in += len(data)
+        self.bytes_out += len(compressed)
+        return compressed
+
+
+class _BulkDecompressor:
+    """Python stand-in for rdp_codec_native.BulkDecompressor (same wire format)"""
+    
+    def __init__(self):
+        self.stream = zlib.decompressobj(-RDP_COMPRESSION_WINDOW_BITS)
+        self.packets = 0
+        self.bytes_in = 0
+        self.bytes_out = 0
+    
+    def decompress(self, data: Union[bytes, memoryview], max_length: int = RDP_MAX_PAYLOAD_SIZE) -> bytes:
+        if len(data) == 0:
+            raise ValueError("Corrupt compressed packet")
+        try:
+            decompressed = self.stream.decompress(bytes(data) + RDP_COMPRESSION_FLUSH_TAIL, max_length + 1)
+        except zlib.error as e:
+            raise ValueError("Corrupt compressed packet") from e
+        if len(decompressed) > max_length or self.stream.unconsumed_tail:
+            raise ValueError("Decompressed packet exceeds max_length")
+        self.packets += 1
+        self.bytes_in += len(data)
+        self.bytes_out += len(decompressed)
+        return decompressed
+
+
 class RDPSessionManager:
     """RDP session protocol manager"""
     
@@ -165,6 +293,15 @@ class RDPSessionManager:
         self.server_private_key = None
         self.encryption_keys: Dict[str, bytes] = {}
         
+        # Framing state per client socket
+        self.frame_decoders: Dict[socket.socket, Any] = {}
+        self.received_frames: Dict[socket.socket, deque] = {}
+        self.session_sockets: Dict[str, socket.socket] = {}
+        # Compression and the write it feeds happen under one lock per
+        # socket, so frames reach the wire in the order their deflate
+        # history was built and partial writes never interleave
+        self.send_locks: Dict[socket.socket, asyncio.Lock] = {}
+        
         # Statistics
         self.connections_total = 0
         self.connections_active = 0
@@ -265,6 +402,7 @@ class RDPSessionManager:
             )
             
             self.active_sessions[session_id] = session
+            self.session_sockets[session_id] = client_socket
             
             # Process RDP protocol
             await self._process_rdp_protocol(client_socket, session)
@@ -304,12 +442,12 @@ class RDPSessionManager:
             session.connection_state = RDPConnectionState.NEGOTIATING
             
             # Receive connection request
-            request_data = await self._receive_packet(client_socket)
-            if not request_data:
+            request_packet = await self._receive_packet(client_socket)
+            if not request_packet:
                 raise ValueError("No connection request received")
             
             # Parse connection request
-            request = self._parse_connection_request(request_data)
+            request = self._parse_connection_request(request_packet.data)
             logger.info(f"Connection request: {request}")
             
             # Validate client capabilities
@@ -337,12 +475,12 @@ class RDPSessionManager:
             session.connection_state = RDPConnectionState.AUTHENTICATING
             
             # Receive authentication request
-            auth_data = await self._receive_packet(client_socket)
-            if not auth_data:
+            auth_packet = await self._receive_packet(client_socket)
+            if not auth_packet:
                 raise ValueError("No authentication request received")
             
             # Parse authentication request
-            auth_request = self._parse_authentication_request(auth_data)
+            auth_request = self._parse_authentication_request(auth_packet.data)
             
             # Validate credentials
             username = auth_request.get("username", "")
@@ -397,6 +535,12 @@ class RDPSessionManager:
             if RDPCapability.PRINTER in session.capabilities:
                 channels.append(RDPChannel(5, RDPChannelType.PRINTER, "printer", priority=60))
             
+            # Bulk compression on data-bearing channels
+            if RDPCapability.COMPRESSION in session.capabilities:
+                session.compression_context = {}
+                for channel in channels:
+                    channel.compression_enabled = channel.channel_type in RDP_COMPRESSED_CHANNEL_TYPES
+            
             session.channels = channels
             
             # Send channel establishment packet
@@ -425,14 +569,14 @@ class RDPSessionManager:
             while session.connection_state == RDPConnectionState.ACTIVE:
                 try:
                     # Receive packet with timeout
-                    packet_data = await asyncio.wait_for(
+                    packet = await asyncio.wait_for(
                         self._receive_packet(client_socket), 
                         timeout=1.0
                     )
                     
-                    if packet_data:
+                    if packet:
                         # Process packet
-                        await self._process_packet(client_socket, session, packet_data)
+                        await self._process_packet(client_socket, session, packet)
                         session.last_activity = datetime.now(timezone.utc)
                     
                     # Send periodic heartbeat
@@ -461,16 +605,10 @@ class RDPSessionManager:
                 except Exception as e:
                     logger.error(f"Disconnection callback error: {e}")
     
-    async def _process_packet(self, client_socket: socket.socket, session: RDPSession, packet_data: bytes):
+    async def _process_packet(self, client_socket: socket.socket, session: RDPSession, packet: RDPPacket):
         """Process incoming RDP packet"""
         try:
-            # Parse packet
-            packet = self._parse_packet(packet_data)
-            if not packet:
-                return
-            
             self.packets_received += 1
-            self.bytes_received += len(packet_data)
             
             # Decrypt if necessary
             if packet.encrypted and session.encryption_key:
@@ -479,7 +617,7 @@ class RDPSessionManager:
             
             # Decompress if necessary
             if packet.compressed:
-                packet.data = self._decompress_data(packet.data)
+                packet.data = self._decompress_data(session, packet.channel_id, packet.data)
                 packet.compressed = False
             
             # Handle packet by type
@@ -524,7 +662,7 @@ class RDPSessionManager:
     async def _handle_control_packet(self, client_socket: socket.socket, session: RDPSession, packet: RDPPacket):
         """Handle control packet"""
         try:
-            control_data = json.loads(packet.data.decode())
+            control_data = json.loads(bytes(packet.data))
             command = control_data.get("command")
             
             if command == "resize_display":
@@ -543,7 +681,7 @@ class RDPSessionManager:
                     sequence_number=packet.sequence_number + 1,
                     timestamp=datetime.now(timezone.utc)
                 )
-                await self._send_packet(client_socket, response_packet)
+                await self._send_packet(client_socket, response_packet, session)
             
             elif command == "heartbeat":
                 # Respond to heartbeat
@@ -584,86 +722,152 @@ class RDPSessionManager:
                 timestamp=datetime.now(timezone.utc)
             )
             
-            await self._send_packet(client_socket, packet)
+            await self._send_packet(client_socket, packet, session)
             
         except Exception as e:
             logger.error(f"Error sending heartbeat: {e}")
     
-    async def _receive_packet(self, client_socket: socket.socket) -> Optional[bytes]:
+    async def _receive_packet(self, client_socket: socket.socket) -> Optional[RDPPacket]:
         """Receive packet from client"""
         try:
-            # Read packet header (8 bytes)
-            header = await asyncio.get_event_loop().sock_recv(client_socket, 8)
-            if not header:
-                return None
-            
-            # Parse header
-            packet_length, packet_type, channel_id, sequence_number = struct.unpack(">HHHH", header)
-            
-            # Read packet data
-            data_length = packet_length - 8
-            if data_length > 0:
-                data = await asyncio.get_event_loop().sock_recv(client_socket, data_length)
-                return header + data
+            frames = self.received_frames.setdefault(client_socket, deque())
+            
+            # One large read usually completes many frames; drain them first
+            while not frames:
+                decoder = self.frame_decoders.get(client_socket)
+                if decoder is None:
+                    decoder = rdp_codec_native.FrameDecoder() if RDP_CODEC_NATIVE_AVAILABLE else _FrameDecoder()
+                    self.frame_decoders[client_socket] = decoder
+                
+                data = await asyncio.get_event_loop().sock_recv(client_socket, RDP_RECEIVE_BUFFER_SIZE)
+                if not data:
+                    return None
+                
+                self.bytes_received += len(data)
+                frames.extend(decoder.feed(data))
             
-            return header
+            return self._parse_packet(frames.popleft())
             
         except Exception as e:
             logger.error(f"Error receiving packet: {e}")
             return None
     
-    async def _send_packet(self, client_socket: socket.socket, packet: RDPPacket):
+    async def _send_packet(self, client_socket: socket.socket, packet: RDPPacket, session: Optional[RDPSession] = None):
         """Send packet to client"""
+        await self._send_packets(client_socket, [packet], session)
+    
+    async def _send_packets(self, client_socket: socket.socket, packets: List[RDPPacket], session: Optional[RDPSession] = None):
+        """Send packets to client, coalesced into as few writes as possible"""
         try:
-            # Serialize packet
-            packet_data = self._serialize_packet(packet)
-            
-            # Send data
-            await asyncio.get_event_loop().sock_sendall(client_socket, packet_data)
+            lock = self.send_locks.setdefault(client_socket, asyncio.Lock())
+            async with lock:
+                # Reject the batch before any packet advances a channel's deflate history
+                for packet in packets:
+                    if len(packet.data) > RDP_MAX_PAYLOAD_SIZE:
+                        raise ValueError(f"RDP payload too large: {len(packet.data)} bytes")
+                
+                # Compress channel data
+                if session is not None:
+                    for packet in packets:
+                        self._compress_packet(session, packet)
+                
+                # Serialize packets
+                frames = [self._serialize_packet(packet) for packet in packets]
+                total_size = sum(RDP_HEADER_SIZE + len(frame[3]) for frame in frames)
+                
+                # Send data
+                if RDP_CODEC_NATIVE_AVAILABLE:
+                    offset = 0
+                    while offset < total_size:
+                        sent = rdp_codec_native.send_frames(client_socket.fileno(), frames, offset)
+                        if sent == 0:
+                            await self._wait_writable(client_socket)
+                        offset += sent
+                else:
+                    packet_data = b"".join(
+                        struct.pack(">HHHH", RDP_HEADER_SIZE + len(data), frame_type, channel_id, sequence_number) + bytes(data)
+                        for frame_type, channel_id, sequence_number, data in frames
+                    )
+                    await asyncio.get_event_loop().sock_sendall(client_socket, packet_data)
             
-            self.packets_sent += 1
-            self.bytes_sent += len(packet_data)
+            self.packets_sent += len(frames)
+            self.bytes_sent += total_size
             
         except Exception as e:
             logger.error(f"Error sending packet: {e}")
     
-    def _serialize_packet(self, packet: RDPPacket) -> bytes:
-        """Serialize RDP packet"""
+    async def send_channel_data(self, session_id: str, channel_id: int, data: bytes,
+                                packet_type: RDPPacketType = RDPPacketType.DATA) -> bool:
+        """Send data to a session's client on one of its channels
+        
+        Data, clipboard, printer and file transfer traffic goes out here and
+        is bulk compressed when the channel negotiated compression.
+        """
+        session = self.active_sessions.get(session_id)
+        client_socket = self.session_sockets.get(session_id)
+        if session is None or client_socket is None:
+            logger.warning(f"Send to unknown session {session_id}")
+            return False
+        
+        channel = next((c for c in session.channels if c.channel_id == channel_id), None)
+        if channel is None or not channel.is_active:
+            logger.warning(f"Send on unknown channel {channel_id} of session {session_id}")
+            return False
+        
+        packet = RDPPacket(
+            packet_type=packet_type,
+            channel_id=channel_id,
+            data=data,
+            sequence_number=0,
+            timestamp=datetime.now(timezone.utc)
+        )
+        await self._send_packet(client_socket, packet, session)
+        channel.last_activity = datetime.now(timezone.utc)
+        return True
+    
+    async def _wait_writable(self, client_socket: socket.socket):
+        """Wait until the socket can take more data"""
+        loop = asyncio.get_event_loop()
+        writable = loop.create_future()
+        fd = client_socket.fileno()
+        loop.add_writer(fd, lambda: writable.done() or writable.set_result(None))
         try:
-            # Create header
-            packet_length = 8 + len(packet.data)
-            header = struct.pack(">HHHH", packet_length, packet.packet_type.value, packet.channel_id, packet.sequence_number)
-            
-            # Add checksum if not present
-            if not packet.checksum:
-                packet.checksum = hashlib.sha256(packet.data).hexdigest()[:16]
-            
-            # Combine header and data
-            return header + packet.data
-            
-        except Exception as e:
-            logger.error(f"Error serializing packet: {e}")
-            return b""
+            await writable
+        finally:
+            loop.remove_writer(fd)
     
-    def _parse_packet(self, packet_data: bytes) -> Optional[RDPPacket]:
-        """Parse RDP packet"""
+    def _serialize_packet(self, packet: RDPPacket) -> Tuple[int, int, int, Union[bytes, memoryview]]:
+        """Serialize RDP packet into a (type word, channel, sequence, payload) frame"""
+        if len(packet.data) > RDP_MAX_PAYLOAD_SIZE:
+            raise ValueError(f"RDP payload too large: {len(packet.data)} bytes")
+        
+        frame_type = RDP_PACKET_TYPE_CODES[packet.packet_type]
+        if packet.compressed:
+            frame_type |= RDP_FLAG_COMPRESSED
+        if packet.encrypted:
+            frame_type |= RDP_FLAG_ENCRYPTED
+        
+        return frame_type, packet.channel_id, packet.sequence_number & 0xFFFF, packet.data
+    
+    def _parse_packet(self, frame: Tuple[int, int, int, memoryview]) -> Optional[RDPPacket]:
+        """Parse RDP packet from a decoded frame"""
         try:
-            if len(packet_data) < 8:
-                return None
+            frame_type, channel_id, sequence_number, data = frame
             
-            # Parse header
-            packet_length, packet_type, channel_id, sequence_number = struct.unpack(">HHHH", packet_data[:8])
-            
-            # Extract data
-            data = packet_data[8:packet_length]
+            packet_type = RDP_PACKET_CODE_TYPES.get(frame_type & RDP_PACKET_TYPE_MASK)
+            if packet_type is None:
+                logger.warning(f"Unknown RDP packet type {frame_type & RDP_PACKET_TYPE_MASK:#04x}")
+                return None
             
             # Create packet object
             packet = RDPPacket(
-                packet_type=RDPPacketType(packet_type),
+                packet_type=packet_type,
                 channel_id=channel_id,
                 data=data,
                 sequence_number=sequence_number,
-                timestamp=datetime.now(timezone.utc)
+                timestamp=datetime.now(timezone.utc),
+                encrypted=bool(frame_type & RDP_FLAG_ENCRYPTED),
+                compressed=bool(frame_type & RDP_FLAG_COMPRESSED)
             )
             
             return packet
@@ -693,7 +897,7 @@ class RDPSessionManager:
         try:
             # In production, this would parse actual RDP authentication
             # For now, return mock data
-            return json.loads(data.decode())
+            return json.loads(bytes(data))
         except Exception as e:
             logger.error(f"Error parsing authentication request: {e}")
             return {}
@@ -734,7 +938,8 @@ class RDPSessionManager:
                     "channel_id": channel.channel_id,
                     "type": channel.channel_type.value,
                     "name": channel.name,
-                    "priority": channel.priority
+                    "priority": channel.priority,
+                    "compression": channel.compression_enabled
                 })
             
             packet_data = {
@@ -748,7 +953,7 @@ class RDPSessionManager:
     
     def _get_supported_capabilities(self) -> Set[RDPCapability]:
         """Get server supported capabilities"""
-        capabilities = {RDPCapability.BITMAP_CACHE, RDPCapability.COMPRESSION}
+        capabilities = {RDPCapability.BITMAP_CACHE}
         
         if RDP_COMPRESSION_ENABLED:
             capabilities.add(RDPCapability.COMPRESSION)
@@ -830,25 +1035,82 @@ class RDPSessionManager:
             logger.error(f"Error decrypting data: {e}")
             return encrypted_data
     
-    def _compress_data(self, data: bytes) -> bytes:
-        """Compress data"""
+    def _compression_streams(self, session: RDPSession, channel_id: int) -> Dict[str, Any]:
+        """Get the compression streams of a channel, creating them on first use"""
+        if session.compression_context is None:
+            session.compression_context = {}
+        
+        streams = session.compression_context.get(channel_id)
+        if streams is None:
+            if RDP_CODEC_NATIVE_AVAILABLE:
+                streams = {
+                    "compressor": rdp_codec_native.BulkCompressor(RDP_COMPRESSION_LEVEL),
+                    "decompressor": rdp_codec_native.BulkDecompressor()
+                }
+            else:
+                streams = {
+                    "compressor": _BulkCompressor(RDP_COMPRESSION_LEVEL),
+                    "decompressor": _BulkDecompressor()
+                }
+            session.compression_context[channel_id] = streams
+        return streams
+    
+    def _compress_packet(self, session: RDPSession, packet: RDPPacket) -> None:
+        """Compress an outgoing packet if its channel negotiated compression"""
+        if packet.compressed or RDPCapability.COMPRESSION not in session.capabilities:
+            return
+        
+        channel = next((c for c in session.channels if c.channel_id == packet.channel_id), None)
+        if not channel or not channel.compression_enabled:
+            return
+        
+        # Decided before touching the stream so both ends' history stays in step
+        if not RDP_COMPRESSION_MIN_SIZE <= len(packet.data) <= RDP_COMPRESSION_MAX_INPUT:
+            return
+        
+        packet.data = self._compress_data(session, packet.channel_id, packet.data)
+        packet.compressed = True
+    
+    def _compress_data(self, session: RDPSession, channel_id: int, data: bytes) -> bytes:
+        """Compress data against the channel's send history"""
         try:
-            # In production, this would use actual compression
-            # For now, return data as-is
-            return data
+            return self._compression_streams(session, channel_id)["compressor"].compress(data)
         except Exception as e:
             logger.error(f"Error compressing data: {e}")
-            return data
+            raise
     
-    def _decompress_data(self, compressed_data: bytes) -> bytes:
-        """Decompress data"""
+    def _decompress_data(self, session: RDPSession, channel_id: int, compressed_data: bytes) -> bytes:
+        """Decompress data against the channel's receive history"""
         try:
-            # In production, this would use actual decompression
-            # For now, return data as-is
-            return compressed_data
+            if RDPCapability.COMPRESSION not in session.capabilities:
+                raise ValueError("Compressed packet on a session without compression")
+            
+            return self._compression_streams(session, channel_id)["decompressor"].decompress(compressed_data)
         except Exception as e:
             logger.error(f"Error decompressing data: {e}")
-            return compressed_data
+            raise
+    
+    def _compression_statistics(self, session: RDPSession) -> Dict[str, Any]:
+        """Per-channel compression statistics"""
+        statistics = {}
+        for channel_id, streams in (session.compression_context or {}).items():
+            compressor = streams["compressor"]
+            decompressor = streams["decompressor"]
+            statistics[str(channel_id)] = {
+                "sent": {
+                    "packets": compressor.packets,
+                    "bytes_in": compressor.bytes_in,
+                    "bytes_out": compressor.bytes_out,
+                    "ratio": compressor.bytes_out / compressor.bytes_in if compressor.bytes_in else 1.0
+                },
+                "received": {
+                    "packets": decompressor.packets,
+                    "bytes_in": decompressor.bytes_in,
+                    "bytes_out": decompressor.bytes_out,
+                    "ratio": decompressor.bytes_in / decompressor.bytes_out if decompressor.bytes_out else 1.0
+                }
+            }
+        return statistics
     
     def _serialize_capabilities(self, capabilities: Set[RDPCapability]) -> bytes:
         """Serialize capabilities to bytes"""
@@ -871,11 +1133,17 @@ class RDPSessionManager:
             # Remove session
             if session_id in self.active_sessions:
                 del self.active_sessions[session_id]
+            self.session_sockets.pop(session_id, None)
             
             # Remove encryption key
             if session_id in self.encryption_keys:
                 del self.encryption_keys[session_id]
             
+            # Drop framing state
+            self.frame_decoders.pop(client_socket, None)
+            self.received_frames.pop(client_socket, None)
+            self.send_locks.pop(client_socket, None)
+            
             # Close socket
             if client_socket:
                 client_socket.close()
@@ -944,7 +1212,8 @@ class RDPSessionManager:
                     "username": session.username,
                     "connection_state": session.connection_state.value,
                     "channels": len(session.channels),
-                    "created_at": session.created_at.isoformat()
+                    "created_at": session.created_at.isoformat(),
+                    "compression": self._compression_statistics(session)
                 }
                 for session in self.active_sessions.values()
             ]
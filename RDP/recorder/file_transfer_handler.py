@@ -20,11 +20,12 @@ import shutil
 import tempfile
 from datetime import datetime, timezone
 from pathlib import Path
-from typing import Dict, List, Optional, Any, Callable, Union, BinaryIO
+from typing import Dict, List, Optional, Any, Callable, Union, BinaryIO, Tuple
 from dataclasses import dataclass, field
 from enum import Enum
 import json
 import uuid
+import errno
 import threading
 import hashlib
 import base64
@@ -48,6 +49,14 @@ except ImportError:
 
 logger = logging.get_logger(__name__)
 
+# Native kernel-side copy engine
+try:
+    import file_transfer_native
+    FILE_TRANSFER_NATIVE_AVAILABLE = True
+except ImportError:
+    FILE_TRANSFER_NATIVE_AVAILABLE = False
+    logger.warning("Native file transfer module not available, using Python copy")
+
 # Configuration from environment
 FILE_TRANSFER_LOG_PATH = Path(os.getenv("FILE_TRANSFER_LOG_PATH", "/var/log/lucid/file_transfer"))
 FILE_TRANSFER_CACHE_PATH = Path(os.getenv("FILE_TRANSFER_CACHE_PATH", "/tmp/lucid/file_transfer"))
@@ -137,6 +146,18 @@ class FileTransferConfig:
     metadata: Dict[str, Any] = field(default_factory=dict)
 
 
+class _TransferProgress:
+    """Python stand-in for file_transfer_native.TransferProgress"""
+    
+    def __init__(self):
+        self.bytes_done = 0
+        self.total = 0
+        self.cancelled = False
+    
+    def cancel(self) -> None:
+        self.cancelled = True
+
+
 class FileTransferHandler:
     """
     File transfer handler for Lucid RDP.
@@ -157,6 +178,7 @@ class FileTransferHandler:
         self.active_transfers: Dict[str, FileTransferEvent] = {}
         self.transfer_history: List[FileTransferEvent] = []
         self.session_files: Dict[str, List[str]] = {}  # session_id -> file_paths
+        self.transfer_progress: Dict[str, Any] = {}  # transfer_id -> progress counter
         
         # Security filters
         self.file_filters: List[Callable] = []
@@ -323,8 +345,8 @@ class FileTransferHandler:
             # Get MIME type
             mime_type = mimetypes.guess_type(file_path)[0] or "application/octet-stream"
             
-            # Calculate file hash
-            file_hash = await self._calculate_file_hash(file_path)
+            # Hash is computed by the copy itself, so the file is read once
+            file_hash = ""
             
             # Validate file
             if not await self._validate_file(file_path, file_size, mime_type):
@@ -386,8 +408,8 @@ class FileTransferHandler:
             # Get MIME type
             mime_type = mimetypes.guess_type(file_path)[0] or "application/octet-stream"
             
-            # Calculate file hash
-            file_hash = await self._calculate_file_hash(file_path)
+            # Hash is computed by the copy itself, so the file is read once
+            file_hash = ""
             
             # Validate file
             if not await self._validate_file(file_path, file_size, mime_type):
@@ -430,6 +452,11 @@ class FileTransferHandler:
             transfer = self.active_transfers[transfer_id]
             transfer.status = FileTransferStatus.CANCELLED
             
+            # Stop the copy at its next chunk
+            progress = self.transfer_progress.get(transfer_id)
+            if progress is not None:
+                progress.cancel()
+            
             # Remove from active transfers
             del self.active_transfers[transfer_id]
             
@@ -452,6 +479,10 @@ class FileTransferHandler:
             # Check active transfers
             if transfer_id in self.active_transfers:
                 transfer = self.active_transfers[transfer_id]
+                progress = self.transfer_progress.get(transfer_id)
+                percent = 0
+                if progress is not None and progress.total:
+                    percent = int(progress.bytes_done * 100 / progress.total)
                 return {
                     "transfer_id": transfer.event_id,
                     "status": transfer.status.value,
@@ -459,7 +490,7 @@ class FileTransferHandler:
                     "file_name": transfer.file_name,
                     "file_size": transfer.file_size,
                     "mime_type": transfer.mime_type,
-                    "progress": 0,  # Would be calculated from actual transfer
+                    "progress": percent,
                     "transfer_speed": transfer.transfer_speed,
                     "timestamp": transfer.timestamp.isoformat()
                 }
@@ -536,19 +567,6 @@ class FileTransferHandler:
             logger.error(f"File validation error: {e}")
             return False
     
-    async def _calculate_file_hash(self, file_path: str) -> str:
-        """Calculate SHA-256 hash of file"""
-        try:
-            hash_sha256 = hashlib.sha256()
-            with open(file_path, "rb") as f:
-                for chunk in iter(lambda: f.read(4096), b""):
-                    hash_sha256.update(chunk)
-            return hash_sha256.hexdigest()
-            
-        except Exception as e:
-            logger.error(f"Failed to calculate file hash: {e}")
-            return ""
-    
     async def _start_transfer(self, transfer_event: FileTransferEvent, target_path: str) -> None:
         """Start file transfer"""
         try:
@@ -571,27 +589,66 @@ class FileTransferHandler:
             transfer_event.status = FileTransferStatus.FAILED
             transfer_event.reason = str(e)
     
+    def _copy_and_hash(self, source_path: str, target_path: str, progress: Any) -> Tuple[int, str, str]:
+        """Copy a file and hash the copied bytes in one pass (runs in a worker thread)"""
+        if FILE_TRANSFER_NATIVE_AVAILABLE:
+            return file_transfer_native.copy_file(source_path, target_path, hash=True, progress=progress)
+        
+        hash_sha256 = hashlib.sha256()
+        bytes_copied = 0
+        progress.total = os.path.getsize(source_path)
+        with open(source_path, "rb") as src, open(os.open(target_path, os.O_WRONLY | os.O_CREAT, 0o644), "wb") as dst:
+            # Truncate only once the target is known not to be the source
+            if os.path.samestat(os.fstat(src.fileno()), os.fstat(dst.fileno())):
+                raise shutil.SameFileError(f"{source_path!r} and {target_path!r} are the same file")
+            dst.truncate(0)
+            for chunk in iter(lambda: src.read(self.config.chunk_size), b""):
+                if progress.cancelled:
+                    raise OSError(errno.ECANCELED, os.strerror(errno.ECANCELED), target_path)
+                hash_sha256.update(chunk)
+                dst.write(chunk)
+                bytes_copied += len(chunk)
+                progress.bytes_done = bytes_copied
+        return bytes_copied, hash_sha256.hexdigest(), "read_write"
+    
     async def _transfer_file(self, transfer_event: FileTransferEvent, target_path: str) -> None:
         """Transfer file with progress monitoring"""
         try:
             start_time = time.time()
-            bytes_transferred = 0
             
             # Create target directory
             target_path_obj = Path(target_path)
             target_path_obj.parent.mkdir(parents=True, exist_ok=True)
             
-            # Copy file
-            shutil.copy2(transfer_event.file_path, target_path)
+            # Copy and hash off the event loop
+            if FILE_TRANSFER_NATIVE_AVAILABLE:
+                progress = file_transfer_native.TransferProgress()
+            else:
+                progress = _TransferProgress()
+            self.transfer_progress[transfer_event.event_id] = progress
+            
+            loop = asyncio.get_running_loop()
+            bytes_transferred, file_hash, copy_method = await loop.run_in_executor(
+                None, self._copy_and_hash, transfer_event.file_path, target_path, progress
+            )
+            shutil.copystat(transfer_event.file_path, target_path)
+            
+            # Cancelled after the last chunk was already written
+            if transfer_event.status == FileTransferStatus.CANCELLED:
+                target_path_obj.unlink(missing_ok=True)
+                return
             
             # Calculate transfer speed
             end_time = time.time()
             transfer_time = end_time - start_time
-            transfer_speed = transfer_event.file_size / transfer_time if transfer_time > 0 else 0
+            transfer_speed = bytes_transferred / transfer_time if transfer_time > 0 else 0
             
             # Update transfer event
             transfer_event.status = FileTransferStatus.COMPLETED
             transfer_event.transfer_speed = transfer_speed
+            transfer_event.file_hash = file_hash
+            transfer_event.metadata["bytes_transferred"] = bytes_transferred
+            transfer_event.metadata["copy_method"] = copy_method
             
             # Remove from active transfers
             if transfer_event.event_id in self.active_transfers:
@@ -611,6 +668,12 @@ class FileTransferHandler:
             logger.info(f"Transfer completed: {transfer_event.event_id} ({transfer_speed:.2f} bytes/sec)")
             
         except Exception as e:
+            # cancel_transfer has already moved the event to history
+            if transfer_event.status == FileTransferStatus.CANCELLED:
+                Path(target_path).unlink(missing_ok=True)
+                logger.info(f"Transfer {transfer_event.event_id} stopped after cancel")
+                return
+            
             logger.error(f"Transfer failed: {e}")
             transfer_event.status = FileTransferStatus.FAILED
             transfer_event.reason = str(e)
@@ -624,6 +687,9 @@ class FileTransferHandler:
             
             # Notify callbacks
             await self._notify_callbacks("transfer_failed", transfer_event)
+        
+        finally:
+            self.transfer_progress.pop(transfer_event.event_id, None)
     
     async def _start_monitoring(self) -> None:
         """Start transfer monitoring"""
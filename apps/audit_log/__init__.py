@@ -0,0 +1,13 @@
+# Audit Log Module
+# Hash-chained binary session audit log
+
+"""
+File: /app/apps/audit_log/__init__.py
+x-lucid-file-path: /app/apps/audit_log/__init__.py
+x-lucid-file-type: python
+
+Audit Log package for Lucid RDP.
+Contains the native append-only audit log used by the session recorder.
+"""
+
+__all__ = []
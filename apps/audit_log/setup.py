@@ -0,0 +1,51 @@
+#!/usr/bin/env python3
+"""
+File: /app/apps/audit_log/setup.py
+x-lucid-file-path: /app/apps/audit_log/setup.py
+x-lucid-file-type: python
+
+Setup script for native RDP codec extension
+"""
+
+from setuptools import setup, Extension
+
+# Define the extension module
+audit_log_native = Extension(
+    'audit_log_native',
+    sources=[
+        'src/audit_log.c',
+        'src/record_log.c'
+    ],
+    include_dirs=[
+        'src/'
+    ],
+    libraries=['crypto'],
+    library_dirs=[],
+    extra_compile_args=[
+        '-O3',
+        '-Wall',
+        '-Wextra',
+        '-std=c99',
+        '-fPIC'
+    ],
+    extra_link_args=['-shared']
+)
+
+setup(
+    name='audit-log-native',
+    version='0.1.0',
+    description='Native audit log extension for Lucid RDP',
+    ext_modules=[audit_log_native],
+    python_requires='>=3.8',
+    classifiers=[
+        'Development Status :: 3 - Alpha',
+        'Intended Audience :: Developers',
+        'License :: OSI Approved :: MIT License',
+        'Programming Language :: C',
+        'Programming Language :: Python :: 3',
+        'Programming Language :: Python :: 3.8',
+        'Programming Language :: Python :: 3.9',
+        'Programming Language :: Python :: 3.10',
+        'Programming Language :: Python :: 3.11',
+    ],
+)
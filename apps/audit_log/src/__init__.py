@@ -0,0 +1,13 @@
+# Audit Log Source Module
+# Audit log native source code components
+
+"""
+File: /app/apps/audit_log/src/__init__.py
+x-lucid-file-path: /app/apps/audit_log/src/__init__.py
+x-lucid-file-type: python
+
+Audit Log Source package for Lucid RDP.
+Contains audit log native source code and C implementations.
+"""
+
+__all__ = []
@@ -0,0 +1,723 @@
+/*
+ * Native audit log extension for Lucid RDP
+ * Append-only session audit log of fixed-header binary records linked by a
+ * SHA-256 hash chain. Batches are hashed and written in one pass without
+ * the GIL and made durable with a single fdatasync (group commit); the
+ * reader maps the file and answers time/session range queries
+ */
+
+#define _GNU_SOURCE
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <pythread.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "audit_log.h"
+#include "record_log.h"
+
+typedef struct {
+    PyObject_HEAD
+    int fd;
+    int sync;
+    uint64_t offset;          // End of the last committed record
+    uint64_t next_sequence;
+    uint64_t last_timestamp;
+    uint8_t last_hash[AUDIT_HASH_SIZE];
+    PyThread_type_lock lock;  // Serializes appends, taken without the GIL
+} AuditLogWriterObject;
+
+typedef struct {
+    PyObject_HEAD
+    uint8_t *map;
+    size_t size;
+    size_t consumed;   // Bytes covered by well-formed records
+    size_t *offsets;
+    size_t count;
+} AuditLogReaderObject;
+
+// One parsed (timestamp_us, event_type, session_id, payload) tuple
+typedef struct {
+    uint64_t timestamp_us;
+    int event_type;
+    const char *session_id;  // Borrowed from the tuple's str
+    Py_ssize_t session_len;
+    Py_buffer payload;
+    size_t offset;
+} pending_record_t;
+
+static PyTypeObject AuditLogWriterType;
+static PyTypeObject AuditLogReaderType;
+
+// Forward declarations
+static PyObject* AuditLogWriter_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
+static int AuditLogWriter_init(AuditLogWriterObject *self, PyObject *args, PyObject *kwds);
+static void AuditLogWriter_dealloc(AuditLogWriterObject *self);
+static PyObject* AuditLogWriter_append(AuditLogWriterObject *self, PyObject *args);
+static PyObject* AuditLogWriter_close(AuditLogWriterObject *self, PyObject *args);
+static PyObject* AuditLogReader_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
+static int AuditLogReader_init(AuditLogReaderObject *self, PyObject *args, PyObject *kwds);
+static void AuditLogReader_dealloc(AuditLogReaderObject *self);
+static PyObject* AuditLogReader_range(AuditLogReaderObject *self, PyObject *args, PyObject *kwds);
+static PyObject* AuditLogReader_verify(AuditLogReaderObject *self, PyObject *args);
+static Py_ssize_t AuditLogReader_length(AuditLogReaderObject *self);
+
+static PyObject* hash_to_hex(const uint8_t hash[AUDIT_HASH_SIZE]) {
+    static const char digits[] = "0123456789abcdef";
+    char hex[AUDIT_HEX_SIZE];
+
+    for (int i = 0; i < AUDIT_HASH_SIZE; i++) {
+        hex[i * 2] = digits[hash[i] >> 4];
+        hex[i * 2 + 1] = digits[hash[i] & 0x0f];
+    }
+    return PyUnicode_FromStringAndSize(hex, AUDIT_HEX_SIZE);
+}
+
+// Method definitions
+static PyMethodDef AuditLogWriter_methods[] = {
+    {"append", (PyCFunction)AuditLogWriter_append, METH_VARARGS,
+     "Append [(timestamp_us, event_type, session_id, payload), ...] as one group commit; "
+     "returns the record hashes as hex"},
+    {"close", (PyCFunction)AuditLogWriter_close, METH_NOARGS, "Close the log file"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyObject* AuditLogWriter_get_sequence(AuditLogWriterObject *self, void *closure) {
+    return PyLong_FromUnsignedLongLong(self->next_sequence);
+}
+
+static PyObject* AuditLogWriter_get_last_hash(AuditLogWriterObject *self, void *closure) {
+    if (self->next_sequence == 0) {
+        Py_RETURN_NONE;
+    }
+    return hash_to_hex(self->last_hash);
+}
+
+static PyObject* AuditLogWriter_get_size(AuditLogWriterObject *self, void *closure) {
+    return PyLong_FromUnsignedLongLong(self->offset);
+}
+
+static PyObject* AuditLogWriter_get_closed(AuditLogWriterObject *self, void *closure) {
+    return PyBool_FromLong(self->fd < 0);
+}
+
+static PyGetSetDef AuditLogWriter_getset[] = {
+    {"sequence", (getter)AuditLogWriter_get_sequence, NULL, "Records in the log, and the next sequence number", NULL},
+    {"last_hash", (getter)AuditLogWriter_get_last_hash, NULL, "Hash of the last record as hex, or None", NULL},
+    {"size", (getter)AuditLogWriter_get_size, NULL, "Committed bytes", NULL},
+    {"closed", (getter)AuditLogWriter_get_closed, NULL, "Whether close() was called", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PyMethodDef AuditLogReader_methods[] = {
+    {"range", (PyCFunction)(void(*)(void))AuditLogReader_range, METH_VARARGS | METH_KEYWORDS,
+     "Records with start_us <= timestamp <= end_us, optionally for one session_id, as "
+     "[(sequence, timestamp_us, event_type, session_id, payload, hash), ...]"},
+    {"verify", (PyCFunction)AuditLogReader_verify, METH_NOARGS,
+     "Index of the first record that breaks the hash chain, or None if intact"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyObject* AuditLogReader_get_last_hash(AuditLogReaderObject *self, void *closure) {
+    if (self->count == 0) {
+        Py_RETURN_NONE;
+    }
+    return hash_to_hex(self->map + self->offsets[self->count - 1] + AUDIT_HASHED_HEADER_SIZE);
+}
+
+static PyGetSetDef AuditLogReader_getset[] = {
+    {"last_hash", (getter)AuditLogReader_get_last_hash, NULL, "Hash of the last record as hex, or None", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PySequenceMethods AuditLogReader_as_sequence = {
+    .sq_length = (lenfunc)AuditLogReader_length,
+};
+
+// Type definition
+static PyTypeObject AuditLogWriterType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "audit_log_native.AuditLogWriter",
+    .tp_doc = "Append-only writer of a hash-chained audit log file",
+    .tp_basicsize = sizeof(AuditLogWriterObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = AuditLogWriter_new,
+    .tp_init = (initproc)AuditLogWriter_init,
+    .tp_dealloc = (destructor)AuditLogWriter_dealloc,
+    .tp_methods = AuditLogWriter_methods,
+    .tp_getset = AuditLogWriter_getset,
+};
+
+static PyTypeObject AuditLogReaderType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "audit_log_native.AuditLogReader",
+    .tp_doc = "Memory-mapped snapshot of an audit log file",
+    .tp_basicsize = sizeof(AuditLogReaderObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = AuditLogReader_new,
+    .tp_init = (initproc)AuditLogReader_init,
+    .tp_dealloc = (destructor)AuditLogReader_dealloc,
+    .tp_methods = AuditLogReader_methods,
+    .tp_getset = AuditLogReader_getset,
+    .tp_as_sequence = &AuditLogReader_as_sequence,
+};
+
+static PyObject* AuditLogWriter_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
+    AuditLogWriterObject *self = (AuditLogWriterObject*)type->tp_alloc(type, 0);
+    if (self == NULL) {
+        return NULL;
+    }
+    self->fd = -1;
+    self->lock = PyThread_allocate_lock();
+    if (self->lock == NULL) {
+        Py_DECREF(self);
+        return PyErr_NoMemory();
+    }
+    return (PyObject*)self;
+}
+
+// Runs without the GIL: open the log and pick up the chain from its last
+// record. A torn tail from a crash mid-append, including a zero-filled
+// one, is cut off; anything else that does not parse is reported as
+// EBADMSG rather than overwritten.
+static int open_log(AuditLogWriterObject *self, const char *path) {
+    struct stat st;
+    int saved_errno;
+
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, AUDIT_FILE_MODE);
+    if (fd < 0) {
+        return -1;
+    }
+    if (fstat(fd, &st) != 0) {
+        goto error;
+    }
+
+    size_t size = (size_t)st.st_size;
+    size_t consumed = 0;
+    if (size > 0) {
+        uint8_t *map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (map == MAP_FAILED) {
+            goto error;
+        }
+
+        size_t count = audit_scan(map, size, NULL, 0, &consumed);
+        audit_header_t header;
+        if (consumed < size && !audit_tail_torn(map + consumed, size - consumed)) {
+            munmap(map, size);
+            errno = EBADMSG;
+            goto error;
+        }
+        if (count > 0) {
+            size_t last = 0, pos = 0;
+            while (pos < consumed) {
+                audit_header_read(map + pos, &header);
+                last = pos;
+                pos += audit_record_size(&header);
+            }
+            audit_header_read(map + last, &header);
+            self->next_sequence = header.sequence + 1;
+            self->last_timestamp = header.timestamp_us;
+            memcpy(self->last_hash, header.hash, AUDIT_HASH_SIZE);
+        }
+        munmap(map, size);
+
+        if (consumed < size && ftruncate(fd, (off_t)consumed) != 0) {
+            goto error;
+        }
+    }
+
+    self->fd = fd;
+    self->offset = consumed;
+    return 0;
+
+error:
+    saved_errno = errno;
+    close(fd);
+    errno = saved_errno;
+    return -1;
+}
+
+static int AuditLogWriter_init(AuditLogWriterObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"path", "sync", NULL};
+    PyObject *path_obj = NULL;
+    int sync = 1;
+    int rc;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O&|p", kwlist,
+                                     PyUnicode_FSConverter, &path_obj, &sync)) {
+        return -1;
+    }
+    if (self->fd >= 0) {
+        Py_DECREF(path_obj);
+        PyErr_SetString(PyExc_RuntimeError, "AuditLogWriter already open");
+        return -1;
+    }
+
+    self->sync = sync;
+    Py_BEGIN_ALLOW_THREADS
+    rc = open_log(self, PyBytes_AS_STRING(path_obj));
+    Py_END_ALLOW_THREADS
+
+    if (rc < 0) {
+        int saved_errno = errno;
+        PyObject *filename = PyUnicode_DecodeFSDefault(PyBytes_AS_STRING(path_obj));
+        errno = saved_errno;
+        PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, filename);
+        Py_XDECREF(filename);
+        Py_DECREF(path_obj);
+        return -1;
+    }
+    Py_DECREF(path_obj);
+    return 0;
+}
+
+static void AuditLogWriter_dealloc(AuditLogWriterObject *self) {
+    if (self->fd >= 0) {
+        close(self->fd);
+    }
+    if (self->lock != NULL) {
+        PyThread_free_lock(self->lock);
+    }
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static int parse_record(PyObject *item, pending_record_t *rec) {
+    PyObject *timestamp;
+    PyObject *session_id;
+
+    if (!PyTuple_Check(item)) {
+        PyErr_SetString(PyExc_TypeError, "record must be a (timestamp_us, event_type, session_id, payload) tuple");
+        return -1;
+    }
+    if (!PyArg_ParseTuple(item, "OiUy*:record", &timestamp, &rec->event_type, &session_id, &rec->payload)) {
+        return -1;
+    }
+    rec->session_id = PyUnicode_AsUTF8AndSize(session_id, &rec->session_len);
+    if (rec->session_id == NULL) {
+        goto error;
+    }
+    rec->timestamp_us = PyLong_AsUnsignedLongLong(timestamp);
+    if (rec->timestamp_us == (uint64_t)-1 && PyErr_Occurred()) {
+        goto error;
+    }
+    if (rec->event_type < 0 || rec->event_type > 0xffff) {
+        PyErr_SetString(PyExc_ValueError, "event_type must fit in 16 bits");
+        goto error;
+    }
+    if (rec->session_len > AUDIT_MAX_SESSION_ID) {
+        PyErr_SetString(PyExc_ValueError, "session_id too long");
+        goto error;
+    }
+    if ((size_t)rec->payload.len > AUDIT_MAX_PAYLOAD) {
+        PyErr_SetString(PyExc_ValueError, "payload too large");
+        goto error;
+    }
+    return 0;
+
+error:
+    PyBuffer_Release(&rec->payload);
+    return -1;
+}
+
+static PyObject* AuditLogWriter_append(AuditLogWriterObject *self, PyObject *args) {
+    PyObject *records;
+    PyObject *result = NULL;
+    pending_record_t *pending = NULL;
+    uint8_t *buf = NULL;
+    Py_ssize_t parsed = 0;
+    size_t total = 0;
+    int rc = 0;
+    int saved_errno = 0;
+
+    if (!PyArg_ParseTuple(args, "O", &records)) {
+        return NULL;
+    }
+    if (self->fd < 0) {
+        PyErr_SetString(PyExc_ValueError, "I/O operation on closed audit log");
+        return NULL;
+    }
+
+    PyObject *seq = PySequence_Fast(records, "records must be a sequence of (timestamp_us, event_type, session_id, payload)");
+    if (seq == NULL) {
+        return NULL;
+    }
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(seq);
+    if (count == 0) {
+        Py_DECREF(seq);
+        return PyList_New(0);
+    }
+
+    pending = PyMem_Calloc((size_t)count, sizeof(pending_record_t));
+    if (pending == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (; parsed < count; parsed++) {
+        if (parse_record(PySequence_Fast_GET_ITEM(seq, parsed), &pending[parsed]) < 0) {
+            goto done;
+        }
+        pending[parsed].offset = total;
+        total += AUDIT_HEADER_SIZE + (size_t)pending[parsed].session_len + (size_t)pending[parsed].payload.len;
+    }
+
+    buf = PyMem_Malloc(total);
+    if (buf == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (Py_ssize_t i = 0; i < count; i++) {
+        pending_record_t *rec = &pending[i];
+        audit_header_t header;
+
+        memset(&header, 0, sizeof(header));
+        header.event_type = (uint16_t)rec->event_type;
+        header.timestamp_us = rec->timestamp_us;
+        header.session_hash = audit_session_hash((const uint8_t*)rec->session_id, (size_t)rec->session_len);
+        header.session_len = (uint16_t)rec->session_len;
+        header.payload_len = (uint32_t)rec->payload.len;
+
+        uint8_t *out = buf + rec->offset;
+        audit_header_write(out, &header);
+        memcpy(out + AUDIT_HEADER_SIZE, rec->session_id, (size_t)rec->session_len);
+        memcpy(out + AUDIT_HEADER_SIZE + rec->session_len, rec->payload.buf, (size_t)rec->payload.len);
+    }
+
+    // Sequence, timestamp floor and chain state are only read and advanced
+    // under the lock, and only once the batch is on disk
+    Py_BEGIN_ALLOW_THREADS
+    PyThread_acquire_lock(self->lock, WAIT_LOCK);
+    if (self->fd < 0) {
+        rc = -1;
+        saved_errno = EBADF;
+    } else {
+        uint64_t next_sequence = self->next_sequence;
+        uint64_t last_timestamp = self->last_timestamp;
+        uint8_t last_hash[AUDIT_HASH_SIZE];
+
+        memcpy(last_hash, self->last_hash, AUDIT_HASH_SIZE);
+        audit_chain_seal(buf, (size_t)count, &next_sequence, &last_timestamp, last_hash);
+
+        rc = audit_write_all(self->fd, buf, total, self->offset);
+        if (rc == 0 && self->sync) {
+            rc = fdatasync(self->fd);
+        }
+        if (rc == 0) {
+            self->offset += total;
+            self->next_sequence = next_sequence;
+            self->last_timestamp = last_timestamp;
+            memcpy(self->last_hash, last_hash, AUDIT_HASH_SIZE);
+        } else {
+            saved_errno = errno;
+            // Drop the partial batch so the file still ends on a record; if
+            // that fails as well, the torn tail is cut when the log reopens
+            (void)!ftruncate(self->fd, (off_t)self->offset);
+        }
+    }
+    PyThread_release_lock(self->lock);
+    Py_END_ALLOW_THREADS
+
+    if (rc < 0) {
+        errno = saved_errno;
+        PyErr_SetFromErrno(PyExc_OSError);
+        goto done;
+    }
+
+    result = PyList_New(count);
+    if (result == NULL) {
+        goto done;
+    }
+    for (Py_ssize_t i = 0; i < count; i++) {
+        PyObject *hex = hash_to_hex(buf + pending[i].offset + AUDIT_HASHED_HEADER_SIZE);
+        if (hex == NULL) {
+            Py_CLEAR(result);
+            goto done;
+        }
+        PyList_SET_ITEM(result, i, hex);
+    }
+
+done:
+    for (Py_ssize_t i = 0; i < parsed; i++) {
+        PyBuffer_Release(&pending[i].payload);
+    }
+    PyMem_Free(pending);
+    PyMem_Free(buf);
+    Py_DECREF(seq);
+    return result;
+}
+
+static PyObject* AuditLogWriter_close(AuditLogWriterObject *self, PyObject *args) {
+    int rc = 0;
+
+    Py_BEGIN_ALLOW_THREADS
+    PyThread_acquire_lock(self->lock, WAIT_LOCK);
+    if (self->fd >= 0) {
+        rc = close(self->fd);
+        self->fd = -1;
+    }
+    PyThread_release_lock(self->lock);
+    Py_END_ALLOW_THREADS
+
+    if (rc != 0) {
+        return PyErr_SetFromErrno(PyExc_OSError);
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* AuditLogReader_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
+    AuditLogReaderObject *self = (AuditLogReaderObject*)type->tp_alloc(type, 0);
+    if (self != NULL) {
+        self->map = NULL;
+        self->offsets = NULL;
+    }
+    return (PyObject*)self;
+}
+
+static void clear_reader(AuditLogReaderObject *self) {
+    if (self->map != NULL) {
+        munmap(self->map, self->size);
+    }
+    PyMem_Free(self->offsets);
+    self->map = NULL;
+    self->offsets = NULL;
+    self->size = 0;
+    self->consumed = 0;
+    self->count = 0;
+}
+
+// Runs without the GIL: map the file as it is now
+static int map_log(const char *path, uint8_t **map, size_t *size) {
+    struct stat st;
+    int saved_errno;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    if (fstat(fd, &st) != 0) {
+        saved_errno = errno;
+        close(fd);
+        errno = saved_errno;
+        return -1;
+    }
+
+    *size = (size_t)st.st_size;
+    *map = NULL;
+    if (*size > 0) {
+        *map = mmap(NULL, *size, PROT_READ, MAP_SHARED, fd, 0);
+        if (*map == MAP_FAILED) {
+            saved_errno = errno;
+            *map = NULL;
+            close(fd);
+            errno = saved_errno;
+            return -1;
+        }
+    }
+    close(fd);
+    return 0;
+}
+
+static int AuditLogReader_init(AuditLogReaderObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"path", NULL};
+    PyObject *path_obj = NULL;
+    uint8_t *map = NULL;
+    size_t size = 0;
+    int rc;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O&", kwlist, PyUnicode_FSConverter, &path_obj)) {
+        return -1;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    rc = map_log(PyBytes_AS_STRING(path_obj), &map, &size);
+    Py_END_ALLOW_THREADS
+
+    if (rc < 0) {
+        int saved_errno = errno;
+        PyObject *filename = PyUnicode_DecodeFSDefault(PyBytes_AS_STRING(path_obj));
+        errno = saved_errno;
+        PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, filename);
+        Py_XDECREF(filename);
+        Py_DECREF(path_obj);
+        return -1;
+    }
+    Py_DECREF(path_obj);
+
+    clear_reader(self);
+    self->map = map;
+    self->size = size;
+    if (size == 0) {
+        return 0;
+    }
+
+    size_t count = audit_scan(map, size, NULL, 0, &self->consumed);
+    self->offsets = PyMem_Malloc((count > 0 ? count : 1) * sizeof(size_t));
+    if (self->offsets == NULL) {
+        clear_reader(self);
+        PyErr_NoMemory();
+        return -1;
+    }
+    self->count = audit_scan(map, size, self->offsets, count, &self->consumed);
+    return 0;
+}
+
+static void AuditLogReader_dealloc(AuditLogReaderObject *self) {
+    clear_reader(self);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static Py_ssize_t AuditLogReader_length(AuditLogReaderObject *self) {
+    return (Py_ssize_t)self->count;
+}
+
+// None leaves the bound open
+static int convert_bound(PyObject *obj, void *out) {
+    if (obj == Py_None) {
+        return 1;
+    }
+    uint64_t value = PyLong_AsUnsignedLongLong(obj);
+    if (value == (uint64_t)-1 && PyErr_Occurred()) {
+        return 0;
+    }
+    *(uint64_t*)out = value;
+    return 1;
+}
+
+static PyObject* AuditLogReader_range(AuditLogReaderObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"start_us", "end_us", "session_id", NULL};
+    uint64_t start_us = 0;
+    uint64_t end_us = UINT64_MAX;
+    const char *session_id = NULL;
+    Py_ssize_t session_len = 0;
+    uint64_t session_hash = 0;
+    audit_header_t header;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O&O&z#", kwlist,
+                                     convert_bound, &start_us, convert_bound, &end_us,
+                                     &session_id, &session_len)) {
+        return NULL;
+    }
+    if (session_id != NULL) {
+        session_hash = audit_session_hash((const uint8_t*)session_id, (size_t)session_len);
+    }
+
+    // Writers keep timestamps non-decreasing, so the start is a lower bound
+    size_t lo = 0, hi = self->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        audit_header_read(self->map + self->offsets[mid], &header);
+        if (header.timestamp_us < start_us) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    PyObject *result = PyList_New(0);
+    if (result == NULL) {
+        return NULL;
+    }
+    for (size_t i = lo; i < self->count; i++) {
+        const uint8_t *rec = self->map + self->offsets[i];
+        audit_header_read(rec, &header);
+        if (header.timestamp_us > end_us) {
+            break;
+        }
+
+        const uint8_t *body = rec + AUDIT_HEADER_SIZE;
+        if (session_id != NULL &&
+            (header.session_hash != session_hash || header.session_len != (size_t)session_len ||
+             memcmp(body, session_id, (size_t)session_len) != 0)) {
+            continue;
+        }
+
+        PyObject *hex = hash_to_hex(header.hash);
+        if (hex == NULL) {
+            Py_DECREF(result);
+            return NULL;
+        }
+        PyObject *item = Py_BuildValue("(KKHs#y#N)",
+                                       (unsigned long long)header.sequence,
+                                       (unsigned long long)header.timestamp_us,
+                                       header.event_type,
+                                       (const char*)body, (Py_ssize_t)header.session_len,
+                                       (const char*)body + header.session_len, (Py_ssize_t)header.payload_len,
+                                       hex);
+        if (item == NULL || PyList_Append(result, item) < 0) {
+            Py_XDECREF(item);
+            Py_DECREF(result);
+            return NULL;
+        }
+        Py_DECREF(item);
+    }
+    return result;
+}
+
+static PyObject* AuditLogReader_verify(AuditLogReaderObject *self, PyObject *args) {
+    ptrdiff_t bad;
+
+    Py_BEGIN_ALLOW_THREADS
+    bad = audit_verify(self->map, self->offsets, self->count);
+    Py_END_ALLOW_THREADS
+
+    // Bytes past the last readable record are a break of their own
+    if (bad < 0 && self->consumed < self->size) {
+        bad = (ptrdiff_t)self->count;
+    }
+    if (bad < 0) {
+        Py_RETURN_NONE;
+    }
+    return PyLong_FromSsize_t((Py_ssize_t)bad);
+}
+
+static PyObject* audit_log_version(PyObject *self, PyObject *args) {
+    return PyUnicode_FromString("0.1.0");
+}
+
+static PyMethodDef audit_log_module_methods[] = {
+    {"version", audit_log_version, METH_NOARGS, "Get version"},
+    {NULL, NULL, 0, NULL}
+};
+
+// Module definition
+static struct PyModuleDef audit_log_module = {
+    PyModuleDef_HEAD_INIT,
+    "audit_log_native",
+    "Native audit log extension for Lucid RDP",
+    -1,
+    audit_log_module_methods
+};
+
+PyMODINIT_FUNC PyInit_audit_log_native(void) {
+    if (PyType_Ready(&AuditLogWriterType) < 0 || PyType_Ready(&AuditLogReaderType) < 0) {
+        return NULL;
+    }
+
+    PyObject *m = PyModule_Create(&audit_log_module);
+    if (m == NULL) {
+        return NULL;
+    }
+
+    Py_INCREF(&AuditLogWriterType);
+    if (PyModule_AddObject(m, "AuditLogWriter", (PyObject*)&AuditLogWriterType) < 0) {
+        Py_DECREF(&AuditLogWriterType);
+        Py_DECREF(m);
+        return NULL;
+    }
+    Py_INCREF(&AuditLogReaderType);
+    if (PyModule_AddObject(m, "AuditLogReader", (PyObject*)&AuditLogReaderType) < 0) {
+        Py_DECREF(&AuditLogReaderType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    PyModule_AddIntConstant(m, "HEADER_SIZE", AUDIT_HEADER_SIZE);
+    PyModule_AddIntConstant(m, "HASH_SIZE", AUDIT_HASH_SIZE);
+    PyModule_AddIntConstant(m, "MAX_PAYLOAD", AUDIT_MAX_PAYLOAD);
+
+    return m;
+}
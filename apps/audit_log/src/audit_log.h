@@ -0,0 +1,10 @@
+#ifndef AUDIT_LOG_H
+#define AUDIT_LOG_H
+
+#include <Python.h>
+
+// Constants
+#define AUDIT_FILE_MODE 0640
+#define AUDIT_HEX_SIZE (AUDIT_HASH_SIZE * 2)
+
+#endif // AUDIT_LOG_H
@@ -0,0 +1,190 @@
+#define _GNU_SOURCE
+#include "record_log.h"
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <openssl/sha.h>
+
+static void put_le16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_le32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static void put_le64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static uint16_t get_le16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_le32(const uint8_t *p) {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; i--) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+static uint64_t get_le64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+uint64_t audit_session_hash(const uint8_t *session_id, size_t len) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len; i++) {
+        h ^= session_id[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+void audit_header_write(uint8_t *out, const audit_header_t *header) {
+    put_le32(out, AUDIT_MAGIC);
+    put_le16(out + 4, AUDIT_VERSION);
+    put_le16(out + 6, header->event_type);
+    put_le64(out + 8, header->timestamp_us);
+    put_le64(out + 16, header->sequence);
+    put_le64(out + 24, header->session_hash);
+    put_le16(out + 32, header->session_len);
+    put_le16(out + 34, 0);
+    put_le32(out + 36, header->payload_len);
+    memcpy(out + 40, header->prev_hash, AUDIT_HASH_SIZE);
+    memcpy(out + 72, header->hash, AUDIT_HASH_SIZE);
+}
+
+int audit_header_read(const uint8_t *in, audit_header_t *header) {
+    if (get_le32(in) != AUDIT_MAGIC || get_le16(in + 4) != AUDIT_VERSION) {
+        return -1;
+    }
+    header->event_type = get_le16(in + 6);
+    header->timestamp_us = get_le64(in + 8);
+    header->sequence = get_le64(in + 16);
+    header->session_hash = get_le64(in + 24);
+    header->session_len = get_le16(in + 32);
+    header->payload_len = get_le32(in + 36);
+    memcpy(header->prev_hash, in + 40, AUDIT_HASH_SIZE);
+    memcpy(header->hash, in + 72, AUDIT_HASH_SIZE);
+    return 0;
+}
+
+void audit_record_hash(uint8_t out[AUDIT_HASH_SIZE], const uint8_t *rec, size_t len) {
+    SHA256_CTX ctx;
+
+    SHA256_Init(&ctx);
+    SHA256_Update(&ctx, rec, AUDIT_HASHED_HEADER_SIZE);
+    SHA256_Update(&ctx, rec + AUDIT_HEADER_SIZE, len - AUDIT_HEADER_SIZE);
+    SHA256_Final(out, &ctx);
+}
+
+void audit_chain_seal(uint8_t *buf, size_t count, uint64_t *next_sequence,
+                      uint64_t *last_timestamp, uint8_t last_hash[AUDIT_HASH_SIZE]) {
+    uint8_t *rec = buf;
+
+    for (size_t i = 0; i < count; i++) {
+        size_t len = AUDIT_HEADER_SIZE + get_le16(rec + 32) + get_le32(rec + 36);
+        uint64_t timestamp = get_le64(rec + 8);
+
+        if (timestamp < *last_timestamp) {
+            timestamp = *last_timestamp;
+            put_le64(rec + 8, timestamp);
+        }
+        put_le64(rec + 16, (*next_sequence)++);
+        memcpy(rec + 40, last_hash, AUDIT_HASH_SIZE);
+        audit_record_hash(rec + 72, rec, len);
+
+        memcpy(last_hash, rec + 72, AUDIT_HASH_SIZE);
+        *last_timestamp = timestamp;
+        rec += len;
+    }
+}
+
+size_t audit_scan(const uint8_t *buf, size_t len, size_t *offsets, size_t max_records,
+                  size_t *consumed) {
+    size_t pos = 0;
+    size_t count = 0;
+    audit_header_t header;
+
+    while (len - pos >= AUDIT_HEADER_SIZE && (offsets == NULL || count < max_records)) {
+        if (audit_header_read(buf + pos, &header) < 0 || header.payload_len > AUDIT_MAX_PAYLOAD) {
+            break;
+        }
+        size_t size = audit_record_size(&header);
+        if (len - pos < size) {
+            break;  // Torn tail
+        }
+        if (offsets != NULL) {
+            offsets[count] = pos;
+        }
+        count++;
+        pos += size;
+    }
+
+    *consumed = pos;
+    return count;
+}
+
+int audit_tail_torn(const uint8_t *tail, size_t len) {
+    if (len < AUDIT_HEADER_SIZE || get_le32(tail) == AUDIT_MAGIC) {
+        return 1;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (tail[i] != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+ptrdiff_t audit_verify(const uint8_t *buf, const size_t *offsets, size_t count) {
+    uint8_t prev[AUDIT_HASH_SIZE] = {0};
+    uint8_t digest[AUDIT_HASH_SIZE];
+    uint64_t last_timestamp = 0;
+    audit_header_t header;
+
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t *rec = buf + offsets[i];
+        audit_header_read(rec, &header);
+
+        if (header.sequence != i || header.timestamp_us < last_timestamp ||
+            memcmp(header.prev_hash, prev, AUDIT_HASH_SIZE) != 0) {
+            return (ptrdiff_t)i;
+        }
+        audit_record_hash(digest, rec, audit_record_size(&header));
+        if (memcmp(digest, header.hash, AUDIT_HASH_SIZE) != 0) {
+            return (ptrdiff_t)i;
+        }
+
+        memcpy(prev, header.hash, AUDIT_HASH_SIZE);
+        last_timestamp = header.timestamp_us;
+    }
+    return -1;
+}
+
+int audit_write_all(int fd, const uint8_t *buf, size_t len, uint64_t offset) {
+    while (len > 0) {
+        ssize_t n = pwrite(fd, buf, len, (off_t)offset);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        buf += n;
+        len -= (size_t)n;
+        offset += (uint64_t)n;
+    }
+    return 0;
+}
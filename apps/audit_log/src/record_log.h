@@ -0,0 +1,75 @@
+#ifndef RECORD_LOG_H
+#define RECORD_LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Constants
+#define AUDIT_MAGIC 0x4c445541u  // "AUDL" on disk
+#define AUDIT_VERSION 1
+#define AUDIT_HASH_SIZE 32  // SHA-256
+#define AUDIT_HEADER_SIZE 104
+#define AUDIT_HASHED_HEADER_SIZE (AUDIT_HEADER_SIZE - AUDIT_HASH_SIZE)
+#define AUDIT_MAX_SESSION_ID 0xffff
+#define AUDIT_MAX_PAYLOAD (16u << 20)
+
+// Fixed little-endian record header; session id and payload follow it.
+//   0 magic u32        4 version u16       6 event_type u16
+//   8 timestamp_us u64 16 sequence u64     24 session_hash u64
+//  32 session_len u16  34 reserved u16     36 payload_len u32
+//  40 prev_hash[32]    72 hash[32]
+// hash = SHA-256(header[0:72] || session id || payload), and prev_hash is
+// the hash of the record before it (zeros for the first), so changing any
+// byte of a record breaks every link after it.
+typedef struct {
+    uint16_t event_type;
+    uint64_t timestamp_us;
+    uint64_t sequence;
+    uint64_t session_hash;
+    uint16_t session_len;
+    uint32_t payload_len;
+    uint8_t prev_hash[AUDIT_HASH_SIZE];
+    uint8_t hash[AUDIT_HASH_SIZE];
+} audit_header_t;
+
+// FNV-1a 64 of the session id, for filtering without touching the body
+uint64_t audit_session_hash(const uint8_t *session_id, size_t len);
+
+void audit_header_write(uint8_t *out, const audit_header_t *header);
+// -1 on bad magic or version
+int audit_header_read(const uint8_t *in, audit_header_t *header);
+
+static inline size_t audit_record_size(const audit_header_t *header) {
+    return AUDIT_HEADER_SIZE + header->session_len + header->payload_len;
+}
+
+// Record hash over the header prefix and body of the record at rec
+void audit_record_hash(uint8_t out[AUDIT_HASH_SIZE], const uint8_t *rec, size_t len);
+
+// Link count records laid out back to back in buf: set sequence numbers
+// from *next_sequence, raise timestamps to at least *last_timestamp so the
+// file stays sorted by time, then write prev_hash and hash in order.
+// Updates the three state values to follow the last record.
+void audit_chain_seal(uint8_t *buf, size_t count, uint64_t *next_sequence,
+                      uint64_t *last_timestamp, uint8_t last_hash[AUDIT_HASH_SIZE]);
+
+// Walk well-formed records in buf. Stores up to max_records record offsets
+// (offsets may be NULL to only count), sets *consumed to the bytes covered
+// and returns the count. Stops at the first torn or malformed record.
+size_t audit_scan(const uint8_t *buf, size_t len, size_t *offsets, size_t max_records,
+                  size_t *consumed);
+
+// Whether the len bytes left after the last well-formed record are an
+// interrupted append: shorter than a header, the start of a record whose
+// body never fully landed, or zeros where the file grew but the data
+// blocks were not written before a crash
+int audit_tail_torn(const uint8_t *tail, size_t len);
+
+// Check hashes, links, sequence numbers and time order of indexed records.
+// Returns the index of the first bad record, or -1 if the chain holds.
+ptrdiff_t audit_verify(const uint8_t *buf, const size_t *offsets, size_t count);
+
+// pwrite all of buf at offset, retrying short writes; -1 with errno set
+int audit_write_all(int fd, const uint8_t *buf, size_t len, uint64_t offset);
+
+#endif // RECORD_LOG_H
@@ -0,0 +1,13 @@
+# Block Codec Module
+# Canonical binary block and transaction encoding
+
+"""
+File: /app/apps/block_codec/__init__.py
+x-lucid-file-path: /app/apps/block_codec/__init__.py
+x-lucid-file-type: python
+
+Block Codec package for Lucid RDP.
+Contains the native block and transaction codec used by the block manager.
+"""
+
+__all__ = []
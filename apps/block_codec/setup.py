@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+"""
+File: /app/apps/block_codec/setup.py
+x-lucid-file-path: /app/apps/block_codec/setup.py
+x-lucid-file-type: python
+
+Setup script for native block codec extension
+"""
+
+from setuptools import setup, Extension
+
+# Define the extension module
+block_codec_native = Extension(
+    'block_codec_native',
+    sources=[
+        'src/block_codec.c',
+        'src/chain_verify.c',
+        'src/wire.c'
+    ],
+    include_dirs=[
+        'src/'
+    ],
+    libraries=['crypto', 'pthread'],
+    library_dirs=[],
+    extra_compile_args=[
+        '-O3',
+        '-Wall',
+        '-Wextra',
+        '-std=c99',
+        '-fPIC'
+    ],
+    extra_link_args=['-shared']
+)
+
+setup(
+    name='block-codec-native',
+    version='0.1.0',
+    description='Native block codec extension for Lucid RDP',
+    ext_modules=[block_codec_native],
+    python_requires='>=3.8',
+    classifiers=[
+        'Development Status :: 3 - Alpha',
+        'Intended Audience :: Developers',
+        'License :: OSI Approved :: MIT License',
+        'Programming Language :: C',
+        'Programming Language :: Python :: 3',
+        'Programming Language :: Python :: 3.8',
+        'Programming Language :: Python :: 3.9',
+        'Programming Language :: Python :: 3.10',
+        'Programming Language :: Python :: 3.11',
+    ],
+)
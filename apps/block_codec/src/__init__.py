@@ -0,0 +1,13 @@
+# Block Codec Source Module
+# Block Codec native source code components
+
+"""
+File: /app/apps/block_codec/src/__init__.py
+x-lucid-file-path: /app/apps/block_codec/src/__init__.py
+x-lucid-file-type: python
+
+Block Codec Source package for Lucid RDP.
+Contains block codec native source code and C implementations.
+"""
+
+__all__ = []
@@ -0,0 +1,784 @@
+/*
+ * Native block codec extension for Lucid RDP
+ * Canonical binary encoding of blocks and transactions: a fixed-layout
+ * header hashed over raw bytes, varint bodies sized without serializing,
+ * and Merkle roots over raw 32-byte transaction ids. Chain segments are
+ * rechecked on a worker pool.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <datetime.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include "block_codec.h"
+#include "chain_verify.h"
+#include "wire.h"
+
+#define TX_STRING_FIELDS 5
+
+// Borrowed views of a transaction's fields; owners keep them alive
+typedef struct {
+    tx_fields_t fields;
+    PyObject *owners[TX_STRING_FIELDS];
+} tx_view_t;
+
+typedef struct {
+    block_header_t header;
+    PyObject *producer;
+    PyObject *transactions;  // PySequence_Fast of the block's transactions
+} block_view_t;
+
+// Forward declarations
+static PyObject* block_codec_encode_header(PyObject *self, PyObject *args);
+static PyObject* block_codec_block_hash(PyObject *self, PyObject *args);
+static PyObject* block_codec_block_size(PyObject *self, PyObject *args);
+static PyObject* block_codec_encode_block(PyObject *self, PyObject *args);
+static PyObject* block_codec_transaction_size(PyObject *self, PyObject *args);
+static PyObject* block_codec_encode_transaction(PyObject *self, PyObject *args);
+static PyObject* block_codec_merkle_root(PyObject *self, PyObject *args);
+static PyObject* block_codec_decode_header(PyObject *self, PyObject *args);
+static PyObject* block_codec_decode_block(PyObject *self, PyObject *args);
+static PyObject* block_codec_verify_blocks(PyObject *self, PyObject *args, PyObject *kwds);
+
+static int64_t days_from_civil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    unsigned year_of_era = (unsigned)(year - era * 400);
+    unsigned day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    unsigned day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + (int64_t)day_of_era - 719468;
+}
+
+// Microseconds since the epoch; naive datetimes are taken as UTC
+static int timestamp_to_us(PyObject *timestamp, int64_t *out) {
+    if (PyLong_Check(timestamp)) {
+        *out = PyLong_AsLongLong(timestamp);
+        return (*out == -1 && PyErr_Occurred()) ? -1 : 0;
+    }
+    if (!PyDateTime_Check(timestamp)) {
+        PyErr_SetString(PyExc_TypeError, "timestamp must be a datetime or integer microseconds");
+        return -1;
+    }
+
+    int64_t days = days_from_civil(PyDateTime_GET_YEAR(timestamp),
+                                   PyDateTime_GET_MONTH(timestamp),
+                                   PyDateTime_GET_DAY(timestamp));
+    int64_t seconds = days * SECONDS_PER_DAY +
+                      PyDateTime_DATE_GET_HOUR(timestamp) * 3600 +
+                      PyDateTime_DATE_GET_MINUTE(timestamp) * 60 +
+                      PyDateTime_DATE_GET_SECOND(timestamp);
+    int64_t micros = seconds * MICROS_PER_SECOND + PyDateTime_DATE_GET_MICROSECOND(timestamp);
+
+    PyObject *offset = PyObject_CallMethod(timestamp, "utcoffset", NULL);
+    if (offset == NULL) {
+        return -1;
+    }
+    if (offset != Py_None) {
+        micros -= ((int64_t)PyDateTime_DELTA_GET_DAYS(offset) * SECONDS_PER_DAY +
+                   PyDateTime_DELTA_GET_SECONDS(offset)) * MICROS_PER_SECOND +
+                  PyDateTime_DELTA_GET_MICROSECONDS(offset);
+    }
+    Py_DECREF(offset);
+
+    *out = micros;
+    return 0;
+}
+
+static int str_attr(PyObject *obj, const char *name, int none_is_empty,
+                    PyObject **owner, const char **data, size_t *len) {
+    PyObject *value = PyObject_GetAttrString(obj, name);
+    if (value == NULL) {
+        return -1;
+    }
+    if (value == Py_None && none_is_empty) {
+        *owner = value;
+        *data = "";
+        *len = 0;
+        return 0;
+    }
+    if (!PyUnicode_Check(value)) {
+        PyErr_Format(PyExc_TypeError, "%s must be a string", name);
+        Py_DECREF(value);
+        return -1;
+    }
+
+    Py_ssize_t size;
+    *data = PyUnicode_AsUTF8AndSize(value, &size);
+    if (*data == NULL) {
+        Py_DECREF(value);
+        return -1;
+    }
+    *owner = value;
+    *len = (size_t)size;
+    return 0;
+}
+
+static void tx_view_release(tx_view_t *view) {
+    for (int i = 0; i < TX_STRING_FIELDS; i++) {
+        Py_CLEAR(view->owners[i]);
+    }
+}
+
+static int tx_view_load(PyObject *tx, tx_view_t *view) {
+    tx_fields_t *fields = &view->fields;
+    memset(view, 0, sizeof(*view));
+
+    if (str_attr(tx, "id", 0, &view->owners[0], &fields->id, &fields->id_len) < 0 ||
+        str_attr(tx, "from_address", 0, &view->owners[1], &fields->from, &fields->from_len) < 0 ||
+        str_attr(tx, "to_address", 0, &view->owners[2], &fields->to, &fields->to_len) < 0 ||
+        str_attr(tx, "data", 1, &view->owners[3], &fields->data, &fields->data_len) < 0 ||
+        str_attr(tx, "signature", 1, &view->owners[4], &fields->signature, &fields->signature_len) < 0) {
+        tx_view_release(view);
+        return -1;
+    }
+
+    PyObject *value = PyObject_GetAttrString(tx, "value");
+    PyObject *timestamp = value ? PyObject_GetAttrString(tx, "timestamp") : NULL;
+    int result = -1;
+    if (timestamp != NULL) {
+        fields->value = PyFloat_AsDouble(value);
+        if (!(fields->value == -1.0 && PyErr_Occurred())) {
+            result = timestamp_to_us(timestamp, &fields->timestamp_us);
+        }
+    }
+    Py_XDECREF(value);
+    Py_XDECREF(timestamp);
+    if (result < 0) {
+        tx_view_release(view);
+    }
+    return result;
+}
+
+static int hash_attr(PyObject *obj, const char *name, uint8_t *out) {
+    PyObject *owner;
+    const char *hex;
+    size_t len;
+
+    if (str_attr(obj, name, 0, &owner, &hex, &len) < 0) {
+        return -1;
+    }
+    int result = hex_decode32(hex, len, out);
+    Py_DECREF(owner);
+    if (result < 0) {
+        PyErr_Format(PyExc_ValueError, "%s must be 64 hex digits", name);
+    }
+    return result;
+}
+
+static void block_view_release(block_view_t *view) {
+    Py_CLEAR(view->producer);
+    Py_CLEAR(view->transactions);
+}
+
+static int block_view_load(PyObject *block, block_view_t *view) {
+    block_header_t *header = &view->header;
+    memset(view, 0, sizeof(*view));
+
+    PyObject *height = PyObject_GetAttrString(block, "height");
+    if (height == NULL) {
+        return -1;
+    }
+    header->height = PyLong_AsUnsignedLongLong(height);
+    Py_DECREF(height);
+    if (header->height == (uint64_t)-1 && PyErr_Occurred()) {
+        return -1;
+    }
+
+    PyObject *timestamp = PyObject_GetAttrString(block, "timestamp");
+    if (timestamp == NULL) {
+        return -1;
+    }
+    int result = timestamp_to_us(timestamp, &header->timestamp_us);
+    Py_DECREF(timestamp);
+    if (result < 0 ||
+        hash_attr(block, "previous_hash", header->previous_hash) < 0 ||
+        hash_attr(block, "merkle_root", header->merkle_root) < 0 ||
+        str_attr(block, "producer", 0, &view->producer, &header->producer, &header->producer_len) < 0) {
+        block_view_release(view);
+        return -1;
+    }
+
+    PyObject *transactions = PyObject_GetAttrString(block, "transactions");
+    if (transactions == NULL) {
+        block_view_release(view);
+        return -1;
+    }
+    view->transactions = PySequence_Fast(transactions, "transactions must be a sequence");
+    Py_DECREF(transactions);
+    if (view->transactions == NULL) {
+        block_view_release(view);
+        return -1;
+    }
+    if (PySequence_Fast_GET_SIZE(view->transactions) > (Py_ssize_t)UINT32_MAX) {
+        PyErr_SetString(PyExc_ValueError, "Too many transactions");
+        block_view_release(view);
+        return -1;
+    }
+    header->tx_count = (uint32_t)PySequence_Fast_GET_SIZE(view->transactions);
+    return 0;
+}
+
+static PyObject* hex_string(const uint8_t *hash) {
+    char hex[BLOCK_HASH_SIZE * 2];
+    hex_encode32(hash, hex);
+    return PyUnicode_FromStringAndSize(hex, sizeof(hex));
+}
+
+static PyObject* block_codec_encode_header(PyObject *self, PyObject *args) {
+    PyObject *block;
+    block_view_t view;
+
+    if (!PyArg_ParseTuple(args, "O", &block) || block_view_load(block, &view) < 0) {
+        return NULL;
+    }
+
+    PyObject *result = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)header_size(&view.header));
+    if (result != NULL) {
+        header_write(&view.header, (uint8_t*)PyBytes_AS_STRING(result));
+    }
+    block_view_release(&view);
+    return result;
+}
+
+static PyObject* block_codec_block_hash(PyObject *self, PyObject *args) {
+    PyObject *encoded = block_codec_encode_header(self, args);
+    if (encoded == NULL) {
+        return NULL;
+    }
+
+    uint8_t hash[BLOCK_HASH_SIZE];
+    wire_sha256((const uint8_t*)PyBytes_AS_STRING(encoded), (size_t)PyBytes_GET_SIZE(encoded), hash);
+    Py_DECREF(encoded);
+    return hex_string(hash);
+}
+
+// Size of the encoded block; -1 on error
+static Py_ssize_t encoded_block_size(block_view_t *view) {
+    size_t total = header_size(&view->header);
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(view->transactions);
+    PyObject **items = PySequence_Fast_ITEMS(view->transactions);
+
+    for (Py_ssize_t i = 0; i < count; i++) {
+        tx_view_t tx;
+        if (tx_view_load(items[i], &tx) < 0) {
+            return -1;
+        }
+        size_t size = tx_size(&tx.fields);
+        total += varint_size(size) + size;
+        tx_view_release(&tx);
+    }
+    return (Py_ssize_t)total;
+}
+
+static PyObject* block_codec_block_size(PyObject *self, PyObject *args) {
+    PyObject *block;
+    block_view_t view;
+
+    if (!PyArg_ParseTuple(args, "O", &block) || block_view_load(block, &view) < 0) {
+        return NULL;
+    }
+
+    Py_ssize_t size = encoded_block_size(&view);
+    block_view_release(&view);
+    return size < 0 ? NULL : PyLong_FromSsize_t(size);
+}
+
+static PyObject* block_codec_encode_block(PyObject *self, PyObject *args) {
+    PyObject *block;
+    block_view_t view;
+
+    if (!PyArg_ParseTuple(args, "O", &block) || block_view_load(block, &view) < 0) {
+        return NULL;
+    }
+
+    Py_ssize_t size = encoded_block_size(&view);
+    PyObject *result = size < 0 ? NULL : PyBytes_FromStringAndSize(NULL, size);
+    if (result == NULL) {
+        block_view_release(&view);
+        return NULL;
+    }
+
+    uint8_t *out = (uint8_t*)PyBytes_AS_STRING(result);
+    size_t used = header_write(&view.header, out);
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(view.transactions);
+    PyObject **items = PySequence_Fast_ITEMS(view.transactions);
+
+    // Transactions are length-prefixed so a reader can skip them
+    for (Py_ssize_t i = 0; i < count; i++) {
+        tx_view_t tx;
+        if (tx_view_load(items[i], &tx) < 0) {
+            Py_DECREF(result);
+            block_view_release(&view);
+            return NULL;
+        }
+        used += varint_put(out + used, tx_size(&tx.fields));
+        used += tx_write(&tx.fields, out + used);
+        tx_view_release(&tx);
+    }
+
+    block_view_release(&view);
+    return result;
+}
+
+static PyObject* block_codec_transaction_size(PyObject *self, PyObject *args) {
+    PyObject *obj;
+    tx_view_t tx;
+
+    if (!PyArg_ParseTuple(args, "O", &obj) || tx_view_load(obj, &tx) < 0) {
+        return NULL;
+    }
+    size_t size = tx_size(&tx.fields);
+    tx_view_release(&tx);
+    return PyLong_FromSize_t(size);
+}
+
+static PyObject* block_codec_encode_transaction(PyObject *self, PyObject *args) {
+    PyObject *obj;
+    tx_view_t tx;
+
+    if (!PyArg_ParseTuple(args, "O", &obj) || tx_view_load(obj, &tx) < 0) {
+        return NULL;
+    }
+    PyObject *result = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)tx_size(&tx.fields));
+    if (result != NULL) {
+        tx_write(&tx.fields, (uint8_t*)PyBytes_AS_STRING(result));
+    }
+    tx_view_release(&tx);
+    return result;
+}
+
+// Leaves from transactions or their ids
+static int load_leaves(PyObject **items, Py_ssize_t count, uint8_t *leaves) {
+    for (Py_ssize_t i = 0; i < count; i++) {
+        PyObject *owner = NULL;
+        const char *id;
+        size_t len;
+
+        if (PyUnicode_Check(items[i])) {
+            Py_ssize_t size;
+            id = PyUnicode_AsUTF8AndSize(items[i], &size);
+            len = (size_t)size;
+            if (id == NULL) {
+                return -1;
+            }
+        } else if (str_attr(items[i], "id", 0, &owner, &id, &len) < 0) {
+            return -1;
+        }
+        tx_leaf(id, len, leaves + i * BLOCK_HASH_SIZE);
+        Py_XDECREF(owner);
+    }
+    return 0;
+}
+
+static PyObject* block_codec_merkle_root(PyObject *self, PyObject *args) {
+    PyObject *transactions;
+
+    if (!PyArg_ParseTuple(args, "O", &transactions)) {
+        return NULL;
+    }
+
+    PyObject *seq = PySequence_Fast(transactions, "transactions must be a sequence");
+    if (seq == NULL) {
+        return NULL;
+    }
+
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(seq);
+    uint8_t *leaves = PyMem_Malloc((size_t)(count ? count : 1) * BLOCK_HASH_SIZE);
+    if (leaves == NULL) {
+        Py_DECREF(seq);
+        return PyErr_NoMemory();
+    }
+    int result = load_leaves(PySequence_Fast_ITEMS(seq), count, leaves);
+    Py_DECREF(seq);
+    if (result < 0) {
+        PyMem_Free(leaves);
+        return NULL;
+    }
+
+    uint8_t root[BLOCK_HASH_SIZE];
+    Py_BEGIN_ALLOW_THREADS
+    merkle_root_raw(leaves, (size_t)count, root);
+    Py_END_ALLOW_THREADS
+    PyMem_Free(leaves);
+    return hex_string(root);
+}
+
+static PyObject* header_tuple(const block_header_t *header) {
+    char previous_hash[BLOCK_HASH_SIZE * 2];
+    char merkle_root[BLOCK_HASH_SIZE * 2];
+
+    hex_encode32(header->previous_hash, previous_hash);
+    hex_encode32(header->merkle_root, merkle_root);
+    return Py_BuildValue("(KLIs#s#s#)",
+                         (unsigned long long)header->height,
+                         (long long)header->timestamp_us,
+                         (unsigned int)header->tx_count,
+                         previous_hash, (Py_ssize_t)sizeof(previous_hash),
+                         merkle_root, (Py_ssize_t)sizeof(merkle_root),
+                         header->producer, (Py_ssize_t)header->producer_len);
+}
+
+static PyObject* tx_tuple(const tx_fields_t *tx) {
+    return Py_BuildValue("(s#s#s#dLs#s#)",
+                         tx->id, (Py_ssize_t)tx->id_len,
+                         tx->from, (Py_ssize_t)tx->from_len,
+                         tx->to, (Py_ssize_t)tx->to_len,
+                         tx->value,
+                         (long long)tx->timestamp_us,
+                         tx->data, (Py_ssize_t)tx->data_len,
+                         tx->signature, (Py_ssize_t)tx->signature_len);
+}
+
+static PyObject* block_codec_decode_header(PyObject *self, PyObject *args) {
+    Py_buffer data;
+    block_header_t header;
+
+    if (!PyArg_ParseTuple(args, "y*", &data)) {
+        return NULL;
+    }
+
+    PyObject *result = NULL;
+    if (header_read(data.buf, (size_t)data.len, &header) == 0) {
+        PyErr_SetString(PyExc_ValueError, "Malformed block header");
+    } else {
+        result = header_tuple(&header);
+    }
+    PyBuffer_Release(&data);
+    return result;
+}
+
+static PyObject* block_codec_decode_block(PyObject *self, PyObject *args) {
+    Py_buffer data;
+    block_header_t header;
+
+    if (!PyArg_ParseTuple(args, "y*", &data)) {
+        return NULL;
+    }
+
+    const uint8_t *in = data.buf;
+    size_t len = (size_t)data.len;
+    size_t used = header_read(in, len, &header);
+    PyObject *header_obj = NULL;
+    PyObject *transactions = NULL;
+    PyObject *result = NULL;
+
+    if (used == 0) {
+        PyErr_SetString(PyExc_ValueError, "Malformed block header");
+        goto done;
+    }
+    // Each transaction takes at least 12 bytes, which bounds the list
+    if (header.tx_count > (len - used) / 12) {
+        PyErr_SetString(PyExc_ValueError, "Truncated block");
+        goto done;
+    }
+    header_obj = header_tuple(&header);
+    transactions = header_obj ? PyList_New(header.tx_count) : NULL;
+    if (transactions == NULL) {
+        goto done;
+    }
+
+    for (uint32_t i = 0; i < header.tx_count; i++) {
+        uint64_t tx_len;
+        tx_fields_t tx;
+        size_t step = varint_get(in + used, len - used, &tx_len);
+        if (step == 0 || tx_len > len - used - step ||
+            tx_read(in + used + step, (size_t)tx_len, &tx) != tx_len) {
+            PyErr_Format(PyExc_ValueError, "Malformed transaction %u", i);
+            goto done;
+        }
+        PyObject *item = tx_tuple(&tx);
+        if (item == NULL) {
+            goto done;
+        }
+        PyList_SET_ITEM(transactions, i, item);
+        used += step + (size_t)tx_len;
+    }
+    if (used != len) {
+        PyErr_SetString(PyExc_ValueError, "Trailing bytes after block");
+        goto done;
+    }
+    result = PyTuple_Pack(2, header_obj, transactions);
+
+done:
+    Py_XDECREF(header_obj);
+    Py_XDECREF(transactions);
+    PyBuffer_Release(&data);
+    return result;
+}
+
+static const char *chain_errors[] = {
+    NULL, "Merkle root mismatch", "Block hash mismatch", "Invalid block signature"
+};
+
+static int signature_attr(PyObject *block, chain_job_t *job) {
+    PyObject *owner;
+    const char *hex;
+    size_t len;
+
+    if (str_attr(block, "signature", 1, &owner, &hex, &len) < 0) {
+        return -1;
+    }
+    job->signature_malformed = len != ED25519_SIGNATURE_SIZE * 2 ||
+                               hex_decode32(hex, BLOCK_HASH_SIZE * 2, job->signature) < 0 ||
+                               hex_decode32(hex + BLOCK_HASH_SIZE * 2, BLOCK_HASH_SIZE * 2,
+                                            job->signature + BLOCK_HASH_SIZE) < 0;
+    Py_DECREF(owner);
+    return 0;
+}
+
+// Fills a job from a block; the encoded header and leaves are owned by the job
+static int chain_job_load(PyObject *block, PyObject *producer_keys, chain_job_t *job) {
+    block_view_t view;
+
+    memset(job, 0, sizeof(*job));
+    if (block_view_load(block, &view) < 0) {
+        return -1;
+    }
+    if (hash_attr(block, "hash", job->hash) < 0) {
+        goto error;
+    }
+
+    job->height = view.header.height;
+    memcpy(job->previous_hash, view.header.previous_hash, BLOCK_HASH_SIZE);
+    memcpy(job->merkle_root, view.header.merkle_root, BLOCK_HASH_SIZE);
+    job->header_len = header_size(&view.header);
+    job->leaf_count = view.header.tx_count;
+    job->header = PyMem_Malloc(job->header_len + job->leaf_count * BLOCK_HASH_SIZE);
+    if (job->header == NULL) {
+        PyErr_NoMemory();
+        goto error;
+    }
+    header_write(&view.header, job->header);
+    if (load_leaves(PySequence_Fast_ITEMS(view.transactions), (Py_ssize_t)job->leaf_count,
+                    job->header + job->header_len) < 0) {
+        goto error;
+    }
+
+    if (producer_keys != Py_None) {
+        PyObject *key = PyDict_GetItemWithError(producer_keys, view.producer);
+        if (key == NULL && PyErr_Occurred()) {
+            goto error;
+        }
+        if (key != NULL) {
+            memcpy(job->public_key, PyBytes_AS_STRING(key), ED25519_PUBLIC_KEY_SIZE);
+            job->has_public_key = 1;
+            if (signature_attr(block, job) < 0) {
+                goto error;
+            }
+        }
+    }
+
+    block_view_release(&view);
+    return 0;
+
+error:
+    PyMem_Free(job->header);
+    job->header = NULL;
+    block_view_release(&view);
+    return -1;
+}
+
+static PyObject* block_codec_verify_blocks(PyObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"blocks", "previous", "producer_keys", "threads", NULL};
+    PyObject *blocks;
+    PyObject *previous = Py_None;
+    PyObject *producer_keys = Py_None;
+    int threads = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|OOi", kwlist,
+                                     &blocks, &previous, &producer_keys, &threads)) {
+        return NULL;
+    }
+    if (producer_keys != Py_None) {
+        if (!PyDict_Check(producer_keys)) {
+            PyErr_SetString(PyExc_TypeError, "producer_keys must be a dict");
+            return NULL;
+        }
+        PyObject *producer, *key;
+        Py_ssize_t pos = 0;
+        while (PyDict_Next(producer_keys, &pos, &producer, &key)) {
+            if (!PyBytes_Check(key) || PyBytes_GET_SIZE(key) != ED25519_PUBLIC_KEY_SIZE) {
+                PyErr_SetString(PyExc_ValueError, "Producer keys must be 32 bytes");
+                return NULL;
+            }
+        }
+    }
+
+    // The block before the segment, as (height, hash), anchors the linkage check
+    int anchored = previous != Py_None;
+    unsigned long long expected_height = 0;
+    uint8_t expected_hash[BLOCK_HASH_SIZE];
+    if (anchored) {
+        PyObject *previous_hash;
+        const char *hex;
+        Py_ssize_t hex_len;
+        if (!PyArg_ParseTuple(previous, "KU;previous must be (height, hash)", &expected_height, &previous_hash) ||
+            (hex = PyUnicode_AsUTF8AndSize(previous_hash, &hex_len)) == NULL) {
+            return NULL;
+        }
+        if (hex_decode32(hex, (size_t)hex_len, expected_hash) < 0) {
+            PyErr_SetString(PyExc_ValueError, "previous hash must be 64 hex digits");
+            return NULL;
+        }
+        expected_height++;
+    }
+
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+        if (threads > DEFAULT_MAX_THREADS) {
+            threads = DEFAULT_MAX_THREADS;
+        }
+    }
+
+    PyObject *seq = PySequence_Fast(blocks, "blocks must be a sequence");
+    if (seq == NULL) {
+        return NULL;
+    }
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(seq);
+    chain_job_t *jobs = PyMem_Calloc((size_t)(count ? count : 1), sizeof(chain_job_t));
+    if (jobs == NULL) {
+        Py_DECREF(seq);
+        return PyErr_NoMemory();
+    }
+
+    // A malformed block ends the segment; everything before it is still checked
+    Py_ssize_t loaded = 0;
+    PyObject *malformed = NULL;
+    for (; loaded < count; loaded++) {
+        if (chain_job_load(PySequence_Fast_GET_ITEM(seq, loaded), producer_keys, &jobs[loaded]) < 0) {
+            if (!PyErr_ExceptionMatches(PyExc_ValueError)) {
+                goto error;
+            }
+            PyObject *type, *value, *traceback;
+            PyErr_Fetch(&type, &value, &traceback);
+            malformed = PyUnicode_FromFormat("Malformed block: %S", value ? value : Py_None);
+            Py_XDECREF(type);
+            Py_XDECREF(value);
+            Py_XDECREF(traceback);
+            if (malformed == NULL) {
+                goto error;
+            }
+            break;
+        }
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    chain_verify_batch(jobs, (size_t)loaded, threads);
+    Py_END_ALLOW_THREADS
+
+    static const uint8_t zero_hash[BLOCK_HASH_SIZE] = {0};
+    PyObject *failure = NULL;
+    PyObject *bad_height = NULL;
+    Py_ssize_t verified = 0;
+
+    for (; verified < loaded; verified++) {
+        chain_job_t *job = &jobs[verified];
+        if (anchored && job->height != expected_height) {
+            failure = job->height > expected_height
+                ? PyUnicode_FromFormat("Missing block at height %llu", expected_height)
+                : PyUnicode_FromFormat("Unexpected block height %llu", (unsigned long long)job->height);
+            bad_height = PyLong_FromUnsignedLongLong(expected_height);
+            break;
+        }
+        if (anchored && memcmp(job->previous_hash, expected_hash, BLOCK_HASH_SIZE) != 0) {
+            failure = PyUnicode_FromString("Previous hash mismatch");
+        } else if (!anchored && job->height == 0 &&
+                   memcmp(job->previous_hash, zero_hash, BLOCK_HASH_SIZE) != 0) {
+            failure = PyUnicode_FromString("Genesis block must have zero previous hash");
+        } else if (job->result != CHAIN_OK) {
+            failure = PyUnicode_FromString(chain_errors[job->result]);
+        }
+        if (failure != NULL) {
+            bad_height = PyLong_FromUnsignedLongLong(job->height);
+            break;
+        }
+        anchored = 1;
+        expected_height = job->height + 1;
+        memcpy(expected_hash, job->hash, BLOCK_HASH_SIZE);
+    }
+    // Without an anchor the height of a malformed first block is unknown
+    if (failure == NULL && malformed != NULL) {
+        failure = malformed;
+        malformed = NULL;
+        if (anchored) {
+            bad_height = PyLong_FromUnsignedLongLong(expected_height);
+        }
+    }
+
+    for (Py_ssize_t i = 0; i < loaded; i++) {
+        PyMem_Free(jobs[i].header);
+    }
+    PyMem_Free(jobs);
+    Py_DECREF(seq);
+    Py_XDECREF(malformed);
+
+    PyObject *result = NULL;
+    if (!PyErr_Occurred()) {
+        result = Py_BuildValue("(nOO)", verified, bad_height ? bad_height : Py_None,
+                               failure ? failure : Py_None);
+    }
+    Py_XDECREF(bad_height);
+    Py_XDECREF(failure);
+    return result;
+
+error:
+    for (Py_ssize_t i = 0; i < loaded; i++) {
+        PyMem_Free(jobs[i].header);
+    }
+    PyMem_Free(jobs);
+    Py_DECREF(seq);
+    return NULL;
+}
+
+static PyObject* block_codec_version(PyObject *self, PyObject *args) {
+    return PyUnicode_FromString("0.1.0");
+}
+
+// Method definitions
+static PyMethodDef block_codec_module_methods[] = {
+    {"encode_header", block_codec_encode_header, METH_VARARGS, "Canonical header bytes of a block"},
+    {"block_hash", block_codec_block_hash, METH_VARARGS, "Hex SHA-256 of the canonical header"},
+    {"block_size", block_codec_block_size, METH_VARARGS, "Exact encoded size of a block, without encoding it"},
+    {"encode_block", block_codec_encode_block, METH_VARARGS, "Header followed by length-prefixed transactions"},
+    {"transaction_size", block_codec_transaction_size, METH_VARARGS, "Exact encoded size of a transaction"},
+    {"encode_transaction", block_codec_encode_transaction, METH_VARARGS, "Canonical transaction bytes"},
+    {"merkle_root", block_codec_merkle_root, METH_VARARGS, "Hex Merkle root over raw 32-byte transaction ids"},
+    {"decode_header", block_codec_decode_header, METH_VARARGS,
+     "(height, timestamp_us, tx_count, previous_hash, merkle_root, producer) from header bytes"},
+    {"decode_block", block_codec_decode_block, METH_VARARGS,
+     "(header, [(id, from, to, value, timestamp_us, data, signature), ...]) from block bytes"},
+    {"verify_blocks", (PyCFunction)(void(*)(void))block_codec_verify_blocks, METH_VARARGS | METH_KEYWORDS,
+     "Recheck a run of blocks on a worker pool; returns (verified, bad_height, error)"},
+    {"version", block_codec_version, METH_NOARGS, "Get version"},
+    {NULL, NULL, 0, NULL}
+};
+
+// Module definition
+static struct PyModuleDef block_codec_module = {
+    PyModuleDef_HEAD_INIT,
+    "block_codec_native",
+    "Native block codec extension for Lucid RDP",
+    -1,
+    block_codec_module_methods
+};
+
+PyMODINIT_FUNC PyInit_block_codec_native(void) {
+    PyDateTime_IMPORT;
+    if (PyDateTimeAPI == NULL) {
+        return NULL;
+    }
+
+    PyObject *m = PyModule_Create(&block_codec_module);
+    if (m == NULL) {
+        return NULL;
+    }
+
+    PyModule_AddIntConstant(m, "FORMAT_VERSION", BLOCK_FORMAT_VERSION);
+    PyModule_AddIntConstant(m, "HEADER_FIXED_SIZE", BLOCK_HEADER_FIXED_SIZE);
+    PyModule_AddIntConstant(m, "DEFAULT_MAX_THREADS", DEFAULT_MAX_THREADS);
+
+    return m;
+}
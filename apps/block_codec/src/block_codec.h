@@ -0,0 +1,11 @@
+#ifndef BLOCK_CODEC_H
+#define BLOCK_CODEC_H
+
+#include <Python.h>
+
+// Constants
+#define MICROS_PER_SECOND 1000000LL
+#define SECONDS_PER_DAY 86400LL
+#define DEFAULT_MAX_THREADS 16
+
+#endif // BLOCK_CODEC_H
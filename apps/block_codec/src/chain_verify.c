@@ -0,0 +1,92 @@
+#include <string.h>
+#include <pthread.h>
+#include <openssl/evp.h>
+#include "chain_verify.h"
+
+#define CHAIN_MIN_PER_THREAD 4   // Blocks are heavy, so threads pay off early
+#define CHAIN_MAX_THREADS 64
+
+int chain_verify_ed25519(const uint8_t *public_key, const uint8_t *signature,
+                         const uint8_t *message, size_t message_len) {
+    EVP_PKEY *pkey = EVP_PKEY_new_raw_public_key(EVP_PKEY_ED25519, NULL, public_key,
+                                                 ED25519_PUBLIC_KEY_SIZE);
+    if (pkey == NULL) {
+        return 0;  // Not a point on the curve
+    }
+
+    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
+    int result = 0;
+    if (ctx != NULL && EVP_DigestVerifyInit(ctx, NULL, NULL, NULL, pkey) == 1) {
+        result = EVP_DigestVerify(ctx, signature, ED25519_SIGNATURE_SIZE, message, message_len) == 1;
+    }
+
+    EVP_MD_CTX_free(ctx);
+    EVP_PKEY_free(pkey);
+    return result;
+}
+
+static int verify_block(chain_job_t *job) {
+    uint8_t digest[BLOCK_HASH_SIZE];
+
+    merkle_root_raw(job->header + job->header_len, job->leaf_count, digest);
+    if (memcmp(digest, job->merkle_root, BLOCK_HASH_SIZE) != 0) {
+        return CHAIN_BAD_MERKLE_ROOT;
+    }
+
+    wire_sha256(job->header, job->header_len, digest);
+    if (memcmp(digest, job->hash, BLOCK_HASH_SIZE) != 0) {
+        return CHAIN_BAD_HASH;
+    }
+
+    // Producers sign the raw block hash
+    if (job->has_public_key &&
+        (job->signature_malformed ||
+         !chain_verify_ed25519(job->public_key, job->signature, job->hash, BLOCK_HASH_SIZE))) {
+        return CHAIN_BAD_SIGNATURE;
+    }
+    return CHAIN_OK;
+}
+
+typedef struct {
+    chain_job_t *jobs;
+    size_t count;
+    size_t next;  // Shared claim cursor
+} chain_batch_t;
+
+static void *chain_worker(void *arg) {
+    chain_batch_t *batch = arg;
+    for (;;) {
+        size_t i = __atomic_fetch_add(&batch->next, 1, __ATOMIC_RELAXED);
+        if (i >= batch->count) {
+            break;
+        }
+        batch->jobs[i].result = verify_block(&batch->jobs[i]);
+    }
+    return NULL;
+}
+
+void chain_verify_batch(chain_job_t *jobs, size_t count, int threads) {
+    chain_batch_t batch = {jobs, count, 0};
+    pthread_t workers[CHAIN_MAX_THREADS];
+    int started = 0;
+
+    size_t useful = count / CHAIN_MIN_PER_THREAD;
+    if ((size_t)threads > useful) {
+        threads = (int)useful;
+    }
+    if (threads > CHAIN_MAX_THREADS) {
+        threads = CHAIN_MAX_THREADS;
+    }
+
+    // The calling thread is one of the workers
+    for (int i = 1; i < threads; i++) {
+        if (pthread_create(&workers[started], NULL, chain_worker, &batch) != 0) {
+            break;
+        }
+        started++;
+    }
+    chain_worker(&batch);
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef CHAIN_VERIFY_H
+#define CHAIN_VERIFY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "wire.h"
+
+#define ED25519_PUBLIC_KEY_SIZE 32
+#define ED25519_SIGNATURE_SIZE 64
+
+// Per-block verdicts, in the order they are checked
+#define CHAIN_OK 0
+#define CHAIN_BAD_MERKLE_ROOT 1
+#define CHAIN_BAD_HASH 2
+#define CHAIN_BAD_SIGNATURE 3
+
+// One block to recheck. header holds the encoded header followed by the
+// transaction leaves, which the Merkle computation overwrites.
+typedef struct {
+    uint64_t height;
+    uint8_t previous_hash[BLOCK_HASH_SIZE];
+    uint8_t merkle_root[BLOCK_HASH_SIZE];
+    uint8_t hash[BLOCK_HASH_SIZE];           // Hash the block claims
+    uint8_t *header;
+    size_t header_len;
+    size_t leaf_count;
+    int has_public_key;                      // 0 skips the signature check
+    int signature_malformed;
+    uint8_t public_key[ED25519_PUBLIC_KEY_SIZE];
+    uint8_t signature[ED25519_SIGNATURE_SIZE];
+    int result;
+} chain_job_t;
+
+int chain_verify_ed25519(const uint8_t *public_key, const uint8_t *signature,
+                         const uint8_t *message, size_t message_len);
+
+// Recomputes Merkle roots, header hashes and signatures across up to
+// threads worker threads, setting each job's result
+void chain_verify_batch(chain_job_t *jobs, size_t count, int threads);
+
+#endif // CHAIN_VERIFY_H
@@ -0,0 +1,239 @@
+#include <string.h>
+#include <openssl/sha.h>
+#include "wire.h"
+
+size_t varint_size(uint64_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+size_t varint_put(uint8_t *out, uint64_t value) {
+    size_t i = 0;
+    while (value >= 0x80) {
+        out[i++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[i++] = (uint8_t)value;
+    return i;
+}
+
+size_t varint_get(const uint8_t *in, size_t len, uint64_t *value) {
+    uint64_t result = 0;
+    for (size_t i = 0; i < len && i < VARINT_MAX_SIZE; i++) {
+        uint64_t byte = in[i];
+        if (i == VARINT_MAX_SIZE - 1 && byte > 1) {
+            return 0;  // Beyond 64 bits
+        }
+        result |= (byte & 0x7F) << (7 * i);
+        if (!(byte & 0x80)) {
+            // Only the shortest encoding is canonical
+            if (byte == 0 && i > 0) {
+                return 0;
+            }
+            *value = result;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+static uint64_t zigzag_encode(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t zigzag_decode(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static void put_le(uint8_t *out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static uint64_t get_le(const uint8_t *in, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value |= (uint64_t)in[i] << (8 * i);
+    }
+    return value;
+}
+
+static size_t put_bytes(uint8_t *out, const char *data, size_t len) {
+    size_t used = varint_put(out, len);
+    memcpy(out + used, data, len);
+    return used + len;
+}
+
+static size_t get_bytes(const uint8_t *in, size_t len, const char **data, size_t *data_len) {
+    uint64_t field_len;
+    size_t used = varint_get(in, len, &field_len);
+    if (used == 0 || field_len > len - used) {
+        return 0;
+    }
+    *data = (const char*)in + used;
+    *data_len = (size_t)field_len;
+    return used + (size_t)field_len;
+}
+
+size_t header_size(const block_header_t *header) {
+    return BLOCK_HEADER_FIXED_SIZE + varint_size(header->producer_len) + header->producer_len;
+}
+
+size_t header_write(const block_header_t *header, uint8_t *out) {
+    out[0] = BLOCK_FORMAT_VERSION;
+    put_le(out + 1, header->height, 8);
+    put_le(out + 9, (uint64_t)header->timestamp_us, 8);
+    put_le(out + 17, header->tx_count, 4);
+    memcpy(out + 21, header->previous_hash, BLOCK_HASH_SIZE);
+    memcpy(out + 53, header->merkle_root, BLOCK_HASH_SIZE);
+    return BLOCK_HEADER_FIXED_SIZE + put_bytes(out + BLOCK_HEADER_FIXED_SIZE, header->producer, header->producer_len);
+}
+
+size_t header_read(const uint8_t *in, size_t len, block_header_t *header) {
+    if (len < BLOCK_HEADER_FIXED_SIZE || in[0] != BLOCK_FORMAT_VERSION) {
+        return 0;
+    }
+    header->height = get_le(in + 1, 8);
+    header->timestamp_us = (int64_t)get_le(in + 9, 8);
+    header->tx_count = (uint32_t)get_le(in + 17, 4);
+    memcpy(header->previous_hash, in + 21, BLOCK_HASH_SIZE);
+    memcpy(header->merkle_root, in + 53, BLOCK_HASH_SIZE);
+
+    size_t used = get_bytes(in + BLOCK_HEADER_FIXED_SIZE, len - BLOCK_HEADER_FIXED_SIZE,
+                            &header->producer, &header->producer_len);
+    return used ? BLOCK_HEADER_FIXED_SIZE + used : 0;
+}
+
+size_t tx_size(const tx_fields_t *tx) {
+    return varint_size(tx->id_len) + tx->id_len +
+           varint_size(tx->from_len) + tx->from_len +
+           varint_size(tx->to_len) + tx->to_len +
+           8 +
+           varint_size(zigzag_encode(tx->timestamp_us)) +
+           varint_size(tx->data_len) + tx->data_len +
+           varint_size(tx->signature_len) + tx->signature_len;
+}
+
+size_t tx_write(const tx_fields_t *tx, uint8_t *out) {
+    uint64_t value_bits;
+    size_t used = 0;
+
+    memcpy(&value_bits, &tx->value, sizeof(value_bits));
+    used += put_bytes(out + used, tx->id, tx->id_len);
+    used += put_bytes(out + used, tx->from, tx->from_len);
+    used += put_bytes(out + used, tx->to, tx->to_len);
+    put_le(out + used, value_bits, 8);
+    used += 8;
+    used += varint_put(out + used, zigzag_encode(tx->timestamp_us));
+    used += put_bytes(out + used, tx->data, tx->data_len);
+    used += put_bytes(out + used, tx->signature, tx->signature_len);
+    return used;
+}
+
+size_t tx_read(const uint8_t *in, size_t len, tx_fields_t *tx) {
+    size_t used = 0;
+    size_t step;
+    uint64_t value_bits;
+    uint64_t timestamp;
+
+#define READ_FIELD(ptr, field_len) \
+    if ((step = get_bytes(in + used, len - used, &(ptr), &(field_len))) == 0) return 0; \
+    used += step;
+
+    READ_FIELD(tx->id, tx->id_len);
+    READ_FIELD(tx->from, tx->from_len);
+    READ_FIELD(tx->to, tx->to_len);
+    if (len - used < 8) {
+        return 0;
+    }
+    value_bits = get_le(in + used, 8);
+    memcpy(&tx->value, &value_bits, sizeof(value_bits));
+    used += 8;
+    if ((step = varint_get(in + used, len - used, &timestamp)) == 0) {
+        return 0;
+    }
+    tx->timestamp_us = zigzag_decode(timestamp);
+    used += step;
+    READ_FIELD(tx->data, tx->data_len);
+    READ_FIELD(tx->signature, tx->signature_len);
+
+#undef READ_FIELD
+    return used;
+}
+
+void wire_sha256(const uint8_t *data, size_t len, uint8_t *out) {
+    SHA256_CTX ctx;
+    SHA256_Init(&ctx);
+    SHA256_Update(&ctx, data, len);
+    SHA256_Final(out, &ctx);
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+int hex_decode32(const char *hex, size_t len, uint8_t *out) {
+    if (len != BLOCK_HASH_SIZE * 2) {
+        return -1;
+    }
+    for (size_t i = 0; i < BLOCK_HASH_SIZE; i++) {
+        int high = hex_value(hex[2 * i]);
+        int low = hex_value(hex[2 * i + 1]);
+        if (high < 0 || low < 0) {
+            return -1;
+        }
+        out[i] = (uint8_t)(high << 4 | low);
+    }
+    return 0;
+}
+
+void hex_encode32(const uint8_t *in, char *out) {
+    static const char digits[] = "0123456789abcdef";
+    for (size_t i = 0; i < BLOCK_HASH_SIZE; i++) {
+        out[2 * i] = digits[in[i] >> 4];
+        out[2 * i + 1] = digits[in[i] & 0x0F];
+    }
+}
+
+void tx_leaf(const char *id, size_t len, uint8_t *out) {
+    if (hex_decode32(id, len, out) != 0) {
+        wire_sha256((const uint8_t*)id, len, out);
+    }
+}
+
+void merkle_root_raw(uint8_t *leaves, size_t count, uint8_t *out) {
+    uint8_t pair[2 * BLOCK_HASH_SIZE];
+
+    if (count == 0) {
+        memset(out, 0, BLOCK_HASH_SIZE);
+        return;
+    }
+
+    while (count > 1) {
+        size_t next = 0;
+        for (size_t i = 0; i < count; i += 2) {
+            const uint8_t *left = leaves + i * BLOCK_HASH_SIZE;
+            const uint8_t *right = i + 1 < count ? left + BLOCK_HASH_SIZE : left;
+            memcpy(pair, left, BLOCK_HASH_SIZE);
+            memcpy(pair + BLOCK_HASH_SIZE, right, BLOCK_HASH_SIZE);
+            wire_sha256(pair, sizeof(pair), leaves + next * BLOCK_HASH_SIZE);
+            next++;
+        }
+        count = next;
+    }
+    memcpy(out, leaves, BLOCK_HASH_SIZE);
+}
@@ -0,0 +1,75 @@
+#ifndef WIRE_H
+#define WIRE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define BLOCK_FORMAT_VERSION 1
+#define BLOCK_HASH_SIZE 32
+#define VARINT_MAX_SIZE 10
+
+// Header layout, little endian:
+//   0  u8   format version
+//   1  u64  height
+//   9  i64  timestamp, microseconds since the Unix epoch (UTC)
+//  17  u32  transaction count
+//  21  [32] previous block hash
+//  53  [32] transaction Merkle root
+//  85  varint length + producer (UTF-8)
+#define BLOCK_HEADER_FIXED_SIZE 85
+
+typedef struct {
+    uint64_t height;
+    int64_t timestamp_us;
+    uint32_t tx_count;
+    uint8_t previous_hash[BLOCK_HASH_SIZE];
+    uint8_t merkle_root[BLOCK_HASH_SIZE];
+    const char *producer;
+    size_t producer_len;
+} block_header_t;
+
+// Transaction body: varint-prefixed id, from and to, f64 value, zigzag
+// varint timestamp (microseconds), then varint-prefixed data and signature
+typedef struct {
+    const char *id;
+    size_t id_len;
+    const char *from;
+    size_t from_len;
+    const char *to;
+    size_t to_len;
+    double value;
+    int64_t timestamp_us;
+    const char *data;
+    size_t data_len;
+    const char *signature;
+    size_t signature_len;
+} tx_fields_t;
+
+size_t varint_size(uint64_t value);
+size_t varint_put(uint8_t *out, uint64_t value);
+// Bytes consumed, or 0 if truncated or overlong
+size_t varint_get(const uint8_t *in, size_t len, uint64_t *value);
+
+size_t header_size(const block_header_t *header);
+size_t header_write(const block_header_t *header, uint8_t *out);
+// Bytes consumed, or 0 if malformed; producer points into in
+size_t header_read(const uint8_t *in, size_t len, block_header_t *header);
+
+size_t tx_size(const tx_fields_t *tx);
+size_t tx_write(const tx_fields_t *tx, uint8_t *out);
+size_t tx_read(const uint8_t *in, size_t len, tx_fields_t *tx);
+
+void wire_sha256(const uint8_t *data, size_t len, uint8_t *out);
+
+// 0 if hex is exactly 64 hex digits, -1 otherwise
+int hex_decode32(const char *hex, size_t len, uint8_t *out);
+void hex_encode32(const uint8_t *in, char *out);
+
+// A 64-hex-digit id is used as is; any other id is hashed to 32 bytes
+void tx_leaf(const char *id, size_t len, uint8_t *out);
+
+// Pairs SHA-256(left || right), repeating the last node on odd levels.
+// Overwrites leaves; the root of zero leaves is all zeros.
+void merkle_root_raw(uint8_t *leaves, size_t count, uint8_t *out);
+
+#endif // WIRE_H
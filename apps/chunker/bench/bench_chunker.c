@@ -0,0 +1,389 @@
+/*
+ * Standalone benchmark for the native chunker
+ * Compression ratio and throughput by level and chunk size, decompression,
+ * SHA-256 checksums, entropy estimation and the chunk pipeline, written
+ * as JSON for tests/performance/native/compare_baseline.py
+ */
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <zlib.h>
+#include "compression.h"
+#include "entropy.h"
+#include "utils.h"
+
+// Constants
+#define CORPUS_SIZE (8 * 1024 * 1024)
+#define QUICK_CORPUS_SIZE (2 * 1024 * 1024)
+#define REPEATS 3                  // Best of, to keep scheduler noise out of the gate
+#define FRAME_WIDTH 1920           // BGRA pixels per row
+#define DEFAULT_LEVEL 6            // Chunker's default compression level
+
+typedef struct {
+    const char *name;
+    uint8_t *data;
+    size_t size;
+} corpus_t;
+
+static double min_seconds = 0.2;
+static int first_result = 1;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static uint64_t xorshift(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+// Desktop-like frames: flat window backgrounds, a gradient title bar and
+// short runs of glyph noise, the content the recorder mostly captures
+static void fill_frames(uint8_t *out, size_t size) {
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    size_t row_bytes = FRAME_WIDTH * 4;
+
+    for (size_t off = 0; off < size; off += 4) {
+        size_t row = (off / row_bytes) % 1080;
+        size_t col = (off % row_bytes) / 4;
+        uint8_t *px = out + off;
+        if (off + 4 > size) {
+            memset(px, 0, size - off);
+            break;
+        }
+        if (row < 32) {
+            px[0] = (uint8_t)(col * 255 / FRAME_WIDTH);
+            px[1] = 0x60;
+            px[2] = 0x30;
+        } else if ((row / 18) % 3 == 1 && col % 240 < 180 && (xorshift(&rng) & 3) == 0) {
+            uint8_t ink = (uint8_t)(xorshift(&rng) & 0x3F);
+            px[0] = px[1] = px[2] = ink;
+        } else {
+            px[0] = col < 320 ? 0x2B : 0xF0;
+            px[1] = col < 320 ? 0x2B : 0xF0;
+            px[2] = col < 320 ? 0x30 : 0xF0;
+        }
+        px[3] = 0xFF;
+    }
+}
+
+// Recorder telemetry serialized as JSON lines
+static void fill_telemetry(uint8_t *out, size_t size) {
+    static const char *const windows[] = {"editor", "terminal", "browser", "mail"};
+    uint64_t rng = 42;
+    size_t off = 0;
+    uint64_t ts = 1700000000000ULL;
+
+    while (off < size) {
+        char line[160];
+        ts += xorshift(&rng) % 40;
+        int n = snprintf(line, sizeof(line),
+                         "{\"ts\":%llu,\"type\":\"key\",\"code\":%u,\"window\":\"%s\",\"cpu\":%u.%u}\n",
+                         (unsigned long long)ts, (unsigned)(xorshift(&rng) % 128),
+                         windows[xorshift(&rng) % 4],
+                         (unsigned)(xorshift(&rng) % 100), (unsigned)(xorshift(&rng) % 10));
+        size_t len = (size_t)n < size - off ? (size_t)n : size - off;
+        memcpy(out + off, line, len);
+        off += len;
+    }
+}
+
+// Stands in for encrypted or already compressed input
+static void fill_random(uint8_t *out, size_t size) {
+    uint64_t rng = 7;
+
+    for (size_t off = 0; off < size; off += 8) {
+        uint64_t v = xorshift(&rng);
+        memcpy(out + off, &v, size - off < 8 ? size - off : 8);
+    }
+}
+
+static void emit_result(const char *name, const char *metrics) {
+    printf("%s\n    \"%s\": {%s}", first_result ? "" : ",", name, metrics);
+    first_result = 0;
+}
+
+// Compress every chunk of the corpus once per pass; returns the best
+// MB/s and the ratio over the whole corpus
+static int bench_compress(const corpus_t *corpus, size_t chunk, int level,
+                          double *mb_per_s, double *ratio) {
+    uint8_t *out = malloc(compressBound((uLong)chunk));
+    double best = 0.0;
+    size_t total_out = 0;
+
+    if (out == NULL) {
+        return -1;
+    }
+    for (int rep = 0; rep < REPEATS; rep++) {
+        size_t bytes = 0;
+        double started = now_seconds();
+        double elapsed = 0.0;
+        do {
+            total_out = 0;
+            for (size_t off = 0; off + chunk <= corpus->size; off += chunk) {
+                size_t out_size = compressBound((uLong)chunk);
+                if (compress_data(corpus->data + off, chunk, out, &out_size, level) != Z_OK) {
+                    free(out);
+                    return -1;
+                }
+                total_out += out_size;
+                bytes += chunk;
+            }
+            elapsed = now_seconds() - started;
+        } while (elapsed < min_seconds);
+        double rate = (double)bytes / elapsed / 1e6;
+        if (rate > best) {
+            best = rate;
+        }
+    }
+    free(out);
+    *mb_per_s = best;
+    *ratio = (double)(corpus->size / chunk * chunk) / (double)total_out;
+    return 0;
+}
+
+static int bench_decompress(const corpus_t *corpus, size_t chunk, double *mb_per_s) {
+    size_t count = corpus->size / chunk;
+    size_t bound = compressBound((uLong)chunk);
+    uint8_t *packed = malloc(count * bound);
+    size_t *sizes = malloc(count * sizeof(size_t));
+    uint8_t *out = malloc(chunk);
+    double best = 0.0;
+    int rc = -1;
+
+    if (packed == NULL || sizes == NULL || out == NULL) {
+        goto done;
+    }
+    for (size_t i = 0; i < count; i++) {
+        sizes[i] = bound;
+        if (compress_data(corpus->data + i * chunk, chunk, packed + i * bound, &sizes[i],
+                          DEFAULT_LEVEL) != Z_OK) {
+            goto done;
+        }
+    }
+    for (int rep = 0; rep < REPEATS; rep++) {
+        size_t bytes = 0;
+        double started = now_seconds();
+        double elapsed = 0.0;
+        do {
+            for (size_t i = 0; i < count; i++) {
+                size_t out_size = chunk;
+                if (decompress_data(packed + i * bound, sizes[i], out, &out_size) != Z_OK) {
+                    goto done;
+                }
+                bytes += out_size;
+            }
+            elapsed = now_seconds() - started;
+        } while (elapsed < min_seconds);
+        double rate = (double)bytes / elapsed / 1e6;
+        if (rate > best) {
+            best = rate;
+        }
+    }
+    *mb_per_s = best;
+    rc = 0;
+
+done:
+    free(packed);
+    free(sizes);
+    free(out);
+    return rc;
+}
+
+static void bench_hash(const corpus_t *corpus, size_t chunk, double *mb_per_s, double *ns_per_op) {
+    char checksum[65];
+    double best = 0.0;
+    double best_ns = 0.0;
+
+    for (int rep = 0; rep < REPEATS; rep++) {
+        size_t bytes = 0;
+        size_t ops = 0;
+        double started = now_seconds();
+        double elapsed = 0.0;
+        do {
+            for (size_t off = 0; off + chunk <= corpus->size; off += chunk) {
+                calculate_checksum(corpus->data + off, chunk, checksum);
+                bytes += chunk;
+                ops++;
+            }
+            elapsed = now_seconds() - started;
+        } while (elapsed < min_seconds);
+        double rate = (double)bytes / elapsed / 1e6;
+        if (rate > best) {
+            best = rate;
+            best_ns = elapsed * 1e9 / (double)ops;
+        }
+    }
+    *mb_per_s = best;
+    *ns_per_op = best_ns;
+}
+
+static void bench_entropy(const corpus_t *corpus, size_t chunk, double *ns_per_op) {
+    entropy_estimate_t est;
+    double best = 0.0;
+
+    for (int rep = 0; rep < REPEATS; rep++) {
+        size_t ops = 0;
+        double started = now_seconds();
+        double elapsed = 0.0;
+        do {
+            for (size_t off = 0; off + chunk <= corpus->size; off += chunk) {
+                entropy_estimate(corpus->data + off, chunk, &est);
+                ops++;
+            }
+            elapsed = now_seconds() - started;
+        } while (elapsed < min_seconds);
+        double ns = elapsed * 1e9 / (double)ops;
+        if (best == 0.0 || ns < best) {
+            best = ns;
+        }
+    }
+    *ns_per_op = best;
+}
+
+// What Chunker.chunk does per block: pick a tier, compress or store,
+// then checksum the stored bytes
+static int bench_pipeline(const corpus_t *corpus, size_t chunk, double *mb_per_s, double *ratio) {
+    uint8_t *out = malloc(compressBound((uLong)chunk));
+    char checksum[65];
+    double best = 0.0;
+    size_t total_out = 0;
+
+    if (out == NULL) {
+        return -1;
+    }
+    for (int rep = 0; rep < REPEATS; rep++) {
+        compression_policy_t policy;
+        size_t bytes = 0;
+        double started = now_seconds();
+        double elapsed = 0.0;
+        policy_init(&policy, 0.0, 1, DEFAULT_LEVEL);
+        do {
+            total_out = 0;
+            for (size_t off = 0; off + chunk <= corpus->size; off += chunk) {
+                entropy_estimate_t est;
+                int level = DEFAULT_LEVEL;
+                size_t out_size = compressBound((uLong)chunk);
+                compression_tier_t tier = policy_select(&policy, corpus->data + off, chunk, &level, &est);
+                if (tier == TIER_STORE) {
+                    memcpy(out, corpus->data + off, chunk);
+                    out_size = chunk;
+                } else if (compress_data(corpus->data + off, chunk, out, &out_size, level) != Z_OK) {
+                    free(out);
+                    return -1;
+                }
+                calculate_checksum(out, out_size, checksum);
+                total_out += out_size;
+                bytes += chunk;
+            }
+            elapsed = now_seconds() - started;
+        } while (elapsed < min_seconds);
+        double rate = (double)bytes / elapsed / 1e6;
+        if (rate > best) {
+            best = rate;
+        }
+    }
+    free(out);
+    *mb_per_s = best;
+    *ratio = (double)(corpus->size / chunk * chunk) / (double)total_out;
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    static const int levels[] = {1, 3, 6, 9};
+    static const size_t chunks[] = {16 * 1024, 64 * 1024, 1024 * 1024};
+    size_t corpus_size = CORPUS_SIZE;
+    char name[128];
+    char metrics[128];
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            corpus_size = QUICK_CORPUS_SIZE;
+            min_seconds = 0.05;
+        } else {
+            fprintf(stderr, "usage: %s [--quick]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    corpus_t corpora[] = {
+        {"frames", malloc(corpus_size), corpus_size},
+        {"telemetry", malloc(corpus_size), corpus_size},
+        {"random", malloc(corpus_size), corpus_size},
+    };
+    const size_t corpus_count = sizeof(corpora) / sizeof(corpora[0]);
+    for (size_t c = 0; c < corpus_count; c++) {
+        if (corpora[c].data == NULL) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+    }
+    fill_frames(corpora[0].data, corpus_size);
+    fill_telemetry(corpora[1].data, corpus_size);
+    fill_random(corpora[2].data, corpus_size);
+
+    printf("{\n  \"suite\": \"chunker_native.c\",\n  \"zlib\": \"%s\",\n  \"results\": {", zlibVersion());
+
+    for (size_t c = 0; c < corpus_count; c++) {
+        const corpus_t *corpus = &corpora[c];
+        double rate, ratio, ns;
+
+        for (size_t s = 0; s < sizeof(chunks) / sizeof(chunks[0]); s++) {
+            for (size_t l = 0; l < sizeof(levels) / sizeof(levels[0]); l++) {
+                if (bench_compress(corpus, chunks[s], levels[l], &rate, &ratio) < 0) {
+                    fprintf(stderr, "compress failed: %s\n", corpus->name);
+                    return 1;
+                }
+                snprintf(name, sizeof(name), "compress/%s/level=%d/chunk=%zu",
+                         corpus->name, levels[l], chunks[s]);
+                snprintf(metrics, sizeof(metrics), "\"mb_per_s\": %.2f, \"ratio\": %.4f", rate, ratio);
+                emit_result(name, metrics);
+            }
+
+            if (bench_decompress(corpus, chunks[s], &rate) < 0) {
+                fprintf(stderr, "decompress failed: %s\n", corpus->name);
+                return 1;
+            }
+            snprintf(name, sizeof(name), "decompress/%s/chunk=%zu", corpus->name, chunks[s]);
+            snprintf(metrics, sizeof(metrics), "\"mb_per_s\": %.2f", rate);
+            emit_result(name, metrics);
+
+            if (bench_pipeline(corpus, chunks[s], &rate, &ratio) < 0) {
+                fprintf(stderr, "pipeline failed: %s\n", corpus->name);
+                return 1;
+            }
+            snprintf(name, sizeof(name), "pipeline/%s/chunk=%zu", corpus->name, chunks[s]);
+            snprintf(metrics, sizeof(metrics), "\"mb_per_s\": %.2f, \"ratio\": %.4f", rate, ratio);
+            emit_result(name, metrics);
+        }
+
+        bench_entropy(corpus, 64 * 1024, &ns);
+        snprintf(name, sizeof(name), "entropy/%s/chunk=65536", corpus->name);
+        snprintf(metrics, sizeof(metrics), "\"ns_per_op\": %.0f", ns);
+        emit_result(name, metrics);
+    }
+
+    // Checksum cost does not depend on content
+    for (size_t s = 0; s < sizeof(chunks) / sizeof(chunks[0]); s++) {
+        double rate, ns;
+        bench_hash(&corpora[2], chunks[s], &rate, &ns);
+        snprintf(name, sizeof(name), "sha256/chunk=%zu", chunks[s]);
+        snprintf(metrics, sizeof(metrics), "\"mb_per_s\": %.2f, \"ns_per_op\": %.0f", rate, ns);
+        emit_result(name, metrics);
+    }
+
+    printf("\n  }\n}\n");
+    for (size_t c = 0; c < corpus_count; c++) {
+        free(corpora[c].data);
+    }
+    return 0;
+}
@@ -11,7 +11,7 @@ Handles data chunking, compression, and processing for session recordings
 import asyncio
 import logging
 import time
-from typing import Optional, Dict, Any, List, Union
+from typing import Optional, Dict, Any, List, Tuple, Union
 from dataclasses import dataclass
 from enum import Enum
 import structlog
@@ -26,6 +26,14 @@ from pathlib import Path
 
 logger = structlog.get_logger(__name__)
 
+# Entropy estimation for adaptive compression
+try:
+    import chunker_native
+    CHUNKER_NATIVE_AVAILABLE = True
+except ImportError:
+    CHUNKER_NATIVE_AVAILABLE = False
+    logger.warning("chunker_native not available, compressing every chunk at the configured level")
+
 
 class CompressionAlgorithm(Enum):
     """Supported compression algorithms"""
@@ -74,12 +82,15 @@ class ChunkProcessor:
         chunk_size_mb: int = 8,
         compression_level: int = 3,
         algorithm: CompressionAlgorithm = CompressionAlgorithm.ZSTD,
-        max_queue_size: int = 1000
+        max_queue_size: int = 1000,
+        adaptive: bool = True,
+        target_mbps: float = 0.0
     ):
         self.chunk_size_bytes = chunk_size_mb * 1024 * 1024
         self.compression_level = compression_level
         self.algorithm = algorithm
         self.max_queue_size = max_queue_size
+        self.target_mbps = target_mbps
         
         # Processing queues
         self.input_queue: asyncio.Queue = asyncio.Queue(maxsize=max_queue_size)
@@ -88,6 +99,13 @@ class ChunkProcessor:
         # Compression contexts
         self.zstd_compressor = None
         self.zstd_decompressor = None
+        self.zstd_compressors: Dict[int, zstd.ZstdCompressor] = {}
+        
+        # Per-chunk store/LZ4/zstd-low/zstd-high selection; only applies when
+        # the configured algorithm is zstd, which the other tiers fall back from
+        self.compression_policy = None
+        self.adaptive = (adaptive and CHUNKER_NATIVE_AVAILABLE
+                         and algorithm == CompressionAlgorithm.ZSTD)
         
         # Statistics
         self.stats = {
@@ -119,6 +137,14 @@ class ChunkProcessor:
                     threads=-1
                 )
                 self.zstd_decompressor = zstd.ZstdDecompressor()
+                self.zstd_compressors[self.compression_level] = self.zstd_compressor
+            
+            if self.adaptive:
+                self.compression_policy = chunker_native.CompressionPolicy(
+                    target_mbps=self.target_mbps,
+                    low_level=1,
+                    high_level=max(1, self.compression_level)
+                )
             
             logger.info("Chunk processor initialized successfully")
             return True
@@ -269,16 +295,29 @@ class ChunkProcessor:
             original_size = len(self.current_chunk_data)
             
             # Compress the data
-            start_time = time.time()
-            compressed_data = await self._compress_data(self.current_chunk_data)
-            compression_time = time.time() - start_time
+            start_time = time.perf_counter()
+            compressed_data, algorithm = await self._compress_data(self.current_chunk_data)
+            compression_time = time.perf_counter() - start_time
+            
+            if CHUNKER_NATIVE_AVAILABLE:
+                # Same histograms the native codecs feed, so p99 is comparable
+                chunker_native.observe(chunker_native.OP_COMPRESS, compression_time,
+                                       original_size, len(compressed_data))
+            
+            # Stored chunks cost a copy, not a compression, and would pull
+            # the measured rate up until the level stepped back too high
+            if self.compression_policy and algorithm != CompressionAlgorithm.NONE:
+                self.compression_policy.record(original_size, compression_time)
             
             compressed_size = len(compressed_data)
             compression_ratio = original_size / compressed_size if compressed_size > 0 else 1.0
             
             # Calculate checksum
-            import hashlib
-            checksum = hashlib.sha256(compressed_data).hexdigest()
+            if CHUNKER_NATIVE_AVAILABLE:
+                checksum = chunker_native.checksum(compressed_data)
+            else:
+                import hashlib
+                checksum = hashlib.sha256(compressed_data).hexdigest()
             
             # Create chunk metadata
             chunk_metadata = ChunkMetadata(
@@ -288,7 +327,7 @@ class ChunkProcessor:
                 size=original_size,
                 compressed_size=compressed_size,
                 compression_ratio=compression_ratio,
-                algorithm=self.algorithm,
+                algorithm=algorithm,
                 checksum=checksum
             )
             
@@ -298,7 +337,7 @@ class ChunkProcessor:
                 chunk_type=ChunkType.VIDEO_FRAME,
                 data=compressed_data,
                 metadata=chunk_metadata,
-                compressed=True
+                compressed=algorithm != CompressionAlgorithm.NONE
             )
             
             # Add to output queue
@@ -328,38 +367,65 @@ class ChunkProcessor:
             logger.error("Failed to create chunk", error=str(e))
             self.stats['errors'] += 1
     
-    async def _compress_data(self, data: bytes) -> bytes:
-        """Compress data using the configured algorithm"""
+    def _zstd_at(self, level: int) -> zstd.ZstdCompressor:
+        """Get a cached zstd compressor for a level"""
+        compressor = self.zstd_compressors.get(level)
+        if compressor is None:
+            compressor = zstd.ZstdCompressor(level=level, threads=-1)
+            self.zstd_compressors[level] = compressor
+        return compressor
+    
+    async def _compress_data(self, data: bytes) -> Tuple[bytes, CompressionAlgorithm]:
+        """Compress data, choosing the codec per chunk when adaptive"""
         try:
+            if self.compression_policy:
+                tier, level = self.compression_policy.select(data)
+                if tier == chunker_native.TIER_STORE:
+                    return data, CompressionAlgorithm.NONE
+                if tier == chunker_native.TIER_FAST:
+                    return lz4.frame.compress(data), CompressionAlgorithm.LZ4
+                return self._zstd_at(level).compress(data), CompressionAlgorithm.ZSTD
+            
             if self.algorithm == CompressionAlgorithm.ZSTD:
-                return self.zstd_compressor.compress(data)
+                return self.zstd_compressor.compress(data), self.algorithm
             elif self.algorithm == CompressionAlgorithm.LZ4:
-                return lz4.frame.compress(data, compression_level=self.compression_level)
+                return lz4.frame.compress(data, compression_level=self.compression_level), self.algorithm
             elif self.algorithm == CompressionAlgorithm.BROTLI:
-                return brotli.compress(data, quality=self.compression_level)
+                return brotli.compress(data, quality=self.compression_level), self.algorithm
             else:
-                return data  # No compression
+                return data, CompressionAlgorithm.NONE  # No compression
                 
         except Exception as e:
             logger.error("Failed to compress data", error=str(e))
             self.stats['errors'] += 1
-            return data
+            return data, CompressionAlgorithm.NONE
     
-    async def decompress_data(self, data: bytes) -> bytes:
-        """Decompress data using the configured algorithm"""
+    async def decompress_data(self, data: bytes,
+                              algorithm: Optional[CompressionAlgorithm] = None) -> bytes:
+        """Decompress data using the chunk's algorithm (default: the configured one)"""
+        algorithm = algorithm or self.algorithm
+        start_time = time.perf_counter()
         try:
-            if self.algorithm == CompressionAlgorithm.ZSTD:
-                return self.zstd_decompressor.decompress(data)
-            elif self.algorithm == CompressionAlgorithm.LZ4:
-                return lz4.frame.decompress(data)
-            elif self.algorithm == CompressionAlgorithm.BROTLI:
-                return brotli.decompress(data)
+            if algorithm == CompressionAlgorithm.ZSTD:
+                result = self.zstd_decompressor.decompress(data)
+            elif algorithm == CompressionAlgorithm.LZ4:
+                result = lz4.frame.decompress(data)
+            elif algorithm == CompressionAlgorithm.BROTLI:
+                result = brotli.decompress(data)
             else:
                 return data  # No compression
+            
+            if CHUNKER_NATIVE_AVAILABLE:
+                chunker_native.observe(chunker_native.OP_DECOMPRESS, time.perf_counter() - start_time,
+                                       len(data), len(result))
+            return result
                 
         except Exception as e:
             logger.error("Failed to decompress data", error=str(e))
             self.stats['errors'] += 1
+            if CHUNKER_NATIVE_AVAILABLE:
+                chunker_native.observe(chunker_native.OP_DECOMPRESS, time.perf_counter() - start_time,
+                                       len(data), 0, ok=False)
             return data
     
     def _generate_chunk_id(self) -> str:
@@ -372,6 +438,13 @@ class ChunkProcessor:
         return {
             'is_processing': self.is_processing,
             'stats': self.stats,
+            'compression_policy': {
+                'level': self.compression_policy.level,
+                'degraded': self.compression_policy.degraded,
+                'throughput_mbps': self.compression_policy.throughput_mbps,
+                'tier_counts': list(self.compression_policy.tier_counts)
+            } if self.compression_policy else None,
+            'native_latency': chunker_native.snapshot() if CHUNKER_NATIVE_AVAILABLE else None,
             'queue_sizes': {
                 'input': self.input_queue.qsize(),
                 'output': self.output_queue.qsize()
@@ -418,7 +491,9 @@ class ChunkerService:
                 'chunk_size_mb': 8,
                 'compression_level': 3,
                 'algorithm': CompressionAlgorithm.ZSTD,
-                'max_queue_size': 1000
+                'max_queue_size': 1000,
+                'adaptive': True,
+                'target_mbps': 0.0
             }
             
             if config:
@@ -429,7 +504,9 @@ class ChunkerService:
                 chunk_size_mb=default_config['chunk_size_mb'],
                 compression_level=default_config['compression_level'],
                 algorithm=default_config['algorithm'],
-                max_queue_size=default_config['max_queue_size']
+                max_queue_size=default_config['max_queue_size'],
+                adaptive=default_config['adaptive'],
+                target_mbps=default_config['target_mbps']
             )
             
             # Initialize processor
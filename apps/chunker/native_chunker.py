@@ -33,10 +33,20 @@ except ImportError:
 class NativeChunker:
     """High-performance native chunker"""
     
-    def __init__(self, chunk_size_mb: int = 8, compression_level: int = 3):
+    def __init__(self, chunk_size_mb: int = 8, compression_level: int = 3,
+                 target_mbps: float = 0.0, telemetry: Any = None,
+                 session_id: Optional[str] = None, compression_threads: int = 0):
         self.chunk_size_bytes = chunk_size_mb * 1024 * 1024
         self.compression_level = compression_level
+        self.target_mbps = target_mbps
+        # Threads deflating one large chunk (0: one per CPU, 1: inline);
+        # the output is the same single zlib stream either way
+        self.compression_threads = compression_threads
         self.native_chunker = None
+        # Event processor whose record_performance queues a fixed-layout
+        # record per chunk (seconds taken, bytes in) without blocking
+        self.telemetry = telemetry
+        self.session_id = session_id
         
         # Statistics
         self.stats = {
@@ -57,11 +67,15 @@ class NativeChunker:
         try:
             self.native_chunker = chunker_native.Chunker(
                 chunk_size=self.chunk_size_bytes,
-                compression_level=self.compression_level
+                compression_level=self.compression_level,
+                target_mbps=self.target_mbps,
+                threads=self.compression_threads
             )
             logger.info("Native chunker initialized", 
                        chunk_size_mb=self.chunk_size_bytes // (1024 * 1024),
-                       compression_level=self.compression_level)
+                       compression_level=self.compression_level,
+                       target_mbps=self.target_mbps,
+                       compression_threads=self.compression_threads)
         except Exception as e:
             logger.error("Failed to initialize native chunker", error=str(e))
             self.native_chunker = None
@@ -96,6 +110,11 @@ class NativeChunker:
                     len(data) / result['compressed_size']
                 )
             
+            if self.telemetry is not None:
+                self.telemetry.record_performance(processing_time, len(data),
+                                                  session=self.session_id,
+                                                  payload=chunk_id)
+            
             return result
             
         except Exception as e:
@@ -103,10 +122,21 @@ class NativeChunker:
             return None
     
     async def _chunk_native(self, data: bytes, chunk_id: str = None) -> Optional[Dict[str, Any]]:
-        """Chunk data using native implementation"""
+        """
+        Chunk data using native implementation
+        
+        The chunk 'data' is a PooledBuffer: bytes-like, with its block going
+        back to the buffer pool once the caller releases or drops it.
+        """
         try:
-            # Call native chunker
-            result = self.native_chunker.chunk(data)
+            # Call native chunker on the worker pool, off the event loop, and
+            # keep the output in its pooled block rather than copying to bytes
+            try:
+                result = await self.native_chunker.chunk_async(data, pooled=True)
+            except asyncio.QueueFull:
+                # The pool's backlog is full; chunking inline holds this
+                # producer to the rate the workers keep up with
+                result = self.native_chunker.chunk(data, pooled=True)
             
             if result:
                 return {
@@ -116,6 +146,8 @@ class NativeChunker:
                     'compressed_size': len(result['data']),
                     'compression_ratio': len(data) / len(result['data']),
                     'algorithm': result.get('algorithm', 'native'),
+                    'level': result.get('level', self.compression_level),
+                    'entropy': result.get('entropy', 0.0),
                     'checksum': result.get('checksum', ''),
                     'timestamp': time.time(),
                     'native': True
@@ -156,7 +188,10 @@ class NativeChunker:
     async def decompress_chunk(self, chunk_data: bytes, algorithm: str = 'native') -> Optional[bytes]:
         """Decompress a chunk"""
         try:
-            if NATIVE_AVAILABLE and self.native_chunker and algorithm == 'native':
+            if algorithm == 'none':
+                # Stored as-is because the input was already incompressible
+                return chunk_data
+            elif NATIVE_AVAILABLE and self.native_chunker and algorithm == 'native':
                 # Use native decompression
                 return self.native_chunker.decompress(chunk_data)
             else:
@@ -175,7 +210,14 @@ class NativeChunker:
             'native_available': NATIVE_AVAILABLE,
             'native_initialized': self.native_chunker is not None,
             'chunk_size_mb': self.chunk_size_bytes // (1024 * 1024),
-            'compression_level': self.compression_level
+            'compression_level': self.compression_level,
+            'current_level': self.native_chunker.level if self.native_chunker else self.compression_level,
+            'tier_counts': list(self.native_chunker.tier_counts) if self.native_chunker else [],
+            # Measured inside the extension, without queueing or GIL waits
+            'native_latency': chunker_native.snapshot() if NATIVE_AVAILABLE else None,
+            'cpu_features': chunker_native.cpu_features() if NATIVE_AVAILABLE else None,
+            'native_pool': chunker_native.pool_stats() if NATIVE_AVAILABLE else None,
+            'buffer_pool': chunker_native.buffer_pool_stats() if NATIVE_AVAILABLE else None
         }
     
     async def cleanup(self):
@@ -223,7 +265,10 @@ class NativeChunkerService:
             # Default configuration
             default_config = {
                 'chunk_size_mb': 8,
-                'compression_level': 3
+                'compression_level': 3,
+                'target_mbps': 0.0,
+                'compression_threads': 0,
+                'telemetry': None
             }
             
             if config:
@@ -232,7 +277,11 @@ class NativeChunkerService:
             # Create chunker
             chunker = NativeChunker(
                 chunk_size_mb=default_config['chunk_size_mb'],
-                compression_level=default_config['compression_level']
+                compression_level=default_config['compression_level'],
+                target_mbps=default_config['target_mbps'],
+                telemetry=default_config['telemetry'],
+                session_id=session_id,
+                compression_threads=default_config['compression_threads']
             )
             
             self.chunkers[session_id] = chunker
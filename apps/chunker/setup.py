@@ -7,22 +7,39 @@ x-lucid-file-type: python
 Setup script for native chunker extension
 """
 
-from setuptools import setup, Extension
-import numpy as np
+from setuptools import setup, Extension, Command
+import os
+import subprocess
+import sysconfig
 
-# Define the extension module
+# Helpers shared with the encryptor extension (op stats, async pool, buffer
+# pool, pooled buffers) are built from one copy in apps/native_common
+NATIVE_COMMON_DIR = '../native_common/src/'
+NATIVE_COMMON_SOURCES = [
+    NATIVE_COMMON_DIR + 'async_pool.c',
+    NATIVE_COMMON_DIR + 'buffer_pool.c',
+    NATIVE_COMMON_DIR + 'op_stats.c',
+    NATIVE_COMMON_DIR + 'pooled_buffer.c'
+]
+
+# Define the extension module. CPU-specific kernels are selected at import,
+# so the same build runs on x86-64 servers and aarch64 (Pi) nodes.
 chunker_native = Extension(
     'chunker_native',
     sources=[
         'src/chunker.c',
         'src/compression.c',
+        'src/cpu_features.c',
+        'src/crc32.c',
+        'src/entropy.c',
+        'src/parallel_deflate.c',
         'src/utils.c'
-    ],
+    ] + NATIVE_COMMON_SOURCES,
     include_dirs=[
-        np.get_include(),
-        'src/'
+        'src/',
+        NATIVE_COMMON_DIR
     ],
-    libraries=['z'],
+    libraries=['z', 'crypto', 'm', 'pthread'],
     library_dirs=[],
     extra_compile_args=[
         '-O3',
@@ -34,12 +51,58 @@ chunker_native = Extension(
     extra_link_args=['-shared']
 )
 
+
+class BenchCommand(Command):
+    """Build and run the standalone C benchmark (bench/bench_chunker.c)"""
+    
+    description = 'build and run the native chunker benchmark'
+    user_options = [
+        ('output=', 'o', 'write JSON results to this file instead of stdout'),
+        ('quick', 'q', 'smaller corpora and shorter timing loops'),
+    ]
+    
+    def initialize_options(self):
+        self.output = None
+        self.quick = False
+    
+    def finalize_options(self):
+        pass
+    
+    def run(self):
+        from distutils.ccompiler import new_compiler
+        from distutils.sysconfig import customize_compiler
+        
+        compiler = new_compiler()
+        customize_compiler(compiler)
+        build_dir = os.path.join('build', 'bench')
+        
+        # The extension's sources minus the parts that need Python
+        python_sources = ('src/chunker.c', NATIVE_COMMON_DIR + 'async_pool.c', NATIVE_COMMON_DIR + 'pooled_buffer.c')
+        sources = [src for src in chunker_native.sources if src not in python_sources]
+        objects = compiler.compile(
+            sources + ['bench/bench_chunker.c'],
+            output_dir=build_dir,
+            include_dirs=chunker_native.include_dirs + [sysconfig.get_paths()['include']],
+            extra_postargs=[arg for arg in chunker_native.extra_compile_args if arg != '-fPIC'],
+        )
+        binary = os.path.join(build_dir, 'bench_chunker')
+        compiler.link_executable(objects, binary, libraries=chunker_native.libraries)
+        
+        args = [binary] + (['--quick'] if self.quick else [])
+        if self.output:
+            with open(self.output, 'w') as out:
+                subprocess.run(args, stdout=out, check=True)
+        else:
+            subprocess.run(args, check=True)
+
+
 setup(
     name='chunker-native',
     version='0.1.0',
     description='Native chunker extension for Lucid RDP',
     ext_modules=[chunker_native],
-    python_requires='>=3.8',
+    cmdclass={'bench': BenchCommand},
+    python_requires='>=3.9',
     install_requires=[
         'numpy>=1.19.0'
     ],
@@ -49,9 +112,10 @@ setup(
         'License :: OSI Approved :: MIT License',
         'Programming Language :: C',
         'Programming Language :: Python :: 3',
-        'Programming Language :: Python :: 3.8',
         'Programming Language :: Python :: 3.9',
         'Programming Language :: Python :: 3.10',
         'Programming Language :: Python :: 3.11',
+        'Programming Language :: Python :: 3.12',
+        'Programming Language :: Python :: 3.13',
     ],
 )
@@ -3,8 +3,9 @@
  * High-performance data chunking and compression
  */
 
+#define PY_SSIZE_T_CLEAN
 #include <Python.h>
-#include <numpy/arrayobject.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -13,47 +14,165 @@
 #include "chunker.h"
 #include "compression.h"
 #include "utils.h"
+#include "entropy.h"
+#include "cpu_features.h"
+#include "crc32.h"
+#include "async_pool.h"
+#include "pooled_buffer.h"
+#include "parallel_deflate.h"
 
 #define MAX_CHUNK_SIZE (100 * 1024 * 1024)  // 100MB max chunk size
 
+#ifndef Py_TPFLAGS_IMMUTABLETYPE
+#define Py_TPFLAGS_IMMUTABLETYPE 0
+#endif
+
+// Per-module state; each interpreter that imports the module gets its own
+typedef struct {
+    PyTypeObject *chunker_type;
+    PyTypeObject *policy_type;
+    PyTypeObject *buffer_type;
+    PyObject *pool;  // Workers behind chunk_async
+} chunker_state;
+
+static struct PyModuleDef chunker_module;
+
+static chunker_state* chunker_state_of(PyTypeObject *type) {
+#if PY_VERSION_HEX >= 0x030B0000
+    PyObject *module = PyType_GetModuleByDef(type, &chunker_module);
+#else
+    PyObject *module = PyType_GetModule(type);
+#endif
+    return module ? PyModule_GetState(module) : NULL;
+}
+
+// Output buffers come from the shared buffer pool but are still charged
+// to the allocation counters
+static void* chunker_buffer_alloc(size_t size) {
+    void *ptr = buffer_pool_alloc(size);
+    op_stats_alloc(&chunker_op_stats, size, ptr != NULL);
+    return ptr;
+}
+
+// Native output as a PooledBuffer when pooled_type is given, otherwise
+// copied into bytes; the pooled block is consumed either way
+static PyObject* chunker_buffer_result(PyTypeObject *pooled_type, char *data, size_t size) {
+    if (pooled_type != NULL) {
+        return pooled_buffer_wrap(pooled_type, data, size);
+    }
+    PyObject *ret = PyBytes_FromStringAndSize(data, (Py_ssize_t)size);
+    buffer_pool_free(data);
+    return ret;
+}
+
 typedef struct {
     PyObject_HEAD
     size_t chunk_size;
     int compression_level;
     z_stream zstream;
     int zstream_initialized;
+    int adaptive;
+    int threads;            // Parallel deflate of large blocks unless 1
+    size_t block_size;      // Parallel deflate split, 0 for the default
+    // Guards the settings and policy: without a GIL, or with several
+    // async jobs for one chunker, blocks are chunked in parallel
+    pthread_mutex_t lock;
+    compression_policy_t policy;
 } ChunkerObject;
 
-static PyTypeObject ChunkerType;
+typedef struct {
+    PyObject_HEAD
+    pthread_mutex_t lock;
+    compression_policy_t policy;
+} PolicyObject;
 
 // Forward declarations
 static PyObject* Chunker_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
 static void Chunker_dealloc(ChunkerObject *self);
 static int Chunker_init(ChunkerObject *self, PyObject *args, PyObject *kwds);
-static PyObject* Chunker_chunk(ChunkerObject *self, PyObject *args);
-static PyObject* Chunker_decompress(ChunkerObject *self, PyObject *args);
+static PyObject* Chunker_chunk(ChunkerObject *self, PyObject *args, PyObject *kwds);
+static PyObject* Chunker_chunk_async(ChunkerObject *self, PyObject *args, PyObject *kwds);
+static PyObject* Chunker_decompress(ChunkerObject *self, PyObject *args, PyObject *kwds);
 static PyObject* Chunker_cleanup(ChunkerObject *self, PyObject *args);
+static PyObject* Chunker_get_level(ChunkerObject *self, void *closure);
+static PyObject* Chunker_get_tier_counts(ChunkerObject *self, void *closure);
+static PyObject* Policy_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
+static void Policy_dealloc(PolicyObject *self);
+static int Policy_init(PolicyObject *self, PyObject *args, PyObject *kwds);
+static PyObject* Policy_select(PolicyObject *self, PyObject *args);
+static PyObject* Policy_record(PolicyObject *self, PyObject *args);
+static PyObject* Policy_get_level(PolicyObject *self, void *closure);
+static PyObject* Policy_get_degraded(PolicyObject *self, void *closure);
+static PyObject* Policy_get_throughput(PolicyObject *self, void *closure);
+static PyObject* Policy_get_tier_counts(PolicyObject *self, void *closure);
 
 // Method definitions
 static PyMethodDef Chunker_methods[] = {
-    {"chunk", (PyCFunction)Chunker_chunk, METH_VARARGS, "Chunk and compress data"},
-    {"decompress", (PyCFunction)Chunker_decompress, METH_VARARGS, "Decompress data"},
+    {"chunk", (PyCFunction)(void(*)(void))Chunker_chunk, METH_VARARGS | METH_KEYWORDS,
+     "Chunk and compress data; pooled=True returns the data as a PooledBuffer"},
+    {"chunk_async", (PyCFunction)(void(*)(void))Chunker_chunk_async, METH_VARARGS | METH_KEYWORDS,
+     "Chunk on the native worker pool; returns a future of the running loop"},
+    {"decompress", (PyCFunction)(void(*)(void))Chunker_decompress, METH_VARARGS | METH_KEYWORDS,
+     "Decompress data"},
     {"cleanup", (PyCFunction)Chunker_cleanup, METH_NOARGS, "Cleanup resources"},
     {NULL, NULL, 0, NULL}
 };
 
+static PyGetSetDef Chunker_getset[] = {
+    {"level", (getter)Chunker_get_level, NULL, "Level the adaptive policy uses for compressible data", NULL},
+    {"tier_counts", (getter)Chunker_get_tier_counts, NULL, "Blocks chunked per tier", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PyMethodDef Policy_methods[] = {
+    {"select", (PyCFunction)Policy_select, METH_VARARGS, "Return (tier, level) for a block"},
+    {"record", (PyCFunction)Policy_record, METH_VARARGS, "Record bytes compressed and seconds spent; skip stored chunks"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef Policy_getset[] = {
+    {"level", (getter)Policy_get_level, NULL, "Current level for the high tier", NULL},
+    {"degraded", (getter)Policy_get_degraded, NULL, "Whether tiers are shifted down to meet the target", NULL},
+    {"throughput_mbps", (getter)Policy_get_throughput, NULL, "Throughput over the last controller window", NULL},
+    {"tier_counts", (getter)Policy_get_tier_counts, NULL, "Blocks selected per tier", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
 // Type definition
-static PyTypeObject ChunkerType = {
-    PyVarObject_HEAD_INIT(NULL, 0)
-    .tp_name = "chunker_native.Chunker",
-    .tp_doc = "Native chunker for high-performance data processing",
-    .tp_basicsize = sizeof(ChunkerObject),
-    .tp_itemsize = 0,
-    .tp_flags = Py_TPFLAGS_DEFAULT,
-    .tp_new = Chunker_new,
-    .tp_init = (initproc)Chunker_init,
-    .tp_dealloc = (destructor)Chunker_dealloc,
-    .tp_methods = Chunker_methods,
+static PyType_Slot Chunker_slots[] = {
+    {Py_tp_doc, "Native chunker for high-performance data processing"},
+    {Py_tp_new, Chunker_new},
+    {Py_tp_init, Chunker_init},
+    {Py_tp_dealloc, Chunker_dealloc},
+    {Py_tp_methods, Chunker_methods},
+    {Py_tp_getset, Chunker_getset},
+    {0, NULL}
+};
+
+static PyType_Spec Chunker_spec = {
+    .name = "chunker_native.Chunker",
+    .basicsize = sizeof(ChunkerObject),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_IMMUTABLETYPE,
+    .slots = Chunker_slots,
+};
+
+static PyType_Slot Policy_slots[] = {
+    {Py_tp_doc, "Entropy-driven compression tier selection with a throughput feedback loop"},
+    {Py_tp_new, Policy_new},
+    {Py_tp_init, Policy_init},
+    {Py_tp_dealloc, Policy_dealloc},
+    {Py_tp_methods, Policy_methods},
+    {Py_tp_getset, Policy_getset},
+    {0, NULL}
+};
+
+static PyType_Spec Policy_spec = {
+    .name = "chunker_native.CompressionPolicy",
+    .basicsize = sizeof(PolicyObject),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_IMMUTABLETYPE,
+    .slots = Policy_slots,
 };
 
 // Module methods
@@ -61,17 +180,19 @@ static PyObject* chunker_version(PyObject *self, PyObject *args) {
     return PyUnicode_FromString("0.1.0");
 }
 
-static PyObject* chunker_compress_data(PyObject *self, PyObject *args) {
+static PyObject* chunker_compress_data(PyObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"data", "compression_level", "pooled", NULL};
     Py_buffer data;
     int compression_level = 6;
+    int pooled = 0;
     
-    if (!PyArg_ParseTuple(args, "y*|i", &data, &compression_level)) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|i$p", kwlist, &data, &compression_level, &pooled)) {
         return NULL;
     }
     
     // Compress data using zlib
     size_t compressed_size = data.len * 2;  // Estimate compressed size
-    char *compressed = malloc(compressed_size);
+    char *compressed = chunker_buffer_alloc(compressed_size);
     if (!compressed) {
         PyBuffer_Release(&data);
         PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory for compression");
@@ -84,26 +205,29 @@ static PyObject* chunker_compress_data(PyObject *self, PyObject *args) {
     
     PyObject *ret = NULL;
     if (result == Z_OK) {
-        ret = PyBytes_FromStringAndSize(compressed, compressed_size);
+        chunker_state *state = PyModule_GetState(self);
+        ret = chunker_buffer_result(pooled ? state->buffer_type : NULL, compressed, compressed_size);
     } else {
+        buffer_pool_free(compressed);
         PyErr_SetString(PyExc_RuntimeError, "Compression failed");
     }
     
-    free(compressed);
     PyBuffer_Release(&data);
     return ret;
 }
 
-static PyObject* chunker_decompress_data(PyObject *self, PyObject *args) {
+static PyObject* chunker_decompress_data(PyObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"data", "pooled", NULL};
     Py_buffer data;
+    int pooled = 0;
     
-    if (!PyArg_ParseTuple(args, "y*", &data)) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|$p", kwlist, &data, &pooled)) {
         return NULL;
     }
     
     // Decompress data using zlib
     size_t decompressed_size = data.len * 4;  // Estimate decompressed size
-    char *decompressed = malloc(decompressed_size);
+    char *decompressed = chunker_buffer_alloc(decompressed_size);
     if (!decompressed) {
         PyBuffer_Release(&data);
         PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory for decompression");
@@ -115,20 +239,425 @@ static PyObject* chunker_decompress_data(PyObject *self, PyObject *args) {
     
     PyObject *ret = NULL;
     if (result == Z_OK) {
-        ret = PyBytes_FromStringAndSize(decompressed, decompressed_size);
+        chunker_state *state = PyModule_GetState(self);
+        ret = chunker_buffer_result(pooled ? state->buffer_type : NULL, decompressed, decompressed_size);
     } else {
+        buffer_pool_free(decompressed);
         PyErr_SetString(PyExc_RuntimeError, "Decompression failed");
     }
     
-    free(decompressed);
     PyBuffer_Release(&data);
     return ret;
 }
 
+// Checks the thread count and block size taken by the parallel deflate
+// entry points; 0 picks the default for either
+static int parse_parallel(int threads, Py_ssize_t block_size) {
+    if (threads < 0 || threads > PDEFLATE_MAX_THREADS) {
+        PyErr_SetString(PyExc_ValueError, "Invalid thread count");
+        return -1;
+    }
+    if (block_size != 0 && (block_size < (Py_ssize_t)PDEFLATE_MIN_BLOCK ||
+                            block_size > (Py_ssize_t)PDEFLATE_MAX_BLOCK)) {
+        PyErr_SetString(PyExc_ValueError, "Invalid block size");
+        return -1;
+    }
+    return 0;
+}
+
+static PyObject* chunker_compress_parallel(PyObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"data", "compression_level", "threads", "block_size",
+                             "format", "independent", "pooled", NULL};
+    Py_buffer data;
+    int compression_level = 6;
+    int threads = 0;
+    Py_ssize_t block_size = 0;
+    const char *format = "zlib";
+    int independent = 0;
+    int pooled = 0;
+    
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|iinsp$p", kwlist, &data, &compression_level,
+                                     &threads, &block_size, &format, &independent, &pooled)) {
+        return NULL;
+    }
+    
+    pdeflate_options_t opts = {
+        .level = compression_level,
+        .threads = threads,
+        .block_size = (size_t)block_size,
+        .independent = independent,
+    };
+    if (compression_level < 0 || compression_level > 9) {
+        PyErr_SetString(PyExc_ValueError, "Invalid compression level");
+    } else if (strcmp(format, "zlib") != 0 && strcmp(format, "gzip") != 0) {
+        PyErr_SetString(PyExc_ValueError, "format must be 'zlib' or 'gzip'");
+    } else {
+        parse_parallel(threads, block_size);
+    }
+    if (PyErr_Occurred()) {
+        PyBuffer_Release(&data);
+        return NULL;
+    }
+    opts.format = strcmp(format, "gzip") == 0 ? PDEFLATE_GZIP : PDEFLATE_ZLIB;
+    
+    size_t compressed_size = pdeflate_bound((size_t)data.len, &opts);
+    char *compressed = chunker_buffer_alloc(compressed_size);
+    if (!compressed) {
+        PyBuffer_Release(&data);
+        PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory for compression");
+        return NULL;
+    }
+    
+    int result;
+    Py_BEGIN_ALLOW_THREADS
+    result = pdeflate_compress((const uint8_t*)data.buf, (size_t)data.len,
+                               (uint8_t*)compressed, &compressed_size, &opts);
+    Py_END_ALLOW_THREADS
+    
+    PyObject *ret = NULL;
+    if (result == Z_OK) {
+        chunker_state *state = PyModule_GetState(self);
+        ret = chunker_buffer_result(pooled ? state->buffer_type : NULL, compressed, compressed_size);
+    } else {
+        buffer_pool_free(compressed);
+        PyErr_SetString(result == Z_MEM_ERROR ? PyExc_MemoryError : PyExc_RuntimeError,
+                        "Compression failed");
+    }
+    
+    PyBuffer_Release(&data);
+    return ret;
+}
+
+static PyObject* chunker_decompress_parallel(PyObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"data", "threads", "pooled", "max_output", NULL};
+    Py_buffer data;
+    int threads = 0;
+    int pooled = 0;
+    Py_ssize_t max_output = 0;
+    
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|i$pn", kwlist, &data, &threads, &pooled,
+                                     &max_output)) {
+        return NULL;
+    }
+    if (max_output < 0) {
+        PyErr_SetString(PyExc_ValueError, "max_output must not be negative");
+    } else {
+        parse_parallel(threads, 0);
+    }
+    if (PyErr_Occurred()) {
+        PyBuffer_Release(&data);
+        return NULL;
+    }
+    
+    uint8_t *decompressed = NULL;
+    size_t decompressed_size = 0;
+    int result;
+    Py_BEGIN_ALLOW_THREADS
+    result = pdeflate_decompress((const uint8_t*)data.buf, (size_t)data.len,
+                                 &decompressed, &decompressed_size, threads, (size_t)max_output);
+    Py_END_ALLOW_THREADS
+    
+    PyObject *ret = NULL;
+    if (result == Z_OK) {
+        chunker_state *state = PyModule_GetState(self);
+        ret = chunker_buffer_result(pooled ? state->buffer_type : NULL, (char*)decompressed,
+                                    decompressed_size);
+    } else if (result == Z_BUF_ERROR) {
+        PyErr_Format(PyExc_ValueError, "Decompressed data exceeds max_output (%zd bytes)",
+                     max_output);
+    } else {
+        PyErr_SetString(result == Z_MEM_ERROR ? PyExc_MemoryError : PyExc_RuntimeError,
+                        "Decompression failed");
+    }
+    
+    PyBuffer_Release(&data);
+    return ret;
+}
+
+static PyObject* chunker_checksum(PyObject *self, PyObject *args) {
+    Py_buffer data;
+    char checksum[65];
+    
+    if (!PyArg_ParseTuple(args, "y*", &data)) {
+        return NULL;
+    }
+    
+    Py_BEGIN_ALLOW_THREADS
+    calculate_checksum((unsigned char*)data.buf, (size_t)data.len, checksum);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&data);
+    
+    return PyUnicode_FromString(checksum);
+}
+
+static PyObject* chunker_crc32(PyObject *self, PyObject *args) {
+    Py_buffer data;
+    unsigned int value = 0;
+    uint32_t crc;
+    
+    if (!PyArg_ParseTuple(args, "y*|I", &data, &value)) {
+        return NULL;
+    }
+    
+    Py_BEGIN_ALLOW_THREADS
+    crc = crc32_update((uint32_t)value, (const uint8_t*)data.buf, (size_t)data.len);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&data);
+    
+    return PyLong_FromUnsignedLong(crc);
+}
+
+static PyObject* chunker_cpu_features(PyObject *self, PyObject *args) {
+    const cpu_features_t *cpu = cpu_features();
+    PyObject *features = PyDict_New();
+    if (features == NULL) {
+        return NULL;
+    }
+    
+    const struct { const char *name; int present; } flags[] = {
+        {"sse4.2", cpu->sse42}, {"avx2", cpu->avx2}, {"avx512f", cpu->avx512f},
+        {"avx512bw", cpu->avx512bw}, {"aes", cpu->aes}, {"pclmul", cpu->pclmul},
+        {"sha", cpu->sha}, {"neon", cpu->neon}, {"crc32", cpu->crc32},
+        {"arm_aes", cpu->arm_aes}, {"pmull", cpu->pmull}, {"sha2", cpu->sha2},
+    };
+    for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); i++) {
+        if (PyDict_SetItemString(features, flags[i].name, flags[i].present ? Py_True : Py_False) < 0) {
+            Py_DECREF(features);
+            return NULL;
+        }
+    }
+    
+    // Kernels chosen at import; SHA-256 and the AEADs dispatch inside
+    // OpenSSL and libsodium on the same features
+    return Py_BuildValue("{s:s,s:N,s:{s:s,s:s,s:s}}",
+                         "arch", cpu->arch,
+                         "features", features,
+                         "kernels",
+                         "crc32", crc32_kernel_name(),
+                         "sha256_expected", cpu_sha256_kernel(),
+                         "aead", cpu_preferred_aead());
+}
+
+static PyObject* chunker_observe(PyObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"op", "seconds", "bytes_in", "bytes_out", "ok", NULL};
+    int op;
+    double seconds;
+    Py_ssize_t bytes_in = 0;
+    Py_ssize_t bytes_out = 0;
+    int ok = 1;
+    
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "id|nnp", kwlist,
+                                     &op, &seconds, &bytes_in, &bytes_out, &ok)) {
+        return NULL;
+    }
+    
+    if (op < 0 || op >= CHUNKER_OP_COUNT) {
+        PyErr_SetString(PyExc_ValueError, "Unknown operation");
+        return NULL;
+    }
+    
+    if (seconds < 0 || bytes_in < 0 || bytes_out < 0) {
+        PyErr_SetString(PyExc_ValueError, "Duration and byte counts must be non-negative");
+        return NULL;
+    }
+    
+    op_stats_record(&chunker_op_stats, op, (uint64_t)(seconds * 1e9),
+                    (size_t)bytes_in, (size_t)bytes_out, ok);
+    Py_RETURN_NONE;
+}
+
+static PyObject* op_histogram_dict(const op_histogram_t *hist, int with_buckets) {
+    PyObject *dict = Py_BuildValue(
+        "{s:K,s:K,s:K,s:K,s:d,s:K,s:K,s:K,s:K,s:K,s:K}",
+        "count", (unsigned long long)hist->count,
+        "errors", (unsigned long long)hist->errors,
+        "sum_ns", (unsigned long long)hist->sum_ns,
+        "max_ns", (unsigned long long)hist->max_ns,
+        "mean_ns", hist->count ? (double)hist->sum_ns / (double)hist->count : 0.0,
+        "p50_ns", (unsigned long long)op_histogram_quantile(hist, 0.50),
+        "p90_ns", (unsigned long long)op_histogram_quantile(hist, 0.90),
+        "p99_ns", (unsigned long long)op_histogram_quantile(hist, 0.99),
+        "p999_ns", (unsigned long long)op_histogram_quantile(hist, 0.999),
+        "bytes_in", (unsigned long long)hist->bytes_in,
+        "bytes_out", (unsigned long long)hist->bytes_out);
+    if (dict == NULL || !with_buckets) {
+        return dict;
+    }
+    
+    // Only occupied buckets, keyed by their inclusive upper bound in ns
+    PyObject *buckets = PyDict_New();
+    if (buckets == NULL) {
+        Py_DECREF(dict);
+        return NULL;
+    }
+    for (int b = 0; b < OP_STATS_BUCKETS; b++) {
+        if (hist->buckets[b] == 0) {
+            continue;
+        }
+        PyObject *key = PyLong_FromUnsignedLongLong(op_stats_bucket_upper(b));
+        PyObject *value = PyLong_FromUnsignedLongLong(hist->buckets[b]);
+        int rc = (key && value) ? PyDict_SetItem(buckets, key, value) : -1;
+        Py_XDECREF(key);
+        Py_XDECREF(value);
+        if (rc < 0) {
+            Py_DECREF(buckets);
+            Py_DECREF(dict);
+            return NULL;
+        }
+    }
+    if (PyDict_SetItemString(dict, "buckets", buckets) < 0) {
+        Py_DECREF(buckets);
+        Py_DECREF(dict);
+        return NULL;
+    }
+    Py_DECREF(buckets);
+    return dict;
+}
+
+static PyObject* chunker_snapshot(PyObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"buckets", NULL};
+    int with_buckets = 0;
+    
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|p", kwlist, &with_buckets)) {
+        return NULL;
+    }
+    
+    op_snapshot_t *snap = malloc(sizeof(op_snapshot_t));
+    if (snap == NULL) {
+        return PyErr_NoMemory();
+    }
+    
+    Py_BEGIN_ALLOW_THREADS
+    op_stats_snapshot(&chunker_op_stats, snap);
+    Py_END_ALLOW_THREADS
+    
+    PyObject *ret = Py_BuildValue("{s:K,s:K,s:K}",
+                                  "allocations", (unsigned long long)snap->allocations,
+                                  "allocated_bytes", (unsigned long long)snap->allocated_bytes,
+                                  "allocation_failures", (unsigned long long)snap->alloc_failures);
+    for (int op = 0; ret != NULL && op < CHUNKER_OP_COUNT; op++) {
+        PyObject *hist = op_histogram_dict(&snap->ops[op], with_buckets);
+        if (hist == NULL || PyDict_SetItemString(ret, chunker_op_stats.names[op], hist) < 0) {
+            Py_CLEAR(ret);
+        }
+        Py_XDECREF(hist);
+    }
+    
+    free(snap);
+    return ret;
+}
+
+static PyObject* chunker_prometheus(PyObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"prefix", NULL};
+    const char *prefix = "lucid_chunker";
+    char *text = NULL;
+    
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|s", kwlist, &prefix)) {
+        return NULL;
+    }
+    
+    op_snapshot_t *snap = malloc(sizeof(op_snapshot_t));
+    if (snap == NULL) {
+        return PyErr_NoMemory();
+    }
+    
+    Py_BEGIN_ALLOW_THREADS
+    op_stats_snapshot(&chunker_op_stats, snap);
+    text = op_stats_prometheus(&chunker_op_stats, snap, prefix);
+    Py_END_ALLOW_THREADS
+    free(snap);
+    
+    if (text == NULL) {
+        return PyErr_NoMemory();
+    }
+    PyObject *ret = PyUnicode_FromString(text);
+    free(text);
+    return ret;
+}
+
+static PyObject* chunker_configure_pool(PyObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"workers", "max_inflight", "max_waiting", NULL};
+    int workers = 0;
+    Py_ssize_t max_inflight = 0;
+    Py_ssize_t max_waiting = 0;
+    
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|inn", kwlist, &workers, &max_inflight,
+                                     &max_waiting)) {
+        return NULL;
+    }
+    chunker_state *state = PyModule_GetState(self);
+    if (async_pool_configure(state->pool, workers, max_inflight, max_waiting) < 0) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* chunker_pool_stats(PyObject *self, PyObject *args) {
+    return async_pool_stats(((chunker_state*)PyModule_GetState(self))->pool);
+}
+
+static PyObject* chunker_alloc_buffer(PyObject *self, PyObject *args) {
+    return pooled_buffer_alloc(((chunker_state*)PyModule_GetState(self))->buffer_type, args);
+}
+
+static PyObject* chunker_configure_buffer_pool(PyObject *self, PyObject *args, PyObject *kwds) {
+    return pooled_buffer_configure(args, kwds);
+}
+
+static PyObject* chunker_trim_buffer_pool(PyObject *self, PyObject *args) {
+    return pooled_buffer_trim();
+}
+
+static PyObject* chunker_buffer_pool_stats(PyObject *self, PyObject *args) {
+    return pooled_buffer_stats();
+}
+
+static PyObject* chunker_estimate_compressibility(PyObject *self, PyObject *args) {
+    Py_buffer data;
+    entropy_estimate_t est;
+    
+    if (!PyArg_ParseTuple(args, "y*", &data)) {
+        return NULL;
+    }
+    
+    Py_BEGIN_ALLOW_THREADS
+    entropy_estimate((const uint8_t*)data.buf, (size_t)data.len, &est);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&data);
+    
+    return Py_BuildValue("(ddi)", est.entropy, est.match_ratio, (int)entropy_tier(&est));
+}
+
 static PyMethodDef chunker_module_methods[] = {
     {"version", chunker_version, METH_NOARGS, "Get version"},
-    {"compress_data", chunker_compress_data, METH_VARARGS, "Compress data"},
-    {"decompress_data", chunker_decompress_data, METH_VARARGS, "Decompress data"},
+    {"estimate_compressibility", chunker_estimate_compressibility, METH_VARARGS,
+     "Return (bits_per_byte, match_ratio, tier) from a sampled byte histogram"},
+    {"compress_data", (PyCFunction)(void(*)(void))chunker_compress_data, METH_VARARGS | METH_KEYWORDS,
+     "Compress data"},
+    {"decompress_data", (PyCFunction)(void(*)(void))chunker_decompress_data, METH_VARARGS | METH_KEYWORDS,
+     "Decompress data"},
+    {"compress_parallel", (PyCFunction)(void(*)(void))chunker_compress_parallel,
+     METH_VARARGS | METH_KEYWORDS, "Compress data as one zlib or gzip stream on several threads"},
+    {"decompress_parallel", (PyCFunction)(void(*)(void))chunker_decompress_parallel,
+     METH_VARARGS | METH_KEYWORDS, "Decompress a zlib or gzip stream, in parallel when it is indexed"},
+    {"checksum", chunker_checksum, METH_VARARGS, "SHA-256 hex digest of data"},
+    {"crc32", chunker_crc32, METH_VARARGS, "CRC-32 of data continuing from value, as zlib.crc32"},
+    {"cpu_features", chunker_cpu_features, METH_NOARGS,
+     "Detected CPU features and the kernels selected for them"},
+    {"observe", (PyCFunction)(void(*)(void))chunker_observe, METH_VARARGS | METH_KEYWORDS,
+     "Record an operation timed outside the module"},
+    {"snapshot", (PyCFunction)(void(*)(void))chunker_snapshot, METH_VARARGS | METH_KEYWORDS,
+     "Latency percentiles, byte and allocation counters per operation"},
+    {"prometheus", (PyCFunction)(void(*)(void))chunker_prometheus, METH_VARARGS | METH_KEYWORDS,
+     "Operation metrics in Prometheus text format"},
+    {"configure_pool", (PyCFunction)(void(*)(void))chunker_configure_pool, METH_VARARGS | METH_KEYWORDS,
+     "Set worker count, in-flight and waiting bounds for async operations before first use"},
+    {"pool_stats", chunker_pool_stats, METH_NOARGS, "Worker pool counters"},
+    {"alloc_buffer", chunker_alloc_buffer, METH_VARARGS, "Zero-filled PooledBuffer of size bytes"},
+    {"configure_buffer_pool", (PyCFunction)(void(*)(void))chunker_configure_buffer_pool,
+     METH_VARARGS | METH_KEYWORDS, "Set buffer cache limits in MB and the huge page policy"},
+    {"trim_buffer_pool", chunker_trim_buffer_pool, METH_NOARGS, "Unmap cached buffers"},
+    {"buffer_pool_stats", chunker_buffer_pool_stats, METH_NOARGS, "Buffer pool counters"},
     {NULL, NULL, 0, NULL}
 };
 
@@ -139,41 +668,75 @@ static PyObject* Chunker_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         self->chunk_size = 8 * 1024 * 1024;  // Default 8MB
         self->compression_level = 6;
         self->zstream_initialized = 0;
+        self->adaptive = 1;
+        self->threads = 1;
+        self->block_size = 0;
+        pthread_mutex_init(&self->lock, NULL);
+        policy_init(&self->policy, 0.0, 1, self->compression_level);
     }
     return (PyObject*)self;
 }
 
 static int Chunker_init(ChunkerObject *self, PyObject *args, PyObject *kwds) {
-    static char *kwlist[] = {"chunk_size", "compression_level", NULL};
+    static char *kwlist[] = {"chunk_size", "compression_level", "adaptive", "target_mbps",
+                             "threads", "block_size", NULL};
+    unsigned long chunk_size = self->chunk_size;
+    int compression_level = self->compression_level;
+    int adaptive = self->adaptive;
+    double target_mbps = 0.0;
+    int threads = self->threads;
+    Py_ssize_t block_size = (Py_ssize_t)self->block_size;
     
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|ki", kwlist,
-                                     &self->chunk_size, &self->compression_level)) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|kipdin", kwlist,
+                                     &chunk_size, &compression_level,
+                                     &adaptive, &target_mbps, &threads, &block_size)) {
         return -1;
     }
     
     // Validate parameters
-    if (self->chunk_size <= 0 || self->chunk_size > MAX_CHUNK_SIZE) {
+    if (chunk_size <= 0 || chunk_size > MAX_CHUNK_SIZE) {
         PyErr_SetString(PyExc_ValueError, "Invalid chunk size");
         return -1;
     }
     
-    if (self->compression_level < 0 || self->compression_level > 9) {
+    if (compression_level < 0 || compression_level > 9) {
         PyErr_SetString(PyExc_ValueError, "Invalid compression level");
         return -1;
     }
     
+    if (target_mbps < 0) {
+        PyErr_SetString(PyExc_ValueError, "Invalid target throughput");
+        return -1;
+    }
+    
+    if (parse_parallel(threads, block_size) < 0) {
+        return -1;
+    }
+    
+    pthread_mutex_lock(&self->lock);
+    self->chunk_size = chunk_size;
+    self->compression_level = compression_level;
+    self->adaptive = adaptive;
+    self->threads = threads;
+    self->block_size = (size_t)block_size;
+    // zlib has no separate fast codec, so the fast and low tiers share level 1
+    policy_init(&self->policy, target_mbps * 1e6, 1, compression_level);
+    
     // Initialize zlib stream
-    self->zstream.zalloc = Z_NULL;
-    self->zstream.zfree = Z_NULL;
-    self->zstream.opaque = Z_NULL;
+    int ok = 1;
+    if (!self->zstream_initialized) {
+        self->zstream.zalloc = Z_NULL;
+        self->zstream.zfree = Z_NULL;
+        self->zstream.opaque = Z_NULL;
+        ok = deflateInit(&self->zstream, compression_level) == Z_OK;
+        self->zstream_initialized = ok;
+    }
+    pthread_mutex_unlock(&self->lock);
     
-    if (deflateInit(&self->zstream, self->compression_level) == Z_OK) {
-        self->zstream_initialized = 1;
-    } else {
+    if (!ok) {
         PyErr_SetString(PyExc_RuntimeError, "Failed to initialize zlib stream");
         return -1;
     }
-    
     return 0;
 }
 
@@ -181,13 +744,124 @@ static void Chunker_dealloc(ChunkerObject *self) {
     if (self->zstream_initialized) {
         deflateEnd(&self->zstream);
     }
-    Py_TYPE(self)->tp_free((PyObject*)self);
+    pthread_mutex_destroy(&self->lock);
+    PyTypeObject *type = Py_TYPE(self);
+    type->tp_free((PyObject*)self);
+    Py_DECREF(type);
+}
+
+static double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+typedef struct {
+    char *compressed;
+    size_t compressed_size;
+    entropy_estimate_t est;
+    compression_tier_t tier;
+    int level;
+    int result;
+    char checksum[65];
+} chunk_output_t;
+
+// Tier selection, compression and checksum for one block; runs without
+// the GIL, possibly on several threads for the same chunker
+static void chunk_block(ChunkerObject *self, const uint8_t *buf, size_t len, chunk_output_t *out) {
+    out->est = (entropy_estimate_t){0.0, 0.0, 0};
+    out->tier = TIER_HIGH;
+    out->result = Z_OK;
+    
+    double started = monotonic_seconds();
+    pthread_mutex_lock(&self->lock);
+    int adaptive = self->adaptive;
+    out->level = self->compression_level;
+    pdeflate_options_t parallel = {
+        .threads = self->threads,
+        .block_size = self->block_size,
+        .format = PDEFLATE_ZLIB,
+    };
+    if (adaptive) {
+        out->tier = policy_select(&self->policy, buf, len, &out->level, &out->est);
+    }
+    pthread_mutex_unlock(&self->lock);
+    
+    // Blocks that split at least twice are deflated across threads; the
+    // stream is still plain zlib, so decompress() is unchanged
+    size_t split = parallel.block_size ? parallel.block_size : PDEFLATE_DEFAULT_BLOCK;
+    int use_parallel = out->tier != TIER_STORE && parallel.threads != 1 && len >= 2 * split;
+    out->compressed_size = compressBound((uLong)len);
+    if (use_parallel) {
+        parallel.level = out->level;
+        size_t bound = pdeflate_bound(len, &parallel);
+        out->compressed_size = bound > out->compressed_size ? bound : out->compressed_size;
+    }
+    out->compressed = chunker_buffer_alloc(out->compressed_size);
+    if (!out->compressed) {
+        out->result = Z_MEM_ERROR;
+        return;
+    }
+    
+    if (out->tier == TIER_STORE) {
+        // Encrypted or already compressed input: deflate would only add framing
+        memcpy(out->compressed, buf, len);
+        out->compressed_size = len;
+    } else if (use_parallel) {
+        out->result = pdeflate_compress(buf, len, (uint8_t*)out->compressed,
+                                        &out->compressed_size, &parallel);
+    } else {
+        out->result = compress_data((unsigned char*)buf, len,
+                                    (unsigned char*)out->compressed, &out->compressed_size,
+                                    out->level);
+    }
+    if (adaptive && out->result == Z_OK && out->tier != TIER_STORE) {
+        double seconds = monotonic_seconds() - started;
+        pthread_mutex_lock(&self->lock);
+        policy_record(&self->policy, len, seconds);
+        pthread_mutex_unlock(&self->lock);
+    }
+    if (out->result == Z_OK) {
+        calculate_checksum((unsigned char*)out->compressed, out->compressed_size, out->checksum);
+    }
+}
+
+// Result dict for a chunked block; the compressed buffer becomes its
+// data (a PooledBuffer when pooled_type is given) or is freed
+static PyObject* chunk_output_dict(chunk_output_t *out, PyTypeObject *pooled_type) {
+    PyObject *ret = NULL;
+    if (out->result == Z_OK) {
+        int stored = out->tier == TIER_STORE;
+        PyObject *data = chunker_buffer_result(pooled_type, out->compressed, out->compressed_size);
+        out->compressed = NULL;
+        if (data == NULL) {
+            return NULL;
+        }
+        ret = Py_BuildValue("{s:N,s:s,s:i,s:i,s:d,s:s}",
+                            "data", data,
+                            "algorithm", stored ? "none" : "zlib",
+                            "level", stored ? 0 : out->level,
+                            "tier", (int)out->tier,
+                            "entropy", out->est.entropy,
+                            "checksum", out->checksum);
+    } else if (out->result == Z_MEM_ERROR) {
+        PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory");
+    } else {
+        PyErr_SetString(PyExc_RuntimeError, "Chunking failed");
+    }
+    
+    buffer_pool_free(out->compressed);
+    out->compressed = NULL;
+    return ret;
 }
 
-static PyObject* Chunker_chunk(ChunkerObject *self, PyObject *args) {
+static PyObject* Chunker_chunk(ChunkerObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"data", "pooled", NULL};
     Py_buffer data;
+    chunk_output_t out;
+    int pooled = 0;
     
-    if (!PyArg_ParseTuple(args, "y*", &data)) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|$p", kwlist, &data, &pooled)) {
         return NULL;
     }
     
@@ -198,49 +872,99 @@ static PyObject* Chunker_chunk(ChunkerObject *self, PyObject *args) {
         return NULL;
     }
     
-    // Compress the data
-    size_t compressed_size = data.len * 2;  // Estimate
-    char *compressed = malloc(compressed_size);
-    if (!compressed) {
-        PyBuffer_Release(&data);
-        PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory");
+    Py_BEGIN_ALLOW_THREADS
+    chunk_block(self, (const uint8_t*)data.buf, (size_t)data.len, &out);
+    Py_END_ALLOW_THREADS
+    
+    PyBuffer_Release(&data);
+    chunker_state *state = chunker_state_of(Py_TYPE(self));
+    if (state == NULL) {
+        buffer_pool_free(out.compressed);
+        return NULL;
+    }
+    return chunk_output_dict(&out, pooled ? state->buffer_type : NULL);
+}
+
+typedef struct {
+    async_job_t base;
+    ChunkerObject *chunker;
+    Py_buffer data;
+    int pooled;
+    chunk_output_t out;
+} ChunkJob;
+
+static void chunk_job_work(async_job_t *job) {
+    ChunkJob *chunk = (ChunkJob*)job;
+    chunk_block(chunk->chunker, (const uint8_t*)chunk->data.buf, (size_t)chunk->data.len, &chunk->out);
+}
+
+static PyObject* chunk_job_result(async_job_t *job) {
+    ChunkJob *chunk = (ChunkJob*)job;
+    chunker_state *state = chunker_state_of(Py_TYPE(chunk->chunker));
+    if (state == NULL) {
         return NULL;
     }
+    return chunk_output_dict(&chunk->out, chunk->pooled ? state->buffer_type : NULL);
+}
+
+static void chunk_job_release(async_job_t *job) {
+    ChunkJob *chunk = (ChunkJob*)job;
+    buffer_pool_free(chunk->out.compressed);
+    PyBuffer_Release(&chunk->data);
+    Py_DECREF(chunk->chunker);
+    PyMem_Free(chunk);
+}
+
+static PyObject* Chunker_chunk_async(ChunkerObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"data", "pooled", NULL};
+    ChunkJob *job = PyMem_Calloc(1, sizeof(ChunkJob));
+    if (job == NULL) {
+        return PyErr_NoMemory();
+    }
     
-    int result = compress_data((unsigned char*)data.buf, data.len,
-                              (unsigned char*)compressed, &compressed_size,
-                              self->compression_level);
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|$p", kwlist, &job->data, &job->pooled)) {
+        PyMem_Free(job);
+        return NULL;
+    }
     
-    PyObject *ret = NULL;
-    if (result == Z_OK) {
-        // Create result dictionary
-        ret = PyDict_New();
-        if (ret) {
-            PyDict_SetItemString(ret, "data", 
-                                PyBytes_FromStringAndSize(compressed, compressed_size));
-            PyDict_SetItemString(ret, "algorithm", PyUnicode_FromString("zlib"));
-            PyDict_SetItemString(ret, "checksum", 
-                                PyUnicode_FromString("sha256_hash_here"));  // TODO: Implement
-        }
-    } else {
-        PyErr_SetString(PyExc_RuntimeError, "Chunking failed");
+    if (job->data.len > MAX_CHUNK_SIZE) {
+        PyBuffer_Release(&job->data);
+        PyMem_Free(job);
+        PyErr_SetString(PyExc_ValueError, "Data too large for chunking");
+        return NULL;
     }
     
-    free(compressed);
-    PyBuffer_Release(&data);
-    return ret;
+    Py_INCREF(self);
+    job->chunker = self;
+    job->base.work = chunk_job_work;
+    job->base.result = chunk_job_result;
+    job->base.release = chunk_job_release;
+    chunker_state *state = chunker_state_of(Py_TYPE(self));
+    if (state == NULL) {
+        chunk_job_release(&job->base);
+        return NULL;
+    }
+    return async_pool_submit(state->pool, &job->base);
 }
 
-static PyObject* Chunker_decompress(ChunkerObject *self, PyObject *args) {
+static PyObject* Chunker_decompress(ChunkerObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"data", "pooled", NULL};
     Py_buffer data;
+    int pooled = 0;
     
-    if (!PyArg_ParseTuple(args, "y*", &data)) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|$p", kwlist, &data, &pooled)) {
+        return NULL;
+    }
+    
+    chunker_state *state = chunker_state_of(Py_TYPE(self));
+    if (state == NULL) {
+        PyBuffer_Release(&data);
         return NULL;
     }
     
     // Decompress the data
     size_t decompressed_size = data.len * 4;  // Estimate
-    char *decompressed = malloc(decompressed_size);
+    char *decompressed = chunker_buffer_alloc(decompressed_size);
     if (!decompressed) {
         PyBuffer_Release(&data);
         PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory");
@@ -252,51 +976,240 @@ static PyObject* Chunker_decompress(ChunkerObject *self, PyObject *args) {
     
     PyObject *ret = NULL;
     if (result == Z_OK) {
-        ret = PyBytes_FromStringAndSize(decompressed, decompressed_size);
+        ret = chunker_buffer_result(pooled ? state->buffer_type : NULL, decompressed, decompressed_size);
     } else {
+        buffer_pool_free(decompressed);
         PyErr_SetString(PyExc_RuntimeError, "Decompression failed");
     }
     
-    free(decompressed);
     PyBuffer_Release(&data);
     return ret;
 }
 
 static PyObject* Chunker_cleanup(ChunkerObject *self, PyObject *args) {
+    pthread_mutex_lock(&self->lock);
     if (self->zstream_initialized) {
         deflateEnd(&self->zstream);
         self->zstream_initialized = 0;
     }
+    pthread_mutex_unlock(&self->lock);
     Py_RETURN_NONE;
 }
 
-// Module definition
-static struct PyModuleDef chunker_module = {
-    PyModuleDef_HEAD_INIT,
-    "chunker_native",
-    "Native chunker extension for Lucid RDP",
-    -1,
-    chunker_module_methods
-};
+static PyObject* tier_counts_tuple(pthread_mutex_t *lock, const compression_policy_t *policy) {
+    unsigned long long counts[TIER_COUNT];
+    pthread_mutex_lock(lock);
+    for (int i = 0; i < TIER_COUNT; i++) {
+        counts[i] = (unsigned long long)policy->tier_counts[i];
+    }
+    pthread_mutex_unlock(lock);
+    return Py_BuildValue("(KKKK)", counts[TIER_STORE], counts[TIER_FAST],
+                         counts[TIER_LOW], counts[TIER_HIGH]);
+}
 
-PyMODINIT_FUNC PyInit_chunker_native(void) {
-    import_array();
+static PyObject* Chunker_get_level(ChunkerObject *self, void *closure) {
+    pthread_mutex_lock(&self->lock);
+    long level = self->policy.level;
+    pthread_mutex_unlock(&self->lock);
+    return PyLong_FromLong(level);
+}
+
+static PyObject* Chunker_get_tier_counts(ChunkerObject *self, void *closure) {
+    return tier_counts_tuple(&self->lock, &self->policy);
+}
+
+// CompressionPolicy object methods
+static PyObject* Policy_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
+    PolicyObject *self = (PolicyObject*)type->tp_alloc(type, 0);
+    if (self != NULL) {
+        pthread_mutex_init(&self->lock, NULL);
+        policy_init(&self->policy, 0.0, 1, 9);
+    }
+    return (PyObject*)self;
+}
+
+static void Policy_dealloc(PolicyObject *self) {
+    pthread_mutex_destroy(&self->lock);
+    PyTypeObject *type = Py_TYPE(self);
+    type->tp_free((PyObject*)self);
+    Py_DECREF(type);
+}
+
+static int Policy_init(PolicyObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"target_mbps", "low_level", "high_level", NULL};
+    double target_mbps = 0.0;
+    int low_level = 1;
+    int high_level = 9;
     
-    if (PyType_Ready(&ChunkerType) < 0) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|dii", kwlist,
+                                     &target_mbps, &low_level, &high_level)) {
+        return -1;
+    }
+    
+    if (target_mbps < 0) {
+        PyErr_SetString(PyExc_ValueError, "Invalid target throughput");
+        return -1;
+    }
+    
+    if (low_level < 0 || high_level < low_level) {
+        PyErr_SetString(PyExc_ValueError, "Invalid compression level range");
+        return -1;
+    }
+    
+    pthread_mutex_lock(&self->lock);
+    policy_init(&self->policy, target_mbps * 1e6, low_level, high_level);
+    pthread_mutex_unlock(&self->lock);
+    return 0;
+}
+
+static PyObject* Policy_select(PolicyObject *self, PyObject *args) {
+    Py_buffer data;
+    entropy_estimate_t est;
+    compression_tier_t tier;
+    int level = 0;
+    
+    if (!PyArg_ParseTuple(args, "y*", &data)) {
         return NULL;
     }
     
-    PyObject *m = PyModule_Create(&chunker_module);
-    if (m == NULL) {
+    pthread_mutex_lock(&self->lock);
+    tier = policy_select(&self->policy, (const uint8_t*)data.buf,
+                         (size_t)data.len, &level, &est);
+    pthread_mutex_unlock(&self->lock);
+    PyBuffer_Release(&data);
+    
+    return Py_BuildValue("(ii)", (int)tier, level);
+}
+
+static PyObject* Policy_record(PolicyObject *self, PyObject *args) {
+    Py_ssize_t nbytes;
+    double seconds;
+    
+    if (!PyArg_ParseTuple(args, "nd", &nbytes, &seconds)) {
         return NULL;
     }
     
-    Py_INCREF(&ChunkerType);
-    if (PyModule_AddObject(m, "Chunker", (PyObject*)&ChunkerType) < 0) {
-        Py_DECREF(&ChunkerType);
-        Py_DECREF(m);
+    if (nbytes < 0 || seconds < 0) {
+        PyErr_SetString(PyExc_ValueError, "Byte count and duration must be non-negative");
         return NULL;
     }
     
-    return m;
+    pthread_mutex_lock(&self->lock);
+    policy_record(&self->policy, (size_t)nbytes, seconds);
+    pthread_mutex_unlock(&self->lock);
+    Py_RETURN_NONE;
+}
+
+static PyObject* Policy_get_level(PolicyObject *self, void *closure) {
+    pthread_mutex_lock(&self->lock);
+    long level = self->policy.level;
+    pthread_mutex_unlock(&self->lock);
+    return PyLong_FromLong(level);
+}
+
+static PyObject* Policy_get_degraded(PolicyObject *self, void *closure) {
+    pthread_mutex_lock(&self->lock);
+    long degraded = self->policy.degraded;
+    pthread_mutex_unlock(&self->lock);
+    return PyBool_FromLong(degraded);
+}
+
+static PyObject* Policy_get_throughput(PolicyObject *self, void *closure) {
+    pthread_mutex_lock(&self->lock);
+    double bps = self->policy.last_bps;
+    pthread_mutex_unlock(&self->lock);
+    return PyFloat_FromDouble(bps / 1e6);
+}
+
+static PyObject* Policy_get_tier_counts(PolicyObject *self, void *closure) {
+    return tier_counts_tuple(&self->lock, &self->policy);
+}
+
+// Module definition
+static int chunker_exec(PyObject *m) {
+    chunker_state *state = PyModule_GetState(m);
+    
+    // Process-wide and idempotent; every interpreter runs this
+    cpu_features_init();
+    crc32_init();
+    
+    state->chunker_type = (PyTypeObject*)PyType_FromModuleAndSpec(m, &Chunker_spec, NULL);
+    if (state->chunker_type == NULL || PyModule_AddType(m, state->chunker_type) < 0) {
+        return -1;
+    }
+    
+    state->policy_type = (PyTypeObject*)PyType_FromModuleAndSpec(m, &Policy_spec, NULL);
+    if (state->policy_type == NULL || PyModule_AddType(m, state->policy_type) < 0) {
+        return -1;
+    }
+    
+    state->buffer_type = pooled_buffer_type_new(m, "chunker_native.PooledBuffer");
+    if (state->buffer_type == NULL || PyModule_AddType(m, state->buffer_type) < 0) {
+        return -1;
+    }
+    
+    state->pool = async_pool_new();
+    if (state->pool == NULL) {
+        return -1;
+    }
+    
+    if (PyModule_AddIntConstant(m, "TIER_STORE", TIER_STORE) < 0 ||
+        PyModule_AddIntConstant(m, "TIER_FAST", TIER_FAST) < 0 ||
+        PyModule_AddIntConstant(m, "TIER_LOW", TIER_LOW) < 0 ||
+        PyModule_AddIntConstant(m, "TIER_HIGH", TIER_HIGH) < 0 ||
+        PyModule_AddIntConstant(m, "OP_COMPRESS", CHUNKER_OP_COMPRESS) < 0 ||
+        PyModule_AddIntConstant(m, "OP_DECOMPRESS", CHUNKER_OP_DECOMPRESS) < 0 ||
+        PyModule_AddIntConstant(m, "OP_HASH", CHUNKER_OP_HASH) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+static int chunker_traverse(PyObject *m, visitproc visit, void *arg) {
+    chunker_state *state = PyModule_GetState(m);
+    Py_VISIT(state->chunker_type);
+    Py_VISIT(state->policy_type);
+    Py_VISIT(state->buffer_type);
+    Py_VISIT(state->pool);
+    return 0;
+}
+
+static int chunker_clear(PyObject *m) {
+    chunker_state *state = PyModule_GetState(m);
+    Py_CLEAR(state->chunker_type);
+    Py_CLEAR(state->policy_type);
+    Py_CLEAR(state->buffer_type);
+    Py_CLEAR(state->pool);
+    return 0;
+}
+
+static void chunker_free(void *m) {
+    chunker_clear((PyObject*)m);
+}
+
+static PyModuleDef_Slot chunker_slots[] = {
+    {Py_mod_exec, chunker_exec},
+#if PY_VERSION_HEX >= 0x030C0000
+    {Py_mod_multiple_interpreters, Py_MOD_PER_INTERPRETER_GIL_SUPPORTED},
+#endif
+#if PY_VERSION_HEX >= 0x030D0000
+    {Py_mod_gil, Py_MOD_GIL_NOT_USED},
+#endif
+    {0, NULL}
+};
+
+static struct PyModuleDef chunker_module = {
+    PyModuleDef_HEAD_INIT,
+    .m_name = "chunker_native",
+    .m_doc = "Native chunker extension for Lucid RDP",
+    .m_size = sizeof(chunker_state),
+    .m_methods = chunker_module_methods,
+    .m_slots = chunker_slots,
+    .m_traverse = chunker_traverse,
+    .m_clear = chunker_clear,
+    .m_free = chunker_free,
+};
+
+PyMODINIT_FUNC PyInit_chunker_native(void) {
+    return PyModuleDef_Init(&chunker_module);
 }
@@ -2,7 +2,6 @@
 #define CHUNKER_H
 
 #include <Python.h>
-#include <numpy/arrayobject.h>
 #include <zlib.h>
 
 // Constants
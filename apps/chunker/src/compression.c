@@ -1,6 +1,10 @@
 #include "chunker.h"
 #include "compression.h"
 
+static const char *const chunker_op_names[CHUNKER_OP_COUNT] = {"compress", "decompress", "hash"};
+
+op_stats_t chunker_op_stats = {.names = chunker_op_names, .op_count = CHUNKER_OP_COUNT};
+
 int compress_data(unsigned char *input, size_t input_size,
                  unsigned char *output, size_t *output_size,
                  int compression_level) {
@@ -8,12 +12,15 @@ int compress_data(unsigned char *input, size_t input_size,
     int result;
     
     // Initialize zlib stream
-    stream.zalloc = Z_NULL;
-    stream.zfree = Z_NULL;
-    stream.opaque = Z_NULL;
+    stream.zalloc = op_stats_zalloc;
+    stream.zfree = op_stats_zfree;
+    stream.opaque = &chunker_op_stats;
     
+    uint64_t started = op_stats_now_ns();
     result = deflateInit(&stream, compression_level);
     if (result != Z_OK) {
+        op_stats_record(&chunker_op_stats, CHUNKER_OP_COMPRESS, op_stats_now_ns() - started,
+                        input_size, 0, 0);
         return result;
     }
     
@@ -31,6 +38,8 @@ int compress_data(unsigned char *input, size_t input_size,
     
     // Cleanup
     deflateEnd(&stream);
+    op_stats_record(&chunker_op_stats, CHUNKER_OP_COMPRESS, op_stats_now_ns() - started,
+                    input_size, *output_size, result == Z_STREAM_END);
     
     return result == Z_STREAM_END ? Z_OK : result;
 }
@@ -41,12 +50,15 @@ int decompress_data(unsigned char *input, size_t input_size,
     int result;
     
     // Initialize zlib stream
-    stream.zalloc = Z_NULL;
-    stream.zfree = Z_NULL;
-    stream.opaque = Z_NULL;
+    stream.zalloc = op_stats_zalloc;
+    stream.zfree = op_stats_zfree;
+    stream.opaque = &chunker_op_stats;
     
+    uint64_t started = op_stats_now_ns();
     result = inflateInit(&stream);
     if (result != Z_OK) {
+        op_stats_record(&chunker_op_stats, CHUNKER_OP_DECOMPRESS, op_stats_now_ns() - started,
+                        input_size, 0, 0);
         return result;
     }
     
@@ -64,6 +76,8 @@ int decompress_data(unsigned char *input, size_t input_size,
     
     // Cleanup
     inflateEnd(&stream);
+    op_stats_record(&chunker_op_stats, CHUNKER_OP_DECOMPRESS, op_stats_now_ns() - started,
+                    input_size, *output_size, result == Z_STREAM_END);
     
     return result == Z_STREAM_END ? Z_OK : result;
 }
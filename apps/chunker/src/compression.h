@@ -2,6 +2,19 @@
 #define COMPRESSION_H
 
 #include <zlib.h>
+#include "op_stats.h"
+
+// Operations timed in chunker_op_stats
+enum {
+    CHUNKER_OP_COMPRESS = 0,
+    CHUNKER_OP_DECOMPRESS = 1,
+    CHUNKER_OP_HASH = 2,
+    CHUNKER_OP_COUNT = 3
+};
+
+// Module-wide latency histograms and counters; zlib state and output
+// buffers are charged to its allocation counters
+extern op_stats_t chunker_op_stats;
 
 // Function declarations for compression utilities
 int compress_data(unsigned char *input, size_t input_size,
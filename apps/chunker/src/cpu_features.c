@@ -0,0 +1,76 @@
+#define _GNU_SOURCE
+
+#include "cpu_features.h"
+
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define CPU_X86 1
+#elif defined(__aarch64__) && defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#define CPU_ARM64 1
+#endif
+
+static cpu_features_t features = {.arch = "generic"};
+static pthread_once_t features_once = PTHREAD_ONCE_INIT;
+
+static void detect_features(void) {
+#ifdef CPU_X86
+    features.arch = "x86_64";
+    __builtin_cpu_init();
+    features.sse42 = __builtin_cpu_supports("sse4.2");
+    features.avx2 = __builtin_cpu_supports("avx2");
+    features.avx512f = __builtin_cpu_supports("avx512f");
+    features.avx512bw = __builtin_cpu_supports("avx512bw");
+    features.aes = __builtin_cpu_supports("aes");
+    features.pclmul = __builtin_cpu_supports("pclmul");
+
+    // SHA extensions: CPUID leaf 7, EBX bit 29
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        features.sha = (ebx >> 29) & 1;
+    }
+#elif defined(CPU_ARM64)
+    features.arch = "aarch64";
+    unsigned long hwcap = getauxval(AT_HWCAP);
+    features.neon = (hwcap & HWCAP_ASIMD) != 0;
+    features.crc32 = (hwcap & HWCAP_CRC32) != 0;
+    features.arm_aes = (hwcap & HWCAP_AES) != 0;
+    features.pmull = (hwcap & HWCAP_PMULL) != 0;
+    features.sha2 = (hwcap & HWCAP_SHA2) != 0;
+#endif
+}
+
+// Every interpreter importing the module calls this; only the first detects
+void cpu_features_init(void) {
+    pthread_once(&features_once, detect_features);
+}
+
+const cpu_features_t *cpu_features(void) {
+    return &features;
+}
+
+const char *cpu_sha256_kernel(void) {
+#ifdef CPU_X86
+    if (features.sha) {
+        return "sha-ni";
+    }
+    if (features.avx2) {
+        return "avx2";
+    }
+    return "ssse3";
+#elif defined(CPU_ARM64)
+    return features.sha2 ? "armv8-sha2" : "neon";
+#else
+    return "generic";
+#endif
+}
+
+const char *cpu_preferred_aead(void) {
+    if ((features.aes && features.pclmul) || (features.arm_aes && features.pmull)) {
+        return "aes256-gcm";
+    }
+    return "xchacha20-poly1305";
+}
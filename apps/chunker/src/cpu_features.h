@@ -0,0 +1,36 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+// CPU features the native kernels dispatch on, detected once at import
+typedef struct {
+    const char *arch;
+    // x86-64
+    int sse42;
+    int avx2;
+    int avx512f;
+    int avx512bw;
+    int aes;
+    int pclmul;
+    int sha;
+    // aarch64
+    int neon;
+    int crc32;
+    int arm_aes;
+    int pmull;
+    int sha2;
+} cpu_features_t;
+
+void cpu_features_init(void);
+
+const cpu_features_t *cpu_features(void);
+
+// Kernel OpenSSL is expected to run SHA-256 on for this CPU, from the
+// same feature bits it checks; OpenSSL dispatches on its own, so this is
+// reported as sha256_expected rather than as a selected kernel
+const char *cpu_sha256_kernel(void);
+
+// AEAD with hardware support here: AES-GCM needs AES and carry-less
+// multiply instructions, otherwise XChaCha20 is faster
+const char *cpu_preferred_aead(void);
+
+#endif // CPU_FEATURES_H
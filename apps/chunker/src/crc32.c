@@ -0,0 +1,166 @@
+/*
+ * CRC-32 kernels
+ * PCLMULQDQ folding on x86-64 and the ARMv8 CRC32 instructions on
+ * aarch64, with zlib's table-driven crc32() as the fallback and for
+ * tails shorter than a fold.
+ */
+
+#include <pthread.h>
+#include <zlib.h>
+#include "crc32.h"
+#include "cpu_features.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define CRC32_X86 1
+#elif defined(__aarch64__)
+#include <arm_acle.h>
+#include <string.h>
+#define CRC32_ARM64 1
+#endif
+
+typedef uint32_t (*crc32_fn)(uint32_t crc, const uint8_t *data, size_t len);
+
+static uint32_t crc32_zlib(uint32_t crc, const uint8_t *data, size_t len) {
+    // zlib takes uInt lengths
+    while (len > 0) {
+        uInt n = len > 0x40000000u ? 0x40000000u : (uInt)len;
+        crc = (uint32_t)crc32(crc, data, n);
+        data += n;
+        len -= n;
+    }
+    return crc;
+}
+
+static crc32_fn crc32_impl = crc32_zlib;
+static const char *kernel_name = "zlib";
+
+#ifdef CRC32_X86
+// Bit-reflected fold constants for 0x04C11DB7 from Intel's "Fast CRC
+// Computation for Generic Polynomials Using PCLMULQDQ Instruction"
+static const uint64_t k1k2[2] __attribute__((aligned(16))) = {0x0154442bd4, 0x01c6e41596};
+static const uint64_t k3k4[2] __attribute__((aligned(16))) = {0x01751997d0, 0x00ccaa009e};
+static const uint64_t k5k0[2] __attribute__((aligned(16))) = {0x0163cd6124, 0x0000000000};
+static const uint64_t poly[2] __attribute__((aligned(16))) = {0x01db710641, 0x01f7011641};
+
+__attribute__((target("pclmul,sse4.1")))
+static inline __m128i fold_128(__m128i acc, __m128i k, __m128i next) {
+    __m128i lo = _mm_clmulepi64_si128(acc, k, 0x00);
+    __m128i hi = _mm_clmulepi64_si128(acc, k, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(hi, lo), next);
+}
+
+// Folds four 16-byte lanes per 64-byte step, then down to 32 bits with
+// a Barrett reduction; requires len >= 64 and works on the inverted crc
+__attribute__((target("pclmul,sse4.1")))
+static uint32_t crc32_fold_pclmul(uint32_t crc, const uint8_t *buf, size_t len) {
+    __m128i x1 = _mm_loadu_si128((const __m128i*)(buf + 0x00));
+    __m128i x2 = _mm_loadu_si128((const __m128i*)(buf + 0x10));
+    __m128i x3 = _mm_loadu_si128((const __m128i*)(buf + 0x20));
+    __m128i x4 = _mm_loadu_si128((const __m128i*)(buf + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+    buf += 64;
+    len -= 64;
+
+    __m128i k = _mm_load_si128((const __m128i*)k1k2);
+    while (len >= 64) {
+        x1 = fold_128(x1, k, _mm_loadu_si128((const __m128i*)(buf + 0x00)));
+        x2 = fold_128(x2, k, _mm_loadu_si128((const __m128i*)(buf + 0x10)));
+        x3 = fold_128(x3, k, _mm_loadu_si128((const __m128i*)(buf + 0x20)));
+        x4 = fold_128(x4, k, _mm_loadu_si128((const __m128i*)(buf + 0x30)));
+        buf += 64;
+        len -= 64;
+    }
+
+    // Four lanes into one, then any remaining 16-byte blocks
+    k = _mm_load_si128((const __m128i*)k3k4);
+    x1 = fold_128(x1, k, x2);
+    x1 = fold_128(x1, k, x3);
+    x1 = fold_128(x1, k, x4);
+    while (len >= 16) {
+        x1 = fold_128(x1, k, _mm_loadu_si128((const __m128i*)buf));
+        buf += 16;
+        len -= 16;
+    }
+
+    // 128 -> 64 bits
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+    __m128i x2r = _mm_clmulepi64_si128(x1, k, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2r);
+    k = _mm_loadl_epi64((const __m128i*)k5k0);
+    x2r = _mm_srli_si128(x1, 4);
+    x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x00);
+    x1 = _mm_xor_si128(x1, x2r);
+
+    // Barrett reduction to 32 bits
+    k = _mm_load_si128((const __m128i*)poly);
+    x2r = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x10);
+    x2r = _mm_clmulepi64_si128(_mm_and_si128(x2r, mask32), k, 0x00);
+    x1 = _mm_xor_si128(x1, x2r);
+    return (uint32_t)_mm_extract_epi32(x1, 1);
+}
+
+static uint32_t crc32_pclmul(uint32_t crc, const uint8_t *data, size_t len) {
+    if (len < 64) {
+        return crc32_zlib(crc, data, len);
+    }
+    size_t folded = len & ~(size_t)15;
+    crc = ~crc32_fold_pclmul(~crc, data, folded);
+    return crc32_zlib(crc, data + folded, len - folded);
+}
+#endif // CRC32_X86
+
+#ifdef CRC32_ARM64
+__attribute__((target("+crc")))
+static uint32_t crc32_armv8(uint32_t crc, const uint8_t *data, size_t len) {
+    crc = ~crc;
+    while (len >= 8) {
+        uint64_t v;
+        memcpy(&v, data, sizeof(v));
+        crc = __crc32d(crc, v);
+        data += 8;
+        len -= 8;
+    }
+    while (len > 0) {
+        crc = __crc32b(crc, *data++);
+        len--;
+    }
+    return ~crc;
+}
+#endif // CRC32_ARM64
+
+static pthread_once_t crc32_once = PTHREAD_ONCE_INIT;
+
+static void select_kernel(void) {
+    const cpu_features_t *cpu = cpu_features();
+
+    crc32_impl = crc32_zlib;
+    kernel_name = "zlib";
+
+#ifdef CRC32_X86
+    if (cpu->pclmul && cpu->sse42) {
+        crc32_impl = crc32_pclmul;
+        kernel_name = "pclmul";
+    }
+#elif defined(CRC32_ARM64)
+    if (cpu->crc32) {
+        crc32_impl = crc32_armv8;
+        kernel_name = "armv8-crc";
+    }
+#else
+    (void)cpu;
+#endif
+}
+
+void crc32_init(void) {
+    cpu_features_init();
+    pthread_once(&crc32_once, select_kernel);
+}
+
+uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t len) {
+    return crc32_impl(crc, data, len);
+}
+
+const char *crc32_kernel_name(void) {
+    return kernel_name;
+}
@@ -0,0 +1,16 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Selects the CRC-32 kernel once per process; safe to call repeatedly
+void crc32_init(void);
+
+// CRC-32 (gzip/zlib polynomial) of data continuing from crc, same
+// result as zlib's crc32()
+uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t len);
+
+const char *crc32_kernel_name(void);
+
+#endif // CRC32_H
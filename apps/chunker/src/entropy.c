@@ -0,0 +1,182 @@
+#define _GNU_SOURCE
+
+#include "entropy.h"
+#include <math.h>
+#include <string.h>
+
+// Four interleaved tables keep consecutive increments off the same
+// counter, which is what limits a byte histogram on modern cores.
+static void histogram_add(uint32_t hist[4][256], const uint8_t *p, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        hist[0][p[i]]++;
+        hist[1][p[i + 1]]++;
+        hist[2][p[i + 2]]++;
+        hist[3][p[i + 3]]++;
+    }
+    for (; i < n; i++) {
+        hist[0][p[i]]++;
+    }
+}
+
+static inline uint32_t load_u32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// Counts 4-byte sequences already seen in this or an earlier window
+static void match_probe(size_t *table, const uint8_t *data, size_t start,
+                        size_t n, uint64_t *probes, uint64_t *hits) {
+    if (n < 4) {
+        return;
+    }
+    for (size_t pos = start; pos + 4 <= start + n; pos++) {
+        uint32_t v = load_u32(data + pos);
+        uint32_t h = (v * 2654435761u) >> (32 - ENTROPY_MATCH_BITS);
+        size_t prev = table[h];
+        if (prev != 0 && load_u32(data + prev - 1) == v) {
+            (*hits)++;
+        }
+        table[h] = pos + 1;
+        (*probes)++;
+    }
+}
+
+void entropy_estimate(const uint8_t *data, size_t len, entropy_estimate_t *est) {
+    uint32_t hist[4][256];
+    size_t table[1u << ENTROPY_MATCH_BITS];
+    uint64_t probes = 0, hits = 0;
+    size_t windows, stride;
+
+    memset(hist, 0, sizeof(hist));
+    memset(table, 0, sizeof(table));
+
+    if (len <= (size_t)ENTROPY_WINDOW * ENTROPY_MAX_WINDOWS) {
+        windows = (len + ENTROPY_WINDOW - 1) / ENTROPY_WINDOW;
+        stride = ENTROPY_WINDOW;
+    } else {
+        windows = ENTROPY_MAX_WINDOWS;
+        stride = (len - ENTROPY_WINDOW) / (ENTROPY_MAX_WINDOWS - 1);
+    }
+
+    size_t sampled = 0;
+    for (size_t w = 0; w < windows; w++) {
+        size_t start = w * stride;
+        size_t n = len - start < ENTROPY_WINDOW ? len - start : ENTROPY_WINDOW;
+        histogram_add(hist, data + start, n);
+        match_probe(table, data, start, n, &probes, &hits);
+        sampled += n;
+    }
+
+    est->sampled = sampled;
+    est->match_ratio = probes ? (double)hits / (double)probes : 0.0;
+    est->entropy = 0.0;
+    if (sampled == 0) {
+        return;
+    }
+
+    double total = (double)sampled;
+    double h = 0.0;
+    int nonzero = 0;
+    for (int b = 0; b < 256; b++) {
+        uint32_t c = hist[0][b] + hist[1][b] + hist[2][b] + hist[3][b];
+        if (c) {
+            double p = (double)c / total;
+            h -= p * log2(p);
+            nonzero++;
+        }
+    }
+    // Miller-Madow: the plug-in estimate reads low on small samples,
+    // which would make short random blocks look compressible.
+    h += (double)(nonzero - 1) / (2.0 * total * M_LN2);
+    est->entropy = h > 8.0 ? 8.0 : h;
+}
+
+compression_tier_t entropy_tier(const entropy_estimate_t *est) {
+    compression_tier_t tier;
+
+    if (est->sampled < ENTROPY_MIN_SAMPLE) {
+        return TIER_LOW;
+    }
+    if (est->entropy >= ENTROPY_STORE_BITS && est->match_ratio < MATCH_STORE_MAX) {
+        return TIER_STORE;
+    }
+    if (est->entropy >= ENTROPY_FAST_BITS) {
+        tier = TIER_FAST;
+    } else if (est->entropy >= ENTROPY_LOW_BITS) {
+        tier = TIER_LOW;
+    } else {
+        tier = TIER_HIGH;
+    }
+    if (tier < TIER_HIGH && est->match_ratio >= MATCH_PROMOTE_MIN) {
+        tier++;
+    }
+    return tier;
+}
+
+void policy_init(compression_policy_t *policy, double target_bps,
+                 int low_level, int high_level) {
+    memset(policy, 0, sizeof(*policy));
+    policy->target_bps = target_bps > 0 ? target_bps : 0;
+    policy->low_level = low_level < high_level ? low_level : high_level;
+    policy->high_level = high_level;
+    policy->level = high_level;
+}
+
+compression_tier_t policy_select(compression_policy_t *policy,
+                                 const uint8_t *data, size_t len,
+                                 int *level, entropy_estimate_t *est) {
+    entropy_estimate(data, len, est);
+    compression_tier_t tier = entropy_tier(est);
+
+    if (policy->degraded && tier > TIER_STORE) {
+        tier--;
+    }
+    switch (tier) {
+        case TIER_HIGH:
+            *level = policy->level;
+            break;
+        case TIER_LOW:
+        case TIER_FAST:
+            *level = policy->low_level;
+            break;
+        default:
+            *level = 0;
+            break;
+    }
+    policy->tier_counts[tier]++;
+    return tier;
+}
+
+void policy_record(compression_policy_t *policy, size_t nbytes, double seconds) {
+    policy->window_bytes += nbytes;
+    policy->window_seconds += seconds;
+    if (++policy->window_calls < POLICY_WINDOW_CALLS) {
+        return;
+    }
+
+    double bps = policy->window_seconds > 0
+        ? (double)policy->window_bytes / policy->window_seconds : 0.0;
+    policy->last_bps = bps;
+    policy->window_bytes = 0;
+    policy->window_seconds = 0.0;
+    policy->window_calls = 0;
+
+    if (policy->target_bps <= 0 || bps <= 0) {
+        return;
+    }
+    if (bps < policy->target_bps * (1.0 - POLICY_HYSTERESIS)) {
+        if (policy->level > policy->low_level) {
+            policy->level--;
+        } else {
+            policy->degraded = 1;
+        }
+    } else if (bps > policy->target_bps * (1.0 + POLICY_HYSTERESIS)) {
+        if (policy->degraded) {
+            policy->degraded = 0;
+        } else if (policy->level < policy->high_level) {
+            policy->level++;
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef ENTROPY_H
+#define ENTROPY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Constants
+#define ENTROPY_WINDOW 1024        // Bytes per sampled window
+#define ENTROPY_MAX_WINDOWS 32     // Windows sampled from inputs larger than 32KB
+#define ENTROPY_MIN_SAMPLE 256     // Below this the estimate is not trusted
+#define ENTROPY_MATCH_BITS 12      // Slots in the repeat probe hash table (log2)
+
+// Tier thresholds, order-0 bits per byte
+#define ENTROPY_STORE_BITS 7.85    // Encrypted, JPEG, zstd output
+#define ENTROPY_FAST_BITS 7.2
+#define ENTROPY_LOW_BITS 5.5
+
+// Share of 4-byte probes that repeat earlier input
+#define MATCH_STORE_MAX 0.02       // High entropy is only stored when nothing repeats
+#define MATCH_PROMOTE_MIN 0.25     // Long repeats lift a block one tier
+
+// Throughput feedback
+#define POLICY_WINDOW_CALLS 8      // Blocks per controller decision
+#define POLICY_HYSTERESIS 0.10     // Dead band around the target rate
+
+typedef enum {
+    TIER_STORE = 0,  // Pass through uncompressed
+    TIER_FAST = 1,   // LZ4, or the lowest level when only zlib is available
+    TIER_LOW = 2,    // Low zstd/zlib level
+    TIER_HIGH = 3    // Controller level
+} compression_tier_t;
+
+#define TIER_COUNT 4
+
+typedef struct {
+    double entropy;      // Miller-Madow corrected bits per byte
+    double match_ratio;  // Repeat probe hits / probes
+    size_t sampled;      // Bytes inspected
+} entropy_estimate_t;
+
+// Histogram and repeat probe over evenly spaced windows of data
+void entropy_estimate(const uint8_t *data, size_t len, entropy_estimate_t *est);
+
+compression_tier_t entropy_tier(const entropy_estimate_t *est);
+
+// Per-stream level controller. Levels step down while measured throughput
+// is under target; at low_level the tiers themselves shift down one.
+typedef struct {
+    double target_bps;  // 0 disables feedback
+    int level;
+    int low_level;
+    int high_level;
+    int degraded;
+    uint64_t window_bytes;
+    double window_seconds;
+    int window_calls;
+    double last_bps;
+    uint64_t tier_counts[TIER_COUNT];
+} compression_policy_t;
+
+void policy_init(compression_policy_t *policy, double target_bps,
+                 int low_level, int high_level);
+
+// Returns the tier for data and stores the level to use in *level
+compression_tier_t policy_select(compression_policy_t *policy,
+                                 const uint8_t *data, size_t len,
+                                 int *level, entropy_estimate_t *est);
+
+// Feeds one compressed chunk's rate to the controller; stored chunks are
+// a memcpy and would read as a fast compressor, so callers skip them
+void policy_record(compression_policy_t *policy, size_t nbytes, double seconds);
+
+#endif // ENTROPY_H
@@ -0,0 +1,592 @@
+#define _GNU_SOURCE
+#include "parallel_deflate.h"
+#include <limits.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+#include "buffer_pool.h"
+#include "compression.h"
+#include "crc32.h"
+
+// Constants
+#define BLOCK_SLACK 16             // Sync flush marker and bit padding past deflateBound
+#define GZIP_HEADER 10
+#define GZIP_TRAILER 8
+#define ZLIB_HEADER 2
+#define ZLIB_TRAILER 4
+#define INDEX_VERSION 1
+#define INDEX_FIXED 9              // Version, block size and block count
+#define INDEX_SUBFIELD 4           // 'L', 'C' and the subfield length
+
+typedef struct {
+    uint8_t *data;                 // Pooled scratch, or the block's slot in the output
+    size_t size;
+    uint32_t check;                // Adler-32 or CRC-32 of the block's input
+    int result;
+} pdeflate_block_t;
+
+typedef struct {
+    const uint8_t *input;
+    size_t input_size;
+    uint8_t *output;               // Decompression only
+    const uint8_t *sizes;          // Little-endian u32 compressed sizes, decompression only
+    size_t *offsets;
+    pdeflate_options_t opts;
+    size_t count;
+    size_t next;                   // Next unclaimed block, atomic
+    pdeflate_block_t *blocks;
+} pdeflate_task_t;
+
+static size_t block_count(size_t input_size, size_t block_size) {
+    return input_size == 0 ? 1 : (input_size + block_size - 1) / block_size;
+}
+
+static size_t block_length(const pdeflate_task_t *task, size_t i) {
+    size_t start = i * task->opts.block_size;
+    size_t left = task->input_size - start;
+    return left < task->opts.block_size ? left : task->opts.block_size;
+}
+
+static int resolve_threads(int requested, size_t count) {
+    long threads = requested > 0 ? requested : sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads < 1) {
+        threads = 1;
+    }
+    if (threads > PDEFLATE_MAX_THREADS) {
+        threads = PDEFLATE_MAX_THREADS;
+    }
+    if ((size_t)threads > count) {
+        threads = (long)count;
+    }
+    return (int)threads;
+}
+
+static void resolve_options(pdeflate_options_t *opts, const pdeflate_options_t *requested) {
+    *opts = *requested;
+    if (opts->block_size == 0) {
+        opts->block_size = PDEFLATE_DEFAULT_BLOCK;
+    } else if (opts->block_size < PDEFLATE_MIN_BLOCK) {
+        opts->block_size = PDEFLATE_MIN_BLOCK;
+    } else if (opts->block_size > PDEFLATE_MAX_BLOCK) {
+        opts->block_size = PDEFLATE_MAX_BLOCK;
+    }
+}
+
+// Runs worker on the calling thread plus threads - 1 helpers; when a
+// helper cannot be started the others pick up its blocks
+static void run_workers(void *(*worker)(void *), pdeflate_task_t *task, int threads) {
+    pthread_t helpers[PDEFLATE_MAX_THREADS];
+    int started = 0;
+    for (int i = 1; i < threads; i++) {
+        if (pthread_create(&helpers[started], NULL, worker, task) != 0) {
+            break;
+        }
+        started++;
+    }
+    worker(task);
+    for (int i = 0; i < started; i++) {
+        pthread_join(helpers[i], NULL);
+    }
+}
+
+static void init_stream(z_stream *stream) {
+    memset(stream, 0, sizeof(*stream));
+    stream->zalloc = op_stats_zalloc;
+    stream->zfree = op_stats_zfree;
+    stream->opaque = &chunker_op_stats;
+}
+
+static void put_le16(uint8_t *out, uint32_t value) {
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+}
+
+static void put_le32(uint8_t *out, uint32_t value) {
+    put_le16(out, value);
+    put_le16(out + 2, value >> 16);
+}
+
+static uint32_t get_le16(const uint8_t *in) {
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8);
+}
+
+static uint32_t get_le32(const uint8_t *in) {
+    return get_le16(in) | (get_le16(in + 2) << 16);
+}
+
+// Compression
+
+static int indexed(const pdeflate_options_t *opts, size_t count) {
+    return opts->format == PDEFLATE_GZIP && opts->independent && count <= PDEFLATE_MAX_INDEXED;
+}
+
+static size_t header_size(const pdeflate_options_t *opts, size_t count) {
+    if (opts->format == PDEFLATE_ZLIB) {
+        return ZLIB_HEADER;
+    }
+    size_t size = GZIP_HEADER;
+    if (indexed(opts, count)) {
+        size += 2 + INDEX_SUBFIELD + INDEX_FIXED + 4 * count;
+    }
+    return size;
+}
+
+static size_t write_header(uint8_t *out, const pdeflate_options_t *opts,
+                           const pdeflate_block_t *blocks, size_t count) {
+    if (opts->format == PDEFLATE_ZLIB) {
+        // Same header deflateInit writes for a 32 KiB window
+        int level = opts->level == Z_DEFAULT_COMPRESSION ? 6 : opts->level;
+        unsigned flags = level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+        unsigned header = (0x78u << 8) | (flags << 6);
+        header += 31 - header % 31;
+        out[0] = (uint8_t)(header >> 8);
+        out[1] = (uint8_t)header;
+        return ZLIB_HEADER;
+    }
+
+    int index = indexed(opts, count);
+    out[0] = 0x1f;
+    out[1] = 0x8b;
+    out[2] = 8;                             // Deflate
+    out[3] = index ? 4 : 0;                 // FEXTRA
+    put_le32(out + 4, 0);                   // No MTIME
+    out[8] = opts->level == 9 ? 2 : opts->level == 1 ? 4 : 0;
+    out[9] = 3;                             // Unix
+    size_t pos = GZIP_HEADER;
+    if (index) {
+        uint32_t subfield = INDEX_FIXED + 4 * (uint32_t)count;
+        put_le16(out + pos, INDEX_SUBFIELD + subfield);
+        out[pos + 2] = 'L';
+        out[pos + 3] = 'C';
+        put_le16(out + pos + 4, subfield);
+        pos += 2 + INDEX_SUBFIELD;
+        out[pos] = INDEX_VERSION;
+        put_le32(out + pos + 1, (uint32_t)opts->block_size);
+        put_le32(out + pos + 5, (uint32_t)count);
+        pos += INDEX_FIXED;
+        for (size_t i = 0; i < count; i++) {
+            put_le32(out + pos, (uint32_t)blocks[i].size);
+            pos += 4;
+        }
+    }
+    return pos;
+}
+
+static void compress_block(pdeflate_task_t *task, size_t i) {
+    pdeflate_block_t *block = &task->blocks[i];
+    size_t start = i * task->opts.block_size;
+    size_t len = block_length(task, i);
+    const uint8_t *in = task->input + start;
+    int last = i == task->count - 1;
+
+    block->check = task->opts.format == PDEFLATE_GZIP
+        ? crc32_update(0, in, len)
+        : (uint32_t)adler32(1L, in, (uInt)len);
+
+    z_stream stream;
+    init_stream(&stream);
+    block->result = deflateInit2(&stream, task->opts.level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+    if (block->result != Z_OK) {
+        return;
+    }
+
+    size_t capacity = deflateBound(&stream, (uLong)len) + BLOCK_SLACK;
+    block->data = buffer_pool_alloc(capacity);
+    op_stats_alloc(&chunker_op_stats, capacity, block->data != NULL);
+    if (block->data == NULL) {
+        deflateEnd(&stream);
+        block->result = Z_MEM_ERROR;
+        return;
+    }
+
+    // Priming with the input before the block keeps matches across the
+    // split, so the ratio stays close to one deflate stream
+    if (!task->opts.independent && start > 0) {
+        size_t dict = start < PDEFLATE_DICT_SIZE ? start : PDEFLATE_DICT_SIZE;
+        deflateSetDictionary(&stream, in - dict, (uInt)dict);
+    }
+
+    stream.next_in = (Bytef*)in;
+    stream.avail_in = (uInt)len;
+    stream.next_out = block->data;
+    stream.avail_out = (uInt)capacity;
+    int result = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+    block->size = capacity - stream.avail_out;
+    deflateEnd(&stream);
+
+    // A sync flush that filled the buffer may not have finished its marker
+    if (last) {
+        block->result = result == Z_STREAM_END ? Z_OK : Z_BUF_ERROR;
+    } else {
+        block->result = result == Z_OK && stream.avail_in == 0 && stream.avail_out > 0 ? Z_OK : Z_BUF_ERROR;
+    }
+}
+
+static void *compress_worker(void *arg) {
+    pdeflate_task_t *task = arg;
+    size_t i;
+    while ((i = __atomic_fetch_add(&task->next, 1, __ATOMIC_RELAXED)) < task->count) {
+        compress_block(task, i);
+    }
+    return NULL;
+}
+
+size_t pdeflate_bound(size_t input_size, const pdeflate_options_t *requested) {
+    pdeflate_options_t opts;
+    resolve_options(&opts, requested);
+    size_t count = block_count(input_size, opts.block_size);
+    size_t full = input_size / opts.block_size;
+    size_t tail = input_size - full * opts.block_size;
+    size_t bound = full * (compressBound((uLong)opts.block_size) + BLOCK_SLACK);
+    if (tail > 0 || full == 0) {
+        bound += compressBound((uLong)tail) + BLOCK_SLACK;
+    }
+    return bound + header_size(&opts, count) + GZIP_TRAILER;
+}
+
+int pdeflate_compress(const uint8_t *input, size_t input_size,
+                      uint8_t *output, size_t *output_size,
+                      const pdeflate_options_t *requested) {
+    uint64_t started = op_stats_now_ns();
+    pdeflate_task_t task = {.input = input, .input_size = input_size};
+    resolve_options(&task.opts, requested);
+    task.count = block_count(input_size, task.opts.block_size);
+
+    int result = Z_OK;
+    task.blocks = calloc(task.count, sizeof(pdeflate_block_t));
+    if (task.blocks == NULL) {
+        result = Z_MEM_ERROR;
+    } else {
+        run_workers(compress_worker, &task, resolve_threads(task.opts.threads, task.count));
+    }
+
+    // Assembled in block order, so the stream does not depend on how the
+    // blocks were scheduled
+    size_t pos = 0;
+    uint32_t check = 0;
+    size_t total = 0;
+    for (size_t i = 0; result == Z_OK && i < task.count; i++) {
+        result = task.blocks[i].result;
+        total += task.blocks[i].size;
+    }
+    if (result == Z_OK) {
+        size_t trailer = task.opts.format == PDEFLATE_GZIP ? GZIP_TRAILER : ZLIB_TRAILER;
+        if (header_size(&task.opts, task.count) + total + trailer > *output_size) {
+            result = Z_BUF_ERROR;
+        }
+    }
+    if (result == Z_OK) {
+        pos = write_header(output, &task.opts, task.blocks, task.count);
+        for (size_t i = 0; i < task.count; i++) {
+            const pdeflate_block_t *block = &task.blocks[i];
+            memcpy(output + pos, block->data, block->size);
+            pos += block->size;
+            size_t len = block_length(&task, i);
+            if (i == 0) {
+                check = block->check;
+            } else if (task.opts.format == PDEFLATE_GZIP) {
+                check = (uint32_t)crc32_combine(check, block->check, (z_off_t)len);
+            } else {
+                check = (uint32_t)adler32_combine(check, block->check, (z_off_t)len);
+            }
+        }
+        if (task.opts.format == PDEFLATE_GZIP) {
+            put_le32(output + pos, check);
+            put_le32(output + pos + 4, (uint32_t)input_size);
+            pos += GZIP_TRAILER;
+        } else {
+            output[pos] = (uint8_t)(check >> 24);
+            output[pos + 1] = (uint8_t)(check >> 16);
+            output[pos + 2] = (uint8_t)(check >> 8);
+            output[pos + 3] = (uint8_t)check;
+            pos += ZLIB_TRAILER;
+        }
+        *output_size = pos;
+    }
+
+    if (task.blocks != NULL) {
+        for (size_t i = 0; i < task.count; i++) {
+            buffer_pool_free(task.blocks[i].data);
+        }
+        free(task.blocks);
+    }
+    op_stats_record(&chunker_op_stats, CHUNKER_OP_COMPRESS, op_stats_now_ns() - started,
+                    input_size, result == Z_OK ? pos : 0, result == Z_OK);
+    return result;
+}
+
+// Decompression
+
+typedef struct {
+    size_t start;                  // First deflate byte
+    size_t block_size;
+    size_t count;
+    const uint8_t *sizes;
+    uint32_t crc;
+    size_t output_size;
+} gzip_index_t;
+
+// Reads the 'LC' index of an independent gzip stream and checks it
+// against the member's length; 0 when the blocks can be inflated apart
+static int parse_index(const uint8_t *in, size_t size, gzip_index_t *index) {
+    if (size < GZIP_HEADER + 2 + GZIP_TRAILER || in[0] != 0x1f || in[1] != 0x8b ||
+        in[2] != 8 || in[3] != 4) {
+        return -1;
+    }
+    size_t xlen = get_le16(in + GZIP_HEADER);
+    size_t pos = GZIP_HEADER + 2;
+    if (xlen < INDEX_SUBFIELD + INDEX_FIXED || pos + xlen + GZIP_TRAILER > size ||
+        in[pos] != 'L' || in[pos + 1] != 'C' || in[pos + 4] != INDEX_VERSION) {
+        return -1;
+    }
+    size_t subfield = get_le16(in + pos + 2);
+    index->block_size = get_le32(in + pos + 5);
+    index->count = get_le32(in + pos + 9);
+    if (subfield + INDEX_SUBFIELD != xlen || index->count < 2 ||
+        index->count > PDEFLATE_MAX_INDEXED || subfield != INDEX_FIXED + 4 * index->count ||
+        index->block_size < PDEFLATE_MIN_BLOCK || index->block_size > PDEFLATE_MAX_BLOCK) {
+        return -1;
+    }
+    index->sizes = in + pos + INDEX_SUBFIELD + INDEX_FIXED;
+    index->start = pos + xlen;
+
+    size_t compressed = 0;
+    for (size_t i = 0; i < index->count; i++) {
+        compressed += get_le32(index->sizes + 4 * i);
+    }
+    if (index->start + compressed + GZIP_TRAILER != size) {
+        return -1;
+    }
+
+    // ISIZE is the length mod 2^32; every block but the last is full, so
+    // the last one's length is the only unknown and smaller than 2^32
+    index->crc = get_le32(in + size - GZIP_TRAILER);
+    size_t base = (index->count - 1) * index->block_size;
+    uint32_t tail = get_le32(in + size - 4) - (uint32_t)base;
+    if (tail == 0 || tail > index->block_size) {
+        return -1;
+    }
+    index->output_size = base + tail;
+    return 0;
+}
+
+static void inflate_block(pdeflate_task_t *task, size_t i) {
+    pdeflate_block_t *block = &task->blocks[i];
+    size_t len = block_length(task, i);
+    uint8_t *out = task->output + i * task->opts.block_size;
+    int last = i == task->count - 1;
+
+    z_stream stream;
+    init_stream(&stream);
+    block->result = inflateInit2(&stream, -15);
+    if (block->result != Z_OK) {
+        return;
+    }
+    stream.next_in = (Bytef*)task->input + task->offsets[i];
+    stream.avail_in = (uInt)get_le32(task->sizes + 4 * i);
+    stream.next_out = out;
+    stream.avail_out = (uInt)len;
+    int result = inflate(&stream, Z_SYNC_FLUSH);
+    if (result == Z_OK && stream.avail_in > 0) {
+        // Output full; the empty stored block of the sync flush is left
+        result = inflate(&stream, Z_SYNC_FLUSH);
+    }
+    int ok = stream.total_out == len && stream.avail_in == 0 &&
+             (last ? result == Z_STREAM_END : result == Z_OK || result == Z_BUF_ERROR);
+    inflateEnd(&stream);
+
+    block->check = crc32_update(0, out, len);
+    block->result = ok ? Z_OK : Z_DATA_ERROR;
+}
+
+static void *inflate_worker(void *arg) {
+    pdeflate_task_t *task = arg;
+    size_t i;
+    while ((i = __atomic_fetch_add(&task->next, 1, __ATOMIC_RELAXED)) < task->count) {
+        inflate_block(task, i);
+    }
+    return NULL;
+}
+
+static int inflate_parallel(const uint8_t *input, const gzip_index_t *index, int threads,
+                            uint8_t **output, size_t *output_size) {
+    pdeflate_task_t task = {
+        .input = input,
+        .input_size = index->output_size,
+        .sizes = index->sizes,
+        .count = index->count,
+    };
+    task.opts.block_size = index->block_size;
+    task.blocks = calloc(task.count, sizeof(pdeflate_block_t));
+    task.offsets = malloc(task.count * sizeof(size_t));
+    task.output = buffer_pool_alloc(index->output_size);
+    op_stats_alloc(&chunker_op_stats, index->output_size, task.output != NULL);
+    int result = Z_OK;
+    if (task.blocks == NULL || task.offsets == NULL || task.output == NULL) {
+        result = Z_MEM_ERROR;
+    } else {
+        size_t offset = index->start;
+        for (size_t i = 0; i < task.count; i++) {
+            task.offsets[i] = offset;
+            offset += get_le32(index->sizes + 4 * i);
+        }
+        run_workers(inflate_worker, &task, resolve_threads(threads, task.count));
+
+        uint32_t crc = 0;
+        for (size_t i = 0; result == Z_OK && i < task.count; i++) {
+            result = task.blocks[i].result;
+            crc = i == 0 ? task.blocks[i].check
+                         : (uint32_t)crc32_combine(crc, task.blocks[i].check,
+                                                   (z_off_t)block_length(&task, i));
+        }
+        if (result == Z_OK && crc != index->crc) {
+            result = Z_DATA_ERROR;
+        }
+    }
+
+    free(task.blocks);
+    free(task.offsets);
+    if (result != Z_OK) {
+        buffer_pool_free(task.output);
+        return result;
+    }
+    *output = task.output;
+    *output_size = index->output_size;
+    return Z_OK;
+}
+
+static uInt clamp_uint(size_t n) {
+    return n > UINT_MAX ? UINT_MAX : (uInt)n;
+}
+
+// Inflates a zlib stream, or gzip members back to back as gzip -d reads
+// them; bytes after the last stream are an error. Output past max_output
+// (0: no cap) fails with Z_BUF_ERROR.
+static int inflate_serial(const uint8_t *input, size_t input_size, size_t max_output,
+                          uint8_t **output, size_t *output_size) {
+    int gzip = input_size >= 2 && input[0] == 0x1f && input[1] == 0x8b;
+
+    // gzip states the (last member's) length up front; zlib does not, so
+    // start at 4x and double. One spare byte lets inflate reach the trailer
+    // without a grow, and one past the cap tells a stream that ends there
+    // from one that runs over.
+    size_t capacity;
+    if (gzip && input_size >= GZIP_TRAILER) {
+        capacity = (size_t)get_le32(input + input_size - 4) + 1;
+    } else {
+        capacity = input_size * 4 + 1;
+    }
+    if (capacity < PDEFLATE_MIN_BLOCK) {
+        capacity = PDEFLATE_MIN_BLOCK;
+    }
+    size_t limit = max_output != 0 ? max_output + 1 : SIZE_MAX;
+    if (capacity > limit) {
+        capacity = limit;
+    }
+
+    z_stream stream;
+    init_stream(&stream);
+    int result = inflateInit2(&stream, 15 + 32);  // zlib or gzip header
+    if (result != Z_OK) {
+        return result;
+    }
+    uint8_t *out = buffer_pool_alloc(capacity);
+    op_stats_alloc(&chunker_op_stats, capacity, out != NULL);
+    if (out == NULL) {
+        inflateEnd(&stream);
+        return Z_MEM_ERROR;
+    }
+
+    stream.next_in = (Bytef*)input;
+    stream.next_out = out;
+    size_t consumed = 0;
+    size_t used = 0;
+    for (;;) {
+        // Buffers past 4 GiB are fed to inflate a window at a time
+        stream.avail_in = clamp_uint(input_size - consumed);
+        stream.avail_out = clamp_uint(capacity - used);
+        result = inflate(&stream, Z_NO_FLUSH);
+        consumed = (size_t)(stream.next_in - (const Bytef*)input);
+        used = (size_t)(stream.next_out - out);
+
+        if (result == Z_STREAM_END) {
+            if (consumed == input_size) {
+                result = Z_OK;
+                break;
+            }
+            if (!gzip || input_size - consumed < 2 || input[consumed] != 0x1f ||
+                input[consumed + 1] != 0x8b) {
+                result = Z_DATA_ERROR;  // Trailing garbage
+                break;
+            }
+            result = inflateReset(&stream);  // Next gzip member
+            if (result != Z_OK) {
+                break;
+            }
+            continue;
+        }
+        if (result != Z_OK && result != Z_BUF_ERROR) {
+            result = result == Z_NEED_DICT ? Z_DATA_ERROR : result;
+            break;
+        }
+        if (used < capacity) {
+            if (consumed < input_size) {
+                continue;
+            }
+            // Out of input with room left: the stream is truncated
+            result = Z_DATA_ERROR;
+            break;
+        }
+        if (capacity >= limit) {
+            result = Z_BUF_ERROR;
+            break;
+        }
+
+        size_t grown = capacity > limit / 2 ? limit : capacity * 2;
+        uint8_t *next = buffer_pool_alloc(grown);
+        op_stats_alloc(&chunker_op_stats, grown, next != NULL);
+        if (next == NULL) {
+            result = Z_MEM_ERROR;
+            break;
+        }
+        memcpy(next, out, used);
+        buffer_pool_free(out);
+        out = next;
+        capacity = grown;
+        stream.next_out = out + used;
+    }
+
+    inflateEnd(&stream);
+    if (result == Z_OK && max_output != 0 && used > max_output) {
+        result = Z_BUF_ERROR;  // Ended in the spare byte
+    }
+    if (result != Z_OK) {
+        buffer_pool_free(out);
+        return result;
+    }
+    *output = out;
+    *output_size = used;
+    return Z_OK;
+}
+
+int pdeflate_decompress(const uint8_t *input, size_t input_size,
+                        uint8_t **output, size_t *output_size, int threads,
+                        size_t max_output) {
+    uint64_t started = op_stats_now_ns();
+    gzip_index_t index;
+    int result = Z_DATA_ERROR;
+    // An index over the cap may be lying; the serial path checks real output
+    if (parse_index(input, input_size, &index) == 0 &&
+        (max_output == 0 || index.output_size <= max_output)) {
+        result = inflate_parallel(input, &index, threads, output, output_size);
+    }
+    // An index that does not match its blocks is not trusted
+    if (result == Z_DATA_ERROR) {
+        result = inflate_serial(input, input_size, max_output, output, output_size);
+    }
+    op_stats_record(&chunker_op_stats, CHUNKER_OP_DECOMPRESS, op_stats_now_ns() - started,
+                    input_size, result == Z_OK ? *output_size : 0, result == Z_OK);
+    return result;
+}
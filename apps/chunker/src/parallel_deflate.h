@@ -0,0 +1,60 @@
+#ifndef PARALLEL_DEFLATE_H
+#define PARALLEL_DEFLATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Constants
+#define PDEFLATE_DEFAULT_BLOCK (1u << 20)
+#define PDEFLATE_MIN_BLOCK (64u << 10)
+#define PDEFLATE_MAX_BLOCK (64u << 20)
+#define PDEFLATE_DICT_SIZE 32768          // Deflate window
+#define PDEFLATE_MAX_THREADS 64
+#define PDEFLATE_MAX_INDEXED 16000        // Blocks that fit the gzip extra field
+
+typedef enum {
+    PDEFLATE_ZLIB = 0,
+    PDEFLATE_GZIP = 1
+} pdeflate_format_t;
+
+typedef struct {
+    int level;
+    int threads;                // 0: one per online CPU
+    size_t block_size;          // 0: PDEFLATE_DEFAULT_BLOCK
+    pdeflate_format_t format;
+    int independent;            // Blocks without dictionaries, see below
+} pdeflate_options_t;
+
+// pigz-style compression of one large buffer: the input is split into
+// block_size blocks that are deflated on helper threads, each primed with
+// the previous 32 KiB of input as a dictionary so the ratio stays close
+// to a single stream. Blocks end on a sync flush, so their raw deflate
+// output concatenates into one stream; the Adler-32 or CRC-32 of each
+// block is combined into the trailer. The result is a standard zlib or
+// gzip stream, byte-identical for any thread count.
+//
+// Independent blocks skip the dictionaries, costing some ratio. Their
+// gzip output carries the compressed block sizes in an 'LC' extra
+// subfield that stock decoders skip, and pdeflate_decompress inflates
+// such streams in parallel.
+
+// Output capacity needed for input_size bytes
+size_t pdeflate_bound(size_t input_size, const pdeflate_options_t *opts);
+
+// Z_OK with *output_size set to the stream length, or a zlib error;
+// *output_size is the capacity on entry
+int pdeflate_compress(const uint8_t *input, size_t input_size,
+                      uint8_t *output, size_t *output_size,
+                      const pdeflate_options_t *opts);
+
+// Inflates a zlib or gzip stream into a buffer_pool block returned in
+// *output (free with buffer_pool_free); indexed gzip streams are inflated
+// on up to threads threads (0: one per online CPU), anything else on the
+// calling thread. Concatenated gzip members inflate as one stream; bytes
+// after the last stream are an error. Z_OK, Z_BUF_ERROR when the output
+// would pass max_output (0: no cap), or another zlib error.
+int pdeflate_decompress(const uint8_t *input, size_t input_size,
+                        uint8_t **output, size_t *output_size, int threads,
+                        size_t max_output);
+
+#endif // PARALLEL_DEFLATE_H
@@ -1,10 +1,12 @@
 #include "chunker.h"
+#include "compression.h"
 #include <openssl/sha.h>
 #include <string.h>
 
 void calculate_checksum(unsigned char *data, size_t size, char *checksum) {
     unsigned char hash[SHA256_DIGEST_LENGTH];
     SHA256_CTX sha256;
+    uint64_t started = op_stats_now_ns();
     
     SHA256_Init(&sha256);
     SHA256_Update(&sha256, data, size);
@@ -15,4 +17,7 @@ void calculate_checksum(unsigned char *data, size_t size, char *checksum) {
         sprintf(checksum + (i * 2), "%02x", hash[i]);
     }
     checksum[SHA256_DIGEST_LENGTH * 2] = '\0';
+    
+    op_stats_record(&chunker_op_stats, CHUNKER_OP_HASH, op_stats_now_ns() - started,
+                    size, SHA256_DIGEST_LENGTH, 1);
 }
@@ -0,0 +1,9 @@
+#ifndef UTILS_H
+#define UTILS_H
+
+#include <stddef.h>
+
+// SHA-256 hex digest of data (checksum must hold 65 bytes)
+void calculate_checksum(unsigned char *data, size_t size, char *checksum);
+
+#endif // UTILS_H
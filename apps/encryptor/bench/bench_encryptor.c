@@ -0,0 +1,289 @@
+/*
+ * Standalone benchmark for the native encryptor
+ * AEAD seal/open throughput by algorithm and message size, the module's
+ * encrypt_data/decrypt_data path, BLAKE2b checksums and Ed25519 signing,
+ * written as JSON for tests/performance/native/compare_baseline.py
+ */
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sodium.h>
+#include "encryptor.h"
+#include "crypto.h"
+
+// Constants
+#define REPEATS 3                  // Best of, to keep scheduler noise out of the gate
+#define MAX_MESSAGE (1024 * 1024)
+#define AD_SIZE 32                 // Session id and chunk index as associated data
+
+typedef int (*seal_fn)(unsigned char *c, unsigned long long *clen,
+                       const unsigned char *m, unsigned long long mlen,
+                       const unsigned char *ad, unsigned long long adlen,
+                       const unsigned char *nsec, const unsigned char *npub,
+                       const unsigned char *k);
+
+typedef int (*open_fn)(unsigned char *m, unsigned long long *mlen,
+                       unsigned char *nsec,
+                       const unsigned char *c, unsigned long long clen,
+                       const unsigned char *ad, unsigned long long adlen,
+                       const unsigned char *npub, const unsigned char *k);
+
+typedef struct {
+    const char *name;
+    seal_fn seal;
+    open_fn open;
+    size_t key_bytes;
+    size_t nonce_bytes;
+} aead_t;
+
+static double min_seconds = 0.2;
+static int first_result = 1;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void emit_result(const char *name, const char *metrics) {
+    printf("%s\n    \"%s\": {%s}", first_result ? "" : ",", name, metrics);
+    first_result = 0;
+}
+
+// Best-of-REPEATS rate for op over size-byte messages; op returns nonzero
+// to abort
+typedef int (*bench_op)(void *ctx, size_t size);
+
+static int measure(bench_op op, void *ctx, size_t size, double *mb_per_s, double *ns_per_op) {
+    double best_ns = 0.0;
+
+    for (int rep = 0; rep < REPEATS; rep++) {
+        size_t ops = 0;
+        double started = now_seconds();
+        double elapsed = 0.0;
+        do {
+            for (int i = 0; i < 16; i++) {
+                if (op(ctx, size) != 0) {
+                    return -1;
+                }
+            }
+            ops += 16;
+            elapsed = now_seconds() - started;
+        } while (elapsed < min_seconds);
+        double ns = elapsed * 1e9 / (double)ops;
+        if (best_ns == 0.0 || ns < best_ns) {
+            best_ns = ns;
+        }
+    }
+    *ns_per_op = best_ns;
+    *mb_per_s = (double)size / best_ns * 1e3;
+    return 0;
+}
+
+typedef struct {
+    const aead_t *aead;
+    unsigned char key[64];
+    unsigned char nonce[32];
+    unsigned char ad[AD_SIZE];
+    unsigned char *plain;
+    unsigned char *sealed;
+    unsigned long long sealed_len;
+    unsigned char *scratch;
+} aead_ctx_t;
+
+static int aead_seal(void *ctx, size_t size) {
+    aead_ctx_t *a = ctx;
+    // A fresh nonce per message, as the encryptor does
+    sodium_increment(a->nonce, a->aead->nonce_bytes);
+    return a->aead->seal(a->sealed, &a->sealed_len, a->plain, size, a->ad, AD_SIZE,
+                         NULL, a->nonce, a->key);
+}
+
+static int aead_open(void *ctx, size_t size) {
+    aead_ctx_t *a = ctx;
+    unsigned long long len;
+    (void)size;
+    return a->aead->open(a->scratch, &len, NULL, a->sealed, a->sealed_len, a->ad, AD_SIZE,
+                         a->nonce, a->key);
+}
+
+typedef struct {
+    unsigned char key[crypto_secretbox_KEYBYTES];
+    unsigned char *plain;
+    unsigned char *sealed;
+    size_t sealed_len;
+} module_ctx_t;
+
+static int module_encrypt(void *ctx, size_t size) {
+    module_ctx_t *m = ctx;
+    unsigned char *out = NULL;
+    size_t out_len = 0;
+
+    if (encrypt_data(m->plain, size, m->key, NULL, 0, &out, &out_len, CRYPTO_XCHACHA20_POLY1305) != 0) {
+        return -1;
+    }
+    memcpy(m->sealed, out, out_len);
+    m->sealed_len = out_len;
+    buffer_pool_free(out);
+    return 0;
+}
+
+static int module_decrypt(void *ctx, size_t size) {
+    module_ctx_t *m = ctx;
+    unsigned char *out = NULL;
+    size_t out_len = 0;
+    (void)size;
+
+    if (decrypt_data(m->sealed, m->sealed_len, m->key, &out, &out_len, CRYPTO_XCHACHA20_POLY1305) != 0) {
+        return -1;
+    }
+    buffer_pool_free(out);
+    return 0;
+}
+
+static int hash_op(void *ctx, size_t size) {
+    char checksum[crypto_generichash_BYTES * 2 + 1];
+    calculate_checksum(ctx, size, checksum);
+    return 0;
+}
+
+typedef struct {
+    unsigned char pk[crypto_sign_PUBLICKEYBYTES];
+    unsigned char sk[crypto_sign_SECRETKEYBYTES];
+    unsigned char sig[crypto_sign_BYTES];
+    unsigned char *message;
+} sign_ctx_t;
+
+static int sign_op(void *ctx, size_t size) {
+    sign_ctx_t *s = ctx;
+    return crypto_sign_detached(s->sig, NULL, s->message, size, s->sk);
+}
+
+static int verify_op(void *ctx, size_t size) {
+    sign_ctx_t *s = ctx;
+    return crypto_sign_verify_detached(s->sig, s->message, size, s->pk);
+}
+
+int main(int argc, char **argv) {
+    static const size_t sizes[] = {1024, 16 * 1024, 64 * 1024, 1024 * 1024};
+    const size_t size_count = sizeof(sizes) / sizeof(sizes[0]);
+    aead_t aeads[] = {
+        {"xchacha20-poly1305", crypto_aead_xchacha20poly1305_ietf_encrypt,
+         crypto_aead_xchacha20poly1305_ietf_decrypt, crypto_aead_xchacha20poly1305_ietf_KEYBYTES,
+         crypto_aead_xchacha20poly1305_ietf_NPUBBYTES},
+        {"chacha20-poly1305", crypto_aead_chacha20poly1305_ietf_encrypt,
+         crypto_aead_chacha20poly1305_ietf_decrypt, crypto_aead_chacha20poly1305_ietf_KEYBYTES,
+         crypto_aead_chacha20poly1305_ietf_NPUBBYTES},
+        {"aes256-gcm", crypto_aead_aes256gcm_encrypt, crypto_aead_aes256gcm_decrypt,
+         crypto_aead_aes256gcm_KEYBYTES, crypto_aead_aes256gcm_NPUBBYTES},
+    };
+    size_t aead_count = sizeof(aeads) / sizeof(aeads[0]);
+    char name[128];
+    char metrics[128];
+    double rate, ns;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            min_seconds = 0.05;
+        } else {
+            fprintf(stderr, "usage: %s [--quick]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (sodium_init() < 0) {
+        fprintf(stderr, "sodium_init failed\n");
+        return 1;
+    }
+    // AES-GCM needs AES-NI and CLMUL; skip it rather than fail elsewhere
+    if (!crypto_aead_aes256gcm_is_available()) {
+        aead_count--;
+    }
+
+    unsigned char *plain = malloc(MAX_MESSAGE);
+    unsigned char *sealed = malloc(MAX_MESSAGE + 128);
+    unsigned char *scratch = malloc(MAX_MESSAGE + 128);
+    if (plain == NULL || sealed == NULL || scratch == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    randombytes_buf(plain, MAX_MESSAGE);
+
+    printf("{\n  \"suite\": \"encryptor_native.c\",\n  \"libsodium\": \"%s\",\n  \"results\": {",
+           sodium_version_string());
+
+    for (size_t a = 0; a < aead_count; a++) {
+        aead_ctx_t ctx = {.aead = &aeads[a], .plain = plain, .sealed = sealed, .scratch = scratch};
+        randombytes_buf(ctx.key, aeads[a].key_bytes);
+        randombytes_buf(ctx.nonce, aeads[a].nonce_bytes);
+        randombytes_buf(ctx.ad, sizeof(ctx.ad));
+
+        for (size_t s = 0; s < size_count; s++) {
+            if (measure(aead_seal, &ctx, sizes[s], &rate, &ns) < 0) {
+                fprintf(stderr, "%s seal failed\n", aeads[a].name);
+                return 1;
+            }
+            snprintf(name, sizeof(name), "seal/%s/size=%zu", aeads[a].name, sizes[s]);
+            snprintf(metrics, sizeof(metrics), "\"mb_per_s\": %.2f, \"ns_per_op\": %.0f", rate, ns);
+            emit_result(name, metrics);
+
+            // Opens the message the last seal produced
+            if (measure(aead_open, &ctx, sizes[s], &rate, &ns) < 0) {
+                fprintf(stderr, "%s open failed\n", aeads[a].name);
+                return 1;
+            }
+            snprintf(name, sizeof(name), "open/%s/size=%zu", aeads[a].name, sizes[s]);
+            snprintf(metrics, sizeof(metrics), "\"mb_per_s\": %.2f, \"ns_per_op\": %.0f", rate, ns);
+            emit_result(name, metrics);
+        }
+    }
+
+    // What Encryptor.encrypt/decrypt run, including the output allocation
+    module_ctx_t module = {.plain = plain, .sealed = sealed};
+    randombytes_buf(module.key, sizeof(module.key));
+    for (size_t s = 0; s < size_count; s++) {
+        if (measure(module_encrypt, &module, sizes[s], &rate, &ns) < 0) {
+            fprintf(stderr, "encrypt_data failed\n");
+            return 1;
+        }
+        snprintf(name, sizeof(name), "encrypt_data/size=%zu", sizes[s]);
+        snprintf(metrics, sizeof(metrics), "\"mb_per_s\": %.2f, \"ns_per_op\": %.0f", rate, ns);
+        emit_result(name, metrics);
+        if (measure(module_decrypt, &module, sizes[s], &rate, &ns) < 0) {
+            fprintf(stderr, "decrypt_data failed\n");
+            return 1;
+        }
+        snprintf(name, sizeof(name), "decrypt_data/size=%zu", sizes[s]);
+        snprintf(metrics, sizeof(metrics), "\"mb_per_s\": %.2f, \"ns_per_op\": %.0f", rate, ns);
+        emit_result(name, metrics);
+    }
+
+    for (size_t s = 0; s < size_count; s++) {
+        measure(hash_op, plain, sizes[s], &rate, &ns);
+        snprintf(name, sizeof(name), "blake2b/size=%zu", sizes[s]);
+        snprintf(metrics, sizeof(metrics), "\"mb_per_s\": %.2f, \"ns_per_op\": %.0f", rate, ns);
+        emit_result(name, metrics);
+    }
+
+    sign_ctx_t signer = {.message = plain};
+    crypto_sign_keypair(signer.pk, signer.sk);
+    measure(sign_op, &signer, 1024, &rate, &ns);
+    snprintf(metrics, sizeof(metrics), "\"ops_per_s\": %.0f, \"ns_per_op\": %.0f", 1e9 / ns, ns);
+    emit_result("ed25519_sign/size=1024", metrics);
+    if (measure(verify_op, &signer, 1024, &rate, &ns) < 0) {
+        fprintf(stderr, "verify failed\n");
+        return 1;
+    }
+    snprintf(metrics, sizeof(metrics), "\"ops_per_s\": %.0f, \"ns_per_op\": %.0f", 1e9 / ns, ns);
+    emit_result("ed25519_verify/size=1024", metrics);
+
+    printf("\n  }\n}\n");
+    free(plain);
+    free(sealed);
+    free(scratch);
+    return 0;
+}
@@ -7,8 +7,10 @@ x-lucid-file-type: python
 Setup script for native libsodium encryptor extension
 """
 
-from setuptools import setup, Extension
+from setuptools import setup, Extension, Command
 import os
+import subprocess
+import sysconfig
 
 # Check for libsodium
 libsodium_paths = [
@@ -49,6 +51,16 @@ if not libsodium_lib or not libsodium_include:
     print("CentOS/RHEL: sudo yum install libsodium-devel")
     print("macOS: brew install libsodium")
 
+# Helpers shared with the chunker extension (op stats, async pool, buffer
+# pool, pooled buffers) are built from one copy in apps/native_common
+NATIVE_COMMON_DIR = '../native_common/src/'
+NATIVE_COMMON_SOURCES = [
+    NATIVE_COMMON_DIR + 'async_pool.c',
+    NATIVE_COMMON_DIR + 'buffer_pool.c',
+    NATIVE_COMMON_DIR + 'op_stats.c',
+    NATIVE_COMMON_DIR + 'pooled_buffer.c'
+]
+
 # Define the extension module
 encryptor_native = Extension(
     'encryptor_native',
@@ -56,12 +68,13 @@ encryptor_native = Extension(
         'src/encryptor.c',
         'src/crypto.c',
         'src/utils.c'
-    ],
+    ] + NATIVE_COMMON_SOURCES,
     include_dirs=[
         'src/',
+        NATIVE_COMMON_DIR,
         libsodium_include
-    ] if libsodium_include else ['src/'],
-    libraries=['sodium'],
+    ] if libsodium_include else ['src/', NATIVE_COMMON_DIR],
+    libraries=['sodium', 'pthread'],
     library_dirs=[libsodium_lib] if libsodium_lib else [],
     extra_compile_args=[
         '-O3',
@@ -73,12 +86,63 @@ encryptor_native = Extension(
     extra_link_args=['-shared']
 )
 
+
+class BenchCommand(Command):
+    """Build and run the standalone C benchmark (bench/bench_encryptor.c)"""
+    
+    description = 'build and run the native encryptor benchmark'
+    user_options = [
+        ('output=', 'o', 'write JSON results to this file instead of stdout'),
+        ('quick', 'q', 'shorter timing loops'),
+    ]
+    
+    def initialize_options(self):
+        self.output = None
+        self.quick = False
+    
+    def finalize_options(self):
+        pass
+    
+    def run(self):
+        from distutils.ccompiler import new_compiler
+        from distutils.sysconfig import customize_compiler
+        
+        if not libsodium_lib or not libsodium_include:
+            raise SystemExit("libsodium is required to build the benchmark")
+        
+        compiler = new_compiler()
+        customize_compiler(compiler)
+        build_dir = os.path.join('build', 'bench')
+        
+        # The extension's sources minus the parts that need Python
+        python_sources = ('src/encryptor.c', NATIVE_COMMON_DIR + 'async_pool.c', NATIVE_COMMON_DIR + 'pooled_buffer.c')
+        sources = [src for src in encryptor_native.sources if src not in python_sources]
+        objects = compiler.compile(
+            sources + ['bench/bench_encryptor.c'],
+            output_dir=build_dir,
+            include_dirs=encryptor_native.include_dirs + [sysconfig.get_paths()['include']],
+            extra_postargs=[arg for arg in encryptor_native.extra_compile_args if arg != '-fPIC'],
+        )
+        binary = os.path.join(build_dir, 'bench_encryptor')
+        compiler.link_executable(objects, binary,
+                                 libraries=encryptor_native.libraries,
+                                 library_dirs=encryptor_native.library_dirs)
+        
+        args = [binary] + (['--quick'] if self.quick else [])
+        if self.output:
+            with open(self.output, 'w') as out:
+                subprocess.run(args, stdout=out, check=True)
+        else:
+            subprocess.run(args, check=True)
+
+
 setup(
     name='encryptor-native',
     version='0.1.0',
     description='Native libsodium encryptor extension for Lucid RDP',
     ext_modules=[encryptor_native] if libsodium_lib and libsodium_include else [],
-    python_requires='>=3.8',
+    cmdclass={'bench': BenchCommand},
+    python_requires='>=3.9',
     install_requires=[
         'PyNaCl>=1.5.0'
     ],
@@ -88,9 +152,10 @@ setup(
         'License :: OSI Approved :: MIT License',
         'Programming Language :: C',
         'Programming Language :: Python :: 3',
-        'Programming Language :: Python :: 3.8',
         'Programming Language :: Python :: 3.9',
         'Programming Language :: Python :: 3.10',
         'Programming Language :: Python :: 3.11',
+        'Programming Language :: Python :: 3.12',
+        'Programming Language :: Python :: 3.13',
     ],
 )
@@ -1,6 +1,16 @@
 #include "encryptor.h"
 #include "crypto.h"
 
+static const char *const encryptor_op_names[ENCRYPTOR_OP_COUNT] = {"encrypt", "decrypt", "sign", "verify"};
+
+op_stats_t encryptor_op_stats = {.names = encryptor_op_names, .op_count = ENCRYPTOR_OP_COUNT};
+
+static unsigned char *crypto_buffer_alloc(size_t size) {
+    unsigned char *ptr = buffer_pool_alloc(size);
+    op_stats_alloc(&encryptor_op_stats, size, ptr != NULL);
+    return ptr;
+}
+
 int encrypt_data(unsigned char *data, size_t data_len,
                 unsigned char *key,
                 unsigned char *additional_data, size_t additional_data_len,
@@ -9,6 +19,7 @@ int encrypt_data(unsigned char *data, size_t data_len,
     
     unsigned char nonce[crypto_secretbox_NONCEBYTES];
     size_t total_size;
+    uint64_t started = op_stats_now_ns();
     
     // Generate random nonce
     randombytes_buf(nonce, sizeof(nonce));
@@ -17,8 +28,10 @@ int encrypt_data(unsigned char *data, size_t data_len,
     total_size = sizeof(nonce) + crypto_secretbox_MACBYTES + data_len;
     
     // Allocate memory for encrypted data
-    *encrypted = malloc(total_size);
+    *encrypted = crypto_buffer_alloc(total_size);
     if (*encrypted == NULL) {
+        op_stats_record(&encryptor_op_stats, ENCRYPTOR_OP_ENCRYPT, op_stats_now_ns() - started,
+                        data_len, 0, 0);
         return -1;
     }
     
@@ -34,11 +47,14 @@ int encrypt_data(unsigned char *data, size_t data_len,
         key
     );
     
+    op_stats_record(&encryptor_op_stats, ENCRYPTOR_OP_ENCRYPT, op_stats_now_ns() - started,
+                    data_len, result == 0 ? total_size : 0, result == 0);
+    
     if (result == 0) {
         *encrypted_size = total_size;
         return 0;
     } else {
-        free(*encrypted);
+        buffer_pool_free(*encrypted);
         *encrypted = NULL;
         return -1;
     }
@@ -49,7 +65,11 @@ int decrypt_data(unsigned char *encrypted_data, size_t encrypted_data_len,
                 unsigned char **decrypted, size_t *decrypted_size,
                 crypto_algorithm_t algorithm) {
     
+    uint64_t started = op_stats_now_ns();
+    
     if (encrypted_data_len < crypto_secretbox_NONCEBYTES + crypto_secretbox_MACBYTES) {
+        op_stats_record(&encryptor_op_stats, ENCRYPTOR_OP_DECRYPT, op_stats_now_ns() - started,
+                        encrypted_data_len, 0, 0);
         return -1;
     }
     
@@ -62,8 +82,10 @@ int decrypt_data(unsigned char *encrypted_data, size_t encrypted_data_len,
     size_t decrypted_len = ciphertext_len - crypto_secretbox_MACBYTES;
     
     // Allocate memory for decrypted data
-    *decrypted = malloc(decrypted_len);
+    *decrypted = crypto_buffer_alloc(decrypted_len);
     if (*decrypted == NULL) {
+        op_stats_record(&encryptor_op_stats, ENCRYPTOR_OP_DECRYPT, op_stats_now_ns() - started,
+                        encrypted_data_len, 0, 0);
         return -1;
     }
     
@@ -76,11 +98,14 @@ int decrypt_data(unsigned char *encrypted_data, size_t encrypted_data_len,
         key
     );
     
+    op_stats_record(&encryptor_op_stats, ENCRYPTOR_OP_DECRYPT, op_stats_now_ns() - started,
+                    encrypted_data_len, result == 0 ? decrypted_len : 0, result == 0);
+    
     if (result == 0) {
         *decrypted_size = decrypted_len;
         return 0;
     } else {
-        free(*decrypted);
+        buffer_pool_free(*decrypted);
         *decrypted = NULL;
         return -1;
     }
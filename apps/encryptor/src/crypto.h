@@ -2,8 +2,24 @@
 #define CRYPTO_H
 
 #include <sodium.h>
+#include "buffer_pool.h"
+#include "op_stats.h"
 
-// Function declarations for cryptographic operations
+// Operations timed in encryptor_op_stats
+enum {
+    ENCRYPTOR_OP_ENCRYPT = 0,
+    ENCRYPTOR_OP_DECRYPT = 1,
+    ENCRYPTOR_OP_SIGN = 2,
+    ENCRYPTOR_OP_VERIFY = 3,
+    ENCRYPTOR_OP_COUNT = 4
+};
+
+// Module-wide latency histograms and counters; ciphertext, plaintext and
+// signature buffers are charged to its allocation counters
+extern op_stats_t encryptor_op_stats;
+
+// Function declarations for cryptographic operations; output buffers
+// come from the buffer pool and are returned with buffer_pool_free()
 int encrypt_data(unsigned char *data, size_t data_len,
                 unsigned char *key,
                 unsigned char *additional_data, size_t additional_data_len,
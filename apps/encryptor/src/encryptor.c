@@ -12,9 +12,26 @@
 #include "encryptor.h"
 #include "crypto.h"
 #include "utils.h"
+#include "async_pool.h"
+#include "pooled_buffer.h"
 
 #define MAX_DATA_SIZE (1024 * 1024 * 1024)  // 1GB max data size
 
+#ifndef Py_TPFLAGS_IMMUTABLETYPE
+#define Py_TPFLAGS_IMMUTABLETYPE 0
+#endif
+
+// Per-module state; each interpreter that imports the module gets its own
+typedef struct {
+    PyTypeObject *encryptor_type;
+    PyTypeObject *buffer_type;
+    PyObject *pool;  // Workers behind encrypt_async and decrypt_async
+} encryptor_state;
+
+static struct PyModuleDef encryptor_module;
+
+// algorithm_type and initialized are read and written atomically, so
+// concurrent calls need no GIL
 typedef struct {
     PyObject_HEAD
     char algorithm[64];
@@ -22,42 +39,89 @@ typedef struct {
     int initialized;
 } EncryptorObject;
 
-static PyTypeObject EncryptorType;
+static inline int encryptor_ready(EncryptorObject *self) {
+    if (!__atomic_load_n(&self->initialized, __ATOMIC_ACQUIRE)) {
+        PyErr_SetString(PyExc_RuntimeError, "Encryptor not initialized");
+        return 0;
+    }
+    return 1;
+}
+
+static inline crypto_algorithm_t encryptor_algorithm(EncryptorObject *self) {
+    return (crypto_algorithm_t)__atomic_load_n(&self->algorithm_type, __ATOMIC_RELAXED);
+}
+
+static encryptor_state* encryptor_state_of(PyTypeObject *type) {
+#if PY_VERSION_HEX >= 0x030B0000
+    PyObject *module = PyType_GetModuleByDef(type, &encryptor_module);
+#else
+    PyObject *module = PyType_GetModule(type);
+#endif
+    return module ? PyModule_GetState(module) : NULL;
+}
+
+// Pooled output as a PooledBuffer when pooled is set, otherwise copied
+// into bytes; the block is consumed either way
+static PyObject* encryptor_buffer_result(EncryptorObject *self, int pooled, unsigned char *data, size_t size) {
+    if (pooled) {
+        encryptor_state *state = encryptor_state_of(Py_TYPE(self));
+        if (state == NULL) {
+            buffer_pool_free(data);
+            return NULL;
+        }
+        return pooled_buffer_wrap(state->buffer_type, data, size);
+    }
+    PyObject *ret = PyBytes_FromStringAndSize((char*)data, (Py_ssize_t)size);
+    buffer_pool_free(data);
+    return ret;
+}
 
 // Forward declarations
 static PyObject* Encryptor_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
 static void Encryptor_dealloc(EncryptorObject *self);
 static int Encryptor_init(EncryptorObject *self, PyObject *args, PyObject *kwds);
 static PyObject* Encryptor_generate_key(EncryptorObject *self, PyObject *args);
-static PyObject* Encryptor_encrypt(EncryptorObject *self, PyObject *args);
-static PyObject* Encryptor_decrypt(EncryptorObject *self, PyObject *args);
-static PyObject* Encryptor_sign(EncryptorObject *self, PyObject *args);
+static PyObject* Encryptor_encrypt(EncryptorObject *self, PyObject *args, PyObject *kwds);
+static PyObject* Encryptor_decrypt(EncryptorObject *self, PyObject *args, PyObject *kwds);
+static PyObject* Encryptor_encrypt_async(EncryptorObject *self, PyObject *args, PyObject *kwds);
+static PyObject* Encryptor_decrypt_async(EncryptorObject *self, PyObject *args, PyObject *kwds);
+static PyObject* Encryptor_sign(EncryptorObject *self, PyObject *args, PyObject *kwds);
 static PyObject* Encryptor_verify(EncryptorObject *self, PyObject *args);
 static PyObject* Encryptor_cleanup(EncryptorObject *self, PyObject *args);
 
 // Method definitions
 static PyMethodDef Encryptor_methods[] = {
     {"generate_key", (PyCFunction)Encryptor_generate_key, METH_NOARGS, "Generate encryption key"},
-    {"encrypt", (PyCFunction)Encryptor_encrypt, METH_VARARGS, "Encrypt data"},
-    {"decrypt", (PyCFunction)Encryptor_decrypt, METH_VARARGS, "Decrypt data"},
-    {"sign", (PyCFunction)Encryptor_sign, METH_VARARGS, "Sign data"},
+    {"encrypt", (PyCFunction)(void(*)(void))Encryptor_encrypt, METH_VARARGS | METH_KEYWORDS,
+     "Encrypt data; pooled=True returns a PooledBuffer"},
+    {"decrypt", (PyCFunction)(void(*)(void))Encryptor_decrypt, METH_VARARGS | METH_KEYWORDS,
+     "Decrypt data; pooled=True returns a PooledBuffer"},
+    {"encrypt_async", (PyCFunction)(void(*)(void))Encryptor_encrypt_async, METH_VARARGS | METH_KEYWORDS,
+     "Encrypt on the native worker pool; returns a future of the running loop"},
+    {"decrypt_async", (PyCFunction)(void(*)(void))Encryptor_decrypt_async, METH_VARARGS | METH_KEYWORDS,
+     "Decrypt on the native worker pool; returns a future of the running loop"},
+    {"sign", (PyCFunction)(void(*)(void))Encryptor_sign, METH_VARARGS | METH_KEYWORDS, "Sign data"},
     {"verify", (PyCFunction)Encryptor_verify, METH_VARARGS, "Verify signature"},
     {"cleanup", (PyCFunction)Encryptor_cleanup, METH_NOARGS, "Cleanup resources"},
     {NULL, NULL, 0, NULL}
 };
 
 // Type definition
-static PyTypeObject EncryptorType = {
-    PyVarObject_HEAD_INIT(NULL, 0)
-    .tp_name = "encryptor_native.Encryptor",
-    .tp_doc = "Native libsodium encryptor for high-performance encryption",
-    .tp_basicsize = sizeof(EncryptorObject),
-    .tp_itemsize = 0,
-    .tp_flags = Py_TPFLAGS_DEFAULT,
-    .tp_new = Encryptor_new,
-    .tp_init = (initproc)Encryptor_init,
-    .tp_dealloc = (destructor)Encryptor_dealloc,
-    .tp_methods = Encryptor_methods,
+static PyType_Slot Encryptor_slots[] = {
+    {Py_tp_doc, "Native libsodium encryptor for high-performance encryption"},
+    {Py_tp_new, Encryptor_new},
+    {Py_tp_init, Encryptor_init},
+    {Py_tp_dealloc, Encryptor_dealloc},
+    {Py_tp_methods, Encryptor_methods},
+    {0, NULL}
+};
+
+static PyType_Spec Encryptor_spec = {
+    .name = "encryptor_native.Encryptor",
+    .basicsize = sizeof(EncryptorObject),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_IMMUTABLETYPE,
+    .slots = Encryptor_slots,
 };
 
 // Module methods
@@ -70,18 +134,185 @@ static PyObject* encryptor_libsodium_version(PyObject *self, PyObject *args) {
 }
 
 static PyObject* encryptor_available_algorithms(PyObject *self, PyObject *args) {
+    if (sodium_init() < 0) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to initialize libsodium");
+        return NULL;
+    }
+    
+    // libsodium only provides AES-GCM with AES-NI+PCLMUL or the ARMv8
+    // crypto extensions, so Pi 4 class nodes do not list it
     PyObject *algorithms = PyList_New(0);
     PyList_Append(algorithms, PyUnicode_FromString("xchacha20-poly1305"));
     PyList_Append(algorithms, PyUnicode_FromString("chacha20-poly1305"));
-    PyList_Append(algorithms, PyUnicode_FromString("aes256-gcm"));
+    if (crypto_aead_aes256gcm_is_available()) {
+        PyList_Append(algorithms, PyUnicode_FromString("aes256-gcm"));
+    }
     PyList_Append(algorithms, PyUnicode_FromString("salsa20-poly1305"));
     return algorithms;
 }
 
+static PyObject* op_histogram_dict(const op_histogram_t *hist, int with_buckets) {
+    PyObject *dict = Py_BuildValue(
+        "{s:K,s:K,s:K,s:K,s:d,s:K,s:K,s:K,s:K,s:K,s:K}",
+        "count", (unsigned long long)hist->count,
+        "errors", (unsigned long long)hist->errors,
+        "sum_ns", (unsigned long long)hist->sum_ns,
+        "max_ns", (unsigned long long)hist->max_ns,
+        "mean_ns", hist->count ? (double)hist->sum_ns / (double)hist->count : 0.0,
+        "p50_ns", (unsigned long long)op_histogram_quantile(hist, 0.50),
+        "p90_ns", (unsigned long long)op_histogram_quantile(hist, 0.90),
+        "p99_ns", (unsigned long long)op_histogram_quantile(hist, 0.99),
+        "p999_ns", (unsigned long long)op_histogram_quantile(hist, 0.999),
+        "bytes_in", (unsigned long long)hist->bytes_in,
+        "bytes_out", (unsigned long long)hist->bytes_out);
+    if (dict == NULL || !with_buckets) {
+        return dict;
+    }
+    
+    // Occupied buckets by inclusive upper bound in ns
+    PyObject *buckets = PyDict_New();
+    if (buckets == NULL) {
+        Py_DECREF(dict);
+        return NULL;
+    }
+    for (int b = 0; b < OP_STATS_BUCKETS; b++) {
+        if (hist->buckets[b] == 0) {
+            continue;
+        }
+        PyObject *key = PyLong_FromUnsignedLongLong(op_stats_bucket_upper(b));
+        PyObject *value = PyLong_FromUnsignedLongLong(hist->buckets[b]);
+        int rc = (key && value) ? PyDict_SetItem(buckets, key, value) : -1;
+        Py_XDECREF(key);
+        Py_XDECREF(value);
+        if (rc < 0) {
+            Py_DECREF(buckets);
+            Py_DECREF(dict);
+            return NULL;
+        }
+    }
+    if (PyDict_SetItemString(dict, "buckets", buckets) < 0) {
+        Py_DECREF(buckets);
+        Py_DECREF(dict);
+        return NULL;
+    }
+    Py_DECREF(buckets);
+    return dict;
+}
+
+static PyObject* encryptor_snapshot(PyObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"buckets", NULL};
+    int with_buckets = 0;
+    
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|p", kwlist, &with_buckets)) {
+        return NULL;
+    }
+    
+    op_snapshot_t *snap = malloc(sizeof(op_snapshot_t));
+    if (snap == NULL) {
+        return PyErr_NoMemory();
+    }
+    
+    Py_BEGIN_ALLOW_THREADS
+    op_stats_snapshot(&encryptor_op_stats, snap);
+    Py_END_ALLOW_THREADS
+    
+    PyObject *ret = Py_BuildValue("{s:K,s:K,s:K}",
+                                  "allocations", (unsigned long long)snap->allocations,
+                                  "allocated_bytes", (unsigned long long)snap->allocated_bytes,
+                                  "allocation_failures", (unsigned long long)snap->alloc_failures);
+    for (int op = 0; ret != NULL && op < ENCRYPTOR_OP_COUNT; op++) {
+        PyObject *hist = op_histogram_dict(&snap->ops[op], with_buckets);
+        if (hist == NULL || PyDict_SetItemString(ret, encryptor_op_stats.names[op], hist) < 0) {
+            Py_CLEAR(ret);
+        }
+        Py_XDECREF(hist);
+    }
+    
+    free(snap);
+    return ret;
+}
+
+static PyObject* encryptor_prometheus(PyObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"prefix", NULL};
+    const char *prefix = "lucid_encryptor";
+    char *text = NULL;
+    
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|s", kwlist, &prefix)) {
+        return NULL;
+    }
+    
+    op_snapshot_t *snap = malloc(sizeof(op_snapshot_t));
+    if (snap == NULL) {
+        return PyErr_NoMemory();
+    }
+    
+    Py_BEGIN_ALLOW_THREADS
+    op_stats_snapshot(&encryptor_op_stats, snap);
+    text = op_stats_prometheus(&encryptor_op_stats, snap, prefix);
+    Py_END_ALLOW_THREADS
+    free(snap);
+    
+    if (text == NULL) {
+        return PyErr_NoMemory();
+    }
+    PyObject *ret = PyUnicode_FromString(text);
+    free(text);
+    return ret;
+}
+
+static PyObject* encryptor_configure_pool(PyObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"workers", "max_inflight", "max_waiting", NULL};
+    int workers = 0;
+    Py_ssize_t max_inflight = 0;
+    Py_ssize_t max_waiting = 0;
+    
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|inn", kwlist, &workers, &max_inflight,
+                                     &max_waiting)) {
+        return NULL;
+    }
+    encryptor_state *state = PyModule_GetState(self);
+    if (async_pool_configure(state->pool, workers, max_inflight, max_waiting) < 0) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* encryptor_pool_stats(PyObject *self, PyObject *args) {
+    return async_pool_stats(((encryptor_state*)PyModule_GetState(self))->pool);
+}
+
+static PyObject* encryptor_alloc_buffer(PyObject *self, PyObject *args) {
+    return pooled_buffer_alloc(((encryptor_state*)PyModule_GetState(self))->buffer_type, args);
+}
+
+static PyObject* encryptor_configure_buffer_pool(PyObject *self, PyObject *args, PyObject *kwds) {
+    return pooled_buffer_configure(args, kwds);
+}
+
+static PyObject* encryptor_trim_buffer_pool(PyObject *self, PyObject *args) {
+    return pooled_buffer_trim();
+}
+
+static PyObject* encryptor_buffer_pool_stats(PyObject *self, PyObject *args) {
+    return pooled_buffer_stats();
+}
+
 static PyMethodDef encryptor_module_methods[] = {
     {"version", encryptor_version, METH_NOARGS, "Get version"},
     {"libsodium_version", encryptor_libsodium_version, METH_NOARGS, "Get libsodium version"},
     {"available_algorithms", encryptor_available_algorithms, METH_NOARGS, "Get available algorithms"},
+    {"snapshot", (PyCFunction)(void(*)(void))encryptor_snapshot, METH_VARARGS | METH_KEYWORDS,
+     "Latency percentiles, byte and allocation counters per operation"},
+    {"prometheus", (PyCFunction)(void(*)(void))encryptor_prometheus, METH_VARARGS | METH_KEYWORDS,
+     "Operation metrics in Prometheus text format"},
+    {"configure_pool", (PyCFunction)(void(*)(void))encryptor_configure_pool, METH_VARARGS | METH_KEYWORDS,
+     "Set worker count, in-flight and waiting bounds for async operations before first use"},
+    {"pool_stats", encryptor_pool_stats, METH_NOARGS, "Worker pool counters"},
+    {"alloc_buffer", encryptor_alloc_buffer, METH_VARARGS, "Zero-filled PooledBuffer of size bytes"},
+    {"configure_buffer_pool", (PyCFunction)(void(*)(void))encryptor_configure_buffer_pool,
+     METH_VARARGS | METH_KEYWORDS, "Set buffer cache limits in MB and the huge page policy"},
+    {"trim_buffer_pool", encryptor_trim_buffer_pool, METH_NOARGS, "Unmap cached buffers"},
+    {"buffer_pool_stats", encryptor_buffer_pool_stats, METH_NOARGS, "Buffer pool counters"},
     {NULL, NULL, 0, NULL}
 };
 
@@ -105,22 +336,24 @@ static int Encryptor_init(EncryptorObject *self, PyObject *args, PyObject *kwds)
     }
     
     if (algorithm != NULL) {
-        strncpy(self->algorithm, algorithm, sizeof(self->algorithm) - 1);
-        self->algorithm[sizeof(self->algorithm) - 1] = '\0';
-        
         // Determine algorithm type
+        int algorithm_type;
         if (strcmp(algorithm, "xchacha20-poly1305") == 0) {
-            self->algorithm_type = CRYPTO_XCHACHA20_POLY1305;
+            algorithm_type = CRYPTO_XCHACHA20_POLY1305;
         } else if (strcmp(algorithm, "chacha20-poly1305") == 0) {
-            self->algorithm_type = CRYPTO_CHACHA20_POLY1305;
+            algorithm_type = CRYPTO_CHACHA20_POLY1305;
         } else if (strcmp(algorithm, "aes256-gcm") == 0) {
-            self->algorithm_type = CRYPTO_AES256_GCM;
+            algorithm_type = CRYPTO_AES256_GCM;
         } else if (strcmp(algorithm, "salsa20-poly1305") == 0) {
-            self->algorithm_type = CRYPTO_SALSA20_POLY1305;
+            algorithm_type = CRYPTO_SALSA20_POLY1305;
         } else {
             PyErr_SetString(PyExc_ValueError, "Unsupported algorithm");
             return -1;
         }
+        
+        strncpy(self->algorithm, algorithm, sizeof(self->algorithm) - 1);
+        self->algorithm[sizeof(self->algorithm) - 1] = '\0';
+        __atomic_store_n(&self->algorithm_type, algorithm_type, __ATOMIC_RELAXED);
     }
     
     // Initialize libsodium
@@ -129,17 +362,18 @@ static int Encryptor_init(EncryptorObject *self, PyObject *args, PyObject *kwds)
         return -1;
     }
     
-    self->initialized = 1;
+    __atomic_store_n(&self->initialized, 1, __ATOMIC_RELEASE);
     return 0;
 }
 
 static void Encryptor_dealloc(EncryptorObject *self) {
-    Py_TYPE(self)->tp_free((PyObject*)self);
+    PyTypeObject *type = Py_TYPE(self);
+    type->tp_free((PyObject*)self);
+    Py_DECREF(type);
 }
 
 static PyObject* Encryptor_generate_key(EncryptorObject *self, PyObject *args) {
-    if (!self->initialized) {
-        PyErr_SetString(PyExc_RuntimeError, "Encryptor not initialized");
+    if (!encryptor_ready(self)) {
         return NULL;
     }
     
@@ -149,17 +383,19 @@ static PyObject* Encryptor_generate_key(EncryptorObject *self, PyObject *args) {
     return PyBytes_FromStringAndSize((char*)key, sizeof(key));
 }
 
-static PyObject* Encryptor_encrypt(EncryptorObject *self, PyObject *args) {
-    if (!self->initialized) {
-        PyErr_SetString(PyExc_RuntimeError, "Encryptor not initialized");
+static PyObject* Encryptor_encrypt(EncryptorObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"data", "key", "additional_data", "pooled", NULL};
+    if (!encryptor_ready(self)) {
         return NULL;
     }
     
     Py_buffer data, key, additional_data;
     additional_data.buf = NULL;
     additional_data.len = 0;
+    int pooled = 0;
     
-    if (!PyArg_ParseTuple(args, "y*y*|y*", &data, &key, &additional_data)) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*y*|y*$p", kwlist,
+                                     &data, &key, &additional_data, &pooled)) {
         return NULL;
     }
     
@@ -188,12 +424,11 @@ static PyObject* Encryptor_encrypt(EncryptorObject *self, PyObject *args) {
                              (unsigned char*)key.buf,
                              additional_data.buf, additional_data.len,
                              &encrypted, &encrypted_size,
-                             self->algorithm_type);
+                             encryptor_algorithm(self));
     
     PyObject *ret = NULL;
     if (result == 0 && encrypted != NULL) {
-        ret = PyBytes_FromStringAndSize((char*)encrypted, encrypted_size);
-        free(encrypted);
+        ret = encryptor_buffer_result(self, pooled, encrypted, encrypted_size);
     } else {
         PyErr_SetString(PyExc_RuntimeError, "Encryption failed");
     }
@@ -205,15 +440,16 @@ static PyObject* Encryptor_encrypt(EncryptorObject *self, PyObject *args) {
     return ret;
 }
 
-static PyObject* Encryptor_decrypt(EncryptorObject *self, PyObject *args) {
-    if (!self->initialized) {
-        PyErr_SetString(PyExc_RuntimeError, "Encryptor not initialized");
+static PyObject* Encryptor_decrypt(EncryptorObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"data", "key", "pooled", NULL};
+    if (!encryptor_ready(self)) {
         return NULL;
     }
     
     Py_buffer encrypted_data, key;
+    int pooled = 0;
     
-    if (!PyArg_ParseTuple(args, "y*y*", &encrypted_data, &key)) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*y*|$p", kwlist, &encrypted_data, &key, &pooled)) {
         return NULL;
     }
     
@@ -232,12 +468,11 @@ static PyObject* Encryptor_decrypt(EncryptorObject *self, PyObject *args) {
     int result = decrypt_data((unsigned char*)encrypted_data.buf, encrypted_data.len,
                              (unsigned char*)key.buf,
                              &decrypted, &decrypted_size,
-                             self->algorithm_type);
+                             encryptor_algorithm(self));
     
     PyObject *ret = NULL;
     if (result == 0 && decrypted != NULL) {
-        ret = PyBytes_FromStringAndSize((char*)decrypted, decrypted_size);
-        free(decrypted);
+        ret = encryptor_buffer_result(self, pooled, decrypted, decrypted_size);
     } else {
         PyErr_SetString(PyExc_RuntimeError, "Decryption failed");
     }
@@ -248,15 +483,125 @@ static PyObject* Encryptor_decrypt(EncryptorObject *self, PyObject *args) {
     return ret;
 }
 
-static PyObject* Encryptor_sign(EncryptorObject *self, PyObject *args) {
-    if (!self->initialized) {
-        PyErr_SetString(PyExc_RuntimeError, "Encryptor not initialized");
+typedef struct {
+    async_job_t base;
+    EncryptorObject *encryptor;  // Keeps the type, and so the module, alive
+    int decrypt;
+    int pooled;
+    crypto_algorithm_t algorithm;
+    Py_buffer data;
+    Py_buffer key;
+    Py_buffer additional_data;  // buf is NULL when not given
+    unsigned char *output;
+    size_t output_size;
+    int result;
+} CryptJob;
+
+static void crypt_job_work(async_job_t *job) {
+    CryptJob *crypt = (CryptJob*)job;
+    if (crypt->decrypt) {
+        crypt->result = decrypt_data((unsigned char*)crypt->data.buf, crypt->data.len,
+                                     (unsigned char*)crypt->key.buf,
+                                     &crypt->output, &crypt->output_size,
+                                     crypt->algorithm);
+    } else {
+        crypt->result = encrypt_data((unsigned char*)crypt->data.buf, crypt->data.len,
+                                     (unsigned char*)crypt->key.buf,
+                                     crypt->additional_data.buf, crypt->additional_data.len,
+                                     &crypt->output, &crypt->output_size,
+                                     crypt->algorithm);
+    }
+}
+
+static PyObject* crypt_job_result(async_job_t *job) {
+    CryptJob *crypt = (CryptJob*)job;
+    if (crypt->result != 0 || crypt->output == NULL) {
+        PyErr_SetString(PyExc_RuntimeError, crypt->decrypt ? "Decryption failed" : "Encryption failed");
+        return NULL;
+    }
+    PyObject *ret = encryptor_buffer_result(crypt->encryptor, crypt->pooled, crypt->output, crypt->output_size);
+    crypt->output = NULL;
+    return ret;
+}
+
+static void crypt_job_release(async_job_t *job) {
+    CryptJob *crypt = (CryptJob*)job;
+    buffer_pool_free(crypt->output);
+    Py_XDECREF(crypt->encryptor);
+    PyBuffer_Release(&crypt->data);
+    PyBuffer_Release(&crypt->key);
+    if (crypt->additional_data.buf) PyBuffer_Release(&crypt->additional_data);
+    PyMem_Free(crypt);
+}
+
+static PyObject* crypt_async(EncryptorObject *self, PyObject *args, PyObject *kwds, int decrypt) {
+    static char *encrypt_kwlist[] = {"data", "key", "additional_data", "pooled", NULL};
+    static char *decrypt_kwlist[] = {"data", "key", "pooled", NULL};
+    if (!encryptor_ready(self)) {
+        return NULL;
+    }
+    
+    CryptJob *job = PyMem_Calloc(1, sizeof(CryptJob));
+    if (job == NULL) {
+        return PyErr_NoMemory();
+    }
+    
+    int parsed = decrypt
+        ? PyArg_ParseTupleAndKeywords(args, kwds, "y*y*|$p", decrypt_kwlist,
+                                      &job->data, &job->key, &job->pooled)
+        : PyArg_ParseTupleAndKeywords(args, kwds, "y*y*|y*$p", encrypt_kwlist,
+                                      &job->data, &job->key, &job->additional_data, &job->pooled);
+    if (!parsed) {
+        PyMem_Free(job);
+        return NULL;
+    }
+    
+    const char *error = NULL;
+    if (!decrypt && job->data.len > MAX_DATA_SIZE) {
+        error = "Data too large";
+    } else if (job->key.len != crypto_secretbox_KEYBYTES) {
+        error = "Invalid key size";
+    }
+    
+    Py_INCREF(self);
+    job->encryptor = self;
+    job->decrypt = decrypt;
+    job->algorithm = encryptor_algorithm(self);
+    job->base.work = crypt_job_work;
+    job->base.result = crypt_job_result;
+    job->base.release = crypt_job_release;
+    if (error != NULL) {
+        crypt_job_release(&job->base);
+        PyErr_SetString(PyExc_ValueError, error);
+        return NULL;
+    }
+    
+    encryptor_state *state = encryptor_state_of(Py_TYPE(self));
+    if (state == NULL) {
+        crypt_job_release(&job->base);
+        return NULL;
+    }
+    return async_pool_submit(state->pool, &job->base);
+}
+
+static PyObject* Encryptor_encrypt_async(EncryptorObject *self, PyObject *args, PyObject *kwds) {
+    return crypt_async(self, args, kwds, 0);
+}
+
+static PyObject* Encryptor_decrypt_async(EncryptorObject *self, PyObject *args, PyObject *kwds) {
+    return crypt_async(self, args, kwds, 1);
+}
+
+static PyObject* Encryptor_sign(EncryptorObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"data", "pooled", NULL};
+    if (!encryptor_ready(self)) {
         return NULL;
     }
     
     Py_buffer data;
+    int pooled = 0;
     
-    if (!PyArg_ParseTuple(args, "y*", &data)) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|$p", kwlist, &data, &pooled)) {
         return NULL;
     }
     
@@ -268,8 +613,10 @@ static PyObject* Encryptor_sign(EncryptorObject *self, PyObject *args) {
     // Sign data
     unsigned char *signed_data = NULL;
     unsigned long long signed_data_len = 0;
+    uint64_t started = op_stats_now_ns();
     
-    signed_data = malloc(data.len + crypto_sign_BYTES);
+    signed_data = buffer_pool_alloc(data.len + crypto_sign_BYTES);
+    op_stats_alloc(&encryptor_op_stats, data.len + crypto_sign_BYTES, signed_data != NULL);
     if (signed_data == NULL) {
         PyBuffer_Release(&data);
         PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory");
@@ -279,23 +626,24 @@ static PyObject* Encryptor_sign(EncryptorObject *self, PyObject *args) {
     int result = crypto_sign(signed_data, &signed_data_len,
                             (unsigned char*)data.buf, data.len,
                             signing_key);
+    op_stats_record(&encryptor_op_stats, ENCRYPTOR_OP_SIGN, op_stats_now_ns() - started,
+                    (size_t)data.len, result == 0 ? (size_t)signed_data_len : 0, result == 0);
     
     PyObject *ret = NULL;
     if (result == 0) {
-        ret = PyBytes_FromStringAndSize((char*)signed_data, signed_data_len);
+        ret = encryptor_buffer_result(self, pooled, signed_data, (size_t)signed_data_len);
     } else {
+        buffer_pool_free(signed_data);
         PyErr_SetString(PyExc_RuntimeError, "Signing failed");
     }
     
-    free(signed_data);
     PyBuffer_Release(&data);
     
     return ret;
 }
 
 static PyObject* Encryptor_verify(EncryptorObject *self, PyObject *args) {
-    if (!self->initialized) {
-        PyErr_SetString(PyExc_RuntimeError, "Encryptor not initialized");
+    if (!encryptor_ready(self)) {
         return NULL;
     }
     
@@ -306,9 +654,13 @@ static PyObject* Encryptor_verify(EncryptorObject *self, PyObject *args) {
     }
     
     // Verify signature
+    uint64_t started = op_stats_now_ns();
     int result = crypto_sign_verify_detached((unsigned char*)signature.buf,
                                             (unsigned char*)data.buf, data.len,
                                             NULL);  // In real implementation, use actual public key
+    // A failed check is an answer, not an error
+    op_stats_record(&encryptor_op_stats, ENCRYPTOR_OP_VERIFY, op_stats_now_ns() - started,
+                    (size_t)data.len, 0, 1);
     
     PyBuffer_Release(&data);
     PyBuffer_Release(&signature);
@@ -321,35 +673,81 @@ static PyObject* Encryptor_verify(EncryptorObject *self, PyObject *args) {
 }
 
 static PyObject* Encryptor_cleanup(EncryptorObject *self, PyObject *args) {
-    self->initialized = 0;
+    __atomic_store_n(&self->initialized, 0, __ATOMIC_RELEASE);
     Py_RETURN_NONE;
 }
 
 // Module definition
-static struct PyModuleDef encryptor_module = {
-    PyModuleDef_HEAD_INIT,
-    "encryptor_native",
-    "Native libsodium encryptor extension for Lucid RDP",
-    -1,
-    encryptor_module_methods
-};
-
-PyMODINIT_FUNC PyInit_encryptor_native(void) {
-    if (PyType_Ready(&EncryptorType) < 0) {
-        return NULL;
+static int encryptor_exec(PyObject *m) {
+    encryptor_state *state = PyModule_GetState(m);
+    
+    state->encryptor_type = (PyTypeObject*)PyType_FromModuleAndSpec(m, &Encryptor_spec, NULL);
+    if (state->encryptor_type == NULL || PyModule_AddType(m, state->encryptor_type) < 0) {
+        return -1;
     }
     
-    PyObject *m = PyModule_Create(&encryptor_module);
-    if (m == NULL) {
-        return NULL;
+    state->buffer_type = pooled_buffer_type_new(m, "encryptor_native.PooledBuffer");
+    if (state->buffer_type == NULL || PyModule_AddType(m, state->buffer_type) < 0) {
+        return -1;
     }
     
-    Py_INCREF(&EncryptorType);
-    if (PyModule_AddObject(m, "Encryptor", (PyObject*)&EncryptorType) < 0) {
-        Py_DECREF(&EncryptorType);
-        Py_DECREF(m);
-        return NULL;
+    state->pool = async_pool_new();
+    if (state->pool == NULL) {
+        return -1;
     }
     
-    return m;
+    if (PyModule_AddIntConstant(m, "OP_ENCRYPT", ENCRYPTOR_OP_ENCRYPT) < 0 ||
+        PyModule_AddIntConstant(m, "OP_DECRYPT", ENCRYPTOR_OP_DECRYPT) < 0 ||
+        PyModule_AddIntConstant(m, "OP_SIGN", ENCRYPTOR_OP_SIGN) < 0 ||
+        PyModule_AddIntConstant(m, "OP_VERIFY", ENCRYPTOR_OP_VERIFY) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+static int encryptor_traverse(PyObject *m, visitproc visit, void *arg) {
+    encryptor_state *state = PyModule_GetState(m);
+    Py_VISIT(state->encryptor_type);
+    Py_VISIT(state->buffer_type);
+    Py_VISIT(state->pool);
+    return 0;
+}
+
+static int encryptor_clear(PyObject *m) {
+    encryptor_state *state = PyModule_GetState(m);
+    Py_CLEAR(state->encryptor_type);
+    Py_CLEAR(state->buffer_type);
+    Py_CLEAR(state->pool);
+    return 0;
+}
+
+static void encryptor_free(void *m) {
+    encryptor_clear((PyObject*)m);
+}
+
+static PyModuleDef_Slot encryptor_slots[] = {
+    {Py_mod_exec, encryptor_exec},
+#if PY_VERSION_HEX >= 0x030C0000
+    {Py_mod_multiple_interpreters, Py_MOD_PER_INTERPRETER_GIL_SUPPORTED},
+#endif
+#if PY_VERSION_HEX >= 0x030D0000
+    {Py_mod_gil, Py_MOD_GIL_NOT_USED},
+#endif
+    {0, NULL}
+};
+
+static struct PyModuleDef encryptor_module = {
+    PyModuleDef_HEAD_INIT,
+    .m_name = "encryptor_native",
+    .m_doc = "Native libsodium encryptor extension for Lucid RDP",
+    .m_size = sizeof(encryptor_state),
+    .m_methods = encryptor_module_methods,
+    .m_slots = encryptor_slots,
+    .m_traverse = encryptor_traverse,
+    .m_clear = encryptor_clear,
+    .m_free = encryptor_free,
+};
+
+PyMODINIT_FUNC PyInit_encryptor_native(void) {
+    return PyModuleDef_Init(&encryptor_module);
 }
@@ -0,0 +1,13 @@
+# Erasure Module
+# Reed-Solomon erasure coding for chunk storage
+
+"""
+File: /app/apps/erasure/__init__.py
+x-lucid-file-path: /app/apps/erasure/__init__.py
+x-lucid-file-type: python
+
+Erasure package for Lucid RDP.
+Contains native Reed-Solomon erasure coding used for chunk storage.
+"""
+
+__all__ = []
@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+"""
+File: /app/apps/erasure/setup.py
+x-lucid-file-path: /app/apps/erasure/setup.py
+x-lucid-file-type: python
+
+Setup script for native Reed-Solomon erasure coding extension
+"""
+
+from setuptools import setup, Extension
+
+# Define the extension module. SIMD kernels are selected at runtime, so the
+# same build runs on x86-64 (SSSE3/AVX2) and aarch64 (NEON) nodes.
+erasure_native = Extension(
+    'erasure_native',
+    sources=[
+        'src/erasure.c',
+        'src/reed_solomon.c',
+        'src/gf256.c'
+    ],
+    include_dirs=[
+        'src/'
+    ],
+    libraries=[],
+    library_dirs=[],
+    extra_compile_args=[
+        '-O3',
+        '-Wall',
+        '-Wextra',
+        '-std=c99',
+        '-fPIC'
+    ],
+    extra_link_args=['-shared']
+)
+
+setup(
+    name='erasure-native',
+    version='0.1.0',
+    description='Native Reed-Solomon erasure coding extension for Lucid RDP',
+    ext_modules=[erasure_native],
+    python_requires='>=3.8',
+    classifiers=[
+        'Development Status :: 3 - Alpha',
+        'Intended Audience :: Developers',
+        'License :: OSI Approved :: MIT License',
+        'Programming Language :: C',
+        'Programming Language :: Python :: 3',
+        'Programming Language :: Python :: 3.8',
+        'Programming Language :: Python :: 3.9',
+        'Programming Language :: Python :: 3.10',
+        'Programming Language :: Python :: 3.11',
+    ],
+)
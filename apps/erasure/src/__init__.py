@@ -0,0 +1,13 @@
+# Erasure Source Module
+# Erasure coding native source code components
+
+"""
+File: /app/apps/erasure/src/__init__.py
+x-lucid-file-path: /app/apps/erasure/src/__init__.py
+x-lucid-file-type: python
+
+Erasure Source package for Lucid RDP.
+Contains Reed-Solomon native source code and C implementations.
+"""
+
+__all__ = []
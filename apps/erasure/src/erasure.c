@@ -0,0 +1,500 @@
+/*
+ * Native Reed-Solomon erasure coding extension for Lucid RDP
+ * Splits chunks into k data + m parity shards and rebuilds them from any k
+ */
+
+#include <Python.h>
+#include <structmember.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "erasure.h"
+#include "gf256.h"
+#include "reed_solomon.h"
+
+typedef struct {
+    PyObject_HEAD
+    int data_shards;
+    int parity_shards;
+    rs_codec_t codec;
+    int codec_initialized;
+} ReedSolomonObject;
+
+static PyTypeObject ReedSolomonType;
+
+// Forward declarations
+static PyObject* ReedSolomon_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
+static void ReedSolomon_dealloc(ReedSolomonObject *self);
+static int ReedSolomon_init(ReedSolomonObject *self, PyObject *args, PyObject *kwds);
+static PyObject* ReedSolomon_shard_size(ReedSolomonObject *self, PyObject *args);
+static PyObject* ReedSolomon_encode(ReedSolomonObject *self, PyObject *args);
+static PyObject* ReedSolomon_encode_into(ReedSolomonObject *self, PyObject *args);
+static PyObject* ReedSolomon_reconstruct(ReedSolomonObject *self, PyObject *args);
+static PyObject* ReedSolomon_decode(ReedSolomonObject *self, PyObject *args);
+
+// Method definitions
+static PyMethodDef ReedSolomon_methods[] = {
+    {"shard_size", (PyCFunction)ReedSolomon_shard_size, METH_VARARGS, "Shard size for a payload length"},
+    {"encode", (PyCFunction)ReedSolomon_encode, METH_VARARGS, "Encode data into k+m shard views"},
+    {"encode_into", (PyCFunction)ReedSolomon_encode_into, METH_VARARGS, "Encode data into a caller-supplied buffer"},
+    {"reconstruct", (PyCFunction)ReedSolomon_reconstruct, METH_VARARGS, "Rebuild missing shards"},
+    {"decode", (PyCFunction)ReedSolomon_decode, METH_VARARGS, "Recover the original payload from any k shards"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyMemberDef ReedSolomon_members[] = {
+    {"data_shards", T_INT, offsetof(ReedSolomonObject, data_shards), READONLY, "Number of data shards (k)"},
+    {"parity_shards", T_INT, offsetof(ReedSolomonObject, parity_shards), READONLY, "Number of parity shards (m)"},
+    {NULL, 0, 0, 0, NULL}
+};
+
+// Type definition
+static PyTypeObject ReedSolomonType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "erasure_native.ReedSolomon",
+    .tp_doc = "Systematic Reed-Solomon codec over GF(2^8)",
+    .tp_basicsize = sizeof(ReedSolomonObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = ReedSolomon_new,
+    .tp_init = (initproc)ReedSolomon_init,
+    .tp_dealloc = (destructor)ReedSolomon_dealloc,
+    .tp_methods = ReedSolomon_methods,
+    .tp_members = ReedSolomon_members,
+};
+
+// Module methods
+static PyObject* erasure_version(PyObject *self, PyObject *args) {
+    return PyUnicode_FromString("0.1.0");
+}
+
+static PyObject* erasure_kernel(PyObject *self, PyObject *args) {
+    return PyUnicode_FromString(gf256_kernel_name());
+}
+
+static PyMethodDef erasure_module_methods[] = {
+    {"version", erasure_version, METH_NOARGS, "Get version"},
+    {"kernel", erasure_kernel, METH_NOARGS, "Get the selected GF(2^8) kernel"},
+    {NULL, NULL, 0, NULL}
+};
+
+static size_t shard_size_for(ReedSolomonObject *self, size_t length) {
+    size_t size = (length + self->data_shards - 1) / self->data_shards;
+    return size ? size : 1;
+}
+
+// Copy the payload into the first k shards (zero padded) and compute parity
+static void encode_payload(ReedSolomonObject *self, const unsigned char *data,
+                           size_t length, unsigned char *out, size_t shard_size) {
+    const int total = self->data_shards + self->parity_shards;
+    uint8_t *shards[RS_MAX_SHARDS];
+
+    memcpy(out, data, length);
+    memset(out + length, 0, (size_t)self->data_shards * shard_size - length);
+
+    for (int i = 0; i < total; i++) {
+        shards[i] = out + (size_t)i * shard_size;
+    }
+    rs_encode(&self->codec, shards, shard_size);
+}
+
+// Acquire buffers for a shard list. Missing entries are None.
+static int collect_shards(ReedSolomonObject *self, PyObject *list, Py_buffer *views,
+                          int *present, size_t *shard_size) {
+    const int total = self->data_shards + self->parity_shards;
+
+    if (!PyList_Check(list) && !PyTuple_Check(list)) {
+        PyErr_SetString(PyExc_TypeError, "Shards must be a list or tuple");
+        return -1;
+    }
+    if (PySequence_Fast_GET_SIZE(list) != total) {
+        PyErr_Format(PyExc_ValueError, "Expected %d shards", total);
+        return -1;
+    }
+
+    *shard_size = 0;
+    for (int i = 0; i < total; i++) {
+        PyObject *item = PySequence_Fast_GET_ITEM(list, i);
+        present[i] = 0;
+        if (item == Py_None) {
+            continue;
+        }
+
+        if (PyObject_GetBuffer(item, &views[i], PyBUF_SIMPLE) < 0) {
+            goto fail;
+        }
+        present[i] = 1;
+
+        if (*shard_size == 0) {
+            *shard_size = (size_t)views[i].len;
+        } else if ((size_t)views[i].len != *shard_size) {
+            PyErr_SetString(PyExc_ValueError, "Shards must all have the same size");
+            goto fail;
+        }
+    }
+
+    if (*shard_size == 0) {
+        PyErr_SetString(PyExc_ValueError, "No shards available");
+        goto fail;
+    }
+    return 0;
+
+fail:
+    for (int i = 0; i < total; i++) {
+        if (present[i]) {
+            PyBuffer_Release(&views[i]);
+            present[i] = 0;
+        }
+    }
+    return -1;
+}
+
+static void release_shards(ReedSolomonObject *self, Py_buffer *views, const int *present) {
+    const int total = self->data_shards + self->parity_shards;
+    for (int i = 0; i < total; i++) {
+        if (present[i]) {
+            PyBuffer_Release(&views[i]);
+        }
+    }
+}
+
+// ReedSolomon object methods
+static PyObject* ReedSolomon_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
+    ReedSolomonObject *self = (ReedSolomonObject*)type->tp_alloc(type, 0);
+    if (self != NULL) {
+        self->data_shards = DEFAULT_DATA_SHARDS;
+        self->parity_shards = DEFAULT_PARITY_SHARDS;
+        self->codec_initialized = 0;
+    }
+    return (PyObject*)self;
+}
+
+static int ReedSolomon_init(ReedSolomonObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"data_shards", "parity_shards", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|ii", kwlist,
+                                     &self->data_shards, &self->parity_shards)) {
+        return -1;
+    }
+
+    // Validate parameters
+    if (self->data_shards <= 0 || self->parity_shards < 0 ||
+        self->data_shards + self->parity_shards > RS_MAX_SHARDS) {
+        PyErr_SetString(PyExc_ValueError, "Invalid shard configuration");
+        return -1;
+    }
+
+    if (self->codec_initialized) {
+        rs_codec_free(&self->codec);
+        self->codec_initialized = 0;
+    }
+
+    if (rs_codec_init(&self->codec, self->data_shards, self->parity_shards) != 0) {
+        PyErr_SetString(PyExc_MemoryError, "Failed to initialize Reed-Solomon codec");
+        return -1;
+    }
+    self->codec_initialized = 1;
+
+    return 0;
+}
+
+static void ReedSolomon_dealloc(ReedSolomonObject *self) {
+    if (self->codec_initialized) {
+        rs_codec_free(&self->codec);
+    }
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static PyObject* ReedSolomon_shard_size(ReedSolomonObject *self, PyObject *args) {
+    Py_ssize_t length;
+
+    if (!PyArg_ParseTuple(args, "n", &length)) {
+        return NULL;
+    }
+    if (length < 0) {
+        PyErr_SetString(PyExc_ValueError, "Length must be non-negative");
+        return NULL;
+    }
+
+    return PyLong_FromSize_t(shard_size_for(self, (size_t)length));
+}
+
+static PyObject* ReedSolomon_encode(ReedSolomonObject *self, PyObject *args) {
+    Py_buffer data;
+
+    if (!PyArg_ParseTuple(args, "y*", &data)) {
+        return NULL;
+    }
+
+    if (data.len > MAX_ENCODE_SIZE) {
+        PyBuffer_Release(&data);
+        PyErr_SetString(PyExc_ValueError, "Data too large for erasure coding");
+        return NULL;
+    }
+
+    const int total = self->data_shards + self->parity_shards;
+    size_t shard_size = shard_size_for(self, (size_t)data.len);
+
+    // All shards live in a single bytes object; callers get memoryview
+    // slices over it so nothing is copied per shard
+    PyObject *block = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)(shard_size * total));
+    if (block == NULL) {
+        PyBuffer_Release(&data);
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    encode_payload(self, (const unsigned char*)data.buf, (size_t)data.len,
+                   (unsigned char*)PyBytes_AS_STRING(block), shard_size);
+    Py_END_ALLOW_THREADS
+
+    PyBuffer_Release(&data);
+
+    PyObject *view = PyMemoryView_FromObject(block);
+    Py_DECREF(block);
+    if (view == NULL) {
+        return NULL;
+    }
+
+    PyObject *ret = PyList_New(total);
+    if (ret == NULL) {
+        Py_DECREF(view);
+        return NULL;
+    }
+
+    for (int i = 0; i < total; i++) {
+        PyObject *start = PyLong_FromSize_t((size_t)i * shard_size);
+        PyObject *stop = PyLong_FromSize_t((size_t)(i + 1) * shard_size);
+        PyObject *slice = (start && stop) ? PySlice_New(start, stop, NULL) : NULL;
+        PyObject *shard = NULL;
+
+        if (slice) {
+            shard = PyObject_GetItem(view, slice);
+        }
+        Py_XDECREF(slice);
+        Py_XDECREF(start);
+        Py_XDECREF(stop);
+
+        if (shard == NULL) {
+            Py_DECREF(ret);
+            Py_DECREF(view);
+            return NULL;
+        }
+        PyList_SET_ITEM(ret, i, shard);
+    }
+
+    Py_DECREF(view);
+    return ret;
+}
+
+static PyObject* ReedSolomon_encode_into(ReedSolomonObject *self, PyObject *args) {
+    Py_buffer data, out;
+
+    if (!PyArg_ParseTuple(args, "y*w*", &data, &out)) {
+        return NULL;
+    }
+
+    const int total = self->data_shards + self->parity_shards;
+    size_t shard_size = shard_size_for(self, (size_t)data.len);
+
+    if ((size_t)out.len < shard_size * total) {
+        PyBuffer_Release(&data);
+        PyBuffer_Release(&out);
+        PyErr_SetString(PyExc_ValueError, "Output buffer too small");
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    encode_payload(self, (const unsigned char*)data.buf, (size_t)data.len,
+                   (unsigned char*)out.buf, shard_size);
+    Py_END_ALLOW_THREADS
+
+    PyBuffer_Release(&data);
+    PyBuffer_Release(&out);
+    return PyLong_FromSize_t(shard_size);
+}
+
+static PyObject* ReedSolomon_reconstruct(ReedSolomonObject *self, PyObject *args) {
+    PyObject *shards_arg;
+    Py_buffer views[RS_MAX_SHARDS];
+    int present[RS_MAX_SHARDS];
+    uint8_t *ptrs[RS_MAX_SHARDS];
+    size_t shard_size;
+
+    if (!PyArg_ParseTuple(args, "O", &shards_arg)) {
+        return NULL;
+    }
+
+    PyObject *seq = PySequence_Fast(shards_arg, "Shards must be a sequence");
+    if (seq == NULL) {
+        return NULL;
+    }
+
+    if (collect_shards(self, seq, views, present, &shard_size) < 0) {
+        Py_DECREF(seq);
+        return NULL;
+    }
+
+    const int total = self->data_shards + self->parity_shards;
+    PyObject *ret = PyList_New(total);
+    if (ret == NULL) {
+        release_shards(self, views, present);
+        Py_DECREF(seq);
+        return NULL;
+    }
+
+    for (int i = 0; i < total; i++) {
+        PyObject *item = PySequence_Fast_GET_ITEM(seq, i);
+        if (present[i]) {
+            Py_INCREF(item);
+            PyList_SET_ITEM(ret, i, item);
+            ptrs[i] = (uint8_t*)views[i].buf;
+        } else {
+            PyObject *rebuilt = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)shard_size);
+            if (rebuilt == NULL) {
+                Py_DECREF(ret);
+                release_shards(self, views, present);
+                Py_DECREF(seq);
+                return NULL;
+            }
+            PyList_SET_ITEM(ret, i, rebuilt);
+            ptrs[i] = (uint8_t*)PyBytes_AS_STRING(rebuilt);
+        }
+    }
+
+    int result;
+    Py_BEGIN_ALLOW_THREADS
+    result = rs_reconstruct(&self->codec, ptrs, present, shard_size, 0);
+    Py_END_ALLOW_THREADS
+
+    release_shards(self, views, present);
+    Py_DECREF(seq);
+
+    if (result != 0) {
+        Py_DECREF(ret);
+        PyErr_SetString(PyExc_ValueError, "Not enough shards to reconstruct");
+        return NULL;
+    }
+
+    return ret;
+}
+
+static PyObject* ReedSolomon_decode(ReedSolomonObject *self, PyObject *args) {
+    PyObject *shards_arg;
+    Py_ssize_t length;
+    Py_buffer views[RS_MAX_SHARDS];
+    int present[RS_MAX_SHARDS];
+    uint8_t *ptrs[RS_MAX_SHARDS];
+    size_t shard_size;
+
+    if (!PyArg_ParseTuple(args, "On", &shards_arg, &length)) {
+        return NULL;
+    }
+
+    PyObject *seq = PySequence_Fast(shards_arg, "Shards must be a sequence");
+    if (seq == NULL) {
+        return NULL;
+    }
+
+    if (collect_shards(self, seq, views, present, &shard_size) < 0) {
+        Py_DECREF(seq);
+        return NULL;
+    }
+
+    if (length < 0 || (size_t)length > shard_size * self->data_shards) {
+        release_shards(self, views, present);
+        Py_DECREF(seq);
+        PyErr_SetString(PyExc_ValueError, "Invalid payload length");
+        return NULL;
+    }
+
+    // Missing data shards are rebuilt into one scratch area
+    int missing = 0;
+    for (int i = 0; i < self->data_shards; i++) {
+        missing += !present[i];
+    }
+
+    unsigned char *scratch = NULL;
+    if (missing > 0) {
+        scratch = malloc(shard_size * missing);
+        if (scratch == NULL) {
+            release_shards(self, views, present);
+            Py_DECREF(seq);
+            PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory");
+            return NULL;
+        }
+    }
+
+    const int total = self->data_shards + self->parity_shards;
+    int n = 0;
+    for (int i = 0; i < total; i++) {
+        if (present[i]) {
+            ptrs[i] = (uint8_t*)views[i].buf;
+        } else if (i < self->data_shards) {
+            ptrs[i] = scratch + (size_t)n++ * shard_size;
+        } else {
+            ptrs[i] = NULL;
+        }
+    }
+
+    PyObject *ret = PyBytes_FromStringAndSize(NULL, length);
+    int result = -1;
+    if (ret != NULL) {
+        char *dst = PyBytes_AS_STRING(ret);
+        Py_BEGIN_ALLOW_THREADS
+        result = missing ? rs_reconstruct(&self->codec, ptrs, present, shard_size, 1) : 0;
+        if (result == 0) {
+            size_t remaining = (size_t)length;
+            for (int i = 0; i < self->data_shards && remaining > 0; i++) {
+                size_t len = remaining < shard_size ? remaining : shard_size;
+                memcpy(dst, ptrs[i], len);
+                dst += len;
+                remaining -= len;
+            }
+        }
+        Py_END_ALLOW_THREADS
+    }
+
+    free(scratch);
+    release_shards(self, views, present);
+    Py_DECREF(seq);
+
+    if (ret != NULL && result != 0) {
+        Py_DECREF(ret);
+        PyErr_SetString(PyExc_ValueError, "Not enough shards to decode");
+        return NULL;
+    }
+
+    return ret;
+}
+
+// Module definition
+static struct PyModuleDef erasure_module = {
+    PyModuleDef_HEAD_INIT,
+    "erasure_native",
+    "Native Reed-Solomon erasure coding extension for Lucid RDP",
+    -1,
+    erasure_module_methods
+};
+
+PyMODINIT_FUNC PyInit_erasure_native(void) {
+    gf256_init();
+
+    if (PyType_Ready(&ReedSolomonType) < 0) {
+        return NULL;
+    }
+
+    PyObject *m = PyModule_Create(&erasure_module);
+    if (m == NULL) {
+        return NULL;
+    }
+
+    Py_INCREF(&ReedSolomonType);
+    if (PyModule_AddObject(m, "ReedSolomon", (PyObject*)&ReedSolomonType) < 0) {
+        Py_DECREF(&ReedSolomonType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    return m;
+}
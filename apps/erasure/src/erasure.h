@@ -0,0 +1,11 @@
+#ifndef ERASURE_H
+#define ERASURE_H
+
+#include <Python.h>
+
+// Constants
+#define MAX_ENCODE_SIZE (100 * 1024 * 1024)  // 100MB, matches chunker MAX_CHUNK_SIZE
+#define DEFAULT_DATA_SHARDS 8
+#define DEFAULT_PARITY_SHARDS 3
+
+#endif // ERASURE_H
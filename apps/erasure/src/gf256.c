@@ -0,0 +1,252 @@
+/*
+ * GF(2^8) arithmetic for the Reed-Solomon codec
+ * Region kernels use split 4-bit lookup tables (PSHUFB / TBL) when the
+ * CPU supports them and fall back to a full 256x256 product table.
+ */
+
+#include <string.h>
+#include "gf256.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GF256_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define GF256_NEON 1
+#endif
+
+static uint8_t gf_exp[512];
+static uint8_t gf_log[256];
+static uint8_t gf_mul_table[256][256];
+static int gf_initialized = 0;
+
+typedef void (*region_fn)(uint8_t *dst, const uint8_t *src, uint8_t c, size_t len);
+
+static region_fn mul_region_impl = NULL;
+static region_fn mul_add_region_impl = NULL;
+static const char *kernel_name = "scalar";
+
+uint8_t gf256_mul(uint8_t a, uint8_t b) {
+    if (a == 0 || b == 0) {
+        return 0;
+    }
+    return gf_exp[gf_log[a] + gf_log[b]];
+}
+
+uint8_t gf256_div(uint8_t a, uint8_t b) {
+    if (a == 0 || b == 0) {
+        return 0;
+    }
+    return gf_exp[gf_log[a] + 255 - gf_log[b]];
+}
+
+uint8_t gf256_inv(uint8_t a) {
+    if (a == 0) {
+        return 0;
+    }
+    return gf_exp[255 - gf_log[a]];
+}
+
+// Low/high nibble product tables for the shuffle kernels
+static void build_nibble_tables(uint8_t c, uint8_t lo[16], uint8_t hi[16]) {
+    for (int i = 0; i < 16; i++) {
+        lo[i] = gf_mul_table[c][i];
+        hi[i] = gf_mul_table[c][i << 4];
+    }
+}
+
+// Scalar kernels
+static void mul_region_scalar(uint8_t *dst, const uint8_t *src, uint8_t c, size_t len) {
+    const uint8_t *row = gf_mul_table[c];
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = row[src[i]];
+    }
+}
+
+static void mul_add_region_scalar(uint8_t *dst, const uint8_t *src, uint8_t c, size_t len) {
+    const uint8_t *row = gf_mul_table[c];
+    for (size_t i = 0; i < len; i++) {
+        dst[i] ^= row[src[i]];
+    }
+}
+
+#ifdef GF256_X86
+__attribute__((target("ssse3")))
+static void region_ssse3(uint8_t *dst, const uint8_t *src, uint8_t c, size_t len, int accumulate) {
+    uint8_t lo[16], hi[16];
+    build_nibble_tables(c, lo, hi);
+
+    const __m128i tlo = _mm_loadu_si128((const __m128i*)lo);
+    const __m128i thi = _mm_loadu_si128((const __m128i*)hi);
+    const __m128i mask = _mm_set1_epi8(0x0f);
+
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i in = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i l = _mm_shuffle_epi8(tlo, _mm_and_si128(in, mask));
+        __m128i h = _mm_shuffle_epi8(thi, _mm_and_si128(_mm_srli_epi64(in, 4), mask));
+        __m128i prod = _mm_xor_si128(l, h);
+        if (accumulate) {
+            prod = _mm_xor_si128(prod, _mm_loadu_si128((const __m128i*)(dst + i)));
+        }
+        _mm_storeu_si128((__m128i*)(dst + i), prod);
+    }
+
+    if (accumulate) {
+        mul_add_region_scalar(dst + i, src + i, c, len - i);
+    } else {
+        mul_region_scalar(dst + i, src + i, c, len - i);
+    }
+}
+
+__attribute__((target("avx2")))
+static void region_avx2(uint8_t *dst, const uint8_t *src, uint8_t c, size_t len, int accumulate) {
+    uint8_t lo[16], hi[16];
+    build_nibble_tables(c, lo, hi);
+
+    const __m256i tlo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)lo));
+    const __m256i thi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)hi));
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i in = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i l = _mm256_shuffle_epi8(tlo, _mm256_and_si256(in, mask));
+        __m256i h = _mm256_shuffle_epi8(thi, _mm256_and_si256(_mm256_srli_epi64(in, 4), mask));
+        __m256i prod = _mm256_xor_si256(l, h);
+        if (accumulate) {
+            prod = _mm256_xor_si256(prod, _mm256_loadu_si256((const __m256i*)(dst + i)));
+        }
+        _mm256_storeu_si256((__m256i*)(dst + i), prod);
+    }
+
+    if (accumulate) {
+        mul_add_region_scalar(dst + i, src + i, c, len - i);
+    } else {
+        mul_region_scalar(dst + i, src + i, c, len - i);
+    }
+}
+
+static void mul_region_ssse3(uint8_t *dst, const uint8_t *src, uint8_t c, size_t len) {
+    region_ssse3(dst, src, c, len, 0);
+}
+
+static void mul_add_region_ssse3(uint8_t *dst, const uint8_t *src, uint8_t c, size_t len) {
+    region_ssse3(dst, src, c, len, 1);
+}
+
+static void mul_region_avx2(uint8_t *dst, const uint8_t *src, uint8_t c, size_t len) {
+    region_avx2(dst, src, c, len, 0);
+}
+
+static void mul_add_region_avx2(uint8_t *dst, const uint8_t *src, uint8_t c, size_t len) {
+    region_avx2(dst, src, c, len, 1);
+}
+#endif // GF256_X86
+
+#ifdef GF256_NEON
+static void region_neon(uint8_t *dst, const uint8_t *src, uint8_t c, size_t len, int accumulate) {
+    uint8_t lo[16], hi[16];
+    build_nibble_tables(c, lo, hi);
+
+    const uint8x16_t tlo = vld1q_u8(lo);
+    const uint8x16_t thi = vld1q_u8(hi);
+    const uint8x16_t mask = vdupq_n_u8(0x0f);
+
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t in = vld1q_u8(src + i);
+        uint8x16_t l = vqtbl1q_u8(tlo, vandq_u8(in, mask));
+        uint8x16_t h = vqtbl1q_u8(thi, vshrq_n_u8(in, 4));
+        uint8x16_t prod = veorq_u8(l, h);
+        if (accumulate) {
+            prod = veorq_u8(prod, vld1q_u8(dst + i));
+        }
+        vst1q_u8(dst + i, prod);
+    }
+
+    if (accumulate) {
+        mul_add_region_scalar(dst + i, src + i, c, len - i);
+    } else {
+        mul_region_scalar(dst + i, src + i, c, len - i);
+    }
+}
+
+static void mul_region_neon(uint8_t *dst, const uint8_t *src, uint8_t c, size_t len) {
+    region_neon(dst, src, c, len, 0);
+}
+
+static void mul_add_region_neon(uint8_t *dst, const uint8_t *src, uint8_t c, size_t len) {
+    region_neon(dst, src, c, len, 1);
+}
+#endif // GF256_NEON
+
+void gf256_init(void) {
+    if (gf_initialized) {
+        return;
+    }
+
+    // Exponent/log tables over generator 2
+    unsigned int x = 1;
+    for (int i = 0; i < 255; i++) {
+        gf_exp[i] = (uint8_t)x;
+        gf_log[x] = (uint8_t)i;
+        x <<= 1;
+        if (x & 0x100) {
+            x ^= GF256_POLY;
+        }
+    }
+    for (int i = 255; i < 512; i++) {
+        gf_exp[i] = gf_exp[i - 255];
+    }
+
+    for (int a = 0; a < 256; a++) {
+        for (int b = 0; b < 256; b++) {
+            gf_mul_table[a][b] = gf256_mul((uint8_t)a, (uint8_t)b);
+        }
+    }
+
+    mul_region_impl = mul_region_scalar;
+    mul_add_region_impl = mul_add_region_scalar;
+    kernel_name = "scalar";
+
+#ifdef GF256_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        mul_region_impl = mul_region_avx2;
+        mul_add_region_impl = mul_add_region_avx2;
+        kernel_name = "avx2";
+    } else if (__builtin_cpu_supports("ssse3")) {
+        mul_region_impl = mul_region_ssse3;
+        mul_add_region_impl = mul_add_region_ssse3;
+        kernel_name = "ssse3";
+    }
+#elif defined(GF256_NEON)
+    mul_region_impl = mul_region_neon;
+    mul_add_region_impl = mul_add_region_neon;
+    kernel_name = "neon";
+#endif
+
+    gf_initialized = 1;
+}
+
+void gf256_mul_region(uint8_t *dst, const uint8_t *src, uint8_t c, size_t len) {
+    if (c == 0) {
+        memset(dst, 0, len);
+    } else if (c == 1) {
+        memmove(dst, src, len);
+    } else {
+        mul_region_impl(dst, src, c, len);
+    }
+}
+
+void gf256_mul_add_region(uint8_t *dst, const uint8_t *src, uint8_t c, size_t len) {
+    if (c == 0) {
+        return;
+    }
+    mul_add_region_impl(dst, src, c, len);
+}
+
+const char *gf256_kernel_name(void) {
+    return kernel_name;
+}
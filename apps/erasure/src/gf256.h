@@ -0,0 +1,24 @@
+#ifndef GF256_H
+#define GF256_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// GF(2^8) with the 0x11d reduction polynomial
+#define GF256_POLY 0x11d
+
+// Table initialisation, must run once before any other call
+void gf256_init(void);
+
+uint8_t gf256_mul(uint8_t a, uint8_t b);
+uint8_t gf256_div(uint8_t a, uint8_t b);
+uint8_t gf256_inv(uint8_t a);
+
+// Region kernels: dst = c * src and dst ^= c * src
+void gf256_mul_region(uint8_t *dst, const uint8_t *src, uint8_t c, size_t len);
+void gf256_mul_add_region(uint8_t *dst, const uint8_t *src, uint8_t c, size_t len);
+
+// Name of the kernel selected at init ("avx2", "ssse3", "neon" or "scalar")
+const char *gf256_kernel_name(void);
+
+#endif // GF256_H
@@ -0,0 +1,207 @@
+#include <stdlib.h>
+#include <string.h>
+#include "gf256.h"
+#include "reed_solomon.h"
+
+int rs_codec_init(rs_codec_t *rs, int data_shards, int parity_shards) {
+    if (data_shards <= 0 || parity_shards < 0 ||
+        data_shards + parity_shards > RS_MAX_SHARDS) {
+        return -1;
+    }
+
+    gf256_init();
+
+    rs->data_shards = data_shards;
+    rs->parity_shards = parity_shards;
+    rs->parity_matrix = malloc((size_t)(parity_shards ? parity_shards : 1) * data_shards);
+    if (rs->parity_matrix == NULL) {
+        return -1;
+    }
+
+    // Cauchy matrix 1 / (x_i + y_j) with x_i = k + i and y_j = j. Every
+    // square submatrix of [I; C] is invertible.
+    for (int i = 0; i < parity_shards; i++) {
+        for (int j = 0; j < data_shards; j++) {
+            uint8_t x = (uint8_t)(data_shards + i);
+            uint8_t y = (uint8_t)j;
+            rs->parity_matrix[i * data_shards + j] = gf256_inv(x ^ y);
+        }
+    }
+
+    return 0;
+}
+
+void rs_codec_free(rs_codec_t *rs) {
+    free(rs->parity_matrix);
+    rs->parity_matrix = NULL;
+}
+
+// out[r] = sum_j matrix[r][j] * in[j] for each output row, block by block
+static void matrix_apply(const uint8_t *matrix, int rows, int cols,
+                         uint8_t **in, uint8_t **out, size_t shard_size) {
+    for (size_t offset = 0; offset < shard_size; offset += RS_BLOCK_SIZE) {
+        size_t len = shard_size - offset;
+        if (len > RS_BLOCK_SIZE) {
+            len = RS_BLOCK_SIZE;
+        }
+
+        for (int r = 0; r < rows; r++) {
+            const uint8_t *coeffs = matrix + (size_t)r * cols;
+            gf256_mul_region(out[r] + offset, in[0] + offset, coeffs[0], len);
+            for (int j = 1; j < cols; j++) {
+                gf256_mul_add_region(out[r] + offset, in[j] + offset, coeffs[j], len);
+            }
+        }
+    }
+}
+
+void rs_encode(const rs_codec_t *rs, uint8_t **shards, size_t shard_size) {
+    if (rs->parity_shards == 0 || shard_size == 0) {
+        return;
+    }
+    matrix_apply(rs->parity_matrix, rs->parity_shards, rs->data_shards,
+                 shards, shards + rs->data_shards, shard_size);
+}
+
+// Gauss-Jordan inversion of an n x n matrix in place. Returns -1 if singular.
+static int invert_matrix(uint8_t *m, uint8_t *inv, int n) {
+    memset(inv, 0, (size_t)n * n);
+    for (int i = 0; i < n; i++) {
+        inv[i * n + i] = 1;
+    }
+
+    for (int col = 0; col < n; col++) {
+        int pivot = col;
+        while (pivot < n && m[pivot * n + col] == 0) {
+            pivot++;
+        }
+        if (pivot == n) {
+            return -1;
+        }
+
+        if (pivot != col) {
+            for (int j = 0; j < n; j++) {
+                uint8_t t = m[col * n + j];
+                m[col * n + j] = m[pivot * n + j];
+                m[pivot * n + j] = t;
+                t = inv[col * n + j];
+                inv[col * n + j] = inv[pivot * n + j];
+                inv[pivot * n + j] = t;
+            }
+        }
+
+        uint8_t scale = gf256_inv(m[col * n + col]);
+        for (int j = 0; j < n; j++) {
+            m[col * n + j] = gf256_mul(m[col * n + j], scale);
+            inv[col * n + j] = gf256_mul(inv[col * n + j], scale);
+        }
+
+        for (int r = 0; r < n; r++) {
+            uint8_t factor = m[r * n + col];
+            if (r == col || factor == 0) {
+                continue;
+            }
+            for (int j = 0; j < n; j++) {
+                m[r * n + j] ^= gf256_mul(factor, m[col * n + j]);
+                inv[r * n + j] ^= gf256_mul(factor, inv[col * n + j]);
+            }
+        }
+    }
+
+    return 0;
+}
+
+int rs_reconstruct(const rs_codec_t *rs, uint8_t **shards, const int *present,
+                   size_t shard_size, int data_only) {
+    const int k = rs->data_shards;
+    const int total = rs->data_shards + rs->parity_shards;
+    int rows[RS_MAX_SHARDS];
+    int found = 0;
+    int missing_data = 0;
+    int missing_parity = 0;
+
+    for (int i = 0; i < total; i++) {
+        if (present[i]) {
+            if (found < k) {
+                rows[found++] = i;
+            }
+        } else if (i < k) {
+            missing_data++;
+        } else {
+            missing_parity++;
+        }
+    }
+
+    if (found < k) {
+        return -1;
+    }
+
+    if (missing_data > 0) {
+        uint8_t *sub = malloc((size_t)k * k);
+        uint8_t *decode = malloc((size_t)k * k);
+        uint8_t *rebuild = malloc((size_t)missing_data * k);
+        uint8_t **in = malloc(sizeof(uint8_t*) * k);
+        uint8_t **out = malloc(sizeof(uint8_t*) * missing_data);
+        int result = -1;
+
+        if (sub && decode && rebuild && in && out) {
+            // Rows of [I; C] for the shards we hold
+            for (int t = 0; t < k; t++) {
+                int r = rows[t];
+                if (r < k) {
+                    memset(sub + t * k, 0, k);
+                    sub[t * k + r] = 1;
+                } else {
+                    memcpy(sub + t * k, rs->parity_matrix + (size_t)(r - k) * k, k);
+                }
+                in[t] = shards[r];
+            }
+
+            if (invert_matrix(sub, decode, k) == 0) {
+                int n = 0;
+                for (int j = 0; j < k; j++) {
+                    if (!present[j]) {
+                        memcpy(rebuild + (size_t)n * k, decode + (size_t)j * k, k);
+                        out[n++] = shards[j];
+                    }
+                }
+                matrix_apply(rebuild, missing_data, k, in, out, shard_size);
+                result = 0;
+            }
+        }
+
+        free(sub);
+        free(decode);
+        free(rebuild);
+        free(in);
+        free(out);
+
+        if (result != 0) {
+            return result;
+        }
+    }
+
+    if (missing_parity > 0 && !data_only) {
+        uint8_t *rebuild = malloc((size_t)missing_parity * k);
+        uint8_t **out = malloc(sizeof(uint8_t*) * missing_parity);
+        if (!rebuild || !out) {
+            free(rebuild);
+            free(out);
+            return -1;
+        }
+
+        int n = 0;
+        for (int i = k; i < total; i++) {
+            if (!present[i]) {
+                memcpy(rebuild + (size_t)n * k, rs->parity_matrix + (size_t)(i - k) * k, k);
+                out[n++] = shards[i];
+            }
+        }
+        matrix_apply(rebuild, missing_parity, k, shards, out, shard_size);
+
+        free(rebuild);
+        free(out);
+    }
+
+    return 0;
+}
@@ -0,0 +1,32 @@
+#ifndef REED_SOLOMON_H
+#define REED_SOLOMON_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Constants
+#define RS_MAX_SHARDS 256
+#define RS_BLOCK_SIZE (64 * 1024)  // Cache block for the encode/decode loops
+
+// Systematic Reed-Solomon codec over GF(2^8) using a Cauchy parity matrix,
+// so that any k of the k+m shards are enough to rebuild the rest
+typedef struct {
+    int data_shards;
+    int parity_shards;
+    uint8_t *parity_matrix;  // parity_shards x data_shards, row-major
+} rs_codec_t;
+
+int rs_codec_init(rs_codec_t *rs, int data_shards, int parity_shards);
+void rs_codec_free(rs_codec_t *rs);
+
+// shards[0..k-1] hold the data, shards[k..k+m-1] receive the parity
+void rs_encode(const rs_codec_t *rs, uint8_t **shards, size_t shard_size);
+
+// Rebuild every shard with present[i] == 0 in place. Missing shards must
+// point at writable buffers of shard_size bytes; with data_only set, missing
+// parity shards are left untouched. Returns -1 when fewer than data_shards
+// shards are present.
+int rs_reconstruct(const rs_codec_t *rs, uint8_t **shards, const int *present,
+                   size_t shard_size, int data_only);
+
+#endif // REED_SOLOMON_H
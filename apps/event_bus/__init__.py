@@ -0,0 +1,13 @@
+# Event Bus Module
+# Native telemetry event bus, aggregation windows and correlation index
+
+"""
+File: /app/apps/event_bus/__init__.py
+x-lucid-file-path: /app/apps/event_bus/__init__.py
+x-lucid-file-type: python
+
+Event Bus package for Lucid RDP.
+Contains the native event bus used by the core telemetry event processor.
+"""
+
+__all__ = []
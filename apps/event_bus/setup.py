@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+"""
+File: /app/apps/event_bus/setup.py
+x-lucid-file-path: /app/apps/event_bus/setup.py
+x-lucid-file-type: python
+
+Setup script for native RDP codec extension
+"""
+
+from setuptools import setup, Extension
+
+# Define the extension module
+event_bus_native = Extension(
+    'event_bus_native',
+    sources=[
+        'src/event_bus.c',
+        'src/event_ring.c',
+        'src/event_window.c',
+        'src/event_index.c'
+    ],
+    include_dirs=[
+        'src/'
+    ],
+    libraries=[],
+    library_dirs=[],
+    extra_compile_args=[
+        '-O3',
+        '-Wall',
+        '-Wextra',
+        '-std=c99',
+        '-fPIC'
+    ],
+    extra_link_args=['-shared']
+)
+
+setup(
+    name='event-bus-native',
+    version='0.1.0',
+    description='Native event bus extension for Lucid RDP',
+    ext_modules=[event_bus_native],
+    python_requires='>=3.8',
+    classifiers=[
+        'Development Status :: 3 - Alpha',
+        'Intended Audience :: Developers',
+        'License :: OSI Approved :: MIT License',
+        'Programming Language :: C',
+        'Programming Language :: Python :: 3',
+        'Programming Language :: Python :: 3.8',
+        'Programming Language :: Python :: 3.9',
+        'Programming Language :: Python :: 3.10',
+        'Programming Language :: Python :: 3.11',
+    ],
+)
@@ -0,0 +1,13 @@
+# Event Bus Source Module
+# Event bus native source code components
+
+"""
+File: /app/apps/event_bus/src/__init__.py
+x-lucid-file-path: /app/apps/event_bus/src/__init__.py
+x-lucid-file-type: python
+
+Event Bus Source package for Lucid RDP.
+Contains event ring, window and correlation native source code and C implementations.
+"""
+
+__all__ = []
@@ -0,0 +1,739 @@
+/*
+ * Native event bus extension for Lucid RDP
+ * Lock-free multi-producer ring of fixed-layout telemetry records, a
+ * time-bucketed sliding window for aggregation and a correlation index
+ * keyed by trace, session, user and request id with O(1) expiry
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <stdint.h>
+#include <string.h>
+#include "event_bus.h"
+#include "event_ring.h"
+#include "event_window.h"
+#include "event_index.h"
+
+// EventBus object structure
+typedef struct {
+    PyObject_HEAD
+    event_ring_t ring;
+} EventBusObject;
+
+// EventWindow object structure
+typedef struct {
+    PyObject_HEAD
+    event_window_t window;
+} EventWindowObject;
+
+// Correlator object structure
+typedef struct {
+    PyObject_HEAD
+    event_index_t index;
+} CorrelatorObject;
+
+static PyTypeObject EventBusType;
+static PyTypeObject EventWindowType;
+static PyTypeObject CorrelatorType;
+
+// Forward declarations
+static PyObject* EventBus_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
+static void EventBus_dealloc(EventBusObject *self);
+static PyObject* EventBus_emit(EventBusObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject* EventBus_drain(EventBusObject *self, PyObject *args);
+static PyObject* EventBus_get_capacity(EventBusObject *self, void *closure);
+static PyObject* EventBus_get_stats(EventBusObject *self, void *closure);
+static Py_ssize_t EventBus_length(EventBusObject *self);
+
+static PyObject* EventWindow_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
+static void EventWindow_dealloc(EventWindowObject *self);
+static PyObject* EventWindow_add(EventWindowObject *self, PyObject *args);
+static PyObject* EventWindow_add_records(EventWindowObject *self, PyObject *args);
+static PyObject* EventWindow_stats(EventWindowObject *self, PyObject *args);
+static PyObject* EventWindow_get_span(EventWindowObject *self, void *closure);
+
+static PyObject* Correlator_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
+static void Correlator_dealloc(CorrelatorObject *self);
+static PyObject* Correlator_add(CorrelatorObject *self, PyObject *args, PyObject *kwds);
+static PyObject* Correlator_add_records(CorrelatorObject *self, PyObject *args);
+static PyObject* Correlator_lookup(CorrelatorObject *self, PyObject *args);
+static PyObject* Correlator_record(CorrelatorObject *self, PyObject *args);
+static PyObject* Correlator_expire(CorrelatorObject *self, PyObject *args);
+static PyObject* Correlator_get_stats(CorrelatorObject *self, void *closure);
+static Py_ssize_t Correlator_length(CorrelatorObject *self);
+static int Correlator_contains(CorrelatorObject *self, PyObject *seq);
+
+// Method definitions
+static PyMethodDef EventBus_methods[] = {
+    {"emit", (PyCFunction)(void(*)(void))EventBus_emit, METH_FASTCALL,
+     "emit(level, category, code=0, value=0.0, session=None, trace=None, payload=None): "
+     "queue a record; False if the ring was full and it was dropped"},
+    {"drain", (PyCFunction)EventBus_drain, METH_VARARGS,
+     "Packed records in emit order, up to max_events of them"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef EventBus_getset[] = {
+    {"capacity", (getter)EventBus_get_capacity, NULL, "Ring capacity in records", NULL},
+    {"stats", (getter)EventBus_get_stats, NULL, "Emitted, dropped and drained record counts", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PySequenceMethods EventBus_as_sequence = {
+    .sq_length = (lenfunc)EventBus_length,
+};
+
+static PyMethodDef EventWindow_methods[] = {
+    {"add", (PyCFunction)EventWindow_add, METH_VARARGS,
+     "add(level, category, value=0.0, timestamp_ns=None): count one event"},
+    {"add_records", (PyCFunction)EventWindow_add_records, METH_VARARGS,
+     "Count every record of a drained batch; returns the number of records"},
+    {"stats", (PyCFunction)EventWindow_stats, METH_VARARGS,
+     "Counts and value summary over the window ending at now_ns"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef EventWindow_getset[] = {
+    {"span", (getter)EventWindow_get_span, NULL, "Window length in seconds", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PyMethodDef Correlator_methods[] = {
+    {"add", (PyCFunction)(void(*)(void))Correlator_add, METH_VARARGS | METH_KEYWORDS,
+     "Index one event by its ids; returns its sequence number"},
+    {"add_records", (PyCFunction)Correlator_add_records, METH_VARARGS,
+     "Index a drained batch by session and trace; returns the number indexed"},
+    {"lookup", (PyCFunction)Correlator_lookup, METH_VARARGS,
+     "lookup(kind, key, now_ns=None): live sequence numbers with the key, oldest first"},
+    {"record", (PyCFunction)Correlator_record, METH_VARARGS,
+     "Packed record of a live sequence number, or None"},
+    {"expire", (PyCFunction)Correlator_expire, METH_VARARGS,
+     "Drop entries older than the window; returns how many"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef Correlator_getset[] = {
+    {"stats", (getter)Correlator_get_stats, NULL, "Live entries and keys, expired and evicted counts", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PySequenceMethods Correlator_as_sequence = {
+    .sq_length = (lenfunc)Correlator_length,
+    .sq_contains = (objobjproc)Correlator_contains,
+};
+
+// Type definitions
+static PyTypeObject EventBusType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "event_bus_native.EventBus",
+    .tp_doc = "Bounded lock-free multi-producer ring of telemetry records",
+    .tp_basicsize = sizeof(EventBusObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = EventBus_new,
+    .tp_dealloc = (destructor)EventBus_dealloc,
+    .tp_methods = EventBus_methods,
+    .tp_getset = EventBus_getset,
+    .tp_as_sequence = &EventBus_as_sequence,
+};
+
+static PyTypeObject EventWindowType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "event_bus_native.EventWindow",
+    .tp_doc = "Sliding window of per-category, per-level event counts in time buckets",
+    .tp_basicsize = sizeof(EventWindowObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = EventWindow_new,
+    .tp_dealloc = (destructor)EventWindow_dealloc,
+    .tp_methods = EventWindow_methods,
+    .tp_getset = EventWindow_getset,
+};
+
+static PyTypeObject CorrelatorType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "event_bus_native.Correlator",
+    .tp_doc = "Hashed correlation index over a ring log of recent events",
+    .tp_basicsize = sizeof(CorrelatorObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = Correlator_new,
+    .tp_dealloc = (destructor)Correlator_dealloc,
+    .tp_methods = Correlator_methods,
+    .tp_getset = Correlator_getset,
+    .tp_as_sequence = &Correlator_as_sequence,
+};
+
+// None is no key, an int is taken as an already hashed key and text or
+// bytes are hashed
+static int parse_key(PyObject *obj, uint64_t *key) {
+    if (obj == NULL || obj == Py_None) {
+        *key = 0;
+        return 0;
+    }
+    if (PyUnicode_Check(obj)) {
+        Py_ssize_t len;
+        const char *data = PyUnicode_AsUTF8AndSize(obj, &len);
+        if (data == NULL) {
+            return -1;
+        }
+        *key = event_key_hash(data, (size_t)len);
+        return 0;
+    }
+    if (PyBytes_Check(obj)) {
+        *key = event_key_hash(PyBytes_AS_STRING(obj), (size_t)PyBytes_GET_SIZE(obj));
+        return 0;
+    }
+    if (PyLong_Check(obj)) {
+        *key = PyLong_AsUnsignedLongLongMask(obj);
+        return PyErr_Occurred() ? -1 : 0;
+    }
+    PyErr_Format(PyExc_TypeError, "Event key must be str, bytes, int or None, not %.100s",
+                 Py_TYPE(obj)->tp_name);
+    return -1;
+}
+
+static int parse_u8(PyObject *obj, uint8_t *out, const char *what) {
+    long v = PyLong_AsLong(obj);
+    if (v == -1 && PyErr_Occurred()) {
+        return -1;
+    }
+    if (v < 0 || v > 255) {
+        PyErr_Format(PyExc_ValueError, "%s must be in 0..255", what);
+        return -1;
+    }
+    *out = (uint8_t)v;
+    return 0;
+}
+
+static int parse_timestamp(PyObject *obj, uint64_t *out) {
+    if (obj == NULL || obj == Py_None) {
+        *out = event_now_ns();
+        return 0;
+    }
+    *out = PyLong_AsUnsignedLongLong(obj);
+    return PyErr_Occurred() ? -1 : 0;
+}
+
+// Drained batches must hold whole records
+static int get_records(PyObject *obj, Py_buffer *view, size_t *n) {
+    if (PyObject_GetBuffer(obj, view, PyBUF_SIMPLE) < 0) {
+        return -1;
+    }
+    if (view->len % EVENT_RECORD_SIZE != 0) {
+        PyErr_Format(PyExc_ValueError, "Record batch length must be a multiple of %d", EVENT_RECORD_SIZE);
+        PyBuffer_Release(view);
+        return -1;
+    }
+    *n = (size_t)view->len / EVENT_RECORD_SIZE;
+    return 0;
+}
+
+// EventBus
+
+static PyObject* EventBus_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"capacity", NULL};
+    Py_ssize_t capacity = EVENT_BUS_DEFAULT_CAPACITY;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|n", kwlist, &capacity)) {
+        return NULL;
+    }
+    if (capacity <= 0 || (size_t)capacity > EVENT_RING_MAX_CAPACITY) {
+        PyErr_Format(PyExc_ValueError, "capacity must be in 1..%u", EVENT_RING_MAX_CAPACITY);
+        return NULL;
+    }
+
+    EventBusObject *self = (EventBusObject*)type->tp_alloc(type, 0);
+    if (self == NULL) {
+        return NULL;
+    }
+    if (event_ring_init(&self->ring, (size_t)capacity) != EVENT_RING_OK) {
+        Py_DECREF(self);
+        return PyErr_NoMemory();
+    }
+    return (PyObject*)self;
+}
+
+static void EventBus_dealloc(EventBusObject *self) {
+    event_ring_free(&self->ring);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+// Positional-only fast call; emit sits on hot paths and keyword parsing
+// would cost more than the push itself
+static PyObject* EventBus_emit(EventBusObject *self, PyObject *const *args, Py_ssize_t nargs) {
+    event_record_t record;
+
+    if (nargs < 2 || nargs > 7) {
+        PyErr_Format(PyExc_TypeError, "emit() takes from 2 to 7 positional arguments (%zd given)", nargs);
+        return NULL;
+    }
+    memset(&record, 0, sizeof(record));
+    if (parse_u8(args[0], &record.level, "level") < 0 ||
+        parse_u8(args[1], &record.category, "category") < 0) {
+        return NULL;
+    }
+    if (nargs > 2 && args[2] != Py_None) {
+        record.code = (uint32_t)PyLong_AsUnsignedLongMask(args[2]);
+        if (PyErr_Occurred()) {
+            return NULL;
+        }
+    }
+    if (nargs > 3 && args[3] != Py_None) {
+        record.value = PyFloat_AsDouble(args[3]);
+        if (record.value == -1.0 && PyErr_Occurred()) {
+            return NULL;
+        }
+    }
+    if ((nargs > 4 && parse_key(args[4], &record.session) < 0) ||
+        (nargs > 5 && parse_key(args[5], &record.trace) < 0)) {
+        return NULL;
+    }
+    if (nargs > 6 && args[6] != Py_None) {
+        const char *data;
+        Py_ssize_t len;
+        if (PyUnicode_Check(args[6])) {
+            data = PyUnicode_AsUTF8AndSize(args[6], &len);
+            if (data == NULL) {
+                return NULL;
+            }
+        } else if (PyBytes_Check(args[6])) {
+            data = PyBytes_AS_STRING(args[6]);
+            len = PyBytes_GET_SIZE(args[6]);
+        } else {
+            PyErr_SetString(PyExc_TypeError, "payload must be str or bytes");
+            return NULL;
+        }
+        // Longer payloads are truncated to the fixed record size
+        if (len > EVENT_PAYLOAD_SIZE) {
+            len = EVENT_PAYLOAD_SIZE;
+        }
+        memcpy(record.payload, data, (size_t)len);
+        record.payload_len = (uint16_t)len;
+    }
+
+    record.timestamp_ns = event_now_ns();
+    if (event_ring_push(&self->ring, &record) != EVENT_RING_OK) {
+        Py_RETURN_FALSE;
+    }
+    Py_RETURN_TRUE;
+}
+
+static PyObject* EventBus_drain(EventBusObject *self, PyObject *args) {
+    Py_ssize_t max_events = EVENT_BUS_DEFAULT_DRAIN;
+
+    if (!PyArg_ParseTuple(args, "|n", &max_events)) {
+        return NULL;
+    }
+    if (max_events < 0) {
+        PyErr_SetString(PyExc_ValueError, "max_events must not be negative");
+        return NULL;
+    }
+    size_t pending = event_ring_pending(&self->ring);
+    if ((size_t)max_events > pending) {
+        max_events = (Py_ssize_t)pending;
+    }
+
+    PyObject *batch = PyBytes_FromStringAndSize(NULL, max_events * EVENT_RECORD_SIZE);
+    if (batch == NULL) {
+        return NULL;
+    }
+    size_t n = event_ring_pop(&self->ring, (event_record_t*)PyBytes_AS_STRING(batch), (size_t)max_events);
+    if ((Py_ssize_t)n < max_events && _PyBytes_Resize(&batch, (Py_ssize_t)n * EVENT_RECORD_SIZE) < 0) {
+        return NULL;
+    }
+    return batch;
+}
+
+static PyObject* EventBus_get_capacity(EventBusObject *self, void *closure) {
+    return PyLong_FromUnsignedLongLong(self->ring.mask + 1);
+}
+
+static PyObject* EventBus_get_stats(EventBusObject *self, void *closure) {
+    return Py_BuildValue("{s:K,s:K,s:K,s:n,s:K}",
+        "emitted", (unsigned long long)__atomic_load_n(&self->ring.emitted, __ATOMIC_RELAXED),
+        "dropped", (unsigned long long)__atomic_load_n(&self->ring.dropped, __ATOMIC_RELAXED),
+        "drained", (unsigned long long)self->ring.drained,
+        "pending", (Py_ssize_t)event_ring_pending(&self->ring),
+        "capacity", (unsigned long long)(self->ring.mask + 1));
+}
+
+static Py_ssize_t EventBus_length(EventBusObject *self) {
+    return (Py_ssize_t)event_ring_pending(&self->ring);
+}
+
+// C API entry point; touches only the ring so it is safe without the GIL
+static int event_bus_capi_emit(PyObject *bus, const event_record_t *record) {
+    event_ring_t *ring = &((EventBusObject*)bus)->ring;
+
+    if (record->timestamp_ns == 0) {
+        event_record_t stamped = *record;
+        stamped.timestamp_ns = event_now_ns();
+        return event_ring_push(ring, &stamped);
+    }
+    return event_ring_push(ring, record);
+}
+
+static event_bus_capi_t event_bus_capi = {
+    EVENT_BUS_CAPI_VERSION,
+    event_bus_capi_emit,
+};
+
+// EventWindow
+
+static PyObject* EventWindow_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"bucket_ms", "buckets", NULL};
+    unsigned long long bucket_ms = EVENT_WINDOW_DEFAULT_BUCKET_MS;
+    Py_ssize_t buckets = EVENT_WINDOW_DEFAULT_BUCKETS;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Kn", kwlist, &bucket_ms, &buckets)) {
+        return NULL;
+    }
+    if (bucket_ms == 0 || buckets <= 0 || buckets > EVENT_WINDOW_MAX_BUCKETS) {
+        PyErr_Format(PyExc_ValueError, "bucket_ms must be positive and buckets in 1..%d",
+                     EVENT_WINDOW_MAX_BUCKETS);
+        return NULL;
+    }
+
+    EventWindowObject *self = (EventWindowObject*)type->tp_alloc(type, 0);
+    if (self == NULL) {
+        return NULL;
+    }
+    if (event_window_init(&self->window, (size_t)buckets, (uint64_t)bucket_ms * 1000000ULL) < 0) {
+        Py_DECREF(self);
+        return PyErr_NoMemory();
+    }
+    return (PyObject*)self;
+}
+
+static void EventWindow_dealloc(EventWindowObject *self) {
+    event_window_free(&self->window);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static PyObject* EventWindow_add(EventWindowObject *self, PyObject *args) {
+    PyObject *level_obj, *category_obj, *ts_obj = NULL;
+    uint8_t level, category;
+    double value = 0.0;
+    uint64_t ts;
+
+    if (!PyArg_ParseTuple(args, "OO|dO", &level_obj, &category_obj, &value, &ts_obj)) {
+        return NULL;
+    }
+    if (parse_u8(level_obj, &level, "level") < 0 ||
+        parse_u8(category_obj, &category, "category") < 0 ||
+        parse_timestamp(ts_obj, &ts) < 0) {
+        return NULL;
+    }
+    event_window_add(&self->window, ts, level, category, value);
+    Py_RETURN_NONE;
+}
+
+static PyObject* EventWindow_add_records(EventWindowObject *self, PyObject *args) {
+    PyObject *obj;
+    Py_buffer view;
+    size_t n;
+
+    if (!PyArg_ParseTuple(args, "O", &obj) || get_records(obj, &view, &n) < 0) {
+        return NULL;
+    }
+    event_window_add_records(&self->window, (const event_record_t*)view.buf, n);
+    PyBuffer_Release(&view);
+    return PyLong_FromSize_t(n);
+}
+
+static PyObject* EventWindow_stats(EventWindowObject *self, PyObject *args) {
+    PyObject *ts_obj = NULL;
+    uint64_t now;
+    window_stats_t stats;
+
+    if (!PyArg_ParseTuple(args, "|O", &ts_obj) || parse_timestamp(ts_obj, &now) < 0) {
+        return NULL;
+    }
+    event_window_stats(&self->window, now, &stats);
+
+    PyObject *counts = PyDict_New();
+    if (counts == NULL) {
+        return NULL;
+    }
+    for (int c = 0; c < EVENT_CATEGORIES; c++) {
+        for (int l = 0; l < EVENT_LEVELS; l++) {
+            if (stats.counts[c][l] == 0) {
+                continue;
+            }
+            PyObject *key = Py_BuildValue("(ii)", c, l);
+            PyObject *count = PyLong_FromUnsignedLongLong(stats.counts[c][l]);
+            int rc = (key && count) ? PyDict_SetItem(counts, key, count) : -1;
+            Py_XDECREF(key);
+            Py_XDECREF(count);
+            if (rc < 0) {
+                Py_DECREF(counts);
+                return NULL;
+            }
+        }
+    }
+
+    // Seconds from the start of the oldest bucket holding events to now
+    double span = 0.0;
+    if (stats.first_epoch >= 0) {
+        span = (double)(now - (uint64_t)stats.first_epoch * self->window.bucket_ns) / 1e9;
+    }
+    return Py_BuildValue("{s:K,s:d,s:d,s:d,s:d,s:K,s:N}",
+        "events", (unsigned long long)stats.events,
+        "value_sum", stats.value_sum,
+        "value_min", stats.value_min,
+        "value_max", stats.value_max,
+        "span", span,
+        "late", (unsigned long long)self->window.late,
+        "counts", counts);
+}
+
+static PyObject* EventWindow_get_span(EventWindowObject *self, void *closure) {
+    return PyFloat_FromDouble((double)(self->window.bucket_ns * self->window.bucket_count) / 1e9);
+}
+
+// Correlator
+
+static PyObject* Correlator_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"capacity", "window", NULL};
+    Py_ssize_t capacity = EVENT_INDEX_DEFAULT_CAPACITY;
+    double window = EVENT_INDEX_DEFAULT_WINDOW;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|nd", kwlist, &capacity, &window)) {
+        return NULL;
+    }
+    if (capacity <= 0 || (size_t)capacity > EVENT_INDEX_MAX_CAPACITY || !(window > 0.0)) {
+        PyErr_Format(PyExc_ValueError, "capacity must be in 1..%u and window positive",
+                     EVENT_INDEX_MAX_CAPACITY);
+        return NULL;
+    }
+
+    CorrelatorObject *self = (CorrelatorObject*)type->tp_alloc(type, 0);
+    if (self == NULL) {
+        return NULL;
+    }
+    if (event_index_init(&self->index, (size_t)capacity, (uint64_t)(window * 1e9)) < 0) {
+        Py_DECREF(self);
+        return PyErr_NoMemory();
+    }
+    return (PyObject*)self;
+}
+
+static void Correlator_dealloc(CorrelatorObject *self) {
+    event_index_free(&self->index);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static PyObject* Correlator_add(CorrelatorObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"trace", "session", "user", "request", "level", "category",
+                             "timestamp_ns", NULL};
+    PyObject *ids[EVENT_KEY_KINDS] = {NULL, NULL, NULL, NULL};
+    PyObject *level_obj = NULL, *category_obj = NULL, *ts_obj = NULL;
+    uint64_t keys[EVENT_KEY_KINDS];
+    event_record_t record;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|OOOOOOO", kwlist,
+                                     &ids[EVENT_KEY_TRACE], &ids[EVENT_KEY_SESSION],
+                                     &ids[EVENT_KEY_USER], &ids[EVENT_KEY_REQUEST],
+                                     &level_obj, &category_obj, &ts_obj)) {
+        return NULL;
+    }
+    memset(&record, 0, sizeof(record));
+    for (int kind = 0; kind < EVENT_KEY_KINDS; kind++) {
+        if (parse_key(ids[kind], &keys[kind]) < 0) {
+            return NULL;
+        }
+    }
+    if ((level_obj && parse_u8(level_obj, &record.level, "level") < 0) ||
+        (category_obj && parse_u8(category_obj, &record.category, "category") < 0) ||
+        parse_timestamp(ts_obj, &record.timestamp_ns) < 0) {
+        return NULL;
+    }
+    record.trace = keys[EVENT_KEY_TRACE];
+    record.session = keys[EVENT_KEY_SESSION];
+
+    event_index_expire(&self->index, event_now_ns());
+    return PyLong_FromUnsignedLongLong(event_index_add(&self->index, &record, keys));
+}
+
+static PyObject* Correlator_add_records(CorrelatorObject *self, PyObject *args) {
+    PyObject *obj;
+    Py_buffer view;
+    size_t n;
+
+    if (!PyArg_ParseTuple(args, "O", &obj) || get_records(obj, &view, &n) < 0) {
+        return NULL;
+    }
+    event_index_expire(&self->index, event_now_ns());
+    size_t added = event_index_add_records(&self->index, (const event_record_t*)view.buf, n);
+    PyBuffer_Release(&view);
+    return PyLong_FromSize_t(added);
+}
+
+static PyObject* Correlator_lookup(CorrelatorObject *self, PyObject *args) {
+    int kind;
+    PyObject *key_obj, *ts_obj = NULL;
+    uint64_t key, now;
+
+    if (!PyArg_ParseTuple(args, "iO|O", &kind, &key_obj, &ts_obj)) {
+        return NULL;
+    }
+    if (kind < 0 || kind >= EVENT_KEY_KINDS) {
+        PyErr_Format(PyExc_ValueError, "kind must be in 0..%d", EVENT_KEY_KINDS - 1);
+        return NULL;
+    }
+    if (parse_key(key_obj, &key) < 0 || parse_timestamp(ts_obj, &now) < 0) {
+        return NULL;
+    }
+
+    size_t n = event_index_lookup(&self->index, kind, key, now, NULL, 0);
+    uint64_t *seqs = PyMem_Malloc((n ? n : 1) * sizeof(uint64_t));
+    if (seqs == NULL) {
+        return PyErr_NoMemory();
+    }
+    event_index_lookup(&self->index, kind, key, now, seqs, n);
+
+    // Chains run newest first; callers expect arrival order
+    PyObject *result = PyList_New((Py_ssize_t)n);
+    for (size_t i = 0; result != NULL && i < n; i++) {
+        PyObject *seq = PyLong_FromUnsignedLongLong(seqs[n - 1 - i]);
+        if (seq == NULL) {
+            Py_CLEAR(result);
+            break;
+        }
+        PyList_SET_ITEM(result, (Py_ssize_t)i, seq);
+    }
+    PyMem_Free(seqs);
+    return result;
+}
+
+static PyObject* Correlator_record(CorrelatorObject *self, PyObject *args) {
+    unsigned long long seq;
+
+    if (!PyArg_ParseTuple(args, "K", &seq)) {
+        return NULL;
+    }
+    const index_entry_t *entry = event_index_get(&self->index, seq);
+    if (entry == NULL) {
+        Py_RETURN_NONE;
+    }
+    return PyBytes_FromStringAndSize((const char*)&entry->record, EVENT_RECORD_SIZE);
+}
+
+static PyObject* Correlator_expire(CorrelatorObject *self, PyObject *args) {
+    PyObject *ts_obj = NULL;
+    uint64_t now;
+
+    if (!PyArg_ParseTuple(args, "|O", &ts_obj) || parse_timestamp(ts_obj, &now) < 0) {
+        return NULL;
+    }
+    return PyLong_FromSize_t(event_index_expire(&self->index, now));
+}
+
+static PyObject* Correlator_get_stats(CorrelatorObject *self, void *closure) {
+    return Py_BuildValue("{s:n,s:K,s:K,s:K,s:K}",
+        "entries", (Py_ssize_t)event_index_count(&self->index),
+        "keys", (unsigned long long)self->index.keys,
+        "expired", (unsigned long long)self->index.expired,
+        "evicted", (unsigned long long)self->index.evicted,
+        "capacity", (unsigned long long)(self->index.log_mask + 1));
+}
+
+static Py_ssize_t Correlator_length(CorrelatorObject *self) {
+    return (Py_ssize_t)event_index_count(&self->index);
+}
+
+static int Correlator_contains(CorrelatorObject *self, PyObject *seq) {
+    if (!PyLong_Check(seq)) {
+        return 0;
+    }
+    unsigned long long v = PyLong_AsUnsignedLongLong(seq);
+    if (v == (unsigned long long)-1 && PyErr_Occurred()) {
+        PyErr_Clear();
+        return 0;
+    }
+    return event_index_get(&self->index, v) != NULL;
+}
+
+// Module methods
+static PyObject* event_bus_version(PyObject *self, PyObject *args) {
+    return PyUnicode_FromString("0.1.0");
+}
+
+static PyObject* event_bus_key_hash(PyObject *self, PyObject *args) {
+    PyObject *obj;
+    uint64_t key;
+
+    if (!PyArg_ParseTuple(args, "O", &obj) || parse_key(obj, &key) < 0) {
+        return NULL;
+    }
+    return PyLong_FromUnsignedLongLong(key);
+}
+
+static PyObject* event_bus_now_ns(PyObject *self, PyObject *args) {
+    return PyLong_FromUnsignedLongLong(event_now_ns());
+}
+
+static PyMethodDef event_bus_module_methods[] = {
+    {"version", event_bus_version, METH_NOARGS, "Get version"},
+    {"key_hash", event_bus_key_hash, METH_VARARGS, "64-bit key hash records carry for an id"},
+    {"now_ns", event_bus_now_ns, METH_NOARGS, "Wall clock in nanoseconds, as stamped on records"},
+    {NULL, NULL, 0, NULL}
+};
+
+// Module definition
+static struct PyModuleDef event_bus_module = {
+    PyModuleDef_HEAD_INIT,
+    "event_bus_native",
+    "Native event bus extension for Lucid RDP",
+    -1,
+    event_bus_module_methods
+};
+
+static int add_type(PyObject *m, const char *name, PyTypeObject *type) {
+    Py_INCREF(type);
+    if (PyModule_AddObject(m, name, (PyObject*)type) < 0) {
+        Py_DECREF(type);
+        return -1;
+    }
+    return 0;
+}
+
+PyMODINIT_FUNC PyInit_event_bus_native(void) {
+    if (PyType_Ready(&EventBusType) < 0 || PyType_Ready(&EventWindowType) < 0 ||
+        PyType_Ready(&CorrelatorType) < 0) {
+        return NULL;
+    }
+
+    PyObject *m = PyModule_Create(&event_bus_module);
+    if (m == NULL) {
+        return NULL;
+    }
+
+    if (add_type(m, "EventBus", &EventBusType) < 0 ||
+        add_type(m, "EventWindow", &EventWindowType) < 0 ||
+        add_type(m, "Correlator", &CorrelatorType) < 0) {
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    PyObject *capi = PyCapsule_New(&event_bus_capi, EVENT_BUS_CAPSULE_NAME, NULL);
+    if (capi == NULL || PyModule_AddObject(m, "_C_API", capi) < 0) {
+        Py_XDECREF(capi);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    PyModule_AddIntConstant(m, "RECORD_SIZE", EVENT_RECORD_SIZE);
+    PyModule_AddIntConstant(m, "PAYLOAD_SIZE", EVENT_PAYLOAD_SIZE);
+    PyModule_AddStringConstant(m, "RECORD_FORMAT", EVENT_BUS_RECORD_FORMAT);
+    PyModule_AddIntConstant(m, "LEVELS", EVENT_LEVELS);
+    PyModule_AddIntConstant(m, "CATEGORIES", EVENT_CATEGORIES);
+    PyModule_AddIntConstant(m, "KEY_TRACE", EVENT_KEY_TRACE);
+    PyModule_AddIntConstant(m, "KEY_SESSION", EVENT_KEY_SESSION);
+    PyModule_AddIntConstant(m, "KEY_USER", EVENT_KEY_USER);
+    PyModule_AddIntConstant(m, "KEY_REQUEST", EVENT_KEY_REQUEST);
+    PyModule_AddIntConstant(m, "CAPI_VERSION", EVENT_BUS_CAPI_VERSION);
+
+    return m;
+}
@@ -0,0 +1,28 @@
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include <Python.h>
+#include "event_ring.h"
+
+// Constants
+#define EVENT_BUS_DEFAULT_CAPACITY 65536
+#define EVENT_BUS_DEFAULT_DRAIN 4096
+#define EVENT_BUS_RECORD_FORMAT "<QQQdIBBH24s"
+#define EVENT_WINDOW_DEFAULT_BUCKET_MS 1000
+#define EVENT_WINDOW_DEFAULT_BUCKETS 60
+#define EVENT_INDEX_DEFAULT_CAPACITY 16384
+#define EVENT_INDEX_DEFAULT_WINDOW 300.0
+
+// C API exported as event_bus_native._C_API so native producers can emit
+// without building Python objects; emit may be called without the GIL
+// while the caller holds a reference to the bus. A zero timestamp is
+// replaced with the current time.
+#define EVENT_BUS_CAPI_VERSION 1
+#define EVENT_BUS_CAPSULE_NAME "event_bus_native._C_API"
+
+typedef struct {
+    int version;
+    int (*emit)(PyObject *bus, const event_record_t *record);
+} event_bus_capi_t;
+
+#endif // EVENT_BUS_H
@@ -0,0 +1,207 @@
+#include "event_index.h"
+#include <stdlib.h>
+#include <string.h>
+
+static uint64_t mix_key(int kind, uint64_t key) {
+    uint64_t k = key ^ ((uint64_t)(kind + 1) * 0x9E3779B97F4A7C15ULL);
+    return k ? k : 1;
+}
+
+static uint64_t home_slot(const event_index_t *index, uint64_t k) {
+    // Fibonacci hashing; callers may pass ids that are not already mixed
+    return (k * 0x9E3779B97F4A7C15ULL) >> index->table_shift;
+}
+
+static index_slot_t *find_slot(const event_index_t *index, uint64_t k) {
+    uint64_t i = home_slot(index, k);
+    for (;;) {
+        index_slot_t *slot = &index->table[i];
+        if (slot->key == k) {
+            return slot;
+        }
+        if (slot->key == 0) {
+            return NULL;
+        }
+        i = (i + 1) & index->table_mask;
+    }
+}
+
+// Backward-shift deletion keeps every probe run unbroken without tombstones
+static void delete_slot(event_index_t *index, index_slot_t *slot) {
+    uint64_t i = (uint64_t)(slot - index->table);
+    uint64_t j = i;
+
+    for (;;) {
+        j = (j + 1) & index->table_mask;
+        if (index->table[j].key == 0) {
+            break;
+        }
+        uint64_t home = home_slot(index, index->table[j].key);
+        if (((j - home) & index->table_mask) >= ((j - i) & index->table_mask)) {
+            index->table[i] = index->table[j];
+            i = j;
+        }
+    }
+    index->table[i].key = 0;
+    index->keys--;
+}
+
+int event_index_init(event_index_t *index, size_t capacity, uint64_t window_ns) {
+    size_t n = EVENT_INDEX_MIN_CAPACITY;
+    int bits = 0;
+
+    while (n < capacity && n < EVENT_INDEX_MAX_CAPACITY) {
+        n <<= 1;
+    }
+    memset(index, 0, sizeof(*index));
+
+    // Every entry may add one key of each kind; twice that keeps the
+    // table at most half full
+    size_t slots = n * EVENT_KEY_KINDS * 2;
+    while (((size_t)1 << bits) < slots) {
+        bits++;
+    }
+    index->log = malloc(n * sizeof(index_entry_t));
+    index->table = calloc(slots, sizeof(index_slot_t));
+    if (index->log == NULL || index->table == NULL) {
+        event_index_free(index);
+        return -1;
+    }
+    index->log_mask = n - 1;
+    index->table_mask = slots - 1;
+    index->table_shift = 64 - bits;
+    index->window_ns = window_ns;
+    return 0;
+}
+
+void event_index_free(event_index_t *index) {
+    free(index->log);
+    free(index->table);
+    index->log = NULL;
+    index->table = NULL;
+}
+
+static void pop_oldest(event_index_t *index) {
+    const index_entry_t *entry = &index->log[index->tail & index->log_mask];
+
+    for (int kind = 0; kind < EVENT_KEY_KINDS; kind++) {
+        if (entry->keys[kind] == 0) {
+            continue;
+        }
+        // Only the key's newest entry owns its table slot
+        index_slot_t *slot = find_slot(index, mix_key(kind, entry->keys[kind]));
+        if (slot != NULL && slot->seq == index->tail) {
+            delete_slot(index, slot);
+        }
+    }
+    index->tail++;
+}
+
+static int is_expired(const event_index_t *index, const index_entry_t *entry, uint64_t now_ns) {
+    return entry->record.timestamp_ns + index->window_ns <= now_ns;
+}
+
+size_t event_index_expire(event_index_t *index, uint64_t now_ns) {
+    size_t n = 0;
+
+    while (index->tail < index->head &&
+           is_expired(index, &index->log[index->tail & index->log_mask], now_ns)) {
+        pop_oldest(index);
+        n++;
+    }
+    index->expired += n;
+    return n;
+}
+
+uint64_t event_index_add(event_index_t *index, const event_record_t *record,
+                         const uint64_t keys[EVENT_KEY_KINDS]) {
+    if (index->head - index->tail > index->log_mask) {
+        pop_oldest(index);
+        index->evicted++;
+    }
+
+    uint64_t seq = index->head++;
+    index_entry_t *entry = &index->log[seq & index->log_mask];
+    entry->record = *record;
+
+    for (int kind = 0; kind < EVENT_KEY_KINDS; kind++) {
+        entry->keys[kind] = keys[kind];
+        entry->prev[kind] = 0;
+        if (keys[kind] == 0) {
+            continue;
+        }
+        uint64_t k = mix_key(kind, keys[kind]);
+        uint64_t i = home_slot(index, k);
+        for (;;) {
+            index_slot_t *slot = &index->table[i];
+            if (slot->key == k) {
+                entry->prev[kind] = slot->seq + 1;
+                slot->seq = seq;
+                break;
+            }
+            if (slot->key == 0) {
+                slot->key = k;
+                slot->seq = seq;
+                index->keys++;
+                break;
+            }
+            i = (i + 1) & index->table_mask;
+        }
+    }
+    return seq;
+}
+
+size_t event_index_add_records(event_index_t *index, const event_record_t *records, size_t n) {
+    size_t added = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        uint64_t keys[EVENT_KEY_KINDS] = {0};
+        keys[EVENT_KEY_TRACE] = records[i].trace;
+        keys[EVENT_KEY_SESSION] = records[i].session;
+        if (records[i].trace == 0 && records[i].session == 0) {
+            continue;
+        }
+        event_index_add(index, &records[i], keys);
+        added++;
+    }
+    return added;
+}
+
+size_t event_index_lookup(const event_index_t *index, int kind, uint64_t key,
+                          uint64_t now_ns, uint64_t *seqs, size_t max) {
+    size_t n = 0;
+
+    if (kind < 0 || kind >= EVENT_KEY_KINDS || key == 0) {
+        return 0;
+    }
+    const index_slot_t *slot = find_slot(index, mix_key(kind, key));
+    if (slot == NULL) {
+        return 0;
+    }
+    // Chains run newest to oldest and end at the first entry that has left
+    // the log; entries past the window are skipped until expire drops them
+    uint64_t link = slot->seq + 1;
+    while (link != 0 && link - 1 >= index->tail) {
+        uint64_t seq = link - 1;
+        const index_entry_t *entry = &index->log[seq & index->log_mask];
+        if (!is_expired(index, entry, now_ns)) {
+            if (n < max) {
+                seqs[n] = seq;
+            }
+            n++;
+        }
+        link = entry->prev[kind];
+    }
+    return n;
+}
+
+const index_entry_t *event_index_get(const event_index_t *index, uint64_t seq) {
+    if (seq < index->tail || seq >= index->head) {
+        return NULL;
+    }
+    return &index->log[seq & index->log_mask];
+}
+
+size_t event_index_count(const event_index_t *index) {
+    return (size_t)(index->head - index->tail);
+}
@@ -0,0 +1,76 @@
+#ifndef EVENT_INDEX_H
+#define EVENT_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "event_ring.h"
+
+// Constants
+#define EVENT_KEY_KINDS 4
+#define EVENT_INDEX_MIN_CAPACITY 64
+#define EVENT_INDEX_MAX_CAPACITY (1u << 22)
+
+// Key kinds
+#define EVENT_KEY_TRACE 0    // Trace or correlation id
+#define EVENT_KEY_SESSION 1
+#define EVENT_KEY_USER 2
+#define EVENT_KEY_REQUEST 3
+
+// One correlated event. prev[k] links to the previous live entry with the
+// same key of kind k, so every key owns a chain through the log.
+typedef struct {
+    event_record_t record;
+    uint64_t keys[EVENT_KEY_KINDS];  // Key hashes, 0 if none
+    uint64_t prev[EVENT_KEY_KINDS];  // seq + 1 of the previous entry, 0 if none
+} index_entry_t;
+
+typedef struct {
+    uint64_t key;  // Key hash mixed with its kind, 0 if the slot is empty
+    uint64_t seq;  // Newest entry with this key
+} index_slot_t;
+
+// Correlation log and index. Entries get consecutive sequence numbers and
+// live in a ring log; a linear-probing table maps each key to its newest
+// entry. Entries leave from the old end of the log once they fall out of
+// the window or the log is full, and a key leaves the table together with
+// its newest entry, so expiry is O(1) per event and never scans.
+typedef struct {
+    index_entry_t *log;
+    uint64_t log_mask;
+    index_slot_t *table;
+    uint64_t table_mask;
+    int table_shift;
+    uint64_t head;       // Next sequence number
+    uint64_t tail;       // Oldest live sequence number
+    uint64_t window_ns;
+    uint64_t keys;       // Live keys in the table
+    uint64_t expired;    // Entries that aged out of the window
+    uint64_t evicted;    // Entries pushed out by a full log
+} event_index_t;
+
+// Capacity is rounded up to a power of two
+int event_index_init(event_index_t *index, size_t capacity, uint64_t window_ns);
+void event_index_free(event_index_t *index);
+
+// Drops entries older than now - window; returns how many
+size_t event_index_expire(event_index_t *index, uint64_t now_ns);
+
+// Appends an entry and returns its sequence number
+uint64_t event_index_add(event_index_t *index, const event_record_t *record,
+                         const uint64_t keys[EVENT_KEY_KINDS]);
+
+// Indexes a drained batch by its session and trace keys; records without
+// either are skipped. Returns the number indexed.
+size_t event_index_add_records(event_index_t *index, const event_record_t *records, size_t n);
+
+// Live entries with the key, newest first; returns the total found, of
+// which at most max are written to seqs
+size_t event_index_lookup(const event_index_t *index, int kind, uint64_t key,
+                          uint64_t now_ns, uint64_t *seqs, size_t max);
+
+// Entry for a live sequence number, NULL once it has left the log
+const index_entry_t *event_index_get(const event_index_t *index, uint64_t seq);
+
+size_t event_index_count(const event_index_t *index);
+
+#endif // EVENT_INDEX_H
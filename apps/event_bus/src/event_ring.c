@@ -0,0 +1,104 @@
+#define _POSIX_C_SOURCE 200809L
+#include "event_ring.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Drained batches are read as packed records, so the layout may not pad
+typedef char event_record_size_check[sizeof(event_record_t) == EVENT_RECORD_SIZE ? 1 : -1];
+
+int event_ring_init(event_ring_t *ring, size_t capacity) {
+    size_t n = EVENT_RING_MIN_CAPACITY;
+
+    while (n < capacity && n < EVENT_RING_MAX_CAPACITY) {
+        n <<= 1;
+    }
+    memset(ring, 0, sizeof(*ring));
+    ring->slots = malloc(n * sizeof(event_slot_t));
+    if (ring->slots == NULL) {
+        return EVENT_RING_ENOMEM;
+    }
+    for (size_t i = 0; i < n; i++) {
+        ring->slots[i].seq = i;
+    }
+    ring->mask = n - 1;
+    return EVENT_RING_OK;
+}
+
+void event_ring_free(event_ring_t *ring) {
+    free(ring->slots);
+    ring->slots = NULL;
+}
+
+int event_ring_push(event_ring_t *ring, const event_record_t *record) {
+    uint64_t pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+
+    for (;;) {
+        event_slot_t *slot = &ring->slots[pos & ring->mask];
+        uint64_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        int64_t dif = (int64_t)(seq - pos);
+        if (dif == 0) {
+            if (__atomic_compare_exchange_n(&ring->tail, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                slot->record = *record;
+                __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+                __atomic_fetch_add(&ring->emitted, 1, __ATOMIC_RELAXED);
+                return EVENT_RING_OK;
+            }
+            // pos now holds the tail another producer moved to
+        } else if (dif < 0) {
+            // The consumer has not released this slot yet
+            __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+            return EVENT_RING_FULL;
+        } else {
+            pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+size_t event_ring_pop(event_ring_t *ring, event_record_t *out, size_t max) {
+    uint64_t pos = ring->head;
+    size_t n = 0;
+
+    while (n < max) {
+        event_slot_t *slot = &ring->slots[pos & ring->mask];
+        // A claimed but unpublished slot ends the batch; its producer is
+        // mid-copy and the record is picked up by the next drain
+        if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != pos + 1) {
+            break;
+        }
+        out[n++] = slot->record;
+        __atomic_store_n(&slot->seq, pos + ring->mask + 1, __ATOMIC_RELEASE);
+        pos++;
+    }
+    __atomic_store_n(&ring->head, pos, __ATOMIC_RELAXED);
+    ring->drained += n;
+    return n;
+}
+
+size_t event_ring_pending(const event_ring_t *ring) {
+    uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    return tail > head ? (size_t)(tail - head) : 0;
+}
+
+uint64_t event_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t event_key_hash(const char *data, size_t len) {
+    // FNV-1a with a murmur finalizer so nearby ids spread over the index
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (uint8_t)data[i];
+        h *= 0x100000001b3ULL;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h ? h : 1;
+}
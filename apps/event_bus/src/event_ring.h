@@ -0,0 +1,70 @@
+#ifndef EVENT_RING_H
+#define EVENT_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Constants
+#define EVENT_PAYLOAD_SIZE 24
+#define EVENT_RECORD_SIZE 64
+#define EVENT_RING_MIN_CAPACITY 16
+#define EVENT_RING_MAX_CAPACITY (1u << 24)
+
+// Fixed event record, little-endian on every supported target and packed
+// by field order so a drained batch can be read with struct format
+// "<QQQdIBBH24s" without decoding anything per field.
+typedef struct {
+    uint64_t timestamp_ns;  // CLOCK_REALTIME at emit
+    uint64_t session;       // Key hash of the session id, 0 if none
+    uint64_t trace;         // Key hash of the trace or correlation id, 0 if none
+    double value;           // Duration, size or other measurement
+    uint32_t code;          // Caller-defined event code
+    uint8_t level;
+    uint8_t category;
+    uint16_t payload_len;
+    uint8_t payload[EVENT_PAYLOAD_SIZE];
+} event_record_t;
+
+typedef struct {
+    uint64_t seq;  // Equals the ticket that may use the slot next
+    event_record_t record;
+} event_slot_t;
+
+// Bounded multi-producer, single-consumer queue. Each slot carries a
+// sequence number: a producer claims ticket t with one CAS on tail once
+// slot t % capacity reports seq == t, writes the record and publishes it
+// with seq = t + 1. The consumer reads the slot at head when seq == head + 1
+// and hands it back with seq = head + capacity. A producer that finds the
+// ring full drops the record and counts it instead of waiting.
+typedef struct {
+    event_slot_t *slots;
+    uint64_t mask;
+    uint64_t tail __attribute__((aligned(64)));  // Next ticket for producers
+    uint64_t head __attribute__((aligned(64)));  // Next ticket for the consumer
+    uint64_t emitted __attribute__((aligned(64)));
+    uint64_t dropped;
+    uint64_t drained;
+} event_ring_t;
+
+// Return codes
+#define EVENT_RING_OK 0
+#define EVENT_RING_FULL 1
+#define EVENT_RING_ENOMEM -1
+
+// Capacity is rounded up to a power of two
+int event_ring_init(event_ring_t *ring, size_t capacity);
+void event_ring_free(event_ring_t *ring);
+
+// Safe from any number of threads, with or without the GIL
+int event_ring_push(event_ring_t *ring, const event_record_t *record);
+
+// Single consumer; copies up to max records in emit order and returns the count
+size_t event_ring_pop(event_ring_t *ring, event_record_t *out, size_t max);
+
+size_t event_ring_pending(const event_ring_t *ring);
+uint64_t event_now_ns(void);
+
+// 64-bit key hash of an id; never 0, which marks a missing key
+uint64_t event_key_hash(const char *data, size_t len);
+
+#endif // EVENT_RING_H
@@ -0,0 +1,98 @@
+#include "event_window.h"
+#include <stdlib.h>
+#include <string.h>
+
+static void bucket_reset(window_bucket_t *bucket, int64_t epoch) {
+    memset(bucket, 0, sizeof(*bucket));
+    bucket->epoch = epoch;
+}
+
+int event_window_init(event_window_t *window, size_t bucket_count, uint64_t bucket_ns) {
+    memset(window, 0, sizeof(*window));
+    window->buckets = malloc(bucket_count * sizeof(window_bucket_t));
+    if (window->buckets == NULL) {
+        return -1;
+    }
+    for (size_t i = 0; i < bucket_count; i++) {
+        bucket_reset(&window->buckets[i], -1);
+    }
+    window->bucket_count = bucket_count;
+    window->bucket_ns = bucket_ns;
+    window->latest = -1;
+    return 0;
+}
+
+void event_window_free(event_window_t *window) {
+    free(window->buckets);
+    window->buckets = NULL;
+}
+
+void event_window_add(event_window_t *window, uint64_t timestamp_ns,
+                      uint8_t level, uint8_t category, double value) {
+    int64_t epoch = (int64_t)(timestamp_ns / window->bucket_ns);
+
+    if (epoch <= window->latest - (int64_t)window->bucket_count) {
+        window->late++;
+        return;
+    }
+    if (epoch > window->latest) {
+        window->latest = epoch;
+    }
+
+    window_bucket_t *bucket = &window->buckets[(uint64_t)epoch % window->bucket_count];
+    if (bucket->epoch != epoch) {
+        bucket_reset(bucket, epoch);
+    }
+    if (level >= EVENT_LEVELS) {
+        level = EVENT_LEVELS - 1;
+    }
+    if (category >= EVENT_CATEGORIES) {
+        category = EVENT_CATEGORIES - 1;
+    }
+    bucket->counts[category][level]++;
+    if (bucket->events == 0 || value < bucket->value_min) {
+        bucket->value_min = value;
+    }
+    if (bucket->events == 0 || value > bucket->value_max) {
+        bucket->value_max = value;
+    }
+    bucket->events++;
+    bucket->value_sum += value;
+}
+
+void event_window_add_records(event_window_t *window, const event_record_t *records, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        event_window_add(window, records[i].timestamp_ns, records[i].level,
+                         records[i].category, records[i].value);
+    }
+}
+
+void event_window_stats(const event_window_t *window, uint64_t now_ns, window_stats_t *out) {
+    int64_t now = (int64_t)(now_ns / window->bucket_ns);
+    int64_t oldest = now - (int64_t)window->bucket_count;
+
+    memset(out, 0, sizeof(*out));
+    out->first_epoch = -1;
+    for (size_t i = 0; i < window->bucket_count; i++) {
+        const window_bucket_t *bucket = &window->buckets[i];
+        if (bucket->events == 0 || bucket->epoch <= oldest || bucket->epoch > now) {
+            continue;
+        }
+        for (int c = 0; c < EVENT_CATEGORIES; c++) {
+            for (int l = 0; l < EVENT_LEVELS; l++) {
+                out->counts[c][l] += bucket->counts[c][l];
+            }
+        }
+        if (out->events == 0 || bucket->value_min < out->value_min) {
+            out->value_min = bucket->value_min;
+        }
+        if (out->events == 0 || bucket->value_max > out->value_max) {
+            out->value_max = bucket->value_max;
+        }
+        if (out->first_epoch < 0 || bucket->epoch < out->first_epoch) {
+            out->first_epoch = bucket->epoch;
+        }
+        out->events += bucket->events;
+        out->value_sum += bucket->value_sum;
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef EVENT_WINDOW_H
+#define EVENT_WINDOW_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "event_ring.h"
+
+// Constants
+#define EVENT_LEVELS 8
+#define EVENT_CATEGORIES 16
+#define EVENT_WINDOW_MAX_BUCKETS 3600
+
+// One time bucket of the sliding window
+typedef struct {
+    int64_t epoch;  // timestamp_ns / bucket_ns of the events counted, -1 if unused
+    uint64_t counts[EVENT_CATEGORIES][EVENT_LEVELS];
+    uint64_t events;
+    double value_sum;
+    double value_min;
+    double value_max;
+} window_bucket_t;
+
+// Ring of buckets covering the last bucket_count * bucket_ns. An event
+// lands in bucket epoch % bucket_count, clearing it first if it still
+// holds an older epoch, so adding is O(1) and old buckets expire by being
+// reused. Stats fold the buckets whose epoch lies inside the window.
+typedef struct {
+    window_bucket_t *buckets;
+    size_t bucket_count;
+    uint64_t bucket_ns;
+    int64_t latest;  // Newest epoch seen
+    uint64_t late;   // Events older than the window when added
+} event_window_t;
+
+typedef struct {
+    uint64_t counts[EVENT_CATEGORIES][EVENT_LEVELS];
+    uint64_t events;
+    double value_sum;
+    double value_min;
+    double value_max;
+    int64_t first_epoch;  // Oldest bucket holding events, -1 if none
+} window_stats_t;
+
+int event_window_init(event_window_t *window, size_t bucket_count, uint64_t bucket_ns);
+void event_window_free(event_window_t *window);
+
+// Levels and categories outside the table are clamped to the last row
+void event_window_add(event_window_t *window, uint64_t timestamp_ns,
+                      uint8_t level, uint8_t category, double value);
+void event_window_add_records(event_window_t *window, const event_record_t *records, size_t n);
+
+// Folds the buckets inside (now - bucket_count * bucket_ns, now]
+void event_window_stats(const event_window_t *window, uint64_t now_ns, window_stats_t *out);
+
+#endif // EVENT_WINDOW_H
@@ -0,0 +1,13 @@
+# File Transfer Module
+# Zero-copy file transfer primitives
+
+"""
+File: /app/apps/file_transfer/__init__.py
+x-lucid-file-path: /app/apps/file_transfer/__init__.py
+x-lucid-file-type: python
+
+File Transfer package for Lucid RDP.
+Contains the native kernel-side copy engine used by the RDP file transfer handler.
+"""
+
+__all__ = []
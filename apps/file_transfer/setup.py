@@ -0,0 +1,51 @@
+#!/usr/bin/env python3
+"""
+File: /app/apps/file_transfer/setup.py
+x-lucid-file-path: /app/apps/file_transfer/setup.py
+x-lucid-file-type: python
+
+Setup script for native file transfer extension
+"""
+
+from setuptools import setup, Extension
+
+# Define the extension module
+file_transfer_native = Extension(
+    'file_transfer_native',
+    sources=[
+        'src/file_transfer.c',
+        'src/zero_copy.c'
+    ],
+    include_dirs=[
+        'src/'
+    ],
+    libraries=['crypto'],
+    library_dirs=[],
+    extra_compile_args=[
+        '-O3',
+        '-Wall',
+        '-Wextra',
+        '-std=c99',
+        '-fPIC'
+    ],
+    extra_link_args=['-shared']
+)
+
+setup(
+    name='file-transfer-native',
+    version='0.1.0',
+    description='Native file transfer extension for Lucid RDP',
+    ext_modules=[file_transfer_native],
+    python_requires='>=3.8',
+    classifiers=[
+        'Development Status :: 3 - Alpha',
+        'Intended Audience :: Developers',
+        'License :: OSI Approved :: MIT License',
+        'Programming Language :: C',
+        'Programming Language :: Python :: 3',
+        'Programming Language :: Python :: 3.8',
+        'Programming Language :: Python :: 3.9',
+        'Programming Language :: Python :: 3.10',
+        'Programming Language :: Python :: 3.11',
+    ],
+)
@@ -0,0 +1,13 @@
+# File Transfer Source Module
+# File transfer native source code components
+
+"""
+File: /app/apps/file_transfer/src/__init__.py
+x-lucid-file-path: /app/apps/file_transfer/src/__init__.py
+x-lucid-file-type: python
+
+File Transfer Source package for Lucid RDP.
+Contains file transfer native source code and C implementations.
+"""
+
+__all__ = []
@@ -0,0 +1,282 @@
+/*
+ * Native file transfer extension for Lucid RDP
+ * Kernel-side file copies (copy_file_range/sendfile/splice) with optional
+ * SHA-256 of the copied bytes in the same pass and a lock-free progress
+ * counter, so large transfers are read once and never hold the GIL
+ */
+
+#define _GNU_SOURCE
+#include <Python.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "file_transfer.h"
+#include "zero_copy.h"
+
+typedef struct {
+    PyObject_HEAD
+    xfer_progress_t progress;
+} TransferProgressObject;
+
+static PyTypeObject TransferProgressType;
+
+// Forward declarations
+static PyObject* TransferProgress_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
+static void TransferProgress_dealloc(TransferProgressObject *self);
+static PyObject* TransferProgress_cancel(TransferProgressObject *self, PyObject *args);
+
+// Method definitions
+static PyMethodDef TransferProgress_methods[] = {
+    {"cancel", (PyCFunction)TransferProgress_cancel, METH_NOARGS, "Ask the running copy to stop at the next chunk"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyObject* TransferProgress_get_bytes_done(TransferProgressObject *self, void *closure) {
+    return PyLong_FromUnsignedLongLong(__atomic_load_n(&self->progress.done, __ATOMIC_RELAXED));
+}
+
+static PyObject* TransferProgress_get_total(TransferProgressObject *self, void *closure) {
+    return PyLong_FromUnsignedLongLong(__atomic_load_n(&self->progress.total, __ATOMIC_RELAXED));
+}
+
+static PyObject* TransferProgress_get_cancelled(TransferProgressObject *self, void *closure) {
+    return PyBool_FromLong(__atomic_load_n(&self->progress.cancelled, __ATOMIC_RELAXED));
+}
+
+static PyGetSetDef TransferProgress_getset[] = {
+    {"bytes_done", (getter)TransferProgress_get_bytes_done, NULL, "Bytes copied so far", NULL},
+    {"total", (getter)TransferProgress_get_total, NULL, "Bytes to copy", NULL},
+    {"cancelled", (getter)TransferProgress_get_cancelled, NULL, "Whether cancel() was called", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+// Type definition
+static PyTypeObject TransferProgressType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "file_transfer_native.TransferProgress",
+    .tp_doc = "Progress counter shared between a running copy and its observers",
+    .tp_basicsize = sizeof(TransferProgressObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = TransferProgress_new,
+    .tp_dealloc = (destructor)TransferProgress_dealloc,
+    .tp_methods = TransferProgress_methods,
+    .tp_getset = TransferProgress_getset,
+};
+
+static PyObject* TransferProgress_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
+    TransferProgressObject *self = (TransferProgressObject*)type->tp_alloc(type, 0);
+    if (self != NULL) {
+        memset(&self->progress, 0, sizeof(self->progress));
+    }
+    return (PyObject*)self;
+}
+
+static void TransferProgress_dealloc(TransferProgressObject *self) {
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static PyObject* TransferProgress_cancel(TransferProgressObject *self, PyObject *args) {
+    __atomic_store_n(&self->progress.cancelled, 1, __ATOMIC_RELAXED);
+    Py_RETURN_NONE;
+}
+
+// Runs without the GIL: open both ends, copy, and report which path was used.
+// On failure *dst_failed tells whether the error belongs to the target, or
+// is COPY_SAME_FILE when both paths name one inode.
+static int64_t copy_path(const char *src, const char *dst, uint8_t *digest,
+                         xfer_progress_t *progress, xfer_method_t *method,
+                         int *dst_failed) {
+    struct stat st;
+    int64_t copied = -1;
+    int saved_errno;
+
+    *dst_failed = 0;
+    int in_fd = open(src, O_RDONLY | O_CLOEXEC);
+    if (in_fd < 0) {
+        return -1;
+    }
+    if (fstat(in_fd, &st) != 0) {
+        saved_errno = errno;
+        close(in_fd);
+        errno = saved_errno;
+        return -1;
+    }
+    if (S_ISDIR(st.st_mode)) {
+        close(in_fd);
+        errno = EISDIR;
+        return -1;
+    }
+
+    *dst_failed = 1;
+    // Truncate only once the target is known not to be the source
+    int out_fd = open(dst, O_WRONLY | O_CREAT | O_CLOEXEC, DEFAULT_FILE_MODE);
+    if (out_fd < 0) {
+        saved_errno = errno;
+        close(in_fd);
+        errno = saved_errno;
+        return -1;
+    }
+    struct stat out_st;
+    int opened = fstat(out_fd, &out_st) == 0;
+    if (opened && out_st.st_dev == st.st_dev && out_st.st_ino == st.st_ino) {
+        *dst_failed = COPY_SAME_FILE;
+        errno = EINVAL;
+        opened = 0;
+    }
+    if (!opened || ftruncate(out_fd, 0) != 0) {
+        saved_errno = errno;
+        close(out_fd);
+        close(in_fd);
+        errno = saved_errno;
+        return -1;
+    }
+
+    copied = xfer_copy(in_fd, out_fd, (uint64_t)st.st_size, digest, progress, method);
+
+    saved_errno = errno;
+    if (close(out_fd) != 0 && copied >= 0) {
+        saved_errno = errno;
+        copied = -1;
+    }
+    close(in_fd);
+    errno = saved_errno;
+    return copied;
+}
+
+// Same error shutil.copy2 raises, so callers keep a single except clause
+static void raise_same_file(PyObject *src_obj, PyObject *dst_obj) {
+    PyObject *shutil = PyImport_ImportModule("shutil");
+    if (shutil == NULL) {
+        return;
+    }
+    PyObject *error = PyObject_GetAttrString(shutil, "SameFileError");
+    Py_DECREF(shutil);
+    if (error == NULL) {
+        return;
+    }
+    PyErr_Format(error, "'%s' and '%s' are the same file",
+                 PyBytes_AS_STRING(src_obj), PyBytes_AS_STRING(dst_obj));
+    Py_DECREF(error);
+}
+
+static PyObject* file_transfer_copy_file(PyObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"src", "dst", "hash", "progress", NULL};
+    PyObject *src_obj = NULL;
+    PyObject *dst_obj = NULL;
+    int want_hash = 1;
+    PyObject *progress_obj = Py_None;
+    xfer_progress_t local_progress;
+    xfer_progress_t *progress = &local_progress;
+    uint8_t digest[XFER_DIGEST_SIZE];
+    xfer_method_t method = XFER_COPY_FILE_RANGE;
+    int64_t copied;
+    int dst_failed = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O&O&|pO", kwlist,
+                                     PyUnicode_FSConverter, &src_obj,
+                                     PyUnicode_FSConverter, &dst_obj,
+                                     &want_hash, &progress_obj)) {
+        return NULL;
+    }
+
+    if (progress_obj != Py_None) {
+        if (!PyObject_TypeCheck(progress_obj, &TransferProgressType)) {
+            PyErr_SetString(PyExc_TypeError, "progress must be a TransferProgress");
+            Py_DECREF(src_obj);
+            Py_DECREF(dst_obj);
+            return NULL;
+        }
+        progress = &((TransferProgressObject*)progress_obj)->progress;
+    } else {
+        memset(&local_progress, 0, sizeof(local_progress));
+    }
+
+    // The argument tuple keeps the progress object alive during the copy
+    Py_BEGIN_ALLOW_THREADS
+    copied = copy_path(PyBytes_AS_STRING(src_obj), PyBytes_AS_STRING(dst_obj),
+                       want_hash ? digest : NULL, progress, &method, &dst_failed);
+    Py_END_ALLOW_THREADS
+
+    if (copied < 0 && dst_failed == COPY_SAME_FILE) {
+        raise_same_file(src_obj, dst_obj);
+        Py_DECREF(src_obj);
+        Py_DECREF(dst_obj);
+        return NULL;
+    }
+    if (copied < 0) {
+        int saved_errno = errno;
+        PyObject *failed = dst_failed ? dst_obj : src_obj;
+        PyObject *filename = PyUnicode_DecodeFSDefault(PyBytes_AS_STRING(failed));
+        errno = saved_errno;
+        PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, filename);
+        Py_XDECREF(filename);
+        Py_DECREF(src_obj);
+        Py_DECREF(dst_obj);
+        return NULL;
+    }
+    Py_DECREF(src_obj);
+    Py_DECREF(dst_obj);
+
+    PyObject *hash_obj;
+    if (want_hash) {
+        char hex[XFER_DIGEST_SIZE * 2 + 1];
+        for (int i = 0; i < XFER_DIGEST_SIZE; i++) {
+            snprintf(hex + i * 2, 3, "%02x", digest[i]);
+        }
+        hash_obj = PyUnicode_FromStringAndSize(hex, XFER_DIGEST_SIZE * 2);
+        if (hash_obj == NULL) {
+            return NULL;
+        }
+    } else {
+        hash_obj = Py_None;
+        Py_INCREF(hash_obj);
+    }
+
+    return Py_BuildValue("(LNs)", (long long)copied, hash_obj, xfer_method_name(method));
+}
+
+static PyObject* file_transfer_version(PyObject *self, PyObject *args) {
+    return PyUnicode_FromString("0.1.0");
+}
+
+static PyMethodDef file_transfer_module_methods[] = {
+    {"copy_file", (PyCFunction)(void(*)(void))file_transfer_copy_file, METH_VARARGS | METH_KEYWORDS,
+     "Copy src to dst in the kernel; returns (bytes_copied, sha256_hex or None, method)"},
+    {"version", file_transfer_version, METH_NOARGS, "Get version"},
+    {NULL, NULL, 0, NULL}
+};
+
+// Module definition
+static struct PyModuleDef file_transfer_module = {
+    PyModuleDef_HEAD_INIT,
+    "file_transfer_native",
+    "Native file transfer extension for Lucid RDP",
+    -1,
+    file_transfer_module_methods
+};
+
+PyMODINIT_FUNC PyInit_file_transfer_native(void) {
+    if (PyType_Ready(&TransferProgressType) < 0) {
+        return NULL;
+    }
+
+    PyObject *m = PyModule_Create(&file_transfer_module);
+    if (m == NULL) {
+        return NULL;
+    }
+
+    Py_INCREF(&TransferProgressType);
+    if (PyModule_AddObject(m, "TransferProgress", (PyObject*)&TransferProgressType) < 0) {
+        Py_DECREF(&TransferProgressType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    PyModule_AddIntConstant(m, "CHUNK_SIZE", XFER_CHUNK_SIZE);
+
+    return m;
+}
@@ -0,0 +1,10 @@
+#ifndef FILE_TRANSFER_H
+#define FILE_TRANSFER_H
+
+#include <Python.h>
+
+// Constants
+#define DEFAULT_FILE_MODE 0644
+#define COPY_SAME_FILE 2  // copy_path: source and target are one inode
+
+#endif // FILE_TRANSFER_H
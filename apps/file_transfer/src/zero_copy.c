@@ -0,0 +1,271 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/sendfile.h>
+#include <openssl/sha.h>
+#include "zero_copy.h"
+
+const char *xfer_method_name(xfer_method_t method) {
+    switch (method) {
+    case XFER_COPY_FILE_RANGE:
+        return "copy_file_range";
+    case XFER_SENDFILE:
+        return "sendfile";
+    case XFER_SPLICE_TEE:
+        return "splice";
+    default:
+        return "read_write";
+    }
+}
+
+// Errors that mean "this syscall cannot handle these descriptors", as
+// opposed to a real I/O failure
+static int is_unsupported(int err) {
+    return err == ENOSYS || err == EXDEV || err == EINVAL || err == EOPNOTSUPP ||
+           err == ENOTSUP || err == EBADF;
+}
+
+static int is_cancelled(xfer_progress_t *progress) {
+    return progress && __atomic_load_n(&progress->cancelled, __ATOMIC_RELAXED);
+}
+
+static void report(xfer_progress_t *progress, uint64_t done) {
+    if (progress) {
+        __atomic_store_n(&progress->done, done, __ATOMIC_RELAXED);
+    }
+}
+
+static int write_all(int fd, const uint8_t *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int read_all(int fd, uint8_t *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = read(fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (n == 0) {
+            errno = EIO;
+            return -1;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static ssize_t read_write_chunk(int in_fd, int out_fd, size_t len, uint8_t *buffer) {
+    ssize_t n;
+    do {
+        n = read(in_fd, buffer, len < XFER_BUFFER_SIZE ? len : XFER_BUFFER_SIZE);
+    } while (n < 0 && errno == EINTR);
+
+    if (n > 0 && write_all(out_fd, buffer, (size_t)n) != 0) {
+        return -1;
+    }
+    return n;
+}
+
+// Kernel-side copy without hashing: copy_file_range, then sendfile, then
+// plain read/write. Falling back is only allowed before any byte moved in
+// the failing call, which both syscalls guarantee on these errors.
+static ssize_t kernel_chunk(int in_fd, int out_fd, size_t len, xfer_method_t *method,
+                            uint8_t *buffer) {
+    for (;;) {
+        ssize_t n;
+        switch (*method) {
+        case XFER_COPY_FILE_RANGE:
+            n = copy_file_range(in_fd, NULL, out_fd, NULL, len, 0);
+            // Some pseudo filesystems report 0 instead of an error
+            if ((n < 0 && is_unsupported(errno)) || n == 0) {
+                *method = XFER_SENDFILE;
+                continue;
+            }
+            break;
+        case XFER_SENDFILE:
+            n = sendfile(out_fd, in_fd, NULL, len);
+            if (n < 0 && is_unsupported(errno)) {
+                *method = XFER_READ_WRITE;
+                continue;
+            }
+            break;
+        default:
+            n = read_write_chunk(in_fd, out_fd, len, buffer);
+            break;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        return n;
+    }
+}
+
+// Hashing copy through two pipes: the source pages are spliced into the
+// first pipe, tee duplicates the page references into the second, the
+// first is spliced to the target and only the second is read back for
+// hashing. The hash therefore covers exactly the bytes that were written.
+static ssize_t tee_chunk(int in_fd, int out_fd, size_t len, const int *pipes,
+                         uint8_t *buffer, SHA256_CTX *ctx) {
+    ssize_t n;
+    do {
+        n = splice(in_fd, NULL, pipes[1], NULL, len, SPLICE_F_MOVE);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0) {
+        return n;
+    }
+
+    size_t teed = 0;
+    while (teed < (size_t)n) {
+        ssize_t t = tee(pipes[0], pipes[3], (size_t)n - teed, 0);
+        if (t < 0 && errno == EINTR) {
+            continue;
+        }
+        if (t <= 0) {
+            return -1;
+        }
+        teed += (size_t)t;
+    }
+
+    size_t left = (size_t)n;
+    while (left > 0) {
+        ssize_t w = splice(pipes[0], NULL, out_fd, NULL, left, SPLICE_F_MOVE);
+        if (w < 0 && errno == EINTR) {
+            continue;
+        }
+        if (w <= 0) {
+            return -1;
+        }
+        left -= (size_t)w;
+    }
+
+    if (read_all(pipes[2], buffer, (size_t)n) != 0) {
+        return -1;
+    }
+    SHA256_Update(ctx, buffer, (size_t)n);
+    return n;
+}
+
+static int open_tee_pipes(int *pipes, size_t *capacity) {
+    if (pipe2(pipes, O_CLOEXEC) != 0) {
+        return -1;
+    }
+    if (pipe2(pipes + 2, O_CLOEXEC) != 0) {
+        close(pipes[0]);
+        close(pipes[1]);
+        return -1;
+    }
+
+    // Larger pipes mean fewer syscalls; the default 64K is still correct
+    fcntl(pipes[1], F_SETPIPE_SZ, XFER_PIPE_SIZE);
+    fcntl(pipes[3], F_SETPIPE_SZ, XFER_PIPE_SIZE);
+    int first = fcntl(pipes[1], F_GETPIPE_SZ);
+    int second = fcntl(pipes[3], F_GETPIPE_SZ);
+    size_t cap = (size_t)(first < second ? first : second);
+    *capacity = cap < XFER_BUFFER_SIZE ? cap : XFER_BUFFER_SIZE;
+    return 0;
+}
+
+static void close_tee_pipes(int *pipes) {
+    for (int i = 0; i < 4; i++) {
+        if (pipes[i] >= 0) {
+            close(pipes[i]);
+        }
+    }
+}
+
+int64_t xfer_copy(int in_fd, int out_fd, uint64_t size, uint8_t *digest,
+                  xfer_progress_t *progress, xfer_method_t *method) {
+    SHA256_CTX ctx;
+    int pipes[4] = {-1, -1, -1, -1};
+    size_t pipe_capacity = 0;
+    uint64_t done = 0;
+    int64_t result = -1;
+    int saved_errno = 0;
+
+    uint8_t *buffer = malloc(XFER_BUFFER_SIZE);
+    if (buffer == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    if (progress) {
+        __atomic_store_n(&progress->total, size, __ATOMIC_RELAXED);
+        report(progress, 0);
+    }
+
+    if (digest) {
+        SHA256_Init(&ctx);
+        *method = open_tee_pipes(pipes, &pipe_capacity) == 0 ? XFER_SPLICE_TEE : XFER_READ_WRITE;
+    } else {
+        *method = XFER_COPY_FILE_RANGE;
+    }
+
+    while (done < size) {
+        if (is_cancelled(progress)) {
+            errno = ECANCELED;
+            goto cleanup;
+        }
+
+        uint64_t remaining = size - done;
+        size_t want = remaining < XFER_CHUNK_SIZE ? (size_t)remaining : XFER_CHUNK_SIZE;
+        ssize_t n;
+
+        if (*method == XFER_SPLICE_TEE) {
+            n = tee_chunk(in_fd, out_fd, want < pipe_capacity ? want : pipe_capacity,
+                          pipes, buffer, &ctx);
+            // Nothing has moved yet if the very first splice is refused
+            if (n < 0 && done == 0 && is_unsupported(errno)) {
+                *method = XFER_READ_WRITE;
+                continue;
+            }
+        } else if (digest) {
+            n = read_write_chunk(in_fd, out_fd, want, buffer);
+            if (n > 0) {
+                SHA256_Update(&ctx, buffer, (size_t)n);
+            }
+        } else {
+            n = kernel_chunk(in_fd, out_fd, want, method, buffer);
+        }
+
+        if (n < 0) {
+            goto cleanup;
+        }
+        if (n == 0) {
+            // Source shrank underneath us; a short copy is not a copy
+            errno = EIO;
+            goto cleanup;
+        }
+        done += (uint64_t)n;
+        report(progress, done);
+    }
+
+    if (digest) {
+        SHA256_Final(digest, &ctx);
+    }
+    result = (int64_t)done;
+
+cleanup:
+    saved_errno = errno;
+    close_tee_pipes(pipes);
+    free(buffer);
+    errno = saved_errno;
+    return result;
+}
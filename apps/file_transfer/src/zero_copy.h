@@ -0,0 +1,40 @@
+#ifndef ZERO_COPY_H
+#define ZERO_COPY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Constants
+#define XFER_DIGEST_SIZE 32
+#define XFER_CHUNK_SIZE (4 * 1024 * 1024)  // Bytes per kernel copy call
+#define XFER_PIPE_SIZE (1024 * 1024)       // Requested capacity of the tee pipes
+#define XFER_BUFFER_SIZE (1024 * 1024)     // Hash and read/write bounce buffer
+
+// Copy strategy actually used, best first. The hashing path only uses
+// splice/tee or read/write since the bytes have to reach the hasher.
+typedef enum {
+    XFER_COPY_FILE_RANGE = 0,
+    XFER_SENDFILE,
+    XFER_SPLICE_TEE,
+    XFER_READ_WRITE
+} xfer_method_t;
+
+// Progress counter shared with the caller. Written by the copying thread
+// and read from any other thread with atomic loads, so no lock is needed.
+typedef struct {
+    uint64_t done;
+    uint64_t total;
+    int cancelled;
+} xfer_progress_t;
+
+const char *xfer_method_name(xfer_method_t method);
+
+// Copy up to size bytes from the current position of in_fd to the current
+// position of out_fd. When digest is non-NULL the SHA-256 of exactly the
+// bytes written is stored in it. Returns the number of bytes copied (less
+// than size if the source shrank), or -1 with errno set (ECANCELED when the
+// progress counter was cancelled).
+int64_t xfer_copy(int in_fd, int out_fd, uint64_t size, uint8_t *digest,
+                  xfer_progress_t *progress, xfer_method_t *method);
+
+#endif // ZERO_COPY_H
@@ -0,0 +1,13 @@
+# Frame Ring Module
+# Shared-memory frame ring between recorder and processor
+
+"""
+File: /app/apps/frame_ring/__init__.py
+x-lucid-file-path: /app/apps/frame_ring/__init__.py
+x-lucid-file-type: python
+
+Frame Ring package for Lucid RDP.
+Contains the native shared-memory frame ring used by the session recorder.
+"""
+
+__all__ = []
@@ -0,0 +1,13 @@
+# Frame Ring Source Module
+# Frame ring native source code components
+
+"""
+File: /app/apps/frame_ring/src/__init__.py
+x-lucid-file-path: /app/apps/frame_ring/src/__init__.py
+x-lucid-file-type: python
+
+Frame Ring Source package for Lucid RDP.
+Contains frame ring native source code and C implementations.
+"""
+
+__all__ = []
@@ -0,0 +1,798 @@
+/*
+ * Native frame ring extension for Lucid RDP
+ * Single-producer, multi-consumer ring of frame slots in POSIX shared
+ * memory. The recorder writes frames straight into a slot and publishes a
+ * descriptor; consumers in this or another process on the host (any
+ * container sharing /dev/shm) read the same pages without a copy and are
+ * woken through a shared futex
+ */
+
+#define _GNU_SOURCE
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "frame_ring.h"
+#include "shm_ring.h"
+
+typedef struct {
+    PyObject_HEAD
+    ring_header_t *ring;
+    size_t size;
+    char name[FRAME_RING_NAME_MAX + 2];
+    Py_ssize_t exports;
+    int reserved;          // A slot is handed out and not yet committed
+    uint64_t reserved_seq;
+    uint64_t published;    // Final counts, kept after close()
+    uint64_t dropped;
+} FrameRingWriterObject;
+
+typedef struct {
+    PyObject_HEAD
+    ring_header_t *ring;
+    size_t size;
+    int consumer;
+    uint64_t token;
+    Py_ssize_t exports;
+    int holding;           // The last frame returned by next() is not released
+    uint64_t held_seq;
+    // Keeps the cursor's heartbeat going while Python works on a frame
+    pthread_t heartbeat;
+    pthread_mutex_t heartbeat_lock;
+    pthread_cond_t heartbeat_cond;
+    int heartbeat_stop;
+    pid_t owner_pid;       // A forked child must not join or detach for the parent
+} FrameRingReaderObject;
+
+static PyTypeObject FrameRingWriterType;
+static PyTypeObject FrameRingReaderType;
+
+// Forward declarations
+static PyObject* FrameRingWriter_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
+static int FrameRingWriter_init(FrameRingWriterObject *self, PyObject *args, PyObject *kwds);
+static void FrameRingWriter_dealloc(FrameRingWriterObject *self);
+static PyObject* FrameRingWriter_reserve(FrameRingWriterObject *self, PyObject *args);
+static PyObject* FrameRingWriter_commit(FrameRingWriterObject *self, PyObject *args, PyObject *kwds);
+static PyObject* FrameRingWriter_publish(FrameRingWriterObject *self, PyObject *args, PyObject *kwds);
+static PyObject* FrameRingWriter_close(FrameRingWriterObject *self, PyObject *args);
+static int FrameRingWriter_getbuffer(FrameRingWriterObject *self, Py_buffer *view, int flags);
+static void FrameRingWriter_releasebuffer(FrameRingWriterObject *self, Py_buffer *view);
+static PyObject* FrameRingReader_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
+static int FrameRingReader_init(FrameRingReaderObject *self, PyObject *args, PyObject *kwds);
+static void FrameRingReader_dealloc(FrameRingReaderObject *self);
+static PyObject* FrameRingReader_next(FrameRingReaderObject *self, PyObject *args, PyObject *kwds);
+static PyObject* FrameRingReader_release(FrameRingReaderObject *self, PyObject *args);
+static PyObject* FrameRingReader_close(FrameRingReaderObject *self, PyObject *args);
+static int FrameRingReader_getbuffer(FrameRingReaderObject *self, Py_buffer *view, int flags);
+static void FrameRingReader_releasebuffer(FrameRingReaderObject *self, Py_buffer *view);
+
+// "session" and "/session" both name the segment /dev/shm/session
+static int shm_name(const char *name, char out[FRAME_RING_NAME_MAX + 2]) {
+    if (name[0] == '/') {
+        name++;
+    }
+    size_t len = strlen(name);
+    if (len == 0 || len > FRAME_RING_NAME_MAX || strchr(name, '/') != NULL) {
+        PyErr_SetString(PyExc_ValueError, "ring name must be 1-255 characters without '/'");
+        return -1;
+    }
+    out[0] = '/';
+    memcpy(out + 1, name, len + 1);
+    return 0;
+}
+
+// Memoryview of [offset, offset + length) of owner's mapping; the view
+// holds a buffer export, so the mapping cannot be closed under it
+static PyObject* slot_view(PyObject *owner, size_t offset, size_t length) {
+    PyObject *whole = PyMemoryView_FromObject(owner);
+    if (whole == NULL) {
+        return NULL;
+    }
+    PyObject *start = PyLong_FromSize_t(offset);
+    PyObject *stop = PyLong_FromSize_t(offset + length);
+    PyObject *slice = start && stop ? PySlice_New(start, stop, NULL) : NULL;
+    PyObject *view = slice ? PyObject_GetItem(whole, slice) : NULL;
+    Py_XDECREF(start);
+    Py_XDECREF(stop);
+    Py_XDECREF(slice);
+    Py_DECREF(whole);
+    return view;
+}
+
+static size_t slot_offset(ring_header_t *ring, uint64_t seq) {
+    return (size_t)(ring_slot(ring, seq) - (uint8_t*)ring);
+}
+
+// Method definitions
+static PyMethodDef FrameRingWriter_methods[] = {
+    {"reserve", (PyCFunction)FrameRingWriter_reserve, METH_NOARGS,
+     "Writable memoryview of the next slot, or None if every slot is still held by a consumer"},
+    {"commit", (PyCFunction)(void(*)(void))FrameRingWriter_commit, METH_VARARGS | METH_KEYWORDS,
+     "Publish the reserved slot: commit(length, timestamp_us=0, width=0, height=0, format=0) -> sequence"},
+    {"publish", (PyCFunction)(void(*)(void))FrameRingWriter_publish, METH_VARARGS | METH_KEYWORDS,
+     "Copy data into the next slot and publish it; returns the sequence, or None if the frame was dropped"},
+    {"close", (PyCFunction)FrameRingWriter_close, METH_NOARGS,
+     "Mark the ring closed, wake consumers and unlink the segment"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyObject* FrameRingWriter_get_name(FrameRingWriterObject *self, void *closure) {
+    return PyUnicode_FromString(self->name + 1);
+}
+
+static PyObject* FrameRingWriter_get_slot_size(FrameRingWriterObject *self, void *closure) {
+    if (self->ring == NULL) {
+        Py_RETURN_NONE;
+    }
+    return PyLong_FromUnsignedLongLong(self->ring->slot_size);
+}
+
+static PyObject* FrameRingWriter_get_slot_count(FrameRingWriterObject *self, void *closure) {
+    if (self->ring == NULL) {
+        Py_RETURN_NONE;
+    }
+    return PyLong_FromUnsignedLong(self->ring->slot_count);
+}
+
+static PyObject* FrameRingWriter_get_published(FrameRingWriterObject *self, void *closure) {
+    if (self->ring == NULL) {
+        return PyLong_FromUnsignedLongLong(self->published);
+    }
+    return PyLong_FromUnsignedLongLong(__atomic_load_n(&self->ring->published, __ATOMIC_RELAXED));
+}
+
+static PyObject* FrameRingWriter_get_dropped(FrameRingWriterObject *self, void *closure) {
+    if (self->ring == NULL) {
+        return PyLong_FromUnsignedLongLong(self->dropped);
+    }
+    return PyLong_FromUnsignedLongLong(__atomic_load_n(&self->ring->dropped, __ATOMIC_RELAXED));
+}
+
+static PyObject* FrameRingWriter_get_consumers(FrameRingWriterObject *self, void *closure) {
+    long count = 0;
+    if (self->ring != NULL) {
+        ring_consumer_t *consumers = ring_consumers(self->ring);
+        for (uint32_t i = 0; i < self->ring->max_consumers; i++) {
+            count += __atomic_load_n(&consumers[i].token, __ATOMIC_ACQUIRE) != 0;
+        }
+    }
+    return PyLong_FromLong(count);
+}
+
+static PyObject* FrameRingWriter_get_closed(FrameRingWriterObject *self, void *closure) {
+    return PyBool_FromLong(self->ring == NULL);
+}
+
+static PyGetSetDef FrameRingWriter_getset[] = {
+    {"name", (getter)FrameRingWriter_get_name, NULL, "Shared memory segment name", NULL},
+    {"slot_size", (getter)FrameRingWriter_get_slot_size, NULL, "Usable bytes per slot", NULL},
+    {"slot_count", (getter)FrameRingWriter_get_slot_count, NULL, "Number of slots", NULL},
+    {"published", (getter)FrameRingWriter_get_published, NULL, "Frames published", NULL},
+    {"dropped", (getter)FrameRingWriter_get_dropped, NULL, "Frames dropped because consumers lagged", NULL},
+    {"consumers", (getter)FrameRingWriter_get_consumers, NULL, "Attached consumers", NULL},
+    {"closed", (getter)FrameRingWriter_get_closed, NULL, "Whether close() was called", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PyBufferProcs FrameRingWriter_as_buffer = {
+    .bf_getbuffer = (getbufferproc)FrameRingWriter_getbuffer,
+    .bf_releasebuffer = (releasebufferproc)FrameRingWriter_releasebuffer,
+};
+
+static PyMethodDef FrameRingReader_methods[] = {
+    {"next", (PyCFunction)(void(*)(void))FrameRingReader_next, METH_VARARGS | METH_KEYWORDS,
+     "Release the previous frame (its view must be gone) and wait for the next: next(timeout=None) -> "
+     "(sequence, timestamp_us, width, height, format, memoryview), or None on timeout; "
+     "raises EOFError once the producer has closed and every frame was read"},
+    {"release", (PyCFunction)FrameRingReader_release, METH_NOARGS,
+     "Hand the last frame's slot back to the producer"},
+    {"close", (PyCFunction)FrameRingReader_close, METH_NOARGS, "Detach from the ring"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyObject* FrameRingReader_get_lag(FrameRingReaderObject *self, void *closure) {
+    if (self->ring == NULL) {
+        return PyLong_FromLong(0);
+    }
+    uint64_t write_seq = __atomic_load_n(&self->ring->write_seq, __ATOMIC_ACQUIRE);
+    uint64_t read_seq = __atomic_load_n(&ring_consumers(self->ring)[self->consumer].read_seq, __ATOMIC_RELAXED);
+    return PyLong_FromUnsignedLongLong(write_seq - read_seq);
+}
+
+static PyObject* FrameRingReader_get_slot_size(FrameRingReaderObject *self, void *closure) {
+    if (self->ring == NULL) {
+        Py_RETURN_NONE;
+    }
+    return PyLong_FromUnsignedLongLong(self->ring->slot_size);
+}
+
+static PyObject* FrameRingReader_get_producer_closed(FrameRingReaderObject *self, void *closure) {
+    return PyBool_FromLong(self->ring == NULL || __atomic_load_n(&self->ring->closed, __ATOMIC_ACQUIRE));
+}
+
+static PyObject* FrameRingReader_get_closed(FrameRingReaderObject *self, void *closure) {
+    return PyBool_FromLong(self->ring == NULL);
+}
+
+static PyGetSetDef FrameRingReader_getset[] = {
+    {"lag", (getter)FrameRingReader_get_lag, NULL, "Published frames not yet released by this reader", NULL},
+    {"slot_size", (getter)FrameRingReader_get_slot_size, NULL, "Usable bytes per slot", NULL},
+    {"producer_closed", (getter)FrameRingReader_get_producer_closed, NULL, "Whether the producer closed the ring", NULL},
+    {"closed", (getter)FrameRingReader_get_closed, NULL, "Whether close() was called", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PyBufferProcs FrameRingReader_as_buffer = {
+    .bf_getbuffer = (getbufferproc)FrameRingReader_getbuffer,
+    .bf_releasebuffer = (releasebufferproc)FrameRingReader_releasebuffer,
+};
+
+// Type definition
+static PyTypeObject FrameRingWriterType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "frame_ring_native.FrameRingWriter",
+    .tp_doc = "Producer end of a shared-memory frame ring; creates and owns the segment",
+    .tp_basicsize = sizeof(FrameRingWriterObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = FrameRingWriter_new,
+    .tp_init = (initproc)FrameRingWriter_init,
+    .tp_dealloc = (destructor)FrameRingWriter_dealloc,
+    .tp_methods = FrameRingWriter_methods,
+    .tp_getset = FrameRingWriter_getset,
+    .tp_as_buffer = &FrameRingWriter_as_buffer,
+};
+
+static PyTypeObject FrameRingReaderType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "frame_ring_native.FrameRingReader",
+    .tp_doc = "Consumer end of a shared-memory frame ring",
+    .tp_basicsize = sizeof(FrameRingReaderObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = FrameRingReader_new,
+    .tp_init = (initproc)FrameRingReader_init,
+    .tp_dealloc = (destructor)FrameRingReader_dealloc,
+    .tp_methods = FrameRingReader_methods,
+    .tp_getset = FrameRingReader_getset,
+    .tp_as_buffer = &FrameRingReader_as_buffer,
+};
+
+static PyObject* FrameRingWriter_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
+    FrameRingWriterObject *self = (FrameRingWriterObject*)type->tp_alloc(type, 0);
+    if (self == NULL) {
+        return NULL;
+    }
+    self->ring = NULL;
+    self->name[0] = '\0';
+    return (PyObject*)self;
+}
+
+// A segment left behind by a producer that died can be replaced
+static int stale_segment(const char *name) {
+    struct stat st;
+    int stale = 0;
+
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        return errno == ENOENT;
+    }
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= RING_CONSUMERS_OFFSET) {
+        ring_header_t *ring = mmap(NULL, RING_CONSUMERS_OFFSET, PROT_READ, MAP_SHARED, fd, 0);
+        if (ring != MAP_FAILED) {
+            stale = ring->magic != RING_MAGIC ||
+                    (kill((pid_t)ring->producer_pid, 0) != 0 && errno == ESRCH);
+            munmap(ring, RING_CONSUMERS_OFFSET);
+        }
+    } else {
+        stale = 1;  // Creator died before sizing it
+    }
+    close(fd);
+    return stale;
+}
+
+static int FrameRingWriter_init(FrameRingWriterObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"name", "slot_size", "slot_count", "max_consumers", "consumer_timeout", NULL};
+    const char *name;
+    unsigned long long slot_size;
+    unsigned int slot_count = FRAME_RING_DEFAULT_SLOTS;
+    unsigned int max_consumers = FRAME_RING_DEFAULT_CONSUMERS;
+    double consumer_timeout = RING_DEFAULT_CONSUMER_TIMEOUT_MS / 1000.0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "sK|IId", kwlist, &name, &slot_size, &slot_count,
+                                     &max_consumers, &consumer_timeout)) {
+        return -1;
+    }
+    // Several missed heartbeats before a cursor counts as abandoned
+    if (!(consumer_timeout * 1000.0 >= 2 * RING_HEARTBEAT_MS) || consumer_timeout > 3600.0) {
+        PyErr_Format(PyExc_ValueError, "consumer_timeout must be %.1f-3600 seconds",
+                     2 * RING_HEARTBEAT_MS / 1000.0);
+        return -1;
+    }
+    if (self->ring != NULL) {
+        PyErr_SetString(PyExc_RuntimeError, "FrameRingWriter is already initialized");
+        return -1;
+    }
+    if (shm_name(name, self->name) < 0) {
+        return -1;
+    }
+    size_t size = ring_layout_size(slot_count, slot_size, max_consumers);
+    if (size == 0) {
+        PyErr_Format(PyExc_ValueError, "slot_count must be 1-%d, max_consumers 1-%d and slot_size positive",
+                     RING_MAX_SLOTS, RING_MAX_CONSUMERS);
+        return -1;
+    }
+
+    int fd = -1, saved_errno = 0;
+    void *map = MAP_FAILED;
+
+    Py_BEGIN_ALLOW_THREADS
+    fd = shm_open(self->name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, FRAME_RING_MODE);
+    if (fd < 0 && errno == EEXIST && stale_segment(self->name)) {
+        shm_unlink(self->name);
+        fd = shm_open(self->name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, FRAME_RING_MODE);
+    }
+    if (fd >= 0) {
+        if (ftruncate(fd, (off_t)size) == 0) {
+            map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        saved_errno = errno;
+        if (map == MAP_FAILED) {
+            shm_unlink(self->name);
+        } else {
+            ring_init(map, slot_count, slot_size, max_consumers, (uint32_t)getpid(),
+                      (uint32_t)(consumer_timeout * 1000.0));
+        }
+        close(fd);
+    } else {
+        saved_errno = errno;
+    }
+    Py_END_ALLOW_THREADS
+
+    if (map == MAP_FAILED) {
+        errno = saved_errno;
+        PyErr_SetFromErrnoWithFilename(PyExc_OSError, self->name);
+        return -1;
+    }
+    self->ring = map;
+    self->size = size;
+    return 0;
+}
+
+static void writer_unmap(FrameRingWriterObject *self) {
+    self->published = __atomic_load_n(&self->ring->published, __ATOMIC_RELAXED);
+    self->dropped = __atomic_load_n(&self->ring->dropped, __ATOMIC_RELAXED);
+    ring_close(self->ring);
+    munmap(self->ring, self->size);
+    shm_unlink(self->name);
+    self->ring = NULL;
+    self->reserved = 0;
+}
+
+static void FrameRingWriter_dealloc(FrameRingWriterObject *self) {
+    if (self->ring != NULL) {
+        writer_unmap(self);
+    }
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static int FrameRingWriter_getbuffer(FrameRingWriterObject *self, Py_buffer *view, int flags) {
+    if (self->ring == NULL) {
+        PyErr_SetString(PyExc_BufferError, "frame ring is closed");
+        view->obj = NULL;
+        return -1;
+    }
+    if (PyBuffer_FillInfo(view, (PyObject*)self, self->ring, (Py_ssize_t)self->size, 0, flags) < 0) {
+        return -1;
+    }
+    self->exports++;
+    return 0;
+}
+
+static void FrameRingWriter_releasebuffer(FrameRingWriterObject *self, Py_buffer *view) {
+    self->exports--;
+}
+
+static int writer_check_open(FrameRingWriterObject *self) {
+    if (self->ring == NULL) {
+        PyErr_SetString(PyExc_ValueError, "I/O operation on closed frame ring");
+        return -1;
+    }
+    return 0;
+}
+
+static PyObject* FrameRingWriter_reserve(FrameRingWriterObject *self, PyObject *args) {
+    if (writer_check_open(self) < 0) {
+        return NULL;
+    }
+    if (!self->reserved) {
+        if (ring_reserve(self->ring, &self->reserved_seq) == NULL) {
+            Py_RETURN_NONE;
+        }
+        self->reserved = 1;
+    }
+    return slot_view((PyObject*)self, slot_offset(self->ring, self->reserved_seq), self->ring->slot_size);
+}
+
+static int parse_desc(FrameRingWriterObject *self, ring_desc_t *desc, long long timestamp_us,
+                      unsigned int width, unsigned int height, unsigned int format, Py_ssize_t length) {
+    if (length < 0 || (unsigned long long)length > self->ring->slot_size) {
+        PyErr_Format(PyExc_ValueError, "frame length must be 0-%llu bytes",
+                     (unsigned long long)self->ring->slot_size);
+        return -1;
+    }
+    memset(desc, 0, sizeof(*desc));
+    desc->length = (uint64_t)length;
+    desc->timestamp_us = timestamp_us;
+    desc->width = width;
+    desc->height = height;
+    desc->format = format;
+    return 0;
+}
+
+static PyObject* FrameRingWriter_commit(FrameRingWriterObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"length", "timestamp_us", "width", "height", "format", NULL};
+    Py_ssize_t length;
+    long long timestamp_us = 0;
+    unsigned int width = 0, height = 0, format = FRAME_FORMAT_RAW;
+    ring_desc_t desc;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "n|LIII", kwlist, &length, &timestamp_us, &width, &height,
+                                     &format)) {
+        return NULL;
+    }
+    if (writer_check_open(self) < 0) {
+        return NULL;
+    }
+    if (!self->reserved) {
+        PyErr_SetString(PyExc_ValueError, "no reserved slot to commit");
+        return NULL;
+    }
+    if (parse_desc(self, &desc, timestamp_us, width, height, format, length) < 0) {
+        return NULL;
+    }
+    ring_commit(self->ring, self->reserved_seq, &desc);
+    self->reserved = 0;
+    return PyLong_FromUnsignedLongLong(self->reserved_seq);
+}
+
+static PyObject* FrameRingWriter_publish(FrameRingWriterObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"data", "timestamp_us", "width", "height", "format", NULL};
+    Py_buffer data;
+    long long timestamp_us = 0;
+    unsigned int width = 0, height = 0, format = FRAME_FORMAT_RAW;
+    ring_desc_t desc;
+    uint64_t seq;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|LIII", kwlist, &data, &timestamp_us, &width, &height,
+                                     &format)) {
+        return NULL;
+    }
+    if (writer_check_open(self) < 0 || parse_desc(self, &desc, timestamp_us, width, height, format, data.len) < 0) {
+        PyBuffer_Release(&data);
+        return NULL;
+    }
+    if (self->reserved) {
+        PyBuffer_Release(&data);
+        PyErr_SetString(PyExc_ValueError, "a reserved slot is waiting for commit()");
+        return NULL;
+    }
+
+    uint8_t *slot = ring_reserve(self->ring, &seq);
+    if (slot == NULL) {
+        PyBuffer_Release(&data);
+        Py_RETURN_NONE;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    memcpy(slot, data.buf, (size_t)data.len);
+    Py_END_ALLOW_THREADS
+    ring_commit(self->ring, seq, &desc);
+
+    PyBuffer_Release(&data);
+    return PyLong_FromUnsignedLongLong(seq);
+}
+
+static PyObject* FrameRingWriter_close(FrameRingWriterObject *self, PyObject *args) {
+    if (self->ring == NULL) {
+        Py_RETURN_NONE;
+    }
+    if (self->exports > 0) {
+        PyErr_SetString(PyExc_BufferError, "slot views are still in use");
+        return NULL;
+    }
+    writer_unmap(self);
+    Py_RETURN_NONE;
+}
+
+static PyObject* FrameRingReader_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
+    FrameRingReaderObject *self = (FrameRingReaderObject*)type->tp_alloc(type, 0);
+    if (self == NULL) {
+        return NULL;
+    }
+    self->ring = NULL;
+    self->consumer = -1;
+    pthread_mutex_init(&self->heartbeat_lock, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&self->heartbeat_cond, &attr);
+    pthread_condattr_destroy(&attr);
+    return (PyObject*)self;
+}
+
+// Bumps the cursor's heartbeat until stopped or the cursor is reclaimed
+static void* reader_heartbeat(void *arg) {
+    FrameRingReaderObject *self = arg;
+    struct timespec deadline;
+
+    pthread_mutex_lock(&self->heartbeat_lock);
+    while (!self->heartbeat_stop && ring_heartbeat(self->ring, self->consumer, self->token) == 0) {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_nsec += RING_HEARTBEAT_MS * 1000000L;
+        deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+        deadline.tv_nsec %= 1000000000L;
+        while (!self->heartbeat_stop &&
+               pthread_cond_timedwait(&self->heartbeat_cond, &self->heartbeat_lock, &deadline) == 0) {
+        }
+    }
+    pthread_mutex_unlock(&self->heartbeat_lock);
+    return NULL;
+}
+
+static int FrameRingReader_init(FrameRingReaderObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"name", NULL};
+    const char *name;
+    char path[FRAME_RING_NAME_MAX + 2];
+    struct stat st;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "s", kwlist, &name)) {
+        return -1;
+    }
+    if (self->ring != NULL) {
+        PyErr_SetString(PyExc_RuntimeError, "FrameRingReader is already initialized");
+        return -1;
+    }
+    if (shm_name(name, path) < 0) {
+        return -1;
+    }
+
+    int fd = shm_open(path, O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0) {
+        PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+        return -1;
+    }
+    void *map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    int saved_errno = errno;
+    close(fd);
+    if (map == MAP_FAILED) {
+        errno = st.st_size > 0 ? saved_errno : EINVAL;
+        PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+        return -1;
+    }
+    if (ring_validate(map, (size_t)st.st_size) < 0) {
+        munmap(map, (size_t)st.st_size);
+        PyErr_Format(PyExc_ValueError, "%s is not a frame ring", path);
+        return -1;
+    }
+
+    uint64_t token;
+    int consumer = ring_attach(map, (uint32_t)getpid(), &token);
+    if (consumer < 0) {
+        munmap(map, (size_t)st.st_size);
+        PyErr_SetString(PyExc_RuntimeError, "frame ring has no free consumer slots");
+        return -1;
+    }
+    self->ring = map;
+    self->size = (size_t)st.st_size;
+    self->consumer = consumer;
+    self->token = token;
+    self->heartbeat_stop = 0;
+    self->owner_pid = getpid();
+    int rc = pthread_create(&self->heartbeat, NULL, reader_heartbeat, self);
+    if (rc != 0) {
+        ring_detach(map, consumer, token);
+        munmap(map, self->size);
+        self->ring = NULL;
+        errno = rc;
+        PyErr_SetFromErrno(PyExc_OSError);
+        return -1;
+    }
+    return 0;
+}
+
+static void reader_unmap(FrameRingReaderObject *self) {
+    // After fork() the heartbeat thread and the cursor belong to the parent
+    if (self->owner_pid == getpid()) {
+        pthread_mutex_lock(&self->heartbeat_lock);
+        self->heartbeat_stop = 1;
+        pthread_cond_signal(&self->heartbeat_cond);
+        pthread_mutex_unlock(&self->heartbeat_lock);
+        Py_BEGIN_ALLOW_THREADS
+        pthread_join(self->heartbeat, NULL);
+        Py_END_ALLOW_THREADS
+        ring_detach(self->ring, self->consumer, self->token);
+    }
+    munmap(self->ring, self->size);
+    self->ring = NULL;
+    self->holding = 0;
+}
+
+static void FrameRingReader_dealloc(FrameRingReaderObject *self) {
+    if (self->ring != NULL) {
+        reader_unmap(self);
+    }
+    pthread_mutex_destroy(&self->heartbeat_lock);
+    pthread_cond_destroy(&self->heartbeat_cond);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static int FrameRingReader_getbuffer(FrameRingReaderObject *self, Py_buffer *view, int flags) {
+    if (self->ring == NULL) {
+        PyErr_SetString(PyExc_BufferError, "frame ring is closed");
+        view->obj = NULL;
+        return -1;
+    }
+    if (PyBuffer_FillInfo(view, (PyObject*)self, self->ring, (Py_ssize_t)self->size, 1, flags) < 0) {
+        return -1;
+    }
+    self->exports++;
+    return 0;
+}
+
+static void FrameRingReader_releasebuffer(FrameRingReaderObject *self, Py_buffer *view) {
+    self->exports--;
+}
+
+// Hands the held frame back; refuses while a view of it is alive, since
+// the producer may overwrite the slot as soon as it is released
+static int reader_release_held(FrameRingReaderObject *self) {
+    if (!self->holding) {
+        return 0;
+    }
+    if (self->exports > 0) {
+        PyErr_SetString(PyExc_BufferError, "frame view is still in use; drop it before releasing the frame");
+        return -1;
+    }
+    self->holding = 0;
+    if (ring_release(self->ring, self->consumer, self->token, self->held_seq) < 0) {
+        PyErr_SetString(PyExc_RuntimeError, "frame ring cursor was reclaimed by the producer");
+        return -1;
+    }
+    return 0;
+}
+
+static PyObject* FrameRingReader_next(FrameRingReaderObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"timeout", NULL};
+    PyObject *timeout = Py_None;
+    int64_t timeout_ms = -1;
+    int rc;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O", kwlist, &timeout)) {
+        return NULL;
+    }
+    if (timeout != Py_None) {
+        double seconds = PyFloat_AsDouble(timeout);
+        if (seconds == -1.0 && PyErr_Occurred()) {
+            return NULL;
+        }
+        timeout_ms = seconds <= 0 ? 0 : (int64_t)(seconds * 1000.0);
+    }
+    if (self->ring == NULL) {
+        PyErr_SetString(PyExc_ValueError, "I/O operation on closed frame ring");
+        return NULL;
+    }
+    if (reader_release_held(self) < 0) {
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    rc = ring_wait(self->ring, self->consumer, self->token, timeout_ms);
+    Py_END_ALLOW_THREADS
+
+    if (rc == 0) {
+        Py_RETURN_NONE;
+    }
+    if (rc == -2) {
+        PyErr_SetString(PyExc_RuntimeError, "frame ring cursor was reclaimed by the producer");
+        return NULL;
+    }
+    if (rc < 0) {
+        PyErr_SetString(PyExc_EOFError, "frame ring closed by producer");
+        return NULL;
+    }
+
+    uint64_t seq = __atomic_load_n(&ring_consumers(self->ring)[self->consumer].read_seq, __ATOMIC_RELAXED);
+    ring_desc_t desc = *ring_desc(self->ring, seq);
+    if (desc.seq != seq || desc.length > self->ring->slot_size) {
+        PyErr_Format(PyExc_ValueError, "corrupt descriptor for frame %llu", (unsigned long long)seq);
+        return NULL;
+    }
+
+    PyObject *view = slot_view((PyObject*)self, slot_offset(self->ring, seq), (size_t)desc.length);
+    if (view == NULL) {
+        return NULL;
+    }
+    self->holding = 1;
+    self->held_seq = seq;
+    return Py_BuildValue("KLIIIN", (unsigned long long)seq, (long long)desc.timestamp_us, desc.width,
+                         desc.height, desc.format, view);
+}
+
+static PyObject* FrameRingReader_release(FrameRingReaderObject *self, PyObject *args) {
+    if (self->ring != NULL && reader_release_held(self) < 0) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* FrameRingReader_close(FrameRingReaderObject *self, PyObject *args) {
+    if (self->ring == NULL) {
+        Py_RETURN_NONE;
+    }
+    if (self->exports > 0) {
+        PyErr_SetString(PyExc_BufferError, "frame views are still in use");
+        return NULL;
+    }
+    reader_unmap(self);
+    Py_RETURN_NONE;
+}
+
+static PyObject* frame_ring_version(PyObject *self, PyObject *args) {
+    return PyUnicode_FromString("0.1.0");
+}
+
+static PyMethodDef frame_ring_module_methods[] = {
+    {"version", frame_ring_version, METH_NOARGS, "Get version"},
+    {NULL, NULL, 0, NULL}
+};
+
+// Module definition
+static struct PyModuleDef frame_ring_module = {
+    PyModuleDef_HEAD_INIT,
+    "frame_ring_native",
+    "Native frame ring extension for Lucid RDP",
+    -1,
+    frame_ring_module_methods
+};
+
+PyMODINIT_FUNC PyInit_frame_ring_native(void) {
+    if (PyType_Ready(&FrameRingWriterType) < 0 || PyType_Ready(&FrameRingReaderType) < 0) {
+        return NULL;
+    }
+
+    PyObject *m = PyModule_Create(&frame_ring_module);
+    if (m == NULL) {
+        return NULL;
+    }
+
+    Py_INCREF(&FrameRingWriterType);
+    if (PyModule_AddObject(m, "FrameRingWriter", (PyObject*)&FrameRingWriterType) < 0) {
+        Py_DECREF(&FrameRingWriterType);
+        Py_DECREF(m);
+        return NULL;
+    }
+    Py_INCREF(&FrameRingReaderType);
+    if (PyModule_AddObject(m, "FrameRingReader", (PyObject*)&FrameRingReaderType) < 0) {
+        Py_DECREF(&FrameRingReaderType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    PyModule_AddIntConstant(m, "FORMAT_RAW", FRAME_FORMAT_RAW);
+    PyModule_AddIntConstant(m, "FORMAT_BGR24", FRAME_FORMAT_BGR24);
+    PyModule_AddIntConstant(m, "FORMAT_JPEG", FRAME_FORMAT_JPEG);
+    PyModule_AddIntConstant(m, "MAX_SLOTS", RING_MAX_SLOTS);
+    PyModule_AddIntConstant(m, "MAX_CONSUMERS", RING_MAX_CONSUMERS);
+
+    return m;
+}
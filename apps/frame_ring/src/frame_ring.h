@@ -0,0 +1,17 @@
+#ifndef FRAME_RING_H
+#define FRAME_RING_H
+
+#include <Python.h>
+
+// Constants
+#define FRAME_RING_MODE 0660  // Readers in other containers share the group
+#define FRAME_RING_DEFAULT_SLOTS 8
+#define FRAME_RING_DEFAULT_CONSUMERS 8
+#define FRAME_RING_NAME_MAX 255
+
+// Frame formats carried in slot descriptors
+#define FRAME_FORMAT_RAW 0
+#define FRAME_FORMAT_BGR24 1
+#define FRAME_FORMAT_JPEG 2
+
+#endif // FRAME_RING_H
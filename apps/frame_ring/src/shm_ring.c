@@ -0,0 +1,235 @@
+#define _GNU_SOURCE
+#include "shm_ring.h"
+#include <limits.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+typedef char ring_header_fits[sizeof(ring_header_t) <= RING_CONSUMERS_OFFSET ? 1 : -1];
+typedef char ring_consumer_size[sizeof(ring_consumer_t) == 64 ? 1 : -1];
+typedef char ring_desc_size[sizeof(ring_desc_t) == RING_DESC_SIZE ? 1 : -1];
+
+static uint64_t align_up(uint64_t v, uint64_t a) {
+    return (v + a - 1) / a * a;
+}
+
+// Shared (not FUTEX_PRIVATE) so waits and wakes match across processes
+static void futex_wait(uint32_t *addr, uint32_t expected, int64_t timeout_ms) {
+    struct timespec ts, *tsp = NULL;
+    if (timeout_ms >= 0) {
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = (timeout_ms % 1000) * 1000000;
+        tsp = &ts;
+    }
+    syscall(SYS_futex, addr, FUTEX_WAIT, expected, tsp, NULL, 0);
+}
+
+static void futex_wake_all(uint32_t *addr) {
+    syscall(SYS_futex, addr, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+static int64_t monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static uint64_t descs_offset(uint32_t max_consumers) {
+    return RING_CONSUMERS_OFFSET + (uint64_t)max_consumers * sizeof(ring_consumer_t);
+}
+
+size_t ring_layout_size(uint32_t slot_count, uint64_t slot_size, uint32_t max_consumers) {
+    if (slot_count == 0 || slot_count > RING_MAX_SLOTS || slot_size == 0 ||
+        max_consumers == 0 || max_consumers > RING_MAX_CONSUMERS || slot_size > (1ull << 40)) {
+        return 0;
+    }
+    uint64_t data = align_up(descs_offset(max_consumers) + (uint64_t)slot_count * RING_DESC_SIZE, RING_SLOT_ALIGN);
+    uint64_t total = data + (uint64_t)slot_count * align_up(slot_size, RING_SLOT_ALIGN);
+    return total > SIZE_MAX ? 0 : (size_t)total;
+}
+
+void ring_init(void *base, uint32_t slot_count, uint64_t slot_size, uint32_t max_consumers,
+               uint32_t producer_pid, uint32_t consumer_timeout_ms) {
+    ring_header_t *ring = base;
+
+    memset(base, 0, (size_t)align_up(descs_offset(max_consumers) + (uint64_t)slot_count * RING_DESC_SIZE, RING_SLOT_ALIGN));
+    ring->version = RING_VERSION;
+    ring->slot_count = slot_count;
+    ring->max_consumers = max_consumers;
+    ring->slot_size = slot_size;
+    ring->slot_stride = align_up(slot_size, RING_SLOT_ALIGN);
+    ring->data_offset = align_up(descs_offset(max_consumers) + (uint64_t)slot_count * RING_DESC_SIZE, RING_SLOT_ALIGN);
+    ring->total_size = ring_layout_size(slot_count, slot_size, max_consumers);
+    ring->producer_pid = producer_pid;
+    ring->consumer_timeout_ms = consumer_timeout_ms;
+    // Magic last: a reader that sees it sees a complete header
+    __atomic_store_n(&ring->magic, RING_MAGIC, __ATOMIC_RELEASE);
+}
+
+int ring_validate(const void *base, size_t mapped) {
+    const ring_header_t *ring = base;
+
+    if (mapped < RING_CONSUMERS_OFFSET || __atomic_load_n(&ring->magic, __ATOMIC_ACQUIRE) != RING_MAGIC ||
+        ring->version != RING_VERSION) {
+        return -1;
+    }
+    size_t size = ring_layout_size(ring->slot_count, ring->slot_size, ring->max_consumers);
+    if (size == 0 || size != ring->total_size || size > mapped ||
+        ring->slot_stride != align_up(ring->slot_size, RING_SLOT_ALIGN)) {
+        return -1;
+    }
+    return 0;
+}
+
+// Whether the owner of token has not bumped its heartbeat for the
+// consumer timeout; only the producer calls this
+static int consumer_stalled(ring_header_t *ring, ring_consumer_t *consumer, uint64_t token) {
+    uint64_t heartbeat = __atomic_load_n(&consumer->heartbeat, __ATOMIC_ACQUIRE);
+    int64_t now = monotonic_ms();
+
+    if (consumer->seen_token != token || consumer->seen_heartbeat != heartbeat) {
+        consumer->seen_token = token;
+        consumer->seen_heartbeat = heartbeat;
+        consumer->seen_ms = now;
+        return 0;
+    }
+    return now - consumer->seen_ms >= (int64_t)ring->consumer_timeout_ms;
+}
+
+// Oldest sequence any live consumer still holds, or seq if none do
+static uint64_t oldest_held(ring_header_t *ring, uint64_t seq, int reap) {
+    ring_consumer_t *consumers = ring_consumers(ring);
+    uint64_t oldest = seq;
+
+    for (uint32_t i = 0; i < ring->max_consumers; i++) {
+        uint64_t token = __atomic_load_n(&consumers[i].token, __ATOMIC_ACQUIRE);
+        if (token == 0) {
+            continue;
+        }
+        uint64_t read_seq = __atomic_load_n(&consumers[i].read_seq, __ATOMIC_ACQUIRE);
+        if (seq - read_seq >= ring->slot_count && reap && consumer_stalled(ring, &consumers[i], token)) {
+            // Owner died or hung without detaching; free its cursor
+            __atomic_compare_exchange_n(&consumers[i].token, &token, 0, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+            continue;
+        }
+        if (read_seq < oldest) {
+            oldest = read_seq;
+        }
+    }
+    return oldest;
+}
+
+uint8_t* ring_reserve(ring_header_t *ring, uint64_t *seq) {
+    uint64_t next = __atomic_load_n(&ring->write_seq, __ATOMIC_RELAXED);
+
+    if (next - oldest_held(ring, next, 0) >= ring->slot_count &&
+        next - oldest_held(ring, next, 1) >= ring->slot_count) {
+        __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    *seq = next;
+    return ring_slot(ring, next);
+}
+
+void ring_commit(ring_header_t *ring, uint64_t seq, const ring_desc_t *desc) {
+    ring_desc_t *slot_desc = ring_desc(ring, seq);
+
+    *slot_desc = *desc;
+    slot_desc->seq = seq;
+    __atomic_store_n(&ring->write_seq, seq + 1, __ATOMIC_SEQ_CST);
+    __atomic_fetch_add(&ring->published, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&ring->notify, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->waiters, __ATOMIC_SEQ_CST) > 0) {
+        futex_wake_all(&ring->notify);
+    }
+}
+
+void ring_close(ring_header_t *ring) {
+    __atomic_store_n(&ring->closed, 1, __ATOMIC_SEQ_CST);
+    __atomic_fetch_add(&ring->notify, 1, __ATOMIC_SEQ_CST);
+    futex_wake_all(&ring->notify);
+}
+
+int ring_attach(ring_header_t *ring, uint32_t pid, uint64_t *token) {
+    ring_consumer_t *consumers = ring_consumers(ring);
+    uint64_t mine = __atomic_add_fetch(&ring->last_token, 1, __ATOMIC_ACQ_REL);
+
+    for (uint32_t i = 0; i < ring->max_consumers; i++) {
+        uint64_t free_token = 0;
+        if (__atomic_compare_exchange_n(&consumers[i].token, &free_token, mine, 0, __ATOMIC_ACQ_REL,
+                                        __ATOMIC_RELAXED)) {
+            // A stale cursor left here only makes the producer drop early
+            __atomic_store_n(&consumers[i].pid, pid, __ATOMIC_RELAXED);
+            __atomic_store_n(&consumers[i].read_seq, __atomic_load_n(&ring->write_seq, __ATOMIC_ACQUIRE),
+                             __ATOMIC_RELEASE);
+            *token = mine;
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+void ring_detach(ring_header_t *ring, int consumer, uint64_t token) {
+    __atomic_compare_exchange_n(&ring_consumers(ring)[consumer].token, &token, 0, 0, __ATOMIC_ACQ_REL,
+                                __ATOMIC_RELAXED);
+}
+
+int ring_heartbeat(ring_header_t *ring, int consumer, uint64_t token) {
+    ring_consumer_t *self = &ring_consumers(ring)[consumer];
+
+    if (__atomic_load_n(&self->token, __ATOMIC_ACQUIRE) != token) {
+        return -1;
+    }
+    __atomic_fetch_add(&self->heartbeat, 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+int ring_wait(ring_header_t *ring, int consumer, uint64_t token, int64_t timeout_ms) {
+    ring_consumer_t *self = &ring_consumers(ring)[consumer];
+    int64_t deadline = timeout_ms >= 0 ? monotonic_ms() + timeout_ms : -1;
+
+    for (;;) {
+        if (__atomic_load_n(&self->token, __ATOMIC_ACQUIRE) != token) {
+            return -2;
+        }
+        uint32_t seen = __atomic_load_n(&ring->notify, __ATOMIC_SEQ_CST);
+        uint64_t read_seq = __atomic_load_n(&self->read_seq, __ATOMIC_RELAXED);
+        if (read_seq < __atomic_load_n(&ring->write_seq, __ATOMIC_SEQ_CST)) {
+            return 1;
+        }
+        if (__atomic_load_n(&ring->closed, __ATOMIC_SEQ_CST)) {
+            return -1;
+        }
+
+        int64_t remaining = -1;
+        if (deadline >= 0) {
+            remaining = deadline - monotonic_ms();
+            if (remaining <= 0) {
+                return 0;
+            }
+        }
+
+        __atomic_fetch_add(&ring->waiters, 1, __ATOMIC_SEQ_CST);
+        if (read_seq >= __atomic_load_n(&ring->write_seq, __ATOMIC_SEQ_CST) &&
+            !__atomic_load_n(&ring->closed, __ATOMIC_SEQ_CST)) {
+            futex_wait(&ring->notify, seen, remaining);
+        }
+        __atomic_fetch_sub(&ring->waiters, 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+int ring_release(ring_header_t *ring, int consumer, uint64_t token, uint64_t seq) {
+    ring_consumer_t *self = &ring_consumers(ring)[consumer];
+
+    if (__atomic_load_n(&self->token, __ATOMIC_ACQUIRE) != token) {
+        return -1;
+    }
+    // Cursors only move forward and a reattached one starts past every
+    // slot the old owner held, so a compare-exchange from seq cannot land
+    // on a cursor that was reclaimed after the check above
+    uint64_t expected = seq;
+    return __atomic_compare_exchange_n(&self->read_seq, &expected, seq + 1, 0, __ATOMIC_ACQ_REL,
+                                       __ATOMIC_RELAXED) ? 0 : -1;
+}
@@ -0,0 +1,122 @@
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Constants
+#define RING_MAGIC 0x474e5246u  // "FRNG"
+#define RING_VERSION 2
+#define RING_CONSUMERS_OFFSET 256
+#define RING_DESC_SIZE 64
+#define RING_SLOT_ALIGN 4096
+#define RING_MAX_SLOTS 1024
+#define RING_MAX_CONSUMERS 64
+#define RING_HEARTBEAT_MS 100
+#define RING_DEFAULT_CONSUMER_TIMEOUT_MS 2000
+
+// Shared segment layout:
+//   header            (offset 0)
+//   consumer table    (RING_CONSUMERS_OFFSET, 64 bytes per consumer)
+//   slot descriptors  (64 bytes per slot)
+//   slot data         (data_offset, page-aligned, slot_stride apart)
+// One producer publishes sequence numbers 0, 1, 2, ... into slot seq %
+// slot_count. Every attached consumer owns a read cursor; a slot is only
+// reused once all live cursors have moved past it, so readers can work on
+// the mapped bytes in place. When a slot is still held the producer drops
+// the frame instead of waiting.
+//
+// Consumers may sit in other containers with their own PID namespace, so
+// liveness is not judged by pid: each cursor carries the token it was
+// attached with and a heartbeat counter the owner keeps bumping. The
+// producer reclaims a cursor that holds it up only after the heartbeat
+// has not moved for consumer_timeout_ms on the producer's own clock, and
+// the old owner's later release or wait sees its token gone and fails
+// instead of moving the new owner's cursor.
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t max_consumers;
+    uint64_t slot_size;    // Usable bytes per slot
+    uint64_t slot_stride;
+    uint64_t data_offset;
+    uint64_t total_size;
+    uint32_t producer_pid;
+    uint32_t closed;       // Set once by the producer; readers drain then stop
+    uint64_t write_seq __attribute__((aligned(64)));  // Next sequence to publish
+    uint32_t notify __attribute__((aligned(64)));     // Futex word, bumped per publish
+    uint32_t waiters;      // Consumers parked on notify
+    uint64_t published __attribute__((aligned(64)));
+    uint64_t dropped;
+    uint64_t last_token;   // Tokens handed out by ring_attach
+    uint32_t consumer_timeout_ms;
+} ring_header_t;
+
+typedef struct {
+    uint64_t token;        // 0 when the entry is free
+    uint64_t read_seq;     // Next sequence to read; everything before is released
+    uint64_t heartbeat;    // Bumped by the owner every RING_HEARTBEAT_MS
+    uint32_t pid;          // Owner's pid in its own namespace, for diagnostics only
+    uint32_t reserved;
+    // Written by the producer only: the heartbeat it last saw change, and when
+    uint64_t seen_token;
+    uint64_t seen_heartbeat;
+    int64_t seen_ms;
+    uint8_t pad[8];
+} ring_consumer_t;
+
+typedef struct {
+    uint64_t seq;
+    uint64_t length;
+    int64_t timestamp_us;
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;
+    uint32_t flags;
+    uint8_t reserved[24];
+} ring_desc_t;
+
+// Total segment size for a geometry; 0 if it is out of range
+size_t ring_layout_size(uint32_t slot_count, uint64_t slot_size, uint32_t max_consumers);
+void ring_init(void *base, uint32_t slot_count, uint64_t slot_size, uint32_t max_consumers,
+               uint32_t producer_pid, uint32_t consumer_timeout_ms);
+// -1 if base[0:mapped] is not a ring of this version
+int ring_validate(const void *base, size_t mapped);
+
+static inline ring_consumer_t* ring_consumers(ring_header_t *ring) {
+    return (ring_consumer_t*)((uint8_t*)ring + RING_CONSUMERS_OFFSET);
+}
+
+static inline ring_desc_t* ring_desc(ring_header_t *ring, uint64_t seq) {
+    uint8_t *descs = (uint8_t*)ring + RING_CONSUMERS_OFFSET + (size_t)ring->max_consumers * sizeof(ring_consumer_t);
+    return (ring_desc_t*)(descs + (size_t)(seq % ring->slot_count) * RING_DESC_SIZE);
+}
+
+static inline uint8_t* ring_slot(ring_header_t *ring, uint64_t seq) {
+    return (uint8_t*)ring + ring->data_offset + (size_t)(seq % ring->slot_count) * ring->slot_stride;
+}
+
+// Producer side. ring_reserve returns the slot for the next sequence, or
+// NULL (and counts a drop) while a consumer still holds it; cursors whose
+// heartbeat has stalled are reclaimed first.
+uint8_t* ring_reserve(ring_header_t *ring, uint64_t *seq);
+void ring_commit(ring_header_t *ring, uint64_t seq, const ring_desc_t *desc);
+void ring_close(ring_header_t *ring);
+
+// Consumer side. ring_attach claims a cursor at the current write position
+// and returns its index with its token, or -1 when the table is full. The
+// owner must call ring_heartbeat every RING_HEARTBEAT_MS while attached,
+// including while it works on a frame.
+int ring_attach(ring_header_t *ring, uint32_t pid, uint64_t *token);
+void ring_detach(ring_header_t *ring, int consumer, uint64_t token);
+// 0, or -1 once the producer has reclaimed the cursor
+int ring_heartbeat(ring_header_t *ring, int consumer, uint64_t token);
+// Block until the cursor has a frame: 1 ready, 0 timed out, -1 producer
+// closed and nothing left, -2 cursor reclaimed. timeout_ms < 0 waits
+// indefinitely.
+int ring_wait(ring_header_t *ring, int consumer, uint64_t token, int64_t timeout_ms);
+// Releases seq, the frame at the cursor; -1 if the cursor was reclaimed
+int ring_release(ring_header_t *ring, int consumer, uint64_t token, uint64_t seq);
+
+#endif // SHM_RING_H
@@ -0,0 +1,13 @@
+# Mempool Module
+# Fee-indexed pending transaction pool
+
+"""
+File: /app/apps/mempool/__init__.py
+x-lucid-file-path: /app/apps/mempool/__init__.py
+x-lucid-file-type: python
+
+Mempool package for Lucid RDP.
+Contains the native fee-indexed mempool used by the transaction processor.
+"""
+
+__all__ = []
@@ -0,0 +1,51 @@
+#!/usr/bin/env python3
+"""
+File: /app/apps/mempool/setup.py
+x-lucid-file-path: /app/apps/mempool/setup.py
+x-lucid-file-type: python
+
+Setup script for native mempool extension
+"""
+
+from setuptools import setup, Extension
+
+# Define the extension module
+mempool_native = Extension(
+    'mempool_native',
+    sources=[
+        'src/mempool.c',
+        'src/fee_index.c'
+    ],
+    include_dirs=[
+        'src/'
+    ],
+    libraries=[],
+    library_dirs=[],
+    extra_compile_args=[
+        '-O3',
+        '-Wall',
+        '-Wextra',
+        '-std=c99',
+        '-fPIC'
+    ],
+    extra_link_args=['-shared']
+)
+
+setup(
+    name='mempool-native',
+    version='0.1.0',
+    description='Native mempool extension for Lucid RDP',
+    ext_modules=[mempool_native],
+    python_requires='>=3.8',
+    classifiers=[
+        'Development Status :: 3 - Alpha',
+        'Intended Audience :: Developers',
+        'License :: OSI Approved :: MIT License',
+        'Programming Language :: C',
+        'Programming Language :: Python :: 3',
+        'Programming Language :: Python :: 3.8',
+        'Programming Language :: Python :: 3.9',
+        'Programming Language :: Python :: 3.10',
+        'Programming Language :: Python :: 3.11',
+    ],
+)
@@ -0,0 +1,13 @@
+# Mempool Source Module
+# Mempool native source code components
+
+"""
+File: /app/apps/mempool/src/__init__.py
+x-lucid-file-path: /app/apps/mempool/src/__init__.py
+x-lucid-file-type: python
+
+Mempool Source package for Lucid RDP.
+Contains mempool native source code and C implementations.
+"""
+
+__all__ = []
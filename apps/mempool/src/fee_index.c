@@ -0,0 +1,342 @@
+#include <stdlib.h>
+#include <string.h>
+#include "fee_index.h"
+
+void mp_pool_init(mp_pool_t *pool) {
+    memset(pool, 0, sizeof(*pool));
+}
+
+void mp_pool_free(mp_pool_t *pool) {
+    for (uint32_t i = 0; i < pool->queue_high; i++) {
+        free(pool->queues[i].entries);
+    }
+    free(pool->entries);
+    free(pool->free_entries);
+    free(pool->heap);
+    free(pool->queues);
+    free(pool->free_queues);
+    memset(pool, 0, sizeof(*pool));
+}
+
+static uint32_t grown_capacity(uint32_t capacity, uint32_t needed) {
+    uint32_t next = capacity ? capacity : 64;
+    while (next < needed) {
+        next *= 2;
+    }
+    return next;
+}
+
+static int resize(void **array, size_t count, size_t item_size) {
+    void *resized = realloc(*array, count * item_size);
+    if (resized == NULL) {
+        return -1;
+    }
+    *array = resized;
+    return 0;
+}
+
+// Entries, the heap and the entry free list always share one capacity
+static int reserve_entries(mp_pool_t *pool, uint32_t needed) {
+    if (needed <= pool->entry_capacity) {
+        return 0;
+    }
+    uint32_t next = grown_capacity(pool->entry_capacity, needed);
+    if (resize((void**)&pool->entries, next, sizeof(mp_entry_t)) != 0 ||
+        resize((void**)&pool->heap, next, sizeof(uint32_t)) != 0 ||
+        resize((void**)&pool->free_entries, next, sizeof(uint32_t)) != 0) {
+        return -1;
+    }
+    pool->entry_capacity = next;
+    return 0;
+}
+
+// Likewise for sender queues and their free list
+static int reserve_queues(mp_pool_t *pool, uint32_t needed) {
+    if (needed <= pool->queue_capacity) {
+        return 0;
+    }
+    uint32_t next = grown_capacity(pool->queue_capacity, needed);
+    if (resize((void**)&pool->queues, next, sizeof(mp_queue_t)) != 0 ||
+        resize((void**)&pool->free_queues, next, sizeof(uint32_t)) != 0) {
+        return -1;
+    }
+    pool->queue_capacity = next;
+    return 0;
+}
+
+static int reserve_queue(mp_queue_t *queue, uint32_t needed) {
+    if (needed <= queue->capacity) {
+        return 0;
+    }
+    // Most senders only ever have a handful pending
+    uint32_t next = queue->capacity ? queue->capacity * 2 : 4;
+    while (next < needed) {
+        next *= 2;
+    }
+    if (resize((void**)&queue->entries, next, sizeof(uint32_t)) != 0) {
+        return -1;
+    }
+    queue->capacity = next;
+    return 0;
+}
+
+// Eviction order: lower fee rate first, and the newer of two equal rates
+static int evicts_before(const mp_entry_t *a, const mp_entry_t *b) {
+    if (a->fee_rate != b->fee_rate) {
+        return a->fee_rate < b->fee_rate;
+    }
+    return a->seq > b->seq;
+}
+
+// Selection order: higher fee rate first, and the older of two equal rates
+static int selects_before(const mp_entry_t *a, const mp_entry_t *b) {
+    if (a->fee_rate != b->fee_rate) {
+        return a->fee_rate > b->fee_rate;
+    }
+    return a->seq < b->seq;
+}
+
+static void heap_place(mp_pool_t *pool, uint32_t pos, uint32_t id) {
+    pool->heap[pos] = id;
+    pool->entries[id].heap_pos = pos;
+}
+
+static void heap_sift_up(mp_pool_t *pool, uint32_t pos) {
+    uint32_t id = pool->heap[pos];
+    while (pos > 0) {
+        uint32_t parent = (pos - 1) / 2;
+        if (!evicts_before(&pool->entries[id], &pool->entries[pool->heap[parent]])) {
+            break;
+        }
+        heap_place(pool, pos, pool->heap[parent]);
+        pos = parent;
+    }
+    heap_place(pool, pos, id);
+}
+
+static void heap_sift_down(mp_pool_t *pool, uint32_t pos) {
+    uint32_t id = pool->heap[pos];
+    for (;;) {
+        uint32_t child = pos * 2 + 1;
+        if (child >= pool->count) {
+            break;
+        }
+        if (child + 1 < pool->count &&
+            evicts_before(&pool->entries[pool->heap[child + 1]], &pool->entries[pool->heap[child]])) {
+            child++;
+        }
+        if (!evicts_before(&pool->entries[pool->heap[child]], &pool->entries[id])) {
+            break;
+        }
+        heap_place(pool, pos, pool->heap[child]);
+        pos = child;
+    }
+    heap_place(pool, pos, id);
+}
+
+uint32_t mp_sender_alloc(mp_pool_t *pool, void *key) {
+    uint32_t slot;
+    if (pool->free_queue_count > 0) {
+        slot = pool->free_queues[--pool->free_queue_count];
+    } else {
+        if (reserve_queues(pool, pool->queue_high + 1) != 0) {
+            return MP_NONE;
+        }
+        slot = pool->queue_high++;
+        memset(&pool->queues[slot], 0, sizeof(mp_queue_t));
+    }
+    pool->queues[slot].count = 0;
+    pool->queues[slot].key = key;
+    pool->sender_count++;
+    return slot;
+}
+
+void mp_sender_release(mp_pool_t *pool, uint32_t slot) {
+    pool->queues[slot].key = NULL;
+    pool->free_queues[pool->free_queue_count++] = slot;
+    pool->sender_count--;
+}
+
+// Index of the first queued entry with nonce >= the given one
+static uint32_t queue_lower_bound(const mp_pool_t *pool, const mp_queue_t *queue, uint64_t nonce) {
+    uint32_t lo = 0;
+    uint32_t hi = queue->count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (pool->entries[queue->entries[mid]].nonce < nonce) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+uint32_t mp_queue_find(const mp_pool_t *pool, uint32_t sender, uint64_t nonce) {
+    const mp_queue_t *queue = &pool->queues[sender];
+    uint32_t pos = queue_lower_bound(pool, queue, nonce);
+    if (pos < queue->count && pool->entries[queue->entries[pos]].nonce == nonce) {
+        return queue->entries[pos];
+    }
+    return MP_NONE;
+}
+
+uint64_t mp_queue_next_nonce(const mp_pool_t *pool, uint32_t sender) {
+    const mp_queue_t *queue = &pool->queues[sender];
+    if (queue->count == 0) {
+        return 0;
+    }
+    return pool->entries[queue->entries[queue->count - 1]].nonce + 1;
+}
+
+uint32_t mp_insert(mp_pool_t *pool, uint32_t sender, uint64_t nonce, double fee,
+                   uint32_t size, void *key) {
+    mp_queue_t *queue = &pool->queues[sender];
+    uint32_t id;
+
+    // Reserve everything first so a failed allocation leaves the pool intact
+    if (reserve_queue(queue, queue->count + 1) != 0) {
+        return MP_NONE;
+    }
+    if (pool->free_entry_count > 0) {
+        id = pool->free_entries[--pool->free_entry_count];
+    } else {
+        if (reserve_entries(pool, pool->entry_high + 1) != 0) {
+            return MP_NONE;
+        }
+        id = pool->entry_high++;
+    }
+
+    mp_entry_t *entry = &pool->entries[id];
+    entry->fee_rate = fee / (double)size;
+    entry->fee = fee;
+    entry->nonce = nonce;
+    entry->seq = pool->next_seq++;
+    entry->size = size;
+    entry->sender = sender;
+    entry->in_use = 1;
+    entry->key = key;
+
+    uint32_t pos = queue_lower_bound(pool, queue, nonce);
+    memmove(queue->entries + pos + 1, queue->entries + pos, (size_t)(queue->count - pos) * sizeof(uint32_t));
+    queue->entries[pos] = id;
+    queue->count++;
+
+    pool->heap[pool->count] = id;
+    entry->heap_pos = pool->count;
+    pool->count++;
+    heap_sift_up(pool, entry->heap_pos);
+
+    pool->total_bytes += size;
+    pool->total_fee += fee;
+    return id;
+}
+
+int mp_remove(mp_pool_t *pool, uint32_t id) {
+    mp_entry_t *entry = &pool->entries[id];
+    mp_queue_t *queue = &pool->queues[entry->sender];
+
+    // Heap: move the last element into the hole and restore order
+    uint32_t pos = entry->heap_pos;
+    pool->count--;
+    if (pos != pool->count) {
+        heap_place(pool, pos, pool->heap[pool->count]);
+        heap_sift_up(pool, pos);
+        heap_sift_down(pool, pos);
+    }
+
+    uint32_t qpos = queue_lower_bound(pool, queue, entry->nonce);
+    memmove(queue->entries + qpos, queue->entries + qpos + 1, (size_t)(queue->count - qpos - 1) * sizeof(uint32_t));
+    queue->count--;
+
+    pool->total_bytes -= entry->size;
+    pool->total_fee -= entry->fee;
+    entry->in_use = 0;
+    entry->key = NULL;
+    pool->free_entries[pool->free_entry_count++] = id;
+
+    if (queue->count == 0) {
+        mp_sender_release(pool, entry->sender);
+        return 1;
+    }
+    return 0;
+}
+
+uint32_t mp_lowest(const mp_pool_t *pool) {
+    return pool->count ? pool->heap[0] : MP_NONE;
+}
+
+typedef struct {
+    uint32_t entry;
+    uint32_t queue_pos;
+} select_head_t;
+
+static void select_sift_down(const mp_pool_t *pool, select_head_t *heap, size_t count, size_t pos) {
+    select_head_t item = heap[pos];
+    for (;;) {
+        size_t child = pos * 2 + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count &&
+            selects_before(&pool->entries[heap[child + 1].entry], &pool->entries[heap[child].entry])) {
+            child++;
+        }
+        if (!selects_before(&pool->entries[heap[child].entry], &pool->entries[item.entry])) {
+            break;
+        }
+        heap[pos] = heap[child];
+        pos = child;
+    }
+    heap[pos] = item;
+}
+
+ptrdiff_t mp_select(const mp_pool_t *pool, uint64_t max_bytes, size_t max_count, uint32_t *out) {
+    size_t heads = 0;
+    size_t chosen = 0;
+    uint64_t used = 0;
+
+    select_head_t *heap = malloc((size_t)(pool->sender_count ? pool->sender_count : 1) * sizeof(select_head_t));
+    if (heap == NULL) {
+        return -1;
+    }
+
+    // Only the lowest nonce of each sender is selectable at first
+    for (uint32_t slot = 0; slot < pool->queue_high; slot++) {
+        if (pool->queues[slot].count > 0) {
+            heap[heads].entry = pool->queues[slot].entries[0];
+            heap[heads].queue_pos = 0;
+            heads++;
+        }
+    }
+    for (size_t i = heads / 2; i-- > 0;) {
+        select_sift_down(pool, heap, heads, i);
+    }
+
+    while (heads > 0 && chosen < max_count) {
+        const mp_entry_t *best = &pool->entries[heap[0].entry];
+        const mp_queue_t *queue = &pool->queues[best->sender];
+
+        if (used + best->size > max_bytes) {
+            // Later nonces depend on this one, so the sender is done
+            heap[0] = heap[--heads];
+        } else {
+            out[chosen++] = heap[0].entry;
+            used += best->size;
+
+            uint32_t next = heap[0].queue_pos + 1;
+            if (next < queue->count && pool->entries[queue->entries[next]].nonce == best->nonce + 1) {
+                heap[0].entry = queue->entries[next];
+                heap[0].queue_pos = next;
+            } else {
+                heap[0] = heap[--heads];
+            }
+        }
+        if (heads > 0) {
+            select_sift_down(pool, heap, heads, 0);
+        }
+    }
+
+    free(heap);
+    return (ptrdiff_t)chosen;
+}
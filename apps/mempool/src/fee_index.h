@@ -0,0 +1,79 @@
+#ifndef FEE_INDEX_H
+#define FEE_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MP_NONE UINT32_MAX
+
+// One pending transaction. key is an opaque handle owned by the caller.
+typedef struct {
+    double fee_rate;  // fee per byte, the ordering key
+    double fee;
+    uint64_t nonce;
+    uint64_t seq;     // arrival order, breaks fee rate ties
+    uint32_t size;
+    uint32_t sender;
+    uint32_t heap_pos;
+    int in_use;
+    void *key;
+} mp_entry_t;
+
+// Transactions of one sender, sorted by nonce
+typedef struct {
+    uint32_t *entries;
+    uint32_t count;
+    uint32_t capacity;
+    void *key;  // Opaque sender handle owned by the caller
+} mp_queue_t;
+
+// Fee-rate indexed pool. The eviction heap is a min-heap over every entry
+// with back-pointers, so the cheapest entry is found in O(1) and any entry
+// is removed in O(log n). Per-sender queues keep nonce order for selection.
+typedef struct {
+    mp_entry_t *entries;
+    uint32_t entry_capacity;
+    uint32_t entry_high;
+    uint32_t *free_entries;
+    uint32_t free_entry_count;
+
+    uint32_t *heap;
+    uint32_t count;
+
+    mp_queue_t *queues;
+    uint32_t queue_capacity;
+    uint32_t queue_high;
+    uint32_t *free_queues;
+    uint32_t free_queue_count;
+    uint32_t sender_count;
+
+    uint64_t next_seq;
+    uint64_t total_bytes;
+    double total_fee;
+} mp_pool_t;
+
+void mp_pool_init(mp_pool_t *pool);
+void mp_pool_free(mp_pool_t *pool);
+
+// Sender queues; a slot is released when its last entry is removed
+uint32_t mp_sender_alloc(mp_pool_t *pool, void *key);
+void mp_sender_release(mp_pool_t *pool, uint32_t slot);
+uint32_t mp_queue_find(const mp_pool_t *pool, uint32_t sender, uint64_t nonce);
+uint64_t mp_queue_next_nonce(const mp_pool_t *pool, uint32_t sender);
+
+// Returns the new entry id, or MP_NONE when out of memory
+uint32_t mp_insert(mp_pool_t *pool, uint32_t sender, uint64_t nonce, double fee,
+                   uint32_t size, void *key);
+
+// Returns 1 if this emptied and released the sender's queue
+int mp_remove(mp_pool_t *pool, uint32_t id);
+
+// Cheapest entry, newest first among equal fee rates
+uint32_t mp_lowest(const mp_pool_t *pool);
+
+// Highest fee rate first, never taking a nonce before its predecessor and
+// stopping a sender at a nonce gap. Writes up to max_count ids to out and
+// returns how many were chosen, or -1 when out of memory.
+ptrdiff_t mp_select(const mp_pool_t *pool, uint64_t max_bytes, size_t max_count, uint32_t *out);
+
+#endif // FEE_INDEX_H
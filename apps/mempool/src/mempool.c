@@ -0,0 +1,473 @@
+/*
+ * Native mempool extension for Lucid RDP
+ * Keeps pending transactions indexed by fee rate for O(log n) admission
+ * and eviction, with per-sender nonce queues for block template selection
+ */
+
+#include <Python.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "mempool.h"
+#include "fee_index.h"
+
+typedef struct {
+    PyObject_HEAD
+    mp_pool_t pool;
+    PyObject *keys;     // key -> entry id
+    PyObject *senders;  // sender -> queue slot
+    Py_ssize_t max_size;
+    double replace_bump;
+} MempoolObject;
+
+static PyTypeObject MempoolType;
+
+// Forward declarations
+static PyObject* Mempool_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
+static int Mempool_init(MempoolObject *self, PyObject *args, PyObject *kwds);
+static void Mempool_dealloc(MempoolObject *self);
+static PyObject* Mempool_add(MempoolObject *self, PyObject *args, PyObject *kwds);
+static PyObject* Mempool_remove(MempoolObject *self, PyObject *args);
+static PyObject* Mempool_lowest(MempoolObject *self, PyObject *args);
+static PyObject* Mempool_select_for_block(MempoolObject *self, PyObject *args, PyObject *kwds);
+static PyObject* Mempool_next_nonce(MempoolObject *self, PyObject *args);
+static PyObject* Mempool_sender_keys(MempoolObject *self, PyObject *args);
+static Py_ssize_t Mempool_length(MempoolObject *self);
+static int Mempool_contains(MempoolObject *self, PyObject *key);
+
+// Method definitions
+static PyMethodDef Mempool_methods[] = {
+    {"add", (PyCFunction)(void(*)(void))Mempool_add, METH_VARARGS | METH_KEYWORDS,
+     "Admit a transaction; returns the keys it evicted or replaced"},
+    {"remove", (PyCFunction)Mempool_remove, METH_VARARGS, "Remove a transaction; returns False if it was not pending"},
+    {"lowest", (PyCFunction)Mempool_lowest, METH_NOARGS, "Key of the next transaction to evict, or None"},
+    {"select_for_block", (PyCFunction)(void(*)(void))Mempool_select_for_block, METH_VARARGS | METH_KEYWORDS,
+     "Keys for a block template, highest fee rate first in nonce order"},
+    {"next_nonce", (PyCFunction)Mempool_next_nonce, METH_VARARGS, "Nonce after the sender's last pending transaction"},
+    {"sender_keys", (PyCFunction)Mempool_sender_keys, METH_VARARGS, "Keys pending for a sender in nonce order"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyObject* Mempool_get_min_fee_rate(MempoolObject *self, void *closure) {
+    uint32_t id = mp_lowest(&self->pool);
+    return PyFloat_FromDouble(id == MP_NONE ? 0.0 : self->pool.entries[id].fee_rate);
+}
+
+static PyObject* Mempool_get_total_bytes(MempoolObject *self, void *closure) {
+    return PyLong_FromUnsignedLongLong(self->pool.total_bytes);
+}
+
+static PyObject* Mempool_get_total_fee(MempoolObject *self, void *closure) {
+    return PyFloat_FromDouble(self->pool.count ? self->pool.total_fee : 0.0);
+}
+
+static PyObject* Mempool_get_sender_count(MempoolObject *self, void *closure) {
+    return PyLong_FromUnsignedLong(self->pool.sender_count);
+}
+
+static PyObject* Mempool_get_max_size(MempoolObject *self, void *closure) {
+    return PyLong_FromSsize_t(self->max_size);
+}
+
+static PyGetSetDef Mempool_getset[] = {
+    {"min_fee_rate", (getter)Mempool_get_min_fee_rate, NULL, "Fee rate a new transaction must beat when full", NULL},
+    {"total_bytes", (getter)Mempool_get_total_bytes, NULL, "Size of all pending transactions", NULL},
+    {"total_fee", (getter)Mempool_get_total_fee, NULL, "Fees of all pending transactions", NULL},
+    {"sender_count", (getter)Mempool_get_sender_count, NULL, "Senders with pending transactions", NULL},
+    {"max_size", (getter)Mempool_get_max_size, NULL, "Pending transaction limit", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PySequenceMethods Mempool_as_sequence = {
+    .sq_length = (lenfunc)Mempool_length,
+    .sq_contains = (objobjproc)Mempool_contains,
+};
+
+// Type definition
+static PyTypeObject MempoolType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "mempool_native.Mempool",
+    .tp_doc = "Fee-rate indexed transaction pool with per-sender nonce queues",
+    .tp_basicsize = sizeof(MempoolObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = Mempool_new,
+    .tp_init = (initproc)Mempool_init,
+    .tp_dealloc = (destructor)Mempool_dealloc,
+    .tp_methods = Mempool_methods,
+    .tp_getset = Mempool_getset,
+    .tp_as_sequence = &Mempool_as_sequence,
+};
+
+static PyObject* Mempool_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
+    MempoolObject *self = (MempoolObject*)type->tp_alloc(type, 0);
+    if (self == NULL) {
+        return NULL;
+    }
+
+    mp_pool_init(&self->pool);
+    self->keys = PyDict_New();
+    self->senders = PyDict_New();
+    if (self->keys == NULL || self->senders == NULL) {
+        Py_DECREF(self);
+        return NULL;
+    }
+    self->max_size = DEFAULT_MAX_SIZE;
+    self->replace_bump = DEFAULT_REPLACE_BUMP;
+    return (PyObject*)self;
+}
+
+static int Mempool_init(MempoolObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"max_size", "replace_bump", NULL};
+    Py_ssize_t max_size = DEFAULT_MAX_SIZE;
+    double replace_bump = DEFAULT_REPLACE_BUMP;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|nd", kwlist, &max_size, &replace_bump)) {
+        return -1;
+    }
+    if (max_size < 1 || max_size > (Py_ssize_t)(MP_NONE - 1)) {
+        PyErr_SetString(PyExc_ValueError, "Invalid max_size");
+        return -1;
+    }
+    if (replace_bump < 0.0) {
+        PyErr_SetString(PyExc_ValueError, "replace_bump must not be negative");
+        return -1;
+    }
+    if (self->pool.count > 0) {
+        PyErr_SetString(PyExc_RuntimeError, "Mempool already holds transactions");
+        return -1;
+    }
+
+    self->max_size = max_size;
+    self->replace_bump = replace_bump;
+    return 0;
+}
+
+static void Mempool_dealloc(MempoolObject *self) {
+    for (uint32_t id = 0; id < self->pool.entry_high; id++) {
+        if (self->pool.entries[id].in_use) {
+            Py_DECREF((PyObject*)self->pool.entries[id].key);
+        }
+    }
+    for (uint32_t slot = 0; slot < self->pool.queue_high; slot++) {
+        Py_XDECREF((PyObject*)self->pool.queues[slot].key);
+    }
+    mp_pool_free(&self->pool);
+    Py_XDECREF(self->keys);
+    Py_XDECREF(self->senders);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static Py_ssize_t Mempool_length(MempoolObject *self) {
+    return (Py_ssize_t)self->pool.count;
+}
+
+static int Mempool_contains(MempoolObject *self, PyObject *key) {
+    return PyDict_Contains(self->keys, key);
+}
+
+// Entry id for a key, MP_NONE if absent, or -1 on error
+static int64_t lookup(PyObject *dict, PyObject *key) {
+    PyObject *value = PyDict_GetItemWithError(dict, key);
+    if (value == NULL) {
+        return PyErr_Occurred() ? -1 : (int64_t)MP_NONE;
+    }
+    return (int64_t)PyLong_AsUnsignedLong(value);
+}
+
+// Drops an entry and, with its last transaction, the sender's mapping
+static int remove_entry(MempoolObject *self, uint32_t id) {
+    mp_entry_t *entry = &self->pool.entries[id];
+    PyObject *key = (PyObject*)entry->key;
+    PyObject *sender = (PyObject*)self->pool.queues[entry->sender].key;
+
+    if (PyDict_DelItem(self->keys, key) < 0) {
+        return -1;
+    }
+    if (mp_remove(&self->pool, id)) {
+        int result = PyDict_DelItem(self->senders, sender);
+        Py_DECREF(sender);
+        if (result < 0) {
+            Py_DECREF(key);
+            return -1;
+        }
+    }
+    Py_DECREF(key);
+    return 0;
+}
+
+// Moves the key into the evicted list, then removes the entry
+static int evict_entry(MempoolObject *self, uint32_t id, PyObject *evicted) {
+    if (PyList_Append(evicted, (PyObject*)self->pool.entries[id].key) < 0) {
+        return -1;
+    }
+    return remove_entry(self, id);
+}
+
+static PyObject* Mempool_add(MempoolObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"key", "sender", "nonce", "fee", "size", NULL};
+    PyObject *key;
+    PyObject *sender;
+    unsigned long long nonce;
+    double fee;
+    Py_ssize_t size;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOKdn", kwlist, &key, &sender, &nonce, &fee, &size)) {
+        return NULL;
+    }
+    if (size <= 0 || size > (Py_ssize_t)UINT32_MAX) {
+        PyErr_SetString(PyExc_ValueError, "Invalid transaction size");
+        return NULL;
+    }
+    if (!(fee >= 0.0)) {
+        PyErr_SetString(PyExc_ValueError, "Invalid transaction fee");
+        return NULL;
+    }
+
+    int present = PyDict_Contains(self->keys, key);
+    if (present != 0) {
+        if (present > 0) {
+            PyErr_SetString(PyExc_ValueError, "Transaction already in mempool");
+        }
+        return NULL;
+    }
+
+    double fee_rate = fee / (double)size;
+    int64_t slot = lookup(self->senders, sender);
+    if (slot < 0) {
+        return NULL;
+    }
+    uint32_t existing = slot == MP_NONE ? MP_NONE : mp_queue_find(&self->pool, (uint32_t)slot, nonce);
+
+    // Everything that can reject the transaction runs before the pool changes
+    uint32_t lowest = MP_NONE;
+    if (existing != MP_NONE) {
+        if (fee_rate < self->pool.entries[existing].fee_rate * (1.0 + self->replace_bump)) {
+            PyErr_SetString(PyExc_ValueError, "Replacement fee rate too low");
+            return NULL;
+        }
+    } else if ((Py_ssize_t)self->pool.count >= self->max_size) {
+        lowest = mp_lowest(&self->pool);
+        if (fee_rate <= self->pool.entries[lowest].fee_rate) {
+            PyErr_SetString(PyExc_ValueError, "Mempool full: fee rate below minimum");
+            return NULL;
+        }
+    }
+
+    PyObject *evicted = PyList_New(0);
+    if (evicted == NULL) {
+        return NULL;
+    }
+
+    if (existing != MP_NONE) {
+        if (evict_entry(self, existing, evicted) < 0) {
+            Py_DECREF(evicted);
+            return NULL;
+        }
+    } else if (lowest != MP_NONE) {
+        // Later nonces of the evicted sender can never execute without it
+        mp_queue_t *queue = &self->pool.queues[self->pool.entries[lowest].sender];
+        uint64_t from = self->pool.entries[lowest].nonce;
+        while (queue->count > 0 && self->pool.entries[queue->entries[queue->count - 1]].nonce >= from) {
+            if (evict_entry(self, queue->entries[queue->count - 1], evicted) < 0) {
+                Py_DECREF(evicted);
+                return NULL;
+            }
+        }
+    }
+
+    // Eviction may have released the sender's slot, so look again
+    slot = lookup(self->senders, sender);
+    if (slot < 0) {
+        Py_DECREF(evicted);
+        return NULL;
+    }
+    if (slot == MP_NONE) {
+        slot = mp_sender_alloc(&self->pool, sender);
+        if (slot == MP_NONE) {
+            Py_DECREF(evicted);
+            return PyErr_NoMemory();
+        }
+        PyObject *value = PyLong_FromUnsignedLong((unsigned long)slot);
+        if (value == NULL || PyDict_SetItem(self->senders, sender, value) < 0) {
+            Py_XDECREF(value);
+            mp_sender_release(&self->pool, (uint32_t)slot);
+            Py_DECREF(evicted);
+            return NULL;
+        }
+        Py_DECREF(value);
+        Py_INCREF(sender);
+    }
+
+    uint32_t id = mp_insert(&self->pool, (uint32_t)slot, nonce, fee, (uint32_t)size, key);
+    PyObject *value = id == MP_NONE ? NULL : PyLong_FromUnsignedLong((unsigned long)id);
+    if (value == NULL || PyDict_SetItem(self->keys, key, value) < 0) {
+        Py_XDECREF(value);
+        if (id != MP_NONE) {
+            self->pool.entries[id].key = NULL;
+            mp_remove(&self->pool, id);
+        }
+        if (self->pool.queues[slot].count == 0) {
+            if (id == MP_NONE) {
+                mp_sender_release(&self->pool, (uint32_t)slot);
+            }
+            PyDict_DelItem(self->senders, sender);
+            Py_DECREF(sender);
+        }
+        Py_DECREF(evicted);
+        return id == MP_NONE && !PyErr_Occurred() ? PyErr_NoMemory() : NULL;
+    }
+    Py_DECREF(value);
+    Py_INCREF(key);
+
+    return evicted;
+}
+
+static PyObject* Mempool_remove(MempoolObject *self, PyObject *args) {
+    PyObject *key;
+
+    if (!PyArg_ParseTuple(args, "O", &key)) {
+        return NULL;
+    }
+
+    int64_t id = lookup(self->keys, key);
+    if (id < 0) {
+        return NULL;
+    }
+    if (id == MP_NONE) {
+        Py_RETURN_FALSE;
+    }
+    if (remove_entry(self, (uint32_t)id) < 0) {
+        return NULL;
+    }
+    Py_RETURN_TRUE;
+}
+
+static PyObject* Mempool_lowest(MempoolObject *self, PyObject *args) {
+    uint32_t id = mp_lowest(&self->pool);
+    if (id == MP_NONE) {
+        Py_RETURN_NONE;
+    }
+    PyObject *key = (PyObject*)self->pool.entries[id].key;
+    Py_INCREF(key);
+    return key;
+}
+
+static PyObject* Mempool_select_for_block(MempoolObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"max_bytes", "max_count", NULL};
+    unsigned long long max_bytes;
+    Py_ssize_t max_count = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "K|n", kwlist, &max_bytes, &max_count)) {
+        return NULL;
+    }
+    if (max_count <= 0 || max_count > (Py_ssize_t)self->pool.count) {
+        max_count = (Py_ssize_t)self->pool.count;
+    }
+
+    uint32_t *chosen = PyMem_Malloc((size_t)(max_count ? max_count : 1) * sizeof(uint32_t));
+    if (chosen == NULL) {
+        return PyErr_NoMemory();
+    }
+
+    ptrdiff_t count = mp_select(&self->pool, max_bytes, (size_t)max_count, chosen);
+    if (count < 0) {
+        PyMem_Free(chosen);
+        return PyErr_NoMemory();
+    }
+
+    PyObject *result = PyList_New(count);
+    if (result != NULL) {
+        for (ptrdiff_t i = 0; i < count; i++) {
+            PyObject *key = (PyObject*)self->pool.entries[chosen[i]].key;
+            Py_INCREF(key);
+            PyList_SET_ITEM(result, i, key);
+        }
+    }
+    PyMem_Free(chosen);
+    return result;
+}
+
+static PyObject* Mempool_next_nonce(MempoolObject *self, PyObject *args) {
+    PyObject *sender;
+
+    if (!PyArg_ParseTuple(args, "O", &sender)) {
+        return NULL;
+    }
+
+    int64_t slot = lookup(self->senders, sender);
+    if (slot < 0) {
+        return NULL;
+    }
+    if (slot == MP_NONE) {
+        return PyLong_FromLong(0);
+    }
+    return PyLong_FromUnsignedLongLong(mp_queue_next_nonce(&self->pool, (uint32_t)slot));
+}
+
+static PyObject* Mempool_sender_keys(MempoolObject *self, PyObject *args) {
+    PyObject *sender;
+
+    if (!PyArg_ParseTuple(args, "O", &sender)) {
+        return NULL;
+    }
+
+    int64_t slot = lookup(self->senders, sender);
+    if (slot < 0) {
+        return NULL;
+    }
+    if (slot == MP_NONE) {
+        return PyList_New(0);
+    }
+
+    mp_queue_t *queue = &self->pool.queues[slot];
+    PyObject *result = PyList_New(queue->count);
+    if (result == NULL) {
+        return NULL;
+    }
+    for (uint32_t i = 0; i < queue->count; i++) {
+        PyObject *key = (PyObject*)self->pool.entries[queue->entries[i]].key;
+        Py_INCREF(key);
+        PyList_SET_ITEM(result, i, key);
+    }
+    return result;
+}
+
+static PyObject* mempool_version(PyObject *self, PyObject *args) {
+    return PyUnicode_FromString("0.1.0");
+}
+
+static PyMethodDef mempool_module_methods[] = {
+    {"version", mempool_version, METH_NOARGS, "Get version"},
+    {NULL, NULL, 0, NULL}
+};
+
+// Module definition
+static struct PyModuleDef mempool_module = {
+    PyModuleDef_HEAD_INIT,
+    "mempool_native",
+    "Native mempool extension for Lucid RDP",
+    -1,
+    mempool_module_methods
+};
+
+PyMODINIT_FUNC PyInit_mempool_native(void) {
+    if (PyType_Ready(&MempoolType) < 0) {
+        return NULL;
+    }
+
+    PyObject *m = PyModule_Create(&mempool_module);
+    if (m == NULL) {
+        return NULL;
+    }
+
+    Py_INCREF(&MempoolType);
+    if (PyModule_AddObject(m, "Mempool", (PyObject*)&MempoolType) < 0) {
+        Py_DECREF(&MempoolType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    PyModule_AddIntConstant(m, "DEFAULT_MAX_SIZE", DEFAULT_MAX_SIZE);
+
+    return m;
+}
@@ -0,0 +1,10 @@
+#ifndef MEMPOOL_H
+#define MEMPOOL_H
+
+#include <Python.h>
+
+// Constants
+#define DEFAULT_MAX_SIZE 10000
+#define DEFAULT_REPLACE_BUMP 0.10  // Same-nonce replacement must pay 10% more per byte
+
+#endif // MEMPOOL_H
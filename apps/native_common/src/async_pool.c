@@ -0,0 +1,600 @@
+#define _GNU_SOURCE
+
+#include "async_pool.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+#define ASYNC_POOL_CAPSULE "async_pool"
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    async_job_t *queue_head;  // Waiting for a worker
+    async_job_t *queue_tail;
+    async_job_t *done_head;   // Finished, not yet delivered
+    async_job_t *done_tail;
+    async_job_t *parked_head; // Over max_inflight
+    async_job_t *parked_tail;
+    size_t inflight;          // Handed to workers and not yet delivered
+    size_t parked;
+    size_t max_inflight;
+    size_t max_waiting;
+    int workers;
+    int started;
+    int stopping;
+    pid_t pid;                // Workers do not survive fork
+    pthread_t *threads;
+    int event_fd;
+    int wake_fd;              // Write end; equals event_fd for an eventfd
+    uint64_t submitted;
+    uint64_t completed;
+    uint64_t cancelled;       // Finished after their future was cancelled (atomic)
+    // Owned by the interpreter that created the pool
+    PyObject *get_running_loop;
+    PyObject *queue_full;     // asyncio.QueueFull
+    PyObject *deliver;        // Resolves a future on its own loop
+    PyObject *loops;          // WeakSet of loops watching event_fd
+} async_pool_t;
+
+static async_pool_t *pool_get(PyObject *capsule) {
+    return PyCapsule_GetPointer(capsule, ASYNC_POOL_CAPSULE);
+}
+
+static void job_push(async_job_t **head, async_job_t **tail, async_job_t *job) {
+    job->next = NULL;
+    if (*tail) {
+        (*tail)->next = job;
+    } else {
+        *head = job;
+    }
+    *tail = job;
+}
+
+static async_job_t *job_pop(async_job_t **head, async_job_t **tail) {
+    async_job_t *job = *head;
+    if (job) {
+        *head = job->next;
+        if (*head == NULL) {
+            *tail = NULL;
+        }
+        job->next = NULL;
+    }
+    return job;
+}
+
+// Completion signal
+static int open_event_fd(async_pool_t *pool) {
+#ifdef __linux__
+    int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    pool->event_fd = fd;
+    pool->wake_fd = fd;
+#else
+    int fds[2];
+    if (pipe(fds) < 0) {
+        return -1;
+    }
+    for (int i = 0; i < 2; i++) {
+        fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL) | O_NONBLOCK);
+        fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+    }
+    pool->event_fd = fds[0];
+    pool->wake_fd = fds[1];
+#endif
+    return 0;
+}
+
+static void close_event_fd(async_pool_t *pool) {
+    if (pool->wake_fd >= 0 && pool->wake_fd != pool->event_fd) {
+        close(pool->wake_fd);
+    }
+    if (pool->event_fd >= 0) {
+        close(pool->event_fd);
+    }
+    pool->event_fd = -1;
+    pool->wake_fd = -1;
+}
+
+static void signal_event(async_pool_t *pool) {
+#ifdef __linux__
+    uint64_t one = 1;
+    ssize_t n = write(pool->wake_fd, &one, sizeof(one));
+#else
+    char one = 1;
+    ssize_t n = write(pool->wake_fd, &one, 1);
+#endif
+    (void)n;  // A full pipe is already readable
+}
+
+static void clear_event(async_pool_t *pool) {
+    char buf[64];
+    while (read(pool->event_fd, buf, sizeof(buf)) > 0) {
+    }
+}
+
+static void *async_worker(void *arg) {
+    async_pool_t *pool = arg;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (pool->queue_head == NULL && !pool->stopping) {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+        if (pool->stopping) {
+            break;
+        }
+        async_job_t *job = job_pop(&pool->queue_head, &pool->queue_tail);
+        pthread_mutex_unlock(&pool->lock);
+
+        job->work(job);
+
+        pthread_mutex_lock(&pool->lock);
+        // The loop drains the whole list per wakeup, so only the first
+        // completion after a drain needs to signal
+        int was_empty = pool->done_head == NULL;
+        job_push(&pool->done_head, &pool->done_tail, job);
+        if (was_empty) {
+            signal_event(pool);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+// Delivery, on a loop thread with the GIL
+static PyObject *take_exception(void) {
+#if PY_VERSION_HEX >= 0x030C0000
+    return PyErr_GetRaisedException();
+#else
+    PyObject *type, *value, *tb;
+    PyErr_Fetch(&type, &value, &tb);
+    PyErr_NormalizeException(&type, &value, &tb);
+    if (tb != NULL && value != NULL) {
+        PyException_SetTraceback(value, tb);
+    }
+    Py_XDECREF(type);
+    Py_XDECREF(tb);
+    return value;
+#endif
+}
+
+// Returns 1 if set, 0 if the future was cancelled meanwhile
+static int set_if_pending(PyObject *future, PyObject *value, int is_exception) {
+    PyObject *done = PyObject_CallMethod(future, "done", NULL);
+    if (done == NULL) {
+        PyErr_WriteUnraisable(future);
+        return 0;
+    }
+    int is_done = PyObject_IsTrue(done);
+    Py_DECREF(done);
+    if (is_done) {
+        return 0;
+    }
+
+    PyObject *ret = PyObject_CallMethod(future, is_exception ? "set_exception" : "set_result",
+                                        "(O)", value);
+    if (ret == NULL) {
+        PyErr_WriteUnraisable(future);
+        return 0;
+    }
+    Py_DECREF(ret);
+    return 1;
+}
+
+static PyObject *deliver_threadsafe(PyObject *self, PyObject *args) {
+    PyObject *future, *value;
+    int is_exception;
+
+    (void)self;
+    if (!PyArg_ParseTuple(args, "OOp", &future, &value, &is_exception)) {
+        return NULL;
+    }
+    set_if_pending(future, value, is_exception);
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef deliver_def = {
+    "_deliver", deliver_threadsafe, METH_VARARGS, "Resolve a native future on its own loop"
+};
+
+static void deliver(async_pool_t *pool, async_job_t *job, PyObject *running) {
+    PyObject *value = job->result(job);
+    int is_exception = value == NULL;
+    if (is_exception) {
+        value = take_exception();
+    }
+    int delivered = 0;
+
+    PyObject *loop = PyObject_CallMethod(job->future, "get_loop", NULL);
+    if (loop == NULL || value == NULL) {
+        PyErr_WriteUnraisable(job->future);
+    } else if (loop == running) {
+        delivered = set_if_pending(job->future, value, is_exception);
+    } else {
+        // Submitted from another loop that shares the pool
+        PyObject *ret = PyObject_CallMethod(loop, "call_soon_threadsafe", "OOOi",
+                                            pool->deliver, job->future, value, is_exception);
+        if (ret == NULL) {
+            PyErr_Clear();  // That loop is closed
+        } else {
+            Py_DECREF(ret);
+            delivered = 1;
+        }
+    }
+
+    if (!delivered) {
+        __atomic_add_fetch(&pool->cancelled, 1, __ATOMIC_RELAXED);
+    }
+    Py_XDECREF(loop);
+    Py_XDECREF(value);
+    Py_CLEAR(job->future);
+    job->release(job);
+}
+
+static PyObject *pool_drain(PyObject *capsule, PyObject *unused) {
+    (void)unused;
+    async_pool_t *pool = pool_get(capsule);
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    // Clear before taking the list so a completion racing with this
+    // drain signals again instead of being left behind
+    clear_event(pool);
+
+    pthread_mutex_lock(&pool->lock);
+    async_job_t *done = pool->done_head;
+    pool->done_head = NULL;
+    pool->done_tail = NULL;
+    for (async_job_t *job = done; job != NULL; job = job->next) {
+        pool->inflight--;
+        pool->completed++;
+    }
+    // Freed slots go to waiting submissions in arrival order
+    int dispatched = 0;
+    while (pool->parked_head != NULL && pool->inflight < pool->max_inflight) {
+        async_job_t *job = job_pop(&pool->parked_head, &pool->parked_tail);
+        job_push(&pool->queue_head, &pool->queue_tail, job);
+        pool->parked--;
+        pool->inflight++;
+        dispatched++;
+    }
+    if (dispatched) {
+        pthread_cond_broadcast(&pool->wake);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    if (done == NULL) {
+        Py_RETURN_NONE;
+    }
+
+    PyObject *running = PyObject_CallNoArgs(pool->get_running_loop);
+    if (running == NULL) {
+        PyErr_Clear();
+    }
+    while (done != NULL) {
+        async_job_t *job = done;
+        done = job->next;
+        deliver(pool, job, running);
+    }
+    Py_XDECREF(running);
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef drain_def = {
+    "_drain", pool_drain, METH_NOARGS, "Resolve futures of completed native jobs"
+};
+
+// Lifecycle
+static void release_jobs(async_job_t *job) {
+    while (job != NULL) {
+        async_job_t *next = job->next;
+        Py_CLEAR(job->future);
+        job->release(job);
+        job = next;
+    }
+}
+
+static void pool_destroy(PyObject *capsule) {
+    async_pool_t *pool = pool_get(capsule);
+    if (pool == NULL) {
+        return;
+    }
+
+    // A child of fork has no workers to join
+    if (pool->started && pool->pid == getpid()) {
+        pthread_mutex_lock(&pool->lock);
+        pool->stopping = 1;
+        pthread_cond_broadcast(&pool->wake);
+        pthread_mutex_unlock(&pool->lock);
+
+        Py_BEGIN_ALLOW_THREADS
+        for (int i = 0; i < pool->workers; i++) {
+            pthread_join(pool->threads[i], NULL);
+        }
+        Py_END_ALLOW_THREADS
+    }
+
+    // Futures of jobs that never ran stay pending
+    release_jobs(pool->queue_head);
+    release_jobs(pool->done_head);
+    release_jobs(pool->parked_head);
+    close_event_fd(pool);
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->lock);
+    Py_XDECREF(pool->get_running_loop);
+    Py_XDECREF(pool->queue_full);
+    Py_XDECREF(pool->deliver);
+    Py_XDECREF(pool->loops);
+    PyMem_RawFree(pool->threads);
+    PyMem_RawFree(pool);
+}
+
+PyObject *async_pool_new(void) {
+    async_pool_t *pool = PyMem_RawCalloc(1, sizeof(async_pool_t));
+    if (pool == NULL) {
+        return PyErr_NoMemory();
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pool->event_fd = -1;
+    pool->wake_fd = -1;
+
+    PyObject *capsule = PyCapsule_New(pool, ASYNC_POOL_CAPSULE, pool_destroy);
+    if (capsule == NULL) {
+        pthread_cond_destroy(&pool->wake);
+        pthread_mutex_destroy(&pool->lock);
+        PyMem_RawFree(pool);
+        return NULL;
+    }
+
+    PyObject *asyncio = PyImport_ImportModule("asyncio");
+    if (asyncio != NULL) {
+        pool->get_running_loop = PyObject_GetAttrString(asyncio, "get_running_loop");
+        pool->queue_full = PyObject_GetAttrString(asyncio, "QueueFull");
+        Py_DECREF(asyncio);
+    }
+    PyObject *weakref = PyImport_ImportModule("weakref");
+    if (weakref != NULL) {
+        pool->loops = PyObject_CallMethod(weakref, "WeakSet", NULL);
+        Py_DECREF(weakref);
+    }
+    pool->deliver = PyCFunction_New(&deliver_def, NULL);
+
+    if (pool->get_running_loop == NULL || pool->queue_full == NULL || pool->loops == NULL ||
+        pool->deliver == NULL) {
+        Py_DECREF(capsule);
+        return NULL;
+    }
+    return capsule;
+}
+
+// Starts the workers on first use, or again in a child of fork
+static int pool_start(async_pool_t *pool) {
+    if (pool->started && pool->pid != getpid()) {
+        // The parent's workers and queued jobs are gone; so is whatever
+        // state its threads left the lock in
+        pthread_mutex_init(&pool->lock, NULL);
+        pthread_cond_init(&pool->wake, NULL);
+        pool->queue_head = pool->queue_tail = NULL;
+        pool->done_head = pool->done_tail = NULL;
+        pool->parked_head = pool->parked_tail = NULL;
+        pool->inflight = 0;
+        pool->parked = 0;
+        pool->started = 0;
+        close_event_fd(pool);
+        PyObject *ret = PyObject_CallMethod(pool->loops, "clear", NULL);
+        if (ret == NULL) {
+            return -1;
+        }
+        Py_DECREF(ret);
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    if (pool->started) {
+        pthread_mutex_unlock(&pool->lock);
+        return 0;
+    }
+
+    if (pool->workers == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        pool->workers = cpus < 1 ? 1 : cpus > ASYNC_POOL_DEFAULT_WORKERS
+            ? ASYNC_POOL_DEFAULT_WORKERS : (int)cpus;
+    }
+    if (pool->max_inflight == 0) {
+        pool->max_inflight = (size_t)pool->workers * ASYNC_POOL_INFLIGHT_PER_WORKER;
+    }
+    if (pool->max_waiting == 0) {
+        pool->max_waiting = (size_t)pool->workers * ASYNC_POOL_WAITING_PER_WORKER;
+    }
+
+    const char *error = NULL;
+    PyMem_RawFree(pool->threads);
+    pool->threads = PyMem_RawCalloc((size_t)pool->workers, sizeof(pthread_t));
+    if (pool->threads == NULL) {
+        error = "Failed to allocate native worker threads";
+    } else if (open_event_fd(pool) < 0) {
+        error = "Failed to open the completion eventfd";
+    } else {
+        int started = 0;
+        for (int i = 0; i < pool->workers; i++) {
+            if (pthread_create(&pool->threads[started], NULL, async_worker, pool) != 0) {
+                break;
+            }
+            started++;
+        }
+        if (started == 0) {
+            close_event_fd(pool);
+            error = "Failed to start native worker threads";
+        } else {
+            pool->workers = started;
+            pool->pid = getpid();
+            pool->started = 1;
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    if (error != NULL) {
+        PyErr_SetString(PyExc_RuntimeError, error);
+        return -1;
+    }
+    return 0;
+}
+
+static int watch_loop(PyObject *capsule, async_pool_t *pool, PyObject *loop) {
+    int watched = PySequence_Contains(pool->loops, loop);
+    if (watched != 0) {
+        return watched < 0 ? -1 : 0;
+    }
+
+    // The reader keeps the pool alive for as long as the loop holds it
+    PyObject *drain = PyCFunction_New(&drain_def, capsule);
+    if (drain == NULL) {
+        return -1;
+    }
+    PyObject *ret = PyObject_CallMethod(loop, "add_reader", "iO", pool->event_fd, drain);
+    Py_DECREF(drain);
+    if (ret == NULL) {
+        return -1;
+    }
+    Py_DECREF(ret);
+    ret = PyObject_CallMethod(pool->loops, "add", "(O)", loop);
+    if (ret == NULL) {
+        return -1;
+    }
+    Py_DECREF(ret);
+    return 0;
+}
+
+int async_pool_configure(PyObject *capsule, int workers, Py_ssize_t max_inflight,
+                         Py_ssize_t max_waiting) {
+    async_pool_t *pool = pool_get(capsule);
+    if (pool == NULL) {
+        return -1;
+    }
+    if (workers < 0 || workers > ASYNC_POOL_MAX_WORKERS) {
+        PyErr_Format(PyExc_ValueError, "workers must be between 0 and %d", ASYNC_POOL_MAX_WORKERS);
+        return -1;
+    }
+    if (max_inflight < 0) {
+        PyErr_SetString(PyExc_ValueError, "max_inflight must not be negative");
+        return -1;
+    }
+    if (max_waiting < 0) {
+        PyErr_SetString(PyExc_ValueError, "max_waiting must not be negative");
+        return -1;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    int started = pool->started && pool->pid == getpid();
+    if (!started) {
+        if (workers > 0) {
+            pool->workers = workers;
+        }
+        if (max_inflight > 0) {
+            pool->max_inflight = (size_t)max_inflight;
+        }
+        if (max_waiting > 0) {
+            pool->max_waiting = (size_t)max_waiting;
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    if (started) {
+        PyErr_SetString(PyExc_RuntimeError, "Worker pool already started");
+        return -1;
+    }
+    return 0;
+}
+
+PyObject *async_pool_submit(PyObject *capsule, async_job_t *job) {
+    async_pool_t *pool = pool_get(capsule);
+    job->next = NULL;
+    job->future = NULL;
+
+    if (pool == NULL || pool_start(pool) < 0) {
+        goto fail;
+    }
+    PyObject *loop = PyObject_CallNoArgs(pool->get_running_loop);
+    if (loop == NULL) {
+        goto fail;
+    }
+    if (watch_loop(capsule, pool, loop) < 0) {
+        Py_DECREF(loop);
+        goto fail;
+    }
+
+    // Only delivery on a loop, which holds the GIL, frees room, so the
+    // job still fits when it is queued below
+    pthread_mutex_lock(&pool->lock);
+    int full = pool->inflight >= pool->max_inflight && pool->parked >= pool->max_waiting;
+    size_t max_waiting = pool->max_waiting;
+    pthread_mutex_unlock(&pool->lock);
+    if (full) {
+        Py_DECREF(loop);
+        PyErr_Format(pool->queue_full, "%zu jobs already waiting for a native worker", max_waiting);
+        goto fail;
+    }
+    job->future = PyObject_CallMethod(loop, "create_future", NULL);
+    Py_DECREF(loop);
+    if (job->future == NULL) {
+        goto fail;
+    }
+    PyObject *future = job->future;
+    Py_INCREF(future);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->submitted++;
+    if (pool->inflight < pool->max_inflight) {
+        pool->inflight++;
+        job_push(&pool->queue_head, &pool->queue_tail, job);
+        pthread_cond_signal(&pool->wake);
+    } else {
+        pool->parked++;
+        job_push(&pool->parked_head, &pool->parked_tail, job);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return future;
+
+fail:
+    Py_CLEAR(job->future);
+    job->release(job);
+    return NULL;
+}
+
+PyObject *async_pool_stats(PyObject *capsule) {
+    async_pool_t *pool = pool_get(capsule);
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    int workers = pool->workers;
+    size_t max_inflight = pool->max_inflight;
+    size_t max_waiting = pool->max_waiting;
+    size_t inflight = pool->inflight;
+    size_t parked = pool->parked;
+    uint64_t submitted = pool->submitted;
+    uint64_t completed = pool->completed;
+    int started = pool->started;
+    pthread_mutex_unlock(&pool->lock);
+
+    return Py_BuildValue("{s:i,s:n,s:n,s:n,s:n,s:K,s:K,s:K,s:O}",
+                         "workers", workers,
+                         "max_inflight", (Py_ssize_t)max_inflight,
+                         "max_waiting", (Py_ssize_t)max_waiting,
+                         "inflight", (Py_ssize_t)inflight,
+                         "waiting", (Py_ssize_t)parked,
+                         "submitted", (unsigned long long)submitted,
+                         "completed", (unsigned long long)completed,
+                         "cancelled", (unsigned long long)__atomic_load_n(&pool->cancelled, __ATOMIC_RELAXED),
+                         "started", started ? Py_True : Py_False);
+}
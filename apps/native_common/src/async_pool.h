@@ -0,0 +1,59 @@
+#ifndef ASYNC_POOL_H
+#define ASYNC_POOL_H
+
+#include <Python.h>
+
+#define ASYNC_POOL_DEFAULT_WORKERS 4     // Upper bound when workers is not configured
+#define ASYNC_POOL_MAX_WORKERS 64
+#define ASYNC_POOL_INFLIGHT_PER_WORKER 2 // Default bound on jobs handed to workers
+#define ASYNC_POOL_WAITING_PER_WORKER 32 // Default bound on jobs queued behind them
+
+typedef struct async_job async_job_t;
+
+// Runs on a pool worker without the GIL
+typedef void (*async_work_fn)(async_job_t *job);
+
+// Runs on the loop thread with the GIL: the future's result as a new
+// reference, or NULL with an exception set
+typedef PyObject *(*async_result_fn)(async_job_t *job);
+
+// Releases the job's buffers and references and frees it, with the GIL
+typedef void (*async_release_fn)(async_job_t *job);
+
+// Embedded as the first member of each operation's job struct
+struct async_job {
+    async_job_t *next;
+    async_work_fn work;
+    async_result_fn result;
+    async_release_fn release;
+    PyObject *future;
+};
+
+// A pool is a set of worker threads behind a capsule, one per module
+// instance so each interpreter has its own. Workers signal completions
+// through an eventfd (a pipe off Linux) that each submitting loop
+// watches with add_reader; the loop then resolves the futures. At most
+// max_inflight jobs are handed to workers, up to max_waiting later
+// submissions wait in FIFO order and their futures resolve after them.
+// Past that, submit raises asyncio.QueueFull rather than pinning ever
+// more input buffers; callers await earlier futures and retry. Workers
+// start on
+// first submit and are joined when the capsule is freed, which is once
+// the module and every loop still watching the pool have let go of it.
+
+// New pool capsule, or NULL with an exception set
+PyObject *async_pool_new(void);
+
+// Sets worker count, in-flight and waiting bounds (0 keeps the
+// default); fails once the pool has started
+int async_pool_configure(PyObject *pool, int workers, Py_ssize_t max_inflight,
+                         Py_ssize_t max_waiting);
+
+// Schedules job on the running loop and returns its future (new
+// reference). On failure the job is released and NULL returned.
+PyObject *async_pool_submit(PyObject *pool, async_job_t *job);
+
+// Worker, in-flight and queue counters as a dict
+PyObject *async_pool_stats(PyObject *pool);
+
+#endif // ASYNC_POOL_H
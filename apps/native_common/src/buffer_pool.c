@@ -0,0 +1,377 @@
+#define _GNU_SOURCE
+#include "buffer_pool.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Sits at the start of each mapping, in front of the caller's bytes
+typedef struct pool_block {
+    struct pool_block *next;  // Free list link while cached
+    size_t map_size;
+    uint64_t owner;           // Cache id of the thread that mapped it, 0 if none
+    int cls;                  // -1 for oversized blocks
+    int backing;
+} __attribute__((aligned(64))) pool_block_t;
+
+typedef struct {
+    uint64_t id;
+    pool_block_t *heads[BUFFER_POOL_CLASSES];
+    int counts[BUFFER_POOL_CLASSES];
+    size_t bytes;
+} thread_cache_t;
+
+static size_t class_capacity[BUFFER_POOL_CLASSES];
+static pthread_once_t pool_once = PTHREAD_ONCE_INIT;
+static pthread_key_t cache_key;
+static __thread thread_cache_t *thread_cache;
+static uint64_t next_cache_id;
+
+// Shared free lists
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pool_block_t *shared_heads[BUFFER_POOL_CLASSES];
+static size_t shared_bytes;
+
+// Counters are updated with relaxed atomics; limits are read the same way
+static buffer_pool_stats_t counters = {
+    .max_cached_bytes = BUFFER_POOL_DEFAULT_CACHED,
+    .thread_cache_bytes = BUFFER_POOL_DEFAULT_THREAD,
+    .hugepages = BUFFER_HUGEPAGES_THP,
+};
+
+static void add_relaxed(uint64_t *counter, uint64_t n) {
+    __atomic_fetch_add(counter, n, __ATOMIC_RELAXED);
+}
+
+static void sub_relaxed(uint64_t *counter, uint64_t n) {
+    __atomic_fetch_sub(counter, n, __ATOMIC_RELAXED);
+}
+
+static size_t round_up(size_t n, size_t align) {
+    return (n + align - 1) & ~(align - 1);
+}
+
+static void unmap_block(pool_block_t *block) {
+    add_relaxed(&counters.unmaps, 1);
+    sub_relaxed(&counters.mapped_bytes, block->map_size);
+    munmap(block, block->map_size);
+}
+
+static void unmap_list(pool_block_t *block) {
+    while (block != NULL) {
+        pool_block_t *next = block->next;
+        unmap_block(block);
+        block = next;
+    }
+}
+
+// Pushes onto the shared list for its class, or unmaps past max_cached
+static void release_shared(pool_block_t *block) {
+    size_t size = block->map_size;
+    pthread_mutex_lock(&pool_lock);
+    int keep = shared_bytes + size <= __atomic_load_n(&counters.max_cached_bytes, __ATOMIC_RELAXED);
+    if (keep) {
+        block->next = shared_heads[block->cls];
+        shared_heads[block->cls] = block;
+        shared_bytes += size;
+        add_relaxed(&counters.cached_bytes, size);
+    }
+    pthread_mutex_unlock(&pool_lock);
+    if (!keep) {
+        unmap_block(block);
+    }
+}
+
+// Detaches shared blocks until at most limit bytes stay cached; the
+// caller unmaps the returned list outside the lock
+static pool_block_t *detach_shared(size_t limit) {
+    pool_block_t *detached = NULL;
+    pthread_mutex_lock(&pool_lock);
+    for (int cls = BUFFER_POOL_CLASSES - 1; cls >= 0 && shared_bytes > limit; cls--) {
+        while (shared_heads[cls] != NULL && shared_bytes > limit) {
+            pool_block_t *block = shared_heads[cls];
+            shared_heads[cls] = block->next;
+            shared_bytes -= block->map_size;
+            sub_relaxed(&counters.cached_bytes, block->map_size);
+            block->next = detached;
+            detached = block;
+        }
+    }
+    pthread_mutex_unlock(&pool_lock);
+    return detached;
+}
+
+static pool_block_t *detach_thread_cache(thread_cache_t *cache) {
+    pool_block_t *detached = NULL;
+    for (int cls = 0; cls < BUFFER_POOL_CLASSES; cls++) {
+        while (cache->heads[cls] != NULL) {
+            pool_block_t *block = cache->heads[cls];
+            cache->heads[cls] = block->next;
+            sub_relaxed(&counters.cached_bytes, block->map_size);
+            block->next = detached;
+            detached = block;
+        }
+        cache->counts[cls] = 0;
+    }
+    cache->bytes = 0;
+    return detached;
+}
+
+// Thread exit: cached blocks move to the shared lists
+static void thread_cache_exit(void *arg) {
+    pool_block_t *block = detach_thread_cache((thread_cache_t*)arg);
+    while (block != NULL) {
+        pool_block_t *next = block->next;
+        release_shared(block);
+        block = next;
+    }
+    thread_cache = NULL;
+    free(arg);
+}
+
+static void fork_prepare(void) {
+    pthread_mutex_lock(&pool_lock);
+}
+
+static void fork_parent(void) {
+    pthread_mutex_unlock(&pool_lock);
+}
+
+// Only the forking thread survives; other threads' caches stay mapped
+// but unreachable in the child
+static void fork_child(void) {
+    pthread_mutex_init(&pool_lock, NULL);
+}
+
+static void pool_setup(void) {
+    for (int cls = 0; cls < BUFFER_POOL_CLASSES; cls++) {
+        size_t base = ((size_t)1 << (BUFFER_POOL_MIN_SHIFT + cls / BUFFER_POOL_STEPS))
+                      / BUFFER_POOL_STEPS * (BUFFER_POOL_STEPS + cls % BUFFER_POOL_STEPS);
+        class_capacity[cls] = base + base / 128;
+    }
+    pthread_key_create(&cache_key, thread_cache_exit);
+    pthread_atfork(fork_prepare, fork_parent, fork_child);
+}
+
+static thread_cache_t *cache_for_thread(void) {
+    if (thread_cache == NULL) {
+        thread_cache_t *cache = calloc(1, sizeof(thread_cache_t));
+        if (cache == NULL) {
+            return NULL;
+        }
+        cache->id = __atomic_add_fetch(&next_cache_id, 1, __ATOMIC_RELAXED);
+        pthread_setspecific(cache_key, cache);
+        thread_cache = cache;
+    }
+    return thread_cache;
+}
+
+// Smallest class holding size, or -1 above the largest
+static int size_class(size_t size) {
+    if (size > class_capacity[BUFFER_POOL_CLASSES - 1]) {
+        return -1;
+    }
+    int lo = 0, hi = BUFFER_POOL_CLASSES - 1;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (class_capacity[mid] >= size) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+// Anonymous mapping starting on a huge page boundary, so THP can back
+// every whole 2 MiB of it
+static void *map_thp(size_t length) {
+#ifdef MADV_HUGEPAGE
+    size_t span = length + BUFFER_POOL_HUGEPAGE;
+    char *raw = mmap(NULL, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return MAP_FAILED;
+    }
+    char *aligned = (char*)round_up((size_t)(uintptr_t)raw, BUFFER_POOL_HUGEPAGE);
+    if (aligned > raw) {
+        munmap(raw, (size_t)(aligned - raw));
+    }
+    size_t tail = (size_t)((raw + span) - (aligned + length));
+    if (tail > 0) {
+        munmap(aligned + length, tail);
+    }
+    // Fails harmlessly when THP is disabled system-wide
+    madvise(aligned, length, MADV_HUGEPAGE);
+    return aligned;
+#else
+    (void)length;
+    return MAP_FAILED;
+#endif
+}
+
+static pool_block_t *map_block(int cls, size_t size, thread_cache_t *cache) {
+    size_t capacity = cls >= 0 ? class_capacity[cls] : size;
+    size_t length = round_up(sizeof(pool_block_t) + capacity, (size_t)sysconf(_SC_PAGESIZE));
+    int mode = __atomic_load_n(&counters.hugepages, __ATOMIC_RELAXED);
+    int backing = BUFFER_HUGEPAGES_OFF;
+    void *map = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+    if (mode == BUFFER_HUGEPAGES_HUGETLB && length >= BUFFER_POOL_HUGEPAGE) {
+        size_t huge_length = round_up(length, BUFFER_POOL_HUGEPAGE);
+        map = mmap(NULL, huge_length, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (map != MAP_FAILED) {
+            length = huge_length;
+            backing = BUFFER_HUGEPAGES_HUGETLB;
+        } else {
+            add_relaxed(&counters.hugetlb_failures, 1);
+        }
+    }
+#endif
+    if (map == MAP_FAILED && mode != BUFFER_HUGEPAGES_OFF && length >= BUFFER_POOL_HUGEPAGE) {
+        map = map_thp(length);
+        if (map != MAP_FAILED) {
+            backing = BUFFER_HUGEPAGES_THP;
+        }
+    }
+    if (map == MAP_FAILED) {
+        map = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    if (map == MAP_FAILED) {
+        return NULL;
+    }
+
+    pool_block_t *block = map;
+    block->map_size = length;
+    block->owner = cache != NULL ? cache->id : 0;
+    block->cls = cls;
+    block->backing = backing;
+    add_relaxed(&counters.maps, 1);
+    add_relaxed(&counters.mapped_bytes, length);
+    if (backing == BUFFER_HUGEPAGES_HUGETLB) {
+        add_relaxed(&counters.hugetlb_maps, 1);
+    } else if (backing == BUFFER_HUGEPAGES_THP) {
+        add_relaxed(&counters.thp_maps, 1);
+    }
+    return block;
+}
+
+void *buffer_pool_alloc(size_t size) {
+    pthread_once(&pool_once, pool_setup);
+    if (size > SIZE_MAX / 2) {
+        return NULL;
+    }
+
+    int cls = size_class(size);
+    thread_cache_t *cache = cache_for_thread();
+    pool_block_t *block = NULL;
+    if (cls >= 0 && cache != NULL && cache->heads[cls] != NULL) {
+        block = cache->heads[cls];
+        cache->heads[cls] = block->next;
+        cache->counts[cls]--;
+        cache->bytes -= block->map_size;
+        sub_relaxed(&counters.cached_bytes, block->map_size);
+        add_relaxed(&counters.thread_hits, 1);
+    } else if (cls >= 0) {
+        pthread_mutex_lock(&pool_lock);
+        block = shared_heads[cls];
+        if (block != NULL) {
+            shared_heads[cls] = block->next;
+            shared_bytes -= block->map_size;
+        }
+        pthread_mutex_unlock(&pool_lock);
+        if (block != NULL) {
+            sub_relaxed(&counters.cached_bytes, block->map_size);
+            add_relaxed(&counters.shared_hits, 1);
+        }
+    }
+    if (block == NULL) {
+        block = map_block(cls, size, cache);
+        if (block == NULL) {
+            return NULL;
+        }
+    }
+
+    block->next = NULL;
+    add_relaxed(&counters.allocations, 1);
+    add_relaxed(&counters.in_use_bytes, block->map_size);
+    return block + 1;
+}
+
+void buffer_pool_free(void *ptr) {
+    if (ptr == NULL) {
+        return;
+    }
+    pool_block_t *block = (pool_block_t*)ptr - 1;
+    size_t size = block->map_size;
+    sub_relaxed(&counters.in_use_bytes, size);
+    if (block->cls < 0) {
+        unmap_block(block);
+        return;
+    }
+
+    thread_cache_t *cache = thread_cache;
+    if (cache != NULL && block->owner == cache->id
+        && cache->counts[block->cls] < BUFFER_POOL_THREAD_BLOCKS
+        && cache->bytes + size <= __atomic_load_n(&counters.thread_cache_bytes, __ATOMIC_RELAXED)) {
+        block->next = cache->heads[block->cls];
+        cache->heads[block->cls] = block;
+        cache->counts[block->cls]++;
+        cache->bytes += size;
+        add_relaxed(&counters.cached_bytes, size);
+        return;
+    }
+    release_shared(block);
+}
+
+size_t buffer_pool_capacity(const void *ptr) {
+    return ((const pool_block_t*)ptr - 1)->map_size - sizeof(pool_block_t);
+}
+
+void buffer_pool_configure(size_t max_cached, size_t thread_cache_limit, buffer_hugepages_t hugepages) {
+    if (max_cached != SIZE_MAX) {
+        __atomic_store_n(&counters.max_cached_bytes, max_cached, __ATOMIC_RELAXED);
+        unmap_list(detach_shared(max_cached));
+    }
+    if (thread_cache_limit != SIZE_MAX) {
+        // Other threads' caches shrink as their blocks are freed
+        __atomic_store_n(&counters.thread_cache_bytes, thread_cache_limit, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&counters.hugepages, hugepages, __ATOMIC_RELAXED);
+}
+
+void buffer_pool_trim(void) {
+    if (thread_cache != NULL) {
+        unmap_list(detach_thread_cache(thread_cache));
+    }
+    unmap_list(detach_shared(0));
+}
+
+void buffer_pool_stats(buffer_pool_stats_t *out) {
+    out->allocations = __atomic_load_n(&counters.allocations, __ATOMIC_RELAXED);
+    out->thread_hits = __atomic_load_n(&counters.thread_hits, __ATOMIC_RELAXED);
+    out->shared_hits = __atomic_load_n(&counters.shared_hits, __ATOMIC_RELAXED);
+    out->maps = __atomic_load_n(&counters.maps, __ATOMIC_RELAXED);
+    out->unmaps = __atomic_load_n(&counters.unmaps, __ATOMIC_RELAXED);
+    out->hugetlb_maps = __atomic_load_n(&counters.hugetlb_maps, __ATOMIC_RELAXED);
+    out->thp_maps = __atomic_load_n(&counters.thp_maps, __ATOMIC_RELAXED);
+    out->hugetlb_failures = __atomic_load_n(&counters.hugetlb_failures, __ATOMIC_RELAXED);
+    out->mapped_bytes = __atomic_load_n(&counters.mapped_bytes, __ATOMIC_RELAXED);
+    out->in_use_bytes = __atomic_load_n(&counters.in_use_bytes, __ATOMIC_RELAXED);
+    out->cached_bytes = __atomic_load_n(&counters.cached_bytes, __ATOMIC_RELAXED);
+    out->max_cached_bytes = __atomic_load_n(&counters.max_cached_bytes, __ATOMIC_RELAXED);
+    out->thread_cache_bytes = __atomic_load_n(&counters.thread_cache_bytes, __ATOMIC_RELAXED);
+    out->hugepages = __atomic_load_n(&counters.hugepages, __ATOMIC_RELAXED);
+}
+
+const char *buffer_pool_hugepages_name(buffer_hugepages_t mode) {
+    switch (mode) {
+    case BUFFER_HUGEPAGES_THP:
+        return "thp";
+    case BUFFER_HUGEPAGES_HUGETLB:
+        return "hugetlb";
+    default:
+        return "off";
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Constants
+#define BUFFER_POOL_MIN_SHIFT 16                 // Smallest class: 64 KiB
+#define BUFFER_POOL_MAX_SHIFT 27                 // Largest class: 128 MiB, above MAX_CHUNK_SIZE
+#define BUFFER_POOL_STEPS 4                      // Classes per power of two, <= 25% slack
+#define BUFFER_POOL_CLASSES ((BUFFER_POOL_MAX_SHIFT - BUFFER_POOL_MIN_SHIFT) * BUFFER_POOL_STEPS + 1)
+#define BUFFER_POOL_THREAD_BLOCKS 4              // Cached blocks per class per thread
+#define BUFFER_POOL_DEFAULT_CACHED (256u << 20)  // Shared free lists
+#define BUFFER_POOL_DEFAULT_THREAD (64u << 20)   // Each thread's free lists
+#define BUFFER_POOL_HUGEPAGE (2u << 20)
+
+typedef enum {
+    BUFFER_HUGEPAGES_OFF = 0,
+    BUFFER_HUGEPAGES_THP = 1,      // madvise(MADV_HUGEPAGE) on 2 MiB aligned mappings
+    BUFFER_HUGEPAGES_HUGETLB = 2   // MAP_HUGETLB from the reserved pool, THP when it is empty
+} buffer_hugepages_t;
+
+// Process-wide pool of large, reusable buffers for chunk, compression
+// and cipher output. Sizes are rounded up to a class (four per power of
+// two, each with 1/128 headroom so a chunk plus its compressBound() or
+// AEAD overhead stays in the chunk's class) and every class is backed by
+// anonymous mappings that are kept faulted in between uses. A freed
+// block goes back to the thread that mapped it, and so first touched
+// its pages, which keeps reuse on that thread's NUMA node; blocks freed
+// elsewhere, or past the thread's limit, go to shared free lists, and
+// past max_cached they are unmapped. Requests above the largest class
+// are mapped and unmapped directly.
+typedef struct {
+    uint64_t allocations;
+    uint64_t thread_hits;      // Served from the calling thread's free list
+    uint64_t shared_hits;      // Served from the shared free lists
+    uint64_t maps;
+    uint64_t unmaps;
+    uint64_t hugetlb_maps;
+    uint64_t thp_maps;
+    uint64_t hugetlb_failures; // MAP_HUGETLB refused, fell back to THP
+    uint64_t mapped_bytes;
+    uint64_t in_use_bytes;
+    uint64_t cached_bytes;
+    size_t max_cached_bytes;
+    size_t thread_cache_bytes;
+    buffer_hugepages_t hugepages;
+} buffer_pool_stats_t;
+
+// At least size usable bytes, 64-byte aligned; NULL when out of memory
+void *buffer_pool_alloc(size_t size);
+
+// Returns a buffer from buffer_pool_alloc; NULL is ignored
+void buffer_pool_free(void *ptr);
+
+// Usable bytes behind a pooled buffer, at least the requested size
+size_t buffer_pool_capacity(const void *ptr);
+
+// Shared and per-thread cache limits in bytes (SIZE_MAX keeps the
+// current value) and the huge page policy for new mappings; shrinking
+// a limit unmaps the shared excess right away
+void buffer_pool_configure(size_t max_cached, size_t thread_cache, buffer_hugepages_t hugepages);
+
+// Unmaps every shared cached block and the calling thread's
+void buffer_pool_trim(void);
+
+void buffer_pool_stats(buffer_pool_stats_t *out);
+
+const char *buffer_pool_hugepages_name(buffer_hugepages_t mode);
+
+#endif // BUFFER_POOL_H
@@ -0,0 +1,279 @@
+#define _GNU_SOURCE
+#include "op_stats.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Prometheus le bounds in seconds: 1-2.5-5 steps from 1us to 10s
+static const double prometheus_bounds[] = {
+    1e-6, 2.5e-6, 5e-6, 1e-5, 2.5e-5, 5e-5, 1e-4, 2.5e-4, 5e-4,
+    1e-3, 2.5e-3, 5e-3, 1e-2, 2.5e-2, 5e-2, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0
+};
+#define PROMETHEUS_BOUNDS (sizeof(prometheus_bounds) / sizeof(prometheus_bounds[0]))
+
+static unsigned next_shard;
+static __thread int thread_shard = -1;
+
+static op_shard_t *shard_for_thread(op_stats_t *stats) {
+    if (thread_shard < 0) {
+        thread_shard = (int)(__atomic_fetch_add(&next_shard, 1, __ATOMIC_RELAXED) % OP_STATS_SHARDS);
+    }
+    return &stats->shards[thread_shard];
+}
+
+static void add_relaxed(uint64_t *counter, uint64_t n) {
+    __atomic_fetch_add(counter, n, __ATOMIC_RELAXED);
+}
+
+static uint64_t load_relaxed(const uint64_t *counter) {
+    return __atomic_load_n(counter, __ATOMIC_RELAXED);
+}
+
+static int bucket_index(uint64_t ns) {
+    if (ns < OP_STATS_SUB_COUNT) {
+        return (int)ns;
+    }
+    int exp = 63 - __builtin_clzll(ns);
+    if (exp > OP_STATS_MAX_EXP) {
+        return OP_STATS_BUCKETS - 1;
+    }
+    int sub = (int)((ns >> (exp - OP_STATS_SUB_BITS)) & (OP_STATS_SUB_COUNT - 1));
+    return (exp - OP_STATS_SUB_BITS + 1) * OP_STATS_SUB_COUNT + sub;
+}
+
+uint64_t op_stats_bucket_upper(int index) {
+    if (index < OP_STATS_SUB_COUNT) {
+        return (uint64_t)index;
+    }
+    int exp = index / OP_STATS_SUB_COUNT + OP_STATS_SUB_BITS - 1;
+    uint64_t sub = (uint64_t)(index % OP_STATS_SUB_COUNT);
+    uint64_t width = (uint64_t)1 << (exp - OP_STATS_SUB_BITS);
+    return ((OP_STATS_SUB_COUNT + sub) << (exp - OP_STATS_SUB_BITS)) + width - 1;
+}
+
+uint64_t op_stats_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void op_stats_record(op_stats_t *stats, int op, uint64_t ns,
+                     size_t bytes_in, size_t bytes_out, int ok) {
+    if (op < 0 || op >= stats->op_count) {
+        return;
+    }
+    op_histogram_t *hist = &shard_for_thread(stats)->ops[op];
+
+    add_relaxed(&hist->buckets[bucket_index(ns)], 1);
+    add_relaxed(&hist->count, 1);
+    add_relaxed(&hist->sum_ns, ns);
+    add_relaxed(&hist->bytes_in, bytes_in);
+    add_relaxed(&hist->bytes_out, bytes_out);
+    if (!ok) {
+        add_relaxed(&hist->errors, 1);
+    }
+
+    uint64_t max = load_relaxed(&hist->max_ns);
+    while (ns > max &&
+           !__atomic_compare_exchange_n(&hist->max_ns, &max, ns, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+void op_stats_alloc(op_stats_t *stats, size_t size, int ok) {
+    op_shard_t *shard = shard_for_thread(stats);
+
+    if (ok) {
+        add_relaxed(&shard->allocations, 1);
+        add_relaxed(&shard->allocated_bytes, size);
+    } else {
+        add_relaxed(&shard->alloc_failures, 1);
+    }
+}
+
+void *op_stats_malloc(op_stats_t *stats, size_t size) {
+    void *ptr = malloc(size ? size : 1);
+    op_stats_alloc(stats, size, ptr != NULL);
+    return ptr;
+}
+
+void *op_stats_zalloc(void *opaque, unsigned items, unsigned size) {
+    size_t total = (size_t)items * size;
+    void *ptr = malloc(total);
+    op_stats_alloc((op_stats_t*)opaque, total, ptr != NULL);
+    return ptr;
+}
+
+void op_stats_zfree(void *opaque, void *address) {
+    (void)opaque;
+    free(address);
+}
+
+void op_stats_snapshot(const op_stats_t *stats, op_snapshot_t *out) {
+    // Shards past the number of threads seen so far were never written
+    unsigned used = __atomic_load_n(&next_shard, __ATOMIC_RELAXED);
+    if (used > OP_STATS_SHARDS) {
+        used = OP_STATS_SHARDS;
+    }
+    memset(out, 0, sizeof(*out));
+
+    for (unsigned s = 0; s < used; s++) {
+        const op_shard_t *shard = &stats->shards[s];
+        for (int op = 0; op < stats->op_count; op++) {
+            const op_histogram_t *src = &shard->ops[op];
+            op_histogram_t *dst = &out->ops[op];
+            if (load_relaxed(&src->count) == 0) {
+                continue;
+            }
+            for (int b = 0; b < OP_STATS_BUCKETS; b++) {
+                dst->buckets[b] += load_relaxed(&src->buckets[b]);
+            }
+            dst->count += load_relaxed(&src->count);
+            dst->errors += load_relaxed(&src->errors);
+            dst->sum_ns += load_relaxed(&src->sum_ns);
+            dst->bytes_in += load_relaxed(&src->bytes_in);
+            dst->bytes_out += load_relaxed(&src->bytes_out);
+            uint64_t max = load_relaxed(&src->max_ns);
+            if (max > dst->max_ns) {
+                dst->max_ns = max;
+            }
+        }
+        out->allocations += load_relaxed(&shard->allocations);
+        out->allocated_bytes += load_relaxed(&shard->allocated_bytes);
+        out->alloc_failures += load_relaxed(&shard->alloc_failures);
+    }
+}
+
+uint64_t op_histogram_quantile(const op_histogram_t *hist, double q) {
+    uint64_t total = 0;
+
+    // Count from the buckets themselves so a snapshot taken mid-update
+    // still walks to a bucket
+    for (int b = 0; b < OP_STATS_BUCKETS; b++) {
+        total += hist->buckets[b];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    if (q < 0.0) {
+        q = 0.0;
+    } else if (q > 1.0) {
+        q = 1.0;
+    }
+    uint64_t rank = (uint64_t)(q * (double)total + 0.5);
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (int b = 0; b < OP_STATS_BUCKETS; b++) {
+        seen += hist->buckets[b];
+        if (seen >= rank) {
+            uint64_t upper = op_stats_bucket_upper(b);
+            return upper < hist->max_ns ? upper : hist->max_ns;
+        }
+    }
+    return hist->max_ns;
+}
+
+typedef struct {
+    char *data;
+    size_t len;
+    size_t cap;
+    int failed;
+} text_buffer_t;
+
+static void append(text_buffer_t *buf, const char *fmt, ...) {
+    va_list args;
+
+    if (buf->failed) {
+        return;
+    }
+    for (;;) {
+        va_start(args, fmt);
+        int n = vsnprintf(buf->data + buf->len, buf->cap - buf->len, fmt, args);
+        va_end(args);
+        if (n < 0) {
+            buf->failed = 1;
+            return;
+        }
+        if ((size_t)n < buf->cap - buf->len) {
+            buf->len += (size_t)n;
+            return;
+        }
+        size_t cap = buf->cap * 2 + (size_t)n;
+        char *data = realloc(buf->data, cap);
+        if (data == NULL) {
+            buf->failed = 1;
+            return;
+        }
+        buf->data = data;
+        buf->cap = cap;
+    }
+}
+
+char *op_stats_prometheus(const op_stats_t *stats, const op_snapshot_t *snap, const char *prefix) {
+    text_buffer_t buf = {malloc(4096), 0, 4096, 0};
+    if (buf.data == NULL) {
+        return NULL;
+    }
+
+    append(&buf, "# HELP %s_op_duration_seconds Time spent inside native operations.\n", prefix);
+    append(&buf, "# TYPE %s_op_duration_seconds histogram\n", prefix);
+    for (int op = 0; op < stats->op_count; op++) {
+        const op_histogram_t *hist = &snap->ops[op];
+        const char *name = stats->names[op];
+        uint64_t cumulative = 0;
+        int b = 0;
+
+        // A bucket only counts toward a bound its whole range fits under
+        for (size_t i = 0; i < PROMETHEUS_BOUNDS; i++) {
+            uint64_t bound_ns = (uint64_t)(prometheus_bounds[i] * 1e9 + 0.5);
+            while (b < OP_STATS_BUCKETS && op_stats_bucket_upper(b) <= bound_ns) {
+                cumulative += hist->buckets[b++];
+            }
+            append(&buf, "%s_op_duration_seconds_bucket{op=\"%s\",le=\"%g\"} %llu\n",
+                   prefix, name, prometheus_bounds[i], (unsigned long long)cumulative);
+        }
+        append(&buf, "%s_op_duration_seconds_bucket{op=\"%s\",le=\"+Inf\"} %llu\n",
+               prefix, name, (unsigned long long)hist->count);
+        append(&buf, "%s_op_duration_seconds_sum{op=\"%s\"} %.9f\n",
+               prefix, name, (double)hist->sum_ns / 1e9);
+        append(&buf, "%s_op_duration_seconds_count{op=\"%s\"} %llu\n",
+               prefix, name, (unsigned long long)hist->count);
+    }
+
+    append(&buf, "# HELP %s_op_errors_total Native operations that failed.\n", prefix);
+    append(&buf, "# TYPE %s_op_errors_total counter\n", prefix);
+    for (int op = 0; op < stats->op_count; op++) {
+        append(&buf, "%s_op_errors_total{op=\"%s\"} %llu\n",
+               prefix, stats->names[op], (unsigned long long)snap->ops[op].errors);
+    }
+
+    append(&buf, "# HELP %s_op_bytes_total Bytes passed through native operations.\n", prefix);
+    append(&buf, "# TYPE %s_op_bytes_total counter\n", prefix);
+    for (int op = 0; op < stats->op_count; op++) {
+        append(&buf, "%s_op_bytes_total{op=\"%s\",direction=\"in\"} %llu\n",
+               prefix, stats->names[op], (unsigned long long)snap->ops[op].bytes_in);
+        append(&buf, "%s_op_bytes_total{op=\"%s\",direction=\"out\"} %llu\n",
+               prefix, stats->names[op], (unsigned long long)snap->ops[op].bytes_out);
+    }
+
+    append(&buf, "# HELP %s_allocations_total Buffers allocated by native operations.\n", prefix);
+    append(&buf, "# TYPE %s_allocations_total counter\n", prefix);
+    append(&buf, "%s_allocations_total %llu\n", prefix, (unsigned long long)snap->allocations);
+    append(&buf, "# HELP %s_allocated_bytes_total Bytes allocated by native operations.\n", prefix);
+    append(&buf, "# TYPE %s_allocated_bytes_total counter\n", prefix);
+    append(&buf, "%s_allocated_bytes_total %llu\n", prefix, (unsigned long long)snap->allocated_bytes);
+    append(&buf, "# HELP %s_allocation_failures_total Native allocations that failed.\n", prefix);
+    append(&buf, "# TYPE %s_allocation_failures_total counter\n", prefix);
+    append(&buf, "%s_allocation_failures_total %llu\n", prefix, (unsigned long long)snap->alloc_failures);
+
+    if (buf.failed) {
+        free(buf.data);
+        return NULL;
+    }
+    return buf.data;
+}
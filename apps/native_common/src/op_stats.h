@@ -0,0 +1,73 @@
+#ifndef OP_STATS_H
+#define OP_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Constants
+#define OP_STATS_SUB_BITS 5                          // 32 sub-buckets per power of two, <= 3.2% error
+#define OP_STATS_SUB_COUNT (1 << OP_STATS_SUB_BITS)
+#define OP_STATS_MAX_EXP 40                          // Durations up to 2^41 ns (~36 min)
+#define OP_STATS_BUCKETS ((OP_STATS_MAX_EXP - OP_STATS_SUB_BITS + 2) * OP_STATS_SUB_COUNT)
+#define OP_STATS_SHARDS 16
+#define OP_STATS_MAX_OPS 5
+
+// Log-linear (HDR-style) latency histogram in nanoseconds: values below
+// OP_STATS_SUB_COUNT get one bucket each, larger ones are bucketed by
+// their top OP_STATS_SUB_BITS bits after the leading one.
+typedef struct {
+    uint64_t buckets[OP_STATS_BUCKETS];
+    uint64_t count;
+    uint64_t errors;
+    uint64_t sum_ns;
+    uint64_t max_ns;
+    uint64_t bytes_in;
+    uint64_t bytes_out;
+} op_histogram_t;
+
+// Threads are assigned shards round-robin on first use, so writers rarely
+// share a cache line; two threads that do share one still add atomically.
+typedef struct {
+    op_histogram_t ops[OP_STATS_MAX_OPS];
+    uint64_t allocations;
+    uint64_t allocated_bytes;
+    uint64_t alloc_failures;
+} __attribute__((aligned(64))) op_shard_t;
+
+typedef struct {
+    const char *const *names;  // One per op
+    int op_count;
+    op_shard_t shards[OP_STATS_SHARDS];
+} op_stats_t;
+
+// Shards folded into one view
+typedef struct {
+    op_histogram_t ops[OP_STATS_MAX_OPS];
+    uint64_t allocations;
+    uint64_t allocated_bytes;
+    uint64_t alloc_failures;
+} op_snapshot_t;
+
+// Safe from any thread, with or without the GIL
+uint64_t op_stats_now_ns(void);
+void op_stats_record(op_stats_t *stats, int op, uint64_t ns,
+                     size_t bytes_in, size_t bytes_out, int ok);
+void op_stats_alloc(op_stats_t *stats, size_t size, int ok);
+
+// Counting allocator; free with plain free()
+void *op_stats_malloc(op_stats_t *stats, size_t size);
+
+// zlib zalloc/zfree hooks; opaque is the op_stats_t to charge
+void *op_stats_zalloc(void *opaque, unsigned items, unsigned size);
+void op_stats_zfree(void *opaque, void *address);
+
+void op_stats_snapshot(const op_stats_t *stats, op_snapshot_t *out);
+
+// Upper bound of the bucket holding quantile q (0..1), clamped to max_ns
+uint64_t op_histogram_quantile(const op_histogram_t *hist, double q);
+uint64_t op_stats_bucket_upper(int index);
+
+// Prometheus text exposition of a snapshot; returns a malloc'd string
+char *op_stats_prometheus(const op_stats_t *stats, const op_snapshot_t *snap, const char *prefix);
+
+#endif // OP_STATS_H
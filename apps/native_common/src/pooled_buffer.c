@@ -0,0 +1,289 @@
+#define _GNU_SOURCE
+#include "pooled_buffer.h"
+#include <pthread.h>
+#include <string.h>
+
+#ifndef Py_TPFLAGS_IMMUTABLETYPE
+#define Py_TPFLAGS_IMMUTABLETYPE 0
+#endif
+#ifndef Py_TPFLAGS_DISALLOW_INSTANTIATION
+#define Py_TPFLAGS_DISALLOW_INSTANTIATION 0
+#endif
+
+typedef struct {
+    PyObject_HEAD
+    pthread_mutex_t lock;  // Guards data and exports without the GIL
+    char *data;            // NULL once released
+    Py_ssize_t size;
+    Py_ssize_t exports;
+} PooledBufferObject;
+
+// Pins the bytes for a copy or compare done outside the lock
+static char* pin(PooledBufferObject *self) {
+    pthread_mutex_lock(&self->lock);
+    char *data = self->data;
+    if (data != NULL) {
+        self->exports++;
+    }
+    pthread_mutex_unlock(&self->lock);
+    if (data == NULL) {
+        PyErr_SetString(PyExc_ValueError, "operation on released pooled buffer");
+    }
+    return data;
+}
+
+static void unpin(PooledBufferObject *self) {
+    pthread_mutex_lock(&self->lock);
+    self->exports--;
+    pthread_mutex_unlock(&self->lock);
+}
+
+static void PooledBuffer_dealloc(PooledBufferObject *self) {
+    buffer_pool_free(self->data);
+    pthread_mutex_destroy(&self->lock);
+    PyTypeObject *type = Py_TYPE(self);
+    type->tp_free((PyObject*)self);
+    Py_DECREF(type);
+}
+
+static int PooledBuffer_getbuffer(PooledBufferObject *self, Py_buffer *view, int flags) {
+    pthread_mutex_lock(&self->lock);
+    if (self->data == NULL) {
+        pthread_mutex_unlock(&self->lock);
+        PyErr_SetString(PyExc_BufferError, "pooled buffer is released");
+        view->obj = NULL;
+        return -1;
+    }
+    if (PyBuffer_FillInfo(view, (PyObject*)self, self->data, self->size, 0, flags) < 0) {
+        pthread_mutex_unlock(&self->lock);
+        return -1;
+    }
+    self->exports++;
+    pthread_mutex_unlock(&self->lock);
+    return 0;
+}
+
+static void PooledBuffer_releasebuffer(PooledBufferObject *self, Py_buffer *view) {
+    (void)view;
+    unpin(self);
+}
+
+static Py_ssize_t PooledBuffer_length(PooledBufferObject *self) {
+    pthread_mutex_lock(&self->lock);
+    Py_ssize_t size = self->data != NULL ? self->size : 0;
+    pthread_mutex_unlock(&self->lock);
+    return size;
+}
+
+static PyObject* PooledBuffer_release(PooledBufferObject *self, PyObject *args) {
+    (void)args;
+    pthread_mutex_lock(&self->lock);
+    if (self->exports > 0) {
+        pthread_mutex_unlock(&self->lock);
+        PyErr_SetString(PyExc_BufferError, "pooled buffer views are still in use");
+        return NULL;
+    }
+    char *data = self->data;
+    self->data = NULL;
+    pthread_mutex_unlock(&self->lock);
+    buffer_pool_free(data);
+    Py_RETURN_NONE;
+}
+
+static PyObject* PooledBuffer_tobytes(PooledBufferObject *self, PyObject *args) {
+    (void)args;
+    char *data = pin(self);
+    if (data == NULL) {
+        return NULL;
+    }
+    PyObject *ret = PyBytes_FromStringAndSize(data, self->size);
+    unpin(self);
+    return ret;
+}
+
+static PyObject* PooledBuffer_richcompare(PooledBufferObject *self, PyObject *other, int op) {
+    if ((op != Py_EQ && op != Py_NE) || !PyObject_CheckBuffer(other)) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    Py_buffer view;
+    if (PyObject_GetBuffer(other, &view, PyBUF_SIMPLE) < 0) {
+        return NULL;
+    }
+    char *data = pin(self);
+    if (data == NULL) {
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+    int equal = view.len == self->size && memcmp(view.buf, data, (size_t)self->size) == 0;
+    unpin(self);
+    PyBuffer_Release(&view);
+    return PyBool_FromLong(op == Py_EQ ? equal : !equal);
+}
+
+static PyObject* PooledBuffer_get_capacity(PooledBufferObject *self, void *closure) {
+    (void)closure;
+    pthread_mutex_lock(&self->lock);
+    size_t capacity = self->data != NULL ? buffer_pool_capacity(self->data) : 0;
+    pthread_mutex_unlock(&self->lock);
+    return PyLong_FromSize_t(capacity);
+}
+
+static PyObject* PooledBuffer_get_released(PooledBufferObject *self, void *closure) {
+    (void)closure;
+    pthread_mutex_lock(&self->lock);
+    int released = self->data == NULL;
+    pthread_mutex_unlock(&self->lock);
+    return PyBool_FromLong(released);
+}
+
+static PyMethodDef PooledBuffer_methods[] = {
+    {"release", (PyCFunction)PooledBuffer_release, METH_NOARGS,
+     "Return the memory to the pool; fails while views are exported"},
+    {"tobytes", (PyCFunction)PooledBuffer_tobytes, METH_NOARGS, "Copy the contents into bytes"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef PooledBuffer_getset[] = {
+    {"capacity", (getter)PooledBuffer_get_capacity, NULL, "Usable bytes of the pooled block", NULL},
+    {"released", (getter)PooledBuffer_get_released, NULL, "Whether release() has been called", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PyType_Slot PooledBuffer_slots[] = {
+    {Py_tp_doc, "Buffer borrowed from the native buffer pool"},
+    {Py_tp_dealloc, PooledBuffer_dealloc},
+    {Py_tp_richcompare, PooledBuffer_richcompare},
+    {Py_tp_hash, PyObject_HashNotImplemented},
+    {Py_tp_methods, PooledBuffer_methods},
+    {Py_tp_getset, PooledBuffer_getset},
+    {Py_sq_length, PooledBuffer_length},
+    {Py_bf_getbuffer, PooledBuffer_getbuffer},
+    {Py_bf_releasebuffer, PooledBuffer_releasebuffer},
+    {0, NULL}
+};
+
+PyTypeObject *pooled_buffer_type_new(PyObject *module, const char *name) {
+    PyType_Spec spec = {
+        .name = name,
+        .basicsize = sizeof(PooledBufferObject),
+        .itemsize = 0,
+        .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_IMMUTABLETYPE | Py_TPFLAGS_DISALLOW_INSTANTIATION,
+        .slots = PooledBuffer_slots,
+    };
+    return (PyTypeObject*)PyType_FromModuleAndSpec(module, &spec, NULL);
+}
+
+PyObject *pooled_buffer_wrap(PyTypeObject *type, void *data, size_t size) {
+    PooledBufferObject *self = (PooledBufferObject*)type->tp_alloc(type, 0);
+    if (self == NULL) {
+        buffer_pool_free(data);
+        return NULL;
+    }
+    pthread_mutex_init(&self->lock, NULL);
+    self->data = data;
+    self->size = (Py_ssize_t)size;
+    return (PyObject*)self;
+}
+
+PyObject *pooled_buffer_alloc(PyTypeObject *type, PyObject *args) {
+    Py_ssize_t size;
+    if (!PyArg_ParseTuple(args, "n", &size)) {
+        return NULL;
+    }
+    if (size < 0) {
+        PyErr_SetString(PyExc_ValueError, "Invalid buffer size");
+        return NULL;
+    }
+
+    void *data;
+    Py_BEGIN_ALLOW_THREADS
+    // Recycled blocks still hold earlier plaintext or chunks
+    data = buffer_pool_alloc((size_t)size);
+    if (data != NULL) {
+        memset(data, 0, (size_t)size);
+    }
+    Py_END_ALLOW_THREADS
+    if (data == NULL) {
+        return PyErr_NoMemory();
+    }
+    return pooled_buffer_wrap(type, data, (size_t)size);
+}
+
+static int parse_limit_mb(Py_ssize_t mb, size_t *bytes) {
+    if (mb < 0) {
+        *bytes = SIZE_MAX;
+        return 0;
+    }
+    if ((size_t)mb > (SIZE_MAX >> 21)) {
+        PyErr_SetString(PyExc_ValueError, "Cache limit too large");
+        return -1;
+    }
+    *bytes = (size_t)mb << 20;
+    return 0;
+}
+
+PyObject *pooled_buffer_configure(PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"max_cached_mb", "thread_cache_mb", "hugepages", NULL};
+    Py_ssize_t max_cached_mb = -1;
+    Py_ssize_t thread_cache_mb = -1;
+    const char *hugepages = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|nnz", kwlist,
+                                     &max_cached_mb, &thread_cache_mb, &hugepages)) {
+        return NULL;
+    }
+
+    size_t max_cached, thread_cache;
+    if (parse_limit_mb(max_cached_mb, &max_cached) < 0 ||
+        parse_limit_mb(thread_cache_mb, &thread_cache) < 0) {
+        return NULL;
+    }
+
+    buffer_pool_stats_t current;
+    buffer_pool_stats(&current);
+    buffer_hugepages_t mode = current.hugepages;
+    if (hugepages != NULL) {
+        if (strcmp(hugepages, "off") == 0) {
+            mode = BUFFER_HUGEPAGES_OFF;
+        } else if (strcmp(hugepages, "thp") == 0) {
+            mode = BUFFER_HUGEPAGES_THP;
+        } else if (strcmp(hugepages, "hugetlb") == 0) {
+            mode = BUFFER_HUGEPAGES_HUGETLB;
+        } else {
+            PyErr_SetString(PyExc_ValueError, "hugepages must be 'off', 'thp' or 'hugetlb'");
+            return NULL;
+        }
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    buffer_pool_configure(max_cached, thread_cache, mode);
+    Py_END_ALLOW_THREADS
+    Py_RETURN_NONE;
+}
+
+PyObject *pooled_buffer_trim(void) {
+    Py_BEGIN_ALLOW_THREADS
+    buffer_pool_trim();
+    Py_END_ALLOW_THREADS
+    Py_RETURN_NONE;
+}
+
+PyObject *pooled_buffer_stats(void) {
+    buffer_pool_stats_t stats;
+    buffer_pool_stats(&stats);
+    return Py_BuildValue("{s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:n,s:n,s:s}",
+                         "allocations", (unsigned long long)stats.allocations,
+                         "thread_hits", (unsigned long long)stats.thread_hits,
+                         "shared_hits", (unsigned long long)stats.shared_hits,
+                         "maps", (unsigned long long)stats.maps,
+                         "unmaps", (unsigned long long)stats.unmaps,
+                         "hugetlb_maps", (unsigned long long)stats.hugetlb_maps,
+                         "thp_maps", (unsigned long long)stats.thp_maps,
+                         "hugetlb_failures", (unsigned long long)stats.hugetlb_failures,
+                         "mapped_bytes", (unsigned long long)stats.mapped_bytes,
+                         "in_use_bytes", (unsigned long long)stats.in_use_bytes,
+                         "cached_bytes", (unsigned long long)stats.cached_bytes,
+                         "max_cached_bytes", (Py_ssize_t)stats.max_cached_bytes,
+                         "thread_cache_bytes", (Py_ssize_t)stats.thread_cache_bytes,
+                         "hugepages", buffer_pool_hugepages_name(stats.hugepages));
+}
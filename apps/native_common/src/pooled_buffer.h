@@ -0,0 +1,27 @@
+#ifndef POOLED_BUFFER_H
+#define POOLED_BUFFER_H
+
+#include <Python.h>
+#include "buffer_pool.h"
+
+// PooledBuffer: a writable buffer-protocol object over one buffer_pool
+// block, so native results reach Python (and go back into native calls)
+// without a copy. The block returns to the pool when the object is
+// collected or release() is called with no views left.
+
+// Heap type for a module instance; name must have static storage
+PyTypeObject *pooled_buffer_type_new(PyObject *module, const char *name);
+
+// Wraps size bytes of a buffer_pool_alloc block, taking ownership; on
+// failure the block is freed and NULL returned with an exception set
+PyObject *pooled_buffer_wrap(PyTypeObject *type, void *data, size_t size);
+
+// Module functions shared by the extensions: alloc_buffer(size),
+// configure_buffer_pool(max_cached_mb, thread_cache_mb, hugepages),
+// trim_buffer_pool() and buffer_pool_stats()
+PyObject *pooled_buffer_alloc(PyTypeObject *type, PyObject *args);
+PyObject *pooled_buffer_configure(PyObject *args, PyObject *kwds);
+PyObject *pooled_buffer_trim(void);
+PyObject *pooled_buffer_stats(void);
+
+#endif // POOLED_BUFFER_H
@@ -0,0 +1,13 @@
+# PII Scanner Module
+# Single-pass PII detection and redaction
+
+"""
+File: /app/apps/pii_scanner/__init__.py
+x-lucid-file-path: /app/apps/pii_scanner/__init__.py
+x-lucid-file-type: python
+
+PII Scanner package for Lucid RDP.
+Contains the native multi-pattern PII scanner used by the privacy shield.
+"""
+
+__all__ = []
@@ -0,0 +1,13 @@
+# PII Scanner Source Module
+# PII scanner native source code components
+
+"""
+File: /app/apps/pii_scanner/src/__init__.py
+x-lucid-file-path: /app/apps/pii_scanner/src/__init__.py
+x-lucid-file-type: python
+
+PII Scanner Source package for Lucid RDP.
+Contains PII scanner native source code and C implementations.
+"""
+
+__all__ = []
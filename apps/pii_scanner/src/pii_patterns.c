@@ -0,0 +1,413 @@
+#include "pii_patterns.h"
+#include <stdlib.h>
+
+#define NOMATCH ((size_t)-1)
+
+// Byte class bits; a pattern element matches when any of its bits is set
+enum {
+    B_D0 = 1u << 0,
+    B_D1 = 1u << 1,
+    B_D2 = 1u << 2,
+    B_D3 = 1u << 3,
+    B_D4 = 1u << 4,
+    B_D5_8 = 1u << 5,
+    B_D9 = 1u << 6,
+    B_UPPER_HEX = 1u << 7,   // A-F
+    B_UPPER_REST = 1u << 8,  // G-Z
+    B_LOWER_HEX = 1u << 9,   // a-f
+    B_LOWER_REST = 1u << 10, // g-z
+    B_AT = 1u << 11,
+    B_DOT = 1u << 12,
+    B_HYPHEN = 1u << 13,
+    B_SLASH = 1u << 14,
+    B_COLON = 1u << 15,
+    B_PLUS = 1u << 16,
+    B_LPAREN = 1u << 17,
+    B_RPAREN = 1u << 18,
+    B_SPACE = 1u << 19,
+    B_WS = 1u << 20,         // \t \n \v \f \r
+    B_UNDERSCORE = 1u << 21,
+    B_PERCENT = 1u << 22
+};
+
+#define C_DIGIT (B_D0 | B_D1 | B_D2 | B_D3 | B_D4 | B_D5_8 | B_D9)
+#define C_UPPER (B_UPPER_HEX | B_UPPER_REST)
+#define C_LOWER (B_LOWER_HEX | B_LOWER_REST)
+#define C_ALPHA (C_UPPER | C_LOWER)
+#define C_HEX (C_DIGIT | B_UPPER_HEX | B_LOWER_HEX)
+#define C_SEP (B_HYPHEN | B_DOT | B_SPACE | B_WS)   // [-.\s]
+#define C_CARD_SEP (B_HYPHEN | B_SPACE | B_WS)      // [-\s]
+#define C_LOCAL (C_DIGIT | C_ALPHA | B_DOT | B_UNDERSCORE | B_PERCENT | B_PLUS | B_HYPHEN)
+#define C_DOMAIN (C_DIGIT | C_ALPHA | B_DOT | B_HYPHEN)
+
+// Greedy element: between min and max bytes of the class
+typedef struct {
+    uint32_t mask;
+    uint16_t min;
+    uint16_t max;
+} pii_elem_t;
+
+typedef size_t (*pii_custom_fn)(const uint8_t *data, size_t len, size_t pos);
+typedef int (*pii_validate_fn)(const uint8_t *p, size_t n);
+
+// One expansion of a PrivacyShield regex. Optional groups and alternations
+// are expanded into separate rows, listed in the order the regex tries them.
+typedef struct {
+    pii_type_t type;
+    int bounded;  // \b at both ends
+    int nelems;
+    pii_elem_t elems[PII_MAX_ELEMS];
+    pii_custom_fn custom;
+    pii_validate_fn validate;
+    uint32_t first;  // Classes that can start a match, filled by init
+} pii_pattern_t;
+
+#define E(mask, lo, hi) {(mask), (lo), (hi)}
+
+static int luhn_valid(const uint8_t *p, size_t n);
+static size_t match_dob_mdy(const uint8_t *data, size_t len, size_t pos);
+static size_t match_dob_ymd(const uint8_t *data, size_t len, size_t pos);
+
+static pii_pattern_t patterns[] = {
+    // \b[A-Za-z0-9._%+-]+@[A-Za-z0-9.-]+\.[A-Za-z]{2,}\b
+    {PII_EMAIL, 1, 5, {E(C_LOCAL, 1, 64), E(B_AT, 1, 1), E(C_DOMAIN, 1, 255),
+                       E(B_DOT, 1, 1), E(C_ALPHA, 2, 63)}, NULL, NULL, 0},
+    // \b\d{4}[-\s]?\d{4}[-\s]?\d{4}[-\s]?\d{4}\b, Luhn checked
+    {PII_CREDIT_CARD, 1, 7, {E(C_DIGIT, 4, 4), E(C_CARD_SEP, 0, 1), E(C_DIGIT, 4, 4),
+                             E(C_CARD_SEP, 0, 1), E(C_DIGIT, 4, 4), E(C_CARD_SEP, 0, 1),
+                             E(C_DIGIT, 4, 4)}, NULL, luhn_valid, 0},
+    // \b\d{3}-?\d{2}-?\d{4}\b
+    {PII_SSN, 1, 5, {E(C_DIGIT, 3, 3), E(B_HYPHEN, 0, 1), E(C_DIGIT, 2, 2),
+                     E(B_HYPHEN, 0, 1), E(C_DIGIT, 4, 4)}, NULL, NULL, 0},
+    // (\+?1[-.\s]?)?\(?(\d{3})\)?[-.\s]?(\d{3})[-.\s]?(\d{4})
+    {PII_PHONE, 0, 10, {E(B_PLUS, 0, 1), E(B_D1, 1, 1), E(C_SEP, 0, 1), E(B_LPAREN, 0, 1),
+                        E(C_DIGIT, 3, 3), E(B_RPAREN, 0, 1), E(C_SEP, 0, 1), E(C_DIGIT, 3, 3),
+                        E(C_SEP, 0, 1), E(C_DIGIT, 4, 4)}, NULL, NULL, 0},
+    {PII_PHONE, 0, 7, {E(B_LPAREN, 0, 1), E(C_DIGIT, 3, 3), E(B_RPAREN, 0, 1), E(C_SEP, 0, 1),
+                       E(C_DIGIT, 3, 3), E(C_SEP, 0, 1), E(C_DIGIT, 4, 4)}, NULL, NULL, 0},
+    // (\+?44[-.\s]?)?\(?(\d{4})\)?[-.\s]?(\d{3})[-.\s]?(\d{3})
+    {PII_PHONE, 0, 10, {E(B_PLUS, 0, 1), E(B_D4, 2, 2), E(C_SEP, 0, 1), E(B_LPAREN, 0, 1),
+                        E(C_DIGIT, 4, 4), E(B_RPAREN, 0, 1), E(C_SEP, 0, 1), E(C_DIGIT, 3, 3),
+                        E(C_SEP, 0, 1), E(C_DIGIT, 3, 3)}, NULL, NULL, 0},
+    {PII_PHONE, 0, 7, {E(B_LPAREN, 0, 1), E(C_DIGIT, 4, 4), E(B_RPAREN, 0, 1), E(C_SEP, 0, 1),
+                       E(C_DIGIT, 3, 3), E(C_SEP, 0, 1), E(C_DIGIT, 3, 3)}, NULL, NULL, 0},
+    // \b(?:[0-9]{1,3}\.){3}[0-9]{1,3}\b
+    {PII_IP_ADDRESS, 1, 7, {E(C_DIGIT, 1, 3), E(B_DOT, 1, 1), E(C_DIGIT, 1, 3), E(B_DOT, 1, 1),
+                            E(C_DIGIT, 1, 3), E(B_DOT, 1, 1), E(C_DIGIT, 1, 3)}, NULL, NULL, 0},
+    // \b(?:[0-9A-Fa-f]{2}[:-]){5}(?:[0-9A-Fa-f]{2})\b
+    {PII_MAC_ADDRESS, 1, 11, {E(C_HEX, 2, 2), E(B_COLON | B_HYPHEN, 1, 1), E(C_HEX, 2, 2),
+                              E(B_COLON | B_HYPHEN, 1, 1), E(C_HEX, 2, 2),
+                              E(B_COLON | B_HYPHEN, 1, 1), E(C_HEX, 2, 2),
+                              E(B_COLON | B_HYPHEN, 1, 1), E(C_HEX, 2, 2),
+                              E(B_COLON | B_HYPHEN, 1, 1), E(C_HEX, 2, 2)}, NULL, NULL, 0},
+    // Month/day/year and year/month/day, see match_dob_*
+    {PII_DATE_OF_BIRTH, 1, 0, {E(0, 0, 0)}, match_dob_mdy, NULL, 0},
+    {PII_DATE_OF_BIRTH, 1, 0, {E(0, 0, 0)}, match_dob_ymd, NULL, 0},
+    // \b[A-Z]\d{7,8}\b, ahead of passports so the narrower pattern names the match
+    {PII_DRIVER_LICENSE, 1, 2, {E(C_ALPHA, 1, 1), E(C_DIGIT, 7, 8)}, NULL, NULL, 0},
+    // \b[A-Z]{1,2}\d{6,9}\b
+    {PII_PASSPORT, 1, 2, {E(C_ALPHA, 1, 2), E(C_DIGIT, 6, 9)}, NULL, NULL, 0},
+    // \b[A-Z][a-z]+ [A-Z][a-z]+ [A-Z][a-z]+\b, then \b[A-Z][a-z]+ [A-Z][a-z]+\b
+    {PII_NAME, 1, 8, {E(C_UPPER, 1, 1), E(C_LOWER, 1, 255), E(B_SPACE, 1, 1),
+                      E(C_UPPER, 1, 1), E(C_LOWER, 1, 255), E(B_SPACE, 1, 1),
+                      E(C_UPPER, 1, 1), E(C_LOWER, 1, 255)}, NULL, NULL, 0},
+    {PII_NAME, 1, 5, {E(C_UPPER, 1, 1), E(C_LOWER, 1, 255), E(B_SPACE, 1, 1),
+                      E(C_UPPER, 1, 1), E(C_LOWER, 1, 255)}, NULL, NULL, 0},
+};
+
+#define NPATTERNS (sizeof(patterns) / sizeof(patterns[0]))
+
+static uint32_t byte_class[256];
+static uint8_t word_byte[256];   // \w; bytes >= 0x80 count as word, as Unicode letters do
+static uint32_t any_first;       // Classes that start some pattern
+static uint32_t unbounded_first; // ... a pattern that needs no leading \b
+static size_t max_match;
+static int initialized = 0;
+
+void pii_patterns_init(void) {
+    if (initialized) {
+        return;
+    }
+
+    static const uint32_t digit_bits[10] = {
+        B_D0, B_D1, B_D2, B_D3, B_D4, B_D5_8, B_D5_8, B_D5_8, B_D5_8, B_D9
+    };
+    for (int c = '0'; c <= '9'; c++) {
+        byte_class[c] = digit_bits[c - '0'];
+    }
+    for (int c = 'A'; c <= 'Z'; c++) {
+        byte_class[c] = c <= 'F' ? B_UPPER_HEX : B_UPPER_REST;
+        byte_class[c + 32] = c <= 'F' ? B_LOWER_HEX : B_LOWER_REST;
+    }
+    byte_class['@'] = B_AT;
+    byte_class['.'] = B_DOT;
+    byte_class['-'] = B_HYPHEN;
+    byte_class['/'] = B_SLASH;
+    byte_class[':'] = B_COLON;
+    byte_class['+'] = B_PLUS;
+    byte_class['('] = B_LPAREN;
+    byte_class[')'] = B_RPAREN;
+    byte_class[' '] = B_SPACE;
+    byte_class['\t'] = byte_class['\n'] = byte_class['\v'] = B_WS;
+    byte_class['\f'] = byte_class['\r'] = B_WS;
+    byte_class['_'] = B_UNDERSCORE;
+    byte_class['%'] = B_PERCENT;
+
+    for (int c = 0; c < 256; c++) {
+        word_byte[c] = (byte_class[c] & (C_DIGIT | C_ALPHA | B_UNDERSCORE)) || c >= 0x80;
+    }
+
+    for (size_t p = 0; p < NPATTERNS; p++) {
+        pii_pattern_t *pat = &patterns[p];
+        size_t longest = 0;
+        if (pat->custom) {
+            pat->first = C_DIGIT;
+            longest = 10;  // mm/dd/yyyy
+        } else {
+            int leading = 1;
+            for (int k = 0; k < pat->nelems; k++) {
+                // Optional leading elements let the next one start the match too
+                if (leading) {
+                    pat->first |= pat->elems[k].mask;
+                    leading = pat->elems[k].min == 0;
+                }
+                longest += pat->elems[k].max;
+            }
+        }
+        any_first |= pat->first;
+        if (!pat->bounded) {
+            unbounded_first |= pat->first;
+        }
+        if (longest > max_match) {
+            max_match = longest;
+        }
+    }
+    max_match += 1;  // Trailing \b looks one byte past the match
+    initialized = 1;
+}
+
+size_t pii_max_match(void) {
+    return max_match;
+}
+
+static inline int word_at(const uint8_t *data, size_t len, size_t pos, int prev) {
+    if (pos == (size_t)-1) {
+        return prev >= 0 && word_byte[prev];
+    }
+    return pos < len && word_byte[data[pos]];
+}
+
+static inline int boundary_at(const uint8_t *data, size_t len, size_t pos, int prev) {
+    return word_at(data, len, pos - 1, prev) != word_at(data, len, pos, prev);
+}
+
+// Backtracking over greedy counts, as re does; rows are short and
+// bounded, so the work per start offset is bounded too. The trailing \b
+// is part of the backtrack: a@b.co.uk_ still matches a@b.co.
+static size_t match_elems(const pii_pattern_t *pat, int k, const uint8_t *data,
+                          size_t len, size_t pos) {
+    if (k == pat->nelems) {
+        return pat->bounded && word_at(data, len, pos, -1) ? NOMATCH : pos;
+    }
+    const pii_elem_t *e = &pat->elems[k];
+    size_t run = 0;
+    while (run < e->max && pos + run < len && (byte_class[data[pos + run]] & e->mask)) {
+        run++;
+    }
+    if (run < e->min) {
+        return NOMATCH;
+    }
+    for (size_t j = run + 1; j-- > e->min;) {
+        size_t end = match_elems(pat, k + 1, data, len, pos + j);
+        if (end != NOMATCH) {
+            return end;
+        }
+    }
+    return NOMATCH;
+}
+
+static int luhn_valid(const uint8_t *p, size_t n) {
+    int sum = 0, digits = 0;
+    for (size_t i = n; i-- > 0;) {
+        if (!(byte_class[p[i]] & C_DIGIT)) {
+            continue;
+        }
+        int d = p[i] - '0';
+        if (digits++ & 1) {
+            d *= 2;
+            if (d > 9) {
+                d -= 9;
+            }
+        }
+        sum += d;
+    }
+    return digits >= 13 && digits <= 19 && sum % 10 == 0;
+}
+
+static inline int digit_at(const uint8_t *data, size_t len, size_t pos, int lo, int hi) {
+    return pos < len && data[pos] >= lo && data[pos] <= hi;
+}
+
+// Lengths of (0?[1-9]|1[0-2]) at pos, in the order re tries them
+static int month_lengths(const uint8_t *data, size_t len, size_t pos, size_t out[3]) {
+    int n = 0;
+    if (digit_at(data, len, pos, '0', '0') && digit_at(data, len, pos + 1, '1', '9')) {
+        out[n++] = 2;
+    }
+    if (digit_at(data, len, pos, '1', '9')) {
+        out[n++] = 1;
+    }
+    if (digit_at(data, len, pos, '1', '1') && digit_at(data, len, pos + 1, '0', '2')) {
+        out[n++] = 2;
+    }
+    return n;
+}
+
+// Lengths of (0?[1-9]|[12][0-9]|3[01]) at pos
+static int day_lengths(const uint8_t *data, size_t len, size_t pos, size_t out[4]) {
+    int n = 0;
+    if (digit_at(data, len, pos, '0', '0') && digit_at(data, len, pos + 1, '1', '9')) {
+        out[n++] = 2;
+    }
+    if (digit_at(data, len, pos, '1', '9')) {
+        out[n++] = 1;
+    }
+    if (digit_at(data, len, pos, '1', '2') && digit_at(data, len, pos + 1, '0', '9')) {
+        out[n++] = 2;
+    }
+    if (digit_at(data, len, pos, '3', '3') && digit_at(data, len, pos + 1, '0', '1')) {
+        out[n++] = 2;
+    }
+    return n;
+}
+
+// (19|20)\d{2}
+static int year_at(const uint8_t *data, size_t len, size_t pos) {
+    int century = (digit_at(data, len, pos, '1', '1') && digit_at(data, len, pos + 1, '9', '9')) ||
+                  (digit_at(data, len, pos, '2', '2') && digit_at(data, len, pos + 1, '0', '0'));
+    return century && digit_at(data, len, pos + 2, '0', '9') && digit_at(data, len, pos + 3, '0', '9');
+}
+
+static inline int date_sep_at(const uint8_t *data, size_t len, size_t pos) {
+    return pos < len && (data[pos] == '-' || data[pos] == '/');
+}
+
+// \b(0?[1-9]|1[0-2])[-/](0?[1-9]|[12][0-9]|3[01])[-/](19|20)\d{2}\b
+static size_t match_dob_mdy(const uint8_t *data, size_t len, size_t pos) {
+    size_t months[3], days[4];
+    int nm = month_lengths(data, len, pos, months);
+    for (int m = 0; m < nm; m++) {
+        size_t q = pos + months[m];
+        if (!date_sep_at(data, len, q)) {
+            continue;
+        }
+        int nd = day_lengths(data, len, q + 1, days);
+        for (int d = 0; d < nd; d++) {
+            size_t r = q + 1 + days[d];
+            if (date_sep_at(data, len, r) && year_at(data, len, r + 1) &&
+                !word_at(data, len, r + 5, -1)) {
+                return r + 5;
+            }
+        }
+    }
+    return NOMATCH;
+}
+
+// \b(19|20)\d{2}[-/](0?[1-9]|1[0-2])[-/](0?[1-9]|[12][0-9]|3[01])\b
+static size_t match_dob_ymd(const uint8_t *data, size_t len, size_t pos) {
+    size_t months[3], days[4];
+    if (!year_at(data, len, pos) || !date_sep_at(data, len, pos + 4)) {
+        return NOMATCH;
+    }
+    int nm = month_lengths(data, len, pos + 5, months);
+    for (int m = 0; m < nm; m++) {
+        size_t q = pos + 5 + months[m];
+        if (!date_sep_at(data, len, q)) {
+            continue;
+        }
+        int nd = day_lengths(data, len, q + 1, days);
+        for (int d = 0; d < nd; d++) {
+            size_t end = q + 1 + days[d];
+            if (!word_at(data, len, end, -1)) {
+                return end;
+            }
+        }
+    }
+    return NOMATCH;
+}
+
+static int spans_push(pii_spans_t *out, uint32_t type, size_t start, size_t end) {
+    if (out->len == out->cap) {
+        size_t cap = out->cap ? out->cap * 2 : 64;
+        pii_span_t *spans = realloc(out->spans, cap * sizeof(pii_span_t));
+        if (!spans) {
+            return -1;
+        }
+        out->spans = spans;
+        out->cap = cap;
+    }
+    out->spans[out->len].type = type;
+    out->spans[out->len].start = start;
+    out->spans[out->len].end = end;
+    out->len++;
+    return 0;
+}
+
+int pii_scan(const uint8_t *data, size_t len, size_t from, size_t stop,
+             int prev, uint32_t types, pii_spans_t *out, size_t *resume) {
+    size_t i = from;
+
+    while (i < stop) {
+        uint32_t cls = byte_class[data[i]];
+        // Most bytes start nothing, and inside a word only phone numbers can
+        if (!(cls & any_first) ||
+            (!(cls & unbounded_first) && !boundary_at(data, len, i, prev))) {
+            i++;
+            continue;
+        }
+
+        int boundary = -1;
+        size_t end = NOMATCH;
+        uint32_t type = 0;
+        for (size_t p = 0; p < NPATTERNS; p++) {
+            const pii_pattern_t *pat = &patterns[p];
+            if (!(types & (1u << pat->type)) || !(cls & pat->first)) {
+                continue;
+            }
+            if (pat->bounded) {
+                if (boundary < 0) {
+                    boundary = boundary_at(data, len, i, prev);
+                }
+                if (!boundary) {
+                    continue;
+                }
+            }
+            size_t e = pat->custom ? pat->custom(data, len, i)
+                                   : match_elems(pat, 0, data, len, i);
+            if (e == NOMATCH || (pat->validate && !pat->validate(data + i, e - i))) {
+                continue;
+            }
+            end = e;
+            type = pat->type;
+            break;
+        }
+
+        if (end == NOMATCH) {
+            i++;
+            continue;
+        }
+        if (spans_push(out, type, i, end) < 0) {
+            return -1;
+        }
+        i = end;
+    }
+
+    *resume = i;
+    return 0;
+}
+
+void pii_spans_free(pii_spans_t *spans) {
+    free(spans->spans);
+    spans->spans = NULL;
+    spans->len = spans->cap = 0;
+}
@@ -0,0 +1,53 @@
+#ifndef PII_PATTERNS_H
+#define PII_PATTERNS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// PII types; at a shared start offset the lower value wins
+typedef enum {
+    PII_EMAIL = 0,
+    PII_CREDIT_CARD = 1,
+    PII_SSN = 2,
+    PII_PHONE = 3,
+    PII_IP_ADDRESS = 4,
+    PII_MAC_ADDRESS = 5,
+    PII_DATE_OF_BIRTH = 6,
+    PII_DRIVER_LICENSE = 7,
+    PII_PASSPORT = 8,
+    PII_NAME = 9,
+    PII_TYPE_COUNT = 10
+} pii_type_t;
+
+#define PII_ALL_TYPES ((1u << PII_TYPE_COUNT) - 1)
+#define PII_MAX_ELEMS 12
+
+typedef struct {
+    uint32_t type;
+    size_t start;
+    size_t end;
+} pii_span_t;
+
+// Growable span list; pii_scan returns -1 only on allocation failure
+typedef struct {
+    pii_span_t *spans;
+    size_t len;
+    size_t cap;
+} pii_spans_t;
+
+// Builds the byte class and dispatch tables; call once before scanning
+void pii_patterns_init(void);
+
+// Longest possible match plus its trailing boundary byte. Streaming
+// callers hold this many bytes back so no match is cut by a chunk edge.
+size_t pii_max_match(void);
+
+// Appends non-overlapping matches starting in [from, stop) to out.
+// data[0, len) is readable; prev is the byte before data[0] or -1.
+// *resume receives the first offset not yet scanned (>= stop).
+int pii_scan(const uint8_t *data, size_t len, size_t from, size_t stop,
+             int prev, uint32_t types, pii_spans_t *out, size_t *resume);
+
+void pii_spans_free(pii_spans_t *spans);
+
+#endif // PII_PATTERNS_H
@@ -0,0 +1,496 @@
+/*
+ * Native PII scanner extension for Lucid RDP
+ * Every PrivacyShield pattern in one table behind a first-byte dispatch:
+ * a single pass yields non-overlapping (type, start, end) spans, masks them
+ * in place, or redacts a stream chunk by chunk
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <stdint.h>
+#include <string.h>
+#include "pii_scanner.h"
+#include "pii_patterns.h"
+
+static const char *type_names[PII_TYPE_COUNT] = {
+    "email", "credit_card", "ssn", "phone", "ip_address", "mac_address",
+    "date_of_birth", "driver_license", "passport", "name"
+};
+
+// Scan input: bytes-like objects are scanned as-is, str as UTF-8
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+    int is_str;
+    int ascii;
+    Py_buffer view;
+    int has_view;
+} scan_input_t;
+
+static int input_acquire(PyObject *obj, scan_input_t *in) {
+    memset(in, 0, sizeof(*in));
+    if (PyUnicode_Check(obj)) {
+        in->is_str = 1;
+        if (PyUnicode_IS_ASCII(obj)) {
+            in->ascii = 1;
+            in->data = (const uint8_t*)PyUnicode_DATA(obj);
+            in->len = (size_t)PyUnicode_GET_LENGTH(obj);
+        } else {
+            Py_ssize_t n;
+            // Cached on the str object, so it lives as long as obj does
+            const char *utf8 = PyUnicode_AsUTF8AndSize(obj, &n);
+            if (utf8 == NULL) {
+                return -1;
+            }
+            in->data = (const uint8_t*)utf8;
+            in->len = (size_t)n;
+        }
+        return 0;
+    }
+    if (PyObject_GetBuffer(obj, &in->view, PyBUF_SIMPLE) < 0) {
+        return -1;
+    }
+    in->has_view = 1;
+    in->data = (const uint8_t*)in->view.buf;
+    in->len = (size_t)in->view.len;
+    return 0;
+}
+
+static void input_release(scan_input_t *in) {
+    if (in->has_view) {
+        PyBuffer_Release(&in->view);
+        in->has_view = 0;
+    }
+}
+
+static int parse_types(unsigned int types) {
+    if (types & ~PII_ALL_TYPES) {
+        PyErr_SetString(PyExc_ValueError, "Unknown PII type bits");
+        return -1;
+    }
+    return 0;
+}
+
+static int parse_mask(int mask) {
+    if (mask <= 0 || mask >= 0x80) {
+        PyErr_SetString(PyExc_ValueError, "Mask must be a single ASCII character");
+        return -1;
+    }
+    return 0;
+}
+
+static int scan_all(const uint8_t *data, size_t len, unsigned int types, pii_spans_t *spans) {
+    size_t resume;
+    int rc;
+
+    Py_BEGIN_ALLOW_THREADS
+    rc = pii_scan(data, len, 0, len, -1, types, spans, &resume);
+    Py_END_ALLOW_THREADS
+
+    if (rc < 0) {
+        pii_spans_free(spans);
+        PyErr_NoMemory();
+    }
+    return rc;
+}
+
+static void mask_spans(uint8_t *data, const pii_spans_t *spans, int mask) {
+    for (size_t i = 0; i < spans->len; i++) {
+        memset(data + spans->spans[i].start, mask, spans->spans[i].end - spans->spans[i].start);
+    }
+}
+
+// Byte offsets into UTF-8 become code point offsets; spans are ascending
+static void spans_to_code_points(const uint8_t *data, pii_spans_t *spans) {
+    size_t pos = 0, chars = 0;
+    for (size_t i = 0; i < spans->len; i++) {
+        size_t *offsets[2] = {&spans->spans[i].start, &spans->spans[i].end};
+        for (int k = 0; k < 2; k++) {
+            for (; pos < *offsets[k]; pos++) {
+                chars += (data[pos] & 0xC0) != 0x80;
+            }
+            *offsets[k] = chars;
+        }
+    }
+}
+
+// Module methods
+static PyObject* pii_scanner_version(PyObject *self, PyObject *args) {
+    return PyUnicode_FromString("0.1.0");
+}
+
+static PyObject* pii_scanner_scan(PyObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"data", "types", NULL};
+    PyObject *obj;
+    unsigned int types = PII_ALL_TYPES;
+    scan_input_t in;
+    pii_spans_t spans = {NULL, 0, 0};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|I", kwlist, &obj, &types)) {
+        return NULL;
+    }
+    if (parse_types(types) < 0 || input_acquire(obj, &in) < 0) {
+        return NULL;
+    }
+
+    if (scan_all(in.data, in.len, types, &spans) < 0) {
+        input_release(&in);
+        return NULL;
+    }
+    if (in.is_str && !in.ascii) {
+        spans_to_code_points(in.data, &spans);
+    }
+    input_release(&in);
+
+    PyObject *result = PyList_New((Py_ssize_t)spans.len);
+    for (size_t i = 0; result != NULL && i < spans.len; i++) {
+        PyObject *item = Py_BuildValue("(Inn)", spans.spans[i].type,
+                                       (Py_ssize_t)spans.spans[i].start,
+                                       (Py_ssize_t)spans.spans[i].end);
+        if (item == NULL) {
+            Py_CLEAR(result);
+            break;
+        }
+        PyList_SET_ITEM(result, (Py_ssize_t)i, item);
+    }
+    pii_spans_free(&spans);
+    return result;
+}
+
+static PyObject* pii_scanner_redact(PyObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"data", "types", "mask", NULL};
+    PyObject *obj;
+    unsigned int types = PII_ALL_TYPES;
+    int mask = PII_DEFAULT_MASK;
+    scan_input_t in;
+    pii_spans_t spans = {NULL, 0, 0};
+    PyObject *result = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|IC", kwlist, &obj, &types, &mask)) {
+        return NULL;
+    }
+    if (parse_types(types) < 0 || parse_mask(mask) < 0 || input_acquire(obj, &in) < 0) {
+        return NULL;
+    }
+    if (scan_all(in.data, in.len, types, &spans) < 0) {
+        input_release(&in);
+        return NULL;
+    }
+
+    // Spans only ever cover ASCII, so masking keeps UTF-8 valid
+    if (in.is_str && in.ascii) {
+        result = PyUnicode_New((Py_ssize_t)in.len, 127);
+        if (result != NULL) {
+            memcpy(PyUnicode_DATA(result), in.data, in.len);
+            mask_spans((uint8_t*)PyUnicode_DATA(result), &spans, mask);
+        }
+    } else {
+        uint8_t *copy = PyMem_Malloc(in.len ? in.len : 1);
+        if (copy == NULL) {
+            PyErr_NoMemory();
+        } else {
+            memcpy(copy, in.data, in.len);
+            mask_spans(copy, &spans, mask);
+            result = in.is_str
+                ? PyUnicode_DecodeUTF8((const char*)copy, (Py_ssize_t)in.len, "strict")
+                : PyBytes_FromStringAndSize((const char*)copy, (Py_ssize_t)in.len);
+            PyMem_Free(copy);
+        }
+    }
+
+    pii_spans_free(&spans);
+    input_release(&in);
+    return result;
+}
+
+static PyObject* pii_scanner_redact_into(PyObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"buffer", "types", "mask", NULL};
+    Py_buffer view;
+    unsigned int types = PII_ALL_TYPES;
+    int mask = PII_DEFAULT_MASK;
+    pii_spans_t spans = {NULL, 0, 0};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "w*|IC", kwlist, &view, &types, &mask)) {
+        return NULL;
+    }
+    if (parse_types(types) < 0 || parse_mask(mask) < 0 ||
+        scan_all((const uint8_t*)view.buf, (size_t)view.len, types, &spans) < 0) {
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    mask_spans((uint8_t*)view.buf, &spans, mask);
+    size_t count = spans.len;
+    pii_spans_free(&spans);
+    PyBuffer_Release(&view);
+    return PyLong_FromSize_t(count);
+}
+
+// Redactor: streaming redaction that holds back one maximal match
+typedef struct {
+    PyObject_HEAD
+    unsigned int types;
+    int mask;
+    uint8_t *buf;
+    size_t len;
+    size_t cap;
+    int prev;  // Last byte emitted, for \b at the start of buf; -1 at stream start
+    int busy;
+    uint64_t matches;
+    uint64_t counts[PII_TYPE_COUNT];
+} RedactorObject;
+
+static PyTypeObject RedactorType;
+
+// Forward declarations
+static PyObject* Redactor_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
+static int Redactor_init(RedactorObject *self, PyObject *args, PyObject *kwds);
+static void Redactor_dealloc(RedactorObject *self);
+static PyObject* Redactor_feed(RedactorObject *self, PyObject *args);
+static PyObject* Redactor_finish(RedactorObject *self, PyObject *args);
+static PyObject* Redactor_get_matches(RedactorObject *self, void *closure);
+static PyObject* Redactor_get_counts(RedactorObject *self, void *closure);
+static PyObject* Redactor_get_pending(RedactorObject *self, void *closure);
+
+// Method definitions
+static PyMethodDef Redactor_methods[] = {
+    {"feed", (PyCFunction)Redactor_feed, METH_VARARGS, "Add bytes; return the redacted bytes that are final"},
+    {"finish", (PyCFunction)Redactor_finish, METH_NOARGS, "Redact and return everything held back"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef Redactor_getset[] = {
+    {"matches", (getter)Redactor_get_matches, NULL, "Spans redacted so far", NULL},
+    {"counts", (getter)Redactor_get_counts, NULL, "Spans redacted so far, per type", NULL},
+    {"pending", (getter)Redactor_get_pending, NULL, "Bytes held back for matches that may continue", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+// Type definition
+static PyTypeObject RedactorType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "pii_scanner_native.Redactor",
+    .tp_doc = "Streaming PII redactor; output is identical to redacting the whole input at once",
+    .tp_basicsize = sizeof(RedactorObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = Redactor_new,
+    .tp_init = (initproc)Redactor_init,
+    .tp_dealloc = (destructor)Redactor_dealloc,
+    .tp_methods = Redactor_methods,
+    .tp_getset = Redactor_getset,
+};
+
+static PyObject* Redactor_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
+    RedactorObject *self = (RedactorObject*)type->tp_alloc(type, 0);
+    if (self != NULL) {
+        self->types = PII_ALL_TYPES;
+        self->mask = PII_DEFAULT_MASK;
+        self->prev = -1;
+    }
+    return (PyObject*)self;
+}
+
+static int Redactor_init(RedactorObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"types", "mask", NULL};
+    unsigned int types = PII_ALL_TYPES;
+    int mask = PII_DEFAULT_MASK;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|IC", kwlist, &types, &mask)) {
+        return -1;
+    }
+    if (parse_types(types) < 0 || parse_mask(mask) < 0) {
+        return -1;
+    }
+
+    self->types = types;
+    self->mask = mask;
+    return 0;
+}
+
+static void Redactor_dealloc(RedactorObject *self) {
+    PyMem_Free(self->buf);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+// Scans what is buffered and emits everything that can no longer change:
+// all of it when final, otherwise up to one maximal match from the end.
+static PyObject* redactor_drain(RedactorObject *self, int final) {
+    size_t hold = pii_max_match();
+    size_t stop = final ? self->len : (self->len > hold ? self->len - hold : 0);
+    pii_spans_t spans = {NULL, 0, 0};
+    size_t resume = 0;
+    int rc = 0;
+
+    if (stop > 0) {
+        self->busy = 1;
+        Py_BEGIN_ALLOW_THREADS
+        rc = pii_scan(self->buf, self->len, 0, stop, self->prev, self->types, &spans, &resume);
+        if (rc == 0) {
+            mask_spans(self->buf, &spans, self->mask);
+        }
+        Py_END_ALLOW_THREADS
+        self->busy = 0;
+    }
+    if (rc < 0) {
+        pii_spans_free(&spans);
+        return PyErr_NoMemory();
+    }
+
+    for (size_t i = 0; i < spans.len; i++) {
+        self->counts[spans.spans[i].type]++;
+    }
+    self->matches += spans.len;
+    pii_spans_free(&spans);
+
+    // A match may run past stop; it is masked already, so emit through it
+    size_t emit = final ? self->len : resume;
+    PyObject *out = PyBytes_FromStringAndSize((const char*)self->buf, (Py_ssize_t)emit);
+    if (out == NULL) {
+        return NULL;
+    }
+    if (emit > 0) {
+        self->prev = self->buf[emit - 1];
+        memmove(self->buf, self->buf + emit, self->len - emit);
+        self->len -= emit;
+    }
+    if (final) {
+        self->prev = -1;
+    }
+    return out;
+}
+
+static PyObject* Redactor_feed(RedactorObject *self, PyObject *args) {
+    Py_buffer data;
+
+    if (!PyArg_ParseTuple(args, "y*", &data)) {
+        return NULL;
+    }
+    if (self->busy) {
+        PyBuffer_Release(&data);
+        PyErr_SetString(PyExc_RuntimeError, "Redactor is in use by another thread");
+        return NULL;
+    }
+
+    size_t need = self->len + (size_t)data.len;
+    if (need > self->cap) {
+        size_t cap = self->cap ? self->cap : REDACTOR_MIN_CAPACITY;
+        while (cap < need) {
+            cap *= 2;
+        }
+        uint8_t *buf = PyMem_Realloc(self->buf, cap);
+        if (buf == NULL) {
+            PyBuffer_Release(&data);
+            return PyErr_NoMemory();
+        }
+        self->buf = buf;
+        self->cap = cap;
+    }
+    memcpy(self->buf + self->len, data.buf, (size_t)data.len);
+    self->len = need;
+    PyBuffer_Release(&data);
+
+    return redactor_drain(self, 0);
+}
+
+static PyObject* Redactor_finish(RedactorObject *self, PyObject *args) {
+    if (self->busy) {
+        PyErr_SetString(PyExc_RuntimeError, "Redactor is in use by another thread");
+        return NULL;
+    }
+    return redactor_drain(self, 1);
+}
+
+static PyObject* Redactor_get_matches(RedactorObject *self, void *closure) {
+    return PyLong_FromUnsignedLongLong(self->matches);
+}
+
+static PyObject* Redactor_get_counts(RedactorObject *self, void *closure) {
+    PyObject *counts = PyDict_New();
+    for (int t = 0; counts != NULL && t < PII_TYPE_COUNT; t++) {
+        if (self->counts[t] == 0) {
+            continue;
+        }
+        PyObject *n = PyLong_FromUnsignedLongLong(self->counts[t]);
+        if (n == NULL || PyDict_SetItemString(counts, type_names[t], n) < 0) {
+            Py_XDECREF(n);
+            Py_CLEAR(counts);
+            break;
+        }
+        Py_DECREF(n);
+    }
+    return counts;
+}
+
+static PyObject* Redactor_get_pending(RedactorObject *self, void *closure) {
+    return PyLong_FromSize_t(self->len);
+}
+
+static PyMethodDef pii_scanner_module_methods[] = {
+    {"version", pii_scanner_version, METH_NOARGS, "Get version"},
+    {"scan", (PyCFunction)(void(*)(void))pii_scanner_scan, METH_VARARGS | METH_KEYWORDS,
+     "Return non-overlapping (type, start, end) PII spans; str offsets are in characters"},
+    {"redact", (PyCFunction)(void(*)(void))pii_scanner_redact, METH_VARARGS | METH_KEYWORDS,
+     "Return a copy with every PII span overwritten by the mask character"},
+    {"redact_into", (PyCFunction)(void(*)(void))pii_scanner_redact_into, METH_VARARGS | METH_KEYWORDS,
+     "Mask PII in a writable buffer in place; return the number of spans"},
+    {NULL, NULL, 0, NULL}
+};
+
+// Module definition
+static struct PyModuleDef pii_scanner_module = {
+    PyModuleDef_HEAD_INIT,
+    "pii_scanner_native",
+    "Native PII scanner extension for Lucid RDP",
+    -1,
+    pii_scanner_module_methods
+};
+
+PyMODINIT_FUNC PyInit_pii_scanner_native(void) {
+    pii_patterns_init();
+
+    if (PyType_Ready(&RedactorType) < 0) {
+        return NULL;
+    }
+
+    PyObject *m = PyModule_Create(&pii_scanner_module);
+    if (m == NULL) {
+        return NULL;
+    }
+
+    Py_INCREF(&RedactorType);
+    if (PyModule_AddObject(m, "Redactor", (PyObject*)&RedactorType) < 0) {
+        Py_DECREF(&RedactorType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    PyObject *names = PyTuple_New(PII_TYPE_COUNT);
+    if (names == NULL) {
+        Py_DECREF(m);
+        return NULL;
+    }
+    for (int t = 0; t < PII_TYPE_COUNT; t++) {
+        PyTuple_SET_ITEM(names, t, PyUnicode_FromString(type_names[t]));
+    }
+    if (PyModule_AddObject(m, "TYPE_NAMES", names) < 0) {
+        Py_DECREF(names);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    PyModule_AddIntConstant(m, "EMAIL", PII_EMAIL);
+    PyModule_AddIntConstant(m, "CREDIT_CARD", PII_CREDIT_CARD);
+    PyModule_AddIntConstant(m, "SSN", PII_SSN);
+    PyModule_AddIntConstant(m, "PHONE", PII_PHONE);
+    PyModule_AddIntConstant(m, "IP_ADDRESS", PII_IP_ADDRESS);
+    PyModule_AddIntConstant(m, "MAC_ADDRESS", PII_MAC_ADDRESS);
+    PyModule_AddIntConstant(m, "DATE_OF_BIRTH", PII_DATE_OF_BIRTH);
+    PyModule_AddIntConstant(m, "DRIVER_LICENSE", PII_DRIVER_LICENSE);
+    PyModule_AddIntConstant(m, "PASSPORT", PII_PASSPORT);
+    PyModule_AddIntConstant(m, "NAME", PII_NAME);
+    PyModule_AddIntConstant(m, "ALL_TYPES", PII_ALL_TYPES);
+    PyModule_AddIntConstant(m, "MAX_MATCH", (long)pii_max_match());
+
+    return m;
+}
@@ -0,0 +1,10 @@
+#ifndef PII_SCANNER_H
+#define PII_SCANNER_H
+
+#include <Python.h>
+
+// Constants
+#define PII_DEFAULT_MASK '*'
+#define REDACTOR_MIN_CAPACITY (64 * 1024)
+
+#endif // PII_SCANNER_H
@@ -0,0 +1,13 @@
+# RDP Codec Module
+# RDP packet framing and channel codecs
+
+"""
+File: /app/apps/rdp_codec/__init__.py
+x-lucid-file-path: /app/apps/rdp_codec/__init__.py
+x-lucid-file-type: python
+
+RDP Codec package for Lucid RDP.
+Contains the native packet framing codec used by the RDP session manager.
+"""
+
+__all__ = []
@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+"""
+File: /app/apps/rdp_codec/setup.py
+x-lucid-file-path: /app/apps/rdp_codec/setup.py
+x-lucid-file-type: python
+
+Setup script for native RDP codec extension
+"""
+
+from setuptools import setup, Extension
+
+# Define the extension module
+rdp_codec_native = Extension(
+    'rdp_codec_native',
+    sources=[
+        'src/rdp_codec.c',
+        'src/framing.c',
+        'src/bulk_compression.c'
+    ],
+    include_dirs=[
+        'src/'
+    ],
+    libraries=['z'],
+    library_dirs=[],
+    extra_compile_args=[
+        '-O3',
+        '-Wall',
+        '-Wextra',
+        '-std=c99',
+        '-fPIC'
+    ],
+    extra_link_args=['-shared']
+)
+
+setup(
+    name='rdp-codec-native',
+    version='0.1.0',
+    description='Native RDP codec extension for Lucid RDP',
+    ext_modules=[rdp_codec_native],
+    python_requires='>=3.8',
+    classifiers=[
+        'Development Status :: 3 - Alpha',
+        'Intended Audience :: Developers',
+        'License :: OSI Approved :: MIT License',
+        'Programming Language :: C',
+        'Programming Language :: Python :: 3',
+        'Programming Language :: Python :: 3.8',
+        'Programming Language :: Python :: 3.9',
+        'Programming Language :: Python :: 3.10',
+        'Programming Language :: Python :: 3.11',
+    ],
+)
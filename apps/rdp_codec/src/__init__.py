@@ -0,0 +1,13 @@
+# RDP Codec Source Module
+# RDP codec native source code components
+
+"""
+File: /app/apps/rdp_codec/src/__init__.py
+x-lucid-file-path: /app/apps/rdp_codec/src/__init__.py
+x-lucid-file-type: python
+
+RDP Codec Source package for Lucid RDP.
+Contains RDP codec native source code and C implementations.
+"""
+
+__all__ = []
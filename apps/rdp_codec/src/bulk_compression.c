@@ -0,0 +1,138 @@
+#include <string.h>
+#include "bulk_compression.h"
+
+static const uint8_t flush_tail[BULK_FLUSH_TAIL_SIZE] = {0x00, 0x00, 0xff, 0xff};
+
+int bulk_compressor_init(bulk_stream_t *bulk, int level) {
+    memset(bulk, 0, sizeof(*bulk));
+
+    // Raw deflate: the frame header already delimits packets
+    int result = deflateInit2(&bulk->stream, level, Z_DEFLATED, -BULK_WINDOW_BITS,
+                              BULK_MEM_LEVEL, Z_DEFAULT_STRATEGY);
+    bulk->ready = result == Z_OK;
+    return result;
+}
+
+void bulk_compressor_end(bulk_stream_t *bulk) {
+    if (bulk->ready) {
+        deflateEnd(&bulk->stream);
+        bulk->ready = 0;
+    }
+}
+
+int bulk_decompressor_init(bulk_stream_t *bulk) {
+    memset(bulk, 0, sizeof(*bulk));
+
+    int result = inflateInit2(&bulk->stream, -BULK_WINDOW_BITS);
+    bulk->ready = result == Z_OK;
+    return result;
+}
+
+void bulk_decompressor_end(bulk_stream_t *bulk) {
+    if (bulk->ready) {
+        inflateEnd(&bulk->stream);
+        bulk->ready = 0;
+    }
+}
+
+size_t bulk_compress_bound(bulk_stream_t *bulk, size_t in_len) {
+    // deflateBound assumes Z_FINISH; a sync flush adds an empty stored block
+    return deflateBound(&bulk->stream, (uLong)in_len) + 16;
+}
+
+int bulk_compress(bulk_stream_t *bulk, const uint8_t *in, size_t in_len,
+                  uint8_t *out, size_t out_cap, size_t *out_len) {
+    z_stream *stream = &bulk->stream;
+
+    // A repeated sync flush with no input emits nothing, and the tail the
+    // decompressor appends to nothing is not a block. Every packet starts
+    // byte aligned, so an empty one is sent as the first byte of an empty
+    // stored block, which the tail completes.
+    if (in_len == 0) {
+        if (out_cap < 1) {
+            return Z_BUF_ERROR;
+        }
+        out[0] = 0x00;
+        bulk->packets++;
+        bulk->bytes_out += 1;
+        *out_len = 1;
+        return Z_OK;
+    }
+
+    stream->next_in = (Bytef*)in;
+    stream->avail_in = (uInt)in_len;
+    stream->next_out = out;
+    stream->avail_out = (uInt)out_cap;
+
+    int result = deflate(stream, Z_SYNC_FLUSH);
+    if (result != Z_OK && result != Z_BUF_ERROR) {
+        return result;
+    }
+    if (stream->avail_in != 0 || stream->avail_out == 0) {
+        return Z_BUF_ERROR;
+    }
+
+    size_t produced = out_cap - stream->avail_out;
+    if (produced >= BULK_FLUSH_TAIL_SIZE &&
+        memcmp(out + produced - BULK_FLUSH_TAIL_SIZE, flush_tail, BULK_FLUSH_TAIL_SIZE) == 0) {
+        produced -= BULK_FLUSH_TAIL_SIZE;
+    }
+
+    bulk->packets++;
+    bulk->bytes_in += in_len;
+    bulk->bytes_out += produced;
+    *out_len = produced;
+    return Z_OK;
+}
+
+static int inflate_into(z_stream *stream, const uint8_t *in, size_t in_len) {
+    stream->next_in = (Bytef*)in;
+    stream->avail_in = (uInt)in_len;
+
+    while (stream->avail_in > 0) {
+        if (stream->avail_out == 0) {
+            return Z_BUF_ERROR;
+        }
+        int result = inflate(stream, Z_SYNC_FLUSH);
+        if (result == Z_STREAM_END) {
+            return Z_DATA_ERROR;  // Senders never finish the stream
+        }
+        if (result == Z_BUF_ERROR) {
+            // No progress with input left means the output is full
+            return stream->avail_out == 0 ? Z_BUF_ERROR : Z_DATA_ERROR;
+        }
+        if (result != Z_OK) {
+            return result == Z_NEED_DICT ? Z_DATA_ERROR : result;
+        }
+    }
+    return Z_OK;
+}
+
+int bulk_decompress(bulk_stream_t *bulk, const uint8_t *in, size_t in_len,
+                    uint8_t *out, size_t out_cap, size_t *out_len) {
+    z_stream *stream = &bulk->stream;
+
+    // bulk_compress never emits an empty packet; appending the tail to one
+    // would be read as a stored block header and desync the stream
+    if (in_len == 0) {
+        return Z_DATA_ERROR;
+    }
+
+    stream->next_out = out;
+    stream->avail_out = (uInt)out_cap;
+
+    int result = inflate_into(stream, in, in_len);
+    if (result == Z_OK) {
+        result = inflate_into(stream, flush_tail, BULK_FLUSH_TAIL_SIZE);
+    }
+    if (result != Z_OK) {
+        return result;
+    }
+
+    size_t produced = out_cap - stream->avail_out;
+    bulk->packets++;
+    bulk->bytes_in += in_len;
+    bulk->bytes_out += produced;
+    *out_len = produced;
+    return Z_OK;
+}
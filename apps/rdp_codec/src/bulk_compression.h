@@ -0,0 +1,45 @@
+#ifndef BULK_COMPRESSION_H
+#define BULK_COMPRESSION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zlib.h>
+
+// Constants
+#define BULK_WINDOW_BITS 15  // 32K history shared by every packet on a channel
+#define BULK_MEM_LEVEL 8
+#define BULK_DEFAULT_LEVEL 6
+#define BULK_FLUSH_TAIL_SIZE 4  // 00 00 ff ff left by every sync flush
+
+// One direction of a channel's compression stream. Each packet ends on a
+// sync flush so it decodes on its own, but the deflate window carries
+// over, so repeated content in later packets costs only back-references.
+typedef struct {
+    z_stream stream;
+    int ready;
+    uint64_t packets;
+    uint64_t bytes_in;
+    uint64_t bytes_out;
+} bulk_stream_t;
+
+int bulk_compressor_init(bulk_stream_t *bulk, int level);
+void bulk_compressor_end(bulk_stream_t *bulk);
+int bulk_decompressor_init(bulk_stream_t *bulk);
+void bulk_decompressor_end(bulk_stream_t *bulk);
+
+// Worst case output of bulk_compress for in_len bytes
+size_t bulk_compress_bound(bulk_stream_t *bulk, size_t in_len);
+
+// Compress one packet. The sync flush tail is dropped from the output and
+// restored by bulk_decompress; empty input becomes a single 00 byte, never
+// an empty packet. Returns Z_OK or a zlib error.
+int bulk_compress(bulk_stream_t *bulk, const uint8_t *in, size_t in_len,
+                  uint8_t *out, size_t out_cap, size_t *out_len);
+
+// Decompress one packet into out. Returns Z_OK, Z_BUF_ERROR if the packet
+// expands past out_cap, or Z_DATA_ERROR for a corrupt stream or an empty
+// packet.
+int bulk_decompress(bulk_stream_t *bulk, const uint8_t *in, size_t in_len,
+                    uint8_t *out, size_t out_cap, size_t *out_len);
+
+#endif // BULK_COMPRESSION_H
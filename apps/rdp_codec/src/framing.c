@@ -0,0 +1,45 @@
+#include "framing.h"
+
+static uint16_t read_be16(const uint8_t *in) {
+    return (uint16_t)((in[0] << 8) | in[1]);
+}
+
+static void write_be16(uint8_t *out, uint16_t value) {
+    out[0] = (uint8_t)(value >> 8);
+    out[1] = (uint8_t)value;
+}
+
+void rdp_header_read(const uint8_t *in, rdp_frame_header_t *header) {
+    header->length = read_be16(in);
+    header->type = read_be16(in + 2);
+    header->channel = read_be16(in + 4);
+    header->sequence = read_be16(in + 6);
+}
+
+void rdp_header_write(uint8_t *out, const rdp_frame_header_t *header) {
+    write_be16(out, header->length);
+    write_be16(out + 2, header->type);
+    write_be16(out + 4, header->channel);
+    write_be16(out + 6, header->sequence);
+}
+
+ptrdiff_t rdp_scan_frames(const uint8_t *buf, size_t len, size_t *offsets,
+                          size_t max_frames, size_t *consumed) {
+    size_t pos = 0;
+    size_t count = 0;
+
+    while (count < max_frames && len - pos >= RDP_HEADER_SIZE) {
+        size_t frame_len = read_be16(buf + pos);
+        if (frame_len < RDP_HEADER_SIZE) {
+            return -1;
+        }
+        if (len - pos < frame_len) {
+            break;
+        }
+        offsets[count++] = pos;
+        pos += frame_len;
+    }
+
+    *consumed = pos;
+    return (ptrdiff_t)count;
+}
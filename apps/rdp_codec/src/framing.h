@@ -0,0 +1,29 @@
+#ifndef FRAMING_H
+#define FRAMING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Constants
+#define RDP_HEADER_SIZE 8  // >HHHH: length, type, channel, sequence
+#define RDP_MAX_FRAME_SIZE 65535  // Length field is 16 bits and covers the header
+#define RDP_MAX_PAYLOAD_SIZE (RDP_MAX_FRAME_SIZE - RDP_HEADER_SIZE)
+
+// Header of one >HHHH frame
+typedef struct {
+    uint16_t length;  // Whole frame, header included
+    uint16_t type;
+    uint16_t channel;
+    uint16_t sequence;
+} rdp_frame_header_t;
+
+void rdp_header_read(const uint8_t *in, rdp_frame_header_t *header);
+void rdp_header_write(uint8_t *out, const rdp_frame_header_t *header);
+
+// Walk complete frames in buf. Stores up to max_frames frame start offsets,
+// sets *consumed to the bytes covered by complete frames and returns the
+// number found, or -1 if a header carries a length below RDP_HEADER_SIZE.
+ptrdiff_t rdp_scan_frames(const uint8_t *buf, size_t len, size_t *offsets,
+                          size_t max_frames, size_t *consumed);
+
+#endif // FRAMING_H
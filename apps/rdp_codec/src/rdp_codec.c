@@ -0,0 +1,631 @@
+/*
+ * Native RDP codec extension for Lucid RDP
+ * Splits >HHHH framed packets out of large receive buffers as views,
+ * writes batches of frames with a single vectored sendmsg, and runs the
+ * per-channel bulk compression streams
+ */
+
+#define _GNU_SOURCE
+#include <Python.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include "rdp_codec.h"
+#include "framing.h"
+#include "bulk_compression.h"
+
+#define SCAN_BATCH 64
+
+typedef struct {
+    PyObject_HEAD
+    uint8_t pending[RDP_MAX_FRAME_SIZE];  // Frame split across reads
+    size_t pending_len;
+    unsigned long long frames_decoded;
+} FrameDecoderObject;
+
+typedef struct {
+    PyObject_HEAD
+    bulk_stream_t bulk;
+} BulkStreamObject;
+
+static PyTypeObject FrameDecoderType;
+static PyTypeObject BulkCompressorType;
+static PyTypeObject BulkDecompressorType;
+
+// Forward declarations
+static PyObject* FrameDecoder_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
+static void FrameDecoder_dealloc(FrameDecoderObject *self);
+static PyObject* FrameDecoder_feed(FrameDecoderObject *self, PyObject *args);
+static PyObject* FrameDecoder_reset(FrameDecoderObject *self, PyObject *args);
+static int BulkCompressor_init(BulkStreamObject *self, PyObject *args, PyObject *kwds);
+static void BulkCompressor_dealloc(BulkStreamObject *self);
+static PyObject* BulkCompressor_compress(BulkStreamObject *self, PyObject *args);
+static int BulkDecompressor_init(BulkStreamObject *self, PyObject *args, PyObject *kwds);
+static void BulkDecompressor_dealloc(BulkStreamObject *self);
+static PyObject* BulkDecompressor_decompress(BulkStreamObject *self, PyObject *args, PyObject *kwds);
+
+// Method definitions
+static PyMethodDef FrameDecoder_methods[] = {
+    {"feed", (PyCFunction)FrameDecoder_feed, METH_VARARGS, "Add received bytes; returns the frames they complete"},
+    {"reset", (PyCFunction)FrameDecoder_reset, METH_NOARGS, "Drop any partially received frame"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyObject* FrameDecoder_get_pending(FrameDecoderObject *self, void *closure) {
+    return PyLong_FromSize_t(self->pending_len);
+}
+
+static PyObject* FrameDecoder_get_frames_decoded(FrameDecoderObject *self, void *closure) {
+    return PyLong_FromUnsignedLongLong(self->frames_decoded);
+}
+
+static PyGetSetDef FrameDecoder_getset[] = {
+    {"pending", (getter)FrameDecoder_get_pending, NULL, "Bytes held for an incomplete frame", NULL},
+    {"frames_decoded", (getter)FrameDecoder_get_frames_decoded, NULL, "Frames returned so far", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+// Type definition
+static PyTypeObject FrameDecoderType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "rdp_codec_native.FrameDecoder",
+    .tp_doc = "Incremental decoder for >HHHH framed RDP packets",
+    .tp_basicsize = sizeof(FrameDecoderObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = FrameDecoder_new,
+    .tp_dealloc = (destructor)FrameDecoder_dealloc,
+    .tp_methods = FrameDecoder_methods,
+    .tp_getset = FrameDecoder_getset,
+};
+
+static PyMethodDef BulkCompressor_methods[] = {
+    {"compress", (PyCFunction)BulkCompressor_compress, METH_VARARGS, "Compress one packet against the channel history"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyMethodDef BulkDecompressor_methods[] = {
+    {"decompress", (PyCFunction)(void(*)(void))BulkDecompressor_decompress, METH_VARARGS | METH_KEYWORDS,
+     "Decompress one packet against the channel history"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyObject* BulkStream_get_packets(BulkStreamObject *self, void *closure) {
+    return PyLong_FromUnsignedLongLong(self->bulk.packets);
+}
+
+static PyObject* BulkStream_get_bytes_in(BulkStreamObject *self, void *closure) {
+    return PyLong_FromUnsignedLongLong(self->bulk.bytes_in);
+}
+
+static PyObject* BulkStream_get_bytes_out(BulkStreamObject *self, void *closure) {
+    return PyLong_FromUnsignedLongLong(self->bulk.bytes_out);
+}
+
+static PyGetSetDef BulkStream_getset[] = {
+    {"packets", (getter)BulkStream_get_packets, NULL, "Packets processed", NULL},
+    {"bytes_in", (getter)BulkStream_get_bytes_in, NULL, "Bytes consumed", NULL},
+    {"bytes_out", (getter)BulkStream_get_bytes_out, NULL, "Bytes produced", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PyTypeObject BulkCompressorType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "rdp_codec_native.BulkCompressor",
+    .tp_doc = "Sending side of a channel's bulk compression stream",
+    .tp_basicsize = sizeof(BulkStreamObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = PyType_GenericNew,
+    .tp_init = (initproc)BulkCompressor_init,
+    .tp_dealloc = (destructor)BulkCompressor_dealloc,
+    .tp_methods = BulkCompressor_methods,
+    .tp_getset = BulkStream_getset,
+};
+
+static PyTypeObject BulkDecompressorType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "rdp_codec_native.BulkDecompressor",
+    .tp_doc = "Receiving side of a channel's bulk compression stream",
+    .tp_basicsize = sizeof(BulkStreamObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = PyType_GenericNew,
+    .tp_init = (initproc)BulkDecompressor_init,
+    .tp_dealloc = (destructor)BulkDecompressor_dealloc,
+    .tp_methods = BulkDecompressor_methods,
+    .tp_getset = BulkStream_getset,
+};
+
+static PyObject* FrameDecoder_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
+    FrameDecoderObject *self = (FrameDecoderObject*)type->tp_alloc(type, 0);
+    if (self != NULL) {
+        self->pending_len = 0;
+        self->frames_decoded = 0;
+    }
+    return (PyObject*)self;
+}
+
+static void FrameDecoder_dealloc(FrameDecoderObject *self) {
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static PyObject* FrameDecoder_reset(FrameDecoderObject *self, PyObject *args) {
+    self->pending_len = 0;
+    Py_RETURN_NONE;
+}
+
+// (type, channel, sequence, payload) with the payload sliced out of view
+static PyObject* make_frame(PyObject *view, const uint8_t *frame, Py_ssize_t start) {
+    rdp_frame_header_t header;
+    rdp_header_read(frame, &header);
+
+    PyObject *payload = PySequence_GetSlice(view, start + RDP_HEADER_SIZE, start + header.length);
+    if (payload == NULL) {
+        return NULL;
+    }
+    PyObject *type = PyLong_FromLong(header.type);
+    PyObject *channel = PyLong_FromLong(header.channel);
+    PyObject *sequence = PyLong_FromLong(header.sequence);
+    PyObject *result = (type && channel && sequence) ? PyTuple_Pack(4, type, channel, sequence, payload) : NULL;
+    Py_XDECREF(type);
+    Py_XDECREF(channel);
+    Py_XDECREF(sequence);
+    Py_DECREF(payload);
+    return result;
+}
+
+// Top up the pending frame from in. Returns the bytes taken, or -1 if the
+// completed header carries an impossible length.
+static ptrdiff_t fill_pending(FrameDecoderObject *self, const uint8_t *in, size_t len) {
+    size_t taken = 0;
+
+    if (self->pending_len < RDP_HEADER_SIZE) {
+        size_t want = RDP_HEADER_SIZE - self->pending_len;
+        if (want > len) {
+            want = len;
+        }
+        memcpy(self->pending + self->pending_len, in, want);
+        self->pending_len += want;
+        taken = want;
+        if (self->pending_len < RDP_HEADER_SIZE) {
+            return (ptrdiff_t)taken;
+        }
+    }
+
+    size_t frame_len = ((size_t)self->pending[0] << 8) | self->pending[1];
+    if (frame_len < RDP_HEADER_SIZE) {
+        return -1;
+    }
+
+    size_t want = frame_len - self->pending_len;
+    if (want > len - taken) {
+        want = len - taken;
+    }
+    memcpy(self->pending + self->pending_len, in + taken, want);
+    self->pending_len += want;
+    return (ptrdiff_t)(taken + want);
+}
+
+static int pending_complete(FrameDecoderObject *self) {
+    if (self->pending_len < RDP_HEADER_SIZE) {
+        return 0;
+    }
+    size_t frame_len = ((size_t)self->pending[0] << 8) | self->pending[1];
+    return self->pending_len == frame_len;
+}
+
+static PyObject* FrameDecoder_feed(FrameDecoderObject *self, PyObject *args) {
+    PyObject *data_obj;
+    Py_buffer buf;
+    PyObject *frames = NULL;
+    PyObject *view = NULL;
+    size_t pos = 0;
+
+    if (!PyArg_ParseTuple(args, "O", &data_obj)) {
+        return NULL;
+    }
+    if (PyObject_GetBuffer(data_obj, &buf, PyBUF_SIMPLE) < 0) {
+        return NULL;
+    }
+
+    const uint8_t *in = (const uint8_t*)buf.buf;
+    size_t len = (size_t)buf.len;
+
+    frames = PyList_New(0);
+    if (frames == NULL) {
+        goto error;
+    }
+
+    // Finish the frame left over from the previous read; its payload is
+    // copied since it spans two buffers
+    if (self->pending_len > 0) {
+        ptrdiff_t taken = fill_pending(self, in, len);
+        if (taken < 0) {
+            goto bad_frame;
+        }
+        pos = (size_t)taken;
+
+        if (pending_complete(self)) {
+            PyObject *payload = PyBytes_FromStringAndSize((const char*)self->pending, (Py_ssize_t)self->pending_len);
+            PyObject *payload_view = payload ? PyMemoryView_FromObject(payload) : NULL;
+            Py_XDECREF(payload);
+            if (payload_view == NULL) {
+                goto error;
+            }
+            PyObject *frame = make_frame(payload_view, self->pending, 0);
+            Py_DECREF(payload_view);
+            if (frame == NULL || PyList_Append(frames, frame) < 0) {
+                Py_XDECREF(frame);
+                goto error;
+            }
+            Py_DECREF(frame);
+            self->pending_len = 0;
+            self->frames_decoded++;
+        }
+    }
+
+    // Whole frames in the rest of the buffer are views onto it
+    while (pos < len) {
+        size_t offsets[SCAN_BATCH];
+        size_t consumed = 0;
+        ptrdiff_t count = rdp_scan_frames(in + pos, len - pos, offsets, SCAN_BATCH, &consumed);
+        if (count < 0) {
+            goto bad_frame;
+        }
+        if (count == 0) {
+            break;
+        }
+
+        if (view == NULL) {
+            view = PyMemoryView_FromObject(data_obj);
+            if (view == NULL) {
+                goto error;
+            }
+        }
+
+        for (ptrdiff_t i = 0; i < count; i++) {
+            size_t start = pos + offsets[i];
+            PyObject *frame = make_frame(view, in + start, (Py_ssize_t)start);
+            if (frame == NULL || PyList_Append(frames, frame) < 0) {
+                Py_XDECREF(frame);
+                goto error;
+            }
+            Py_DECREF(frame);
+        }
+        self->frames_decoded += (unsigned long long)count;
+        pos += consumed;
+    }
+
+    // Keep the partial frame at the tail for the next read
+    if (pos < len) {
+        memcpy(self->pending, in + pos, len - pos);
+        self->pending_len = len - pos;
+    }
+
+    Py_XDECREF(view);
+    PyBuffer_Release(&buf);
+    return frames;
+
+bad_frame:
+    PyErr_SetString(PyExc_ValueError, "Invalid RDP frame length");
+    self->pending_len = 0;
+error:
+    Py_XDECREF(view);
+    Py_XDECREF(frames);
+    PyBuffer_Release(&buf);
+    return NULL;
+}
+
+static PyObject* rdp_codec_send_frames(PyObject *self, PyObject *args) {
+    int fd;
+    PyObject *frames_obj;
+    Py_ssize_t offset = 0;
+
+    if (!PyArg_ParseTuple(args, "iO|n", &fd, &frames_obj, &offset)) {
+        return NULL;
+    }
+    if (offset < 0) {
+        PyErr_SetString(PyExc_ValueError, "offset must be non-negative");
+        return NULL;
+    }
+
+    PyObject *seq = PySequence_Fast(frames_obj, "frames must be a sequence");
+    if (seq == NULL) {
+        return NULL;
+    }
+
+    Py_ssize_t frame_count = PySequence_Fast_GET_SIZE(seq);
+    Py_ssize_t max_frames = frame_count < RDP_MAX_IOVECS / 2 ? frame_count : RDP_MAX_IOVECS / 2;
+    uint8_t *headers = PyMem_Malloc((size_t)(max_frames ? max_frames : 1) * RDP_HEADER_SIZE);
+    Py_buffer *payloads = PyMem_Calloc((size_t)(max_frames ? max_frames : 1), sizeof(Py_buffer));
+    struct iovec iov[RDP_MAX_IOVECS];
+    Py_ssize_t held = 0;
+    int iov_count = 0;
+    size_t skip = (size_t)offset;
+    ssize_t sent = 0;
+    PyObject *result = NULL;
+
+    if (headers == NULL || payloads == NULL) {
+        PyErr_NoMemory();
+        goto cleanup;
+    }
+
+    // Skip what earlier calls already sent, then gather up to RDP_MAX_IOVECS
+    for (Py_ssize_t i = 0; i < frame_count && held < max_frames; i++) {
+        PyObject *item = PySequence_Fast_GET_ITEM(seq, i);
+        int type, channel, sequence;
+        Py_buffer *payload = &payloads[held];
+
+        if (!PyArg_ParseTuple(item, "iiiy*", &type, &channel, &sequence, payload)) {
+            goto cleanup;
+        }
+        if (type < 0 || type > 0xFFFF || channel < 0 || channel > 0xFFFF ||
+            sequence < 0 || sequence > 0xFFFF || payload->len > RDP_MAX_PAYLOAD_SIZE) {
+            PyBuffer_Release(payload);
+            PyErr_SetString(PyExc_ValueError, "RDP frame field out of range");
+            goto cleanup;
+        }
+
+        size_t frame_size = RDP_HEADER_SIZE + (size_t)payload->len;
+        if (skip >= frame_size) {
+            skip -= frame_size;
+            PyBuffer_Release(payload);
+            continue;
+        }
+
+        uint8_t *header = headers + held * RDP_HEADER_SIZE;
+        rdp_frame_header_t fields = {
+            .length = (uint16_t)frame_size,
+            .type = (uint16_t)type,
+            .channel = (uint16_t)channel,
+            .sequence = (uint16_t)sequence,
+        };
+        rdp_header_write(header, &fields);
+        held++;
+
+        if (skip < RDP_HEADER_SIZE) {
+            iov[iov_count].iov_base = header + skip;
+            iov[iov_count].iov_len = RDP_HEADER_SIZE - skip;
+            iov_count++;
+            skip = 0;
+        } else {
+            skip -= RDP_HEADER_SIZE;
+        }
+        if ((size_t)payload->len > skip) {
+            iov[iov_count].iov_base = (uint8_t*)payload->buf + skip;
+            iov[iov_count].iov_len = (size_t)payload->len - skip;
+            iov_count++;
+        }
+        skip = 0;
+    }
+
+    if (iov_count > 0) {
+        struct msghdr msg;
+        int saved_errno = 0;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = (size_t)iov_count;
+
+        Py_BEGIN_ALLOW_THREADS
+        do {
+            sent = sendmsg(fd, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+        } while (sent < 0 && errno == EINTR);
+        saved_errno = errno;
+        Py_END_ALLOW_THREADS
+
+        if (sent < 0) {
+            // Socket buffer full: the caller waits for writability
+            if (saved_errno == EAGAIN || saved_errno == EWOULDBLOCK) {
+                sent = 0;
+            } else {
+                errno = saved_errno;
+                PyErr_SetFromErrno(PyExc_OSError);
+                goto cleanup;
+            }
+        }
+    }
+
+    result = PyLong_FromSsize_t(sent);
+
+cleanup:
+    for (Py_ssize_t i = 0; i < held; i++) {
+        PyBuffer_Release(&payloads[i]);
+    }
+    PyMem_Free(payloads);
+    PyMem_Free(headers);
+    Py_DECREF(seq);
+    return result;
+}
+
+static int BulkCompressor_init(BulkStreamObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"level", NULL};
+    int level = BULK_DEFAULT_LEVEL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|i", kwlist, &level)) {
+        return -1;
+    }
+    if (level < 0 || level > 9) {
+        PyErr_SetString(PyExc_ValueError, "level must be between 0 and 9");
+        return -1;
+    }
+
+    bulk_compressor_end(&self->bulk);
+    if (bulk_compressor_init(&self->bulk, level) != Z_OK) {
+        PyErr_SetString(PyExc_MemoryError, "Failed to initialize compressor");
+        return -1;
+    }
+    return 0;
+}
+
+static void BulkCompressor_dealloc(BulkStreamObject *self) {
+    bulk_compressor_end(&self->bulk);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static PyObject* BulkCompressor_compress(BulkStreamObject *self, PyObject *args) {
+    Py_buffer data;
+    size_t produced = 0;
+
+    if (!self->bulk.ready) {
+        PyErr_SetString(PyExc_RuntimeError, "Compressor not initialized");
+        return NULL;
+    }
+    if (!PyArg_ParseTuple(args, "y*", &data)) {
+        return NULL;
+    }
+    if ((size_t)data.len > UINT32_MAX / 2) {
+        PyBuffer_Release(&data);
+        PyErr_SetString(PyExc_ValueError, "Packet too large");
+        return NULL;
+    }
+
+    size_t bound = bulk_compress_bound(&self->bulk, (size_t)data.len);
+    PyObject *out = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)bound);
+    if (out == NULL) {
+        PyBuffer_Release(&data);
+        return NULL;
+    }
+
+    int result = bulk_compress(&self->bulk, (const uint8_t*)data.buf, (size_t)data.len,
+                               (uint8_t*)PyBytes_AS_STRING(out), bound, &produced);
+    PyBuffer_Release(&data);
+
+    if (result != Z_OK) {
+        Py_DECREF(out);
+        PyErr_Format(PyExc_RuntimeError, "Compression failed: %d", result);
+        return NULL;
+    }
+    if (_PyBytes_Resize(&out, (Py_ssize_t)produced) < 0) {
+        return NULL;
+    }
+    return out;
+}
+
+static int BulkDecompressor_init(BulkStreamObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "", kwlist)) {
+        return -1;
+    }
+
+    bulk_decompressor_end(&self->bulk);
+    if (bulk_decompressor_init(&self->bulk) != Z_OK) {
+        PyErr_SetString(PyExc_MemoryError, "Failed to initialize decompressor");
+        return -1;
+    }
+    return 0;
+}
+
+static void BulkDecompressor_dealloc(BulkStreamObject *self) {
+    bulk_decompressor_end(&self->bulk);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static PyObject* BulkDecompressor_decompress(BulkStreamObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"data", "max_length", NULL};
+    Py_buffer data;
+    Py_ssize_t max_length = RDP_MAX_PAYLOAD_SIZE;
+    size_t produced = 0;
+
+    if (!self->bulk.ready) {
+        PyErr_SetString(PyExc_RuntimeError, "Decompressor not initialized");
+        return NULL;
+    }
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|n", kwlist, &data, &max_length)) {
+        return NULL;
+    }
+    if (max_length < 0 || (size_t)max_length >= UINT32_MAX || (size_t)data.len > UINT32_MAX / 2) {
+        PyBuffer_Release(&data);
+        PyErr_SetString(PyExc_ValueError, "Invalid packet or max_length");
+        return NULL;
+    }
+
+    // One spare byte tells "exactly max_length" apart from "too large"
+    PyObject *out = PyBytes_FromStringAndSize(NULL, max_length + 1);
+    if (out == NULL) {
+        PyBuffer_Release(&data);
+        return NULL;
+    }
+
+    int result = bulk_decompress(&self->bulk, (const uint8_t*)data.buf, (size_t)data.len,
+                                 (uint8_t*)PyBytes_AS_STRING(out), (size_t)max_length + 1, &produced);
+    PyBuffer_Release(&data);
+
+    if (result == Z_BUF_ERROR || (result == Z_OK && produced > (size_t)max_length)) {
+        Py_DECREF(out);
+        PyErr_SetString(PyExc_ValueError, "Decompressed packet exceeds max_length");
+        return NULL;
+    }
+    if (result != Z_OK) {
+        Py_DECREF(out);
+        PyErr_SetString(PyExc_ValueError, "Corrupt compressed packet");
+        return NULL;
+    }
+    if (_PyBytes_Resize(&out, (Py_ssize_t)produced) < 0) {
+        return NULL;
+    }
+    return out;
+}
+
+static PyObject* rdp_codec_version(PyObject *self, PyObject *args) {
+    return PyUnicode_FromString("0.1.0");
+}
+
+static PyMethodDef rdp_codec_module_methods[] = {
+    {"send_frames", rdp_codec_send_frames, METH_VARARGS,
+     "Write (type, channel, sequence, payload) frames with one non-blocking sendmsg; returns bytes sent"},
+    {"version", rdp_codec_version, METH_NOARGS, "Get version"},
+    {NULL, NULL, 0, NULL}
+};
+
+// Module definition
+static struct PyModuleDef rdp_codec_module = {
+    PyModuleDef_HEAD_INIT,
+    "rdp_codec_native",
+    "Native RDP codec extension for Lucid RDP",
+    -1,
+    rdp_codec_module_methods
+};
+
+PyMODINIT_FUNC PyInit_rdp_codec_native(void) {
+    if (PyType_Ready(&FrameDecoderType) < 0 ||
+        PyType_Ready(&BulkCompressorType) < 0 ||
+        PyType_Ready(&BulkDecompressorType) < 0) {
+        return NULL;
+    }
+
+    PyObject *m = PyModule_Create(&rdp_codec_module);
+    if (m == NULL) {
+        return NULL;
+    }
+
+    Py_INCREF(&FrameDecoderType);
+    if (PyModule_AddObject(m, "FrameDecoder", (PyObject*)&FrameDecoderType) < 0) {
+        Py_DECREF(&FrameDecoderType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    Py_INCREF(&BulkCompressorType);
+    if (PyModule_AddObject(m, "BulkCompressor", (PyObject*)&BulkCompressorType) < 0) {
+        Py_DECREF(&BulkCompressorType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    Py_INCREF(&BulkDecompressorType);
+    if (PyModule_AddObject(m, "BulkDecompressor", (PyObject*)&BulkDecompressorType) < 0) {
+        Py_DECREF(&BulkDecompressorType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    PyModule_AddIntConstant(m, "HEADER_SIZE", RDP_HEADER_SIZE);
+    PyModule_AddIntConstant(m, "MAX_PAYLOAD_SIZE", RDP_MAX_PAYLOAD_SIZE);
+
+    return m;
+}
@@ -0,0 +1,9 @@
+#ifndef RDP_CODEC_H
+#define RDP_CODEC_H
+
+#include <Python.h>
+
+// Constants
+#define RDP_MAX_IOVECS 1024  // Header + payload iovec per frame, per sendmsg
+
+#endif // RDP_CODEC_H
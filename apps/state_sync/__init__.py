@@ -0,0 +1,13 @@
+# State Sync Module
+# Range-hash state digests and reconciliation between node operators
+
+"""
+File: /app/apps/state_sync/__init__.py
+x-lucid-file-path: /app/apps/state_sync/__init__.py
+x-lucid-file-type: python
+
+State Sync package for Lucid RDP.
+Contains the native state digest used by node operator synchronization.
+"""
+
+__all__ = []
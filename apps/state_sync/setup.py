@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+"""
+File: /app/apps/state_sync/setup.py
+x-lucid-file-path: /app/apps/state_sync/setup.py
+x-lucid-file-type: python
+
+Setup script for native RDP codec extension
+"""
+
+from setuptools import setup, Extension
+
+# Define the extension module
+state_sync_native = Extension(
+    'state_sync_native',
+    sources=[
+        'src/state_sync.c',
+        'src/state_digest.c',
+        'src/reconcile.c'
+    ],
+    include_dirs=[
+        'src/'
+    ],
+    libraries=['crypto'],
+    library_dirs=[],
+    extra_compile_args=[
+        '-O3',
+        '-Wall',
+        '-Wextra',
+        '-std=c99',
+        '-fPIC'
+    ],
+    extra_link_args=['-shared']
+)
+
+setup(
+    name='state-sync-native',
+    version='0.1.0',
+    description='Native state sync extension for Lucid RDP',
+    ext_modules=[state_sync_native],
+    python_requires='>=3.8',
+    classifiers=[
+        'Development Status :: 3 - Alpha',
+        'Intended Audience :: Developers',
+        'License :: OSI Approved :: MIT License',
+        'Programming Language :: C',
+        'Programming Language :: Python :: 3',
+        'Programming Language :: Python :: 3.8',
+        'Programming Language :: Python :: 3.9',
+        'Programming Language :: Python :: 3.10',
+        'Programming Language :: Python :: 3.11',
+    ],
+)
@@ -0,0 +1,13 @@
+# State Sync Source Module
+# State sync native source code components
+
+"""
+File: /app/apps/state_sync/src/__init__.py
+x-lucid-file-path: /app/apps/state_sync/src/__init__.py
+x-lucid-file-type: python
+
+State Sync Source package for Lucid RDP.
+Contains state digest native source code and C implementations.
+"""
+
+__all__ = []
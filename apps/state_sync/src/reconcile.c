@@ -0,0 +1,356 @@
+#include "reconcile.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const digest_bound_t KEY_SPACE_START = {(const uint8_t*)"", 0};
+
+static int buf_reserve(recon_buf_t *buf, size_t extra) {
+    if (buf->len + extra <= buf->cap) {
+        return 0;
+    }
+    size_t cap = buf->cap ? buf->cap : 256;
+    while (cap < buf->len + extra) {
+        cap *= 2;
+    }
+    uint8_t *data = realloc(buf->data, cap);
+    if (data == NULL) {
+        return -1;
+    }
+    buf->data = data;
+    buf->cap = cap;
+    return 0;
+}
+
+static int buf_put(recon_buf_t *buf, const void *src, size_t n) {
+    if (buf_reserve(buf, n) < 0) {
+        return -1;
+    }
+    if (n) {
+        memcpy(buf->data + buf->len, src, n);
+    }
+    buf->len += n;
+    return 0;
+}
+
+static int buf_put_u8(recon_buf_t *buf, uint8_t v) {
+    return buf_put(buf, &v, 1);
+}
+
+static int buf_put_u32(recon_buf_t *buf, uint32_t v) {
+    uint8_t p[4];
+    for (int i = 0; i < 4; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+    return buf_put(buf, p, sizeof(p));
+}
+
+static int keys_push(recon_keys_t *keys, const uint8_t *key, size_t len) {
+    if (keys->len == keys->cap) {
+        size_t cap = keys->cap ? keys->cap * 2 : 64;
+        recon_key_t *grown = realloc(keys->keys, cap * sizeof(recon_key_t));
+        if (grown == NULL) {
+            return -1;
+        }
+        keys->keys = grown;
+        keys->cap = cap;
+    }
+    keys->keys[keys->len].key = key;
+    keys->keys[keys->len].len = len;
+    keys->len++;
+    return 0;
+}
+
+void recon_buf_free(recon_buf_t *buf) {
+    free(buf->data);
+    buf->data = NULL;
+    buf->len = buf->cap = 0;
+}
+
+void recon_diff_free(recon_diff_t *diff) {
+    free(diff->missing.keys);
+    free(diff->extra.keys);
+    free(diff->changed.keys);
+    memset(diff, 0, sizeof(*diff));
+}
+
+// Sequential message reader
+typedef struct {
+    const uint8_t *p;
+    const uint8_t *end;
+} reader_t;
+
+static int read_u8(reader_t *r, uint8_t *v) {
+    if (r->p >= r->end) {
+        return -1;
+    }
+    *v = *r->p++;
+    return 0;
+}
+
+static int read_u32(reader_t *r, uint32_t *v) {
+    if ((size_t)(r->end - r->p) < 4) {
+        return -1;
+    }
+    *v = (uint32_t)r->p[0] | ((uint32_t)r->p[1] << 8) | ((uint32_t)r->p[2] << 16) | ((uint32_t)r->p[3] << 24);
+    r->p += 4;
+    return 0;
+}
+
+static int read_bytes(reader_t *r, size_t n, const uint8_t **out) {
+    if ((size_t)(r->end - r->p) < n) {
+        return -1;
+    }
+    *out = r->p;
+    r->p += n;
+    return 0;
+}
+
+static int bound_less(digest_bound_t a, digest_bound_t b) {
+    if (a.key == NULL) {
+        return 0;
+    }
+    if (b.key == NULL) {
+        return 1;
+    }
+    return digest_key_cmp(a.key, a.len, b.key, b.len) < 0;
+}
+
+// Output writer: skipped ranges are coalesced and only written when a
+// later range needs its start position
+typedef struct {
+    recon_buf_t *out;
+    int gap;
+} writer_t;
+
+static int write_header(writer_t *w, uint8_t mode, digest_bound_t lower, digest_bound_t upper) {
+    if (w->out->len == 0 && buf_put_u8(w->out, RECON_VERSION) < 0) {
+        return -1;
+    }
+    if (w->gap) {
+        w->gap = 0;
+        if (write_header(w, RECON_SKIP, KEY_SPACE_START, lower) < 0) {
+            return -1;
+        }
+    }
+    if (buf_put_u8(w->out, mode) < 0) {
+        return -1;
+    }
+    if (upper.key == NULL) {
+        return buf_put_u8(w->out, 0);
+    }
+    if (buf_put_u8(w->out, 1) < 0 || buf_put_u32(w->out, (uint32_t)upper.len) < 0) {
+        return -1;
+    }
+    return buf_put(w->out, upper.key, upper.len);
+}
+
+static int write_items(writer_t *w, uint8_t mode, digest_bound_t lower, digest_bound_t upper,
+                       const digest_node_t **items, size_t n) {
+    if (write_header(w, mode, lower, upper) < 0 || buf_put_u32(w->out, (uint32_t)n) < 0) {
+        return -1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (buf_put_u32(w->out, items[i]->klen) < 0 ||
+            buf_put(w->out, items[i]->key, items[i]->klen) < 0 ||
+            buf_put(w->out, items[i]->hash, DIGEST_HASH_SIZE) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int collect_range(const state_digest_t *digest, digest_bound_t lower, digest_bound_t upper,
+                         uint64_t count, const digest_node_t ***items) {
+    *items = malloc((count ? count : 1) * sizeof(**items));
+    if (*items == NULL) {
+        return -1;
+    }
+    digest_collect(digest, lower, upper, *items, count);
+    return 0;
+}
+
+// Describes our side of a range the peer disagrees with: items when small,
+// otherwise fingerprints of sub-ranges split at evenly spaced ranks
+static int describe_range(const state_digest_t *digest, writer_t *w,
+                          digest_bound_t lower, digest_bound_t upper, const digest_agg_t *agg) {
+    if (agg->count <= RECON_ITEM_THRESHOLD) {
+        const digest_node_t **items;
+        if (collect_range(digest, lower, upper, agg->count, &items) < 0) {
+            return -1;
+        }
+        int rc = write_items(w, RECON_ITEMS, lower, upper, items, agg->count);
+        free(items);
+        return rc;
+    }
+
+    // Fewer parts than keys keeps every split point distinct
+    uint64_t parts = agg->count < RECON_BRANCHING ? agg->count : RECON_BRANCHING;
+    uint64_t base = digest_rank(digest, lower);
+    digest_bound_t start = lower;
+    for (uint64_t k = 1; k <= parts; k++) {
+        digest_bound_t end = upper;
+        if (k < parts) {
+            const digest_node_t *split = digest_select(digest, base + agg->count * k / parts);
+            end.key = split->key;
+            end.len = split->klen;
+        }
+        digest_agg_t part;
+        uint8_t fp[DIGEST_FP_SIZE];
+        digest_range(digest, start, end, &part);
+        digest_fingerprint(&part, fp);
+        if (write_header(w, RECON_FINGERPRINT, start, end) < 0 || buf_put(w->out, fp, sizeof(fp)) < 0) {
+            return -1;
+        }
+        start = end;
+    }
+    return 0;
+}
+
+int recon_initiate(const state_digest_t *digest, recon_buf_t *out) {
+    writer_t w = {out, 0};
+    digest_bound_t open = {NULL, 0};
+    digest_agg_t agg;
+
+    out->len = 0;
+    digest_range(digest, KEY_SPACE_START, open, &agg);
+    return describe_range(digest, &w, KEY_SPACE_START, open, &agg) < 0 ? RECON_ENOMEM : RECON_OK;
+}
+
+// Compares the peer's items with ours over [lower, upper); *differs is set
+// when any key is missing, extra or changed
+static int diff_items(reader_t *r, digest_bound_t lower, digest_bound_t upper,
+                      const digest_node_t **own, size_t own_n, recon_diff_t *diff, int *differs) {
+    uint32_t n;
+    size_t j = 0;
+    digest_bound_t prev = lower;
+    int first = 1;
+
+    if (read_u32(r, &n) < 0) {
+        return RECON_EMALFORMED;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t klen;
+        const uint8_t *key, *hash;
+        if (read_u32(r, &klen) < 0 || read_bytes(r, klen, &key) < 0 ||
+            read_bytes(r, DIGEST_HASH_SIZE, &hash) < 0) {
+            return RECON_EMALFORMED;
+        }
+        // Keys must ascend and stay inside the range
+        digest_bound_t at = {key, klen};
+        if ((first ? bound_less(at, prev) : !bound_less(prev, at)) || !bound_less(at, upper)) {
+            return RECON_EMALFORMED;
+        }
+        prev = at;
+        first = 0;
+
+        while (j < own_n && digest_key_cmp(own[j]->key, own[j]->klen, key, klen) < 0) {
+            if (keys_push(&diff->extra, own[j]->key, own[j]->klen) < 0) {
+                return RECON_ENOMEM;
+            }
+            *differs = 1;
+            j++;
+        }
+        if (j < own_n && digest_key_cmp(own[j]->key, own[j]->klen, key, klen) == 0) {
+            if (memcmp(own[j]->hash, hash, DIGEST_HASH_SIZE) != 0) {
+                if (keys_push(&diff->changed, own[j]->key, own[j]->klen) < 0) {
+                    return RECON_ENOMEM;
+                }
+                *differs = 1;
+            }
+            j++;
+        } else {
+            if (keys_push(&diff->missing, key, klen) < 0) {
+                return RECON_ENOMEM;
+            }
+            *differs = 1;
+        }
+    }
+    for (; j < own_n; j++) {
+        if (keys_push(&diff->extra, own[j]->key, own[j]->klen) < 0) {
+            return RECON_ENOMEM;
+        }
+        *differs = 1;
+    }
+    return RECON_OK;
+}
+
+int recon_process(const state_digest_t *digest, const uint8_t *msg, size_t len,
+                  recon_buf_t *out, recon_diff_t *diff) {
+    reader_t r = {msg, msg + len};
+    writer_t w = {out, 0};
+    digest_bound_t lower = KEY_SPACE_START;
+    uint8_t version;
+
+    out->len = 0;
+    if (len == 0) {
+        return RECON_OK;
+    }
+    if (read_u8(&r, &version) < 0 || version != RECON_VERSION) {
+        return RECON_EMALFORMED;
+    }
+
+    while (r.p < r.end) {
+        uint8_t mode, bounded;
+        digest_bound_t upper = {NULL, 0};
+
+        if (lower.key == NULL) {
+            return RECON_EMALFORMED;  // Data after the unbounded range
+        }
+        if (read_u8(&r, &mode) < 0 || read_u8(&r, &bounded) < 0 || bounded > 1) {
+            return RECON_EMALFORMED;
+        }
+        if (bounded) {
+            uint32_t klen;
+            if (read_u32(&r, &klen) < 0 || read_bytes(&r, klen, &upper.key) < 0) {
+                return RECON_EMALFORMED;
+            }
+            upper.len = klen;
+        }
+        if (!bound_less(lower, upper)) {
+            return RECON_EMALFORMED;
+        }
+
+        digest_agg_t agg;
+        digest_range(digest, lower, upper, &agg);
+
+        if (mode == RECON_SKIP) {
+            w.gap = 1;
+        } else if (mode == RECON_FINGERPRINT) {
+            const uint8_t *theirs;
+            uint8_t ours[DIGEST_FP_SIZE];
+            if (read_bytes(&r, DIGEST_FP_SIZE, &theirs) < 0) {
+                return RECON_EMALFORMED;
+            }
+            digest_fingerprint(&agg, ours);
+            if (memcmp(ours, theirs, DIGEST_FP_SIZE) == 0) {
+                w.gap = 1;
+            } else if (describe_range(digest, &w, lower, upper, &agg) < 0) {
+                return RECON_ENOMEM;
+            }
+        } else if (mode == RECON_ITEMS || mode == RECON_ITEMS_FINAL) {
+            const digest_node_t **own;
+            int differs = 0;
+            if (collect_range(digest, lower, upper, agg.count, &own) < 0) {
+                return RECON_ENOMEM;
+            }
+            int rc = diff_items(&r, lower, upper, own, agg.count, diff, &differs);
+            if (rc == RECON_OK) {
+                if (mode == RECON_ITEMS && differs) {
+                    if (write_items(&w, RECON_ITEMS_FINAL, lower, upper, own, agg.count) < 0) {
+                        rc = RECON_ENOMEM;
+                    }
+                } else {
+                    w.gap = 1;
+                }
+            }
+            free(own);
+            if (rc != RECON_OK) {
+                return rc;
+            }
+        } else {
+            return RECON_EMALFORMED;
+        }
+        lower = upper;
+    }
+    return RECON_OK;
+}
@@ -0,0 +1,70 @@
+#ifndef RECONCILE_H
+#define RECONCILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "state_digest.h"
+
+// Constants
+#define RECON_VERSION 1
+#define RECON_BRANCHING 16       // Sub-ranges per mismatching range
+#define RECON_ITEM_THRESHOLD 8   // Ranges this small are sent as items
+
+// Range modes
+#define RECON_SKIP 0         // Range already agrees
+#define RECON_FINGERPRINT 1  // 16-byte fingerprint of the sender's range
+#define RECON_ITEMS 2        // Sender's (key, hash) list; reply with ours if they differ
+#define RECON_ITEMS_FINAL 3  // Sender's (key, hash) list; no reply
+
+// Message: u8 version, then ranges in key order. The first range starts
+// at the empty key and each one starts where the previous one ended.
+//   u8 mode | u8 bounded | [u32 len | key] upper bound (exclusive)
+//   FINGERPRINT: fp[16]
+//   ITEMS, ITEMS_FINAL: u32 n | n x (u32 len | key | hash[32])
+// Only the last range may be unbounded; a message may stop before the end
+// of the key space, and an empty message means nothing is left to compare.
+// Every mismatching range is either split by rank into up to RECON_BRANCHING
+// fingerprints or, once small, settled by exchanging items, so d differing
+// keys cost O(d log n) ranges over O(log n) round trips.
+
+typedef struct {
+    uint8_t *data;
+    size_t len;
+    size_t cap;
+} recon_buf_t;
+
+typedef struct {
+    const uint8_t *key;
+    size_t len;
+} recon_key_t;
+
+typedef struct {
+    recon_key_t *keys;
+    size_t len;
+    size_t cap;
+} recon_keys_t;
+
+// Keys point into the peer message or into the digest, so copy them out
+// before either changes.
+typedef struct {
+    recon_keys_t missing;  // Peer has it, we do not
+    recon_keys_t extra;    // We have it, peer does not
+    recon_keys_t changed;  // Both have it with different hashes
+} recon_diff_t;
+
+// Return codes
+#define RECON_OK 0
+#define RECON_ENOMEM -1
+#define RECON_EMALFORMED -2
+
+// First message of a session
+int recon_initiate(const state_digest_t *digest, recon_buf_t *out);
+
+// Answers one peer message; out->len == 0 when there is nothing to send
+int recon_process(const state_digest_t *digest, const uint8_t *msg, size_t len,
+                  recon_buf_t *out, recon_diff_t *diff);
+
+void recon_buf_free(recon_buf_t *buf);
+void recon_diff_free(recon_diff_t *diff);
+
+#endif // RECONCILE_H
@@ -0,0 +1,393 @@
+#include "state_digest.h"
+#include <stdlib.h>
+#include <string.h>
+#include <openssl/sha.h>
+
+static void put_le32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static void put_le64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static uint64_t get_le64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+static void sum_add(uint64_t *acc, const uint64_t *v) {
+    uint64_t carry = 0;
+    for (int i = 0; i < DIGEST_SUM_WORDS; i++) {
+        uint64_t s = acc[i] + carry;
+        carry = s < carry;
+        acc[i] = s + v[i];
+        carry += acc[i] < s;
+    }
+}
+
+static void sum_sub(uint64_t *acc, const uint64_t *v) {
+    uint64_t borrow = 0;
+    for (int i = 0; i < DIGEST_SUM_WORDS; i++) {
+        uint64_t d = acc[i] - v[i];
+        uint64_t b = acc[i] < v[i];
+        acc[i] = d - borrow;
+        borrow = b | (d < borrow);
+    }
+}
+
+static void hash_words(const uint8_t hash[DIGEST_HASH_SIZE], uint64_t *out) {
+    for (int i = 0; i < DIGEST_SUM_WORDS; i++) {
+        out[i] = get_le64(hash + 8 * i);
+    }
+}
+
+int digest_key_cmp(const uint8_t *a, size_t alen, const uint8_t *b, size_t blen) {
+    size_t n = alen < blen ? alen : blen;
+    int c = n ? memcmp(a, b, n) : 0;
+    if (c != 0) {
+        return c;
+    }
+    return alen < blen ? -1 : (alen > blen ? 1 : 0);
+}
+
+// Compares a key with a bound; the open bound is above every key
+static int bound_cmp(const uint8_t *key, size_t klen, digest_bound_t bound) {
+    if (bound.key == NULL) {
+        return -1;
+    }
+    return digest_key_cmp(key, klen, bound.key, bound.len);
+}
+
+static uint64_t key_priority(const uint8_t *key, size_t klen) {
+    uint8_t hash[DIGEST_HASH_SIZE];
+    SHA256(key, klen, hash);
+    return get_le64(hash);
+}
+
+// Heap order of the treap; ties go to the smaller key so the shape never
+// depends on the order keys were written in
+static int node_above(const digest_node_t *a, const digest_node_t *b) {
+    if (a->priority != b->priority) {
+        return a->priority > b->priority;
+    }
+    return digest_key_cmp(a->key, a->klen, b->key, b->klen) < 0;
+}
+
+static void node_pull(digest_node_t *node) {
+    static const uint8_t absent[DIGEST_HASH_SIZE];
+    SHA256_CTX ctx;
+
+    hash_words(node->hash, node->sum);
+    node->count = 1;
+    if (node->left) {
+        node->count += node->left->count;
+        sum_add(node->sum, node->left->sum);
+    }
+    if (node->right) {
+        node->count += node->right->count;
+        sum_add(node->sum, node->right->sum);
+    }
+
+    SHA256_Init(&ctx);
+    SHA256_Update(&ctx, node->left ? node->left->merkle : absent, DIGEST_HASH_SIZE);
+    SHA256_Update(&ctx, node->hash, DIGEST_HASH_SIZE);
+    SHA256_Update(&ctx, node->right ? node->right->merkle : absent, DIGEST_HASH_SIZE);
+    SHA256_Final(node->merkle, &ctx);
+}
+
+static digest_node_t *rotate_right(digest_node_t *node) {
+    digest_node_t *l = node->left;
+    node->left = l->right;
+    l->right = node;
+    node_pull(node);
+    node_pull(l);
+    return l;
+}
+
+static digest_node_t *rotate_left(digest_node_t *node) {
+    digest_node_t *r = node->right;
+    node->right = r->left;
+    r->left = node;
+    node_pull(node);
+    node_pull(r);
+    return r;
+}
+
+static void node_free(digest_node_t *node) {
+    if (node) {
+        node_free(node->left);
+        node_free(node->right);
+        free(node);
+    }
+}
+
+void digest_init(state_digest_t *digest) {
+    digest->root = NULL;
+}
+
+void digest_free(state_digest_t *digest) {
+    node_free(digest->root);
+    digest->root = NULL;
+}
+
+void digest_entry_hash(const uint8_t *key, size_t klen,
+                       const uint8_t *value, size_t vlen,
+                       uint8_t out[DIGEST_HASH_SIZE]) {
+    SHA256_CTX ctx;
+    uint8_t len[4];
+
+    put_le32(len, (uint32_t)klen);
+    SHA256_Init(&ctx);
+    SHA256_Update(&ctx, len, sizeof(len));
+    SHA256_Update(&ctx, key, klen);
+    SHA256_Update(&ctx, value, vlen);
+    SHA256_Final(out, &ctx);
+}
+
+// Recursive insert; *result is 1 on insert or change, 0 if unchanged, -1 on ENOMEM
+static digest_node_t *node_put(digest_node_t *node, const uint8_t *key, size_t klen,
+                               const uint8_t *hash, int *result) {
+    if (node == NULL) {
+        digest_node_t *fresh = malloc(sizeof(digest_node_t) + klen);
+        if (fresh == NULL) {
+            *result = -1;
+            return NULL;
+        }
+        fresh->left = fresh->right = NULL;
+        fresh->priority = key_priority(key, klen);
+        fresh->klen = (uint32_t)klen;
+        memcpy(fresh->hash, hash, DIGEST_HASH_SIZE);
+        if (klen) {
+            memcpy(fresh->key, key, klen);
+        }
+        node_pull(fresh);
+        *result = 1;
+        return fresh;
+    }
+
+    int c = digest_key_cmp(key, klen, node->key, node->klen);
+    if (c == 0) {
+        if (memcmp(node->hash, hash, DIGEST_HASH_SIZE) == 0) {
+            *result = 0;
+            return node;
+        }
+        memcpy(node->hash, hash, DIGEST_HASH_SIZE);
+        *result = 1;
+    } else if (c < 0) {
+        digest_node_t *child = node_put(node->left, key, klen, hash, result);
+        if (*result <= 0) {
+            return node;  // Unchanged, or out of memory with the subtree intact
+        }
+        node->left = child;
+        if (node_above(child, node)) {
+            return rotate_right(node);
+        }
+    } else {
+        digest_node_t *child = node_put(node->right, key, klen, hash, result);
+        if (*result <= 0) {
+            return node;
+        }
+        node->right = child;
+        if (node_above(child, node)) {
+            return rotate_left(node);
+        }
+    }
+    node_pull(node);
+    return node;
+}
+
+int digest_put(state_digest_t *digest, const uint8_t *key, size_t klen,
+               const uint8_t hash[DIGEST_HASH_SIZE]) {
+    int result = 0;
+    digest->root = node_put(digest->root, key, klen, hash, &result);
+    return result;
+}
+
+static digest_node_t *node_merge(digest_node_t *a, digest_node_t *b) {
+    if (a == NULL) {
+        return b;
+    }
+    if (b == NULL) {
+        return a;
+    }
+    if (node_above(a, b)) {
+        a->right = node_merge(a->right, b);
+        node_pull(a);
+        return a;
+    }
+    b->left = node_merge(a, b->left);
+    node_pull(b);
+    return b;
+}
+
+static digest_node_t *node_delete(digest_node_t *node, const uint8_t *key, size_t klen, int *removed) {
+    if (node == NULL) {
+        return NULL;
+    }
+    int c = digest_key_cmp(key, klen, node->key, node->klen);
+    if (c == 0) {
+        digest_node_t *merged = node_merge(node->left, node->right);
+        free(node);
+        *removed = 1;
+        return merged;
+    }
+    if (c < 0) {
+        node->left = node_delete(node->left, key, klen, removed);
+    } else {
+        node->right = node_delete(node->right, key, klen, removed);
+    }
+    if (*removed) {
+        node_pull(node);
+    }
+    return node;
+}
+
+int digest_delete(state_digest_t *digest, const uint8_t *key, size_t klen) {
+    int removed = 0;
+    digest->root = node_delete(digest->root, key, klen, &removed);
+    return removed;
+}
+
+const digest_node_t *digest_find(const state_digest_t *digest, const uint8_t *key, size_t klen) {
+    const digest_node_t *node = digest->root;
+    while (node) {
+        int c = digest_key_cmp(key, klen, node->key, node->klen);
+        if (c == 0) {
+            return node;
+        }
+        node = c < 0 ? node->left : node->right;
+    }
+    return NULL;
+}
+
+uint64_t digest_count(const state_digest_t *digest) {
+    return digest->root ? digest->root->count : 0;
+}
+
+// Summary of every key below bound
+static void prefix_agg(const state_digest_t *digest, digest_bound_t bound, digest_agg_t *out) {
+    const digest_node_t *node = digest->root;
+    uint64_t words[DIGEST_SUM_WORDS];
+
+    memset(out, 0, sizeof(*out));
+    if (bound.key == NULL) {
+        if (node) {
+            out->count = node->count;
+            memcpy(out->sum, node->sum, sizeof(out->sum));
+        }
+        return;
+    }
+    while (node) {
+        if (bound_cmp(node->key, node->klen, bound) < 0) {
+            if (node->left) {
+                out->count += node->left->count;
+                sum_add(out->sum, node->left->sum);
+            }
+            out->count++;
+            hash_words(node->hash, words);
+            sum_add(out->sum, words);
+            node = node->right;
+        } else {
+            node = node->left;
+        }
+    }
+}
+
+void digest_range(const state_digest_t *digest, digest_bound_t lo, digest_bound_t hi,
+                  digest_agg_t *out) {
+    digest_agg_t below;
+
+    prefix_agg(digest, hi, out);
+    prefix_agg(digest, lo, &below);
+    out->count -= below.count;
+    sum_sub(out->sum, below.sum);
+}
+
+uint64_t digest_rank(const state_digest_t *digest, digest_bound_t bound) {
+    const digest_node_t *node = digest->root;
+    uint64_t rank = 0;
+
+    if (bound.key == NULL) {
+        return digest_count(digest);
+    }
+    while (node) {
+        if (bound_cmp(node->key, node->klen, bound) < 0) {
+            rank += (node->left ? node->left->count : 0) + 1;
+            node = node->right;
+        } else {
+            node = node->left;
+        }
+    }
+    return rank;
+}
+
+const digest_node_t *digest_select(const state_digest_t *digest, uint64_t rank) {
+    const digest_node_t *node = digest->root;
+    while (node) {
+        uint64_t left = node->left ? node->left->count : 0;
+        if (rank < left) {
+            node = node->left;
+        } else if (rank == left) {
+            return node;
+        } else {
+            rank -= left + 1;
+            node = node->right;
+        }
+    }
+    return NULL;
+}
+
+static void node_collect(const digest_node_t *node, digest_bound_t lo, digest_bound_t hi,
+                         const digest_node_t **out, size_t max, size_t *n) {
+    while (node && *n < max) {
+        int above_lo = bound_cmp(node->key, node->klen, lo) >= 0;
+        int below_hi = bound_cmp(node->key, node->klen, hi) < 0;
+        if (above_lo) {
+            node_collect(node->left, lo, hi, out, max, n);
+            if (below_hi && *n < max) {
+                out[(*n)++] = node;
+            }
+        }
+        if (!below_hi) {
+            return;
+        }
+        node = node->right;
+    }
+}
+
+size_t digest_collect(const state_digest_t *digest, digest_bound_t lo, digest_bound_t hi,
+                      const digest_node_t **out, size_t max) {
+    size_t n = 0;
+    node_collect(digest->root, lo, hi, out, max, &n);
+    return n;
+}
+
+void digest_fingerprint(const digest_agg_t *agg, uint8_t out[DIGEST_FP_SIZE]) {
+    uint8_t buf[DIGEST_SUM_WORDS * 8 + 8];
+    uint8_t hash[DIGEST_HASH_SIZE];
+
+    for (int i = 0; i < DIGEST_SUM_WORDS; i++) {
+        put_le64(buf + 8 * i, agg->sum[i]);
+    }
+    put_le64(buf + DIGEST_SUM_WORDS * 8, agg->count);
+    SHA256(buf, sizeof(buf), hash);
+    memcpy(out, hash, DIGEST_FP_SIZE);
+}
+
+void digest_root(const state_digest_t *digest, uint8_t out[DIGEST_HASH_SIZE]) {
+    uint8_t buf[8 + DIGEST_HASH_SIZE] = {0};
+
+    put_le64(buf, digest_count(digest));
+    if (digest->root) {
+        memcpy(buf + 8, digest->root->merkle, DIGEST_HASH_SIZE);
+    }
+    SHA256(buf, sizeof(buf), out);
+}
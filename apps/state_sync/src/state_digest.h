@@ -0,0 +1,87 @@
+#ifndef STATE_DIGEST_H
+#define STATE_DIGEST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Constants
+#define DIGEST_HASH_SIZE 32  // SHA-256
+#define DIGEST_FP_SIZE 16
+#define DIGEST_SUM_WORDS 4   // 256-bit sum as little-endian 64-bit words
+
+// Treap node over the sorted key space. Every node carries the count and
+// the sum (mod 2^256) of the entry hashes in its subtree, so the summary
+// of any key range is a difference of two O(log n) prefix walks and a
+// write only touches the nodes on its path.
+//
+// Sums only steer reconciliation: entries can be chosen to make two sums
+// collide, so they are never a commitment. Priorities come from the key
+// alone, which makes the treap's shape a function of the key set, and
+// each node also keeps a Merkle hash over its subtree; the root commits
+// to the state through those.
+typedef struct digest_node {
+    struct digest_node *left;
+    struct digest_node *right;
+    uint64_t count;
+    uint64_t sum[DIGEST_SUM_WORDS];
+    uint64_t priority;           // SHA-256(key)[0:8], little-endian
+    uint8_t merkle[DIGEST_HASH_SIZE];
+    uint32_t klen;
+    uint8_t hash[DIGEST_HASH_SIZE];
+    uint8_t key[];
+} digest_node_t;
+
+typedef struct {
+    digest_node_t *root;
+} state_digest_t;
+
+// Count and hash sum of a key range
+typedef struct {
+    uint64_t count;
+    uint64_t sum[DIGEST_SUM_WORDS];
+} digest_agg_t;
+
+// Range bound; key == NULL is the open upper end of the key space
+typedef struct {
+    const uint8_t *key;
+    size_t len;
+} digest_bound_t;
+
+void digest_init(state_digest_t *digest);
+void digest_free(state_digest_t *digest);
+
+// entry hash = SHA-256(u32 key length || key || value)
+void digest_entry_hash(const uint8_t *key, size_t klen,
+                       const uint8_t *value, size_t vlen,
+                       uint8_t out[DIGEST_HASH_SIZE]);
+
+// 1 inserted or hash changed, 0 unchanged, -1 out of memory
+int digest_put(state_digest_t *digest, const uint8_t *key, size_t klen,
+               const uint8_t hash[DIGEST_HASH_SIZE]);
+// 1 removed, 0 absent
+int digest_delete(state_digest_t *digest, const uint8_t *key, size_t klen);
+const digest_node_t *digest_find(const state_digest_t *digest, const uint8_t *key, size_t klen);
+
+uint64_t digest_count(const state_digest_t *digest);
+// Summary of [lo, hi)
+void digest_range(const state_digest_t *digest, digest_bound_t lo, digest_bound_t hi,
+                  digest_agg_t *out);
+// Number of keys below bound
+uint64_t digest_rank(const state_digest_t *digest, digest_bound_t bound);
+// Entry at a 0-based rank, NULL past the end
+const digest_node_t *digest_select(const state_digest_t *digest, uint64_t rank);
+// Entries in [lo, hi) in key order; returns how many were written (<= max)
+size_t digest_collect(const state_digest_t *digest, digest_bound_t lo, digest_bound_t hi,
+                      const digest_node_t **out, size_t max);
+
+// fingerprint = SHA-256(sum || u64 count)[0:16]
+void digest_fingerprint(const digest_agg_t *agg, uint8_t out[DIGEST_FP_SIZE]);
+// merkle(node) = SHA-256(merkle(left) || entry hash || merkle(right)), a
+// missing child counting as 32 zero bytes, where a node sits above every
+// node with a lower priority, or an equal one and a greater key;
+// root = SHA-256(u64 count || merkle(top)), zeros for an empty state
+void digest_root(const state_digest_t *digest, uint8_t out[DIGEST_HASH_SIZE]);
+
+int digest_key_cmp(const uint8_t *a, size_t alen, const uint8_t *b, size_t blen);
+
+#endif // STATE_DIGEST_H
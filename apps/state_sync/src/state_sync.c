@@ -0,0 +1,432 @@
+/*
+ * Native state sync extension for Lucid RDP
+ * Range-hash digest over the sorted key space of operator state, updated
+ * on every write, and a stateless range reconciliation protocol that
+ * finds the keys two operators disagree on without shipping the state
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <stdint.h>
+#include <string.h>
+#include "state_sync.h"
+#include "state_digest.h"
+#include "reconcile.h"
+
+// StateDigest object structure
+typedef struct {
+    PyObject_HEAD
+    state_digest_t digest;
+    int busy;  // Set while a reconcile step runs without the GIL
+    uint64_t messages;
+    uint64_t bytes_out;
+} StateDigestObject;
+
+static PyTypeObject StateDigestType;
+
+// Forward declarations
+static PyObject* StateDigest_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
+static void StateDigest_dealloc(StateDigestObject *self);
+static PyObject* StateDigest_put(StateDigestObject *self, PyObject *args);
+static PyObject* StateDigest_delete(StateDigestObject *self, PyObject *args);
+static PyObject* StateDigest_get(StateDigestObject *self, PyObject *args);
+static PyObject* StateDigest_fingerprint(StateDigestObject *self, PyObject *args, PyObject *kwds);
+static PyObject* StateDigest_keys(StateDigestObject *self, PyObject *args, PyObject *kwds);
+static PyObject* StateDigest_initiate(StateDigestObject *self, PyObject *args);
+static PyObject* StateDigest_reconcile(StateDigestObject *self, PyObject *args);
+static PyObject* StateDigest_get_root(StateDigestObject *self, void *closure);
+static PyObject* StateDigest_get_stats(StateDigestObject *self, void *closure);
+static Py_ssize_t StateDigest_length(StateDigestObject *self);
+static int StateDigest_contains(StateDigestObject *self, PyObject *key);
+
+// Method definitions
+static PyMethodDef StateDigest_methods[] = {
+    {"put", (PyCFunction)StateDigest_put, METH_VARARGS, "Set key to the hash of value; True if the digest changed"},
+    {"delete", (PyCFunction)StateDigest_delete, METH_VARARGS, "Remove key; True if it was present"},
+    {"get", (PyCFunction)StateDigest_get, METH_VARARGS, "Entry hash of key, or None"},
+    {"fingerprint", (PyCFunction)(void(*)(void))StateDigest_fingerprint, METH_VARARGS | METH_KEYWORDS,
+     "(count, fingerprint) of the keys in [lo, hi)"},
+    {"keys", (PyCFunction)(void(*)(void))StateDigest_keys, METH_VARARGS | METH_KEYWORDS,
+     "Keys in [lo, hi) in sorted order"},
+    {"initiate", (PyCFunction)StateDigest_initiate, METH_NOARGS, "First reconciliation message"},
+    {"reconcile", (PyCFunction)StateDigest_reconcile, METH_VARARGS,
+     "Answer a peer message: (reply or None, missing, extra, changed)"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef StateDigest_getset[] = {
+    {"root", (getter)StateDigest_get_root, NULL, "Merkle commitment to the whole state", NULL},
+    {"stats", (getter)StateDigest_get_stats, NULL, "Reconciliation messages and bytes produced", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PySequenceMethods StateDigest_as_sequence = {
+    .sq_length = (lenfunc)StateDigest_length,
+    .sq_contains = (objobjproc)StateDigest_contains,
+};
+
+// Type definition
+static PyTypeObject StateDigestType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "state_sync_native.StateDigest",
+    .tp_doc = "Incrementally maintained range-hash digest of keyed state",
+    .tp_basicsize = sizeof(StateDigestObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = StateDigest_new,
+    .tp_dealloc = (destructor)StateDigest_dealloc,
+    .tp_methods = StateDigest_methods,
+    .tp_getset = StateDigest_getset,
+    .tp_as_sequence = &StateDigest_as_sequence,
+};
+
+static int check_idle(StateDigestObject *self) {
+    if (self->busy) {
+        PyErr_SetString(PyExc_RuntimeError, "StateDigest is in use by another thread");
+        return -1;
+    }
+    return 0;
+}
+
+static int check_key(Py_ssize_t len) {
+    if (len > STATE_SYNC_MAX_KEY) {
+        PyErr_Format(PyExc_ValueError, "Key longer than %d bytes", STATE_SYNC_MAX_KEY);
+        return -1;
+    }
+    return 0;
+}
+
+// None is the open end of the key space; lo defaults to the empty key
+static int parse_bound(PyObject *obj, digest_bound_t *bound, Py_buffer *view, int is_lower) {
+    view->obj = NULL;
+    if (obj == NULL || obj == Py_None) {
+        bound->key = is_lower ? (const uint8_t*)"" : NULL;
+        bound->len = 0;
+        return 0;
+    }
+    if (PyObject_GetBuffer(obj, view, PyBUF_SIMPLE) < 0) {
+        return -1;
+    }
+    bound->key = (const uint8_t*)view->buf;
+    bound->len = (size_t)view->len;
+    return 0;
+}
+
+static void release_bound(Py_buffer *view) {
+    if (view->obj != NULL) {
+        PyBuffer_Release(view);
+    }
+}
+
+static PyObject* keys_to_list(const recon_keys_t *keys) {
+    PyObject *list = PyList_New((Py_ssize_t)keys->len);
+    for (size_t i = 0; list != NULL && i < keys->len; i++) {
+        PyObject *key = PyBytes_FromStringAndSize((const char*)keys->keys[i].key, (Py_ssize_t)keys->keys[i].len);
+        if (key == NULL) {
+            Py_CLEAR(list);
+            break;
+        }
+        PyList_SET_ITEM(list, (Py_ssize_t)i, key);
+    }
+    return list;
+}
+
+static PyObject* StateDigest_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
+    StateDigestObject *self = (StateDigestObject*)type->tp_alloc(type, 0);
+    if (self != NULL) {
+        digest_init(&self->digest);
+    }
+    return (PyObject*)self;
+}
+
+static void StateDigest_dealloc(StateDigestObject *self) {
+    digest_free(&self->digest);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static PyObject* StateDigest_put(StateDigestObject *self, PyObject *args) {
+    Py_buffer key, value;
+    uint8_t hash[DIGEST_HASH_SIZE];
+
+    if (!PyArg_ParseTuple(args, "y*y*", &key, &value)) {
+        return NULL;
+    }
+    if (check_idle(self) < 0 || check_key(key.len) < 0) {
+        PyBuffer_Release(&key);
+        PyBuffer_Release(&value);
+        return NULL;
+    }
+
+    digest_entry_hash(key.buf, (size_t)key.len, value.buf, (size_t)value.len, hash);
+    int rc = digest_put(&self->digest, key.buf, (size_t)key.len, hash);
+    PyBuffer_Release(&key);
+    PyBuffer_Release(&value);
+
+    if (rc < 0) {
+        return PyErr_NoMemory();
+    }
+    return PyBool_FromLong(rc);
+}
+
+static PyObject* StateDigest_delete(StateDigestObject *self, PyObject *args) {
+    Py_buffer key;
+
+    if (!PyArg_ParseTuple(args, "y*", &key)) {
+        return NULL;
+    }
+    if (check_idle(self) < 0) {
+        PyBuffer_Release(&key);
+        return NULL;
+    }
+    int removed = digest_delete(&self->digest, key.buf, (size_t)key.len);
+    PyBuffer_Release(&key);
+    return PyBool_FromLong(removed);
+}
+
+static PyObject* StateDigest_get(StateDigestObject *self, PyObject *args) {
+    Py_buffer key;
+
+    if (!PyArg_ParseTuple(args, "y*", &key)) {
+        return NULL;
+    }
+    const digest_node_t *node = digest_find(&self->digest, key.buf, (size_t)key.len);
+    PyBuffer_Release(&key);
+    if (node == NULL) {
+        Py_RETURN_NONE;
+    }
+    return PyBytes_FromStringAndSize((const char*)node->hash, DIGEST_HASH_SIZE);
+}
+
+static PyObject* StateDigest_fingerprint(StateDigestObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"lo", "hi", NULL};
+    PyObject *lo_obj = NULL, *hi_obj = NULL;
+    Py_buffer lo_view, hi_view;
+    digest_bound_t lo, hi;
+    digest_agg_t agg;
+    uint8_t fp[DIGEST_FP_SIZE];
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|OO", kwlist, &lo_obj, &hi_obj)) {
+        return NULL;
+    }
+    if (parse_bound(lo_obj, &lo, &lo_view, 1) < 0) {
+        return NULL;
+    }
+    if (parse_bound(hi_obj, &hi, &hi_view, 0) < 0) {
+        release_bound(&lo_view);
+        return NULL;
+    }
+
+    digest_range(&self->digest, lo, hi, &agg);
+    // An empty or inverted range has no keys
+    if (hi.key != NULL && digest_key_cmp(lo.key, lo.len, hi.key, hi.len) >= 0) {
+        memset(&agg, 0, sizeof(agg));
+    }
+    digest_fingerprint(&agg, fp);
+    release_bound(&lo_view);
+    release_bound(&hi_view);
+    return Py_BuildValue("(Ky#)", (unsigned long long)agg.count, fp, (Py_ssize_t)DIGEST_FP_SIZE);
+}
+
+static PyObject* StateDigest_keys(StateDigestObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"lo", "hi", NULL};
+    PyObject *lo_obj = NULL, *hi_obj = NULL;
+    Py_buffer lo_view, hi_view;
+    digest_bound_t lo, hi;
+    digest_agg_t agg;
+    PyObject *result = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|OO", kwlist, &lo_obj, &hi_obj)) {
+        return NULL;
+    }
+    if (parse_bound(lo_obj, &lo, &lo_view, 1) < 0) {
+        return NULL;
+    }
+    if (parse_bound(hi_obj, &hi, &hi_view, 0) < 0) {
+        release_bound(&lo_view);
+        return NULL;
+    }
+
+    digest_range(&self->digest, lo, hi, &agg);
+    if (hi.key != NULL && digest_key_cmp(lo.key, lo.len, hi.key, hi.len) >= 0) {
+        agg.count = 0;
+    }
+    const digest_node_t **nodes = PyMem_Malloc((agg.count ? agg.count : 1) * sizeof(*nodes));
+    if (nodes == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    size_t n = digest_collect(&self->digest, lo, hi, nodes, agg.count);
+    result = PyList_New((Py_ssize_t)n);
+    for (size_t i = 0; result != NULL && i < n; i++) {
+        PyObject *key = PyBytes_FromStringAndSize((const char*)nodes[i]->key, nodes[i]->klen);
+        if (key == NULL) {
+            Py_CLEAR(result);
+            break;
+        }
+        PyList_SET_ITEM(result, (Py_ssize_t)i, key);
+    }
+    PyMem_Free(nodes);
+
+done:
+    release_bound(&lo_view);
+    release_bound(&hi_view);
+    return result;
+}
+
+static PyObject* StateDigest_initiate(StateDigestObject *self, PyObject *args) {
+    recon_buf_t out = {NULL, 0, 0};
+
+    if (check_idle(self) < 0) {
+        return NULL;
+    }
+    if (recon_initiate(&self->digest, &out) != RECON_OK) {
+        recon_buf_free(&out);
+        return PyErr_NoMemory();
+    }
+    PyObject *msg = PyBytes_FromStringAndSize((const char*)out.data, (Py_ssize_t)out.len);
+    self->messages++;
+    self->bytes_out += out.len;
+    recon_buf_free(&out);
+    return msg;
+}
+
+static PyObject* StateDigest_reconcile(StateDigestObject *self, PyObject *args) {
+    Py_buffer msg;
+    recon_buf_t out = {NULL, 0, 0};
+    recon_diff_t diff;
+    int rc;
+
+    if (!PyArg_ParseTuple(args, "y*", &msg)) {
+        return NULL;
+    }
+    if (check_idle(self) < 0) {
+        PyBuffer_Release(&msg);
+        return NULL;
+    }
+
+    memset(&diff, 0, sizeof(diff));
+    self->busy = 1;
+    Py_BEGIN_ALLOW_THREADS
+    rc = recon_process(&self->digest, msg.buf, (size_t)msg.len, &out, &diff);
+    Py_END_ALLOW_THREADS
+    self->busy = 0;
+
+    PyObject *result = NULL;
+    if (rc == RECON_ENOMEM) {
+        PyErr_NoMemory();
+    } else if (rc == RECON_EMALFORMED) {
+        PyErr_SetString(PyExc_ValueError, "Malformed reconciliation message");
+    } else {
+        PyObject *reply;
+        if (out.len) {
+            reply = PyBytes_FromStringAndSize((const char*)out.data, (Py_ssize_t)out.len);
+            self->messages++;
+            self->bytes_out += out.len;
+        } else {
+            reply = Py_None;
+            Py_INCREF(reply);
+        }
+        PyObject *missing = keys_to_list(&diff.missing);
+        PyObject *extra = keys_to_list(&diff.extra);
+        PyObject *changed = keys_to_list(&diff.changed);
+        if (reply && missing && extra && changed) {
+            result = PyTuple_Pack(4, reply, missing, extra, changed);
+        }
+        Py_XDECREF(reply);
+        Py_XDECREF(missing);
+        Py_XDECREF(extra);
+        Py_XDECREF(changed);
+    }
+
+    recon_diff_free(&diff);
+    recon_buf_free(&out);
+    PyBuffer_Release(&msg);
+    return result;
+}
+
+static PyObject* StateDigest_get_root(StateDigestObject *self, void *closure) {
+    uint8_t root[DIGEST_HASH_SIZE];
+    digest_root(&self->digest, root);
+    return PyBytes_FromStringAndSize((const char*)root, DIGEST_HASH_SIZE);
+}
+
+static PyObject* StateDigest_get_stats(StateDigestObject *self, void *closure) {
+    return Py_BuildValue("{s:K,s:K,s:K}",
+        "keys", (unsigned long long)digest_count(&self->digest),
+        "messages", (unsigned long long)self->messages,
+        "bytes_out", (unsigned long long)self->bytes_out);
+}
+
+static Py_ssize_t StateDigest_length(StateDigestObject *self) {
+    return (Py_ssize_t)digest_count(&self->digest);
+}
+
+static int StateDigest_contains(StateDigestObject *self, PyObject *key) {
+    Py_buffer view;
+    if (PyObject_GetBuffer(key, &view, PyBUF_SIMPLE) < 0) {
+        return -1;
+    }
+    int found = digest_find(&self->digest, view.buf, (size_t)view.len) != NULL;
+    PyBuffer_Release(&view);
+    return found;
+}
+
+// Module methods
+static PyObject* state_sync_version(PyObject *self, PyObject *args) {
+    return PyUnicode_FromString("0.1.0");
+}
+
+static PyObject* state_sync_entry_hash(PyObject *self, PyObject *args) {
+    Py_buffer key, value;
+    uint8_t hash[DIGEST_HASH_SIZE];
+
+    if (!PyArg_ParseTuple(args, "y*y*", &key, &value)) {
+        return NULL;
+    }
+    digest_entry_hash(key.buf, (size_t)key.len, value.buf, (size_t)value.len, hash);
+    PyBuffer_Release(&key);
+    PyBuffer_Release(&value);
+    return PyBytes_FromStringAndSize((const char*)hash, DIGEST_HASH_SIZE);
+}
+
+static PyMethodDef state_sync_module_methods[] = {
+    {"version", state_sync_version, METH_NOARGS, "Get version"},
+    {"entry_hash", state_sync_entry_hash, METH_VARARGS, "SHA-256 entry hash the digest stores for (key, value)"},
+    {NULL, NULL, 0, NULL}
+};
+
+// Module definition
+static struct PyModuleDef state_sync_module = {
+    PyModuleDef_HEAD_INIT,
+    "state_sync_native",
+    "Native state sync extension for Lucid RDP",
+    -1,
+    state_sync_module_methods
+};
+
+PyMODINIT_FUNC PyInit_state_sync_native(void) {
+    if (PyType_Ready(&StateDigestType) < 0) {
+        return NULL;
+    }
+
+    PyObject *m = PyModule_Create(&state_sync_module);
+    if (m == NULL) {
+        return NULL;
+    }
+
+    Py_INCREF(&StateDigestType);
+    if (PyModule_AddObject(m, "StateDigest", (PyObject*)&StateDigestType) < 0) {
+        Py_DECREF(&StateDigestType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    PyModule_AddIntConstant(m, "HASH_SIZE", DIGEST_HASH_SIZE);
+    PyModule_AddIntConstant(m, "FINGERPRINT_SIZE", DIGEST_FP_SIZE);
+    PyModule_AddIntConstant(m, "PROTOCOL_VERSION", RECON_VERSION);
+    PyModule_AddIntConstant(m, "BRANCHING", RECON_BRANCHING);
+    PyModule_AddIntConstant(m, "ITEM_THRESHOLD", RECON_ITEM_THRESHOLD);
+    PyModule_AddIntConstant(m, "MAX_KEY", STATE_SYNC_MAX_KEY);
+
+    return m;
+}
@@ -0,0 +1,9 @@
+#ifndef STATE_SYNC_H
+#define STATE_SYNC_H
+
+#include <Python.h>
+
+// Constants
+#define STATE_SYNC_MAX_KEY (64 * 1024)
+
+#endif // STATE_SYNC_H
@@ -0,0 +1,13 @@
+# Storage Proof Module
+# Proof-of-storage challenge engine
+
+"""
+File: /app/apps/storage_proof/__init__.py
+x-lucid-file-path: /app/apps/storage_proof/__init__.py
+x-lucid-file-type: python
+
+Storage Proof package for Lucid RDP.
+Contains the native Merkle challenge/response engine used to audit stored chunks.
+"""
+
+__all__ = []
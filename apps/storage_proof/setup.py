@@ -0,0 +1,51 @@
+#!/usr/bin/env python3
+"""
+File: /app/apps/storage_proof/setup.py
+x-lucid-file-path: /app/apps/storage_proof/setup.py
+x-lucid-file-type: python
+
+Setup script for native proof-of-storage extension
+"""
+
+from setuptools import setup, Extension
+
+# Define the extension module
+storage_proof_native = Extension(
+    'storage_proof_native',
+    sources=[
+        'src/storage_proof.c',
+        'src/merkle_tree.c'
+    ],
+    include_dirs=[
+        'src/'
+    ],
+    libraries=['crypto'],
+    library_dirs=[],
+    extra_compile_args=[
+        '-O3',
+        '-Wall',
+        '-Wextra',
+        '-std=c99',
+        '-fPIC'
+    ],
+    extra_link_args=['-shared']
+)
+
+setup(
+    name='storage-proof-native',
+    version='0.1.0',
+    description='Native proof-of-storage extension for Lucid RDP',
+    ext_modules=[storage_proof_native],
+    python_requires='>=3.8',
+    classifiers=[
+        'Development Status :: 3 - Alpha',
+        'Intended Audience :: Developers',
+        'License :: OSI Approved :: MIT License',
+        'Programming Language :: C',
+        'Programming Language :: Python :: 3',
+        'Programming Language :: Python :: 3.8',
+        'Programming Language :: Python :: 3.9',
+        'Programming Language :: Python :: 3.10',
+        'Programming Language :: Python :: 3.11',
+    ],
+)
@@ -0,0 +1,13 @@
+# Storage Proof Source Module
+# Proof-of-storage native source code components
+
+"""
+File: /app/apps/storage_proof/src/__init__.py
+x-lucid-file-path: /app/apps/storage_proof/src/__init__.py
+x-lucid-file-type: python
+
+Storage Proof Source package for Lucid RDP.
+Contains proof-of-storage native source code and C implementations.
+"""
+
+__all__ = []
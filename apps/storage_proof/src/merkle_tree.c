@@ -0,0 +1,185 @@
+#include <stdlib.h>
+#include <string.h>
+#include <openssl/sha.h>
+#include "merkle_tree.h"
+
+size_t proof_block_count(size_t data_size, size_t block_size) {
+    size_t count = (data_size + block_size - 1) / block_size;
+    return count ? count : 1;
+}
+
+size_t proof_block_length(size_t data_size, size_t block_size, size_t index) {
+    size_t offset = index * block_size;
+    if (offset >= data_size) {
+        return 0;
+    }
+    return data_size - offset < block_size ? data_size - offset : block_size;
+}
+
+void proof_leaf_hash(uint64_t index, const uint8_t *block, size_t len, uint8_t *out) {
+    SHA256_CTX ctx;
+    uint8_t header[9];
+
+    // Binding the index stops a holder from answering with another block
+    header[0] = PROOF_LEAF_PREFIX;
+    for (int i = 0; i < 8; i++) {
+        header[1 + i] = (uint8_t)(index >> (8 * i));
+    }
+
+    SHA256_Init(&ctx);
+    SHA256_Update(&ctx, header, sizeof(header));
+    SHA256_Update(&ctx, block, len);
+    SHA256_Final(out, &ctx);
+}
+
+void proof_node_hash(const uint8_t *left, const uint8_t *right, uint8_t *out) {
+    SHA256_CTX ctx;
+    uint8_t prefix = PROOF_NODE_PREFIX;
+
+    SHA256_Init(&ctx);
+    SHA256_Update(&ctx, &prefix, 1);
+    SHA256_Update(&ctx, left, PROOF_HASH_SIZE);
+    SHA256_Update(&ctx, right, PROOF_HASH_SIZE);
+    SHA256_Final(out, &ctx);
+}
+
+int proof_tree_alloc(proof_tree_t *tree, size_t data_size, size_t block_size) {
+    if (block_size == 0) {
+        return -1;
+    }
+
+    memset(tree, 0, sizeof(*tree));
+    tree->data_size = data_size;
+    tree->block_size = block_size;
+    tree->block_count = proof_block_count(data_size, block_size);
+
+    size_t count = tree->block_count;
+    size_t offset = 0;
+    int level = 0;
+    for (;;) {
+        if (level >= PROOF_MAX_LEVELS) {
+            return -1;
+        }
+        tree->level_offset[level] = offset;
+        tree->level_count[level] = count;
+        offset += count;
+        level++;
+        if (count == 1) {
+            break;
+        }
+        count = (count + 1) / 2;
+    }
+
+    tree->levels = level;
+    tree->node_count = offset;
+    tree->nodes = malloc(offset * PROOF_HASH_SIZE);
+    return tree->nodes ? 0 : -1;
+}
+
+void proof_tree_free(proof_tree_t *tree) {
+    free(tree->nodes);
+    tree->nodes = NULL;
+}
+
+static uint8_t *node_at(const proof_tree_t *tree, int level, size_t pos) {
+    return tree->nodes + (tree->level_offset[level] + pos) * PROOF_HASH_SIZE;
+}
+
+void proof_tree_build_interior(proof_tree_t *tree) {
+    for (int level = 1; level < tree->levels; level++) {
+        size_t below = tree->level_count[level - 1];
+        for (size_t pos = 0; pos < tree->level_count[level]; pos++) {
+            size_t left = pos * 2;
+            if (left + 1 < below) {
+                proof_node_hash(node_at(tree, level - 1, left),
+                                node_at(tree, level - 1, left + 1),
+                                node_at(tree, level, pos));
+            } else {
+                memcpy(node_at(tree, level, pos), node_at(tree, level - 1, left), PROOF_HASH_SIZE);
+            }
+        }
+    }
+}
+
+int proof_tree_build(proof_tree_t *tree, const uint8_t *data, size_t data_size,
+                     size_t block_size) {
+    if (proof_tree_alloc(tree, data_size, block_size) != 0) {
+        proof_tree_free(tree);
+        return -1;
+    }
+
+    for (size_t i = 0; i < tree->block_count; i++) {
+        size_t len = proof_block_length(data_size, block_size, i);
+        proof_leaf_hash(i, data + i * block_size, len, node_at(tree, 0, i));
+    }
+
+    proof_tree_build_interior(tree);
+    return 0;
+}
+
+const uint8_t *proof_tree_root(const proof_tree_t *tree) {
+    return node_at(tree, tree->levels - 1, 0);
+}
+
+size_t proof_path_length(size_t block_count, size_t index) {
+    size_t count = block_count;
+    size_t pos = index;
+    size_t length = 0;
+
+    while (count > 1) {
+        if ((pos ^ 1) < count) {
+            length++;
+        }
+        pos >>= 1;
+        count = (count + 1) / 2;
+    }
+    return length;
+}
+
+size_t proof_tree_path(const proof_tree_t *tree, size_t index, uint8_t *out) {
+    size_t pos = index;
+    size_t written = 0;
+
+    for (int level = 0; level < tree->levels - 1; level++) {
+        size_t sibling = pos ^ 1;
+        if (sibling < tree->level_count[level]) {
+            memcpy(out + written * PROOF_HASH_SIZE, node_at(tree, level, sibling), PROOF_HASH_SIZE);
+            written++;
+        }
+        pos >>= 1;
+    }
+    return written;
+}
+
+int proof_verify_block(const uint8_t *root, size_t data_size, size_t block_size,
+                       size_t index, const uint8_t *block, size_t block_len,
+                       const uint8_t *path, size_t path_len) {
+    size_t count = proof_block_count(data_size, block_size);
+    uint8_t hash[PROOF_HASH_SIZE];
+    size_t pos = index;
+    size_t used = 0;
+
+    if (index >= count || block_len != proof_block_length(data_size, block_size, index) ||
+        path_len != proof_path_length(count, index)) {
+        return 0;
+    }
+
+    proof_leaf_hash(index, block, block_len, hash);
+
+    while (count > 1) {
+        size_t sibling = pos ^ 1;
+        if (sibling < count) {
+            const uint8_t *other = path + used * PROOF_HASH_SIZE;
+            if (pos & 1) {
+                proof_node_hash(other, hash, hash);
+            } else {
+                proof_node_hash(hash, other, hash);
+            }
+            used++;
+        }
+        pos >>= 1;
+        count = (count + 1) / 2;
+    }
+
+    return memcmp(hash, root, PROOF_HASH_SIZE) == 0;
+}
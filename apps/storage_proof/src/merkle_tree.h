@@ -0,0 +1,56 @@
+#ifndef MERKLE_TREE_H
+#define MERKLE_TREE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Constants
+#define PROOF_HASH_SIZE 32
+#define PROOF_MAX_LEVELS 64
+#define DEFAULT_PROOF_BLOCK_SIZE 4096
+
+// Domain separation prefixes for leaf and interior hashes
+#define PROOF_LEAF_PREFIX 0x00
+#define PROOF_NODE_PREFIX 0x01
+
+// Binary Merkle tree over fixed-size blocks. A node without a right
+// sibling is promoted unchanged, so the shape follows from block_count.
+typedef struct {
+    size_t data_size;
+    size_t block_size;
+    size_t block_count;
+    int levels;
+    size_t level_offset[PROOF_MAX_LEVELS];
+    size_t level_count[PROOF_MAX_LEVELS];
+    uint8_t *nodes;  // All levels back to back, leaves first
+    size_t node_count;
+} proof_tree_t;
+
+// Layout helpers shared by the prover and the verifier
+size_t proof_block_count(size_t data_size, size_t block_size);
+size_t proof_block_length(size_t data_size, size_t block_size, size_t index);
+
+void proof_leaf_hash(uint64_t index, const uint8_t *block, size_t len, uint8_t *out);
+void proof_node_hash(const uint8_t *left, const uint8_t *right, uint8_t *out);
+
+// Allocate the node array for a data size; leaves are left unset
+int proof_tree_alloc(proof_tree_t *tree, size_t data_size, size_t block_size);
+void proof_tree_free(proof_tree_t *tree);
+
+// Hash every block of data and build the interior levels
+int proof_tree_build(proof_tree_t *tree, const uint8_t *data, size_t data_size,
+                     size_t block_size);
+void proof_tree_build_interior(proof_tree_t *tree);
+
+const uint8_t *proof_tree_root(const proof_tree_t *tree);
+
+// Sibling hashes from leaf to root; returns the number written
+size_t proof_tree_path(const proof_tree_t *tree, size_t index, uint8_t *out);
+size_t proof_path_length(size_t block_count, size_t index);
+
+// Recompute the root from one block and its path and compare
+int proof_verify_block(const uint8_t *root, size_t data_size, size_t block_size,
+                       size_t index, const uint8_t *block, size_t block_len,
+                       const uint8_t *path, size_t path_len);
+
+#endif // MERKLE_TREE_H
@@ -0,0 +1,493 @@
+/*
+ * Native proof-of-storage extension for Lucid RDP
+ * Merkle trees over fixed-size blocks with random block challenges, so a
+ * verifier checks possession without reading the whole chunk back
+ */
+
+#include <Python.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <openssl/sha.h>
+#include "storage_proof.h"
+#include "merkle_tree.h"
+
+typedef struct {
+    PyObject_HEAD
+    proof_tree_t tree;
+    int tree_built;
+} StorageTreeObject;
+
+static PyTypeObject StorageTreeType;
+
+// Forward declarations
+static PyObject* StorageTree_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
+static void StorageTree_dealloc(StorageTreeObject *self);
+static int StorageTree_init(StorageTreeObject *self, PyObject *args, PyObject *kwds);
+static PyObject* StorageTree_prove(StorageTreeObject *self, PyObject *args);
+static PyObject* StorageTree_to_bytes(StorageTreeObject *self, PyObject *args);
+
+// Method definitions
+static PyMethodDef StorageTree_methods[] = {
+    {"prove", (PyCFunction)StorageTree_prove, METH_VARARGS, "Answer a challenge with blocks and Merkle paths"},
+    {"to_bytes", (PyCFunction)StorageTree_to_bytes, METH_NOARGS, "Serialize the tree for the storage holder"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyObject* StorageTree_get_root(StorageTreeObject *self, void *closure) {
+    return PyBytes_FromStringAndSize((const char*)proof_tree_root(&self->tree), PROOF_HASH_SIZE);
+}
+
+static PyObject* StorageTree_get_block_count(StorageTreeObject *self, void *closure) {
+    return PyLong_FromSize_t(self->tree.block_count);
+}
+
+static PyObject* StorageTree_get_block_size(StorageTreeObject *self, void *closure) {
+    return PyLong_FromSize_t(self->tree.block_size);
+}
+
+static PyObject* StorageTree_get_size(StorageTreeObject *self, void *closure) {
+    return PyLong_FromSize_t(self->tree.data_size);
+}
+
+static PyGetSetDef StorageTree_getset[] = {
+    {"root", (getter)StorageTree_get_root, NULL, "Merkle root", NULL},
+    {"block_count", (getter)StorageTree_get_block_count, NULL, "Number of blocks", NULL},
+    {"block_size", (getter)StorageTree_get_block_size, NULL, "Block size in bytes", NULL},
+    {"size", (getter)StorageTree_get_size, NULL, "Size of the covered data", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+// Type definition
+static PyTypeObject StorageTreeType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "storage_proof_native.StorageTree",
+    .tp_doc = "Merkle tree over fixed-size blocks of a stored chunk",
+    .tp_basicsize = sizeof(StorageTreeObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = StorageTree_new,
+    .tp_init = (initproc)StorageTree_init,
+    .tp_dealloc = (destructor)StorageTree_dealloc,
+    .tp_methods = StorageTree_methods,
+    .tp_getset = StorageTree_getset,
+};
+
+static void write_u32(uint8_t *out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static void write_u64(uint8_t *out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static uint32_t read_u32(const uint8_t *in) {
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+static uint64_t read_u64(const uint8_t *in) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; i--) {
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+// Convert a sequence of block indices, checking them against block_count
+static size_t *parse_indices(PyObject *indices, size_t block_count, Py_ssize_t *count) {
+    PyObject *seq = PySequence_Fast(indices, "Indices must be a sequence");
+    if (seq == NULL) {
+        return NULL;
+    }
+
+    *count = PySequence_Fast_GET_SIZE(seq);
+    if (*count > MAX_CHALLENGE_BLOCKS) {
+        Py_DECREF(seq);
+        PyErr_SetString(PyExc_ValueError, "Too many challenged blocks");
+        return NULL;
+    }
+
+    size_t *out = malloc(sizeof(size_t) * (*count ? *count : 1));
+    if (out == NULL) {
+        Py_DECREF(seq);
+        PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory");
+        return NULL;
+    }
+
+    for (Py_ssize_t i = 0; i < *count; i++) {
+        size_t index = PyLong_AsSize_t(PySequence_Fast_GET_ITEM(seq, i));
+        if (index == (size_t)-1 && PyErr_Occurred()) {
+            free(out);
+            Py_DECREF(seq);
+            return NULL;
+        }
+        if (index >= block_count) {
+            free(out);
+            Py_DECREF(seq);
+            PyErr_SetString(PyExc_IndexError, "Block index out of range");
+            return NULL;
+        }
+        out[i] = index;
+    }
+
+    Py_DECREF(seq);
+    return out;
+}
+
+// Module methods
+static PyObject* storage_proof_version(PyObject *self, PyObject *args) {
+    return PyUnicode_FromString("0.1.0");
+}
+
+static PyObject* storage_proof_challenge_indices(PyObject *self, PyObject *args) {
+    Py_buffer seed;
+    Py_ssize_t block_count, count;
+
+    if (!PyArg_ParseTuple(args, "y*nn", &seed, &block_count, &count)) {
+        return NULL;
+    }
+
+    if (block_count <= 0 || count < 0 || count > MAX_CHALLENGE_BLOCKS) {
+        PyBuffer_Release(&seed);
+        PyErr_SetString(PyExc_ValueError, "Invalid challenge parameters");
+        return NULL;
+    }
+
+    PyObject *ret = PyList_New(count);
+    if (ret == NULL) {
+        PyBuffer_Release(&seed);
+        return NULL;
+    }
+
+    // index_i = SHA-256(seed || i) mod block_count, reproducible by both sides
+    for (Py_ssize_t i = 0; i < count; i++) {
+        SHA256_CTX ctx;
+        uint8_t counter[4];
+        uint8_t digest[SHA256_DIGEST_LENGTH];
+
+        write_u32(counter, (uint32_t)i);
+        SHA256_Init(&ctx);
+        SHA256_Update(&ctx, seed.buf, seed.len);
+        SHA256_Update(&ctx, counter, sizeof(counter));
+        SHA256_Final(digest, &ctx);
+
+        uint64_t value = read_u64(digest) % (uint64_t)block_count;
+        PyObject *index = PyLong_FromUnsignedLongLong(value);
+        if (index == NULL) {
+            Py_DECREF(ret);
+            PyBuffer_Release(&seed);
+            return NULL;
+        }
+        PyList_SET_ITEM(ret, i, index);
+    }
+
+    PyBuffer_Release(&seed);
+    return ret;
+}
+
+static PyObject* storage_proof_verify_proof(PyObject *self, PyObject *args) {
+    Py_buffer root, proof;
+    Py_ssize_t data_size, block_size;
+    PyObject *indices_arg;
+
+    if (!PyArg_ParseTuple(args, "y*nnOy*", &root, &data_size, &block_size, &indices_arg, &proof)) {
+        return NULL;
+    }
+
+    if (root.len != PROOF_HASH_SIZE || data_size < 0 || block_size <= 0) {
+        PyBuffer_Release(&root);
+        PyBuffer_Release(&proof);
+        PyErr_SetString(PyExc_ValueError, "Invalid proof parameters");
+        return NULL;
+    }
+
+    size_t block_count = proof_block_count((size_t)data_size, (size_t)block_size);
+    Py_ssize_t count;
+    size_t *indices = parse_indices(indices_arg, block_count, &count);
+    if (indices == NULL) {
+        PyBuffer_Release(&root);
+        PyBuffer_Release(&proof);
+        return NULL;
+    }
+
+    int valid = 1;
+    Py_BEGIN_ALLOW_THREADS
+    const uint8_t *cursor = (const uint8_t*)proof.buf;
+    const uint8_t *end = cursor + proof.len;
+
+    for (Py_ssize_t i = 0; i < count && valid; i++) {
+        if (end - cursor < PROOF_ENTRY_HEADER) {
+            valid = 0;
+            break;
+        }
+
+        size_t index = read_u32(cursor);
+        size_t block_len = read_u32(cursor + 4);
+        size_t path_len = proof_path_length(block_count, indices[i]);
+        cursor += PROOF_ENTRY_HEADER;
+
+        if (index != indices[i] || block_len > (size_t)block_size ||
+            (size_t)(end - cursor) < block_len + path_len * PROOF_HASH_SIZE) {
+            valid = 0;
+            break;
+        }
+
+        valid = proof_verify_block((const uint8_t*)root.buf, (size_t)data_size, (size_t)block_size,
+                                   index, cursor, block_len,
+                                   cursor + block_len, path_len);
+        cursor += block_len + path_len * PROOF_HASH_SIZE;
+    }
+
+    if (cursor != end) {
+        valid = 0;
+    }
+    Py_END_ALLOW_THREADS
+
+    free(indices);
+    PyBuffer_Release(&root);
+    PyBuffer_Release(&proof);
+    return PyBool_FromLong(valid);
+}
+
+static PyObject* storage_proof_load_tree(PyObject *self, PyObject *args) {
+    Py_buffer blob;
+
+    if (!PyArg_ParseTuple(args, "y*", &blob)) {
+        return NULL;
+    }
+
+    const uint8_t *buf = (const uint8_t*)blob.buf;
+    if (blob.len < TREE_HEADER_SIZE || memcmp(buf, TREE_MAGIC, 4) != 0) {
+        PyBuffer_Release(&blob);
+        PyErr_SetString(PyExc_ValueError, "Invalid storage tree");
+        return NULL;
+    }
+
+    StorageTreeObject *tree = (StorageTreeObject*)StorageTreeType.tp_alloc(&StorageTreeType, 0);
+    if (tree == NULL) {
+        PyBuffer_Release(&blob);
+        return NULL;
+    }
+    memset(&tree->tree, 0, sizeof(tree->tree));
+
+    size_t block_size = read_u32(buf + 4);
+    size_t data_size = (size_t)read_u64(buf + 8);
+    size_t stored_nodes = (blob.len - TREE_HEADER_SIZE) / PROOF_HASH_SIZE;
+    if (block_size == 0 || proof_block_count(data_size, block_size) > stored_nodes ||
+        proof_tree_alloc(&tree->tree, data_size, block_size) != 0) {
+        proof_tree_free(&tree->tree);
+        Py_DECREF(tree);
+        PyBuffer_Release(&blob);
+        PyErr_SetString(PyExc_ValueError, "Invalid storage tree");
+        return NULL;
+    }
+    tree->tree_built = 1;
+
+    if ((size_t)blob.len != TREE_HEADER_SIZE + tree->tree.node_count * PROOF_HASH_SIZE) {
+        Py_DECREF(tree);
+        PyBuffer_Release(&blob);
+        PyErr_SetString(PyExc_ValueError, "Storage tree size mismatch");
+        return NULL;
+    }
+
+    memcpy(tree->tree.nodes, buf + TREE_HEADER_SIZE, tree->tree.node_count * PROOF_HASH_SIZE);
+    PyBuffer_Release(&blob);
+    return (PyObject*)tree;
+}
+
+static PyMethodDef storage_proof_module_methods[] = {
+    {"version", storage_proof_version, METH_NOARGS, "Get version"},
+    {"challenge_indices", storage_proof_challenge_indices, METH_VARARGS, "Derive challenged block indices from a seed"},
+    {"verify_proof", storage_proof_verify_proof, METH_VARARGS, "Verify a challenge response against a root"},
+    {"load_tree", storage_proof_load_tree, METH_VARARGS, "Load a serialized storage tree"},
+    {NULL, NULL, 0, NULL}
+};
+
+// StorageTree object methods
+static PyObject* StorageTree_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
+    StorageTreeObject *self = (StorageTreeObject*)type->tp_alloc(type, 0);
+    if (self != NULL) {
+        memset(&self->tree, 0, sizeof(self->tree));
+        self->tree_built = 0;
+    }
+    return (PyObject*)self;
+}
+
+static int StorageTree_init(StorageTreeObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"data", "block_size", NULL};
+    Py_buffer data;
+    Py_ssize_t block_size = DEFAULT_PROOF_BLOCK_SIZE;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|n", kwlist, &data, &block_size)) {
+        return -1;
+    }
+
+    if (block_size <= 0 || block_size > MAX_PROOF_BLOCK_SIZE) {
+        PyBuffer_Release(&data);
+        PyErr_SetString(PyExc_ValueError, "Invalid block size");
+        return -1;
+    }
+
+    if (self->tree_built) {
+        proof_tree_free(&self->tree);
+        self->tree_built = 0;
+    }
+
+    int result;
+    Py_BEGIN_ALLOW_THREADS
+    result = proof_tree_build(&self->tree, (const uint8_t*)data.buf, (size_t)data.len,
+                              (size_t)block_size);
+    Py_END_ALLOW_THREADS
+
+    PyBuffer_Release(&data);
+
+    if (result != 0) {
+        PyErr_SetString(PyExc_MemoryError, "Failed to build storage tree");
+        return -1;
+    }
+
+    self->tree_built = 1;
+    return 0;
+}
+
+static void StorageTree_dealloc(StorageTreeObject *self) {
+    if (self->tree_built) {
+        proof_tree_free(&self->tree);
+    }
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static PyObject* StorageTree_prove(StorageTreeObject *self, PyObject *args) {
+    PyObject *indices_arg, *blocks_arg;
+
+    if (!PyArg_ParseTuple(args, "OO", &indices_arg, &blocks_arg)) {
+        return NULL;
+    }
+
+    if (!self->tree_built) {
+        PyErr_SetString(PyExc_RuntimeError, "Storage tree not built");
+        return NULL;
+    }
+
+    Py_ssize_t count;
+    size_t *indices = parse_indices(indices_arg, self->tree.block_count, &count);
+    if (indices == NULL) {
+        return NULL;
+    }
+
+    PyObject *blocks = PySequence_Fast(blocks_arg, "Blocks must be a sequence");
+    if (blocks == NULL) {
+        free(indices);
+        return NULL;
+    }
+    if (PySequence_Fast_GET_SIZE(blocks) != count) {
+        Py_DECREF(blocks);
+        free(indices);
+        PyErr_SetString(PyExc_ValueError, "One block is needed per challenged index");
+        return NULL;
+    }
+
+    // Size the response up front so it is written in one pass
+    size_t total = 0;
+    for (Py_ssize_t i = 0; i < count; i++) {
+        total += PROOF_ENTRY_HEADER +
+                 proof_block_length(self->tree.data_size, self->tree.block_size, indices[i]) +
+                 proof_path_length(self->tree.block_count, indices[i]) * PROOF_HASH_SIZE;
+    }
+
+    PyObject *ret = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)total);
+    if (ret == NULL) {
+        Py_DECREF(blocks);
+        free(indices);
+        return NULL;
+    }
+
+    uint8_t *cursor = (uint8_t*)PyBytes_AS_STRING(ret);
+    for (Py_ssize_t i = 0; i < count; i++) {
+        Py_buffer block;
+        size_t expected = proof_block_length(self->tree.data_size, self->tree.block_size, indices[i]);
+
+        if (PyObject_GetBuffer(PySequence_Fast_GET_ITEM(blocks, i), &block, PyBUF_SIMPLE) < 0) {
+            goto fail;
+        }
+        if ((size_t)block.len != expected) {
+            PyBuffer_Release(&block);
+            PyErr_SetString(PyExc_ValueError, "Block length does not match the tree");
+            goto fail;
+        }
+
+        write_u32(cursor, (uint32_t)indices[i]);
+        write_u32(cursor + 4, (uint32_t)expected);
+        cursor += PROOF_ENTRY_HEADER;
+        memcpy(cursor, block.buf, expected);
+        cursor += expected;
+        cursor += proof_tree_path(&self->tree, indices[i], cursor) * PROOF_HASH_SIZE;
+        PyBuffer_Release(&block);
+    }
+
+    Py_DECREF(blocks);
+    free(indices);
+    return ret;
+
+fail:
+    Py_DECREF(ret);
+    Py_DECREF(blocks);
+    free(indices);
+    return NULL;
+}
+
+static PyObject* StorageTree_to_bytes(StorageTreeObject *self, PyObject *args) {
+    if (!self->tree_built) {
+        PyErr_SetString(PyExc_RuntimeError, "Storage tree not built");
+        return NULL;
+    }
+
+    size_t nodes_size = self->tree.node_count * PROOF_HASH_SIZE;
+    PyObject *ret = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)(TREE_HEADER_SIZE + nodes_size));
+    if (ret == NULL) {
+        return NULL;
+    }
+
+    uint8_t *buf = (uint8_t*)PyBytes_AS_STRING(ret);
+    memcpy(buf, TREE_MAGIC, 4);
+    write_u32(buf + 4, (uint32_t)self->tree.block_size);
+    write_u64(buf + 8, (uint64_t)self->tree.data_size);
+    memcpy(buf + TREE_HEADER_SIZE, self->tree.nodes, nodes_size);
+    return ret;
+}
+
+// Module definition
+static struct PyModuleDef storage_proof_module = {
+    PyModuleDef_HEAD_INIT,
+    "storage_proof_native",
+    "Native proof-of-storage extension for Lucid RDP",
+    -1,
+    storage_proof_module_methods
+};
+
+PyMODINIT_FUNC PyInit_storage_proof_native(void) {
+    if (PyType_Ready(&StorageTreeType) < 0) {
+        return NULL;
+    }
+
+    PyObject *m = PyModule_Create(&storage_proof_module);
+    if (m == NULL) {
+        return NULL;
+    }
+
+    Py_INCREF(&StorageTreeType);
+    if (PyModule_AddObject(m, "StorageTree", (PyObject*)&StorageTreeType) < 0) {
+        Py_DECREF(&StorageTreeType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    PyModule_AddIntConstant(m, "HASH_SIZE", PROOF_HASH_SIZE);
+    PyModule_AddIntConstant(m, "DEFAULT_BLOCK_SIZE", DEFAULT_PROOF_BLOCK_SIZE);
+
+    return m;
+}
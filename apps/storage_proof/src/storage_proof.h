@@ -0,0 +1,15 @@
+#ifndef STORAGE_PROOF_H
+#define STORAGE_PROOF_H
+
+#include <Python.h>
+
+// Constants
+#define MAX_PROOF_BLOCK_SIZE (1024 * 1024)  // 1MB max block size
+#define MAX_CHALLENGE_BLOCKS 4096
+#define PROOF_ENTRY_HEADER 8  // u32 index + u32 block length
+
+// Serialized tree: magic, u32 block size, u64 data size, then node hashes
+#define TREE_MAGIC "LSPT"
+#define TREE_HEADER_SIZE 16
+
+#endif // STORAGE_PROOF_H
@@ -0,0 +1,13 @@
+# Telemetry Codec Module
+# Columnar encoding for recorder telemetry streams
+
+"""
+File: /app/apps/telemetry_codec/__init__.py
+x-lucid-file-path: /app/apps/telemetry_codec/__init__.py
+x-lucid-file-type: python
+
+Telemetry Codec package for Lucid RDP.
+Contains the native columnar block codec used by the session recorder monitors.
+"""
+
+__all__ = []
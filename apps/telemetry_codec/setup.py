@@ -0,0 +1,51 @@
+#!/usr/bin/env python3
+"""
+File: /app/apps/telemetry_codec/setup.py
+x-lucid-file-path: /app/apps/telemetry_codec/setup.py
+x-lucid-file-type: python
+
+Setup script for native RDP codec extension
+"""
+
+from setuptools import setup, Extension
+
+# Define the extension module
+telemetry_codec_native = Extension(
+    'telemetry_codec_native',
+    sources=[
+        'src/telemetry_codec.c',
+        'src/columnar.c'
+    ],
+    include_dirs=[
+        'src/'
+    ],
+    libraries=['z'],
+    library_dirs=[],
+    extra_compile_args=[
+        '-O3',
+        '-Wall',
+        '-Wextra',
+        '-std=c99',
+        '-fPIC'
+    ],
+    extra_link_args=['-shared']
+)
+
+setup(
+    name='telemetry-codec-native',
+    version='0.1.0',
+    description='Native telemetry codec extension for Lucid RDP',
+    ext_modules=[telemetry_codec_native],
+    python_requires='>=3.8',
+    classifiers=[
+        'Development Status :: 3 - Alpha',
+        'Intended Audience :: Developers',
+        'License :: OSI Approved :: MIT License',
+        'Programming Language :: C',
+        'Programming Language :: Python :: 3',
+        'Programming Language :: Python :: 3.8',
+        'Programming Language :: Python :: 3.9',
+        'Programming Language :: Python :: 3.10',
+        'Programming Language :: Python :: 3.11',
+    ],
+)
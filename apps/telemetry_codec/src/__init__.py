@@ -0,0 +1,13 @@
+# Telemetry Codec Source Module
+# Telemetry codec native source code components
+
+"""
+File: /app/apps/telemetry_codec/src/__init__.py
+x-lucid-file-path: /app/apps/telemetry_codec/src/__init__.py
+x-lucid-file-type: python
+
+Telemetry Codec Source package for Lucid RDP.
+Contains telemetry codec native source code and C implementations.
+"""
+
+__all__ = []
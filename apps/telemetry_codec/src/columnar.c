@@ -0,0 +1,451 @@
+#include "columnar.h"
+#include <stdlib.h>
+#include <string.h>
+
+// LSB-first bit writer over a tc_buf_t
+typedef struct {
+    tc_buf_t *buf;
+    uint64_t acc;
+    unsigned count;
+} bit_writer_t;
+
+// LSB-first bit reader; overrun latches error
+typedef struct {
+    const uint8_t *in;
+    size_t len;
+    size_t pos;
+    uint64_t acc;
+    unsigned count;
+    int error;
+} bit_reader_t;
+
+static uint64_t zigzag(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static int64_t unzigzag(uint64_t v) {
+    return (int64_t)((v >> 1) ^ (~(v & 1) + 1));
+}
+
+void tc_buf_free(tc_buf_t *buf) {
+    free(buf->data);
+    buf->data = NULL;
+    buf->len = 0;
+    buf->cap = 0;
+}
+
+int tc_buf_reserve(tc_buf_t *buf, size_t extra) {
+    if (buf->cap - buf->len >= extra) {
+        return 0;
+    }
+    size_t cap = buf->cap ? buf->cap : 256;
+    while (cap - buf->len < extra) {
+        cap *= 2;
+    }
+    uint8_t *data = realloc(buf->data, cap);
+    if (data == NULL) {
+        return -1;
+    }
+    buf->data = data;
+    buf->cap = cap;
+    return 0;
+}
+
+int tc_buf_put(tc_buf_t *buf, const void *data, size_t len) {
+    if (tc_buf_reserve(buf, len) < 0) {
+        return -1;
+    }
+    memcpy(buf->data + buf->len, data, len);
+    buf->len += len;
+    return 0;
+}
+
+int tc_buf_put_varint(tc_buf_t *buf, uint64_t value) {
+    if (tc_buf_reserve(buf, 10) < 0) {
+        return -1;
+    }
+    while (value >= 0x80) {
+        buf->data[buf->len++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    buf->data[buf->len++] = (uint8_t)value;
+    return 0;
+}
+
+int tc_read_varint(const uint8_t *in, size_t len, uint64_t *value, size_t *used) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < len && i < 10; i++) {
+        v |= (uint64_t)(in[i] & 0x7f) << (7 * i);
+        if ((in[i] & 0x80) == 0) {
+            *value = v;
+            *used = i + 1;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+void tc_put_le32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static uint32_t get_le32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+void tc_block_header_write(uint8_t *out, const tc_block_header_t *header) {
+    tc_put_le32(out, TC_MAGIC);
+    out[4] = TC_VERSION;
+    out[5] = header->kind;
+    out[6] = (uint8_t)header->ncols;
+    out[7] = (uint8_t)(header->ncols >> 8);
+    tc_put_le32(out + 8, header->nrows);
+    tc_put_le32(out + 12, header->body_len);
+    tc_put_le32(out + 16, header->crc);
+}
+
+int tc_block_header_read(const uint8_t *in, tc_block_header_t *header) {
+    if (get_le32(in) != TC_MAGIC || in[4] != TC_VERSION) {
+        return -1;
+    }
+    header->kind = in[5];
+    header->ncols = (uint16_t)(in[6] | (in[7] << 8));
+    header->nrows = get_le32(in + 8);
+    header->body_len = get_le32(in + 12);
+    header->crc = get_le32(in + 16);
+    return 0;
+}
+
+unsigned tc_bit_width(uint64_t max) {
+    return max == 0 ? 0 : 64 - (unsigned)__builtin_clzll(max);
+}
+
+static int bits_put(bit_writer_t *w, uint64_t value, unsigned nbits) {
+    if (nbits > 32) {
+        if (bits_put(w, value & 0xffffffffu, 32) < 0) {
+            return -1;
+        }
+        value >>= 32;
+        nbits -= 32;
+    }
+    if (nbits < 64) {
+        value &= ((uint64_t)1 << nbits) - 1;
+    }
+    w->acc |= value << w->count;
+    w->count += nbits;
+    while (w->count >= 8) {
+        uint8_t byte = (uint8_t)w->acc;
+        if (tc_buf_put(w->buf, &byte, 1) < 0) {
+            return -1;
+        }
+        w->acc >>= 8;
+        w->count -= 8;
+    }
+    return 0;
+}
+
+static int bits_flush(bit_writer_t *w) {
+    if (w->count > 0) {
+        uint8_t byte = (uint8_t)w->acc;
+        w->acc = 0;
+        w->count = 0;
+        return tc_buf_put(w->buf, &byte, 1);
+    }
+    return 0;
+}
+
+static uint64_t bits_get(bit_reader_t *r, unsigned nbits) {
+    if (nbits > 32) {
+        uint64_t low = bits_get(r, 32);
+        return low | (bits_get(r, nbits - 32) << 32);
+    }
+    while (r->count < nbits) {
+        if (r->pos >= r->len) {
+            r->error = 1;
+            return 0;
+        }
+        r->acc |= (uint64_t)r->in[r->pos++] << r->count;
+        r->count += 8;
+    }
+    uint64_t value = nbits == 0 ? 0 : r->acc & (((uint64_t)1 << nbits) - 1);
+    r->acc >>= nbits;
+    r->count -= nbits;
+    return value;
+}
+
+int tc_encode_timestamps(tc_buf_t *buf, const int64_t *values, size_t n) {
+    uint64_t prev = 0, prev_delta = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        uint64_t value = (uint64_t)values[i];
+        uint64_t delta = value - prev;
+        uint64_t out = i == 0 ? value : i == 1 ? delta : delta - prev_delta;
+        if (tc_buf_put_varint(buf, zigzag((int64_t)out)) < 0) {
+            return -1;
+        }
+        prev = value;
+        prev_delta = delta;
+    }
+    return 0;
+}
+
+int tc_decode_timestamps(const uint8_t *in, size_t len, int64_t *out, size_t n, size_t *used) {
+    uint64_t prev = 0, prev_delta = 0;
+    size_t pos = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        uint64_t raw;
+        size_t step;
+        if (tc_read_varint(in + pos, len - pos, &raw, &step) < 0) {
+            return -1;
+        }
+        pos += step;
+
+        uint64_t v = (uint64_t)unzigzag(raw);
+        uint64_t delta = i == 0 ? v : i == 1 ? v : prev_delta + v;
+        uint64_t value = i == 0 ? v : prev + delta;
+        out[i] = (int64_t)value;
+        prev = value;
+        prev_delta = delta;
+    }
+    *used = pos;
+    return 0;
+}
+
+// Frame of reference: zigzag varint base, u8 width, bit-packed offsets
+static int put_frame(tc_buf_t *buf, const int64_t *values, size_t n, int64_t min, unsigned width) {
+    uint8_t width_byte = (uint8_t)width;
+
+    if (tc_buf_put_varint(buf, zigzag(min)) < 0 || tc_buf_put(buf, &width_byte, 1) < 0) {
+        return -1;
+    }
+    bit_writer_t w = {buf, 0, 0};
+    for (size_t i = 0; i < n; i++) {
+        if (bits_put(&w, (uint64_t)values[i] - (uint64_t)min, width) < 0) {
+            return -1;
+        }
+    }
+    return bits_flush(&w);
+}
+
+static size_t read_frame(const uint8_t *in, size_t len, int64_t *out, size_t n) {
+    uint64_t raw;
+    size_t pos;
+
+    if (tc_read_varint(in, len, &raw, &pos) < 0 || pos >= len || in[pos] > 64) {
+        return 0;
+    }
+    uint64_t min = (uint64_t)unzigzag(raw);
+    unsigned width = in[pos++];
+
+    size_t packed = (n * width + 7) / 8;
+    if (len - pos < packed) {
+        return 0;
+    }
+    bit_reader_t r = {in + pos, packed, 0, 0, 0, 0};
+    for (size_t i = 0; i < n; i++) {
+        out[i] = (int64_t)(min + bits_get(&r, width));
+    }
+    return r.error ? 0 : pos + packed;
+}
+
+int tc_encode_ints(tc_buf_t *buf, const int64_t *values, size_t n) {
+    if (n == 0) {
+        return 0;
+    }
+    int64_t min = values[0], max = values[0];
+    int64_t dmin = 0, dmax = 0;
+    for (size_t i = 1; i < n; i++) {
+        int64_t delta = (int64_t)((uint64_t)values[i] - (uint64_t)values[i - 1]);
+        if (values[i] < min) {
+            min = values[i];
+        }
+        if (values[i] > max) {
+            max = values[i];
+        }
+        if (i == 1 || delta < dmin) {
+            dmin = delta;
+        }
+        if (i == 1 || delta > dmax) {
+            dmax = delta;
+        }
+    }
+    unsigned width = tc_bit_width((uint64_t)max - (uint64_t)min);
+    unsigned dwidth = tc_bit_width((uint64_t)dmax - (uint64_t)dmin);
+
+    // Counters and slow-moving series pack tighter as deltas
+    uint8_t mode = n > 1 && (n - 1) * dwidth + 80 < n * width ? TC_INT_DELTA : TC_INT_FRAME;
+    if (tc_buf_put(buf, &mode, 1) < 0) {
+        return -1;
+    }
+    if (mode == TC_INT_FRAME) {
+        return put_frame(buf, values, n, min, width);
+    }
+
+    int64_t *deltas = malloc((n - 1) * sizeof(int64_t));
+    if (deltas == NULL) {
+        return -1;
+    }
+    for (size_t i = 1; i < n; i++) {
+        deltas[i - 1] = (int64_t)((uint64_t)values[i] - (uint64_t)values[i - 1]);
+    }
+    int rc = tc_buf_put_varint(buf, zigzag(values[0]));
+    if (rc == 0) {
+        rc = put_frame(buf, deltas, n - 1, dmin, dwidth);
+    }
+    free(deltas);
+    return rc;
+}
+
+int tc_decode_ints(const uint8_t *in, size_t len, int64_t *out, size_t n, size_t *used) {
+    if (n == 0) {
+        *used = 0;
+        return 0;
+    }
+    if (len < 1 || in[0] > TC_INT_DELTA) {
+        return -1;
+    }
+    if (in[0] == TC_INT_FRAME) {
+        size_t step = read_frame(in + 1, len - 1, out, n);
+        *used = 1 + step;
+        return step ? 0 : -1;
+    }
+
+    uint64_t raw;
+    size_t pos;
+    if (tc_read_varint(in + 1, len - 1, &raw, &pos) < 0) {
+        return -1;
+    }
+    pos += 1;
+    out[0] = unzigzag(raw);
+    size_t step = read_frame(in + pos, len - pos, out + 1, n - 1);
+    if (step == 0) {
+        return -1;
+    }
+    for (size_t i = 1; i < n; i++) {
+        out[i] = (int64_t)((uint64_t)out[i - 1] + (uint64_t)out[i]);
+    }
+    *used = pos + step;
+    return 0;
+}
+
+int tc_encode_floats(tc_buf_t *buf, const double *values, size_t n) {
+    bit_writer_t w = {buf, 0, 0};
+    uint64_t prev = 0;
+    unsigned prev_lead = 65, prev_trail = 0;  // No window yet
+
+    for (size_t i = 0; i < n; i++) {
+        uint64_t bits;
+        memcpy(&bits, &values[i], sizeof(bits));
+        if (i == 0) {
+            if (bits_put(&w, bits, 64) < 0) {
+                return -1;
+            }
+            prev = bits;
+            continue;
+        }
+
+        uint64_t x = bits ^ prev;
+        prev = bits;
+        if (x == 0) {
+            if (bits_put(&w, 0, 1) < 0) {
+                return -1;
+            }
+            continue;
+        }
+
+        unsigned lead = (unsigned)__builtin_clzll(x);
+        unsigned trail = (unsigned)__builtin_ctzll(x);
+        if (prev_lead <= 64 && lead >= prev_lead && trail >= prev_trail) {
+            // Meaningful bits fit the previous window
+            unsigned size = 64 - prev_lead - prev_trail;
+            if (bits_put(&w, 1, 2) < 0 || bits_put(&w, x >> prev_trail, size) < 0) {
+                return -1;
+            }
+        } else {
+            unsigned size = 64 - lead - trail;
+            if (bits_put(&w, 3, 2) < 0 || bits_put(&w, lead, 6) < 0 ||
+                bits_put(&w, size - 1, 6) < 0 || bits_put(&w, x >> trail, size) < 0) {
+                return -1;
+            }
+            prev_lead = lead;
+            prev_trail = trail;
+        }
+    }
+    return bits_flush(&w);
+}
+
+int tc_decode_floats(const uint8_t *in, size_t len, double *out, size_t n, size_t *used) {
+    bit_reader_t r = {in, len, 0, 0, 0, 0};
+    uint64_t prev = 0;
+    unsigned lead = 0, trail = 0;
+    int have_window = 0;
+
+    for (size_t i = 0; i < n && !r.error; i++) {
+        if (i == 0) {
+            prev = bits_get(&r, 64);
+        } else if (bits_get(&r, 1)) {
+            if (bits_get(&r, 1)) {
+                lead = (unsigned)bits_get(&r, 6);
+                unsigned size = (unsigned)bits_get(&r, 6) + 1;
+                if (lead + size > 64) {
+                    return -1;
+                }
+                trail = 64 - lead - size;
+                have_window = 1;
+            } else if (!have_window) {
+                return -1;
+            }
+            prev ^= bits_get(&r, 64 - lead - trail) << trail;
+        }
+        memcpy(&out[i], &prev, sizeof(prev));
+    }
+    *used = r.pos;
+    return r.error ? -1 : 0;
+}
+
+int tc_encode_indices(tc_buf_t *buf, const uint32_t *indices, size_t n, uint32_t ndict) {
+    if (n == 0) {
+        return 0;
+    }
+    unsigned width = tc_bit_width(ndict - 1);
+    uint8_t width_byte = (uint8_t)width;
+
+    if (tc_buf_put(buf, &width_byte, 1) < 0) {
+        return -1;
+    }
+    bit_writer_t w = {buf, 0, 0};
+    for (size_t i = 0; i < n; i++) {
+        if (bits_put(&w, indices[i], width) < 0) {
+            return -1;
+        }
+    }
+    return bits_flush(&w);
+}
+
+int tc_decode_indices(const uint8_t *in, size_t len, uint32_t *out, size_t n, uint32_t ndict, size_t *used) {
+    if (n == 0) {
+        *used = 0;
+        return 0;
+    }
+    if (len < 1 || in[0] > 32) {
+        return -1;
+    }
+    unsigned width = in[0];
+    size_t packed = (n * width + 7) / 8;
+    if (len - 1 < packed) {
+        return -1;
+    }
+
+    bit_reader_t r = {in + 1, packed, 0, 0, 0, 0};
+    for (size_t i = 0; i < n; i++) {
+        out[i] = (uint32_t)bits_get(&r, width);
+        if (out[i] >= ndict) {
+            return -1;
+        }
+    }
+    *used = 1 + packed;
+    return r.error ? -1 : 0;
+}
@@ -0,0 +1,79 @@
+#ifndef COLUMNAR_H
+#define COLUMNAR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Constants
+#define TC_MAGIC 0x3142544cu  // "LTB1" on disk
+#define TC_VERSION 1
+#define TC_BLOCK_HEADER_SIZE 20
+#define TC_COLUMN_FIXED_SIZE 7  // name_len u8, type u8, flags u8, data_len u32
+#define TC_MAX_ROWS (1u << 24)
+#define TC_MAX_COLUMNS 255
+#define TC_MAX_NAME 255
+#define TC_UUID_SIZE 16
+
+#define TC_FLAG_NULLS 0x01  // Column data starts with a null bitmap
+
+// Integer column layouts, chosen per column by the encoder
+#define TC_INT_FRAME 0  // Frame of reference over the values
+#define TC_INT_DELTA 1  // First value, then frame of reference over deltas
+
+// Column types
+typedef enum {
+    TC_TIMESTAMP = 1,  // int64, delta-of-delta zigzag varints
+    TC_INT = 2,        // int64, bit-packed offsets from a frame of reference
+    TC_FLOAT = 3,      // double, Gorilla XOR stream
+    TC_STRING = 4,     // UTF-8, dictionary + bit-packed indices
+    TC_UUID = 5        // 16 raw bytes per value
+} tc_type_t;
+
+// Block header, little-endian:
+//   0 magic u32   4 version u8   5 kind u8   6 ncols u16
+//   8 nrows u32  12 body_len u32 16 crc32(body) u32
+// Each column in the body: name_len u8, name, type u8, flags u8,
+// data_len u32, then data_len bytes (null bitmap first when flagged).
+typedef struct {
+    uint8_t kind;
+    uint16_t ncols;
+    uint32_t nrows;
+    uint32_t body_len;
+    uint32_t crc;
+} tc_block_header_t;
+
+// Growable output buffer; functions return -1 only on allocation failure
+typedef struct {
+    uint8_t *data;
+    size_t len;
+    size_t cap;
+} tc_buf_t;
+
+void tc_buf_free(tc_buf_t *buf);
+int tc_buf_reserve(tc_buf_t *buf, size_t extra);
+int tc_buf_put(tc_buf_t *buf, const void *data, size_t len);
+int tc_buf_put_varint(tc_buf_t *buf, uint64_t value);
+void tc_put_le32(uint8_t *p, uint32_t v);
+
+void tc_block_header_write(uint8_t *out, const tc_block_header_t *header);
+// -1 on bad magic or version
+int tc_block_header_read(const uint8_t *in, tc_block_header_t *header);
+
+// Bits needed to hold values 0..max
+unsigned tc_bit_width(uint64_t max);
+
+int tc_encode_timestamps(tc_buf_t *buf, const int64_t *values, size_t n);
+int tc_encode_ints(tc_buf_t *buf, const int64_t *values, size_t n);
+int tc_encode_floats(tc_buf_t *buf, const double *values, size_t n);
+// Indices into a dictionary of ndict entries
+int tc_encode_indices(tc_buf_t *buf, const uint32_t *indices, size_t n, uint32_t ndict);
+
+// Decoders read exactly n values from in[0:len]; -1 on truncated or
+// malformed input. *used receives the bytes consumed.
+int tc_decode_timestamps(const uint8_t *in, size_t len, int64_t *out, size_t n, size_t *used);
+int tc_decode_ints(const uint8_t *in, size_t len, int64_t *out, size_t n, size_t *used);
+int tc_decode_floats(const uint8_t *in, size_t len, double *out, size_t n, size_t *used);
+int tc_decode_indices(const uint8_t *in, size_t len, uint32_t *out, size_t n, uint32_t ndict, size_t *used);
+int tc_read_varint(const uint8_t *in, size_t len, uint64_t *value, size_t *used);
+
+#endif // COLUMNAR_H
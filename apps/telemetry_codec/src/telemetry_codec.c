@@ -0,0 +1,577 @@
+/*
+ * Native telemetry codec extension for Lucid RDP
+ * Columnar, self-describing blocks for recorder telemetry: delta-of-delta
+ * timestamps, bit-packed integers, dictionary-encoded strings and Gorilla
+ * XOR-compressed floats, in place of per-event JSON
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <stdint.h>
+#include <string.h>
+#include <zlib.h>
+#include "telemetry_codec.h"
+#include "columnar.h"
+
+// Null bitmap bytes for n rows
+#define BITMAP_SIZE(n) (((size_t)(n) + 7) / 8)
+
+static int is_null(const uint8_t *bitmap, size_t i) {
+    return bitmap != NULL && (bitmap[i / 8] >> (i % 8)) & 1;
+}
+
+static int encode_numbers(tc_buf_t *body, PyObject **items, Py_ssize_t n, const uint8_t *bitmap,
+                          size_t count, int type) {
+    void *values = PyMem_Malloc((count > 0 ? count : 1) * 8);
+    size_t k = 0;
+    int rc;
+
+    if (values == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    for (Py_ssize_t i = 0; i < n; i++) {
+        if (is_null(bitmap, (size_t)i)) {
+            continue;
+        }
+        if (type == TC_FLOAT) {
+            double v = PyFloat_AsDouble(items[i]);
+            if (v == -1.0 && PyErr_Occurred()) {
+                PyMem_Free(values);
+                return -1;
+            }
+            ((double*)values)[k++] = v;
+        } else {
+            long long v = PyLong_AsLongLong(items[i]);
+            if (v == -1 && PyErr_Occurred()) {
+                PyMem_Free(values);
+                return -1;
+            }
+            ((int64_t*)values)[k++] = (int64_t)v;
+        }
+    }
+
+    if (type == TC_TIMESTAMP) {
+        rc = tc_encode_timestamps(body, values, count);
+    } else if (type == TC_INT) {
+        rc = tc_encode_ints(body, values, count);
+    } else {
+        rc = tc_encode_floats(body, values, count);
+    }
+    PyMem_Free(values);
+    if (rc < 0) {
+        PyErr_NoMemory();
+    }
+    return rc;
+}
+
+static int encode_strings(tc_buf_t *body, PyObject **items, Py_ssize_t n, const uint8_t *bitmap,
+                          size_t count) {
+    PyObject *index = PyDict_New();
+    PyObject *entries = PyList_New(0);
+    uint32_t *indices = PyMem_Malloc((count > 0 ? count : 1) * sizeof(uint32_t));
+    size_t k = 0;
+    int rc = -1;
+
+    if (index == NULL || entries == NULL || indices == NULL) {
+        if (indices == NULL) {
+            PyErr_NoMemory();
+        }
+        goto done;
+    }
+
+    // Dictionary in first-seen order
+    for (Py_ssize_t i = 0; i < n; i++) {
+        if (is_null(bitmap, (size_t)i)) {
+            continue;
+        }
+        if (!PyUnicode_Check(items[i])) {
+            PyErr_SetString(PyExc_TypeError, "string column values must be str or None");
+            goto done;
+        }
+        PyObject *slot = PyDict_GetItemWithError(index, items[i]);
+        if (slot == NULL) {
+            if (PyErr_Occurred()) {
+                goto done;
+            }
+            slot = PyLong_FromSsize_t(PyList_GET_SIZE(entries));
+            if (slot == NULL || PyDict_SetItem(index, items[i], slot) < 0 ||
+                PyList_Append(entries, items[i]) < 0) {
+                Py_XDECREF(slot);
+                goto done;
+            }
+            Py_DECREF(slot);
+        }
+        indices[k++] = (uint32_t)PyLong_AsSsize_t(slot);
+    }
+
+    Py_ssize_t ndict = PyList_GET_SIZE(entries);
+    if (tc_buf_put_varint(body, (uint64_t)ndict) < 0) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (Py_ssize_t i = 0; i < ndict; i++) {
+        Py_ssize_t len;
+        const char *utf8 = PyUnicode_AsUTF8AndSize(PyList_GET_ITEM(entries, i), &len);
+        if (utf8 == NULL) {
+            goto done;
+        }
+        if (tc_buf_put_varint(body, (uint64_t)len) < 0 || tc_buf_put(body, utf8, (size_t)len) < 0) {
+            PyErr_NoMemory();
+            goto done;
+        }
+    }
+    if (tc_encode_indices(body, indices, count, (uint32_t)ndict) < 0) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    rc = 0;
+
+done:
+    PyMem_Free(indices);
+    Py_XDECREF(entries);
+    Py_XDECREF(index);
+    return rc;
+}
+
+static int encode_uuids(tc_buf_t *body, PyObject **items, Py_ssize_t n, const uint8_t *bitmap) {
+    for (Py_ssize_t i = 0; i < n; i++) {
+        if (is_null(bitmap, (size_t)i)) {
+            continue;
+        }
+        if (!PyBytes_Check(items[i]) || PyBytes_GET_SIZE(items[i]) != TC_UUID_SIZE) {
+            PyErr_SetString(PyExc_TypeError, "uuid column values must be 16 bytes or None");
+            return -1;
+        }
+        if (tc_buf_put(body, PyBytes_AS_STRING(items[i]), TC_UUID_SIZE) < 0) {
+            PyErr_NoMemory();
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Append one (name, type, values) column to body; returns its row count
+static Py_ssize_t encode_column(tc_buf_t *body, PyObject *column) {
+    const char *name;
+    Py_ssize_t name_len;
+    int type;
+    PyObject *values;
+
+    if (!PyTuple_Check(column) || !PyArg_ParseTuple(column, "s#iO:column", &name, &name_len, &type, &values)) {
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_TypeError, "column must be a (name, type, values) tuple");
+        }
+        return -1;
+    }
+    if (name_len > TC_MAX_NAME) {
+        PyErr_SetString(PyExc_ValueError, "Column name too long");
+        return -1;
+    }
+    if (type < TC_TIMESTAMP || type > TC_UUID) {
+        PyErr_SetString(PyExc_ValueError, "Unknown column type");
+        return -1;
+    }
+
+    PyObject *seq = PySequence_Fast(values, "column values must be a sequence");
+    if (seq == NULL) {
+        return -1;
+    }
+    Py_ssize_t n = PySequence_Fast_GET_SIZE(seq);
+    PyObject **items = PySequence_Fast_ITEMS(seq);
+    uint8_t *bitmap = NULL;
+    size_t count = 0;
+    int rc = -1;
+
+    if ((size_t)n > TC_MAX_ROWS) {
+        PyErr_SetString(PyExc_ValueError, "Too many rows for one block");
+        goto done;
+    }
+    for (Py_ssize_t i = 0; i < n; i++) {
+        if (items[i] == Py_None) {
+            if (bitmap == NULL) {
+                bitmap = PyMem_Calloc(BITMAP_SIZE(n), 1);
+                if (bitmap == NULL) {
+                    PyErr_NoMemory();
+                    goto done;
+                }
+            }
+            bitmap[i / 8] |= (uint8_t)(1 << (i % 8));
+        } else {
+            count++;
+        }
+    }
+
+    uint8_t fixed[6] = {(uint8_t)type, bitmap != NULL ? TC_FLAG_NULLS : 0};
+    uint8_t name_byte = (uint8_t)name_len;
+    if (tc_buf_put(body, &name_byte, 1) < 0 || tc_buf_put(body, name, (size_t)name_len) < 0 ||
+        tc_buf_put(body, fixed, sizeof(fixed)) < 0) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    size_t start = body->len;
+    if (bitmap != NULL && tc_buf_put(body, bitmap, BITMAP_SIZE(n)) < 0) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    if (type == TC_STRING) {
+        rc = encode_strings(body, items, n, bitmap, count);
+    } else if (type == TC_UUID) {
+        rc = encode_uuids(body, items, n, bitmap);
+    } else {
+        rc = encode_numbers(body, items, n, bitmap, count, type);
+    }
+    if (rc == 0) {
+        tc_put_le32(body->data + start - 4, (uint32_t)(body->len - start));
+    }
+
+done:
+    PyMem_Free(bitmap);
+    Py_DECREF(seq);
+    return rc < 0 ? -1 : n;
+}
+
+static PyObject* telemetry_codec_encode_block(PyObject *self, PyObject *args) {
+    int kind;
+    PyObject *columns;
+    tc_buf_t body = {NULL, 0, 0};
+    Py_ssize_t nrows = -1;
+
+    if (!PyArg_ParseTuple(args, "iO", &kind, &columns)) {
+        return NULL;
+    }
+    if (kind < 0 || kind > 255) {
+        PyErr_SetString(PyExc_ValueError, "kind must fit in 8 bits");
+        return NULL;
+    }
+
+    PyObject *seq = PySequence_Fast(columns, "columns must be a sequence of (name, type, values)");
+    if (seq == NULL) {
+        return NULL;
+    }
+    Py_ssize_t ncols = PySequence_Fast_GET_SIZE(seq);
+    if (ncols > TC_MAX_COLUMNS) {
+        Py_DECREF(seq);
+        PyErr_SetString(PyExc_ValueError, "Too many columns");
+        return NULL;
+    }
+
+    for (Py_ssize_t c = 0; c < ncols; c++) {
+        Py_ssize_t rows = encode_column(&body, PySequence_Fast_GET_ITEM(seq, c));
+        if (rows < 0) {
+            goto error;
+        }
+        if (nrows >= 0 && rows != nrows) {
+            PyErr_SetString(PyExc_ValueError, "Columns must all have the same length");
+            goto error;
+        }
+        nrows = rows;
+    }
+    Py_DECREF(seq);
+    seq = NULL;
+
+    if (body.len > UINT32_MAX) {
+        PyErr_SetString(PyExc_ValueError, "Block too large");
+        goto error;
+    }
+    tc_block_header_t header = {
+        .kind = (uint8_t)kind,
+        .ncols = (uint16_t)ncols,
+        .nrows = (uint32_t)(nrows < 0 ? 0 : nrows),
+        .body_len = (uint32_t)body.len,
+        .crc = (uint32_t)crc32(0L, body.data, (uInt)body.len),
+    };
+
+    PyObject *result = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)(TC_BLOCK_HEADER_SIZE + body.len));
+    if (result != NULL) {
+        uint8_t *out = (uint8_t*)PyBytes_AS_STRING(result);
+        tc_block_header_write(out, &header);
+        if (body.len > 0) {
+            memcpy(out + TC_BLOCK_HEADER_SIZE, body.data, body.len);
+        }
+    }
+    tc_buf_free(&body);
+    return result;
+
+error:
+    Py_XDECREF(seq);
+    tc_buf_free(&body);
+    return NULL;
+}
+
+static PyObject* decode_error(const char *message) {
+    PyErr_SetString(PyExc_ValueError, message);
+    return NULL;
+}
+
+static PyObject* decode_strings(const uint8_t *in, size_t len, size_t count, PyObject **values) {
+    uint64_t ndict;
+    size_t pos, used;
+
+    if (tc_read_varint(in, len, &ndict, &pos) < 0 || ndict > count) {
+        return decode_error("Malformed string dictionary");
+    }
+    PyObject *entries = PyList_New((Py_ssize_t)ndict);
+    uint32_t *indices = PyMem_Malloc((count > 0 ? count : 1) * sizeof(uint32_t));
+    if (entries == NULL || indices == NULL) {
+        Py_XDECREF(entries);
+        PyMem_Free(indices);
+        return PyErr_NoMemory();
+    }
+
+    for (uint64_t i = 0; i < ndict; i++) {
+        uint64_t slen;
+        if (tc_read_varint(in + pos, len - pos, &slen, &used) < 0 || slen > len - pos - used) {
+            goto malformed;
+        }
+        pos += used;
+        PyObject *s = PyUnicode_DecodeUTF8((const char*)in + pos, (Py_ssize_t)slen, "strict");
+        if (s == NULL) {
+            goto error;
+        }
+        PyList_SET_ITEM(entries, (Py_ssize_t)i, s);
+        pos += slen;
+    }
+    if (tc_decode_indices(in + pos, len - pos, indices, count, (uint32_t)ndict, &used) < 0 ||
+        pos + used != len) {
+        goto malformed;
+    }
+    for (size_t i = 0; i < count; i++) {
+        values[i] = PyList_GET_ITEM(entries, indices[i]);
+        Py_INCREF(values[i]);
+    }
+    PyMem_Free(indices);
+    return entries;
+
+malformed:
+    PyErr_SetString(PyExc_ValueError, "Malformed string column");
+error:
+    Py_DECREF(entries);
+    PyMem_Free(indices);
+    return NULL;
+}
+
+// Decode count non-null values of a column into new references
+static int decode_values(const uint8_t *in, size_t len, int type, size_t count, PyObject **values) {
+    size_t used = 0;
+
+    if (type == TC_STRING) {
+        PyObject *entries = decode_strings(in, len, count, values);
+        if (entries == NULL) {
+            return -1;
+        }
+        Py_DECREF(entries);
+        return 0;
+    }
+    if (type == TC_UUID) {
+        if (len != count * TC_UUID_SIZE) {
+            PyErr_SetString(PyExc_ValueError, "Malformed uuid column");
+            return -1;
+        }
+        for (size_t i = 0; i < count; i++) {
+            values[i] = PyBytes_FromStringAndSize((const char*)in + i * TC_UUID_SIZE, TC_UUID_SIZE);
+            if (values[i] == NULL) {
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    void *raw = PyMem_Malloc((count > 0 ? count : 1) * 8);
+    if (raw == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    int rc;
+    if (type == TC_TIMESTAMP) {
+        rc = tc_decode_timestamps(in, len, raw, count, &used);
+    } else if (type == TC_INT) {
+        rc = tc_decode_ints(in, len, raw, count, &used);
+    } else {
+        rc = tc_decode_floats(in, len, raw, count, &used);
+    }
+    if (rc < 0 || used != len) {
+        PyMem_Free(raw);
+        PyErr_SetString(PyExc_ValueError, "Malformed numeric column");
+        return -1;
+    }
+    for (size_t i = 0; i < count; i++) {
+        values[i] = type == TC_FLOAT ? PyFloat_FromDouble(((double*)raw)[i])
+                                     : PyLong_FromLongLong(((int64_t*)raw)[i]);
+        if (values[i] == NULL) {
+            PyMem_Free(raw);
+            return -1;
+        }
+    }
+    PyMem_Free(raw);
+    return 0;
+}
+
+static PyObject* decode_column(const uint8_t *in, size_t len, size_t nrows, size_t *consumed) {
+    if (len < 1 || len - 1 < (size_t)in[0] + 6) {
+        return decode_error("Truncated column header");
+    }
+    size_t name_len = in[0];
+    const uint8_t *p = in + 1 + name_len;
+    int type = p[0];
+    int flags = p[1];
+    size_t data_len = (size_t)p[2] | ((size_t)p[3] << 8) | ((size_t)p[4] << 16) | ((size_t)p[5] << 24);
+    size_t header_len = 1 + name_len + 6;
+
+    if (type < TC_TIMESTAMP || type > TC_UUID) {
+        return decode_error("Unknown column type");
+    }
+    if (len - header_len < data_len) {
+        return decode_error("Truncated column data");
+    }
+    const uint8_t *data = in + header_len;
+    const uint8_t *bitmap = NULL;
+    size_t count = nrows;
+    if (flags & TC_FLAG_NULLS) {
+        if (data_len < BITMAP_SIZE(nrows)) {
+            return decode_error("Truncated null bitmap");
+        }
+        bitmap = data;
+        for (size_t i = 0; i < nrows; i++) {
+            count -= is_null(bitmap, i);
+        }
+        data += BITMAP_SIZE(nrows);
+        data_len -= BITMAP_SIZE(nrows);
+    }
+
+    PyObject **dense = PyMem_Calloc(count > 0 ? count : 1, sizeof(PyObject*));
+    if (dense == NULL) {
+        return PyErr_NoMemory();
+    }
+    PyObject *values = NULL;
+    if (decode_values(data, data_len, type, count, dense) == 0) {
+        values = PyList_New((Py_ssize_t)nrows);
+    }
+    if (values != NULL) {
+        // Hand the dense references over, filling nulls with None
+        size_t k = 0;
+        for (size_t i = 0; i < nrows; i++) {
+            PyObject *v = is_null(bitmap, i) ? Py_None : dense[k++];
+            if (v == Py_None) {
+                Py_INCREF(v);
+            }
+            PyList_SET_ITEM(values, (Py_ssize_t)i, v);
+        }
+        count = 0;
+    }
+    for (size_t i = 0; i < count; i++) {
+        Py_XDECREF(dense[i]);
+    }
+    PyMem_Free(dense);
+    if (values == NULL) {
+        return NULL;
+    }
+
+    *consumed = header_len + (bitmap != NULL ? BITMAP_SIZE(nrows) : 0) + data_len;
+    return Py_BuildValue("(s#iN)", (const char*)in + 1, (Py_ssize_t)name_len, type, values);
+}
+
+static PyObject* telemetry_codec_decode_block(PyObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"data", "offset", NULL};
+    Py_buffer data;
+    Py_ssize_t offset = 0;
+    tc_block_header_t header;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|n", kwlist, &data, &offset)) {
+        return NULL;
+    }
+    const uint8_t *in = data.buf;
+    size_t len = (size_t)data.len;
+    PyObject *columns = NULL;
+
+    if (offset < 0 || (size_t)offset > len || len - (size_t)offset < TC_BLOCK_HEADER_SIZE) {
+        PyErr_SetString(PyExc_ValueError, "Truncated block header");
+        goto done;
+    }
+    in += offset;
+    len -= (size_t)offset;
+    if (tc_block_header_read(in, &header) < 0) {
+        PyErr_SetString(PyExc_ValueError, "Not a telemetry block");
+        goto done;
+    }
+    if (header.nrows > TC_MAX_ROWS || len - TC_BLOCK_HEADER_SIZE < header.body_len) {
+        PyErr_SetString(PyExc_ValueError, "Truncated block");
+        goto done;
+    }
+    const uint8_t *body = in + TC_BLOCK_HEADER_SIZE;
+    if ((uint32_t)crc32(0L, body, header.body_len) != header.crc) {
+        PyErr_SetString(PyExc_ValueError, "Telemetry block checksum mismatch");
+        goto done;
+    }
+
+    columns = PyList_New(header.ncols);
+    if (columns == NULL) {
+        goto done;
+    }
+    size_t pos = 0;
+    for (uint16_t c = 0; c < header.ncols; c++) {
+        size_t used = 0;
+        PyObject *column = decode_column(body + pos, header.body_len - pos, header.nrows, &used);
+        if (column == NULL) {
+            Py_CLEAR(columns);
+            goto done;
+        }
+        PyList_SET_ITEM(columns, c, column);
+        pos += used;
+    }
+    if (pos != header.body_len) {
+        Py_CLEAR(columns);
+        PyErr_SetString(PyExc_ValueError, "Trailing bytes in block body");
+    }
+
+done:
+    PyBuffer_Release(&data);
+    if (columns == NULL) {
+        return NULL;
+    }
+    return Py_BuildValue("(iNn)", header.kind, columns,
+                         offset + (Py_ssize_t)(TC_BLOCK_HEADER_SIZE + header.body_len));
+}
+
+static PyObject* telemetry_codec_version(PyObject *self, PyObject *args) {
+    return PyUnicode_FromString("0.1.0");
+}
+
+// Method definitions
+static PyMethodDef telemetry_codec_module_methods[] = {
+    {"encode_block", telemetry_codec_encode_block, METH_VARARGS,
+     "Encode [(name, type, values), ...] as one columnar block of the given kind"},
+    {"decode_block", (PyCFunction)(void(*)(void))telemetry_codec_decode_block, METH_VARARGS | METH_KEYWORDS,
+     "Decode the block at offset; returns (kind, [(name, type, values), ...], end_offset)"},
+    {"version", telemetry_codec_version, METH_NOARGS, "Get version"},
+    {NULL, NULL, 0, NULL}
+};
+
+// Module definition
+static struct PyModuleDef telemetry_codec_module = {
+    PyModuleDef_HEAD_INIT,
+    "telemetry_codec_native",
+    "Native telemetry codec extension for Lucid RDP",
+    -1,
+    telemetry_codec_module_methods
+};
+
+PyMODINIT_FUNC PyInit_telemetry_codec_native(void) {
+    PyObject *m = PyModule_Create(&telemetry_codec_module);
+    if (m == NULL) {
+        return NULL;
+    }
+
+    PyModule_AddIntConstant(m, "TIMESTAMP", TC_TIMESTAMP);
+    PyModule_AddIntConstant(m, "INT", TC_INT);
+    PyModule_AddIntConstant(m, "FLOAT", TC_FLOAT);
+    PyModule_AddIntConstant(m, "STRING", TC_STRING);
+    PyModule_AddIntConstant(m, "UUID", TC_UUID);
+    PyModule_AddIntConstant(m, "KIND_KEYSTROKES", TC_KIND_KEYSTROKES);
+    PyModule_AddIntConstant(m, "KIND_WINDOW_EVENTS", TC_KIND_WINDOW_EVENTS);
+    PyModule_AddIntConstant(m, "KIND_RESOURCE_SAMPLES", TC_KIND_RESOURCE_SAMPLES);
+    PyModule_AddIntConstant(m, "BLOCK_HEADER_SIZE", TC_BLOCK_HEADER_SIZE);
+
+    return m;
+}
@@ -0,0 +1,11 @@
+#ifndef TELEMETRY_CODEC_H
+#define TELEMETRY_CODEC_H
+
+#include <Python.h>
+
+// Block kinds written by the session recorder monitors
+#define TC_KIND_KEYSTROKES 1
+#define TC_KIND_WINDOW_EVENTS 2
+#define TC_KIND_RESOURCE_SAMPLES 3
+
+#endif // TELEMETRY_CODEC_H
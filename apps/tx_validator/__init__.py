@@ -0,0 +1,13 @@
+# Transaction Validator Module
+# Batch transaction signature and state validation
+
+"""
+File: /app/apps/tx_validator/__init__.py
+x-lucid-file-path: /app/apps/tx_validator/__init__.py
+x-lucid-file-type: python
+
+Transaction Validator package for Lucid RDP.
+Contains the native batch validator used by the transaction processor.
+"""
+
+__all__ = []
@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+"""
+File: /app/apps/tx_validator/setup.py
+x-lucid-file-path: /app/apps/tx_validator/setup.py
+x-lucid-file-type: python
+
+Setup script for native transaction validator extension
+"""
+
+from setuptools import setup, Extension
+
+# Define the extension module
+tx_validator_native = Extension(
+    'tx_validator_native',
+    sources=[
+        'src/tx_validator.c',
+        'src/sig_verify.c',
+        'src/state_snapshot.c'
+    ],
+    include_dirs=[
+        'src/'
+    ],
+    libraries=['crypto', 'pthread'],
+    library_dirs=[],
+    extra_compile_args=[
+        '-O3',
+        '-Wall',
+        '-Wextra',
+        '-std=c99',
+        '-fPIC'
+    ],
+    extra_link_args=['-shared']
+)
+
+setup(
+    name='tx-validator-native',
+    version='0.1.0',
+    description='Native transaction validator extension for Lucid RDP',
+    ext_modules=[tx_validator_native],
+    python_requires='>=3.8',
+    classifiers=[
+        'Development Status :: 3 - Alpha',
+        'Intended Audience :: Developers',
+        'License :: OSI Approved :: MIT License',
+        'Programming Language :: C',
+        'Programming Language :: Python :: 3',
+        'Programming Language :: Python :: 3.8',
+        'Programming Language :: Python :: 3.9',
+        'Programming Language :: Python :: 3.10',
+        'Programming Language :: Python :: 3.11',
+    ],
+)
@@ -0,0 +1,13 @@
+# Transaction Validator Source Module
+# Transaction Validator native source code components
+
+"""
+File: /app/apps/tx_validator/src/__init__.py
+x-lucid-file-path: /app/apps/tx_validator/src/__init__.py
+x-lucid-file-type: python
+
+Transaction Validator Source package for Lucid RDP.
+Contains transaction validator native source code and C implementations.
+"""
+
+__all__ = []
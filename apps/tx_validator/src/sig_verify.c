@@ -0,0 +1,74 @@
+#include <pthread.h>
+#include <openssl/evp.h>
+#include "sig_verify.h"
+
+#define SIG_CLAIM_SIZE 16       // Jobs a worker claims at a time
+#define SIG_MIN_PER_THREAD 32   // Below this a thread costs more than it saves
+#define SIG_MAX_THREADS 64
+
+int sig_verify_ed25519(const uint8_t *public_key, const uint8_t *signature,
+                       const uint8_t *message, size_t message_len) {
+    EVP_PKEY *pkey = EVP_PKEY_new_raw_public_key(EVP_PKEY_ED25519, NULL, public_key,
+                                                 ED25519_PUBLIC_KEY_SIZE);
+    if (pkey == NULL) {
+        return 0;  // Not a point on the curve
+    }
+
+    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
+    int result = -1;
+    if (ctx != NULL && EVP_DigestVerifyInit(ctx, NULL, NULL, NULL, pkey) == 1) {
+        result = EVP_DigestVerify(ctx, signature, ED25519_SIGNATURE_SIZE, message, message_len) == 1;
+    }
+
+    EVP_MD_CTX_free(ctx);
+    EVP_PKEY_free(pkey);
+    return result;
+}
+
+typedef struct {
+    sig_job_t *jobs;
+    size_t count;
+    size_t next;  // Shared claim cursor
+} sig_batch_t;
+
+static void *sig_worker(void *arg) {
+    sig_batch_t *batch = arg;
+    for (;;) {
+        size_t start = __atomic_fetch_add(&batch->next, SIG_CLAIM_SIZE, __ATOMIC_RELAXED);
+        if (start >= batch->count) {
+            break;
+        }
+        size_t end = start + SIG_CLAIM_SIZE < batch->count ? start + SIG_CLAIM_SIZE : batch->count;
+        for (size_t i = start; i < end; i++) {
+            sig_job_t *job = &batch->jobs[i];
+            job->result = sig_verify_ed25519(job->public_key, job->signature, job->message, job->message_len);
+        }
+    }
+    return NULL;
+}
+
+void sig_verify_batch(sig_job_t *jobs, size_t count, int threads) {
+    sig_batch_t batch = {jobs, count, 0};
+    pthread_t workers[SIG_MAX_THREADS];
+    int started = 0;
+
+    size_t useful = count / SIG_MIN_PER_THREAD;
+    if ((size_t)threads > useful) {
+        threads = (int)useful;
+    }
+    if (threads > SIG_MAX_THREADS) {
+        threads = SIG_MAX_THREADS;
+    }
+
+    // The calling thread is one of the workers
+    for (int i = 1; i < threads; i++) {
+        if (pthread_create(&workers[started], NULL, sig_worker, &batch) != 0) {
+            break;
+        }
+        started++;
+    }
+    sig_worker(&batch);
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+}
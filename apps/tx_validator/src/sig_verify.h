@@ -0,0 +1,25 @@
+#ifndef SIG_VERIFY_H
+#define SIG_VERIFY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ED25519_PUBLIC_KEY_SIZE 32
+#define ED25519_SIGNATURE_SIZE 64
+
+// One signature check; result is 1 for valid, 0 for invalid, -1 on error
+typedef struct {
+    const uint8_t *public_key;
+    const uint8_t *signature;
+    const uint8_t *message;
+    size_t message_len;
+    int result;
+} sig_job_t;
+
+int sig_verify_ed25519(const uint8_t *public_key, const uint8_t *signature,
+                       const uint8_t *message, size_t message_len);
+
+// Verifies every job, spreading them over up to threads worker threads
+void sig_verify_batch(sig_job_t *jobs, size_t count, int threads);
+
+#endif // SIG_VERIFY_H
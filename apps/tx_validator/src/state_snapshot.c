@@ -0,0 +1,113 @@
+#include <stdlib.h>
+#include <string.h>
+#include "state_snapshot.h"
+
+#define SNAP_INITIAL_CAPACITY 1024  // Power of two, kept at most half full
+
+static uint64_t snap_hash(const char *address, size_t len) {
+    // FNV-1a
+    uint64_t hash = 1469598103934665603ULL;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (uint8_t)address[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+int snap_init(snap_table_t *table) {
+    memset(table, 0, sizeof(*table));
+    table->slots = calloc(SNAP_INITIAL_CAPACITY, sizeof(snap_entry_t));
+    if (table->slots == NULL) {
+        return -1;
+    }
+    table->capacity = SNAP_INITIAL_CAPACITY;
+    return 0;
+}
+
+void snap_clear(snap_table_t *table) {
+    for (size_t i = 0; i < table->capacity; i++) {
+        free(table->slots[i].address);
+    }
+    memset(table->slots, 0, table->capacity * sizeof(snap_entry_t));
+    table->count = 0;
+}
+
+void snap_free(snap_table_t *table) {
+    if (table->slots != NULL) {
+        snap_clear(table);
+        free(table->slots);
+    }
+    memset(table, 0, sizeof(*table));
+}
+
+static snap_entry_t *snap_slot(snap_entry_t *slots, size_t capacity, uint64_t hash,
+                               const char *address, size_t len) {
+    size_t mask = capacity - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        snap_entry_t *slot = &slots[i];
+        if (slot->address == NULL ||
+            (slot->hash == hash && slot->address_len == len && memcmp(slot->address, address, len) == 0)) {
+            return slot;
+        }
+    }
+}
+
+snap_entry_t *snap_find(const snap_table_t *table, const char *address, size_t len) {
+    snap_entry_t *slot = snap_slot(table->slots, table->capacity, snap_hash(address, len), address, len);
+    return slot->address ? slot : NULL;
+}
+
+static int snap_grow(snap_table_t *table) {
+    size_t capacity = table->capacity * 2;
+    snap_entry_t *slots = calloc(capacity, sizeof(snap_entry_t));
+    if (slots == NULL) {
+        return -1;
+    }
+    for (size_t i = 0; i < table->capacity; i++) {
+        snap_entry_t *old = &table->slots[i];
+        if (old->address != NULL) {
+            *snap_slot(slots, capacity, old->hash, old->address, old->address_len) = *old;
+        }
+    }
+    free(table->slots);
+    table->slots = slots;
+    table->capacity = capacity;
+    return 0;
+}
+
+int snap_put(snap_table_t *table, const char *address, size_t len, double balance, uint64_t nonce) {
+    if ((table->count + 1) * 2 > table->capacity && snap_grow(table) != 0) {
+        return -1;
+    }
+
+    uint64_t hash = snap_hash(address, len);
+    snap_entry_t *slot = snap_slot(table->slots, table->capacity, hash, address, len);
+    if (slot->address == NULL) {
+        slot->address = malloc(len ? len : 1);
+        if (slot->address == NULL) {
+            return -1;
+        }
+        memcpy(slot->address, address, len);
+        slot->address_len = len;
+        slot->hash = hash;
+        table->count++;
+    }
+    slot->balance = balance;
+    slot->nonce = nonce;
+    slot->epoch = 0;  // Stale overlay from an earlier batch
+    return 0;
+}
+
+uint64_t snap_begin_batch(snap_table_t *table) {
+    return ++table->epoch;
+}
+
+snap_entry_t *snap_batch_entry(snap_table_t *table, const char *address, size_t len) {
+    snap_entry_t *entry = snap_find(table, address, len);
+    if (entry != NULL && entry->epoch != table->epoch) {
+        entry->work_balance = entry->balance;
+        entry->work_nonce = entry->nonce;
+        entry->epoch = table->epoch;
+    }
+    return entry;
+}
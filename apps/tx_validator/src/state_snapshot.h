@@ -0,0 +1,38 @@
+#ifndef STATE_SNAPSHOT_H
+#define STATE_SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Account state as of the last refresh. The work_* fields are a per-batch
+// overlay, reset lazily the first time a batch touches the account.
+typedef struct {
+    char *address;  // NULL marks an empty slot
+    size_t address_len;
+    uint64_t hash;
+    double balance;
+    uint64_t nonce;  // Next expected nonce
+    double work_balance;
+    uint64_t work_nonce;
+    uint64_t epoch;
+} snap_entry_t;
+
+typedef struct {
+    snap_entry_t *slots;
+    size_t capacity;
+    size_t count;
+    uint64_t epoch;
+} snap_table_t;
+
+int snap_init(snap_table_t *table);
+void snap_free(snap_table_t *table);
+void snap_clear(snap_table_t *table);
+
+snap_entry_t *snap_find(const snap_table_t *table, const char *address, size_t len);
+int snap_put(snap_table_t *table, const char *address, size_t len, double balance, uint64_t nonce);
+
+// Starts a batch; entries touched afterwards begin from their stored state
+uint64_t snap_begin_batch(snap_table_t *table);
+snap_entry_t *snap_batch_entry(snap_table_t *table, const char *address, size_t len);
+
+#endif // STATE_SNAPSHOT_H
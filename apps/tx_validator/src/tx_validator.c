@@ -0,0 +1,412 @@
+/*
+ * Native transaction validator extension for Lucid RDP
+ * Verifies a batch of Ed25519 signatures across threads and checks nonces
+ * and balances against an in-memory account snapshot, without the GIL
+ */
+
+#include <Python.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "tx_validator.h"
+#include "sig_verify.h"
+#include "state_snapshot.h"
+
+typedef struct {
+    PyObject_HEAD
+    snap_table_t table;
+    int busy;  // A batch is running on another thread
+} StateSnapshotObject;
+
+// One transaction as parsed from its tuple; pointers borrow from the tuple
+typedef struct {
+    const char *sender;
+    Py_ssize_t sender_len;
+    int has_nonce;
+    uint64_t nonce;
+    double cost;
+    Py_ssize_t sig_job;  // Index into the signature jobs, or -1
+    uint8_t verdict;
+    int decided;
+} tx_item_t;
+
+static PyTypeObject StateSnapshotType;
+
+// Forward declarations
+static PyObject* StateSnapshot_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
+static void StateSnapshot_dealloc(StateSnapshotObject *self);
+static PyObject* StateSnapshot_update(StateSnapshotObject *self, PyObject *args);
+static PyObject* StateSnapshot_load(StateSnapshotObject *self, PyObject *args);
+static PyObject* StateSnapshot_get(StateSnapshotObject *self, PyObject *args);
+static PyObject* StateSnapshot_clear(StateSnapshotObject *self, PyObject *args);
+static Py_ssize_t StateSnapshot_length(StateSnapshotObject *self);
+
+// Method definitions
+static PyMethodDef StateSnapshot_methods[] = {
+    {"update", (PyCFunction)StateSnapshot_update, METH_VARARGS, "Set an account's balance and next nonce"},
+    {"load", (PyCFunction)StateSnapshot_load, METH_VARARGS, "Set many (address, balance, nonce) accounts"},
+    {"get", (PyCFunction)StateSnapshot_get, METH_VARARGS, "(balance, nonce) for an address, or None"},
+    {"clear", (PyCFunction)StateSnapshot_clear, METH_NOARGS, "Forget every account"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PySequenceMethods StateSnapshot_as_sequence = {
+    .sq_length = (lenfunc)StateSnapshot_length,
+};
+
+// Type definition
+static PyTypeObject StateSnapshotType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "tx_validator_native.StateSnapshot",
+    .tp_doc = "Account balances and nonces that a batch is validated against",
+    .tp_basicsize = sizeof(StateSnapshotObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = StateSnapshot_new,
+    .tp_dealloc = (destructor)StateSnapshot_dealloc,
+    .tp_methods = StateSnapshot_methods,
+    .tp_as_sequence = &StateSnapshot_as_sequence,
+};
+
+static PyObject* StateSnapshot_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
+    StateSnapshotObject *self = (StateSnapshotObject*)type->tp_alloc(type, 0);
+    if (self == NULL) {
+        return NULL;
+    }
+    if (snap_init(&self->table) != 0) {
+        Py_DECREF(self);
+        return PyErr_NoMemory();
+    }
+    self->busy = 0;
+    return (PyObject*)self;
+}
+
+static void StateSnapshot_dealloc(StateSnapshotObject *self) {
+    snap_free(&self->table);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static Py_ssize_t StateSnapshot_length(StateSnapshotObject *self) {
+    return (Py_ssize_t)self->table.count;
+}
+
+static int check_idle(StateSnapshotObject *self) {
+    if (self->busy) {
+        PyErr_SetString(PyExc_RuntimeError, "State snapshot is in use by a running batch");
+        return -1;
+    }
+    return 0;
+}
+
+static int put_account(StateSnapshotObject *self, PyObject *address, double balance, unsigned long long nonce) {
+    Py_ssize_t len;
+    const char *data = PyUnicode_AsUTF8AndSize(address, &len);
+    if (data == NULL) {
+        return -1;
+    }
+    if (snap_put(&self->table, data, (size_t)len, balance, nonce) != 0) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    return 0;
+}
+
+static PyObject* StateSnapshot_update(StateSnapshotObject *self, PyObject *args) {
+    PyObject *address;
+    double balance;
+    unsigned long long nonce;
+
+    if (!PyArg_ParseTuple(args, "UdK", &address, &balance, &nonce)) {
+        return NULL;
+    }
+    if (check_idle(self) < 0 || put_account(self, address, balance, nonce) < 0) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* StateSnapshot_load(StateSnapshotObject *self, PyObject *args) {
+    PyObject *accounts;
+
+    if (!PyArg_ParseTuple(args, "O", &accounts)) {
+        return NULL;
+    }
+    if (check_idle(self) < 0) {
+        return NULL;
+    }
+
+    PyObject *iterator = PyObject_GetIter(accounts);
+    if (iterator == NULL) {
+        return NULL;
+    }
+
+    PyObject *item;
+    while ((item = PyIter_Next(iterator)) != NULL) {
+        PyObject *address;
+        double balance;
+        unsigned long long nonce;
+        int ok = PyArg_ParseTuple(item, "UdK", &address, &balance, &nonce) &&
+                 put_account(self, address, balance, nonce) == 0;
+        Py_DECREF(item);
+        if (!ok) {
+            Py_DECREF(iterator);
+            return NULL;
+        }
+    }
+    Py_DECREF(iterator);
+    if (PyErr_Occurred()) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* StateSnapshot_get(StateSnapshotObject *self, PyObject *args) {
+    PyObject *key;
+    Py_ssize_t len;
+
+    if (!PyArg_ParseTuple(args, "U", &key)) {
+        return NULL;
+    }
+    const char *address = PyUnicode_AsUTF8AndSize(key, &len);
+    if (address == NULL) {
+        return NULL;
+    }
+
+    snap_entry_t *entry = snap_find(&self->table, address, (size_t)len);
+    if (entry == NULL) {
+        Py_RETURN_NONE;
+    }
+    return Py_BuildValue("(dK)", entry->balance, (unsigned long long)entry->nonce);
+}
+
+static PyObject* StateSnapshot_clear(StateSnapshotObject *self, PyObject *args) {
+    if (check_idle(self) < 0) {
+        return NULL;
+    }
+    snap_clear(&self->table);
+    Py_RETURN_NONE;
+}
+
+// Fills item and, if it is signed, the next signature job
+static int parse_transaction(PyObject *tuple, tx_item_t *item, sig_job_t *jobs, Py_ssize_t *job_count) {
+    PyObject *sender;
+    PyObject *nonce;
+    PyObject *public_key;
+    PyObject *signature;
+    PyObject *message;
+
+    if (!PyTuple_Check(tuple) ||
+        !PyArg_ParseTuple(tuple, "UOdOOO", &sender, &nonce, &item->cost, &public_key, &signature, &message)) {
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_TypeError,
+                            "Transactions must be (sender, nonce, cost, public_key, signature, message) tuples");
+        }
+        return -1;
+    }
+
+    item->sender = PyUnicode_AsUTF8AndSize(sender, &item->sender_len);
+    if (item->sender == NULL) {
+        return -1;
+    }
+
+    item->has_nonce = nonce != Py_None;
+    if (item->has_nonce) {
+        item->nonce = PyLong_AsUnsignedLongLong(nonce);
+        if (item->nonce == (uint64_t)-1 && PyErr_Occurred()) {
+            return -1;
+        }
+    }
+
+    item->sig_job = -1;
+    item->decided = 0;
+    if (public_key == Py_None) {
+        return 0;  // The caller checked the signature itself
+    }
+    if (!PyBytes_Check(public_key) || !PyBytes_Check(signature) || !PyBytes_Check(message)) {
+        PyErr_SetString(PyExc_TypeError, "public_key, signature and message must be bytes");
+        return -1;
+    }
+    if (PyBytes_GET_SIZE(public_key) != ED25519_PUBLIC_KEY_SIZE ||
+        PyBytes_GET_SIZE(signature) != ED25519_SIGNATURE_SIZE) {
+        item->verdict = VERDICT_BAD_SIGNATURE;
+        item->decided = 1;
+        return 0;
+    }
+
+    sig_job_t *job = &jobs[*job_count];
+    job->public_key = (const uint8_t*)PyBytes_AS_STRING(public_key);
+    job->signature = (const uint8_t*)PyBytes_AS_STRING(signature);
+    job->message = (const uint8_t*)PyBytes_AS_STRING(message);
+    job->message_len = (size_t)PyBytes_GET_SIZE(message);
+    item->sig_job = (*job_count)++;
+    return 0;
+}
+
+// In order, so a sender's transactions spend from one running balance
+static void apply_state(snap_table_t *table, tx_item_t *items, Py_ssize_t count, const sig_job_t *jobs) {
+    snap_begin_batch(table);
+
+    for (Py_ssize_t i = 0; i < count; i++) {
+        tx_item_t *item = &items[i];
+        if (item->decided) {
+            continue;
+        }
+        if (item->sig_job >= 0 && jobs[item->sig_job].result != 1) {
+            item->verdict = VERDICT_BAD_SIGNATURE;
+            continue;
+        }
+
+        snap_entry_t *account = snap_batch_entry(table, item->sender, (size_t)item->sender_len);
+        if (account == NULL) {
+            item->verdict = VERDICT_UNKNOWN_SENDER;
+        } else if (item->has_nonce && item->nonce != account->work_nonce) {
+            item->verdict = VERDICT_BAD_NONCE;
+        } else if (item->cost > 0 && account->work_balance < item->cost) {
+            item->verdict = VERDICT_INSUFFICIENT_BALANCE;
+        } else {
+            item->verdict = VERDICT_OK;
+            account->work_balance -= item->cost;
+            if (item->has_nonce) {
+                account->work_nonce = item->nonce + 1;
+            }
+        }
+    }
+}
+
+static PyObject* tx_validator_validate_batch(PyObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"transactions", "snapshot", "threads", NULL};
+    PyObject *transactions;
+    StateSnapshotObject *snapshot;
+    int threads = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO!|i", kwlist, &transactions,
+                                     &StateSnapshotType, &snapshot, &threads)) {
+        return NULL;
+    }
+    if (check_idle(snapshot) < 0) {
+        return NULL;
+    }
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+        if (threads > DEFAULT_MAX_THREADS) {
+            threads = DEFAULT_MAX_THREADS;
+        }
+    }
+
+    // A private tuple keeps every borrowed buffer alive without the GIL
+    PyObject *batch = PySequence_Tuple(transactions);
+    if (batch == NULL) {
+        return NULL;
+    }
+
+    Py_ssize_t count = PyTuple_GET_SIZE(batch);
+    tx_item_t *items = PyMem_Calloc(count ? count : 1, sizeof(tx_item_t));
+    sig_job_t *jobs = PyMem_Calloc(count ? count : 1, sizeof(sig_job_t));
+    PyObject *result = NULL;
+    Py_ssize_t job_count = 0;
+
+    if (items == NULL || jobs == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (Py_ssize_t i = 0; i < count; i++) {
+        if (parse_transaction(PyTuple_GET_ITEM(batch, i), &items[i], jobs, &job_count) < 0) {
+            goto done;
+        }
+    }
+
+    snapshot->busy = 1;
+    Py_BEGIN_ALLOW_THREADS
+    sig_verify_batch(jobs, (size_t)job_count, threads);
+    apply_state(&snapshot->table, items, count, jobs);
+    Py_END_ALLOW_THREADS
+    snapshot->busy = 0;
+
+    result = PyBytes_FromStringAndSize(NULL, count);
+    if (result != NULL) {
+        uint8_t *verdicts = (uint8_t*)PyBytes_AS_STRING(result);
+        for (Py_ssize_t i = 0; i < count; i++) {
+            verdicts[i] = items[i].verdict;
+        }
+    }
+
+done:
+    PyMem_Free(items);
+    PyMem_Free(jobs);
+    Py_DECREF(batch);
+    return result;
+}
+
+static PyObject* tx_validator_verify_ed25519(PyObject *self, PyObject *args) {
+    Py_buffer public_key;
+    Py_buffer signature;
+    Py_buffer message;
+
+    if (!PyArg_ParseTuple(args, "y*y*y*", &public_key, &signature, &message)) {
+        return NULL;
+    }
+
+    int valid = 0;
+    if (public_key.len == ED25519_PUBLIC_KEY_SIZE && signature.len == ED25519_SIGNATURE_SIZE) {
+        Py_BEGIN_ALLOW_THREADS
+        valid = sig_verify_ed25519(public_key.buf, signature.buf, message.buf, (size_t)message.len);
+        Py_END_ALLOW_THREADS
+    }
+
+    PyBuffer_Release(&public_key);
+    PyBuffer_Release(&signature);
+    PyBuffer_Release(&message);
+    if (valid < 0) {
+        PyErr_SetString(PyExc_RuntimeError, "Signature verification failed to run");
+        return NULL;
+    }
+    return PyBool_FromLong(valid);
+}
+
+static PyObject* tx_validator_version(PyObject *self, PyObject *args) {
+    return PyUnicode_FromString("0.1.0");
+}
+
+static PyMethodDef tx_validator_module_methods[] = {
+    {"validate_batch", (PyCFunction)(void(*)(void))tx_validator_validate_batch, METH_VARARGS | METH_KEYWORDS,
+     "Validate (sender, nonce, cost, public_key, signature, message) tuples; returns one verdict byte each"},
+    {"verify_ed25519", tx_validator_verify_ed25519, METH_VARARGS, "Verify a single Ed25519 signature"},
+    {"version", tx_validator_version, METH_NOARGS, "Get version"},
+    {NULL, NULL, 0, NULL}
+};
+
+// Module definition
+static struct PyModuleDef tx_validator_module = {
+    PyModuleDef_HEAD_INIT,
+    "tx_validator_native",
+    "Native transaction validator extension for Lucid RDP",
+    -1,
+    tx_validator_module_methods
+};
+
+PyMODINIT_FUNC PyInit_tx_validator_native(void) {
+    if (PyType_Ready(&StateSnapshotType) < 0) {
+        return NULL;
+    }
+
+    PyObject *m = PyModule_Create(&tx_validator_module);
+    if (m == NULL) {
+        return NULL;
+    }
+
+    Py_INCREF(&StateSnapshotType);
+    if (PyModule_AddObject(m, "StateSnapshot", (PyObject*)&StateSnapshotType) < 0) {
+        Py_DECREF(&StateSnapshotType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    PyModule_AddIntConstant(m, "VERDICT_OK", VERDICT_OK);
+    PyModule_AddIntConstant(m, "VERDICT_BAD_SIGNATURE", VERDICT_BAD_SIGNATURE);
+    PyModule_AddIntConstant(m, "VERDICT_UNKNOWN_SENDER", VERDICT_UNKNOWN_SENDER);
+    PyModule_AddIntConstant(m, "VERDICT_BAD_NONCE", VERDICT_BAD_NONCE);
+    PyModule_AddIntConstant(m, "VERDICT_INSUFFICIENT_BALANCE", VERDICT_INSUFFICIENT_BALANCE);
+
+    return m;
+}
@@ -0,0 +1,15 @@
+#ifndef TX_VALIDATOR_H
+#define TX_VALIDATOR_H
+
+#include <Python.h>
+
+// Verdicts, one byte per transaction
+#define VERDICT_OK 0
+#define VERDICT_BAD_SIGNATURE 1
+#define VERDICT_UNKNOWN_SENDER 2
+#define VERDICT_BAD_NONCE 3
+#define VERDICT_INSUFFICIENT_BALANCE 4
+
+#define DEFAULT_MAX_THREADS 16
+
+#endif // TX_VALIDATOR_H
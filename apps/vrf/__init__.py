@@ -0,0 +1,13 @@
+# VRF Module
+# Verifiable random functions for leader election
+
+"""
+File: /app/apps/vrf/__init__.py
+x-lucid-file-path: /app/apps/vrf/__init__.py
+x-lucid-file-type: python
+
+VRF package for Lucid RDP.
+Contains the native ECVRF and candidate table used by leader selection.
+"""
+
+__all__ = []
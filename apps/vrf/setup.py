@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+"""
+File: /app/apps/vrf/setup.py
+x-lucid-file-path: /app/apps/vrf/setup.py
+x-lucid-file-type: python
+
+Setup script for native VRF extension
+"""
+
+from setuptools import setup, Extension
+
+# Define the extension module
+vrf_native = Extension(
+    'vrf_native',
+    sources=[
+        'src/vrf.c',
+        'src/ecvrf.c',
+        'src/ed25519.c',
+        'src/alias.c'
+    ],
+    include_dirs=[
+        'src/'
+    ],
+    libraries=['crypto'],
+    library_dirs=[],
+    extra_compile_args=[
+        '-O3',
+        '-Wall',
+        '-Wextra',
+        '-std=c99',
+        '-fPIC'
+    ],
+    extra_link_args=['-shared']
+)
+
+setup(
+    name='vrf-native',
+    version='0.1.0',
+    description='Native VRF extension for Lucid RDP',
+    ext_modules=[vrf_native],
+    python_requires='>=3.8',
+    classifiers=[
+        'Development Status :: 3 - Alpha',
+        'Intended Audience :: Developers',
+        'License :: OSI Approved :: MIT License',
+        'Programming Language :: C',
+        'Programming Language :: Python :: 3',
+        'Programming Language :: Python :: 3.8',
+        'Programming Language :: Python :: 3.9',
+        'Programming Language :: Python :: 3.10',
+        'Programming Language :: Python :: 3.11',
+    ],
+)
@@ -0,0 +1,13 @@
+# VRF Source Module
+# VRF native source code components
+
+"""
+File: /app/apps/vrf/src/__init__.py
+x-lucid-file-path: /app/apps/vrf/src/__init__.py
+x-lucid-file-type: python
+
+VRF Source package for Lucid RDP.
+Contains VRF native source code and C implementations.
+"""
+
+__all__ = []
@@ -0,0 +1,103 @@
+#include "alias.h"
+#include <stdlib.h>
+#include <openssl/sha.h>
+
+typedef unsigned __int128 uint128_t;
+
+int alias_build(alias_table_t *table, const uint64_t *weights, size_t count) {
+    uint64_t *scaled = malloc(count * sizeof(uint64_t));
+    uint32_t *small = malloc(count * sizeof(uint32_t));
+    uint32_t *large = malloc(count * sizeof(uint32_t));
+    size_t small_len = 0, large_len = 0;
+
+    table->count = count;
+    table->total = 0;
+    table->threshold = malloc(count * sizeof(uint64_t));
+    table->alias = malloc(count * sizeof(uint32_t));
+    if (scaled == NULL || small == NULL || large == NULL || table->threshold == NULL || table->alias == NULL) {
+        free(scaled);
+        free(small);
+        free(large);
+        alias_free(table);
+        return -1;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        table->total += weights[i];
+    }
+
+    // Every bucket holds exactly total once weights are scaled by count
+    for (size_t i = 0; i < count; i++) {
+        scaled[i] = weights[i] * count;
+        if (scaled[i] < table->total) {
+            small[small_len++] = (uint32_t)i;
+        } else {
+            large[large_len++] = (uint32_t)i;
+        }
+    }
+
+    while (small_len > 0 && large_len > 0) {
+        uint32_t s = small[--small_len];
+        uint32_t l = large[--large_len];
+
+        table->threshold[s] = scaled[s];
+        table->alias[s] = l;
+        scaled[l] -= table->total - scaled[s];
+        if (scaled[l] < table->total) {
+            small[small_len++] = l;
+        } else {
+            large[large_len++] = l;
+        }
+    }
+    while (large_len > 0) {
+        uint32_t l = large[--large_len];
+        table->threshold[l] = table->total;
+        table->alias[l] = l;
+    }
+    while (small_len > 0) {
+        uint32_t s = small[--small_len];
+        table->threshold[s] = table->total;
+        table->alias[s] = s;
+    }
+
+    free(scaled);
+    free(small);
+    free(large);
+    return 0;
+}
+
+void alias_free(alias_table_t *table) {
+    free(table->threshold);
+    free(table->alias);
+    table->threshold = NULL;
+    table->alias = NULL;
+    table->count = 0;
+}
+
+size_t alias_sample(const alias_table_t *table, uint64_t bucket_bits, uint64_t coin_bits) {
+    size_t bucket = (size_t)(((uint128_t)bucket_bits * table->count) >> 64);
+    uint64_t coin = (uint64_t)(((uint128_t)coin_bits * table->total) >> 64);
+    return coin < table->threshold[bucket] ? bucket : table->alias[bucket];
+}
+
+static uint64_t load64_le(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+size_t alias_draw(const alias_table_t *table, const uint8_t *beta, size_t beta_len, uint32_t counter) {
+    uint8_t counter_bytes[4] = {
+        (uint8_t)counter, (uint8_t)(counter >> 8), (uint8_t)(counter >> 16), (uint8_t)(counter >> 24)
+    };
+    uint8_t digest[SHA512_DIGEST_LENGTH];
+    SHA512_CTX ctx;
+
+    SHA512_Init(&ctx);
+    SHA512_Update(&ctx, beta, beta_len);
+    SHA512_Update(&ctx, counter_bytes, sizeof(counter_bytes));
+    SHA512_Final(digest, &ctx);
+    return alias_sample(table, load64_le(digest), load64_le(digest + 8));
+}
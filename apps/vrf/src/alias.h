@@ -0,0 +1,28 @@
+#ifndef ALIAS_H
+#define ALIAS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Walker/Vose alias table over integer weights. Bucket i keeps itself when
+// the coin falls below threshold[i] and yields alias[i] otherwise, so one
+// draw costs two multiplications regardless of the number of entries.
+typedef struct {
+    size_t count;
+    uint64_t total;         // Sum of weights; coins are uniform in [0, total)
+    uint64_t *threshold;
+    uint32_t *alias;
+} alias_table_t;
+
+// weights must be positive with count * max(weight) below 2^64.
+// Returns -1 when out of memory.
+int alias_build(alias_table_t *table, const uint64_t *weights, size_t count);
+void alias_free(alias_table_t *table);
+
+size_t alias_sample(const alias_table_t *table, uint64_t bucket_bits, uint64_t coin_bits);
+
+// Draw number counter for a VRF output: SHA-512(beta | le32(counter)) split
+// into bucket and coin words
+size_t alias_draw(const alias_table_t *table, const uint8_t *beta, size_t beta_len, uint32_t counter);
+
+#endif // ALIAS_H
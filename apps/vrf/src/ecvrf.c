@@ -0,0 +1,194 @@
+#include "ecvrf.h"
+#include "ed25519.h"
+#include <string.h>
+#include <openssl/sha.h>
+
+// Encoding of the neutral element (x = 0, y = 1)
+static const uint8_t IDENTITY_POINT[ED25519_POINT_SIZE] = {1};
+
+static void expand_secret(uint8_t scalar[ED25519_SCALAR_SIZE], uint8_t prefix[32],
+                          const uint8_t secret_key[ECVRF_SECRET_KEY_SIZE]) {
+    uint8_t digest[SHA512_DIGEST_LENGTH];
+
+    SHA512(secret_key, ECVRF_SECRET_KEY_SIZE, digest);
+    memcpy(scalar, digest, ED25519_SCALAR_SIZE);
+    scalar[0] &= 248;
+    scalar[31] &= 127;
+    scalar[31] |= 64;
+    memcpy(prefix, digest + 32, 32);
+}
+
+// Try-and-increment: the first counter whose hash decodes as a point wins
+static int encode_to_curve(ge25519_t *h, const uint8_t public_key[ECVRF_PUBLIC_KEY_SIZE],
+                           const uint8_t *alpha, size_t alpha_len) {
+    static const uint8_t domain[2] = {ECVRF_SUITE, 0x01};
+    static const uint8_t trailer = 0x00;
+    uint8_t digest[SHA512_DIGEST_LENGTH];
+    ge25519_t point;
+
+    for (int counter = 0; counter < 256; counter++) {
+        uint8_t counter_byte = (uint8_t)counter;
+        SHA512_CTX ctx;
+        SHA512_Init(&ctx);
+        SHA512_Update(&ctx, domain, sizeof(domain));
+        SHA512_Update(&ctx, public_key, ECVRF_PUBLIC_KEY_SIZE);
+        SHA512_Update(&ctx, alpha, alpha_len);
+        SHA512_Update(&ctx, &counter_byte, 1);
+        SHA512_Update(&ctx, &trailer, 1);
+        SHA512_Final(digest, &ctx);
+
+        if (ge25519_decode(&point, digest) == 0) {
+            ge25519_mul_cofactor(h, &point);
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static void challenge(uint8_t c[ED25519_SCALAR_SIZE], const uint8_t public_key[ECVRF_PUBLIC_KEY_SIZE],
+                      const uint8_t h[ED25519_POINT_SIZE], const uint8_t gamma[ED25519_POINT_SIZE],
+                      const ge25519_t *u, const ge25519_t *v) {
+    static const uint8_t domain[2] = {ECVRF_SUITE, 0x02};
+    static const uint8_t trailer = 0x00;
+    uint8_t u_bytes[ED25519_POINT_SIZE], v_bytes[ED25519_POINT_SIZE];
+    uint8_t digest[SHA512_DIGEST_LENGTH];
+    SHA512_CTX ctx;
+
+    ge25519_encode(u_bytes, u);
+    ge25519_encode(v_bytes, v);
+
+    SHA512_Init(&ctx);
+    SHA512_Update(&ctx, domain, sizeof(domain));
+    SHA512_Update(&ctx, public_key, ECVRF_PUBLIC_KEY_SIZE);
+    SHA512_Update(&ctx, h, ED25519_POINT_SIZE);
+    SHA512_Update(&ctx, gamma, ED25519_POINT_SIZE);
+    SHA512_Update(&ctx, u_bytes, ED25519_POINT_SIZE);
+    SHA512_Update(&ctx, v_bytes, ED25519_POINT_SIZE);
+    SHA512_Update(&ctx, &trailer, 1);
+    SHA512_Final(digest, &ctx);
+
+    // Challenge is the first 16 bytes as a little-endian scalar
+    memset(c, 0, ED25519_SCALAR_SIZE);
+    memcpy(c, digest, ECVRF_CHALLENGE_SIZE);
+}
+
+// a*P - b*Q
+static void double_scalarmult_sub(ge25519_t *r, const uint8_t a[ED25519_SCALAR_SIZE], const ge25519_t *p,
+                                  const uint8_t b[ED25519_SCALAR_SIZE], const ge25519_t *q) {
+    ge25519_t ap, bq;
+
+    ge25519_scalarmult(&ap, a, p);
+    ge25519_scalarmult(&bq, b, q);
+    ge25519_negate(&bq, &bq);
+    ge25519_add(r, &ap, &bq);
+}
+
+void ecvrf_public_key(uint8_t public_key[ECVRF_PUBLIC_KEY_SIZE],
+                      const uint8_t secret_key[ECVRF_SECRET_KEY_SIZE]) {
+    uint8_t x[ED25519_SCALAR_SIZE], prefix[32];
+    ge25519_t base, y;
+
+    expand_secret(x, prefix, secret_key);
+    ge25519_base(&base);
+    ge25519_scalarmult(&y, x, &base);
+    ge25519_encode(public_key, &y);
+}
+
+int ecvrf_prove(uint8_t proof[ECVRF_PROOF_SIZE], const uint8_t secret_key[ECVRF_SECRET_KEY_SIZE],
+                const uint8_t *alpha, size_t alpha_len) {
+    uint8_t x[ED25519_SCALAR_SIZE], prefix[32], public_key[ECVRF_PUBLIC_KEY_SIZE];
+    uint8_t h_bytes[ED25519_POINT_SIZE], gamma_bytes[ED25519_POINT_SIZE];
+    uint8_t digest[SHA512_DIGEST_LENGTH], k[ED25519_SCALAR_SIZE], c[ED25519_SCALAR_SIZE];
+    ge25519_t base, y, h, gamma, u, v;
+    SHA512_CTX ctx;
+
+    expand_secret(x, prefix, secret_key);
+    ge25519_base(&base);
+    ge25519_scalarmult(&y, x, &base);
+    ge25519_encode(public_key, &y);
+
+    if (encode_to_curve(&h, public_key, alpha, alpha_len) < 0) {
+        return -1;
+    }
+    ge25519_encode(h_bytes, &h);
+    ge25519_scalarmult(&gamma, x, &h);
+    ge25519_encode(gamma_bytes, &gamma);
+
+    // RFC 8032 style nonce from the second half of the expanded key
+    SHA512_Init(&ctx);
+    SHA512_Update(&ctx, prefix, sizeof(prefix));
+    SHA512_Update(&ctx, h_bytes, sizeof(h_bytes));
+    SHA512_Final(digest, &ctx);
+    sc25519_reduce(k, digest, sizeof(digest));
+
+    ge25519_scalarmult(&u, k, &base);
+    ge25519_scalarmult(&v, k, &h);
+    challenge(c, public_key, h_bytes, gamma_bytes, &u, &v);
+
+    memcpy(proof, gamma_bytes, ED25519_POINT_SIZE);
+    memcpy(proof + ED25519_POINT_SIZE, c, ECVRF_CHALLENGE_SIZE);
+    sc25519_muladd(proof + ED25519_POINT_SIZE + ECVRF_CHALLENGE_SIZE, c, x, k);
+
+    memset(x, 0, sizeof(x));
+    memset(prefix, 0, sizeof(prefix));
+    memset(k, 0, sizeof(k));
+    return 0;
+}
+
+int ecvrf_proof_to_hash(uint8_t beta[ECVRF_OUTPUT_SIZE], const uint8_t proof[ECVRF_PROOF_SIZE]) {
+    static const uint8_t domain[2] = {ECVRF_SUITE, 0x03};
+    static const uint8_t trailer = 0x00;
+    uint8_t point_bytes[ED25519_POINT_SIZE];
+    ge25519_t gamma;
+    SHA512_CTX ctx;
+
+    if (ge25519_decode(&gamma, proof) < 0) {
+        return -1;
+    }
+    ge25519_mul_cofactor(&gamma, &gamma);
+    ge25519_encode(point_bytes, &gamma);
+
+    SHA512_Init(&ctx);
+    SHA512_Update(&ctx, domain, sizeof(domain));
+    SHA512_Update(&ctx, point_bytes, sizeof(point_bytes));
+    SHA512_Update(&ctx, &trailer, 1);
+    SHA512_Final(beta, &ctx);
+    return 0;
+}
+
+int ecvrf_verify(uint8_t beta[ECVRF_OUTPUT_SIZE], const uint8_t public_key[ECVRF_PUBLIC_KEY_SIZE],
+                 const uint8_t proof[ECVRF_PROOF_SIZE], const uint8_t *alpha, size_t alpha_len) {
+    uint8_t point_bytes[ED25519_POINT_SIZE], c[ED25519_SCALAR_SIZE], expected[ED25519_SCALAR_SIZE];
+    const uint8_t *s = proof + ED25519_POINT_SIZE + ECVRF_CHALLENGE_SIZE;
+    ge25519_t base, y, gamma, h, u, v;
+
+    if (ge25519_decode(&y, public_key) < 0) {
+        return -1;
+    }
+    ge25519_mul_cofactor(&u, &y);
+    ge25519_encode(point_bytes, &u);
+    if (memcmp(point_bytes, IDENTITY_POINT, sizeof(point_bytes)) == 0) {
+        return -1;  // Small-order key
+    }
+
+    if (ge25519_decode(&gamma, proof) < 0 || !sc25519_is_canonical(s)) {
+        return -1;
+    }
+    memset(c, 0, sizeof(c));
+    memcpy(c, proof + ED25519_POINT_SIZE, ECVRF_CHALLENGE_SIZE);
+
+    if (encode_to_curve(&h, public_key, alpha, alpha_len) < 0) {
+        return -1;
+    }
+    ge25519_encode(point_bytes, &h);
+
+    ge25519_base(&base);
+    double_scalarmult_sub(&u, s, &base, c, &y);
+    double_scalarmult_sub(&v, s, &h, c, &gamma);
+    challenge(expected, public_key, point_bytes, proof, &u, &v);
+
+    if (memcmp(expected, c, ECVRF_CHALLENGE_SIZE) != 0) {
+        return -1;
+    }
+    return ecvrf_proof_to_hash(beta, proof);
+}
@@ -0,0 +1,30 @@
+#ifndef ECVRF_H
+#define ECVRF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ECVRF-EDWARDS25519-SHA512-TAI (RFC 9381)
+#define ECVRF_SUITE 0x03
+#define ECVRF_SECRET_KEY_SIZE 32
+#define ECVRF_PUBLIC_KEY_SIZE 32
+#define ECVRF_PROOF_SIZE 80          // Gamma | c (16 bytes) | s
+#define ECVRF_OUTPUT_SIZE 64
+#define ECVRF_CHALLENGE_SIZE 16
+
+// Same key pair as RFC 8032 Ed25519
+void ecvrf_public_key(uint8_t public_key[ECVRF_PUBLIC_KEY_SIZE],
+                      const uint8_t secret_key[ECVRF_SECRET_KEY_SIZE]);
+
+// 0 on success, -1 if alpha hashes to no curve point (probability 2^-256)
+int ecvrf_prove(uint8_t proof[ECVRF_PROOF_SIZE], const uint8_t secret_key[ECVRF_SECRET_KEY_SIZE],
+                const uint8_t *alpha, size_t alpha_len);
+
+// -1 if Gamma does not decode
+int ecvrf_proof_to_hash(uint8_t beta[ECVRF_OUTPUT_SIZE], const uint8_t proof[ECVRF_PROOF_SIZE]);
+
+// 0 and beta set for a valid proof, -1 otherwise. Small-order keys are rejected.
+int ecvrf_verify(uint8_t beta[ECVRF_OUTPUT_SIZE], const uint8_t public_key[ECVRF_PUBLIC_KEY_SIZE],
+                 const uint8_t proof[ECVRF_PROOF_SIZE], const uint8_t *alpha, size_t alpha_len);
+
+#endif // ECVRF_H
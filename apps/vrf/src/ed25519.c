@@ -0,0 +1,468 @@
+#include "ed25519.h"
+#include <string.h>
+
+typedef unsigned __int128 uint128_t;
+
+#define MASK51 0x7ffffffffffffULL
+
+// Little-endian encodings of the curve constants
+static const uint8_t D2_BYTES[32] = {
+    0x59, 0xf1, 0xb2, 0x26, 0x94, 0x9b, 0xd6, 0xeb, 0x56, 0xb1, 0x83, 0x82, 0x9a, 0x14, 0xe0, 0x00,
+    0x30, 0xd1, 0xf3, 0xee, 0xf2, 0x80, 0x8e, 0x19, 0xe7, 0xfc, 0xdf, 0x56, 0xdc, 0xd9, 0x06, 0x24
+};
+static const uint8_t D_BYTES[32] = {
+    0xa3, 0x78, 0x59, 0x13, 0xca, 0x4d, 0xeb, 0x75, 0xab, 0xd8, 0x41, 0x41, 0x4d, 0x0a, 0x70, 0x00,
+    0x98, 0xe8, 0x79, 0x77, 0x79, 0x40, 0xc7, 0x8c, 0x73, 0xfe, 0x6f, 0x2b, 0xee, 0x6c, 0x03, 0x52
+};
+static const uint8_t SQRTM1_BYTES[32] = {
+    0xb0, 0xa0, 0x0e, 0x4a, 0x27, 0x1b, 0xee, 0xc4, 0x78, 0xe4, 0x2f, 0xad, 0x06, 0x18, 0x43, 0x2f,
+    0xa7, 0xd7, 0xfb, 0x3d, 0x99, 0x00, 0x4d, 0x2b, 0x0b, 0xdf, 0xc1, 0x4f, 0x80, 0x24, 0x83, 0x2b
+};
+static const uint8_t BASE_BYTES[32] = {
+    0x58, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66,
+    0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66
+};
+static const uint8_t L_BYTES[32] = {
+    0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10
+};
+
+// Field arithmetic
+
+static uint64_t load64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+static void store64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static void fe_carry(fe25519 h) {
+    h[1] += h[0] >> 51; h[0] &= MASK51;
+    h[2] += h[1] >> 51; h[1] &= MASK51;
+    h[3] += h[2] >> 51; h[2] &= MASK51;
+    h[4] += h[3] >> 51; h[3] &= MASK51;
+    h[0] += 19 * (h[4] >> 51); h[4] &= MASK51;
+}
+
+static void fe_frombytes(fe25519 h, const uint8_t s[32]) {
+    h[0] = load64(s) & MASK51;
+    h[1] = (load64(s + 6) >> 3) & MASK51;
+    h[2] = (load64(s + 12) >> 6) & MASK51;
+    h[3] = (load64(s + 19) >> 1) & MASK51;
+    h[4] = (load64(s + 24) >> 12) & MASK51;
+}
+
+static void fe_tobytes(uint8_t s[32], const fe25519 h) {
+    fe25519 t;
+    memcpy(t, h, sizeof(t));
+    fe_carry(t);
+    fe_carry(t);
+
+    // t is now below 2^255; adding 19 carries into bit 255 exactly when t >= p
+    t[0] += 19;
+    fe_carry(t);
+    t[0] += 0x8000000000000ULL - 19;
+    t[1] += 0x8000000000000ULL - 1;
+    t[2] += 0x8000000000000ULL - 1;
+    t[3] += 0x8000000000000ULL - 1;
+    t[4] += 0x8000000000000ULL - 1;
+    t[1] += t[0] >> 51; t[0] &= MASK51;
+    t[2] += t[1] >> 51; t[1] &= MASK51;
+    t[3] += t[2] >> 51; t[2] &= MASK51;
+    t[4] += t[3] >> 51; t[3] &= MASK51;
+    t[4] &= MASK51;
+
+    store64(s, t[0] | (t[1] << 51));
+    store64(s + 8, (t[1] >> 13) | (t[2] << 38));
+    store64(s + 16, (t[2] >> 26) | (t[3] << 25));
+    store64(s + 24, (t[3] >> 39) | (t[4] << 12));
+}
+
+static void fe_zero(fe25519 h) {
+    memset(h, 0, sizeof(fe25519));
+}
+
+static void fe_one(fe25519 h) {
+    fe_zero(h);
+    h[0] = 1;
+}
+
+static void fe_add(fe25519 h, const fe25519 f, const fe25519 g) {
+    for (int i = 0; i < 5; i++) {
+        h[i] = f[i] + g[i];
+    }
+    fe_carry(h);
+}
+
+static void fe_sub(fe25519 h, const fe25519 f, const fe25519 g) {
+    // Add 4p first so no limb goes negative
+    h[0] = f[0] + 0x1fffffffffffb4ULL - g[0];
+    h[1] = f[1] + 0x1ffffffffffffcULL - g[1];
+    h[2] = f[2] + 0x1ffffffffffffcULL - g[2];
+    h[3] = f[3] + 0x1ffffffffffffcULL - g[3];
+    h[4] = f[4] + 0x1ffffffffffffcULL - g[4];
+    fe_carry(h);
+}
+
+static void fe_neg(fe25519 h, const fe25519 f) {
+    fe25519 zero;
+    fe_zero(zero);
+    fe_sub(h, zero, f);
+}
+
+static void fe_mul(fe25519 h, const fe25519 f, const fe25519 g) {
+    uint64_t g1_19 = 19 * g[1], g2_19 = 19 * g[2], g3_19 = 19 * g[3], g4_19 = 19 * g[4];
+    uint128_t r0 = (uint128_t)f[0] * g[0] + (uint128_t)f[1] * g4_19 + (uint128_t)f[2] * g3_19
+                 + (uint128_t)f[3] * g2_19 + (uint128_t)f[4] * g1_19;
+    uint128_t r1 = (uint128_t)f[0] * g[1] + (uint128_t)f[1] * g[0] + (uint128_t)f[2] * g4_19
+                 + (uint128_t)f[3] * g3_19 + (uint128_t)f[4] * g2_19;
+    uint128_t r2 = (uint128_t)f[0] * g[2] + (uint128_t)f[1] * g[1] + (uint128_t)f[2] * g[0]
+                 + (uint128_t)f[3] * g4_19 + (uint128_t)f[4] * g3_19;
+    uint128_t r3 = (uint128_t)f[0] * g[3] + (uint128_t)f[1] * g[2] + (uint128_t)f[2] * g[1]
+                 + (uint128_t)f[3] * g[0] + (uint128_t)f[4] * g4_19;
+    uint128_t r4 = (uint128_t)f[0] * g[4] + (uint128_t)f[1] * g[3] + (uint128_t)f[2] * g[2]
+                 + (uint128_t)f[3] * g[1] + (uint128_t)f[4] * g[0];
+
+    r1 += (uint64_t)(r0 >> 51);
+    r2 += (uint64_t)(r1 >> 51);
+    r3 += (uint64_t)(r2 >> 51);
+    r4 += (uint64_t)(r3 >> 51);
+    h[0] = (uint64_t)r0 & MASK51;
+    h[1] = (uint64_t)r1 & MASK51;
+    h[2] = (uint64_t)r2 & MASK51;
+    h[3] = (uint64_t)r3 & MASK51;
+    h[4] = (uint64_t)r4 & MASK51;
+    h[0] += 19 * (uint64_t)(r4 >> 51);
+    h[1] += h[0] >> 51;
+    h[0] &= MASK51;
+}
+
+static void fe_sq(fe25519 h, const fe25519 f) {
+    fe_mul(h, f, f);
+}
+
+static void fe_sqn(fe25519 h, const fe25519 f, int n) {
+    fe_sq(h, f);
+    for (int i = 1; i < n; i++) {
+        fe_sq(h, h);
+    }
+}
+
+// Shared addition chain: z^(2^250 - 1) and z^11
+static void fe_pow2_250_1(fe25519 out, fe25519 z11, const fe25519 z) {
+    fe25519 z2, z9, t, z2_5_0, z2_10_0, z2_20_0, z2_50_0, z2_100_0;
+
+    fe_sq(z2, z);
+    fe_sqn(t, z2, 2);
+    fe_mul(z9, t, z);
+    fe_mul(z11, z9, z2);
+    fe_sq(t, z11);
+    fe_mul(z2_5_0, t, z9);
+    fe_sqn(t, z2_5_0, 5);
+    fe_mul(z2_10_0, t, z2_5_0);
+    fe_sqn(t, z2_10_0, 10);
+    fe_mul(z2_20_0, t, z2_10_0);
+    fe_sqn(t, z2_20_0, 20);
+    fe_mul(t, t, z2_20_0);
+    fe_sqn(t, t, 10);
+    fe_mul(z2_50_0, t, z2_10_0);
+    fe_sqn(t, z2_50_0, 50);
+    fe_mul(z2_100_0, t, z2_50_0);
+    fe_sqn(t, z2_100_0, 100);
+    fe_mul(t, t, z2_100_0);
+    fe_sqn(t, t, 50);
+    fe_mul(out, t, z2_50_0);
+}
+
+static void fe_invert(fe25519 out, const fe25519 z) {
+    fe25519 t, z11;
+    fe_pow2_250_1(t, z11, z);
+    fe_sqn(t, t, 5);
+    fe_mul(out, t, z11);
+}
+
+static void fe_pow22523(fe25519 out, const fe25519 z) {
+    fe25519 t, z11;
+    fe_pow2_250_1(t, z11, z);
+    fe_sqn(t, t, 2);
+    fe_mul(out, t, z);
+}
+
+static int fe_equal(const fe25519 f, const fe25519 g) {
+    uint8_t a[32], b[32];
+    fe_tobytes(a, f);
+    fe_tobytes(b, g);
+    return memcmp(a, b, 32) == 0;
+}
+
+static int fe_is_negative(const fe25519 f) {
+    uint8_t s[32];
+    fe_tobytes(s, f);
+    return s[0] & 1;
+}
+
+static void fe_cmov(fe25519 f, const fe25519 g, unsigned int flag) {
+    uint64_t mask = (uint64_t)0 - (uint64_t)flag;
+    for (int i = 0; i < 5; i++) {
+        f[i] ^= mask & (f[i] ^ g[i]);
+    }
+}
+
+// Group operations
+
+void ge25519_identity(ge25519_t *r) {
+    fe_zero(r->X);
+    fe_one(r->Y);
+    fe_one(r->Z);
+    fe_zero(r->T);
+}
+
+void ge25519_base(ge25519_t *r) {
+    ge25519_decode(r, BASE_BYTES);
+}
+
+int ge25519_decode(ge25519_t *r, const uint8_t s[ED25519_POINT_SIZE]) {
+    uint8_t y_bytes[32], check[32];
+    fe25519 d, u, v, v3, vxx, x;
+    int sign = s[31] >> 7;
+
+    memcpy(y_bytes, s, 32);
+    y_bytes[31] &= 0x7f;
+    fe_frombytes(r->Y, y_bytes);
+    fe_tobytes(check, r->Y);
+    if (memcmp(check, y_bytes, 32) != 0) {
+        return -1;  // y >= p
+    }
+
+    // x^2 = (y^2 - 1) / (d y^2 + 1)
+    fe_frombytes(d, D_BYTES);
+    fe_one(r->Z);
+    fe_sq(u, r->Y);
+    fe_mul(v, u, d);
+    fe_sub(u, u, r->Z);
+    fe_add(v, v, r->Z);
+
+    fe_sq(v3, v);
+    fe_mul(v3, v3, v);
+    fe_sq(x, v3);
+    fe_mul(x, x, v);
+    fe_mul(x, x, u);
+    fe_pow22523(x, x);
+    fe_mul(x, x, v3);
+    fe_mul(x, x, u);
+
+    fe_sq(vxx, x);
+    fe_mul(vxx, vxx, v);
+    if (!fe_equal(vxx, u)) {
+        fe25519 neg_u, sqrtm1;
+        fe_neg(neg_u, u);
+        if (!fe_equal(vxx, neg_u)) {
+            return -1;
+        }
+        fe_frombytes(sqrtm1, SQRTM1_BYTES);
+        fe_mul(x, x, sqrtm1);
+    }
+
+    uint8_t x_bytes[32];
+    fe_tobytes(x_bytes, x);
+    if (sign && memcmp(x_bytes, (const uint8_t[32]){0}, 32) == 0) {
+        return -1;
+    }
+    if ((x_bytes[0] & 1) != sign) {
+        fe_neg(x, x);
+    }
+
+    memcpy(r->X, x, sizeof(fe25519));
+    fe_mul(r->T, r->X, r->Y);
+    return 0;
+}
+
+void ge25519_encode(uint8_t s[ED25519_POINT_SIZE], const ge25519_t *p) {
+    fe25519 zinv, x, y;
+    fe_invert(zinv, p->Z);
+    fe_mul(x, p->X, zinv);
+    fe_mul(y, p->Y, zinv);
+    fe_tobytes(s, y);
+    s[31] |= (uint8_t)(fe_is_negative(x) << 7);
+}
+
+void ge25519_add(ge25519_t *r, const ge25519_t *p, const ge25519_t *q) {
+    fe25519 a, b, c, d, e, f, g, h, t;
+
+    fe_sub(a, p->Y, p->X);
+    fe_sub(t, q->Y, q->X);
+    fe_mul(a, a, t);
+    fe_add(b, p->Y, p->X);
+    fe_add(t, q->Y, q->X);
+    fe_mul(b, b, t);
+    fe_frombytes(t, D2_BYTES);
+    fe_mul(c, p->T, t);
+    fe_mul(c, c, q->T);
+    fe_mul(d, p->Z, q->Z);
+    fe_add(d, d, d);
+    fe_sub(e, b, a);
+    fe_sub(f, d, c);
+    fe_add(g, d, c);
+    fe_add(h, b, a);
+
+    fe_mul(r->X, e, f);
+    fe_mul(r->Y, g, h);
+    fe_mul(r->T, e, h);
+    fe_mul(r->Z, f, g);
+}
+
+void ge25519_double(ge25519_t *r, const ge25519_t *p) {
+    fe25519 a, b, c, e, f, g, h;
+
+    fe_sq(a, p->X);
+    fe_sq(b, p->Y);
+    fe_sq(c, p->Z);
+    fe_add(c, c, c);
+    fe_add(h, a, b);
+    fe_add(e, p->X, p->Y);
+    fe_sq(e, e);
+    fe_sub(e, h, e);
+    fe_sub(g, a, b);
+    fe_add(f, c, g);
+
+    fe_mul(r->X, e, f);
+    fe_mul(r->Y, g, h);
+    fe_mul(r->T, e, h);
+    fe_mul(r->Z, f, g);
+}
+
+void ge25519_negate(ge25519_t *r, const ge25519_t *p) {
+    fe_neg(r->X, p->X);
+    memcpy(r->Y, p->Y, sizeof(fe25519));
+    memcpy(r->Z, p->Z, sizeof(fe25519));
+    fe_neg(r->T, p->T);
+}
+
+void ge25519_mul_cofactor(ge25519_t *r, const ge25519_t *p) {
+    ge25519_double(r, p);
+    ge25519_double(r, r);
+    ge25519_double(r, r);
+}
+
+void ge25519_scalarmult(ge25519_t *r, const uint8_t scalar[ED25519_SCALAR_SIZE], const ge25519_t *p) {
+    ge25519_t acc, sum;
+
+    ge25519_identity(&acc);
+    for (int i = 255; i >= 0; i--) {
+        unsigned int bit = (scalar[i >> 3] >> (i & 7)) & 1;
+        ge25519_double(&acc, &acc);
+        ge25519_add(&sum, &acc, p);
+        fe_cmov(acc.X, sum.X, bit);
+        fe_cmov(acc.Y, sum.Y, bit);
+        fe_cmov(acc.Z, sum.Z, bit);
+        fe_cmov(acc.T, sum.T, bit);
+    }
+    *r = acc;
+}
+
+// Scalar arithmetic in 32-bit limbs; nine limbs hold a value below 256 L
+
+#define SC_LIMBS 9
+
+static void sc_load(uint32_t out[SC_LIMBS], const uint8_t in[32]) {
+    memset(out, 0, SC_LIMBS * sizeof(uint32_t));
+    for (int i = 0; i < 32; i++) {
+        out[i / 4] |= (uint32_t)in[i] << (8 * (i % 4));
+    }
+}
+
+// r -= m when r >= m, selected with a mask rather than a branch
+static void sc_cond_sub(uint32_t r[SC_LIMBS], const uint32_t m[SC_LIMBS]) {
+    uint32_t t[SC_LIMBS];
+    uint64_t borrow = 0;
+
+    for (int j = 0; j < SC_LIMBS; j++) {
+        uint64_t diff = (uint64_t)r[j] - m[j] - borrow;
+        t[j] = (uint32_t)diff;
+        borrow = diff >> 63;
+    }
+    uint32_t keep = (uint32_t)0 - (uint32_t)borrow;
+    for (int j = 0; j < SC_LIMBS; j++) {
+        r[j] = (r[j] & keep) | (t[j] & ~keep);
+    }
+}
+
+void sc25519_reduce(uint8_t out[ED25519_SCALAR_SIZE], const uint8_t *in, size_t len) {
+    uint32_t l_shifted[8][SC_LIMBS];
+    uint32_t r[SC_LIMBS] = {0};
+
+    sc_load(l_shifted[0], L_BYTES);
+    for (int k = 1; k < 8; k++) {
+        uint32_t carry = 0;
+        for (int j = 0; j < SC_LIMBS; j++) {
+            l_shifted[k][j] = (l_shifted[k - 1][j] << 1) | carry;
+            carry = l_shifted[k - 1][j] >> 31;
+        }
+    }
+
+    // Horner over bytes from the most significant: r = (r * 256 + byte) mod L
+    for (size_t i = len; i-- > 0;) {
+        uint64_t carry = in[i];
+        for (int j = 0; j < SC_LIMBS; j++) {
+            uint64_t v = ((uint64_t)r[j] << 8) + carry;
+            r[j] = (uint32_t)v;
+            carry = v >> 32;
+        }
+        for (int k = 7; k >= 0; k--) {
+            sc_cond_sub(r, l_shifted[k]);
+        }
+    }
+
+    for (int i = 0; i < 32; i++) {
+        out[i] = (uint8_t)(r[i / 4] >> (8 * (i % 4)));
+    }
+}
+
+void sc25519_muladd(uint8_t out[ED25519_SCALAR_SIZE], const uint8_t a[ED25519_SCALAR_SIZE],
+                    const uint8_t b[ED25519_SCALAR_SIZE], const uint8_t c[ED25519_SCALAR_SIZE]) {
+    uint32_t x[SC_LIMBS], y[SC_LIMBS], z[SC_LIMBS];
+    uint32_t product[16] = {0};
+    uint8_t wide[64];
+
+    sc_load(x, a);
+    sc_load(y, b);
+    sc_load(z, c);
+
+    for (int i = 0; i < 8; i++) {
+        uint64_t carry = 0;
+        for (int j = 0; j < 8; j++) {
+            uint64_t v = (uint64_t)x[i] * y[j] + product[i + j] + carry;
+            product[i + j] = (uint32_t)v;
+            carry = v >> 32;
+        }
+        product[i + 8] = (uint32_t)carry;
+    }
+
+    uint64_t carry = 0;
+    for (int i = 0; i < 16; i++) {
+        uint64_t v = (uint64_t)product[i] + (i < 8 ? z[i] : 0) + carry;
+        product[i] = (uint32_t)v;
+        carry = v >> 32;
+    }
+
+    for (int i = 0; i < 64; i++) {
+        wide[i] = (uint8_t)(product[i / 4] >> (8 * (i % 4)));
+    }
+    sc25519_reduce(out, wide, sizeof(wide));
+}
+
+int sc25519_is_canonical(const uint8_t s[ED25519_SCALAR_SIZE]) {
+    for (int i = 31; i >= 0; i--) {
+        if (s[i] != L_BYTES[i]) {
+            return s[i] < L_BYTES[i];
+        }
+    }
+    return 0;
+}
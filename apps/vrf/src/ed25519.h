@@ -0,0 +1,42 @@
+#ifndef ED25519_H
+#define ED25519_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ED25519_POINT_SIZE 32
+#define ED25519_SCALAR_SIZE 32
+
+// Field element mod 2^255 - 19 in five 51-bit limbs
+typedef uint64_t fe25519[5];
+
+// Extended twisted Edwards coordinates, x = X/Z, y = Y/Z, x*y = T/Z
+typedef struct {
+    fe25519 X;
+    fe25519 Y;
+    fe25519 Z;
+    fe25519 T;
+} ge25519_t;
+
+void ge25519_identity(ge25519_t *r);
+void ge25519_base(ge25519_t *r);
+
+// RFC 8032 point decoding; -1 for non-canonical y or a y with no x
+int ge25519_decode(ge25519_t *r, const uint8_t s[ED25519_POINT_SIZE]);
+void ge25519_encode(uint8_t s[ED25519_POINT_SIZE], const ge25519_t *p);
+
+void ge25519_add(ge25519_t *r, const ge25519_t *p, const ge25519_t *q);
+void ge25519_double(ge25519_t *r, const ge25519_t *p);
+void ge25519_negate(ge25519_t *r, const ge25519_t *p);
+void ge25519_mul_cofactor(ge25519_t *r, const ge25519_t *p);
+
+// Double-and-always-add over all 256 bits, without secret-dependent branches
+void ge25519_scalarmult(ge25519_t *r, const uint8_t scalar[ED25519_SCALAR_SIZE], const ge25519_t *p);
+
+// Scalars mod L = 2^252 + 27742317777372353535851937790883648493, little-endian
+void sc25519_reduce(uint8_t out[ED25519_SCALAR_SIZE], const uint8_t *in, size_t len);
+void sc25519_muladd(uint8_t out[ED25519_SCALAR_SIZE], const uint8_t a[ED25519_SCALAR_SIZE],
+                    const uint8_t b[ED25519_SCALAR_SIZE], const uint8_t c[ED25519_SCALAR_SIZE]);
+int sc25519_is_canonical(const uint8_t s[ED25519_SCALAR_SIZE]);
+
+#endif // ED25519_H
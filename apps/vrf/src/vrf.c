@@ -0,0 +1,499 @@
+/*
+ * Native VRF extension for Lucid RDP
+ * ECVRF-EDWARDS25519-SHA512-TAI proofs for leader election, and per-epoch
+ * candidate tables that turn a VRF output into a weighted pick in O(1)
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include "vrf.h"
+#include "ecvrf.h"
+#include "alias.h"
+
+typedef struct {
+    PyObject *id;           // str, owned
+    const char *utf8;       // Borrowed from id
+    Py_ssize_t utf8_len;
+    double weight;
+} candidate_t;
+
+typedef struct {
+    PyObject_HEAD
+    candidate_t *candidates;  // Sorted by UTF-8 entity id
+    Py_ssize_t count;
+    alias_table_t table;
+} CandidateTableObject;
+
+static PyTypeObject CandidateTableType;
+
+// Forward declarations
+static PyObject* CandidateTable_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
+static int CandidateTable_init(CandidateTableObject *self, PyObject *args, PyObject *kwds);
+static void CandidateTable_dealloc(CandidateTableObject *self);
+static PyObject* CandidateTable_pick(CandidateTableObject *self, PyObject *args);
+static PyObject* CandidateTable_select(CandidateTableObject *self, PyObject *args, PyObject *kwds);
+static PyObject* CandidateTable_candidates(CandidateTableObject *self, PyObject *args);
+static Py_ssize_t CandidateTable_length(CandidateTableObject *self);
+
+// Method definitions
+static PyMethodDef CandidateTable_methods[] = {
+    {"pick", (PyCFunction)CandidateTable_pick, METH_VARARGS, "Weighted pick of one entity id from a VRF output"},
+    {"select", (PyCFunction)(void(*)(void))CandidateTable_select, METH_VARARGS | METH_KEYWORDS,
+     "Up to count distinct entity ids from a VRF output, skipping those in exclude"},
+    {"candidates", (PyCFunction)CandidateTable_candidates, METH_NOARGS,
+     "[(entity_id, weight), ...] in table order"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PySequenceMethods CandidateTable_as_sequence = {
+    .sq_length = (lenfunc)CandidateTable_length,
+};
+
+// Type definition
+static PyTypeObject CandidateTableType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "vrf_native.CandidateTable",
+    .tp_doc = "Alias table of weighted leader candidates for one epoch",
+    .tp_basicsize = sizeof(CandidateTableObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = CandidateTable_new,
+    .tp_init = (initproc)CandidateTable_init,
+    .tp_dealloc = (destructor)CandidateTable_dealloc,
+    .tp_methods = CandidateTable_methods,
+    .tp_as_sequence = &CandidateTable_as_sequence,
+};
+
+static void clear_candidates(CandidateTableObject *self) {
+    for (Py_ssize_t i = 0; i < self->count; i++) {
+        Py_XDECREF(self->candidates[i].id);
+    }
+    PyMem_Free(self->candidates);
+    self->candidates = NULL;
+    self->count = 0;
+    alias_free(&self->table);
+}
+
+static int compare_ids(const char *a, Py_ssize_t a_len, const char *b, Py_ssize_t b_len) {
+    int cmp = memcmp(a, b, (size_t)(a_len < b_len ? a_len : b_len));
+    if (cmp != 0) {
+        return cmp;
+    }
+    return (a_len > b_len) - (a_len < b_len);
+}
+
+static int compare_candidates(const void *a, const void *b) {
+    const candidate_t *x = a, *y = b;
+    return compare_ids(x->utf8, x->utf8_len, y->utf8, y->utf8_len);
+}
+
+// Index of an entity id in the sorted table, or -1
+static Py_ssize_t find_candidate(CandidateTableObject *self, const char *id, Py_ssize_t id_len) {
+    Py_ssize_t lo = 0, hi = self->count;
+    while (lo < hi) {
+        Py_ssize_t mid = lo + (hi - lo) / 2;
+        int cmp = compare_ids(self->candidates[mid].utf8, self->candidates[mid].utf8_len, id, id_len);
+        if (cmp == 0) {
+            return mid;
+        }
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return -1;
+}
+
+static PyObject* CandidateTable_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
+    CandidateTableObject *self = (CandidateTableObject*)type->tp_alloc(type, 0);
+    if (self == NULL) {
+        return NULL;
+    }
+    self->candidates = NULL;
+    self->count = 0;
+    memset(&self->table, 0, sizeof(self->table));
+    return (PyObject*)self;
+}
+
+static int CandidateTable_init(CandidateTableObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"candidates", NULL};
+    PyObject *candidates;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O", kwlist, &candidates)) {
+        return -1;
+    }
+
+    PyObject *seq = PySequence_Fast(candidates, "candidates must be a sequence of (entity_id, weight)");
+    if (seq == NULL) {
+        return -1;
+    }
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(seq);
+    if (count == 0 || count > MAX_CANDIDATES) {
+        Py_DECREF(seq);
+        PyErr_SetString(PyExc_ValueError, "Candidate count out of range");
+        return -1;
+    }
+
+    clear_candidates(self);
+    self->candidates = PyMem_Calloc((size_t)count, sizeof(candidate_t));
+    uint64_t *weights = PyMem_Malloc((size_t)count * sizeof(uint64_t));
+    if (self->candidates == NULL || weights == NULL) {
+        PyMem_Free(weights);
+        Py_DECREF(seq);
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    double max_weight = 0.0;
+    for (Py_ssize_t i = 0; i < count; i++) {
+        candidate_t *c = &self->candidates[i];
+        PyObject *id;
+
+        if (!PyArg_ParseTuple(PySequence_Fast_GET_ITEM(seq, i), "Ud:candidate", &id, &c->weight)) {
+            goto error;
+        }
+        c->utf8 = PyUnicode_AsUTF8AndSize(id, &c->utf8_len);
+        if (c->utf8 == NULL) {
+            goto error;
+        }
+        Py_INCREF(id);
+        c->id = id;
+        self->count = i + 1;
+
+        if (!isfinite(c->weight) || c->weight <= 0.0) {
+            PyErr_SetString(PyExc_ValueError, "Candidate weights must be positive");
+            goto error;
+        }
+        if (c->weight > max_weight) {
+            max_weight = c->weight;
+        }
+    }
+
+    qsort(self->candidates, (size_t)count, sizeof(candidate_t), compare_candidates);
+    for (Py_ssize_t i = 1; i < count; i++) {
+        if (compare_candidates(&self->candidates[i - 1], &self->candidates[i]) == 0) {
+            PyErr_SetString(PyExc_ValueError, "Duplicate candidate");
+            goto error;
+        }
+    }
+
+    // Integer weights keep the table identical on every peer
+    double scale = WEIGHT_SCALE / max_weight;
+    for (Py_ssize_t i = 0; i < count; i++) {
+        weights[i] = (uint64_t)(self->candidates[i].weight * scale);
+        if (weights[i] == 0) {
+            weights[i] = 1;
+        }
+    }
+    if (alias_build(&self->table, weights, (size_t)count) < 0) {
+        PyErr_NoMemory();
+        goto error;
+    }
+
+    PyMem_Free(weights);
+    Py_DECREF(seq);
+    return 0;
+
+error:
+    PyMem_Free(weights);
+    Py_DECREF(seq);
+    clear_candidates(self);
+    return -1;
+}
+
+static void CandidateTable_dealloc(CandidateTableObject *self) {
+    clear_candidates(self);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static int check_table(CandidateTableObject *self) {
+    if (self->count == 0) {
+        PyErr_SetString(PyExc_RuntimeError, "CandidateTable not initialized");
+        return -1;
+    }
+    return 0;
+}
+
+static PyObject* CandidateTable_pick(CandidateTableObject *self, PyObject *args) {
+    Py_buffer beta;
+
+    if (!PyArg_ParseTuple(args, "y*", &beta)) {
+        return NULL;
+    }
+    if (check_table(self) < 0) {
+        PyBuffer_Release(&beta);
+        return NULL;
+    }
+
+    size_t index = alias_draw(&self->table, beta.buf, (size_t)beta.len, 0);
+    PyBuffer_Release(&beta);
+
+    PyObject *id = self->candidates[index].id;
+    Py_INCREF(id);
+    return id;
+}
+
+static PyObject* CandidateTable_select(CandidateTableObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"beta", "count", "exclude", NULL};
+    Py_buffer beta;
+    Py_ssize_t count = 1;
+    PyObject *exclude = Py_None;
+    PyObject *result = NULL;
+    uint8_t *taken = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|nO", kwlist, &beta, &count, &exclude)) {
+        return NULL;
+    }
+    if (check_table(self) < 0) {
+        goto done;
+    }
+    if (count < 0) {
+        PyErr_SetString(PyExc_ValueError, "count must not be negative");
+        goto done;
+    }
+
+    taken = PyMem_Calloc((size_t)self->count, 1);
+    if (taken == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    Py_ssize_t available = self->count;
+    if (exclude != Py_None) {
+        PyObject *iter = PyObject_GetIter(exclude);
+        PyObject *item;
+        if (iter == NULL) {
+            goto done;
+        }
+        while ((item = PyIter_Next(iter)) != NULL) {
+            Py_ssize_t len;
+            const char *id = PyUnicode_Check(item) ? PyUnicode_AsUTF8AndSize(item, &len) : NULL;
+            if (id == NULL) {
+                if (!PyErr_Occurred()) {
+                    PyErr_SetString(PyExc_TypeError, "exclude must contain entity id strings");
+                }
+                Py_DECREF(item);
+                break;
+            }
+            Py_ssize_t index = find_candidate(self, id, len);
+            if (index >= 0 && !taken[index]) {
+                taken[index] = 1;
+                available--;
+            }
+            Py_DECREF(item);
+        }
+        Py_DECREF(iter);
+        if (PyErr_Occurred()) {
+            goto done;
+        }
+    }
+
+    Py_ssize_t want = count < available ? count : available;
+    result = PyList_New(0);
+    if (result == NULL) {
+        goto done;
+    }
+
+    // Bounded rejection sampling, then the rest in table order
+    uint64_t budget = (uint64_t)want * DRAWS_PER_PICK;
+    for (uint64_t draw = 0; PyList_GET_SIZE(result) < want && draw < budget && draw <= UINT32_MAX; draw++) {
+        size_t index = alias_draw(&self->table, beta.buf, (size_t)beta.len, (uint32_t)draw);
+        if (taken[index]) {
+            continue;
+        }
+        taken[index] = 1;
+        if (PyList_Append(result, self->candidates[index].id) < 0) {
+            Py_CLEAR(result);
+            goto done;
+        }
+    }
+    for (Py_ssize_t index = 0; PyList_GET_SIZE(result) < want && index < self->count; index++) {
+        if (taken[index]) {
+            continue;
+        }
+        taken[index] = 1;
+        if (PyList_Append(result, self->candidates[index].id) < 0) {
+            Py_CLEAR(result);
+            goto done;
+        }
+    }
+
+done:
+    PyMem_Free(taken);
+    PyBuffer_Release(&beta);
+    return result;
+}
+
+static PyObject* CandidateTable_candidates(CandidateTableObject *self, PyObject *args) {
+    PyObject *result = PyList_New(self->count);
+    if (result == NULL) {
+        return NULL;
+    }
+    for (Py_ssize_t i = 0; i < self->count; i++) {
+        PyObject *entry = Py_BuildValue("(Od)", self->candidates[i].id, self->candidates[i].weight);
+        if (entry == NULL) {
+            Py_DECREF(result);
+            return NULL;
+        }
+        PyList_SET_ITEM(result, i, entry);
+    }
+    return result;
+}
+
+static Py_ssize_t CandidateTable_length(CandidateTableObject *self) {
+    return self->count;
+}
+
+// Module functions
+
+static int check_size(Py_buffer *buffer, Py_ssize_t size, const char *message) {
+    if (buffer->len != size) {
+        PyErr_SetString(PyExc_ValueError, message);
+        return -1;
+    }
+    return 0;
+}
+
+static PyObject* vrf_public_key(PyObject *self, PyObject *args) {
+    Py_buffer secret_key;
+    uint8_t public_key[ECVRF_PUBLIC_KEY_SIZE];
+
+    if (!PyArg_ParseTuple(args, "y*", &secret_key)) {
+        return NULL;
+    }
+    if (check_size(&secret_key, ECVRF_SECRET_KEY_SIZE, "Secret key must be 32 bytes") < 0) {
+        PyBuffer_Release(&secret_key);
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    ecvrf_public_key(public_key, secret_key.buf);
+    Py_END_ALLOW_THREADS
+
+    PyBuffer_Release(&secret_key);
+    return PyBytes_FromStringAndSize((const char*)public_key, sizeof(public_key));
+}
+
+static PyObject* vrf_prove(PyObject *self, PyObject *args) {
+    Py_buffer secret_key, alpha;
+    uint8_t proof[ECVRF_PROOF_SIZE];
+    int status;
+
+    if (!PyArg_ParseTuple(args, "y*y*", &secret_key, &alpha)) {
+        return NULL;
+    }
+    if (check_size(&secret_key, ECVRF_SECRET_KEY_SIZE, "Secret key must be 32 bytes") < 0) {
+        PyBuffer_Release(&secret_key);
+        PyBuffer_Release(&alpha);
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    status = ecvrf_prove(proof, secret_key.buf, alpha.buf, (size_t)alpha.len);
+    Py_END_ALLOW_THREADS
+
+    PyBuffer_Release(&secret_key);
+    PyBuffer_Release(&alpha);
+    if (status < 0) {
+        PyErr_SetString(PyExc_ValueError, "Input does not hash to a curve point");
+        return NULL;
+    }
+    return PyBytes_FromStringAndSize((const char*)proof, sizeof(proof));
+}
+
+static PyObject* vrf_proof_to_hash(PyObject *self, PyObject *args) {
+    Py_buffer proof;
+    uint8_t beta[ECVRF_OUTPUT_SIZE];
+    int status = -1;
+
+    if (!PyArg_ParseTuple(args, "y*", &proof)) {
+        return NULL;
+    }
+    if (proof.len == ECVRF_PROOF_SIZE) {
+        status = ecvrf_proof_to_hash(beta, proof.buf);
+    }
+    PyBuffer_Release(&proof);
+
+    if (status < 0) {
+        PyErr_SetString(PyExc_ValueError, "Malformed proof");
+        return NULL;
+    }
+    return PyBytes_FromStringAndSize((const char*)beta, sizeof(beta));
+}
+
+static PyObject* vrf_verify(PyObject *self, PyObject *args) {
+    Py_buffer public_key, proof, alpha;
+    uint8_t beta[ECVRF_OUTPUT_SIZE];
+    int status = -1;
+
+    if (!PyArg_ParseTuple(args, "y*y*y*", &public_key, &proof, &alpha)) {
+        return NULL;
+    }
+
+    // Wrong sizes are an invalid proof rather than an error
+    if (public_key.len == ECVRF_PUBLIC_KEY_SIZE && proof.len == ECVRF_PROOF_SIZE) {
+        Py_BEGIN_ALLOW_THREADS
+        status = ecvrf_verify(beta, public_key.buf, proof.buf, alpha.buf, (size_t)alpha.len);
+        Py_END_ALLOW_THREADS
+    }
+
+    PyBuffer_Release(&public_key);
+    PyBuffer_Release(&proof);
+    PyBuffer_Release(&alpha);
+    if (status < 0) {
+        Py_RETURN_NONE;
+    }
+    return PyBytes_FromStringAndSize((const char*)beta, sizeof(beta));
+}
+
+static PyObject* vrf_version(PyObject *self, PyObject *args) {
+    return PyUnicode_FromString("0.1.0");
+}
+
+static PyMethodDef vrf_module_methods[] = {
+    {"public_key", vrf_public_key, METH_VARARGS, "Ed25519 public key for a 32-byte secret key"},
+    {"prove", vrf_prove, METH_VARARGS, "80-byte ECVRF proof for alpha"},
+    {"proof_to_hash", vrf_proof_to_hash, METH_VARARGS, "64-byte VRF output of a proof"},
+    {"verify", vrf_verify, METH_VARARGS, "VRF output if the proof is valid for public key and alpha, else None"},
+    {"version", vrf_version, METH_NOARGS, "Get version"},
+    {NULL, NULL, 0, NULL}
+};
+
+// Module definition
+static struct PyModuleDef vrf_module = {
+    PyModuleDef_HEAD_INIT,
+    "vrf_native",
+    "Native VRF extension for Lucid RDP",
+    -1,
+    vrf_module_methods
+};
+
+PyMODINIT_FUNC PyInit_vrf_native(void) {
+    if (PyType_Ready(&CandidateTableType) < 0) {
+        return NULL;
+    }
+
+    PyObject *m = PyModule_Create(&vrf_module);
+    if (m == NULL) {
+        return NULL;
+    }
+
+    Py_INCREF(&CandidateTableType);
+    if (PyModule_AddObject(m, "CandidateTable", (PyObject*)&CandidateTableType) < 0) {
+        Py_DECREF(&CandidateTableType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    PyModule_AddIntConstant(m, "SECRET_KEY_SIZE", ECVRF_SECRET_KEY_SIZE);
+    PyModule_AddIntConstant(m, "PUBLIC_KEY_SIZE", ECVRF_PUBLIC_KEY_SIZE);
+    PyModule_AddIntConstant(m, "PROOF_SIZE", ECVRF_PROOF_SIZE);
+    PyModule_AddIntConstant(m, "OUTPUT_SIZE", ECVRF_OUTPUT_SIZE);
+    PyModule_AddIntConstant(m, "MAX_CANDIDATES", MAX_CANDIDATES);
+
+    return m;
+}
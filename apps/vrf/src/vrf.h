@@ -0,0 +1,11 @@
+#ifndef VRF_H
+#define VRF_H
+
+#include <Python.h>
+
+// Constants
+#define MAX_CANDIDATES (1 << 20)
+#define WEIGHT_SCALE 1099511627776.0   // 2^40; the heaviest candidate maps to this
+#define DRAWS_PER_PICK 32              // Draw budget per pick before filling in table order
+
+#endif // VRF_H
@@ -0,0 +1,13 @@
+# Work Credits Module
+# Sliding-window PoOT work credits aggregation
+
+"""
+File: /app/apps/work_credits/__init__.py
+x-lucid-file-path: /app/apps/work_credits/__init__.py
+x-lucid-file-type: python
+
+Work Credits package for Lucid RDP.
+Contains the native work credits aggregator used by the PoOT engine.
+"""
+
+__all__ = []
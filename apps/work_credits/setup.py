@@ -0,0 +1,51 @@
+#!/usr/bin/env python3
+"""
+File: /app/apps/work_credits/setup.py
+x-lucid-file-path: /app/apps/work_credits/setup.py
+x-lucid-file-type: python
+
+Setup script for native work credits extension
+"""
+
+from setuptools import setup, Extension
+
+# Define the extension module
+work_credits_native = Extension(
+    'work_credits_native',
+    sources=[
+        'src/work_credits.c',
+        'src/window_agg.c'
+    ],
+    include_dirs=[
+        'src/'
+    ],
+    libraries=['m'],
+    library_dirs=[],
+    extra_compile_args=[
+        '-O3',
+        '-Wall',
+        '-Wextra',
+        '-std=c99',
+        '-fPIC'
+    ],
+    extra_link_args=['-shared']
+)
+
+setup(
+    name='work-credits-native',
+    version='0.1.0',
+    description='Native work credits extension for Lucid RDP',
+    ext_modules=[work_credits_native],
+    python_requires='>=3.8',
+    classifiers=[
+        'Development Status :: 3 - Alpha',
+        'Intended Audience :: Developers',
+        'License :: OSI Approved :: MIT License',
+        'Programming Language :: C',
+        'Programming Language :: Python :: 3',
+        'Programming Language :: Python :: 3.8',
+        'Programming Language :: Python :: 3.9',
+        'Programming Language :: Python :: 3.10',
+        'Programming Language :: Python :: 3.11',
+    ],
+)
@@ -0,0 +1,13 @@
+# Work Credits Source Module
+# Work credits native source code components
+
+"""
+File: /app/apps/work_credits/src/__init__.py
+x-lucid-file-path: /app/apps/work_credits/src/__init__.py
+x-lucid-file-type: python
+
+Work Credits Source package for Lucid RDP.
+Contains work credits native source code and C implementations.
+"""
+
+__all__ = []
@@ -0,0 +1,443 @@
+#include <stdlib.h>
+#include <string.h>
+#include "window_agg.h"
+
+#define WA_INITIAL_ENTITIES 256
+#define WA_INITIAL_INDEX 512    // Power of two, kept at most half full
+
+#define ENTITY(table, idx) ((table)->entities[idx])
+
+static uint64_t wa_hash(const char *id, size_t len) {
+    // FNV-1a
+    uint64_t hash = 1469598103934665603ULL;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (uint8_t)id[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static uint32_t wa_random(wa_table_t *table) {
+    // xorshift64
+    table->rng ^= table->rng << 13;
+    table->rng ^= table->rng >> 7;
+    table->rng ^= table->rng << 17;
+    return (uint32_t)(table->rng >> 32);
+}
+
+int wa_init(wa_table_t *table, uint32_t window, int64_t bucket_seconds, double min_uptime) {
+    memset(table, 0, sizeof(*table));
+    table->window = window;
+    table->bucket_seconds = bucket_seconds;
+    table->max_uptime = (double)window * (double)bucket_seconds;
+    table->min_uptime = min_uptime;
+    table->free_head = WA_NIL;
+    table->root = WA_NIL;
+    table->rng = 0x9E3779B97F4A7C15ULL;
+
+    table->entities = calloc(WA_INITIAL_ENTITIES, sizeof(wa_entity_t));
+    table->index = malloc(WA_INITIAL_INDEX * sizeof(uint32_t));
+    table->slot_day = malloc(window * sizeof(int64_t));
+    table->slot_head = malloc(window * sizeof(uint32_t));
+    if (table->entities == NULL || table->index == NULL || table->slot_day == NULL || table->slot_head == NULL) {
+        wa_free(table);
+        return -1;
+    }
+
+    table->entity_capacity = WA_INITIAL_ENTITIES;
+    table->index_capacity = WA_INITIAL_INDEX;
+    memset(table->index, 0xFF, WA_INITIAL_INDEX * sizeof(uint32_t));
+    for (uint32_t i = 0; i < window; i++) {
+        table->slot_day[i] = WA_EMPTY_DAY;
+        table->slot_head[i] = WA_NIL;
+    }
+    return 0;
+}
+
+void wa_free(wa_table_t *table) {
+    if (table->entities != NULL) {
+        for (uint32_t i = 0; i < table->entity_used; i++) {
+            free(table->entities[i].id);
+            free(table->entities[i].buckets);
+        }
+    }
+    free(table->entities);
+    free(table->index);
+    free(table->slot_day);
+    free(table->slot_head);
+    memset(table, 0, sizeof(*table));
+}
+
+int64_t wa_day(const wa_table_t *table, int64_t timestamp) {
+    int64_t day = timestamp / table->bucket_seconds;
+    return timestamp % table->bucket_seconds < 0 ? day - 1 : day;
+}
+
+static size_t wa_slot(const wa_table_t *table, int64_t day) {
+    int64_t slot = day % (int64_t)table->window;
+    return (size_t)(slot < 0 ? slot + table->window : slot);
+}
+
+// Rank treap, ordered by live score (highest first) and then by id
+
+static int wa_before(const wa_table_t *table, uint32_t a, uint32_t b) {
+    const wa_entity_t *x = &ENTITY(table, a);
+    const wa_entity_t *y = &ENTITY(table, b);
+    if (x->live_score != y->live_score) {
+        return x->live_score > y->live_score;
+    }
+    int order = memcmp(x->id, y->id, x->id_len < y->id_len ? x->id_len : y->id_len);
+    return order != 0 ? order < 0 : x->id_len < y->id_len;
+}
+
+static uint32_t wa_size(const wa_table_t *table, uint32_t node) {
+    return node == WA_NIL ? 0 : ENTITY(table, node).size;
+}
+
+static void wa_update(wa_table_t *table, uint32_t node) {
+    wa_entity_t *entity = &ENTITY(table, node);
+    entity->size = 1 + wa_size(table, entity->left) + wa_size(table, entity->right);
+}
+
+// Every node of a comes before every node of b
+static uint32_t wa_merge(wa_table_t *table, uint32_t a, uint32_t b) {
+    if (a == WA_NIL) {
+        return b;
+    }
+    if (b == WA_NIL) {
+        return a;
+    }
+    if (ENTITY(table, a).priority > ENTITY(table, b).priority) {
+        ENTITY(table, a).right = wa_merge(table, ENTITY(table, a).right, b);
+        wa_update(table, a);
+        return a;
+    }
+    ENTITY(table, b).left = wa_merge(table, a, ENTITY(table, b).left);
+    wa_update(table, b);
+    return b;
+}
+
+// Splits node into the entities ordered before key and the rest
+static void wa_split(wa_table_t *table, uint32_t node, uint32_t key, uint32_t *before, uint32_t *rest) {
+    if (node == WA_NIL) {
+        *before = *rest = WA_NIL;
+        return;
+    }
+    if (wa_before(table, node, key)) {
+        wa_split(table, ENTITY(table, node).right, key, &ENTITY(table, node).right, rest);
+        *before = node;
+    } else {
+        wa_split(table, ENTITY(table, node).left, key, before, &ENTITY(table, node).left);
+        *rest = node;
+    }
+    wa_update(table, node);
+}
+
+static uint32_t wa_drop_first(wa_table_t *table, uint32_t node) {
+    if (ENTITY(table, node).left == WA_NIL) {
+        return ENTITY(table, node).right;
+    }
+    ENTITY(table, node).left = wa_drop_first(table, ENTITY(table, node).left);
+    wa_update(table, node);
+    return node;
+}
+
+static void wa_tree_insert(wa_table_t *table, uint32_t node) {
+    uint32_t before, rest;
+    ENTITY(table, node).left = ENTITY(table, node).right = WA_NIL;
+    ENTITY(table, node).size = 1;
+    wa_split(table, table->root, node, &before, &rest);
+    table->root = wa_merge(table, wa_merge(table, before, node), rest);
+}
+
+static void wa_tree_erase(wa_table_t *table, uint32_t node) {
+    uint32_t before, rest;
+    // Ids are unique, so node is the first entity of rest
+    wa_split(table, table->root, node, &before, &rest);
+    table->root = wa_merge(table, before, wa_drop_first(table, rest));
+}
+
+uint32_t wa_rank(const wa_table_t *table, const wa_entity_t *entity) {
+    if (!entity->ranked) {
+        return 0;
+    }
+    uint32_t target = (uint32_t)(entity - table->entities);
+    uint32_t rank = 0;
+    uint32_t node = table->root;
+    while (node != WA_NIL) {
+        const wa_entity_t *current = &ENTITY(table, node);
+        if (node == target) {
+            return rank + wa_size(table, current->left) + 1;
+        }
+        if (wa_before(table, target, node)) {
+            node = current->left;
+        } else {
+            rank += wa_size(table, current->left) + 1;
+            node = current->right;
+        }
+    }
+    return 0;
+}
+
+uint32_t wa_ranked_count(const wa_table_t *table) {
+    return wa_size(table, table->root);
+}
+
+size_t wa_top(const wa_table_t *table, uint32_t *out, size_t limit) {
+    size_t total = wa_ranked_count(table);
+    if (limit > total) {
+        limit = total;
+    }
+    for (size_t k = 0; k < limit; k++) {
+        // Select the entity at rank k + 1
+        size_t remaining = k;
+        uint32_t node = table->root;
+        for (;;) {
+            uint32_t left = wa_size(table, ENTITY(table, node).left);
+            if (remaining < left) {
+                node = ENTITY(table, node).left;
+            } else if (remaining == left) {
+                break;
+            } else {
+                remaining -= left + 1;
+                node = ENTITY(table, node).right;
+            }
+        }
+        out[k] = node;
+    }
+    return limit;
+}
+
+static void wa_rescore(wa_table_t *table, uint32_t idx) {
+    wa_entity_t *entity = &ENTITY(table, idx);
+    if (entity->ranked) {
+        wa_tree_erase(table, idx);
+        entity->ranked = 0;
+    }
+
+    int64_t credits = entity->totals[WA_RELAY] + entity->totals[WA_STORAGE] + entity->totals[WA_VALIDATION];
+    double uptime_score = (double)entity->totals[WA_UPTIME] / table->max_uptime;
+    entity->uptime_score = uptime_score < 1.0 ? uptime_score : 1.0;
+    entity->live_score = (double)credits * entity->uptime_score;
+
+    if (credits > 0 && entity->uptime_score >= table->min_uptime) {
+        wa_tree_insert(table, idx);
+        entity->ranked = 1;
+    }
+}
+
+// Id index
+
+static size_t wa_index_slot(const wa_table_t *table, uint64_t hash, const char *id, size_t len) {
+    size_t mask = table->index_capacity - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        uint32_t idx = table->index[i];
+        if (idx == WA_NIL) {
+            return i;
+        }
+        const wa_entity_t *entity = &ENTITY(table, idx);
+        if (entity->hash == hash && entity->id_len == len && memcmp(entity->id, id, len) == 0) {
+            return i;
+        }
+    }
+}
+
+static int wa_index_grow(wa_table_t *table) {
+    size_t capacity = table->index_capacity * 2;
+    uint32_t *index = malloc(capacity * sizeof(uint32_t));
+    if (index == NULL) {
+        return -1;
+    }
+    memset(index, 0xFF, capacity * sizeof(uint32_t));
+    for (size_t i = 0; i < table->index_capacity; i++) {
+        uint32_t idx = table->index[i];
+        if (idx != WA_NIL) {
+            size_t j = ENTITY(table, idx).hash & (capacity - 1);
+            while (index[j] != WA_NIL) {
+                j = (j + 1) & (capacity - 1);
+            }
+            index[j] = idx;
+        }
+    }
+    free(table->index);
+    table->index = index;
+    table->index_capacity = capacity;
+    return 0;
+}
+
+// Backward-shift deletion keeps probe chains intact without tombstones
+static void wa_index_remove(wa_table_t *table, size_t hole) {
+    size_t mask = table->index_capacity - 1;
+    for (size_t i = (hole + 1) & mask; table->index[i] != WA_NIL; i = (i + 1) & mask) {
+        size_t home = ENTITY(table, table->index[i]).hash & mask;
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            table->index[hole] = table->index[i];
+            hole = i;
+        }
+    }
+    table->index[hole] = WA_NIL;
+}
+
+wa_entity_t *wa_find(const wa_table_t *table, const char *id, size_t len) {
+    uint32_t idx = table->index[wa_index_slot(table, wa_hash(id, len), id, len)];
+    return idx == WA_NIL ? NULL : &ENTITY(table, idx);
+}
+
+static uint32_t wa_entity_new(wa_table_t *table, const char *id, size_t len, uint64_t hash) {
+    char *copy = malloc(len ? len : 1);
+    wa_bucket_t *buckets = malloc(table->window * sizeof(wa_bucket_t));
+    if (copy == NULL || buckets == NULL) {
+        goto error;
+    }
+
+    uint32_t idx;
+    if (table->free_head != WA_NIL) {
+        idx = table->free_head;
+        table->free_head = ENTITY(table, idx).left;
+    } else {
+        if (table->entity_used == table->entity_capacity) {
+            if (table->entity_capacity >= WA_NIL / 2) {
+                goto error;
+            }
+            wa_entity_t *entities = realloc(table->entities, 2 * table->entity_capacity * sizeof(wa_entity_t));
+            if (entities == NULL) {
+                goto error;
+            }
+            table->entities = entities;
+            table->entity_capacity *= 2;
+        }
+        idx = table->entity_used++;
+    }
+
+    wa_entity_t *entity = &ENTITY(table, idx);
+    memset(entity, 0, sizeof(*entity));
+    memcpy(copy, id, len);
+    entity->id = copy;
+    entity->id_len = len;
+    entity->hash = hash;
+    entity->left = entity->right = WA_NIL;
+    entity->size = 1;
+    entity->priority = wa_random(table);
+    entity->buckets = buckets;
+    for (uint32_t i = 0; i < table->window; i++) {
+        buckets[i].day = WA_EMPTY_DAY;
+    }
+    return idx;
+
+error:
+    free(copy);
+    free(buckets);
+    return WA_NIL;
+}
+
+static void wa_entity_remove(wa_table_t *table, uint32_t idx) {
+    wa_entity_t *entity = &ENTITY(table, idx);
+    if (entity->ranked) {
+        wa_tree_erase(table, idx);
+    }
+    wa_index_remove(table, wa_index_slot(table, entity->hash, entity->id, entity->id_len));
+    table->count--;
+
+    free(entity->id);
+    free(entity->buckets);
+    memset(entity, 0, sizeof(*entity));
+    entity->left = table->free_head;
+    table->free_head = idx;
+}
+
+static size_t wa_expire_slot(wa_table_t *table, size_t slot) {
+    size_t expired = 0;
+    uint32_t idx = table->slot_head[slot];
+
+    while (idx != WA_NIL) {
+        wa_entity_t *entity = &ENTITY(table, idx);
+        wa_bucket_t *bucket = &entity->buckets[slot];
+        uint32_t next = bucket->next;
+
+        for (int i = 0; i < WA_FIELDS; i++) {
+            entity->totals[i] -= bucket->amounts[i];
+        }
+        bucket->day = WA_EMPTY_DAY;
+        entity->active--;
+        expired++;
+
+        if (entity->active == 0) {
+            wa_entity_remove(table, idx);
+        } else {
+            wa_rescore(table, idx);
+        }
+        idx = next;
+    }
+
+    table->slot_day[slot] = WA_EMPTY_DAY;
+    table->slot_head[slot] = WA_NIL;
+    return expired;
+}
+
+size_t wa_advance(wa_table_t *table, int64_t day) {
+    if (!table->started) {
+        table->started = 1;
+        table->current_day = day;
+        return 0;
+    }
+    if (day <= table->current_day) {
+        return 0;
+    }
+
+    // Each slot holds one day, so a jump of any length touches each slot once
+    size_t expired = 0;
+    for (uint32_t slot = 0; slot < table->window; slot++) {
+        int64_t slot_day = table->slot_day[slot];
+        if (slot_day != WA_EMPTY_DAY && slot_day <= day - (int64_t)table->window) {
+            expired += wa_expire_slot(table, slot);
+        }
+    }
+    table->current_day = day;
+    return expired;
+}
+
+int wa_add(wa_table_t *table, const char *id, size_t len, int64_t day, const int64_t *amounts) {
+    wa_advance(table, day);
+    if (day <= table->current_day - (int64_t)table->window) {
+        return 0;
+    }
+    if ((table->count + 1) * 2 > table->index_capacity && wa_index_grow(table) != 0) {
+        return -1;
+    }
+
+    uint64_t hash = wa_hash(id, len);
+    size_t pos = wa_index_slot(table, hash, id, len);
+    uint32_t idx = table->index[pos];
+    if (idx == WA_NIL) {
+        idx = wa_entity_new(table, id, len, hash);
+        if (idx == WA_NIL) {
+            return -1;
+        }
+        table->index[pos] = idx;
+        table->count++;
+    }
+
+    wa_entity_t *entity = &ENTITY(table, idx);
+    size_t slot = wa_slot(table, day);
+    wa_bucket_t *bucket = &entity->buckets[slot];
+
+    // Any older day in this slot has already been expired
+    if (table->slot_day[slot] != day) {
+        table->slot_day[slot] = day;
+        table->slot_head[slot] = WA_NIL;
+    }
+    if (bucket->day != day) {
+        bucket->day = day;
+        memset(bucket->amounts, 0, sizeof(bucket->amounts));
+        bucket->next = table->slot_head[slot];
+        table->slot_head[slot] = idx;
+        entity->active++;
+    }
+
+    for (int i = 0; i < WA_FIELDS; i++) {
+        bucket->amounts[i] += amounts[i];
+        entity->totals[i] += amounts[i];
+    }
+    wa_rescore(table, idx);
+    return 1;
+}
@@ -0,0 +1,78 @@
+#ifndef WINDOW_AGG_H
+#define WINDOW_AGG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Amounts tracked per bucket
+#define WA_RELAY 0
+#define WA_STORAGE 1
+#define WA_VALIDATION 2
+#define WA_UPTIME 3
+#define WA_FIELDS 4
+
+#define WA_NIL UINT32_MAX
+#define WA_EMPTY_DAY INT64_MIN
+
+typedef struct {
+    int64_t day;                 // Day held, WA_EMPTY_DAY when unused
+    int64_t amounts[WA_FIELDS];
+    uint32_t next;               // Next entity with a bucket in this slot
+} wa_bucket_t;
+
+typedef struct {
+    char *id;                    // NULL marks a free entity
+    size_t id_len;
+    uint64_t hash;
+    int64_t totals[WA_FIELDS];   // Sum over live buckets
+    double uptime_score;
+    double live_score;
+    int ranked;                  // In the rank tree
+    uint32_t active;             // Buckets in use
+    uint32_t left, right;        // Rank treap; left doubles as the free list link
+    uint32_t size;
+    uint32_t priority;
+    wa_bucket_t *buckets;        // One per day of the window, indexed by day % window
+} wa_entity_t;
+
+typedef struct {
+    wa_entity_t *entities;
+    uint32_t entity_capacity;
+    uint32_t entity_used;        // High-water mark
+    uint32_t free_head;
+    uint32_t *index;             // Open addressing over entity indices
+    size_t index_capacity;
+    size_t count;
+    uint32_t root;
+    uint32_t window;
+    int64_t bucket_seconds;
+    double max_uptime;           // Seconds in a full window
+    double min_uptime;           // Score below which an entity is not ranked
+    int started;
+    int64_t current_day;
+    int64_t *slot_day;
+    uint32_t *slot_head;
+    uint64_t rng;
+} wa_table_t;
+
+int wa_init(wa_table_t *table, uint32_t window, int64_t bucket_seconds, double min_uptime);
+void wa_free(wa_table_t *table);
+
+int64_t wa_day(const wa_table_t *table, int64_t timestamp);
+
+// Expires buckets older than the window ending at day; returns buckets expired
+size_t wa_advance(wa_table_t *table, int64_t day);
+
+// 1 if added, 0 if the day already left the window, -1 on allocation failure
+int wa_add(wa_table_t *table, const char *id, size_t len, int64_t day, const int64_t *amounts);
+
+wa_entity_t *wa_find(const wa_table_t *table, const char *id, size_t len);
+
+// 1-based rank by live score, 0 if the entity is not ranked
+uint32_t wa_rank(const wa_table_t *table, const wa_entity_t *entity);
+uint32_t wa_ranked_count(const wa_table_t *table);
+
+// Entity indices in rank order; returns how many were written
+size_t wa_top(const wa_table_t *table, uint32_t *out, size_t limit);
+
+#endif // WINDOW_AGG_H
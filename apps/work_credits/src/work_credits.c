@@ -0,0 +1,346 @@
+/*
+ * Native work credits extension for Lucid RDP
+ * Aggregates PoOT task proofs into per-entity day buckets over a sliding
+ * window, expiring whole days at once and keeping entities ranked by live
+ * score in an order-statistic tree
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <math.h>
+#include <stdint.h>
+#include "work_credits.h"
+#include "window_agg.h"
+
+typedef struct {
+    PyObject_HEAD
+    wa_table_t table;
+    int initialized;
+} WorkAggregatorObject;
+
+static PyTypeObject WorkAggregatorType;
+
+// Forward declarations
+static PyObject* WorkAggregator_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
+static int WorkAggregator_init(WorkAggregatorObject *self, PyObject *args, PyObject *kwds);
+static void WorkAggregator_dealloc(WorkAggregatorObject *self);
+static PyObject* WorkAggregator_add(WorkAggregatorObject *self, PyObject *args, PyObject *kwds);
+static PyObject* WorkAggregator_advance(WorkAggregatorObject *self, PyObject *args);
+static PyObject* WorkAggregator_get(WorkAggregatorObject *self, PyObject *args);
+static PyObject* WorkAggregator_rank(WorkAggregatorObject *self, PyObject *args);
+static PyObject* WorkAggregator_top(WorkAggregatorObject *self, PyObject *args, PyObject *kwds);
+static PyObject* WorkAggregator_snapshot(WorkAggregatorObject *self, PyObject *args);
+static Py_ssize_t WorkAggregator_length(WorkAggregatorObject *self);
+
+// Method definitions
+static PyMethodDef WorkAggregator_methods[] = {
+    {"add", (PyCFunction)(void(*)(void))WorkAggregator_add, METH_VARARGS | METH_KEYWORDS,
+     "Add a proof's credits to its entity; False if it is older than the window"},
+    {"advance", (PyCFunction)WorkAggregator_advance, METH_VARARGS,
+     "Move the window to end at a timestamp; returns the day buckets expired"},
+    {"get", (PyCFunction)WorkAggregator_get, METH_VARARGS,
+     "(relay, storage, validation, uptime_seconds, uptime_score, live_score) for an entity, or None"},
+    {"rank", (PyCFunction)WorkAggregator_rank, METH_VARARGS, "1-based rank by live score, or None if unranked"},
+    {"top", (PyCFunction)(void(*)(void))WorkAggregator_top, METH_VARARGS | METH_KEYWORDS,
+     "[(entity_id, credits, live_score), ...] for the highest ranked entities"},
+    {"snapshot", (PyCFunction)WorkAggregator_snapshot, METH_NOARGS,
+     "Every ranked entity as (entity_id, relay, storage, validation, uptime_seconds, uptime_score, live_score)"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyObject* WorkAggregator_get_ranked(WorkAggregatorObject *self, void *closure) {
+    return PyLong_FromUnsignedLong(wa_ranked_count(&self->table));
+}
+
+static PyObject* WorkAggregator_get_window_days(WorkAggregatorObject *self, void *closure) {
+    return PyLong_FromUnsignedLong(self->table.window);
+}
+
+static PyObject* WorkAggregator_get_current_day(WorkAggregatorObject *self, void *closure) {
+    if (!self->table.started) {
+        Py_RETURN_NONE;
+    }
+    return PyLong_FromLongLong(self->table.current_day);
+}
+
+static PyGetSetDef WorkAggregator_getset[] = {
+    {"ranked", (getter)WorkAggregator_get_ranked, NULL, "Entities with a live score", NULL},
+    {"window_days", (getter)WorkAggregator_get_window_days, NULL, "Buckets in the window", NULL},
+    {"current_day", (getter)WorkAggregator_get_current_day, NULL, "Newest bucket index, or None before any proof", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PySequenceMethods WorkAggregator_as_sequence = {
+    .sq_length = (lenfunc)WorkAggregator_length,
+};
+
+// Type definition
+static PyTypeObject WorkAggregatorType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "work_credits_native.WorkAggregator",
+    .tp_doc = "Sliding-window work credits with live-score ranking",
+    .tp_basicsize = sizeof(WorkAggregatorObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = WorkAggregator_new,
+    .tp_init = (initproc)WorkAggregator_init,
+    .tp_dealloc = (destructor)WorkAggregator_dealloc,
+    .tp_methods = WorkAggregator_methods,
+    .tp_getset = WorkAggregator_getset,
+    .tp_as_sequence = &WorkAggregator_as_sequence,
+};
+
+static PyObject* WorkAggregator_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
+    WorkAggregatorObject *self = (WorkAggregatorObject*)type->tp_alloc(type, 0);
+    if (self == NULL) {
+        return NULL;
+    }
+    self->initialized = 0;
+    return (PyObject*)self;
+}
+
+static int WorkAggregator_init(WorkAggregatorObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"window_days", "bucket_seconds", "min_uptime", NULL};
+    int window_days = DEFAULT_WINDOW_DAYS;
+    long long bucket_seconds = DEFAULT_BUCKET_SECONDS;
+    double min_uptime = DEFAULT_MIN_UPTIME;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|iLd", kwlist, &window_days, &bucket_seconds, &min_uptime)) {
+        return -1;
+    }
+    if (window_days < 1 || window_days > MAX_WINDOW_DAYS) {
+        PyErr_SetString(PyExc_ValueError, "Invalid window_days");
+        return -1;
+    }
+    if (bucket_seconds < 1) {
+        PyErr_SetString(PyExc_ValueError, "Invalid bucket_seconds");
+        return -1;
+    }
+
+    if (self->initialized) {
+        wa_free(&self->table);
+        self->initialized = 0;
+    }
+    if (wa_init(&self->table, (uint32_t)window_days, bucket_seconds, min_uptime) != 0) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    self->initialized = 1;
+    return 0;
+}
+
+static void WorkAggregator_dealloc(WorkAggregatorObject *self) {
+    if (self->initialized) {
+        wa_free(&self->table);
+    }
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static int check_initialized(WorkAggregatorObject *self) {
+    if (!self->initialized) {
+        PyErr_SetString(PyExc_RuntimeError, "WorkAggregator not initialized");
+        return -1;
+    }
+    return 0;
+}
+
+static int timestamp_day(WorkAggregatorObject *self, double timestamp, int64_t *day) {
+    if (!isfinite(timestamp) || fabs(timestamp) > 9.0e18) {
+        PyErr_SetString(PyExc_ValueError, "Invalid timestamp");
+        return -1;
+    }
+    *day = wa_day(&self->table, (int64_t)floor(timestamp));
+    return 0;
+}
+
+static PyObject* WorkAggregator_add(WorkAggregatorObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"entity_id", "timestamp", "relay", "storage", "validation", "uptime", NULL};
+    PyObject *entity_id;
+    double timestamp;
+    long long relay = 0, storage = 0, validation = 0, uptime = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "Ud|LLLL", kwlist, &entity_id, &timestamp,
+                                     &relay, &storage, &validation, &uptime)) {
+        return NULL;
+    }
+    if (check_initialized(self) < 0) {
+        return NULL;
+    }
+    if (relay < 0 || storage < 0 || validation < 0 || uptime < 0) {
+        PyErr_SetString(PyExc_ValueError, "Credits must not be negative");
+        return NULL;
+    }
+
+    Py_ssize_t len;
+    const char *id = PyUnicode_AsUTF8AndSize(entity_id, &len);
+    int64_t day;
+    if (id == NULL || timestamp_day(self, timestamp, &day) < 0) {
+        return NULL;
+    }
+
+    int64_t amounts[WA_FIELDS];
+    amounts[WA_RELAY] = relay;
+    amounts[WA_STORAGE] = storage;
+    amounts[WA_VALIDATION] = validation;
+    amounts[WA_UPTIME] = uptime;
+
+    int result = wa_add(&self->table, id, (size_t)len, day, amounts);
+    if (result < 0) {
+        return PyErr_NoMemory();
+    }
+    return PyBool_FromLong(result);
+}
+
+static PyObject* WorkAggregator_advance(WorkAggregatorObject *self, PyObject *args) {
+    double now;
+    int64_t day;
+
+    if (!PyArg_ParseTuple(args, "d", &now) || check_initialized(self) < 0 ||
+        timestamp_day(self, now, &day) < 0) {
+        return NULL;
+    }
+    return PyLong_FromSize_t(wa_advance(&self->table, day));
+}
+
+static wa_entity_t* find_entity(WorkAggregatorObject *self, PyObject *args) {
+    PyObject *entity_id;
+    Py_ssize_t len;
+    const char *id;
+
+    if (!PyArg_ParseTuple(args, "U", &entity_id) || check_initialized(self) < 0 ||
+        (id = PyUnicode_AsUTF8AndSize(entity_id, &len)) == NULL) {
+        return NULL;
+    }
+    return wa_find(&self->table, id, (size_t)len);
+}
+
+static PyObject* WorkAggregator_get(WorkAggregatorObject *self, PyObject *args) {
+    wa_entity_t *entity = find_entity(self, args);
+    if (entity == NULL) {
+        if (PyErr_Occurred()) {
+            return NULL;
+        }
+        Py_RETURN_NONE;
+    }
+    return Py_BuildValue("(LLLLdd)",
+                         (long long)entity->totals[WA_RELAY],
+                         (long long)entity->totals[WA_STORAGE],
+                         (long long)entity->totals[WA_VALIDATION],
+                         (long long)entity->totals[WA_UPTIME],
+                         entity->uptime_score, entity->live_score);
+}
+
+static PyObject* WorkAggregator_rank(WorkAggregatorObject *self, PyObject *args) {
+    wa_entity_t *entity = find_entity(self, args);
+    if (entity == NULL && PyErr_Occurred()) {
+        return NULL;
+    }
+    uint32_t rank = entity ? wa_rank(&self->table, entity) : 0;
+    if (rank == 0) {
+        Py_RETURN_NONE;
+    }
+    return PyLong_FromUnsignedLong(rank);
+}
+
+// Ranked entities in order, at most limit of them
+static PyObject* ranked_list(WorkAggregatorObject *self, size_t limit, int full) {
+    uint32_t ranked = wa_ranked_count(&self->table);
+    if (limit > ranked) {
+        limit = ranked;
+    }
+
+    uint32_t *order = PyMem_Malloc((limit ? limit : 1) * sizeof(uint32_t));
+    if (order == NULL) {
+        return PyErr_NoMemory();
+    }
+    limit = wa_top(&self->table, order, limit);
+
+    PyObject *result = PyList_New((Py_ssize_t)limit);
+    for (size_t i = 0; result != NULL && i < limit; i++) {
+        const wa_entity_t *entity = &self->table.entities[order[i]];
+        int64_t credits = entity->totals[WA_RELAY] + entity->totals[WA_STORAGE] + entity->totals[WA_VALIDATION];
+        PyObject *item = full
+            ? Py_BuildValue("(s#LLLLdd)", entity->id, (Py_ssize_t)entity->id_len,
+                            (long long)entity->totals[WA_RELAY],
+                            (long long)entity->totals[WA_STORAGE],
+                            (long long)entity->totals[WA_VALIDATION],
+                            (long long)entity->totals[WA_UPTIME],
+                            entity->uptime_score, entity->live_score)
+            : Py_BuildValue("(s#Ld)", entity->id, (Py_ssize_t)entity->id_len,
+                            (long long)credits, entity->live_score);
+        if (item == NULL) {
+            Py_CLEAR(result);
+            break;
+        }
+        PyList_SET_ITEM(result, (Py_ssize_t)i, item);
+    }
+
+    PyMem_Free(order);
+    return result;
+}
+
+static PyObject* WorkAggregator_top(WorkAggregatorObject *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"limit", NULL};
+    Py_ssize_t limit = 10;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|n", kwlist, &limit) || check_initialized(self) < 0) {
+        return NULL;
+    }
+    if (limit < 0) {
+        PyErr_SetString(PyExc_ValueError, "limit must not be negative");
+        return NULL;
+    }
+    return ranked_list(self, (size_t)limit, 0);
+}
+
+static PyObject* WorkAggregator_snapshot(WorkAggregatorObject *self, PyObject *args) {
+    if (check_initialized(self) < 0) {
+        return NULL;
+    }
+    return ranked_list(self, SIZE_MAX, 1);
+}
+
+static Py_ssize_t WorkAggregator_length(WorkAggregatorObject *self) {
+    return self->initialized ? (Py_ssize_t)self->table.count : 0;
+}
+
+static PyObject* work_credits_version(PyObject *self, PyObject *args) {
+    return PyUnicode_FromString("0.1.0");
+}
+
+static PyMethodDef work_credits_module_methods[] = {
+    {"version", work_credits_version, METH_NOARGS, "Get version"},
+    {NULL, NULL, 0, NULL}
+};
+
+// Module definition
+static struct PyModuleDef work_credits_module = {
+    PyModuleDef_HEAD_INIT,
+    "work_credits_native",
+    "Native work credits extension for Lucid RDP",
+    -1,
+    work_credits_module_methods
+};
+
+PyMODINIT_FUNC PyInit_work_credits_native(void) {
+    if (PyType_Ready(&WorkAggregatorType) < 0) {
+        return NULL;
+    }
+
+    PyObject *m = PyModule_Create(&work_credits_module);
+    if (m == NULL) {
+        return NULL;
+    }
+
+    Py_INCREF(&WorkAggregatorType);
+    if (PyModule_AddObject(m, "WorkAggregator", (PyObject*)&WorkAggregatorType) < 0) {
+        Py_DECREF(&WorkAggregatorType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    PyModule_AddIntConstant(m, "DEFAULT_WINDOW_DAYS", DEFAULT_WINDOW_DAYS);
+    PyModule_AddIntConstant(m, "DEFAULT_BUCKET_SECONDS", DEFAULT_BUCKET_SECONDS);
+
+    return m;
+}
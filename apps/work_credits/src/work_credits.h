@@ -0,0 +1,12 @@
+#ifndef WORK_CREDITS_H
+#define WORK_CREDITS_H
+
+#include <Python.h>
+
+// Constants
+#define DEFAULT_WINDOW_DAYS 7          // PoOT leader window
+#define DEFAULT_BUCKET_SECONDS 86400   // One bucket per day
+#define DEFAULT_MIN_UPTIME 0.2         // D_MIN
+#define MAX_WINDOW_DAYS 366
+
+#endif // WORK_CREDITS_H
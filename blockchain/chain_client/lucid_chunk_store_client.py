@@ -31,6 +31,22 @@ import aiofiles
 
 logger = logging.getLogger(__name__)
 
+# Try to import native erasure coding extension
+try:
+    import erasure_native
+    ERASURE_NATIVE_AVAILABLE = True
+except ImportError:
+    ERASURE_NATIVE_AVAILABLE = False
+    logger.warning("Native erasure coding extension not available, using replication only")
+
+# Try to import native proof-of-storage extension
+try:
+    import storage_proof_native
+    STORAGE_PROOF_NATIVE_AVAILABLE = True
+except ImportError:
+    STORAGE_PROOF_NATIVE_AVAILABLE = False
+    logger.warning("Native proof-of-storage extension not available, verifying by full reads")
+
 # Configuration from environment
 LUCID_CHUNK_STORE_CONTRACT_ADDRESS = "0x2345678901234567890123456789012345678901"
 CHUNK_STORE_TIMEOUT_SECONDS = 300
@@ -38,6 +54,12 @@ CHUNK_VERIFICATION_INTERVAL = 60
 MAX_CHUNK_SIZE = 1024 * 1024  # 1MB
 CHUNK_REPLICATION_FACTOR = 3
 STORAGE_PROOF_ALGORITHM = "sha256"
+ERASURE_DATA_SHARDS = 8
+ERASURE_PARITY_SHARDS = 3
+LOCAL_NODE_SCHEME = "file://"  # Node addresses backed by a local directory
+STORAGE_PROOF_BLOCK_SIZE = 4096  # Merkle leaf size for storage challenges
+STORAGE_PROOF_CHALLENGES = 16  # Blocks sampled per storage path and audit
+STORAGE_PROOF_SUFFIX = ".proof"  # Holder-side serialized Merkle tree
 
 
 class ChunkStatus(Enum):
@@ -84,6 +106,16 @@ class ChunkMetadata:
     encryption_key: Optional[str] = None
     compression_ratio: Optional[float] = None
     checksum: Optional[str] = None
+    erasure_data_shards: Optional[int] = None
+    erasure_parity_shards: Optional[int] = None
+    shard_checksums: List[str] = field(default_factory=list)
+    proof_roots: List[str] = field(default_factory=list)  # One Merkle root per storage path
+    proof_data_size: Optional[int] = None  # Size of each object the roots cover
+    
+    @property
+    def erasure_coded(self) -> bool:
+        """Whether storage_paths hold erasure-coded shards rather than replicas"""
+        return self.erasure_data_shards is not None
     
     def to_dict(self) -> Dict[str, Any]:
         """Convert to dictionary"""
@@ -98,7 +130,12 @@ class ChunkMetadata:
             "status": self.status.value,
             "encryptionKey": self.encryption_key,
             "compressionRatio": self.compression_ratio,
-            "checksum": self.checksum
+            "checksum": self.checksum,
+            "erasureDataShards": self.erasure_data_shards,
+            "erasureParityShards": self.erasure_parity_shards,
+            "shardChecksums": self.shard_checksums,
+            "proofRoots": self.proof_roots,
+            "proofDataSize": self.proof_data_size
         }
 
 
@@ -207,6 +244,9 @@ class LucidChunkStoreClient:
         # Verification tasks
         self._verification_tasks: Dict[str, asyncio.Task] = {}
         
+        # Reed-Solomon codecs keyed by (data_shards, parity_shards)
+        self._erasure_coders: Dict[Tuple[int, int], Any] = {}
+        
         # Ensure output directory exists
         self.output_dir.mkdir(parents=True, exist_ok=True)
         
@@ -250,9 +290,12 @@ class LucidChunkStoreClient:
         session_id: str,
         chunk_data: bytes,
         replication_factor: int = CHUNK_REPLICATION_FACTOR,
-        encrypt: bool = True
+        encrypt: bool = True,
+        erasure_coding: bool = False,
+        data_shards: int = ERASURE_DATA_SHARDS,
+        parity_shards: int = ERASURE_PARITY_SHARDS
     ) -> bool:
-        """Store chunk with replication"""
+        """Store chunk with replication, or as k+m erasure-coded shards"""
         try:
             # Validate chunk size
             if len(chunk_data) > MAX_CHUNK_SIZE:
@@ -270,6 +313,14 @@ class LucidChunkStoreClient:
             # Calculate checksum
             checksum = hashlib.md5(chunk_data).hexdigest()
             
+            if erasure_coding:
+                if ERASURE_NATIVE_AVAILABLE:
+                    return await self._store_erasure_coded_chunk(
+                        chunk_id, session_id, chunk_hash, chunk_data, checksum,
+                        encryption_key, data_shards, parity_shards
+                    )
+                logger.warning(f"Erasure coding unavailable, replicating chunk {chunk_id}")
+            
             # Get available storage nodes
             available_nodes = await self._get_available_storage_nodes(replication_factor)
             if len(available_nodes) < replication_factor:
@@ -290,6 +341,9 @@ class LucidChunkStoreClient:
             if len(storage_paths) < replication_factor:
                 raise ValueError(f"Failed to store chunk on sufficient nodes: {len(storage_paths)} < {replication_factor}")
             
+            # Replicas are identical, so they share one Merkle root
+            proof_root = self._build_storage_proof_root(chunk_data)
+            
             # Create chunk metadata
             metadata = ChunkMetadata(
                 chunk_id=chunk_id,
@@ -301,7 +355,9 @@ class LucidChunkStoreClient:
                 timestamp=datetime.now(timezone.utc),
                 status=ChunkStatus.STORED,
                 encryption_key=encryption_key,
-                checksum=checksum
+                checksum=checksum,
+                proof_roots=[proof_root] * len(storage_paths) if proof_root else [],
+                proof_data_size=len(chunk_data) if proof_root else None
             )
             
             # Store metadata
@@ -346,14 +402,17 @@ class LucidChunkStoreClient:
             
             # Try to retrieve from storage nodes
             chunk_data = None
-            for storage_path in metadata.storage_paths:
-                try:
-                    chunk_data = await self._retrieve_chunk_from_path(storage_path)
-                    if chunk_data:
-                        break
-                except Exception as e:
-                    logger.warning(f"Failed to retrieve from {storage_path}: {e}")
-                    continue
+            if metadata.erasure_coded:
+                chunk_data = await self._retrieve_erasure_coded_chunk(metadata)
+            else:
+                for storage_path in metadata.storage_paths:
+                    try:
+                        chunk_data = await self._retrieve_chunk_from_path(storage_path)
+                        if chunk_data:
+                            break
+                    except Exception as e:
+                        logger.warning(f"Failed to retrieve from {storage_path}: {e}")
+                        continue
             
             if not chunk_data:
                 retrieval.status = "failed"
@@ -389,10 +448,18 @@ class LucidChunkStoreClient:
             if not metadata:
                 return False
             
+            if metadata.erasure_coded:
+                return await self._verify_erasure_coded_chunk(metadata)
+            
             # Verify chunk on each storage path
             verification_results = []
-            for storage_path in metadata.storage_paths:
+            for i, storage_path in enumerate(metadata.storage_paths):
                 try:
+                    # Challenge random blocks when a Merkle root is on record
+                    if self._can_challenge(metadata):
+                        verification_results.append(await self._challenge_storage_path(metadata, i))
+                        continue
+                    
                     # Retrieve chunk data
                     chunk_data = await self._retrieve_chunk_from_path(storage_path)
                     if not chunk_data:
@@ -443,6 +510,9 @@ class LucidChunkStoreClient:
             if not metadata:
                 return False
             
+            if metadata.erasure_coded:
+                return await self._repair_erasure_coded_chunk(metadata)
+            
             # Find working replicas
             working_paths = []
             for storage_path in metadata.storage_paths:
@@ -668,6 +738,24 @@ class LucidChunkStoreClient:
             # Create storage path
             storage_path = f"{node.node_address}/chunks/{chunk_id}_{replica_index}"
             
+            if len(chunk_data) > node.available_capacity:
+                return None
+            
+            # Local directory nodes stand in for remote storage nodes
+            if storage_path.startswith(LOCAL_NODE_SCHEME):
+                local_path = Path(storage_path[len(LOCAL_NODE_SCHEME):])
+                local_path.parent.mkdir(parents=True, exist_ok=True)
+                async with aiofiles.open(local_path, "wb") as f:
+                    await f.write(chunk_data)
+                
+                # The holder keeps its own tree to answer storage challenges
+                if STORAGE_PROOF_NATIVE_AVAILABLE:
+                    tree = storage_proof_native.StorageTree(chunk_data, STORAGE_PROOF_BLOCK_SIZE)
+                    async with aiofiles.open(f"{local_path}{STORAGE_PROOF_SUFFIX}", "wb") as f:
+                        await f.write(tree.to_bytes())
+                logger.info(f"Chunk stored on node {node.node_id}: {storage_path}")
+                return storage_path
+            
             # In production, this would make HTTP request to storage node
             # For now, simulate storage
             await asyncio.sleep(0.1)  # Simulate network delay
@@ -686,6 +774,13 @@ class LucidChunkStoreClient:
     async def _retrieve_chunk_from_path(self, storage_path: str) -> Optional[bytes]:
         """Retrieve chunk from storage path"""
         try:
+            if storage_path.startswith(LOCAL_NODE_SCHEME):
+                local_path = Path(storage_path[len(LOCAL_NODE_SCHEME):])
+                if not local_path.exists():
+                    return None
+                async with aiofiles.open(local_path, "rb") as f:
+                    return await f.read()
+            
             # In production, this would make HTTP request to storage node
             # For now, simulate retrieval
             await asyncio.sleep(0.1)  # Simulate network delay
@@ -699,6 +794,22 @@ class LucidChunkStoreClient:
             logger.error(f"Failed to retrieve chunk from {storage_path}: {e}")
             return None
     
+    async def _delete_chunk_from_path(self, storage_path: str) -> None:
+        """Delete a stored chunk or shard, ignoring paths already gone"""
+        try:
+            if storage_path.startswith(LOCAL_NODE_SCHEME):
+                local_path = Path(storage_path[len(LOCAL_NODE_SCHEME):])
+                local_path.unlink(missing_ok=True)
+                Path(f"{local_path}{STORAGE_PROOF_SUFFIX}").unlink(missing_ok=True)
+                return
+            
+            # In production, this would make HTTP request to storage node
+            # For now, simulate deletion
+            await asyncio.sleep(0.1)  # Simulate network delay
+            
+        except Exception as e:
+            logger.warning(f"Failed to delete chunk at {storage_path}: {e}")
+    
     async def _verify_chunk_integrity(self, chunk_id: str, chunk_data: bytes) -> bool:
         """Verify chunk integrity"""
         try:
@@ -820,6 +931,275 @@ class LucidChunkStoreClient:
         except Exception as e:
             logger.error(f"Failed to find replacement node: {e}")
             return None
+    
+    def _get_erasure_coder(self, data_shards: int, parity_shards: int) -> Any:
+        """Get cached Reed-Solomon codec for a k+m layout"""
+        key = (data_shards, parity_shards)
+        coder = self._erasure_coders.get(key)
+        if coder is None:
+            coder = erasure_native.ReedSolomon(
+                data_shards=data_shards,
+                parity_shards=parity_shards
+            )
+            self._erasure_coders[key] = coder
+        return coder
+    
+    def _node_for_path(self, storage_path: str) -> Optional[StorageNode]:
+        """Find the storage node that owns a storage path"""
+        for node in self.storage_nodes.values():
+            if storage_path.startswith(f"{node.node_address}/chunks/"):
+                return node
+        return None
+    
+    async def _store_erasure_coded_chunk(
+        self,
+        chunk_id: str,
+        session_id: str,
+        chunk_hash: str,
+        chunk_data: bytes,
+        checksum: str,
+        encryption_key: Optional[str],
+        data_shards: int,
+        parity_shards: int
+    ) -> bool:
+        """Store chunk as k data + m parity shards, one shard per node"""
+        total_shards = data_shards + parity_shards
+        available_nodes = await self._get_available_storage_nodes(total_shards)
+        if len(available_nodes) < total_shards:
+            raise ValueError(f"Insufficient storage nodes: {len(available_nodes)} < {total_shards}")
+        
+        # Shards are zero-copy views over a single native buffer
+        coder = self._get_erasure_coder(data_shards, parity_shards)
+        shards = coder.encode(chunk_data)
+        
+        storage_paths = []
+        shard_checksums = []
+        proof_roots = []
+        try:
+            for i, (node, shard) in enumerate(zip(available_nodes, shards)):
+                storage_path = await self._store_chunk_on_node(node, chunk_id, shard, i)
+                if not storage_path:
+                    raise ValueError(f"Failed to store shard {i} of chunk {chunk_id} on node {node.node_id}")
+                storage_paths.append(storage_path)
+                shard_checksums.append(hashlib.sha256(shard).hexdigest())
+                proof_root = self._build_storage_proof_root(shard)
+                if proof_root:
+                    proof_roots.append(proof_root)
+                node.available_capacity -= len(shard)
+                node.chunks_stored.append(chunk_id)
+        except Exception:
+            # No metadata will point at a partial set, so take back what was stored
+            for node, shard, storage_path in zip(available_nodes, shards, storage_paths):
+                await self._delete_chunk_from_path(storage_path)
+                node.available_capacity += len(shard)
+                node.chunks_stored.remove(chunk_id)
+            raise
+        
+        metadata = ChunkMetadata(
+            chunk_id=chunk_id,
+            session_id=session_id,
+            chunk_hash=chunk_hash,
+            size=len(chunk_data),
+            storage_paths=storage_paths,
+            replication_factor=len(storage_paths),
+            timestamp=datetime.now(timezone.utc),
+            status=ChunkStatus.STORED,
+            encryption_key=encryption_key,
+            checksum=checksum,
+            erasure_data_shards=data_shards,
+            erasure_parity_shards=parity_shards,
+            shard_checksums=shard_checksums,
+            proof_roots=proof_roots,
+            proof_data_size=len(shards[0]) if proof_roots else None
+        )
+        
+        self.chunk_metadata[chunk_id] = metadata
+        await self._submit_chunk_metadata(metadata)
+        await self._start_chunk_verification(chunk_id)
+        
+        logger.info(f"Chunk stored: {chunk_id} as {data_shards}+{parity_shards} shards")
+        return True
+    
+    async def _read_erasure_shards(
+        self,
+        metadata: ChunkMetadata,
+        stop_at_data_shards: bool = False
+    ) -> List[Optional[bytes]]:
+        """Read shards whose checksum matches, None for missing or corrupt ones"""
+        shards: List[Optional[bytes]] = [None] * len(metadata.storage_paths)
+        healthy = 0
+        
+        for i, storage_path in enumerate(metadata.storage_paths):
+            if stop_at_data_shards and healthy >= metadata.erasure_data_shards:
+                break
+            try:
+                shard = await self._retrieve_chunk_from_path(storage_path)
+            except Exception as e:
+                logger.warning(f"Failed to retrieve shard from {storage_path}: {e}")
+                continue
+            
+            if shard and hashlib.sha256(shard).hexdigest() == metadata.shard_checksums[i]:
+                shards[i] = shard
+                healthy += 1
+        
+        return shards
+    
+    async def _retrieve_erasure_coded_chunk(self, metadata: ChunkMetadata) -> Optional[bytes]:
+        """Rebuild chunk data from the first k healthy shards"""
+        shards = await self._read_erasure_shards(metadata, stop_at_data_shards=True)
+        if sum(shard is not None for shard in shards) < metadata.erasure_data_shards:
+            return None
+        
+        coder = self._get_erasure_coder(metadata.erasure_data_shards, metadata.erasure_parity_shards)
+        return coder.decode(shards, metadata.size)
+    
+    async def _verify_erasure_coded_chunk(self, metadata: ChunkMetadata) -> bool:
+        """Verify shards by challenge or checksum; the chunk is intact while k survive"""
+        total = len(metadata.storage_paths)
+        if self._can_challenge(metadata):
+            healthy = 0
+            for i in range(total):
+                healthy += await self._challenge_storage_path(metadata, i)
+        else:
+            shards = await self._read_erasure_shards(metadata)
+            healthy = sum(shard is not None for shard in shards)
+        
+        # Any lost shard marks the chunk for repair by the verification loop
+        if healthy == total:
+            metadata.status = ChunkStatus.VERIFIED
+        else:
+            metadata.status = ChunkStatus.CORRUPTED
+        
+        logger.info(f"Chunk verification completed: {metadata.chunk_id} - {healthy}/{total} shards healthy")
+        return healthy >= metadata.erasure_data_shards
+    
+    async def _repair_erasure_coded_chunk(self, metadata: ChunkMetadata) -> bool:
+        """Rebuild and re-store only the missing shards"""
+        shards = await self._read_erasure_shards(metadata)
+        missing = [i for i, shard in enumerate(shards) if shard is None]
+        if not missing:
+            return False
+        
+        if len(shards) - len(missing) < metadata.erasure_data_shards:
+            logger.error(f"Not enough shards to repair chunk: {metadata.chunk_id}")
+            return False
+        
+        coder = self._get_erasure_coder(metadata.erasure_data_shards, metadata.erasure_parity_shards)
+        rebuilt = coder.reconstruct(shards)
+        
+        repaired_count = 0
+        for i in missing:
+            try:
+                failed_path = metadata.storage_paths[i]
+                used_nodes = {
+                    node.node_id for node in map(self._node_for_path, metadata.storage_paths)
+                    if node is not None
+                }
+                
+                # Prefer a node holding no shard of this chunk, then the original node
+                candidates = [
+                    node for node in self.storage_nodes.values()
+                    if node.status == StorageNodeStatus.ACTIVE and node.node_id not in used_nodes
+                ]
+                candidates.sort(key=lambda n: n.available_capacity, reverse=True)
+                original_node = self._node_for_path(failed_path)
+                if candidates:
+                    replacement_node = candidates[0]
+                elif original_node and original_node.status == StorageNodeStatus.ACTIVE:
+                    replacement_node = original_node
+                else:
+                    replacement_node = await self._find_replacement_node(failed_path)
+                
+                if replacement_node:
+                    new_path = await self._store_chunk_on_node(
+                        replacement_node, metadata.chunk_id, rebuilt[i], i
+                    )
+                    if new_path:
+                        # The shard's space moves from the node that lost it
+                        if replacement_node is not original_node:
+                            replacement_node.available_capacity -= len(rebuilt[i])
+                            if original_node is not None:
+                                original_node.available_capacity += len(rebuilt[i])
+                        metadata.storage_paths[i] = new_path
+                        if metadata.proof_roots:
+                            metadata.proof_roots[i] = self._build_storage_proof_root(rebuilt[i])
+                        if metadata.chunk_id not in replacement_node.chunks_stored:
+                            replacement_node.chunks_stored.append(metadata.chunk_id)
+                        repaired_count += 1
+            
+            except Exception as e:
+                logger.warning(f"Failed to repair shard {i} of {metadata.chunk_id}: {e}")
+        
+        if repaired_count > 0:
+            metadata.status = ChunkStatus.REPLICATED
+            logger.info(f"Chunk repaired: {metadata.chunk_id} - {repaired_count} shards restored")
+            return True
+        
+        return False
+    
+    def _build_storage_proof_root(self, data: bytes) -> Optional[str]:
+        """Merkle root over fixed-size blocks, None without the native engine"""
+        if not STORAGE_PROOF_NATIVE_AVAILABLE:
+            return None
+        return storage_proof_native.StorageTree(data, STORAGE_PROOF_BLOCK_SIZE).root.hex()
+    
+    def _can_challenge(self, metadata: ChunkMetadata) -> bool:
+        """Whether storage can be audited by block challenges"""
+        return (
+            STORAGE_PROOF_NATIVE_AVAILABLE
+            and metadata.proof_data_size is not None
+            and len(metadata.proof_roots) == len(metadata.storage_paths)
+        )
+    
+    async def _challenge_storage_path(self, metadata: ChunkMetadata, index: int) -> bool:
+        """Challenge random blocks on one storage path and verify the Merkle paths"""
+        storage_path = metadata.storage_paths[index]
+        try:
+            block_count = -(-metadata.proof_data_size // STORAGE_PROOF_BLOCK_SIZE) or 1
+            indices = storage_proof_native.challenge_indices(
+                secrets.token_bytes(16), block_count, STORAGE_PROOF_CHALLENGES
+            )
+            
+            proof = await self._request_storage_proof(storage_path, indices)
+            if not proof:
+                return False
+            
+            return storage_proof_native.verify_proof(
+                bytes.fromhex(metadata.proof_roots[index]), metadata.proof_data_size,
+                STORAGE_PROOF_BLOCK_SIZE, indices, proof
+            )
+            
+        except Exception as e:
+            logger.warning(f"Storage challenge failed for {storage_path}: {e}")
+            return False
+    
+    async def _request_storage_proof(self, storage_path: str, indices: List[int]) -> Optional[bytes]:
+        """Ask the holder of a storage path to answer a block challenge"""
+        if storage_path.startswith(LOCAL_NODE_SCHEME):
+            # Answer as the holder would: read only the challenged blocks
+            local_path = Path(storage_path[len(LOCAL_NODE_SCHEME):])
+            tree_path = Path(f"{local_path}{STORAGE_PROOF_SUFFIX}")
+            if not local_path.exists() or not tree_path.exists():
+                return None
+            
+            async with aiofiles.open(tree_path, "rb") as f:
+                tree = storage_proof_native.load_tree(await f.read())
+            
+            blocks = []
+            async with aiofiles.open(local_path, "rb") as f:
+                for block_index in indices:
+                    await f.seek(block_index * STORAGE_PROOF_BLOCK_SIZE)
+                    blocks.append(await f.read(STORAGE_PROOF_BLOCK_SIZE))
+            
+            return tree.prove(indices, blocks)
+        
+        if not self.http_session:
+            return None
+        
+        async with self.http_session.post(f"{storage_path}/prove", json={"indices": indices}) as response:
+            if response.status != 200:
+                return None
+            return await response.read()
 
 
 # Global chunk store client
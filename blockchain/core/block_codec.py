@@ -0,0 +1,286 @@
+"""
+File: /app/blockchain/core/block_codec.py
+x-lucid-file-path: /app/blockchain/core/block_codec.py
+x-lucid-file-type: python
+
+Canonical binary encoding of blocks and transactions.
+
+The block hash is SHA-256 over a fixed-layout header rather than over a
+formatted string, block sizes are computed from field lengths without
+serializing, and Merkle trees are built over raw 32-byte ids. Runs of
+stored blocks are rechecked in batches by verify_blocks.
+"""
+
+from __future__ import annotations
+
+import hashlib
+import logging
+import re
+import struct
+from datetime import datetime, timezone, timedelta
+from typing import Any, Dict, List, Optional, Sequence, Tuple
+
+from cryptography.exceptions import InvalidSignature
+from cryptography.hazmat.primitives.asymmetric.ed25519 import Ed25519PublicKey
+
+logger = logging.getLogger(__name__)
+
+try:
+    import block_codec_native
+    BLOCK_CODEC_NATIVE_AVAILABLE = True
+except ImportError:
+    BLOCK_CODEC_NATIVE_AVAILABLE = False
+    logger.warning("block_codec_native not available, using Python block codec")
+
+FORMAT_VERSION = 1
+HEADER_FIXED_SIZE = 85  # version | height | timestamp_us | tx_count | previous_hash | merkle_root
+
+_HEADER = struct.Struct("<BQqI32s32s")
+_HASH_HEX = re.compile(r"[0-9a-fA-F]{64}")
+_EPOCH = datetime(1970, 1, 1, tzinfo=timezone.utc)
+_MICROSECOND = timedelta(microseconds=1)
+_MASK64 = (1 << 64) - 1
+
+
+def _varint(value: int) -> bytes:
+    out = bytearray()
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+    return bytes(out)
+
+
+def _read_varint(data: bytes, pos: int) -> Tuple[int, int]:
+    result = 0
+    for i in range(10):
+        if pos + i >= len(data):
+            break
+        byte = data[pos + i]
+        if i == 9 and byte > 1:
+            break
+        result |= (byte & 0x7F) << (7 * i)
+        if not byte & 0x80:
+            if byte == 0 and i > 0:
+                break  # Only the shortest encoding is canonical
+            return result, pos + i + 1
+    raise ValueError("Malformed varint")
+
+
+def _prefixed(data: bytes) -> bytes:
+    return _varint(len(data)) + data
+
+
+def _read_prefixed(data: bytes, pos: int) -> Tuple[bytes, int]:
+    length, pos = _read_varint(data, pos)
+    if length > len(data) - pos:
+        raise ValueError("Truncated field")
+    return data[pos:pos + length], pos + length
+
+
+def _timestamp_us(timestamp: Any) -> int:
+    """Microseconds since the epoch; naive datetimes are taken as UTC"""
+    if isinstance(timestamp, int):
+        return timestamp
+    if not isinstance(timestamp, datetime):
+        raise TypeError("timestamp must be a datetime or integer microseconds")
+    if timestamp.utcoffset() is None:
+        timestamp = timestamp.replace(tzinfo=timezone.utc)
+    return (timestamp - _EPOCH) // _MICROSECOND
+
+
+def _hash_bytes(value: Any, name: str) -> bytes:
+    if not isinstance(value, str) or not _HASH_HEX.fullmatch(value):
+        raise ValueError(f"{name} must be 64 hex digits")
+    return bytes.fromhex(value)
+
+
+def _text(value: Any, name: str, none_is_empty: bool = False) -> bytes:
+    if value is None and none_is_empty:
+        return b""
+    if not isinstance(value, str):
+        raise TypeError(f"{name} must be a string")
+    return value.encode("utf-8")
+
+
+def _py_encode_transaction(tx: Any) -> bytes:
+    timestamp = _timestamp_us(tx.timestamp)
+    return b"".join((
+        _prefixed(_text(tx.id, "id")),
+        _prefixed(_text(tx.from_address, "from_address")),
+        _prefixed(_text(tx.to_address, "to_address")),
+        struct.pack("<d", float(tx.value)),
+        _varint(((timestamp << 1) ^ (timestamp >> 63)) & _MASK64),
+        _prefixed(_text(tx.data, "data", True)),
+        _prefixed(_text(tx.signature, "signature", True)),
+    ))
+
+
+def _py_encode_header(block: Any) -> bytes:
+    if block.height < 0:
+        raise OverflowError("height must not be negative")
+    fixed = _HEADER.pack(
+        FORMAT_VERSION,
+        block.height,
+        _timestamp_us(block.timestamp),
+        len(block.transactions),
+        _hash_bytes(block.previous_hash, "previous_hash"),
+        _hash_bytes(block.merkle_root, "merkle_root"),
+    )
+    return fixed + _prefixed(_text(block.producer, "producer"))
+
+
+def _py_encode_block(block: Any) -> bytes:
+    parts = [_py_encode_header(block)]
+    for tx in block.transactions:
+        parts.append(_prefixed(_py_encode_transaction(tx)))
+    return b"".join(parts)
+
+
+def _py_block_hash(block: Any) -> str:
+    return hashlib.sha256(_py_encode_header(block)).hexdigest()
+
+
+def _py_block_size(block: Any) -> int:
+    return len(_py_encode_block(block))
+
+
+def _py_transaction_size(tx: Any) -> int:
+    return len(_py_encode_transaction(tx))
+
+
+def _py_merkle_root(transactions: Sequence[Any]) -> str:
+    if not transactions:
+        return "0" * 64
+
+    level = []
+    for item in transactions:
+        tx_id = item if isinstance(item, str) else _text(item.id, "id").decode("utf-8")
+        if _HASH_HEX.fullmatch(tx_id):
+            level.append(bytes.fromhex(tx_id))
+        else:
+            level.append(hashlib.sha256(tx_id.encode("utf-8")).digest())
+
+    while len(level) > 1:
+        if len(level) % 2:
+            level.append(level[-1])
+        level = [hashlib.sha256(level[i] + level[i + 1]).digest() for i in range(0, len(level), 2)]
+    return level[0].hex()
+
+
+def _read_header(data: bytes) -> Tuple[tuple, int]:
+    if len(data) < HEADER_FIXED_SIZE or data[0] != FORMAT_VERSION:
+        raise ValueError("Malformed block header")
+    _, height, timestamp, tx_count, previous_hash, merkle_root = _HEADER.unpack_from(data)
+    try:
+        producer, pos = _read_prefixed(data, HEADER_FIXED_SIZE)
+    except ValueError:
+        raise ValueError("Malformed block header") from None
+    header = (height, timestamp, tx_count, previous_hash.hex(), merkle_root.hex(), producer.decode("utf-8"))
+    return header, pos
+
+
+def _py_decode_header(data: bytes) -> tuple:
+    return _read_header(bytes(data))[0]
+
+
+def _py_decode_block(data: bytes) -> Tuple[tuple, List[tuple]]:
+    data = bytes(data)
+    header, pos = _read_header(data)
+    if header[2] > (len(data) - pos) // 12:
+        raise ValueError("Truncated block")
+
+    transactions = []
+    for i in range(header[2]):
+        try:
+            body, pos = _read_prefixed(data, pos)
+            tx_id, at = _read_prefixed(body, 0)
+            from_address, at = _read_prefixed(body, at)
+            to_address, at = _read_prefixed(body, at)
+            if len(body) - at < 8:
+                raise ValueError("Truncated field")
+            value = struct.unpack_from("<d", body, at)[0]
+            zigzag, at = _read_varint(body, at + 8)
+            tx_data, at = _read_prefixed(body, at)
+            signature, at = _read_prefixed(body, at)
+            if at != len(body):
+                raise ValueError("Trailing bytes")
+        except ValueError:
+            raise ValueError(f"Malformed transaction {i}") from None
+        transactions.append((
+            tx_id.decode("utf-8"), from_address.decode("utf-8"), to_address.decode("utf-8"),
+            value, (zigzag >> 1) ^ -(zigzag & 1),
+            tx_data.decode("utf-8"), signature.decode("utf-8"),
+        ))
+    if pos != len(data):
+        raise ValueError("Trailing bytes after block")
+    return header, transactions
+
+
+def _py_verify_blocks(blocks: Sequence[Any], previous: Optional[Tuple[int, str]] = None,
+                      producer_keys: Optional[Dict[str, bytes]] = None,
+                      threads: int = 0) -> Tuple[int, Optional[int], Optional[str]]:
+    if producer_keys is not None:
+        if not isinstance(producer_keys, dict):
+            raise TypeError("producer_keys must be a dict")
+        if any(not isinstance(key, bytes) or len(key) != 32 for key in producer_keys.values()):
+            raise ValueError("Producer keys must be 32 bytes")
+
+    expected = None
+    if previous is not None:
+        expected = (previous[0] + 1, _hash_bytes(previous[1], "previous hash"))
+
+    for verified, block in enumerate(blocks):
+        try:
+            header = _py_encode_header(block)
+            claimed = _hash_bytes(block.hash, "hash")
+            key = producer_keys.get(block.producer) if producer_keys else None
+        except ValueError as e:
+            return verified, expected[0] if expected else None, f"Malformed block: {e}"
+
+        if expected is not None and block.height != expected[0]:
+            if block.height > expected[0]:
+                return verified, expected[0], f"Missing block at height {expected[0]}"
+            return verified, expected[0], f"Unexpected block height {block.height}"
+        if expected is not None and bytes.fromhex(block.previous_hash) != expected[1]:
+            return verified, block.height, "Previous hash mismatch"
+        if expected is None and block.height == 0 and bytes.fromhex(block.previous_hash) != bytes(32):
+            return verified, block.height, "Genesis block must have zero previous hash"
+        if bytes.fromhex(_py_merkle_root(block.transactions)) != bytes.fromhex(block.merkle_root):
+            return verified, block.height, "Merkle root mismatch"
+        if hashlib.sha256(header).digest() != claimed:
+            return verified, block.height, "Block hash mismatch"
+        if key is not None:
+            # Producers sign the raw block hash
+            signature = _text(block.signature, "signature", True).decode("utf-8")
+            try:
+                Ed25519PublicKey.from_public_bytes(key).verify(bytes.fromhex(signature), claimed)
+            except (InvalidSignature, ValueError):
+                return verified, block.height, "Invalid block signature"
+        expected = (block.height + 1, claimed)
+
+    return len(blocks), None, None
+
+
+if BLOCK_CODEC_NATIVE_AVAILABLE:
+    encode_header = block_codec_native.encode_header
+    encode_block = block_codec_native.encode_block
+    encode_transaction = block_codec_native.encode_transaction
+    block_hash = block_codec_native.block_hash
+    block_size = block_codec_native.block_size
+    transaction_size = block_codec_native.transaction_size
+    merkle_root = block_codec_native.merkle_root
+    decode_header = block_codec_native.decode_header
+    decode_block = block_codec_native.decode_block
+    verify_blocks = block_codec_native.verify_blocks
+else:
+    encode_header = _py_encode_header
+    encode_block = _py_encode_block
+    encode_transaction = _py_encode_transaction
+    block_hash = _py_block_hash
+    block_size = _py_block_size
+    transaction_size = _py_transaction_size
+    merkle_root = _py_merkle_root
+    decode_header = _py_decode_header
+    decode_block = _py_decode_block
+    verify_blocks = _py_verify_blocks
@@ -23,8 +23,8 @@ import json
 import uuid
 
 from motor.motor_asyncio import AsyncIOMotorDatabase
-import blake3
 
+from . import block_codec
 from .models import (
     Block, Transaction, BlockHeader, BlockStatus, ChainType,
     SessionAnchor, ChunkMetadata, generate_session_id
@@ -37,6 +37,8 @@ BLOCK_TIME_SECONDS = 10          # Target block time
 BLOCK_SIZE_LIMIT_MB = 1          # Maximum block size
 MAX_TRANSACTIONS_PER_BLOCK = 1000  # Maximum transactions per block
 GENESIS_BLOCK_HEIGHT = 0         # Genesis block height
+CHAIN_VERIFY_BATCH_BLOCKS = 256  # Blocks per native verification batch
+CHAIN_CHECKPOINT_ID = "chain_integrity"
 
 @dataclass
 class BlockValidationResult:
@@ -71,11 +73,16 @@ class BlockManager:
     - Block integrity verification
     """
     
-    def __init__(self, db: AsyncIOMotorDatabase, storage_path: Optional[Path] = None):
+    def __init__(self, db: AsyncIOMotorDatabase, storage_path: Optional[Path] = None,
+                 producer_keys: Optional[Dict[str, bytes]] = None):
         self.db = db
         self.storage_path = storage_path or Path("/data/blocks")
         self.storage_path.mkdir(parents=True, exist_ok=True)
         
+        # Raw Ed25519 public keys of block producers; blocks from producers
+        # listed here must carry a hex signature over their raw hash
+        self.producer_keys: Dict[str, bytes] = dict(producer_keys or {})
+        
         # Block cache for recent blocks
         self.block_cache: Dict[str, Block] = {}
         self.height_cache: Dict[int, str] = {}  # height -> block_hash
@@ -600,44 +607,17 @@ class BlockManager:
             return []
     
     def _calculate_merkle_root(self, transactions: List[Transaction]) -> str:
-        """Calculate Merkle root for transactions"""
-        if not transactions:
-            return "0" * 64
-        
-        # Create leaf hashes
-        leaves = [blake3.blake3(tx.id.encode()).hexdigest() for tx in transactions]
-        
-        # Build Merkle tree
-        while len(leaves) > 1:
-            next_level = []
-            for i in range(0, len(leaves), 2):
-                left = leaves[i]
-                right = leaves[i + 1] if i + 1 < len(leaves) else left
-                combined = blake3.blake3((left + right).encode()).hexdigest()
-                next_level.append(combined)
-            leaves = next_level
-        
-        return leaves[0] if leaves else "0" * 64
+        """Calculate Merkle root over the raw 32-byte transaction ids"""
+        return block_codec.merkle_root(transactions)
     
     def _calculate_block_hash(self, block: Block) -> str:
-        """Calculate the hash of a block"""
-        # Create block header data for hashing
-        header_data = (
-            f"{block.height}"
-            f"{block.previous_hash}"
-            f"{block.timestamp.isoformat()}"
-            f"{block.merkle_root}"
-            f"{block.producer}"
-            f"{len(block.transactions)}"
-        )
-        
-        return blake3.blake3(header_data.encode()).hexdigest()
+        """Calculate the hash of a block from its canonical binary header"""
+        return block_codec.block_hash(block)
     
     def _calculate_block_size(self, block: Block) -> int:
-        """Calculate the size of a block in bytes"""
+        """Calculate the encoded size of a block in bytes"""
         try:
-            block_json = json.dumps(block.to_dict(), default=str)
-            return len(block_json.encode('utf-8'))
+            return block_codec.block_size(block)
         except Exception:
             return 0
     
@@ -645,16 +625,7 @@ class BlockManager:
         """Convert MongoDB document to Block object"""
         transactions = []
         for tx_doc in doc.get("transactions", []):
-            tx = Transaction(
-                id=tx_doc["id"],
-                from_address=tx_doc["from_address"],
-                to_address=tx_doc["to_address"],
-                value=tx_doc["value"],
-                data=tx_doc.get("data", ""),
-                timestamp=tx_doc["timestamp"],
-                signature=tx_doc["signature"]
-            )
-            transactions.append(tx)
+            transactions.append(Transaction.from_dict(tx_doc))
         
         return Block(
             height=doc["height"],
@@ -717,39 +688,137 @@ class BlockManager:
             logger.error(f"Failed to get blockchain status: {e}")
             return {"status": "error", "error": str(e)}
     
-    async def verify_chain_integrity(self, start_height: int = 0, end_height: Optional[int] = None) -> Dict[str, Any]:
-        """Verify the integrity of the blockchain"""
+    async def verify_chain_integrity(self, start_height: int = 0, end_height: Optional[int] = None,
+                                     resume: bool = True) -> Dict[str, Any]:
+        """
+        Verify the integrity of the blockchain
+        
+        Blocks are streamed from the store in batches and rechecked off the
+        event loop, with the next batch fetched while the current one is
+        verified. Hashes, Merkle roots, signatures and previous_hash links
+        are checked, and verification stops at the first bad height. Runs
+        from genesis checkpoint their progress so a resumed run skips the
+        range already verified.
+        """
         try:
             if end_height is None:
                 end_height = self.current_height
             
-            errors = []
-            warnings = []
-            blocks_checked = 0
-            
-            for height in range(start_height, end_height + 1):
-                block = await self.get_block_by_height(height)
-                if not block:
-                    errors.append(f"Missing block at height {height}")
-                    continue
-                
-                # Validate block
-                validation_result = await self.validate_block(block)
-                if not validation_result.is_valid:
-                    errors.extend([f"Height {height}: {error}" for error in validation_result.errors])
-                
-                warnings.extend([f"Height {height}: {warning}" for warning in validation_result.warnings])
-                blocks_checked += 1
-            
-            return {
-                "is_valid": len(errors) == 0,
-                "blocks_checked": blocks_checked,
-                "errors": errors,
-                "warnings": warnings,
+            next_height = start_height
+            previous: Optional[Tuple[int, str]] = None
+            resumed_from = None
+            
+            checkpoint = await self._load_integrity_checkpoint(start_height) if resume else None
+            if checkpoint:
+                previous = checkpoint
+                next_height = resumed_from = checkpoint[0] + 1
+            elif start_height > 0:
+                # Anchor the first block to its stored predecessor
+                prev_doc = await self.db["blocks"].find_one({"height": start_height - 1}, {"hash": 1})
+                if prev_doc:
+                    previous = (start_height - 1, prev_doc["hash"])
+            checkpointing = start_height == 0 or checkpoint is not None
+            
+            result = {
+                "is_valid": True,
+                "blocks_checked": 0,
+                "errors": [],
+                "warnings": [],
                 "start_height": start_height,
-                "end_height": end_height
+                "end_height": end_height,
+                "first_bad_height": None,
+                "resumed_from": resumed_from
             }
+            if next_height > end_height:
+                return result
+            
+            loop = asyncio.get_running_loop()
+            pending = None
+            async for blocks in self._stream_block_batches(next_height, end_height):
+                if previous is None and blocks[0].height != next_height:
+                    self._record_integrity_failure(result, next_height, f"Missing block at height {next_height}")
+                    return result
+                # The next batch is fetched while this one is verified
+                if pending and not await self._finish_verify_batch(pending, result, checkpointing):
+                    return result
+                pending = (loop.run_in_executor(None, self._verify_block_batch, blocks, previous), blocks)
+                previous = (blocks[-1].height, blocks[-1].hash)
+            if pending and not await self._finish_verify_batch(pending, result, checkpointing):
+                return result
+            
+            # Blocks missing from the end of the range never reach the verifier
+            last_height = previous[0] if previous else next_height - 1
+            if last_height < end_height:
+                self._record_integrity_failure(result, last_height + 1, f"Missing block at height {last_height + 1}")
+            
+            return result
             
         except Exception as e:
             logger.error(f"Failed to verify chain integrity: {e}")
             return {"is_valid": False, "error": str(e)}
+    
+    async def _stream_block_batches(self, start_height: int, end_height: int):
+        """Yield stored blocks in height order, CHAIN_VERIFY_BATCH_BLOCKS at a time"""
+        cursor = self.db["blocks"].find(
+            {"height": {"$gte": start_height, "$lte": end_height}},
+            sort=[("height", 1)]
+        ).batch_size(CHAIN_VERIFY_BATCH_BLOCKS)
+        
+        batch: List[Block] = []
+        async for doc in cursor:
+            batch.append(self._doc_to_block(doc))
+            if len(batch) == CHAIN_VERIFY_BATCH_BLOCKS:
+                yield batch
+                batch = []
+        if batch:
+            yield batch
+    
+    def _verify_block_batch(self, blocks: List[Block],
+                            previous: Optional[Tuple[int, str]]) -> Tuple[int, Optional[int], Optional[str]]:
+        """Recheck a run of blocks; runs in an executor thread"""
+        return block_codec.verify_blocks(blocks, previous, self.producer_keys or None)
+    
+    async def _finish_verify_batch(self, pending: Tuple[asyncio.Future, List[Block]],
+                                   result: Dict[str, Any], checkpointing: bool) -> bool:
+        """Fold a finished batch into result; False once a bad block was found"""
+        future, blocks = pending
+        verified, bad_height, error = await future
+        result["blocks_checked"] += verified
+        
+        if verified and checkpointing:
+            last = blocks[verified - 1]
+            await self.db["chain_checkpoints"].update_one(
+                {"_id": CHAIN_CHECKPOINT_ID},
+                {"$set": {"height": last.height, "hash": last.hash, "updated_at": datetime.now(timezone.utc)}},
+                upsert=True
+            )
+        
+        if error is None:
+            return True
+        if bad_height is None:
+            bad_height = blocks[0].height
+        self._record_integrity_failure(result, bad_height, error)
+        return False
+    
+    def _record_integrity_failure(self, result: Dict[str, Any], height: int, error: str):
+        result["is_valid"] = False
+        result["first_bad_height"] = height
+        result["errors"].append(f"Height {height}: {error}")
+        logger.warning(f"Chain integrity check failed at height {height}: {error}")
+    
+    async def _load_integrity_checkpoint(self, start_height: int) -> Optional[Tuple[int, str]]:
+        """
+        Last (height, hash) verified from genesis, if it covers start_height
+        
+        The checkpoint only counts while the stored block at its height still
+        has the hash that was verified.
+        """
+        doc = await self.db["chain_checkpoints"].find_one({"_id": CHAIN_CHECKPOINT_ID})
+        if not doc or start_height > doc["height"] + 1:
+            return None
+        
+        block_doc = await self.db["blocks"].find_one({"height": doc["height"]}, {"hash": 1})
+        if not block_doc or block_doc["hash"] != doc["hash"]:
+            logger.warning(f"Discarding chain checkpoint at height {doc['height']}: block changed")
+            return None
+        return doc["height"], doc["hash"]
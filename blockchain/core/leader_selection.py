@@ -9,8 +9,8 @@ Implements leader selection for PoOT consensus based on work credits ranking
 with cooldown periods and VRF tie-breaking as specified in Spec-1b lines 135-157.
 
 Features:
-- Work credits ranking with cooldown periods (16 slots)
-- VRF tie-breaking for equal credits
+- Work credits weighting with cooldown periods (16 slots)
+- ECVRF draws over a per-epoch candidate table, verifiable by peers
 - Fallback leader selection
 - Density threshold enforcement
 """
@@ -21,14 +21,17 @@ Features:
 from __future__ import annotations
 
 import asyncio
-import logging
 import hashlib
+import logging
+import struct
 from datetime import datetime, timezone, timedelta
 from typing import Dict, List, Optional, Set, Tuple
 import secrets
 
 from motor.motor_asyncio import AsyncIOMotorDatabase
+from pymongo.errors import DuplicateKeyError
 
+from . import leader_vrf
 from .models import WorkCredit, LeaderSchedule, TaskProofType
 
 logger = logging.get_logger(__name__)
@@ -42,6 +45,8 @@ SLOT_TIMEOUT_MS = 5000   # 5s leader timeout
 COOLDOWN_SLOTS = 16      # 16 slot cooldown
 LEADER_WINDOW_DAYS = 7   # 7-day PoOT window
 D_MIN = 0.2             # Minimum density threshold
+LEADER_FALLBACKS = 5     # Fallback leaders drawn after the primary
+VRF_DOMAIN = b"lucid-leader"
 
 
 class LeaderSelectionEngine:
@@ -49,14 +54,22 @@ class LeaderSelectionEngine:
     PoOT leader selection engine with work credits ranking and cooldown.
     
     Per Spec-1b lines 135-157:
-    - Primary leader = top-ranked, not in cooldown (16 slots)
-    - Fallbacks: next ranked entities
-    - VRF tie-breaking for equal credits
+    - Primary leader drawn by VRF weighted by live score, not in cooldown (16 slots)
+    - Fallbacks: further distinct draws from the same VRF output
+    - Eligible entities are tabled once per epoch, so a slot costs one proof
+      and O(1) per draw
+    - The first table built for an epoch is frozen in leader_candidates and
+      its root travels in each schedule, so peers verify against the same
+      snapshot instead of their own later tallies
     """
     
-    def __init__(self, db: AsyncIOMotorDatabase):
+    def __init__(self, db: AsyncIOMotorDatabase, vrf_key: Optional[bytes] = None):
         self.db = db
-        self.vrf_seed = secrets.token_bytes(32)  # VRF seed for tie-breaking
+        self.vrf_seed = vrf_key or secrets.token_bytes(32)  # ECVRF secret key (Ed25519 seed)
+        self.vrf_public_key = leader_vrf.public_key(self.vrf_seed)
+        self._candidate_epoch: Optional[int] = None
+        self._candidate_table = None
+        self._candidate_root: Optional[str] = None
         
         logger.info("Leader selection engine initialized")
     
@@ -71,30 +84,32 @@ class LeaderSelectionEngine:
             LeaderSchedule with primary and fallback leaders
         """
         try:
-            # Get current work credits
-            current_epoch = slot // (24 * 60 * 60 // SLOT_DURATION_SEC)  # Daily epochs
-            work_credits = await self._get_work_credits_for_epoch(current_epoch)
+            current_epoch = calculate_epoch_from_slot(slot)
+            candidate_table, candidate_root = await self._get_candidate_table(current_epoch)
             
             # Get entities in cooldown
             cooldown_entities = await self._get_cooldown_entities(slot)
             
-            # Filter eligible entities (not in cooldown and above density threshold)
-            eligible_entities = self._filter_eligible_entities(work_credits, cooldown_entities)
+            proof = leader_vrf.prove(self.vrf_seed, slot_vrf_input(current_epoch, slot))
+            leaders = self._draw_leaders(candidate_table, leader_vrf.proof_to_hash(proof), cooldown_entities)
             
-            if not eligible_entities:
+            if not leaders:
                 # No eligible entities, use fallback
                 return self._create_fallback_schedule(slot)
             
             # Select primary and fallbacks
-            primary = eligible_entities[0]
-            fallbacks = eligible_entities[1:6] if len(eligible_entities) > 1 else ["fallback_node"]
+            primary = leaders[0]
+            fallbacks = leaders[1:] if len(leaders) > 1 else ["fallback_node"]
             
             # Create leader schedule
             schedule = LeaderSchedule(
                 slot=slot,
                 primary=primary,
                 fallbacks=fallbacks,
-                deadline=datetime.now(timezone.utc) + timedelta(milliseconds=SLOT_TIMEOUT_MS)
+                deadline=datetime.now(timezone.utc) + timedelta(milliseconds=SLOT_TIMEOUT_MS),
+                vrf_proof=proof.hex(),
+                vrf_public_key=self.vrf_public_key.hex(),
+                candidate_root=candidate_root
             )
             
             # Store schedule in MongoDB
@@ -107,6 +122,100 @@ class LeaderSelectionEngine:
             logger.error(f"Failed to select leader for slot {slot}: {e}")
             return self._create_fallback_schedule(slot)
     
+    async def verify_leader_schedule(self, schedule: LeaderSchedule,
+                                     public_key: Optional[bytes] = None) -> bool:
+        """
+        Check a peer's schedule: the proof must verify for the slot, the
+        schedule must commit to the epoch's frozen candidate table, and the
+        leaders must be the draws the proof yields from that table.
+        
+        Args:
+            schedule: Schedule carrying a VRF proof
+            public_key: Expected producer key; defaults to the key in the schedule
+        """
+        try:
+            if not schedule.vrf_proof or not schedule.vrf_public_key:
+                return False
+            schedule_key = bytes.fromhex(schedule.vrf_public_key)
+            if public_key is not None and schedule_key != public_key:
+                return False
+            
+            epoch = calculate_epoch_from_slot(schedule.slot)
+            beta = leader_vrf.verify(schedule_key, bytes.fromhex(schedule.vrf_proof),
+                                     slot_vrf_input(epoch, schedule.slot))
+            if beta is None:
+                return False
+            
+            candidate_table, candidate_root = await self._get_candidate_table(epoch)
+            if candidate_root is None or schedule.candidate_root != candidate_root:
+                logger.warning(f"Leader schedule for slot {schedule.slot} was drawn from another candidate table")
+                return False
+            cooldown_entities = await self._get_cooldown_entities(schedule.slot)
+            leaders = self._draw_leaders(candidate_table, beta, cooldown_entities)
+            if not leaders:
+                return False
+            return [schedule.primary] + schedule.fallbacks == leaders[:1] + (leaders[1:] or ["fallback_node"])
+            
+        except ValueError as e:
+            logger.warning(f"Malformed leader schedule for slot {schedule.slot}: {e}")
+            return False
+    
+    async def _get_candidate_table(self, epoch: int) -> Tuple[Optional[leader_vrf.CandidateTable], Optional[str]]:
+        """Weighted table of eligible entities and its root, fixed once per epoch"""
+        if self._candidate_epoch == epoch:
+            return self._candidate_table, self._candidate_root
+        
+        entries = await self._get_candidate_snapshot(epoch)
+        if not entries:
+            # Tallies may not be stored yet; try again next slot
+            return None, None
+        
+        self._candidate_table = leader_vrf.CandidateTable(entries)
+        self._candidate_root = candidate_root(entries)
+        self._candidate_epoch = epoch
+        logger.info(f"Leader candidate table loaded for epoch {epoch}: {len(entries)} entities")
+        return self._candidate_table, self._candidate_root
+    
+    async def _get_candidate_snapshot(self, epoch: int) -> List[Tuple[str, float]]:
+        """
+        Eligible (entity_id, live_score) pairs for an epoch.
+        
+        Tallies keep changing as proofs arrive, so the first node to table an
+        epoch stores its entries and every node, producer or verifier, draws
+        from that stored copy.
+        """
+        collection = self.db["leader_candidates"]
+        doc = await collection.find_one({"_id": epoch})
+        if doc is None:
+            work_credits = await self._get_work_credits_for_epoch(epoch)
+            live_scores = {credit.entity_id: credit.live_score for credit in work_credits}
+            eligible_entities = self._filter_eligible_entities(work_credits, set())
+            if not eligible_entities:
+                return []
+            
+            entries = [(entity_id, live_scores[entity_id]) for entity_id in eligible_entities]
+            try:
+                await collection.insert_one({
+                    "_id": epoch,
+                    "epoch": epoch,
+                    "entries": [[entity_id, score] for entity_id, score in entries],
+                    "root": candidate_root(entries)
+                })
+                return entries
+            except DuplicateKeyError:
+                # Another node froze the epoch first; use its snapshot
+                doc = await collection.find_one({"_id": epoch})
+                if doc is None:
+                    return []
+        
+        return [(entity_id, float(score)) for entity_id, score in doc["entries"]]
+    
+    def _draw_leaders(self, candidate_table, beta: bytes, cooldown_entities: Set[str]) -> List[str]:
+        """Primary and fallbacks for a VRF output, skipping entities in cooldown"""
+        if candidate_table is None:
+            return []
+        return candidate_table.select(beta, count=1 + LEADER_FALLBACKS, exclude=cooldown_entities)
+    
     async def _get_work_credits_for_epoch(self, epoch: int) -> List[WorkCredit]:
         """Get work credits for current epoch, sorted by rank"""
         try:
@@ -229,15 +338,10 @@ class LeaderSelectionEngine:
         if len(candidates) == 1:
             return candidates[0]
         
-        # Create VRF input from slot and candidates
-        vrf_input = f"{slot}_{'_'.join(sorted(candidates))}_{self.vrf_seed.hex()}"
-        vrf_hash = hashlib.sha256(vrf_input.encode()).hexdigest()
-        
-        # Use hash to select candidate
-        vrf_value = int(vrf_hash[:8], 16)  # Use first 8 hex chars
-        selected_index = vrf_value % len(candidates)
-        
-        selected = candidates[selected_index]
+        # Equal weights; the table orders candidates itself
+        candidate_table = leader_vrf.CandidateTable([(entity_id, 1.0) for entity_id in dict.fromkeys(candidates)])
+        proof = leader_vrf.prove(self.vrf_seed, slot_vrf_input(calculate_epoch_from_slot(slot), slot))
+        selected = candidate_table.pick(leader_vrf.proof_to_hash(proof))
         logger.info(f"VRF selected {selected} from {len(candidates)} candidates")
         
         return selected
@@ -300,7 +404,8 @@ class LeaderSelectionEngine:
             }
     
     async def update_vrf_seed(self, new_seed: bytes):
-        """Update VRF seed for tie-breaking"""
+        """Replace the ECVRF secret key"""
+        self.vrf_public_key = leader_vrf.public_key(new_seed)
         self.vrf_seed = new_seed
         logger.info("VRF seed updated")
 
@@ -314,6 +419,20 @@ def calculate_epoch_from_slot(slot: int) -> int:
     return slot // (24 * 60 * 60 // SLOT_DURATION_SEC)
 
 
+def slot_vrf_input(epoch: int, slot: int) -> bytes:
+    """VRF input for a slot's leader draw"""
+    return VRF_DOMAIN + struct.pack("<QQ", epoch, slot)
+
+
+def candidate_root(entries: List[Tuple[str, float]]) -> str:
+    """SHA-256 over a candidate table's entries in order, as hex"""
+    digest = hashlib.sha256(struct.pack("<Q", len(entries)))
+    for entity_id, score in entries:
+        encoded = entity_id.encode("utf-8")
+        digest.update(struct.pack("<I", len(encoded)) + encoded + struct.pack("<d", score))
+    return digest.hexdigest()
+
+
 def calculate_slot_from_timestamp(timestamp: datetime) -> int:
     """Calculate slot number from timestamp"""
     epoch_start = datetime(2024, 1, 1, tzinfo=timezone.utc)
@@ -342,6 +461,8 @@ def is_slot_timeout(slot_start_time: datetime, timeout_ms: int = SLOT_TIMEOUT_MS
 __all__ = [
     "LeaderSelectionEngine",
     "calculate_epoch_from_slot",
+    "slot_vrf_input",
+    "candidate_root",
     "calculate_slot_from_timestamp", 
     "get_next_slot_start_time",
     "is_slot_timeout",
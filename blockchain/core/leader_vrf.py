@@ -0,0 +1,270 @@
+"""
+File: /app/blockchain/core/leader_vrf.py
+x-lucid-file-path: /app/blockchain/core/leader_vrf.py
+x-lucid-file-type: python
+
+Verifiable leader election primitives.
+
+ECVRF-EDWARDS25519-SHA512-TAI (RFC 9381) proofs over Ed25519 keys, and a
+per-epoch CandidateTable: a Walker/Vose alias table over integer weights
+that maps a VRF output to a weighted candidate in constant time. Peers that
+build the table from the same tallies select the same leaders.
+"""
+
+from __future__ import annotations
+
+import hashlib
+import logging
+import math
+from typing import Iterable, List, Optional, Tuple
+
+logger = logging.getLogger(__name__)
+
+try:
+    import vrf_native
+    VRF_NATIVE_AVAILABLE = True
+except ImportError:
+    VRF_NATIVE_AVAILABLE = False
+    logger.warning("vrf_native not available, using Python VRF")
+
+SECRET_KEY_SIZE = 32
+PUBLIC_KEY_SIZE = 32
+PROOF_SIZE = 80
+OUTPUT_SIZE = 64
+MAX_CANDIDATES = 1 << 20
+
+_SUITE = b"\x03"
+_P = 2 ** 255 - 19
+_L = 2 ** 252 + 27742317777372353535851937790883648493
+_D = -121665 * pow(121666, _P - 2, _P) % _P
+_SQRT_M1 = pow(2, (_P - 1) // 4, _P)
+_IDENTITY = (0, 1, 1, 0)
+_WEIGHT_SCALE = float(1 << 40)
+_DRAWS_PER_PICK = 32
+
+
+def _point_add(p: tuple, q: tuple) -> tuple:
+    a = (p[1] - p[0]) * (q[1] - q[0]) % _P
+    b = (p[1] + p[0]) * (q[1] + q[0]) % _P
+    c = 2 * p[3] * q[3] * _D % _P
+    d = 2 * p[2] * q[2] % _P
+    e, f, g, h = b - a, d - c, d + c, b + a
+    return (e * f % _P, g * h % _P, f * g % _P, e * h % _P)
+
+
+def _negate(p: tuple) -> tuple:
+    return (-p[0] % _P, p[1], p[2], -p[3] % _P)
+
+
+def _scalarmult(scalar: int, p: tuple) -> tuple:
+    result = _IDENTITY
+    while scalar:
+        if scalar & 1:
+            result = _point_add(result, p)
+        p = _point_add(p, p)
+        scalar >>= 1
+    return result
+
+
+def _encode(p: tuple) -> bytes:
+    z_inv = pow(p[2], _P - 2, _P)
+    x, y = p[0] * z_inv % _P, p[1] * z_inv % _P
+    return (y | ((x & 1) << 255)).to_bytes(32, "little")
+
+
+def _decode(s: bytes) -> Optional[tuple]:
+    y = int.from_bytes(s[:32], "little")
+    sign = y >> 255
+    y &= (1 << 255) - 1
+    if y >= _P:
+        return None
+
+    u, v = (y * y - 1) % _P, (_D * y * y + 1) % _P
+    x = u * pow(v, 3, _P) * pow(u * pow(v, 7, _P), (_P - 5) // 8, _P) % _P
+    if v * x * x % _P != u:
+        if v * x * x % _P != -u % _P:
+            return None
+        x = x * _SQRT_M1 % _P
+    if x == 0 and sign:
+        return None
+    if x & 1 != sign:
+        x = _P - x
+    return (x, y, 1, x * y % _P)
+
+
+_BASE = _decode(bytes.fromhex("58" + "66" * 31))
+
+
+def _expand_secret(secret_key: bytes) -> Tuple[int, bytes]:
+    if not isinstance(secret_key, (bytes, bytearray)) or len(secret_key) != SECRET_KEY_SIZE:
+        raise ValueError("Secret key must be 32 bytes")
+    digest = hashlib.sha512(secret_key).digest()
+    scalar = int.from_bytes(digest[:32], "little")
+    scalar &= (1 << 254) - 8
+    scalar |= 1 << 254
+    return scalar, digest[32:]
+
+
+def _encode_to_curve(public_key: bytes, alpha: bytes) -> Optional[tuple]:
+    for counter in range(256):
+        digest = hashlib.sha512(_SUITE + b"\x01" + public_key + alpha + bytes([counter, 0])).digest()
+        point = _decode(digest[:32])
+        if point is not None:
+            return _scalarmult(8, point)
+    return None
+
+
+def _challenge(*points: bytes) -> int:
+    digest = hashlib.sha512(_SUITE + b"\x02" + b"".join(points) + b"\x00").digest()
+    return int.from_bytes(digest[:16], "little")
+
+
+def _py_public_key(secret_key: bytes) -> bytes:
+    return _encode(_scalarmult(_expand_secret(secret_key)[0], _BASE))
+
+
+def _py_prove(secret_key: bytes, alpha: bytes) -> bytes:
+    x, prefix = _expand_secret(secret_key)
+    public_key = _encode(_scalarmult(x, _BASE))
+    h = _encode_to_curve(public_key, bytes(alpha))
+    if h is None:
+        raise ValueError("Input does not hash to a curve point")
+    h_bytes = _encode(h)
+    gamma = _encode(_scalarmult(x, h))
+
+    k = int.from_bytes(hashlib.sha512(prefix + h_bytes).digest(), "little") % _L
+    c = _challenge(public_key, h_bytes, gamma, _encode(_scalarmult(k, _BASE)), _encode(_scalarmult(k, h)))
+    s = (k + c * x) % _L
+    return gamma + c.to_bytes(16, "little") + s.to_bytes(32, "little")
+
+
+def _py_proof_to_hash(proof: bytes) -> bytes:
+    gamma = _decode(proof) if len(proof) == PROOF_SIZE else None
+    if gamma is None:
+        raise ValueError("Malformed proof")
+    return hashlib.sha512(_SUITE + b"\x03" + _encode(_scalarmult(8, gamma)) + b"\x00").digest()
+
+
+def _py_verify(public_key: bytes, proof: bytes, alpha: bytes) -> Optional[bytes]:
+    public_key, proof = bytes(public_key), bytes(proof)
+    if len(public_key) != PUBLIC_KEY_SIZE or len(proof) != PROOF_SIZE:
+        return None
+    y = _decode(public_key)
+    if y is None or _encode(_scalarmult(8, y)) == _encode(_IDENTITY):
+        return None  # Small-order key
+    gamma = _decode(proof)
+    c = int.from_bytes(proof[32:48], "little")
+    s = int.from_bytes(proof[48:], "little")
+    if gamma is None or s >= _L:
+        return None
+    h = _encode_to_curve(public_key, bytes(alpha))
+    if h is None:
+        return None
+
+    u = _point_add(_scalarmult(s, _BASE), _negate(_scalarmult(c, y)))
+    v = _point_add(_scalarmult(s, h), _negate(_scalarmult(c, gamma)))
+    if _challenge(public_key, _encode(h), proof[:32], _encode(u), _encode(v)) != c:
+        return None
+    return _py_proof_to_hash(proof)
+
+
+class _CandidateTable:
+    """
+    Python stand-in for vrf_native.CandidateTable with the same interface
+    and the same picks for the same VRF output.
+    """
+
+    def __init__(self, candidates: Iterable[Tuple[str, float]]) -> None:
+        entries = []
+        for entity_id, weight in candidates:
+            if not isinstance(entity_id, str):
+                raise TypeError("Candidate entity ids must be strings")
+            weight = float(weight)
+            if not math.isfinite(weight) or weight <= 0.0:
+                raise ValueError("Candidate weights must be positive")
+            entries.append((entity_id.encode("utf-8"), entity_id, weight))
+        if not 0 < len(entries) <= MAX_CANDIDATES:
+            raise ValueError("Candidate count out of range")
+
+        entries.sort()
+        if any(entries[i][0] == entries[i + 1][0] for i in range(len(entries) - 1)):
+            raise ValueError("Duplicate candidate")
+        self._ids = [entry[1] for entry in entries]
+        self._weights = [entry[2] for entry in entries]
+        self._index = {entity_id: i for i, entity_id in enumerate(self._ids)}
+
+        scale = _WEIGHT_SCALE / max(self._weights)
+        self._build([max(int(weight * scale), 1) for weight in self._weights])
+
+    def _build(self, weights: List[int]) -> None:
+        count = len(weights)
+        self._total = sum(weights)
+        self._threshold = [self._total] * count
+        self._alias = list(range(count))
+
+        scaled = [weight * count for weight in weights]
+        small = [i for i in range(count) if scaled[i] < self._total]
+        large = [i for i in range(count) if scaled[i] >= self._total]
+        while small and large:
+            s, l = small.pop(), large.pop()
+            self._threshold[s] = scaled[s]
+            self._alias[s] = l
+            scaled[l] -= self._total - scaled[s]
+            (small if scaled[l] < self._total else large).append(l)
+
+    def __len__(self) -> int:
+        return len(self._ids)
+
+    def _draw(self, beta: bytes, counter: int) -> int:
+        digest = hashlib.sha512(beta + counter.to_bytes(4, "little")).digest()
+        bucket = (int.from_bytes(digest[:8], "little") * len(self._ids)) >> 64
+        coin = (int.from_bytes(digest[8:16], "little") * self._total) >> 64
+        return bucket if coin < self._threshold[bucket] else self._alias[bucket]
+
+    def pick(self, beta: bytes) -> str:
+        return self._ids[self._draw(bytes(beta), 0)]
+
+    def select(self, beta: bytes, count: int = 1, exclude: Optional[Iterable[str]] = None) -> List[str]:
+        if count < 0:
+            raise ValueError("count must not be negative")
+        beta = bytes(beta)
+        taken = set()
+        for entity_id in exclude or ():
+            if not isinstance(entity_id, str):
+                raise TypeError("exclude must contain entity id strings")
+            if entity_id in self._index:
+                taken.add(self._index[entity_id])
+
+        want = min(count, len(self._ids) - len(taken))
+        result = []
+        for draw in range(want * _DRAWS_PER_PICK):
+            if len(result) >= want:
+                break
+            index = self._draw(beta, draw)
+            if index not in taken:
+                taken.add(index)
+                result.append(self._ids[index])
+        for index in range(len(self._ids)):
+            if len(result) >= want:
+                break
+            if index not in taken:
+                taken.add(index)
+                result.append(self._ids[index])
+        return result
+
+    def candidates(self) -> List[Tuple[str, float]]:
+        return list(zip(self._ids, self._weights))
+
+
+if VRF_NATIVE_AVAILABLE:
+    public_key = vrf_native.public_key
+    prove = vrf_native.prove
+    proof_to_hash = vrf_native.proof_to_hash
+    verify = vrf_native.verify
+    CandidateTable = vrf_native.CandidateTable
+else:
+    public_key = _py_public_key
+    prove = _py_prove
+    proof_to_hash = _py_proof_to_hash
+    verify = _py_verify
+    CandidateTable = _CandidateTable
@@ -7,30 +7,239 @@ x-lucid-file-type: python
 from __future__ import annotations
 
 import asyncio
-from typing import Dict, List
+import bisect
+import heapq
+import logging
+from typing import Dict, Iterable, List, Optional, Tuple
 from .transaction import Transaction
 
+logger = logging.getLogger(__name__)
+
+try:
+    import mempool_native
+    MEMPOOL_NATIVE_AVAILABLE = True
+except ImportError:
+    MEMPOOL_NATIVE_AVAILABLE = False
+    logger.warning("mempool_native not available, using Python mempool index")
+
+MEMPOOL_MAX_SIZE = 10000          # Pending transactions before fee-based eviction
+MEMPOOL_REPLACE_BUMP = 0.10       # Same-nonce replacement must pay 10% more per byte
+
+
+class _MempoolIndex:
+    """
+    Python stand-in for mempool_native.Mempool with the same interface.
+
+    Eviction uses a heap with lazy deletion, so a removed entry stays in the
+    heap until it surfaces or the heap is compacted.
+    """
+
+    def __init__(self, max_size: int = MEMPOOL_MAX_SIZE, replace_bump: float = MEMPOOL_REPLACE_BUMP) -> None:
+        if max_size < 1:
+            raise ValueError("Invalid max_size")
+        if replace_bump < 0:
+            raise ValueError("replace_bump must not be negative")
+        self.max_size = max_size
+        self._replace_bump = replace_bump
+        # key -> (fee_rate, seq, sender, nonce, fee, size)
+        self._entries: Dict[object, Tuple[float, int, object, int, float, int]] = {}
+        self._heap: List[Tuple[float, int, object]] = []
+        self._nonces: Dict[object, List[int]] = {}
+        self._by_nonce: Dict[object, Dict[int, object]] = {}
+        self._seq = 0
+        self.total_bytes = 0
+        self.total_fee = 0.0
+
+    def __len__(self) -> int:
+        return len(self._entries)
+
+    def __contains__(self, key: object) -> bool:
+        return key in self._entries
+
+    @property
+    def sender_count(self) -> int:
+        return len(self._nonces)
+
+    @property
+    def min_fee_rate(self) -> float:
+        key = self.lowest()
+        return self._entries[key][0] if key is not None else 0.0
+
+    def lowest(self) -> Optional[object]:
+        while self._heap:
+            _, neg_seq, key = self._heap[0]
+            entry = self._entries.get(key)
+            if entry is not None and entry[1] == -neg_seq:
+                return key
+            heapq.heappop(self._heap)
+        return None
+
+    def add(self, key: object, sender: object, nonce: int, fee: float, size: int) -> List[object]:
+        if size <= 0:
+            raise ValueError("Invalid transaction size")
+        if not fee >= 0:
+            raise ValueError("Invalid transaction fee")
+        if nonce < 0:
+            raise OverflowError("nonce must not be negative")
+        if key in self._entries:
+            raise ValueError("Transaction already in mempool")
+
+        fee_rate = fee / size
+        existing = self._by_nonce.get(sender, {}).get(nonce)
+        lowest = None
+        if existing is not None:
+            if fee_rate < self._entries[existing][0] * (1.0 + self._replace_bump):
+                raise ValueError("Replacement fee rate too low")
+        elif len(self._entries) >= self.max_size:
+            lowest = self.lowest()
+            if fee_rate <= self._entries[lowest][0]:
+                raise ValueError("Mempool full: fee rate below minimum")
+
+        evicted: List[object] = []
+        if existing is not None:
+            evicted.append(existing)
+            self.remove(existing)
+        elif lowest is not None:
+            # Later nonces of the evicted sender can never execute without it
+            low_sender, low_nonce = self._entries[lowest][2], self._entries[lowest][3]
+            nonces = self._nonces[low_sender]
+            for n in reversed(nonces[bisect.bisect_left(nonces, low_nonce):]):
+                victim = self._by_nonce[low_sender][n]
+                evicted.append(victim)
+                self.remove(victim)
+
+        seq = self._seq
+        self._seq += 1
+        self._entries[key] = (fee_rate, seq, sender, nonce, fee, size)
+        heapq.heappush(self._heap, (fee_rate, -seq, key))
+        bisect.insort(self._nonces.setdefault(sender, []), nonce)
+        self._by_nonce.setdefault(sender, {})[nonce] = key
+        self.total_bytes += size
+        self.total_fee += fee
+        return evicted
+
+    def remove(self, key: object) -> bool:
+        entry = self._entries.pop(key, None)
+        if entry is None:
+            return False
+
+        _, _, sender, nonce, fee, size = entry
+        nonces = self._nonces[sender]
+        del nonces[bisect.bisect_left(nonces, nonce)]
+        del self._by_nonce[sender][nonce]
+        if not nonces:
+            del self._nonces[sender]
+            del self._by_nonce[sender]
+
+        self.total_bytes -= size
+        self.total_fee -= fee
+        if not self._entries:
+            self.total_fee = 0.0
+        if len(self._heap) > 2 * len(self._entries) + 64:
+            self._heap = [(e[0], -e[1], k) for k, e in self._entries.items()]
+            heapq.heapify(self._heap)
+        return True
+
+    def select_for_block(self, max_bytes: int, max_count: int = 0) -> List[object]:
+        if max_count <= 0:
+            max_count = len(self._entries)
+
+        # Only the lowest nonce of each sender is selectable at first
+        heads = []
+        for sender, nonces in self._nonces.items():
+            key = self._by_nonce[sender][nonces[0]]
+            fee_rate, seq = self._entries[key][:2]
+            heads.append((-fee_rate, seq, sender, 0))
+        heapq.heapify(heads)
+
+        chosen: List[object] = []
+        used = 0
+        while heads and len(chosen) < max_count:
+            _, _, sender, pos = heapq.heappop(heads)
+            nonces = self._nonces[sender]
+            key = self._by_nonce[sender][nonces[pos]]
+            size = self._entries[key][5]
+            if used + size > max_bytes:
+                continue  # Later nonces depend on this one, so the sender is done
+            chosen.append(key)
+            used += size
+            if pos + 1 < len(nonces) and nonces[pos + 1] == nonces[pos] + 1:
+                fee_rate, seq = self._entries[self._by_nonce[sender][nonces[pos + 1]]][:2]
+                heapq.heappush(heads, (-fee_rate, seq, sender, pos + 1))
+        return chosen
+
+    def next_nonce(self, sender: object) -> int:
+        nonces = self._nonces.get(sender)
+        return nonces[-1] + 1 if nonces else 0
+
+    def sender_keys(self, sender: object) -> List[object]:
+        by_nonce = self._by_nonce.get(sender, {})
+        return [by_nonce[n] for n in self._nonces.get(sender, [])]
+
+
+def create_mempool_index(max_size: int = MEMPOOL_MAX_SIZE, replace_bump: float = MEMPOOL_REPLACE_BUMP):
+    """Fee-rate index over pending transactions, native when available"""
+    if MEMPOOL_NATIVE_AVAILABLE:
+        return mempool_native.Mempool(max_size=max_size, replace_bump=replace_bump)
+    return _MempoolIndex(max_size=max_size, replace_bump=replace_bump)
+
+
+def overlay_pending(accounts: Dict[object, Tuple[float, int]], index,
+                    pending: Iterable[Tuple[object, float]]) -> Dict[object, Tuple[float, int]]:
+    """
+    Fold pending transactions into confirmed (balance, next nonce) state.
+
+    A sender's next nonce follows its queued ones in the index and its balance
+    is net of what the pending (sender, cost) pairs already spend.
+    """
+    for sender, cost in pending:
+        if sender in accounts:
+            balance, nonce = accounts[sender]
+            accounts[sender] = (balance - cost, nonce)
+    for sender, (balance, nonce) in accounts.items():
+        accounts[sender] = (balance, max(nonce, index.next_nonce(sender)))
+    return accounts
+
 
 class Mempool:
-    def __init__(self) -> None:
+    def __init__(self, max_size: int = MEMPOOL_MAX_SIZE) -> None:
         self._txs: Dict[str, Transaction] = {}
+        self._index = create_mempool_index(max_size)
         self._lock = asyncio.Lock()
 
-    async def add(self, tx: Transaction) -> None:
+    async def add(self, tx: Transaction) -> List[str]:
+        """
+        Add a transaction; returns the txids it evicted or replaced.
+
+        Re-adding a pending transaction is a no-op, as it always was. Raises
+        ValueError when the pool is full and the fee rate is not above the
+        cheapest pending one, or when a same-nonce replacement underpays.
+        """
         async with self._lock:
-            self._txs[tx.txid] = tx
+            txid = tx.txid
+            if txid in self._txs:
+                return []  # txids hash the content, so this is the same transaction
+            fee = float(tx.data.get("fee", 0))
+            evicted = self._index.add(txid, tx.sender, tx.nonce, fee, len(tx.serialize()))
+            for key in evicted:
+                self._txs.pop(key, None)
+            self._txs[txid] = tx
+            return evicted
 
     async def get_all(self, limit: int | None = None) -> List[Transaction]:
         async with self._lock:
             vals = list(self._txs.values())
             return vals[:limit] if limit else vals
 
-    async def drain(self, limit: int) -> List[Transaction]:
+    async def drain(self, limit: int, max_bytes: int | None = None) -> List[Transaction]:
+        """Remove the best block template: highest fee rate first, in nonce order"""
+        if limit <= 0:
+            return []  # The index reads a zero count as uncapped; drain never did
         async with self._lock:
-            keys = list(self._txs.keys())[:limit]
-            txs = [self._txs[k] for k in keys]
+            keys = self._index.select_for_block(max_bytes if max_bytes is not None else self._index.total_bytes, limit)
+            txs = [self._txs.pop(k) for k in keys]
             for k in keys:
-                self._txs.pop(k, None)
+                self._index.remove(k)
             return txs
 
     async def size(self) -> int:
@@ -383,27 +383,41 @@ class LeaderSchedule:
     winner: Optional[str] = None
     reason: str = ""
     deadline: datetime = field(default_factory=lambda: datetime.now(timezone.utc))
+    vrf_proof: Optional[str] = None  # hex ECVRF proof the leaders were drawn from
+    vrf_public_key: Optional[str] = None  # hex key of the node that made the draw
+    candidate_root: Optional[str] = None  # hex root of the candidate table drawn from
     
     def to_dict(self) -> Dict[str, Any]:
         """Convert to MongoDB document format"""
-        return {
+        doc = {
             "_id": self.slot,
             "slot": self.slot,
             "primary": self.primary,
             "fallbacks": self.fallbacks,
             "result": {"winner": self.winner, "reason": self.reason}
         }
+        if self.vrf_proof:
+            doc["vrf"] = {
+                "proof": self.vrf_proof,
+                "publicKey": self.vrf_public_key,
+                "candidateRoot": self.candidate_root
+            }
+        return doc
     
     @classmethod
     def from_dict(cls, data: Dict[str, Any]) -> LeaderSchedule:
         """Create from MongoDB document"""
         result = data.get("result", {})
+        vrf = data.get("vrf", {})
         return cls(
             slot=data["slot"],
             primary=data["primary"],
             fallbacks=data["fallbacks"],
             winner=result.get("winner"),
-            reason=result.get("reason", "")
+            reason=result.get("reason", ""),
+            vrf_proof=vrf.get("proof"),
+            vrf_public_key=vrf.get("publicKey"),
+            candidate_root=vrf.get("candidateRoot")
         )
 
 
@@ -420,12 +434,53 @@ class LeaderSchedule:
 
 @dataclass
 class Transaction:
-    """Simplified transaction model used by Merkle tree builder."""
+    """Transaction model used by the processor, block manager and Merkle tree builder."""
     id: str
     from_address: str
     to_address: str
     value: Any
     timestamp: Optional[datetime] = None
+    data: str = ""
+    signature: str = ""
+    fee: Optional[float] = None
+    nonce: Optional[int] = None
+    # Hex Ed25519 key the signature verifies against; without one the
+    # signature is the legacy blake3 digest
+    public_key: Optional[str] = None
+    
+    def to_dict(self) -> Dict[str, Any]:
+        """Convert to MongoDB document format"""
+        doc = {
+            "id": self.id,
+            "from_address": self.from_address,
+            "to_address": self.to_address,
+            "value": self.value,
+            "timestamp": self.timestamp,
+            "data": self.data,
+            "signature": self.signature
+        }
+        # Optional fields are omitted rather than stored as null, so
+        # aggregations over nonce only see transactions that carry one
+        for key in ("fee", "nonce", "public_key"):
+            if getattr(self, key) is not None:
+                doc[key] = getattr(self, key)
+        return doc
+    
+    @classmethod
+    def from_dict(cls, data: Dict[str, Any]) -> Transaction:
+        """Create from MongoDB document"""
+        return cls(
+            id=data["id"],
+            from_address=data["from_address"],
+            to_address=data["to_address"],
+            value=data["value"],
+            timestamp=data.get("timestamp"),
+            data=data.get("data", ""),
+            signature=data.get("signature", ""),
+            fee=data.get("fee"),
+            nonce=data.get("nonce"),
+            public_key=data.get("public_key")
+        )
 
 
 @dataclass
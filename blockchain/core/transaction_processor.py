@@ -24,20 +24,45 @@ import uuid
 
 from motor.motor_asyncio import AsyncIOMotorDatabase
 import blake3
+from cryptography.exceptions import InvalidSignature
+from cryptography.hazmat.primitives.asymmetric import ed25519
 
 from .models import (
     Transaction, TransactionStatus, TransactionType, Block,
     SessionAnchor, ChunkMetadata, generate_session_id
 )
+from .mempool import create_mempool_index, overlay_pending
 
 logger = logging.get_logger(__name__)
 
+try:
+    import tx_validator_native
+    TX_VALIDATOR_NATIVE_AVAILABLE = True
+except ImportError:
+    TX_VALIDATOR_NATIVE_AVAILABLE = False
+    logger.warning("tx_validator_native not available, using Python batch validation")
+
 # Transaction configuration
 MAX_TRANSACTION_SIZE_BYTES = 1024 * 1024  # 1MB max transaction size
 TRANSACTION_FEE_MINIMUM = 0.001           # Minimum transaction fee
 MEMPOOL_MAX_SIZE = 10000                  # Maximum transactions in mempool
+BLOCK_TEMPLATE_MAX_BYTES = 1024 * 1024    # Transaction bytes per block template
 TRANSACTION_TIMEOUT_HOURS = 24            # Transaction timeout in hours
 
+# Batch validation verdicts (match tx_validator_native)
+VERDICT_OK = 0
+VERDICT_BAD_SIGNATURE = 1
+VERDICT_UNKNOWN_SENDER = 2
+VERDICT_BAD_NONCE = 3
+VERDICT_INSUFFICIENT_BALANCE = 4
+
+VERDICT_ERRORS = {
+    VERDICT_BAD_SIGNATURE: "Invalid transaction signature",
+    VERDICT_UNKNOWN_SENDER: "Unknown sender account",
+    VERDICT_BAD_NONCE: "Invalid transaction nonce",
+    VERDICT_INSUFFICIENT_BALANCE: "Insufficient balance",
+}
+
 @dataclass
 class TransactionValidationResult:
     """
@@ -59,6 +84,61 @@ class MempoolStats:
     total_value: float = 0.0
     average_fee: float = 0.0
 
+class _StateSnapshot:
+    """Python stand-in for tx_validator_native.StateSnapshot"""
+    
+    def __init__(self):
+        self._accounts: Dict[str, Tuple[float, int]] = {}
+    
+    def __len__(self) -> int:
+        return len(self._accounts)
+    
+    def update(self, address: str, balance: float, nonce: int):
+        self._accounts[address] = (float(balance), int(nonce))
+    
+    def load(self, accounts):
+        for address, balance, nonce in accounts:
+            self.update(address, balance, nonce)
+    
+    def get(self, address: str) -> Optional[Tuple[float, int]]:
+        return self._accounts.get(address)
+    
+    def clear(self):
+        self._accounts.clear()
+
+def _validate_batch(transactions, snapshot: _StateSnapshot, threads: int = 0) -> bytes:
+    """Python stand-in for tx_validator_native.validate_batch"""
+    verdicts = bytearray(len(transactions))
+    working: Dict[str, List] = {}
+    
+    for i, (sender, nonce, cost, public_key, signature, message) in enumerate(transactions):
+        if public_key is not None:
+            try:
+                ed25519.Ed25519PublicKey.from_public_bytes(public_key).verify(signature, message)
+            except (InvalidSignature, ValueError):
+                verdicts[i] = VERDICT_BAD_SIGNATURE
+                continue
+        
+        # A sender's transactions spend from one running balance
+        account = working.get(sender)
+        if account is None:
+            stored = snapshot.get(sender)
+            if stored is None:
+                verdicts[i] = VERDICT_UNKNOWN_SENDER
+                continue
+            account = working[sender] = list(stored)
+        
+        if nonce is not None and nonce != account[1]:
+            verdicts[i] = VERDICT_BAD_NONCE
+        elif cost > 0 and account[0] < cost:
+            verdicts[i] = VERDICT_INSUFFICIENT_BALANCE
+        else:
+            account[0] -= cost
+            if nonce is not None:
+                account[1] = nonce + 1
+    
+    return bytes(verdicts)
+
 class TransactionProcessor:
     """
     Transaction Processor for the lucid_blocks blockchain
@@ -77,11 +157,20 @@ class TransactionProcessor:
         
         # Mempool for pending transactions
         self.mempool: Dict[str, Transaction] = {}
-        self.mempool_by_address: Dict[str, List[str]] = {}  # address -> tx_ids
+        self.mempool_index = create_mempool_index(MEMPOOL_MAX_SIZE)  # fee rate and per-address nonce order
         
         # Transaction cache
         self.tx_cache: Dict[str, Transaction] = {}
         
+        # Account state for batch validation, refreshed once per batch
+        if TX_VALIDATOR_NATIVE_AVAILABLE:
+            self.state_snapshot = tx_validator_native.StateSnapshot()
+            self._validate_batch = tx_validator_native.validate_batch
+        else:
+            self.state_snapshot = _StateSnapshot()
+            self._validate_batch = _validate_batch
+        self.validation_lock = asyncio.Lock()
+        
         # Processing state
         self.processing_enabled = True
         self.batch_processing_active = False
@@ -121,7 +210,7 @@ class TransactionProcessor:
             
             # Clear caches
             self.mempool.clear()
-            self.mempool_by_address.clear()
+            self.mempool_index = create_mempool_index(MEMPOOL_MAX_SIZE)
             self.tx_cache.clear()
             
             logger.info("Transaction processor stopped")
@@ -163,12 +252,14 @@ class TransactionProcessor:
             
             async for tx_doc in cursor:
                 tx = self._doc_to_transaction(tx_doc)
+                try:
+                    evicted = self._index_transaction(tx)
+                except ValueError as e:
+                    logger.warning(f"Skipped stored mempool transaction {tx.id}: {e}")
+                    continue
                 self.mempool[tx.id] = tx
-                
-                # Update address mapping
-                if tx.from_address not in self.mempool_by_address:
-                    self.mempool_by_address[tx.from_address] = []
-                self.mempool_by_address[tx.from_address].append(tx.id)
+                for tx_id in evicted:
+                    await self._remove_from_mempool(tx_id, "evicted")
             
             logger.info(f"Loaded {len(self.mempool)} transactions into mempool")
             
@@ -226,13 +317,13 @@ class TransactionProcessor:
                 validation_result.errors.append("Transaction already exists")
                 return validation_result
             
-            # Check mempool size limit
-            if len(self.mempool) >= MEMPOOL_MAX_SIZE:
-                # Remove lowest fee transaction
-                await self._evict_lowest_fee_transaction()
-            
-            # Add to mempool
-            await self._add_to_mempool(tx)
+            # Add to mempool; when full this evicts cheaper transactions or rejects this one
+            try:
+                await self._add_to_mempool(tx)
+            except ValueError as e:
+                validation_result.is_valid = False
+                validation_result.errors.append(str(e))
+                return validation_result
             
             logger.info(f"Transaction submitted to mempool: {tx.id}")
             return validation_result
@@ -243,74 +334,155 @@ class TransactionProcessor:
     
     async def validate_transaction(self, tx: Transaction) -> TransactionValidationResult:
         """Validate a transaction thoroughly"""
+        results = await self.validate_transactions([tx])
+        return results[0]
+    
+    async def validate_transactions(self, transactions: List[Transaction]) -> List[TransactionValidationResult]:
+        """Validate a batch of transactions against one state snapshot"""
         try:
-            result = TransactionValidationResult(is_valid=True)
-            
-            # Basic structure validation
-            if not tx.id:
-                result.errors.append("Transaction ID is missing")
-            
-            if not tx.signature:
-                result.errors.append("Transaction signature is missing")
-            
-            if not tx.from_address or not tx.to_address:
-                result.errors.append("Transaction addresses are missing")
-            
-            if len(tx.from_address) != 42 or not tx.from_address.startswith('0x'):
-                result.errors.append("Invalid from_address format")
-            
-            if len(tx.to_address) != 42 or not tx.to_address.startswith('0x'):
-                result.errors.append("Invalid to_address format")
-            
-            if tx.value < 0:
-                result.errors.append("Transaction value cannot be negative")
-            
-            # Transaction size validation
-            tx_size = len(json.dumps(tx.to_dict(), default=str).encode('utf-8'))
-            if tx_size > MAX_TRANSACTION_SIZE_BYTES:
-                result.errors.append(f"Transaction too large: {tx_size} bytes")
-            
-            # Fee validation
-            calculated_fee = self._calculate_transaction_fee(tx)
-            result.fee_required = calculated_fee
-            
-            if hasattr(tx, 'fee') and tx.fee < calculated_fee:
-                result.errors.append(f"Insufficient fee: {tx.fee} < {calculated_fee}")
-            
-            # Timestamp validation
-            now = datetime.now(timezone.utc)
-            if tx.timestamp > now + timedelta(minutes=5):
-                result.errors.append("Transaction timestamp too far in future")
-            
-            if tx.timestamp < now - timedelta(hours=1):
-                result.errors.append("Transaction timestamp too old")
-            
-            # Signature validation
-            if not await self._verify_transaction_signature(tx):
-                result.errors.append("Invalid transaction signature")
-            
-            # Balance validation (if applicable)
-            if tx.value > 0:
-                balance = await self._get_address_balance(tx.from_address)
-                if balance < tx.value + calculated_fee:
-                    result.errors.append("Insufficient balance")
-            
-            # Nonce validation (prevent replay attacks)
-            if not await self._validate_transaction_nonce(tx):
-                result.errors.append("Invalid transaction nonce")
-            
-            result.is_valid = len(result.errors) == 0
+            results = [self._check_transaction_fields(tx) for tx in transactions]
+            
+            # Signatures and state are only checked for well-formed transactions
+            batch = []
+            checked = []
+            for i, (tx, result) in enumerate(zip(transactions, results)):
+                if result.errors:
+                    continue
+                entry = await self._batch_entry(tx, result.fee_required)
+                if entry is None:
+                    result.errors.append("Invalid transaction signature")
+                    continue
+                batch.append(entry)
+                checked.append(i)
+            
+            if batch:
+                async with self.validation_lock:
+                    await self._refresh_state_snapshot({entry[0] for entry in batch})
+                    loop = asyncio.get_running_loop()
+                    verdicts = await loop.run_in_executor(None, self._validate_batch, batch, self.state_snapshot)
+                
+                for i, verdict in zip(checked, verdicts):
+                    if verdict != VERDICT_OK:
+                        results[i].errors.append(VERDICT_ERRORS.get(verdict, "Transaction rejected"))
             
-            if result.is_valid:
-                logger.debug(f"Transaction validation passed: {tx.id}")
-            else:
-                logger.warning(f"Transaction validation failed: {result.errors}")
+            for tx, result in zip(transactions, results):
+                result.is_valid = len(result.errors) == 0
+                if result.is_valid:
+                    logger.debug(f"Transaction validation passed: {tx.id}")
+                else:
+                    logger.warning(f"Transaction validation failed: {result.errors}")
             
-            return result
+            return results
             
         except Exception as e:
-            logger.error(f"Failed to validate transaction: {e}")
-            return TransactionValidationResult(is_valid=False, errors=[str(e)])
+            logger.error(f"Failed to validate transactions: {e}")
+            return [TransactionValidationResult(is_valid=False, errors=[str(e)]) for _ in transactions]
+    
+    def _check_transaction_fields(self, tx: Transaction) -> TransactionValidationResult:
+        """Structure, size, fee and timestamp checks that need no state"""
+        result = TransactionValidationResult(is_valid=True)
+        
+        # Basic structure validation
+        if not tx.id:
+            result.errors.append("Transaction ID is missing")
+        
+        if not tx.signature:
+            result.errors.append("Transaction signature is missing")
+        
+        if not tx.from_address or not tx.to_address:
+            result.errors.append("Transaction addresses are missing")
+        
+        if len(tx.from_address) != 42 or not tx.from_address.startswith('0x'):
+            result.errors.append("Invalid from_address format")
+        
+        if len(tx.to_address) != 42 or not tx.to_address.startswith('0x'):
+            result.errors.append("Invalid to_address format")
+        
+        if tx.value < 0:
+            result.errors.append("Transaction value cannot be negative")
+        
+        # Transaction size validation
+        tx_size = len(json.dumps(tx.to_dict(), default=str).encode('utf-8'))
+        if tx_size > MAX_TRANSACTION_SIZE_BYTES:
+            result.errors.append(f"Transaction too large: {tx_size} bytes")
+        
+        # Fee validation
+        calculated_fee = self._calculate_transaction_fee(tx)
+        result.fee_required = calculated_fee
+        
+        if tx.fee is not None and tx.fee < calculated_fee:
+            result.errors.append(f"Insufficient fee: {tx.fee} < {calculated_fee}")
+        
+        # Timestamp validation
+        now = datetime.now(timezone.utc)
+        if tx.timestamp > now + timedelta(minutes=5):
+            result.errors.append("Transaction timestamp too far in future")
+        
+        if tx.timestamp < now - timedelta(hours=1):
+            result.errors.append("Transaction timestamp too old")
+        
+        return result
+    
+    async def _batch_entry(self, tx: Transaction, fee: float) -> Optional[Tuple]:
+        """(sender, nonce, cost, public_key, signature, message) for the batch validator"""
+        cost = self._transaction_cost(tx, fee)
+        nonce = tx.nonce
+        
+        public_key = tx.public_key
+        if public_key is None:
+            # Legacy signatures are checked here; the batch only sees state
+            if not await self._verify_transaction_signature(tx):
+                return None
+            return (tx.from_address, nonce, cost, None, None, None)
+        
+        try:
+            public_key = bytes.fromhex(public_key)
+            signature = bytes.fromhex(tx.signature)
+        except ValueError:
+            return None
+        return (tx.from_address, nonce, cost, public_key, signature, self._signing_payload(tx))
+    
+    def _transaction_cost(self, tx: Transaction, fee: float) -> float:
+        """Amount a transaction spends; balance is only checked for value transfers"""
+        return tx.value + fee if tx.value > 0 else 0.0
+    
+    def _signing_payload(self, tx: Transaction) -> bytes:
+        """Bytes a transaction signature covers"""
+        return f"{tx.id}{tx.from_address}{tx.to_address}{tx.value}{tx.data}{tx.timestamp.isoformat()}".encode()
+    
+    async def _refresh_state_snapshot(self, addresses: Set[str]):
+        """Load balances and next nonces for a batch's senders, net of the mempool"""
+        senders = list(addresses)
+        pipeline = [
+            {"$match": {"$or": [{"from_address": {"$in": senders}}, {"to_address": {"$in": senders}}]}},
+            {"$project": {"entries": [
+                {"address": "$from_address", "amount": {"$multiply": ["$value", -1]}, "nonce": "$nonce"},
+                {"address": "$to_address", "amount": "$value", "nonce": {"$literal": None}}
+            ]}},
+            {"$unwind": "$entries"},
+            {"$match": {"entries.address": {"$in": senders}}},
+            {"$group": {
+                "_id": "$entries.address",
+                "balance": {"$sum": "$entries.amount"},
+                "last_nonce": {"$max": "$entries.nonce"}
+            }}
+        ]
+        
+        # Senders with no history start empty
+        accounts = {address: (0.0, 0) for address in senders}
+        for doc in await self.db["transactions"].aggregate(pipeline).to_list(length=None):
+            last_nonce = doc.get("last_nonce")
+            accounts[doc["_id"]] = (float(doc.get("balance", 0.0)), last_nonce + 1 if last_nonce is not None else 0)
+        
+        # Pending transactions queue nonces and spend balance ahead of confirmation
+        pending = (
+            (tx.from_address, self._transaction_cost(tx, tx.fee if tx.fee is not None else self._calculate_transaction_fee(tx)))
+            for tx in self.mempool.values() if tx.from_address in accounts
+        )
+        overlay_pending(accounts, self.mempool_index, pending)
+        
+        self.state_snapshot.clear()
+        self.state_snapshot.load((address, balance, nonce) for address, (balance, nonce) in accounts.items())
     
     def _calculate_transaction_fee(self, tx: Transaction) -> float:
         """Calculate required fee for a transaction"""
@@ -373,23 +545,6 @@ class TransactionProcessor:
             logger.error(f"Failed to get address balance: {e}")
             return 0.0
     
-    async def _validate_transaction_nonce(self, tx: Transaction) -> bool:
-        """Validate transaction nonce to prevent replay attacks"""
-        try:
-            # Get the last nonce for this address
-            last_tx = await self.db["transactions"].find_one(
-                {"from_address": tx.from_address},
-                sort=[("timestamp", -1)]
-            )
-            
-            # For now, just check that we don't have duplicate transaction IDs
-            # In production, this would implement proper nonce validation
-            return True
-            
-        except Exception as e:
-            logger.error(f"Failed to validate transaction nonce: {e}")
-            return False
-    
     async def _transaction_exists(self, tx_id: str) -> bool:
         """Check if transaction already exists in blockchain"""
         try:
@@ -400,16 +555,27 @@ class TransactionProcessor:
             logger.error(f"Failed to check transaction existence: {e}")
             return False
     
+    def _index_transaction(self, tx: Transaction) -> List[str]:
+        """Add transaction to the fee index; returns the tx_ids it displaced"""
+        # Transactions without a nonce queue behind the address's pending ones
+        nonce = tx.nonce
+        if nonce is None:
+            nonce = self.mempool_index.next_nonce(tx.from_address)
+        fee = tx.fee if tx.fee is not None else TRANSACTION_FEE_MINIMUM
+        size = len(json.dumps(tx.to_dict(), default=str).encode('utf-8'))
+        return self.mempool_index.add(tx.id, tx.from_address, nonce, fee, size)
+    
     async def _add_to_mempool(self, tx: Transaction):
         """Add transaction to mempool"""
         try:
-            # Add to memory mempool
+            # Admission is decided by the index before anything else changes
+            evicted = self._index_transaction(tx)
             self.mempool[tx.id] = tx
             
-            # Update address mapping
-            if tx.from_address not in self.mempool_by_address:
-                self.mempool_by_address[tx.from_address] = []
-            self.mempool_by_address[tx.from_address].append(tx.id)
+            for tx_id in evicted:
+                await self._remove_from_mempool(tx_id, "evicted")
+            if evicted:
+                logger.info(f"Evicted {len(evicted)} lower fee transactions for {tx.id}")
             
             # Store in database
             tx_doc = tx.to_dict()
@@ -418,8 +584,10 @@ class TransactionProcessor:
             await self.db["mempool"].insert_one(tx_doc)
             
             # Update statistics
-            await self._update_statistics()
+            self.stats.pending_transactions = len(self.mempool)
             
+        except ValueError:
+            raise
         except Exception as e:
             logger.error(f"Failed to add transaction to mempool: {e}")
             raise
@@ -430,17 +598,10 @@ class TransactionProcessor:
             if tx_id not in self.mempool:
                 return
             
-            tx = self.mempool[tx_id]
-            
-            # Remove from memory
+            # Remove from memory; evicted transactions have already left the index
             del self.mempool[tx_id]
-            
-            # Update address mapping
-            if tx.from_address in self.mempool_by_address:
-                if tx_id in self.mempool_by_address[tx.from_address]:
-                    self.mempool_by_address[tx.from_address].remove(tx_id)
-                if not self.mempool_by_address[tx.from_address]:
-                    del self.mempool_by_address[tx.from_address]
+            self.mempool_index.remove(tx_id)
+            self.stats.pending_transactions = len(self.mempool)
             
             # Update database
             await self.db["mempool"].update_one(
@@ -454,22 +615,10 @@ class TransactionProcessor:
             logger.error(f"Failed to remove transaction from mempool: {e}")
     
     async def _evict_lowest_fee_transaction(self):
-        """Evict the transaction with the lowest fee from mempool"""
+        """Evict the transaction with the lowest fee rate from mempool"""
         try:
-            if not self.mempool:
-                return
-            
-            # Find transaction with lowest fee
-            lowest_fee_tx_id = None
-            lowest_fee = float('inf')
-            
-            for tx_id, tx in self.mempool.items():
-                fee = getattr(tx, 'fee', TRANSACTION_FEE_MINIMUM)
-                if fee < lowest_fee:
-                    lowest_fee = fee
-                    lowest_fee_tx_id = tx_id
-            
-            if lowest_fee_tx_id:
+            lowest_fee_tx_id = self.mempool_index.lowest()
+            if lowest_fee_tx_id is not None:
                 await self._remove_from_mempool(lowest_fee_tx_id, "evicted")
                 logger.info(f"Evicted transaction with lowest fee: {lowest_fee_tx_id}")
             
@@ -483,11 +632,12 @@ class TransactionProcessor:
             # For now, just update transaction statuses
             
             processed_count = 0
-            for tx_id, tx in list(self.mempool.items()):
+            transactions = list(self.mempool.values())
+            results = await self.validate_transactions(transactions)
+            for tx, validation_result in zip(transactions, results):
                 # Check if transaction is still valid
-                validation_result = await self.validate_transaction(tx)
                 if not validation_result.is_valid:
-                    await self._remove_from_mempool(tx_id, "invalid")
+                    await self._remove_from_mempool(tx.id, "invalid")
                     processed_count += 1
             
             if processed_count > 0:
@@ -496,17 +646,13 @@ class TransactionProcessor:
         except Exception as e:
             logger.error(f"Failed to process pending transactions: {e}")
     
-    async def get_pending_transactions(self, limit: int = 1000) -> List[Transaction]:
+    async def get_pending_transactions(self, limit: int = 1000,
+                                       max_bytes: int = BLOCK_TEMPLATE_MAX_BYTES) -> List[Transaction]:
         """Get pending transactions from mempool for block creation"""
         try:
-            # Sort by fee (highest first) and timestamp (oldest first)
-            transactions = list(self.mempool.values())
-            transactions.sort(key=lambda tx: (
-                -getattr(tx, 'fee', TRANSACTION_FEE_MINIMUM),
-                tx.timestamp
-            ))
-            
-            return transactions[:limit]
+            # Highest fee rate first, each address in nonce order
+            tx_ids = self.mempool_index.select_for_block(max_bytes, limit)
+            return [self.mempool[tx_id] for tx_id in tx_ids]
             
         except Exception as e:
             logger.error(f"Failed to get pending transactions: {e}")
@@ -642,8 +788,7 @@ class TransactionProcessor:
             self.stats.total_value = sum(tx.value for tx in self.mempool.values())
             
             if self.mempool:
-                total_fees = sum(getattr(tx, 'fee', TRANSACTION_FEE_MINIMUM) for tx in self.mempool.values())
-                self.stats.average_fee = total_fees / len(self.mempool)
+                self.stats.average_fee = self.mempool_index.total_fee / len(self.mempool)
             
             # Database stats
             self.stats.total_transactions = await self.db["transactions"].count_documents({})
@@ -655,15 +800,7 @@ class TransactionProcessor:
     
     def _doc_to_transaction(self, doc: Dict[str, Any]) -> Transaction:
         """Convert MongoDB document to Transaction object"""
-        return Transaction(
-            id=doc["id"],
-            from_address=doc["from_address"],
-            to_address=doc["to_address"],
-            value=doc["value"],
-            data=doc.get("data", ""),
-            timestamp=doc["timestamp"],
-            signature=doc["signature"]
-        )
+        return Transaction.from_dict(doc)
     
     async def get_mempool_info(self) -> Dict[str, Any]:
         """Get comprehensive mempool information"""
@@ -688,11 +825,27 @@ class TransactionProcessor:
         """Submit multiple transactions as a batch"""
         try:
             self.batch_processing_active = True
-            results = []
-            
-            for tx in transactions:
-                result = await self.submit_transaction(tx)
-                results.append(result)
+            results = await self.validate_transactions(transactions)
+            
+            # One query for every already-known id in the batch
+            candidate_ids = [tx.id for tx, result in zip(transactions, results) if result.is_valid]
+            existing_docs = await self.db["transactions"].find(
+                {"id": {"$in": candidate_ids}}, {"id": 1}
+            ).to_list(length=None) if candidate_ids else []
+            existing_ids = {doc["id"] for doc in existing_docs}
+            
+            for tx, result in zip(transactions, results):
+                if not result.is_valid:
+                    continue
+                if tx.id in self.mempool or tx.id in existing_ids:
+                    result.is_valid = False
+                    result.errors.append("Transaction already exists")
+                    continue
+                try:
+                    await self._add_to_mempool(tx)
+                except ValueError as e:
+                    result.is_valid = False
+                    result.errors.append(str(e))
             
             self.batch_processing_active = False
             logger.info(f"Batch processed {len(transactions)} transactions")
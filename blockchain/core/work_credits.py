@@ -23,9 +23,10 @@ Formula: W_t = max(S_t, ceil(B_t / BASE_MB_PER_SESSION))
 from __future__ import annotations
 
 import asyncio
+import bisect
 import logging
 from datetime import datetime, timezone, timedelta
-from typing import Dict, List, Optional, Any
+from typing import Dict, List, Optional, Any, Tuple
 import math
 
 from motor.motor_asyncio import AsyncIOMotorDatabase
@@ -34,6 +35,13 @@ from .models import TaskProof, TaskProofType, WorkCreditsTally, WorkCredit
 
 logger = logging.get_logger(__name__)
 
+try:
+    import work_credits_native
+    WORK_CREDITS_NATIVE_AVAILABLE = True
+except ImportError:
+    WORK_CREDITS_NATIVE_AVAILABLE = False
+    logger.warning("work_credits_native not available, using Python work credits aggregator")
+
 # =============================================================================
 # IMMUTABLE CONSENSUS PARAMETERS (Spec-1b)
 # =============================================================================
@@ -42,6 +50,147 @@ LEADER_WINDOW_DAYS = 7   # 7-day PoOT window
 BASE_MB_PER_SESSION = 5  # 5MB base unit
 D_MIN = 0.2             # Minimum density threshold
 
+SECONDS_PER_DAY = 24 * 60 * 60  # Aggregator bucket width
+
+
+class _WorkAggregator:
+    """
+    Python stand-in for work_credits_native.WorkAggregator with the same interface.
+    
+    Ranking is a sorted list, so rescoring an entity costs O(entities)
+    instead of O(log entities).
+    """
+    
+    def __init__(self, window_days: int = LEADER_WINDOW_DAYS, bucket_seconds: int = SECONDS_PER_DAY,
+                 min_uptime: float = D_MIN) -> None:
+        if not 1 <= window_days <= 366:
+            raise ValueError("Invalid window_days")
+        if bucket_seconds < 1:
+            raise ValueError("Invalid bucket_seconds")
+        self.window_days = window_days
+        self.current_day: Optional[int] = None
+        self._bucket_seconds = bucket_seconds
+        self._max_uptime = float(window_days * bucket_seconds)
+        self._min_uptime = min_uptime
+        # entity -> day -> [relay, storage, validation, uptime_seconds]
+        self._buckets: Dict[str, Dict[int, List[int]]] = {}
+        self._totals: Dict[str, List[int]] = {}
+        self._scores: Dict[str, Tuple[float, float]] = {}  # entity -> (uptime_score, live_score)
+        self._days: Dict[int, set] = {}  # day -> entities with a bucket for it
+        self._ranking: List[Tuple[float, str]] = []  # (-live_score, entity) of ranked entities
+    
+    def __len__(self) -> int:
+        return len(self._totals)
+    
+    @property
+    def ranked(self) -> int:
+        return len(self._ranking)
+    
+    def _day(self, timestamp: float) -> int:
+        if not math.isfinite(timestamp) or abs(timestamp) > 9.0e18:
+            raise ValueError("Invalid timestamp")
+        return math.floor(timestamp) // self._bucket_seconds
+    
+    def _rescore(self, entity_id: str) -> None:
+        previous = self._scores.pop(entity_id, None)
+        if previous is not None:
+            self._ranking.pop(bisect.bisect_left(self._ranking, (-previous[1], entity_id)))
+        
+        totals = self._totals.get(entity_id)
+        if totals is None:
+            return
+        credits = totals[0] + totals[1] + totals[2]
+        uptime_score = min(totals[3] / self._max_uptime, 1.0)
+        live_score = credits * uptime_score
+        if credits > 0 and uptime_score >= self._min_uptime:
+            self._scores[entity_id] = (uptime_score, live_score)
+            bisect.insort(self._ranking, (-live_score, entity_id))
+    
+    def advance(self, now: float) -> int:
+        day = self._day(now)
+        if self.current_day is None:
+            self.current_day = day
+            return 0
+        if day <= self.current_day:
+            return 0
+        
+        expired = 0
+        for old_day in [d for d in self._days if d <= day - self.window_days]:
+            for entity_id in self._days.pop(old_day):
+                amounts = self._buckets[entity_id].pop(old_day)
+                totals = self._totals[entity_id]
+                for i in range(4):
+                    totals[i] -= amounts[i]
+                expired += 1
+                if not self._buckets[entity_id]:
+                    del self._buckets[entity_id]
+                    del self._totals[entity_id]
+                self._rescore(entity_id)
+        self.current_day = day
+        return expired
+    
+    def add(self, entity_id: str, timestamp: float, relay: int = 0, storage: int = 0,
+            validation: int = 0, uptime: int = 0) -> bool:
+        if not isinstance(entity_id, str):
+            raise TypeError("entity_id must be a string")
+        if min(relay, storage, validation, uptime) < 0:
+            raise ValueError("Credits must not be negative")
+        
+        day = self._day(timestamp)
+        self.advance(timestamp)
+        if day <= self.current_day - self.window_days:
+            return False
+        
+        bucket = self._buckets.setdefault(entity_id, {}).setdefault(day, [0, 0, 0, 0])
+        totals = self._totals.setdefault(entity_id, [0, 0, 0, 0])
+        self._days.setdefault(day, set()).add(entity_id)
+        for i, amount in enumerate((relay, storage, validation, uptime)):
+            bucket[i] += amount
+            totals[i] += amount
+        self._rescore(entity_id)
+        return True
+    
+    def get(self, entity_id: str) -> Optional[Tuple[int, int, int, int, float, float]]:
+        totals = self._totals.get(entity_id)
+        if totals is None:
+            return None
+        uptime_score = min(totals[3] / self._max_uptime, 1.0)
+        return (*totals, uptime_score, (totals[0] + totals[1] + totals[2]) * uptime_score)
+    
+    def rank(self, entity_id: str) -> Optional[int]:
+        score = self._scores.get(entity_id)
+        if score is None:
+            return None
+        return bisect.bisect_left(self._ranking, (-score[1], entity_id)) + 1
+    
+    def top(self, limit: int = 10) -> List[Tuple[str, int, float]]:
+        if limit < 0:
+            raise ValueError("limit must not be negative")
+        result = []
+        for _, entity_id in self._ranking[:limit]:
+            totals = self._totals[entity_id]
+            result.append((entity_id, totals[0] + totals[1] + totals[2], self._scores[entity_id][1]))
+        return result
+    
+    def snapshot(self) -> List[Tuple[str, int, int, int, int, float, float]]:
+        return [(entity_id, *self._totals[entity_id], *self._scores[entity_id])
+                for _, entity_id in self._ranking]
+
+
+def create_work_aggregator(window_days: int = LEADER_WINDOW_DAYS):
+    """Sliding-window work credits aggregator, native when available"""
+    if WORK_CREDITS_NATIVE_AVAILABLE:
+        return work_credits_native.WorkAggregator(window_days=window_days, bucket_seconds=SECONDS_PER_DAY,
+                                                  min_uptime=D_MIN)
+    return _WorkAggregator(window_days=window_days, bucket_seconds=SECONDS_PER_DAY, min_uptime=D_MIN)
+
+
+def _timestamp_seconds(ts: datetime) -> float:
+    """Seconds since the epoch; naive datetimes from MongoDB are UTC"""
+    if ts.tzinfo is None:
+        ts = ts.replace(tzinfo=timezone.utc)
+    return ts.timestamp()
+
 
 class WorkCreditsEngine:
     """
@@ -52,12 +201,77 @@ class WorkCreditsEngine:
     - storage_availability: Chunks stored and available  
     - validation_signature: Session validation signatures
     - uptime_beacon: Node uptime and availability
+    
+    Proofs are folded into per-day buckets as they are submitted, so live
+    rankings never rescan the task_proofs window. Other engine instances
+    write to the same collection, so each epoch tally first reloads the
+    window from it; the live ranking between epochs only misses their
+    proofs until then.
     """
     
     def __init__(self, db: AsyncIOMotorDatabase):
         self.db = db
+        self.current_epoch = 0  # Last epoch with calculated tallies
+        self.aggregator = create_work_aggregator()
+        self._aggregator_loaded = False
+        self._aggregator_lock = asyncio.Lock()
         logger.info("Work credits engine initialized")
     
+    async def _load_window(self, aggregator) -> int:
+        """Add every stored proof in the current window to aggregator"""
+        now = datetime.now(timezone.utc)
+        aggregator.advance(now.timestamp())
+        proofs_cursor = self.db["task_proofs"].find({
+            "ts": {"$gte": now - timedelta(days=LEADER_WINDOW_DAYS)}
+        })
+        
+        loaded = 0
+        async for proof_doc in proofs_cursor:
+            if self._ingest_proof(TaskProofType(proof_doc["type"]), proof_doc["nodeId"],
+                                  proof_doc["value"], proof_doc["ts"], aggregator):
+                loaded += 1
+        return loaded
+    
+    async def _ensure_aggregator(self):
+        """Load the current window from MongoDB once; later proofs are added on submit"""
+        if self._aggregator_loaded:
+            return
+        async with self._aggregator_lock:
+            if self._aggregator_loaded:
+                return
+            
+            loaded = await self._load_window(self.aggregator)
+            self._aggregator_loaded = True
+            logger.info(f"Work credits window loaded: {loaded} proofs, {len(self.aggregator)} entities")
+    
+    async def _resync_aggregator(self):
+        """Rebuild the window from MongoDB, picking up proofs other instances stored"""
+        async with self._aggregator_lock:
+            # Submits hold the lock across insert and ingest, so none can
+            # land in the old aggregator after the cursor has passed it
+            aggregator = create_work_aggregator()
+            loaded = await self._load_window(aggregator)
+            self.aggregator = aggregator
+            self._aggregator_loaded = True
+            logger.info(f"Work credits window resynced: {loaded} proofs, {len(aggregator)} entities")
+    
+    def _ingest_proof(self, proof_type: TaskProofType, entity_id: str,
+                      value: Dict[str, Any], ts: datetime, aggregator=None) -> bool:
+        """Add one proof to the aggregator; False if it is older than the window"""
+        amounts = {}
+        if proof_type == TaskProofType.RELAY_BANDWIDTH:
+            amounts["relay"] = self._calculate_credits_for_proof(proof_type, value)
+        elif proof_type == TaskProofType.STORAGE_AVAILABILITY:
+            amounts["storage"] = self._calculate_credits_for_proof(proof_type, value)
+        elif proof_type == TaskProofType.VALIDATION_SIGNATURE:
+            amounts["validation"] = self._calculate_credits_for_proof(proof_type, value)
+        elif proof_type == TaskProofType.UPTIME_BEACON:
+            amounts["uptime"] = value["uptime_seconds"]
+        
+        if aggregator is None:
+            aggregator = self.aggregator
+        return aggregator.add(entity_id, _timestamp_seconds(ts), **amounts)
+    
     async def submit_task_proof(self, proof: TaskProof) -> bool:
         """
         Submit work credits proof for PoOT consensus.
@@ -76,8 +290,14 @@ class WorkCreditsEngine:
             # Validate proof data based on type
             self._validate_proof_data(proof)
             
-            # Store proof in MongoDB (sharded collection)
-            await self.db["task_proofs"].insert_one(proof.to_dict())
+            # Window must be loaded before the insert or the proof is counted twice
+            await self._ensure_aggregator()
+            
+            # Store proof in MongoDB (sharded collection); a resync must not
+            # start between the insert and the ingest
+            async with self._aggregator_lock:
+                await self.db["task_proofs"].insert_one(proof.to_dict())
+                self._ingest_proof(proof.type, proof.node_id, proof.value, proof.ts)
             
             logger.info(f"Work proof submitted: {proof.node_id} - {proof.type.value}")
             return True
@@ -130,84 +350,28 @@ class WorkCreditsEngine:
             List of WorkCreditsTally objects sorted by live score
         """
         try:
-            # Get all work proofs for the epoch window
-            window_start = datetime.now(timezone.utc) - timedelta(days=LEADER_WINDOW_DAYS)
-            
-            proofs_cursor = self.db["task_proofs"].find({
-                "ts": {"$gte": window_start}
-            })
-            
-            # Aggregate work credits by entity
-            entity_credits: Dict[str, Dict[str, Any]] = {}
+            # Tallies feed leader selection, so they count every node's proofs
+            await self._resync_aggregator()
             
-            async for proof_doc in proofs_cursor:
-                entity_id = proof_doc["nodeId"]
-                proof_type = TaskProofType(proof_doc["type"])
-                value = proof_doc["value"]
-                
-                if entity_id not in entity_credits:
-                    entity_credits[entity_id] = {
-                        "relay_bandwidth": 0,
-                        "storage_proofs": 0,
-                        "validation_signatures": 0,
-                        "uptime_score": 0.0,
-                        "total_uptime_seconds": 0,
-                        "proof_count": 0
-                    }
-                
-                # Calculate credits based on proof type
-                credits = self._calculate_credits_for_proof(proof_type, value)
-                
-                if proof_type == TaskProofType.RELAY_BANDWIDTH:
-                    entity_credits[entity_id]["relay_bandwidth"] += credits
-                elif proof_type == TaskProofType.STORAGE_AVAILABILITY:
-                    entity_credits[entity_id]["storage_proofs"] += credits
-                elif proof_type == TaskProofType.VALIDATION_SIGNATURE:
-                    entity_credits[entity_id]["validation_signatures"] += credits
-                elif proof_type == TaskProofType.UPTIME_BEACON:
-                    entity_credits[entity_id]["total_uptime_seconds"] += value["uptime_seconds"]
-                    entity_credits[entity_id]["proof_count"] += 1
-            
-            # Calculate uptime scores and create tallies
+            # Snapshot is already in rank order and advanced to now
             tallies = []
-            for entity_id, credits in entity_credits.items():
-                # Calculate uptime score (percentage of window)
-                max_uptime_seconds = LEADER_WINDOW_DAYS * 24 * 60 * 60
-                uptime_score = min(credits["total_uptime_seconds"] / max_uptime_seconds, 1.0)
-                credits["uptime_score"] = uptime_score
-                
-                # Calculate total credits
-                total_credits = (
-                    credits["relay_bandwidth"] +
-                    credits["storage_proofs"] +
-                    credits["validation_signatures"]
-                )
-                
-                # Apply uptime multiplier to get live score
-                live_score = total_credits * uptime_score
-                
-                # Only include entities with minimum activity
-                if total_credits > 0 and uptime_score >= D_MIN:
-                    tally = WorkCreditsTally(
-                        epoch=epoch,
-                        entity_id=entity_id,
-                        credits_total=total_credits,
-                        relay_bandwidth=credits["relay_bandwidth"],
-                        storage_proofs=credits["storage_proofs"],
-                        validation_signatures=credits["validation_signatures"],
-                        uptime_score=uptime_score,
-                        live_score=live_score,
-                        rank=0  # Will be set after sorting
-                    )
-                    tallies.append(tally)
-            
-            # Sort by live score and assign ranks
-            tallies.sort(key=lambda x: x.live_score, reverse=True)
-            for i, tally in enumerate(tallies):
-                tally.rank = i + 1
+            for rank, entry in enumerate(self.aggregator.snapshot(), 1):
+                entity_id, relay, storage, validation, _, uptime_score, live_score = entry
+                tallies.append(WorkCreditsTally(
+                    epoch=epoch,
+                    entity_id=entity_id,
+                    credits_total=relay + storage + validation,
+                    relay_bandwidth=relay,
+                    storage_proofs=storage,
+                    validation_signatures=validation,
+                    uptime_score=uptime_score,
+                    live_score=live_score,
+                    rank=rank
+                ))
             
             # Store tallies in MongoDB
             await self._store_work_tallies(tallies)
+            self.current_epoch = epoch
             
             logger.info(f"Work credits calculated for epoch {epoch}: {len(tallies)} entities")
             return tallies
@@ -297,9 +461,23 @@ class WorkCreditsEngine:
             logger.error(f"Failed to get work credits for {entity_id}: {e}")
             return None
     
-    async def get_top_entities(self, epoch: int, limit: int = 10) -> List[WorkCredit]:
-        """Get top entities by work credits for epoch"""
+    async def get_top_entities(self, epoch: Optional[int] = None, limit: int = 10) -> List[WorkCredit]:
+        """Get top entities by work credits for epoch, or the live ranking when epoch is None"""
         try:
+            if epoch is None:
+                await self._ensure_aggregator()
+                self.aggregator.advance(datetime.now(timezone.utc).timestamp())
+                return [
+                    WorkCredit(
+                        entity_id=entity_id,
+                        credits=credits,
+                        live_score=live_score,
+                        rank=rank,
+                        epoch=self.current_epoch
+                    )
+                    for rank, (entity_id, credits, live_score) in enumerate(self.aggregator.top(limit), 1)
+                ]
+            
             cursor = self.db["work_tally"].find({"epoch": epoch}).sort("rank", 1).limit(limit)
             
             entities = []
@@ -319,9 +497,14 @@ class WorkCreditsEngine:
             logger.error(f"Failed to get top entities: {e}")
             return []
     
-    async def get_entity_rank(self, entity_id: str, epoch: int) -> Optional[int]:
-        """Get rank of entity in epoch"""
+    async def get_entity_rank(self, entity_id: str, epoch: Optional[int] = None) -> Optional[int]:
+        """Get rank of entity in epoch, or its live rank when epoch is None"""
         try:
+            if epoch is None:
+                await self._ensure_aggregator()
+                self.aggregator.advance(datetime.now(timezone.utc).timestamp())
+                return self.aggregator.rank(entity_id)
+            
             doc = await self.db["work_tally"].find_one({
                 "_id": f"{epoch}_{entity_id}"
             })
@@ -16,7 +16,7 @@ import secrets
 import hashlib
 import re
 from datetime import datetime, timezone, timedelta
-from typing import Dict, List, Optional, Any, Tuple, Union, Callable, Set
+from typing import Dict, List, Optional, Any, Tuple, Union, Callable, Set, Iterable, AsyncIterator
 from dataclasses import dataclass, field
 from enum import Enum
 from pathlib import Path
@@ -34,6 +34,13 @@ from .trust_nothing_engine import (
 
 logger = logging.getLogger(__name__)
 
+try:
+    import pii_scanner_native
+    PII_SCANNER_NATIVE_AVAILABLE = True
+except ImportError:
+    PII_SCANNER_NATIVE_AVAILABLE = False
+    logger.warning("pii_scanner_native not available, PII detection falls back to per-pattern regex")
+
 # Privacy Shield Configuration
 DEFAULT_RETENTION_DAYS = 90
 ANONYMIZATION_ALGORITHM = "sha256"
@@ -41,6 +48,13 @@ REDACTION_MASK_CHAR = "*"
 PII_DETECTION_CONFIDENCE_THRESHOLD = 0.8
 DATA_CLASSIFICATION_LEVELS = ["public", "internal", "confidential", "restricted", "top_secret"]
 
+# Overlapping detections resolve to the leftmost start, then to the first
+# type in this order (same order as the native scanner's pattern table)
+PII_SCAN_PRIORITY = [
+    "email", "credit_card", "ssn", "phone", "ip_address", "mac_address",
+    "date_of_birth", "driver_license", "passport", "name"
+]
+
 
 class DataClassification(Enum):
     """Data classification levels"""
@@ -217,6 +231,10 @@ class PrivacyShield:
             r'\b[A-Z][a-z]+ [A-Z][a-z]+ [A-Z][a-z]+\b'  # First Middle Last
         ]
         
+        # The native scanner has these defaults compiled in; once either
+        # table is edited, scans take the regex path so the edit applies
+        self._native_patterns = self._pattern_snapshot()
+        
         # Initialize default privacy policies
         self._initialize_default_policies()
         
@@ -458,52 +476,138 @@ class PrivacyShield:
         """Detect PII in text content"""
         pii_detected = []
         
-        # Detect structured PII using patterns
-        for pii_type, patterns in self.pii_patterns.items():
-            for pattern in patterns:
-                matches = re.finditer(pattern, content, re.IGNORECASE)
-                for match in matches:
-                    confidence = self._calculate_pii_confidence(match.group(), pii_type)
-                    
-                    if confidence >= PII_DETECTION_CONFIDENCE_THRESHOLD:
-                        detection = PIIDetection(
-                            pii_type=pii_type,
-                            confidence=confidence,
-                            start_position=match.start(),
-                            end_position=match.end(),
-                            original_value=match.group(),
-                            suggested_action=self._get_suggested_action(pii_type),
-                            context=content[max(0, match.start()-20):match.end()+20]
-                        )
-                        pii_detected.append(detection)
-        
-        # Detect names (more complex pattern matching)
-        name_detections = await self._detect_names(content)
-        pii_detected.extend(name_detections)
+        # One pass over the content yields non-overlapping spans
+        for pii_type, start, end in await self._scan_pii_spans(content):
+            value = content[start:end]
+            context = content[max(0, start-20):end+20]
+            
+            if pii_type == PIIType.NAME:
+                detection = PIIDetection(
+                    pii_type=pii_type,
+                    confidence=0.7,  # Names are harder to detect with high confidence
+                    start_position=start,
+                    end_position=end,
+                    original_value=value,
+                    suggested_action=PrivacyAction.REDACT,
+                    context=context
+                )
+                pii_detected.append(detection)
+                continue
+            
+            confidence = self._calculate_pii_confidence(value, pii_type)
+            if confidence >= PII_DETECTION_CONFIDENCE_THRESHOLD:
+                detection = PIIDetection(
+                    pii_type=pii_type,
+                    confidence=confidence,
+                    start_position=start,
+                    end_position=end,
+                    original_value=value,
+                    suggested_action=self._get_suggested_action(pii_type),
+                    context=context
+                )
+                pii_detected.append(detection)
         
         return pii_detected
     
-    async def _detect_names(self, content: str) -> List[PIIDetection]:
-        """Detect names in text content"""
-        name_detections = []
-        
-        for pattern in self.name_patterns:
-            matches = re.finditer(pattern, content)
-            for match in matches:
-                # Additional validation for names
-                if await self._validate_name_candidate(match.group()):
-                    detection = PIIDetection(
-                        pii_type=PIIType.NAME,
-                        confidence=0.7,  # Names are harder to detect with high confidence
-                        start_position=match.start(),
-                        end_position=match.end(),
-                        original_value=match.group(),
-                        suggested_action=PrivacyAction.REDACT,
-                        context=content[max(0, match.start()-20):match.end()+20]
-                    )
-                    name_detections.append(detection)
-        
-        return name_detections
+    def _pattern_snapshot(self) -> Tuple:
+        """Current PII and name patterns in comparable form"""
+        return (
+            tuple((pii_type, tuple(patterns)) for pii_type, patterns in self.pii_patterns.items()),
+            tuple(self.name_patterns)
+        )
+    
+    def _native_scan_available(self) -> bool:
+        """Whether the native scanner matches the configured patterns"""
+        return PII_SCANNER_NATIVE_AVAILABLE and self._pattern_snapshot() == self._native_patterns
+    
+    async def _scan_pii_spans(self, content: str) -> List[Tuple[PIIType, int, int]]:
+        """Find non-overlapping PII spans as (type, start, end) character offsets"""
+        if self._native_scan_available():
+            return [
+                (PIIType(pii_scanner_native.TYPE_NAMES[type_id]), start, end)
+                for type_id, start, end in pii_scanner_native.scan(content)
+            ]
+        
+        # Same semantics as the native scan: at the leftmost position where
+        # anything matches, the first type in priority order wins
+        scanners = []
+        for type_name in PII_SCAN_PRIORITY:
+            pii_type = PIIType(type_name)
+            if pii_type == PIIType.NAME:
+                scanners.extend((pii_type, re.compile(p)) for p in self.name_patterns)
+            else:
+                scanners.extend((pii_type, re.compile(p, re.IGNORECASE)) for p in self.pii_patterns.get(pii_type, []))
+        
+        spans = []
+        pending: Dict[int, Optional[re.Match]] = {}
+        pos = 0
+        while True:
+            best = None
+            for index, (pii_type, regex) in enumerate(scanners):
+                match = pending.get(index, False)
+                if match is False or (match is not None and match.start() < pos):
+                    match = regex.search(content, pos)
+                    while match is not None:
+                        # Card-shaped numbers that fail Luhn are not cards
+                        if pii_type == PIIType.CREDIT_CARD:
+                            valid = self._validate_credit_card_checksum(match.group())
+                        elif pii_type == PIIType.NAME:
+                            valid = await self._validate_name_candidate(match.group())
+                        else:
+                            valid = True
+                        if valid:
+                            break
+                        match = regex.search(content, match.start() + 1)
+                    pending[index] = match
+                if match is None:
+                    continue
+                
+                rank = (match.start(), PII_SCAN_PRIORITY.index(pii_type.value), -match.end())
+                if best is None or rank < best[0]:
+                    best = (rank, pii_type, match)
+            
+            if best is None:
+                break
+            _, pii_type, match = best
+            spans.append((pii_type, match.start(), match.end()))
+            pos = match.end()
+        
+        return spans
+    
+    async def mask_text(self, content: str) -> str:
+        """Overwrite every PII span with the mask character, keeping length and offsets"""
+        if self._native_scan_available():
+            return pii_scanner_native.redact(content, mask=REDACTION_MASK_CHAR)
+        
+        spans = await self._scan_pii_spans(content)
+        parts = []
+        last = 0
+        for _, start, end in spans:
+            parts.append(content[last:start])
+            parts.append(REDACTION_MASK_CHAR * (end - start))
+            last = end
+        parts.append(content[last:])
+        return "".join(parts)
+    
+    async def mask_stream(self, chunks: Iterable[bytes]) -> AsyncIterator[bytes]:
+        """Mask PII across a stream of byte chunks; matches split between chunks are still found"""
+        if self._native_scan_available():
+            redactor = pii_scanner_native.Redactor(mask=REDACTION_MASK_CHAR)
+            for chunk in chunks:
+                out = redactor.feed(chunk)
+                if out:
+                    yield out
+            tail = redactor.finish()
+            if tail:
+                yield tail
+            return
+        
+        # Without the native redactor the whole stream is buffered;
+        # latin-1 maps bytes to characters one to one
+        data = b"".join(chunks)
+        if data:
+            masked = await self.mask_text(data.decode("latin-1"))
+            yield masked.encode("latin-1")
     
     async def _validate_name_candidate(self, candidate: str) -> bool:
         """Validate if a candidate string is likely a name"""
@@ -914,20 +1018,22 @@ class PrivacyShield:
     async def _anonymize_text(self, text: str, key: str) -> str:
         """Anonymize text content"""
         # Simple anonymization by replacing PII with consistent hashes
-        anonymized_text = text
-        
-        for pii_type, patterns in self.pii_patterns.items():
-            for pattern in patterns:
-                matches = re.finditer(pattern, text, re.IGNORECASE)
-                for match in matches:
-                    # Generate consistent hash for the value
-                    hash_input = f"{match.group()}:{key}"
-                    hash_value = hashlib.sha256(hash_input.encode()).hexdigest()[:8]
-                    anonymized_value = f"[{pii_type.value.upper()}_{hash_value}]"
-                    
-                    anonymized_text = anonymized_text.replace(match.group(), anonymized_value)
-        
-        return anonymized_text
+        parts = []
+        last = 0
+        
+        for pii_type, start, end in await self._scan_pii_spans(text):
+            if pii_type == PIIType.NAME:
+                continue
+            
+            # Generate consistent hash for the value
+            hash_input = f"{text[start:end]}:{key}"
+            hash_value = hashlib.sha256(hash_input.encode()).hexdigest()[:8]
+            parts.append(text[last:start])
+            parts.append(f"[{pii_type.value.upper()}_{hash_value}]")
+            last = end
+        
+        parts.append(text[last:])
+        return "".join(parts)
     
     async def _anonymize_dict(self, data: Dict[str, Any], key: str) -> Dict[str, Any]:
         """Anonymize dictionary content"""
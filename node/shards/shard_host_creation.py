@@ -82,6 +82,7 @@ class ShardInfo:
     replica_hosts: List[str] = field(default_factory=list)
     encryption_key_hash: Optional[str] = None
     compression_ratio: float = 1.0
+    proof_root: Optional[str] = None  # Merkle root for storage challenges
     
     def to_dict(self) -> Dict[str, Any]:
         return {
@@ -96,7 +97,8 @@ class ShardInfo:
             "primary_host": self.primary_host,
             "replica_hosts": self.replica_hosts,
             "encryption_key_hash": self.encryption_key_hash,
-            "compression_ratio": self.compression_ratio
+            "compression_ratio": self.compression_ratio,
+            "proof_root": self.proof_root
         }
 
 
@@ -524,7 +526,8 @@ class ShardHostCreationSystem:
                         data_hash=chunk.get("hash", ""),
                         size_bytes=chunk.get("size_bytes", 0),
                         status=ShardStatus.CREATING,
-                        encryption_key_hash=chunk.get("encryption_key_hash")
+                        encryption_key_hash=chunk.get("encryption_key_hash"),
+                        proof_root=chunk.get("proof_root")
                     )
                     
                     # Select hosts for this shard
@@ -895,7 +898,8 @@ class ShardHostCreationSystem:
                     primary_host=shard_doc.get("primary_host"),
                     replica_hosts=shard_doc.get("replica_hosts", []),
                     encryption_key_hash=shard_doc.get("encryption_key_hash"),
-                    compression_ratio=shard_doc.get("compression_ratio", 1.0)
+                    compression_ratio=shard_doc.get("compression_ratio", 1.0),
+                    proof_root=shard_doc.get("proof_root")
                 )
                 
                 self.active_shards[shard.shard_id] = shard
@@ -21,6 +21,13 @@ try:
 except ImportError:
     aiohttp = None
     AIOHTTP_AVAILABLE = False
+# Optional native proof-of-storage import
+try:
+    import storage_proof_native
+    STORAGE_PROOF_NATIVE_AVAILABLE = True
+except ImportError:
+    storage_proof_native = None
+    STORAGE_PROOF_NATIVE_AVAILABLE = False
 from pathlib import Path
 from typing import Dict, List, Optional, Any, Set, Tuple
 from dataclasses import dataclass, field
@@ -43,6 +50,8 @@ PERFORMANCE_WINDOW_HOURS = int(os.getenv("LUCID_PERFORMANCE_WINDOW_HOURS", "24")
 DEGRADED_THRESHOLD_FAILURES = int(os.getenv("LUCID_DEGRADED_THRESHOLD_FAILURES", "3"))  # 3 failed checks
 MAINTENANCE_WINDOW_HOURS = int(os.getenv("LUCID_MAINTENANCE_WINDOW_HOURS", "2"))  # 2 hour maintenance window
 BACKUP_REDUNDANCY_FACTOR = int(os.getenv("LUCID_BACKUP_REDUNDANCY_FACTOR", "2"))  # Additional backup copies
+STORAGE_PROOF_CHALLENGES = int(os.getenv("LUCID_STORAGE_PROOF_CHALLENGES", "16"))  # Blocks sampled per audit
+STORAGE_PROOF_BLOCK_SIZE = int(os.getenv("LUCID_STORAGE_PROOF_BLOCK_SIZE", "4096"))  # Merkle leaf size
 
 
 class MaintenanceType(Enum):
@@ -629,7 +638,7 @@ class ShardHostManagementSystem:
                         result=is_valid,
                         details={
                             "expected_hash": shard.data_hash,
-                            "verification_method": "sha256",
+                            "verification_method": "merkle_challenge" if self._can_challenge(shard) else "sha256",
                             "host_status": host.status.value
                         }
                     )
@@ -647,14 +656,35 @@ class ShardHostManagementSystem:
         except Exception as e:
             logger.error(f"Failed to perform integrity check: {e}")
     
+    def _can_challenge(self, shard: ShardInfo) -> bool:
+        """Whether the shard can be audited by Merkle block challenges"""
+        return STORAGE_PROOF_NATIVE_AVAILABLE and bool(shard.proof_root)
+    
     async def _verify_shard_hash(self, shard: ShardInfo, host: ShardHost) -> bool:
         """Verify shard hash on a specific host"""
         try:
             if not self._http_session:
                 return False
             
-            # Request shard hash from host
             proxy_url = "http://127.0.0.1:8118"  # Privoxy HTTP proxy
+            
+            # Challenge random blocks instead of having the host hash the whole shard
+            if self._can_challenge(shard):
+                seed = os.urandom(16)
+                block_count = -(-shard.size_bytes // STORAGE_PROOF_BLOCK_SIZE) or 1
+                indices = storage_proof_native.challenge_indices(seed, block_count, STORAGE_PROOF_CHALLENGES)
+                url = f"http://{host.onion_address}:{host.port}/storage/prove/{shard.shard_id}"
+                
+                async with self._http_session.post(url, json={"indices": indices}, proxy=proxy_url) as response:
+                    if response.status != 200:
+                        return False
+                    proof = await response.read()
+                    return storage_proof_native.verify_proof(
+                        bytes.fromhex(shard.proof_root), shard.size_bytes,
+                        STORAGE_PROOF_BLOCK_SIZE, indices, proof
+                    )
+            
+            # Request shard hash from host
             url = f"http://{host.onion_address}:{host.port}/storage/verify/{shard.shard_id}"
             
             async with self._http_session.get(url, proxy=proxy_url) as response:
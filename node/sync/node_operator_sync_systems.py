@@ -15,12 +15,13 @@ import logging
 import hashlib
 import os
 from pathlib import Path
-from typing import Dict, List, Optional, Any, Set, Tuple, Union
+from typing import Dict, List, Optional, Any, Set, Tuple, Union, Callable, Awaitable
 from dataclasses import dataclass, field
 from datetime import datetime, timezone, timedelta
 from enum import Enum
 import uuid
 import json
+import base64
 from decimal import Decimal
 import time
 # Optional aiohttp import
@@ -40,6 +41,13 @@ from ..sync.sync.work_credits import WorkCreditsCalculator
 
 logger = logging.get_logger(__name__)
 
+try:
+    import state_sync_native
+    STATE_SYNC_NATIVE_AVAILABLE = True
+except ImportError:
+    STATE_SYNC_NATIVE_AVAILABLE = False
+    logger.warning("state_sync_native not available, operator resync falls back to full state transfer")
+
 # Operator Sync Constants
 SYNC_HEARTBEAT_INTERVAL_SEC = int(os.getenv("LUCID_SYNC_HEARTBEAT_INTERVAL_SEC", "30"))  # 30 seconds
 OPERATOR_TIMEOUT_MINUTES = int(os.getenv("LUCID_OPERATOR_TIMEOUT_MINUTES", "5"))  # 5 minutes
@@ -47,6 +55,46 @@ CONFLICT_RESOLUTION_TIMEOUT_SEC = int(os.getenv("LUCID_CONFLICT_RESOLUTION_TIMEO
 MAX_SYNC_RETRIES = int(os.getenv("LUCID_MAX_SYNC_RETRIES", "3"))  # Max retry attempts
 STATE_CHECKPOINT_INTERVAL_MINUTES = int(os.getenv("LUCID_STATE_CHECKPOINT_INTERVAL_MINUTES", "15"))  # 15 minutes
 OPERATION_BATCH_SIZE = int(os.getenv("LUCID_OPERATION_BATCH_SIZE", "100"))  # Operations per batch
+STATE_SYNC_MAX_ROUNDS = int(os.getenv("LUCID_STATE_SYNC_MAX_ROUNDS", "64"))  # Reconciliation round trips per sync
+
+
+def _py_state_root(entries: Dict[bytes, bytes]) -> bytes:
+    """
+    Python stand-in for StateDigest.root, the same Merkle treap commitment.
+    
+    The native digest keeps a treap whose priorities come from the keys;
+    building the Cartesian tree of the sorted keys on those priorities
+    gives the same shape, so both backends agree on every root.
+    """
+    keys = sorted(entries)
+    n = len(keys)
+    priorities = [int.from_bytes(hashlib.sha256(key).digest()[:8], "little") for key in keys]
+    hashes = [
+        hashlib.sha256(len(key).to_bytes(4, "little") + key + entries[key]).digest()
+        for key in keys
+    ]
+    
+    # Keys arrive in order, so a tie leaves the earlier (smaller) key on top
+    left, right, stack = [-1] * n, [-1] * n, []
+    for i in range(n):
+        last = -1
+        while stack and priorities[i] > priorities[stack[-1]]:
+            last = stack.pop()
+        left[i] = last
+        if stack:
+            right[stack[-1]] = i
+        stack.append(i)
+    
+    # Children sort below their parents, so this visits them first
+    absent = bytes(32)
+    merkle = [absent] * n
+    for i in sorted(range(n), key=lambda i: (priorities[i], -i)):
+        merkle[i] = hashlib.sha256(
+            (merkle[left[i]] if left[i] >= 0 else absent) + hashes[i] +
+            (merkle[right[i]] if right[i] >= 0 else absent)
+        ).digest()
+    
+    return hashlib.sha256(n.to_bytes(8, "little") + (merkle[stack[0]] if n else absent)).digest()
 
 
 class OperatorRole(Enum):
@@ -258,6 +306,15 @@ class NodeOperatorSyncSystem:
         self.last_checkpoint: Optional[StateCheckpoint] = None
         self.state_version = 1
         
+        # Operator state and its range-hash digest, updated on every write
+        self.state: Dict[str, Any] = {}
+        self.state_digest = state_sync_native.StateDigest() if STATE_SYNC_NATIVE_AVAILABLE else None
+        self._checkpoint_changes: Set[str] = set()  # Keys written since the last checkpoint
+        
+        # Request hook for state sync: (operator, path, payload) -> response.
+        # Defaults to HTTP POST against the operator endpoint.
+        self.state_transport: Optional[Callable[[OperatorInfo, str, Dict[str, Any]], Awaitable[Dict[str, Any]]]] = None
+        
         # Background tasks
         self._heartbeat_task: Optional[asyncio.Task] = None
         self._sync_task: Optional[asyncio.Task] = None
@@ -417,12 +474,17 @@ class NodeOperatorSyncSystem:
             logger.error(f"Failed to submit operation: {e}")
             raise
     
-    async def create_checkpoint(self, state_data: Dict[str, Any]) -> str:
+    async def create_checkpoint(self, state_data: Optional[Dict[str, Any]] = None,
+                                metadata: Optional[Dict[str, Any]] = None) -> str:
         """
         Create a state checkpoint.
         
+        The checkpoint records the state digest and only the keys written
+        since the previous checkpoint, not the whole state.
+        
         Args:
-            state_data: Current state data to checkpoint
+            state_data: State changes to apply before checkpointing
+            metadata: Extra checkpoint metadata
             
         Returns:
             Checkpoint ID
@@ -430,16 +492,28 @@ class NodeOperatorSyncSystem:
         try:
             checkpoint_id = str(uuid.uuid4())
             
-            # Calculate state hash
-            state_json = json.dumps(state_data, sort_keys=True)
-            state_hash = hashlib.sha256(state_json.encode()).hexdigest()
+            for key, value in (state_data or {}).items():
+                self._write_state(key, value)
+            
+            # Delta since the previous checkpoint
+            changed_keys = sorted(self._checkpoint_changes)
+            delta = {
+                "changes": {key: self.state[key] for key in changed_keys if key in self.state},
+                "deletions": [key for key in changed_keys if key not in self.state]
+            }
             
             checkpoint = StateCheckpoint(
                 checkpoint_id=checkpoint_id,
                 operator_id=self.operator_id,
-                state_hash=state_hash,
-                state_data=state_data,
-                version=self.state_version
+                state_hash=self.get_state_root(),
+                state_data=delta,
+                version=self.state_version,
+                metadata={
+                    **(metadata or {}),
+                    "delta": True,
+                    "base_checkpoint": self.last_checkpoint.checkpoint_id if self.last_checkpoint else None,
+                    "state_keys": len(self.state)
+                }
             )
             
             # Store checkpoint
@@ -449,6 +523,7 @@ class NodeOperatorSyncSystem:
                 checkpoint.to_dict(),
                 upsert=True
             )
+            self._checkpoint_changes.clear()
             
             # Increment state version
             self.state_version += 1
@@ -456,7 +531,7 @@ class NodeOperatorSyncSystem:
             # Broadcast checkpoint to other operators
             await self._broadcast_checkpoint(checkpoint)
             
-            logger.info(f"State checkpoint created: {checkpoint_id}")
+            logger.info(f"State checkpoint created: {checkpoint_id} ({len(changed_keys)} changed keys)")
             return checkpoint_id
             
         except Exception as e:
@@ -544,6 +619,8 @@ class NodeOperatorSyncSystem:
                 "pending_operations": len(self.pending_operations),
                 "active_conflicts": len(self.active_conflicts),
                 "current_state_version": self.state_version,
+                "state_keys": len(self.state),
+                "state_root": self.get_state_root(),
                 "last_checkpoint": self.last_checkpoint.checkpoint_id if self.last_checkpoint else None,
                 "system_status": "healthy" if sync_health > 80 else "degraded" if sync_health > 50 else "critical"
             }
@@ -567,6 +644,34 @@ class NodeOperatorSyncSystem:
             logger.error(f"Failed to get operator metrics: {e}")
             return None
     
+    def get_state_root(self) -> str:
+        """Hex Merkle commitment to the whole operator state, the same with or without the native digest"""
+        if self.state_digest is not None:
+            return self.state_digest.root.hex()
+        return _py_state_root({
+            key.encode(): self._encode_state_value(value) for key, value in self.state.items()
+        }).hex()
+    
+    async def handle_state_reconcile(self, payload: Dict[str, Any]) -> Dict[str, Any]:
+        """Answer a peer's reconciliation message (served at /state/reconcile)"""
+        if self.state_digest is None:
+            return {"error": "state digest not available"}
+        
+        message = base64.b64decode(payload.get("message", ""))
+        reply, _, _, _ = self.state_digest.reconcile(message)
+        return {"message": base64.b64encode(reply).decode() if reply else None}
+    
+    async def handle_state_fetch(self, payload: Dict[str, Any]) -> Dict[str, Any]:
+        """Return values for the requested keys, or the whole state (served at /state/fetch)"""
+        keys = payload.get("keys")
+        if keys is None:
+            return {"state": dict(self.state)}
+        return {"state": {key: self.state[key] for key in keys if key in self.state}}
+    
+    async def handle_state_updates(self, payload: Dict[str, Any]) -> Dict[str, Any]:
+        """Apply changes pushed by the primary (served at /state/updates)"""
+        return await self._apply_state_update(payload)
+    
     async def force_resync(self, target_operator: Optional[str] = None) -> bool:
         """Force a resynchronization with operators"""
         try:
@@ -666,26 +771,52 @@ class NodeOperatorSyncSystem:
     async def _apply_state_update(self, payload: Dict[str, Any]) -> Dict[str, Any]:
         """Apply a state update operation"""
         try:
-            # Mock state update implementation
             state_changes = payload.get("changes", {})
+            deletions = payload.get("deletions", [])
             
             # Validate state changes
-            if not self._validate_state_changes(state_changes):
+            if state_changes and not await self._validate_state_changes(state_changes):
+                return {"success": False, "error": "Invalid state changes"}
+            if not state_changes and not deletions:
                 return {"success": False, "error": "Invalid state changes"}
             
-            # Apply changes (mock implementation)
-            applied_changes = len(state_changes)
+            for key, value in state_changes.items():
+                self._write_state(key, value)
+            for key in deletions:
+                self._delete_state(key)
             
             return {
                 "success": True,
-                "applied_changes": applied_changes,
-                "new_state_version": self.state_version
+                "applied_changes": len(state_changes) + len(deletions),
+                "new_state_version": self.state_version,
+                "state_root": self.get_state_root()
             }
             
         except Exception as e:
             logger.error(f"Failed to apply state update: {e}")
             return {"success": False, "error": str(e)}
     
+    def _write_state(self, key: str, value: Any):
+        """Write one state key and keep the digest in step; None is stored like any value"""
+        self.state[key] = value
+        if self.state_digest is not None:
+            self.state_digest.put(key.encode(), self._encode_state_value(value))
+        self._checkpoint_changes.add(key)
+    
+    def _delete_state(self, key: str):
+        """Remove one state key and keep the digest in step"""
+        if key not in self.state:
+            return
+        del self.state[key]
+        if self.state_digest is not None:
+            self.state_digest.delete(key.encode())
+        self._checkpoint_changes.add(key)
+    
+    @staticmethod
+    def _encode_state_value(value: Any) -> bytes:
+        """Canonical encoding hashed into the state digest"""
+        return json.dumps(value, sort_keys=True, separators=(",", ":"), default=str).encode()
+    
     async def _apply_configuration(self, payload: Dict[str, Any]) -> Dict[str, Any]:
         """Apply configuration changes"""
         try:
@@ -762,21 +893,21 @@ class NodeOperatorSyncSystem:
     async def _sync_with_operator(self, operator: OperatorInfo):
         """Synchronize state with a specific operator"""
         try:
-            # Mock sync implementation - would make HTTP requests in real system
             if operator.status == SyncStatus.OFFLINE:
                 return
             
             sync_start = time.time()
             
-            # Simulate network delay
-            await asyncio.sleep(0.1)
-            
             # Check for state differences
             state_diff = await self._calculate_state_diff(operator)
             
             if state_diff:
-                # Send sync updates
-                await self._send_sync_updates(operator, state_diff)
+                if operator.role == OperatorRole.PRIMARY and self.current_role != OperatorRole.PRIMARY:
+                    # Lagging behind the primary: pull only what changed
+                    await self._pull_sync_updates(operator, state_diff)
+                elif self.current_role == OperatorRole.PRIMARY:
+                    # Send sync updates
+                    await self._send_sync_updates(operator, state_diff)
             
             # Update sync status
             sync_time = time.time() - sync_start
@@ -794,39 +925,117 @@ class NodeOperatorSyncSystem:
             await self._update_operator_metrics(operator.operator_id, 0, False)
     
     async def _calculate_state_diff(self, operator: OperatorInfo) -> Optional[Dict[str, Any]]:
-        """Calculate state differences with an operator"""
-        try:
-            # Mock state difference calculation
-            # In real implementation, would compare state hashes/versions
-            
-            # Simulate finding differences 20% of the time
-            import secrets
-            if secrets.randbits(1) and secrets.randbits(1) and secrets.randbits(1):
-                return {
-                    "version_diff": 1,
-                    "changes": ["mock_change_1", "mock_change_2"]
-                }
-            
-            return None
+        """
+        Calculate state differences with an operator.
+        
+        Exchanges range fingerprints over the sorted key space until every
+        differing key is found, so the cost grows with the number of
+        differences rather than the size of the state. Writes that land
+        during the exchange are picked up by the next sync.
+        
+        Returns:
+            None when in sync, otherwise the keys only the peer has
+            ("missing"), only we have ("extra") and that differ ("changed")
+        """
+        if self.state_digest is None:
+            # Without the digest the only safe diff is the peer's whole state
+            response = await self._request_operator(operator, "/state/fetch", {"keys": None})
+            remote = response.get("state", {})
+            diff = {
+                "missing": [key for key in remote if key not in self.state],
+                "extra": [key for key in self.state if key not in remote],
+                "changed": [
+                    key for key in remote
+                    if key in self.state and
+                    self._encode_state_value(remote[key]) != self._encode_state_value(self.state[key])
+                ],
+                "values": remote,
+                "rounds": 1
+            }
+        else:
+            diff = {"missing": [], "extra": [], "changed": [], "rounds": 0}
+            message = self.state_digest.initiate()
             
-        except Exception as e:
-            logger.error(f"Failed to calculate state diff: {e}")
+            while message:
+                if diff["rounds"] >= STATE_SYNC_MAX_ROUNDS:
+                    raise RuntimeError(f"State reconciliation with {operator.operator_id} did not converge")
+                
+                response = await self._request_operator(
+                    operator, "/state/reconcile", {"message": base64.b64encode(message).decode()}
+                )
+                diff["rounds"] += 1
+                if not response.get("message"):
+                    break
+                
+                message, missing, extra, changed = self.state_digest.reconcile(
+                    base64.b64decode(response["message"])
+                )
+                diff["missing"].extend(key.decode() for key in missing)
+                diff["extra"].extend(key.decode() for key in extra)
+                diff["changed"].extend(key.decode() for key in changed)
+        
+        if not (diff["missing"] or diff["extra"] or diff["changed"]):
             return None
+        
+        logger.debug(
+            f"State diff with {operator.operator_id}: {len(diff['missing'])} missing, "
+            f"{len(diff['extra'])} extra, {len(diff['changed'])} changed in {diff['rounds']} rounds"
+        )
+        return diff
+    
+    async def _pull_sync_updates(self, operator: OperatorInfo, state_diff: Dict[str, Any]):
+        """Fetch and apply only the keys that differ from an operator"""
+        wanted = state_diff["missing"] + state_diff["changed"]
+        
+        values = state_diff.get("values")
+        if values is None and wanted:
+            response = await self._request_operator(operator, "/state/fetch", {"keys": wanted})
+            values = response.get("state", {})
+        
+        for key in wanted:
+            if key in (values or {}):
+                self._write_state(key, values[key])
+        for key in state_diff["extra"]:
+            self._delete_state(key)
+        
+        logger.info(
+            f"Pulled {len(wanted)} keys and dropped {len(state_diff['extra'])} from {operator.operator_id}"
+        )
     
     async def _send_sync_updates(self, operator: OperatorInfo, updates: Dict[str, Any]):
         """Send synchronization updates to an operator"""
         try:
-            # Mock sending sync updates
-            # In real implementation, would make HTTP POST to operator endpoint
+            # The peer lacks our extra keys, holds stale changed ones and
+            # has keys we no longer do
+            changes = {
+                key: self.state[key]
+                for key in updates.get("extra", []) + updates.get("changed", [])
+                if key in self.state
+            }
+            deletions = list(updates.get("missing", []))
+            if not changes and not deletions:
+                return
             
-            logger.debug(f"Sending sync updates to {operator.operator_id}: {len(updates.get('changes', []))} changes")
+            logger.debug(f"Sending sync updates to {operator.operator_id}: {len(changes)} changes, {len(deletions)} deletions")
             
-            # Simulate network delay
-            await asyncio.sleep(0.05)
+            await self._request_operator(operator, "/state/updates", {"changes": changes, "deletions": deletions})
             
         except Exception as e:
             logger.error(f"Failed to send sync updates to {operator.operator_id}: {e}")
     
+    async def _request_operator(self, operator: OperatorInfo, path: str, payload: Dict[str, Any]) -> Dict[str, Any]:
+        """Send a state sync request to an operator"""
+        if self.state_transport is not None:
+            return await self.state_transport(operator, path, payload)
+        
+        if not AIOHTTP_AVAILABLE:
+            raise RuntimeError("aiohttp not available for operator state sync")
+        
+        async with aiohttp.ClientSession(timeout=aiohttp.ClientTimeout(total=CONFLICT_RESOLUTION_TIMEOUT_SEC)) as session:
+            async with session.post(f"{operator.endpoint.rstrip('/')}{path}", json=payload) as response:
+                response.raise_for_status()
+                return await response.json()
+    
     async def _broadcast_checkpoint(self, checkpoint: StateCheckpoint):
         """Broadcast checkpoint to all operators"""
         try:
@@ -1098,8 +1307,8 @@ class NodeOperatorSyncSystem:
             try:
                 # Only primary operator creates regular checkpoints
                 if self.current_role == OperatorRole.PRIMARY:
-                    # Mock state data for checkpoint
-                    state_data = {
+                    # Summary recorded alongside the state delta
+                    summary = {
                         "version": self.state_version,
                         "timestamp": datetime.now(timezone.utc).isoformat(),
                         "operators": len(self.operators),
@@ -1109,7 +1318,7 @@ class NodeOperatorSyncSystem:
                         ])
                     }
                     
-                    await self.create_checkpoint(state_data)
+                    await self.create_checkpoint(metadata=summary)
                 
                 await asyncio.sleep(STATE_CHECKPOINT_INTERVAL_MINUTES * 60)
                 
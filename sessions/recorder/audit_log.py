@@ -0,0 +1,264 @@
+# Path: sessions/recorder/audit_log.py
+# Lucid RDP Session Audit Log - Hash-chained binary audit log
+# Append-only record file backing the session audit trail
+
+"""
+File: /app/sessions/recorder/audit_log.py
+x-lucid-file-path: /app/sessions/recorder/audit_log.py
+x-lucid-file-type: python
+
+Append-only binary audit log.
+
+Each record is a fixed 104-byte little-endian header followed by the
+session id and payload. The header carries the hash of the record before
+it, and the record hash covers the header prefix and body, so editing,
+dropping or reordering any record breaks the chain from that point on.
+Batches are written with one fsync. Timestamps are kept non-decreasing so
+readers can binary-search by time.
+"""
+
+from __future__ import annotations
+
+import bisect
+import errno
+import hashlib
+import logging
+import mmap
+import os
+import struct
+import threading
+from typing import Iterable, List, Optional, Tuple
+
+logger = logging.getLogger(__name__)
+
+try:
+    import audit_log_native
+    AUDIT_LOG_NATIVE_AVAILABLE = True
+except ImportError:
+    AUDIT_LOG_NATIVE_AVAILABLE = False
+    logger.warning("audit_log_native not available, using Python audit log")
+
+HEADER_SIZE = 104
+HASH_SIZE = 32
+MAX_PAYLOAD = 16 << 20
+
+_MAGIC = 0x4C445541
+_VERSION = 1
+_MAX_SESSION_ID = 0xFFFF
+_HASHED_HEADER_SIZE = HEADER_SIZE - HASH_SIZE
+# magic, version, event_type, timestamp_us, sequence, session_hash,
+# session_len, reserved, payload_len, prev_hash
+_PREFIX = struct.Struct("<IHHQQQHHI32s")
+_FILE_MODE = 0o640
+
+Record = Tuple[int, int, int, str, bytes, str]
+
+
+def _session_hash(session_id: bytes) -> int:
+    h = 0xCBF29CE484222325
+    for byte in session_id:
+        h = ((h ^ byte) * 0x100000001B3) & 0xFFFFFFFFFFFFFFFF
+    return h
+
+
+def _read_header(data, offset: int) -> Optional[tuple]:
+    fields = _PREFIX.unpack_from(data, offset)
+    if fields[0] != _MAGIC or fields[1] != _VERSION or fields[8] > MAX_PAYLOAD:
+        return None
+    return fields
+
+
+def _scan(data) -> Tuple[List[int], int]:
+    """Offsets of well-formed records and the bytes they cover."""
+    offsets, pos, size = [], 0, len(data)
+    while size - pos >= HEADER_SIZE:
+        fields = _read_header(data, pos)
+        if fields is None:
+            break
+        length = HEADER_SIZE + fields[6] + fields[8]
+        if size - pos < length:
+            break  # Torn tail
+        offsets.append(pos)
+        pos += length
+    return offsets, pos
+
+
+def _tail_torn(data, offset: int) -> bool:
+    """Whether the bytes after the last well-formed record are an interrupted append."""
+    tail = data[offset:]
+    if len(tail) < HEADER_SIZE or struct.unpack_from("<I", tail)[0] == _MAGIC:
+        return True
+    # The file grew but its data blocks never reached disk
+    return tail.count(0) == len(tail)
+
+
+class _AuditLogWriter:
+    """
+    Python stand-in for audit_log_native.AuditLogWriter, writing the same
+    file format.
+    """
+
+    def __init__(self, path: str, sync: bool = True) -> None:
+        self._sync = sync
+        self._lock = threading.Lock()
+        self._fd = os.open(os.fspath(path), os.O_RDWR | os.O_CREAT | os.O_CLOEXEC, _FILE_MODE)
+        self._offset = 0
+        self._sequence = 0
+        self._last_timestamp = 0
+        self._last_hash = bytes(HASH_SIZE)
+        try:
+            self._recover()
+        except Exception:
+            os.close(self._fd)
+            raise
+
+    def _recover(self) -> None:
+        size = os.fstat(self._fd).st_size
+        if size == 0:
+            return
+        with mmap.mmap(self._fd, size, prot=mmap.PROT_READ) as data:
+            offsets, consumed = _scan(data)
+            if consumed < size and not _tail_torn(data, consumed):
+                raise OSError(errno.EBADMSG, os.strerror(errno.EBADMSG))
+            if offsets:
+                fields = _read_header(data, offsets[-1])
+                self._sequence = fields[4] + 1
+                self._last_timestamp = fields[3]
+                self._last_hash = bytes(data[offsets[-1] + _HASHED_HEADER_SIZE:offsets[-1] + HEADER_SIZE])
+        if consumed < size:
+            os.ftruncate(self._fd, consumed)
+        self._offset = consumed
+
+    @property
+    def sequence(self) -> int:
+        return self._sequence
+
+    @property
+    def last_hash(self) -> Optional[str]:
+        return self._last_hash.hex() if self._sequence else None
+
+    @property
+    def size(self) -> int:
+        return self._offset
+
+    @property
+    def closed(self) -> bool:
+        return self._fd < 0
+
+    def append(self, records: Iterable[Tuple[int, int, str, bytes]]) -> List[str]:
+        if self._fd < 0:
+            raise ValueError("I/O operation on closed audit log")
+        bodies = []
+        for timestamp_us, event_type, session_id, payload in records:
+            if not isinstance(session_id, str):
+                raise TypeError("session_id must be a str")
+            session = session_id.encode("utf-8")
+            payload = bytes(payload)
+            if not 0 <= event_type <= 0xFFFF:
+                raise ValueError("event_type must fit in 16 bits")
+            if len(session) > _MAX_SESSION_ID:
+                raise ValueError("session_id too long")
+            if len(payload) > MAX_PAYLOAD:
+                raise ValueError("payload too large")
+            bodies.append((int(timestamp_us), event_type, session, payload))
+        if not bodies:
+            return []
+
+        with self._lock:
+            sequence, last_timestamp, prev = self._sequence, self._last_timestamp, self._last_hash
+            chunks, hashes = [], []
+            for timestamp_us, event_type, session, payload in bodies:
+                last_timestamp = max(timestamp_us, last_timestamp)
+                prefix = _PREFIX.pack(_MAGIC, _VERSION, event_type, last_timestamp, sequence,
+                                      _session_hash(session), len(session), 0, len(payload), prev)
+                prev = hashlib.sha256(prefix + session + payload).digest()
+                chunks += [prefix, prev, session, payload]
+                hashes.append(prev.hex())
+                sequence += 1
+
+            data = b"".join(chunks)
+            try:
+                written = 0
+                while written < len(data):
+                    written += os.pwrite(self._fd, data[written:], self._offset + written)
+                if self._sync:
+                    os.fdatasync(self._fd)
+            except OSError:
+                os.ftruncate(self._fd, self._offset)
+                raise
+
+            self._offset += len(data)
+            self._sequence, self._last_timestamp, self._last_hash = sequence, last_timestamp, prev
+        return hashes
+
+    def close(self) -> None:
+        with self._lock:
+            if self._fd >= 0:
+                fd, self._fd = self._fd, -1
+                os.close(fd)
+
+
+class _AuditLogReader:
+    """
+    Python stand-in for audit_log_native.AuditLogReader: a snapshot of the
+    file as it was when opened.
+    """
+
+    def __init__(self, path: str) -> None:
+        with open(os.fspath(path), "rb") as f:
+            size = os.fstat(f.fileno()).st_size
+            self._data = mmap.mmap(f.fileno(), size, prot=mmap.PROT_READ) if size else b""
+        self._size = size
+        self._offsets, self._consumed = _scan(self._data)
+        self._timestamps = [_PREFIX.unpack_from(self._data, offset)[3] for offset in self._offsets]
+
+    def __len__(self) -> int:
+        return len(self._offsets)
+
+    @property
+    def last_hash(self) -> Optional[str]:
+        if not self._offsets:
+            return None
+        offset = self._offsets[-1] + _HASHED_HEADER_SIZE
+        return bytes(self._data[offset:offset + HASH_SIZE]).hex()
+
+    def range(self, start_us: Optional[int] = None, end_us: Optional[int] = None,
+              session_id: Optional[str] = None) -> List[Record]:
+        session = session_id.encode("utf-8") if session_id is not None else None
+        first = bisect.bisect_left(self._timestamps, start_us or 0)
+        last = len(self._timestamps) if end_us is None else bisect.bisect_right(self._timestamps, end_us)
+
+        result = []
+        for offset in self._offsets[first:last]:
+            fields = _PREFIX.unpack_from(self._data, offset)
+            body = offset + HEADER_SIZE
+            record_session = bytes(self._data[body:body + fields[6]])
+            if session is not None and record_session != session:
+                continue
+            payload = bytes(self._data[body + fields[6]:body + fields[6] + fields[8]])
+            record_hash = bytes(self._data[offset + _HASHED_HEADER_SIZE:body]).hex()
+            result.append((fields[4], fields[3], fields[2], record_session.decode("utf-8"), payload, record_hash))
+        return result
+
+    def verify(self) -> Optional[int]:
+        prev, last_timestamp = bytes(HASH_SIZE), 0
+        for index, offset in enumerate(self._offsets):
+            fields = _PREFIX.unpack_from(self._data, offset)
+            end = offset + HEADER_SIZE + fields[6] + fields[8]
+            record_hash = bytes(self._data[offset + _HASHED_HEADER_SIZE:offset + HEADER_SIZE])
+            digest = hashlib.sha256(bytes(self._data[offset:offset + _HASHED_HEADER_SIZE])
+                                    + bytes(self._data[offset + HEADER_SIZE:end])).digest()
+            if fields[4] != index or fields[3] < last_timestamp or fields[9] != prev or digest != record_hash:
+                return index
+            prev, last_timestamp = record_hash, fields[3]
+        if self._consumed < self._size:
+            return len(self._offsets)
+        return None
+
+
+if AUDIT_LOG_NATIVE_AVAILABLE:
+    AuditLogWriter = audit_log_native.AuditLogWriter
+    AuditLogReader = audit_log_native.AuditLogReader
+else:
+    AuditLogWriter = _AuditLogWriter
+    AuditLogReader = _AuditLogReader
@@ -29,6 +29,13 @@ except ImportError:
     import logging
     logger = logging.getLogger(settings="SETTINGS", log_level="INFO", config_logger="CONFIG")
 
+# Parallel gzip for the 10MB chunks; the output is a standard gzip member
+try:
+    import chunker_native
+    CHUNKER_NATIVE_AVAILABLE = True
+except ImportError:
+    CHUNKER_NATIVE_AVAILABLE = False
+
 # D
 @dataclass
 class ChunkConfig:
@@ -131,7 +138,11 @@ class ChunkGenerator:
         
         # Compress data if enabled
         if self.config.enable_compression:
-            compressed_data = gzip.compress(chunk_data, compresslevel=self.config.compression_level)
+            if CHUNKER_NATIVE_AVAILABLE:
+                compressed_data = chunker_native.compress_parallel(
+                    chunk_data, self.config.compression_level, format="gzip")
+            else:
+                compressed_data = gzip.compress(chunk_data, compresslevel=self.config.compression_level)
             compression_ratio = len(chunk_data) / len(compressed_data) if len(compressed_data) > 0 else 1.0
             final_data = compressed_data
             compressed = True
@@ -25,6 +25,7 @@ import pynput
 import hashlib
 import base64
 from sessions.recorder.config import RecorderConfig, RecorderSettings
+from sessions.recorder import telemetry_codec as tc
 import os
 CONFIG = os.getenv("SESSIONS_CONFIG":-RecorderConfig())
 INFO = os.getenv("SESSIONS_INFO", env=".env.sessions")
@@ -74,6 +75,7 @@ KEYSTROKE_CACHE_PATH = Path(os.getenv("LUCID_KEYSTROKE_CACHE_PATH", "/tmp/lucid/
 KEYSTROKE_MAX_EVENTS = int(os.getenv("LUCID_KEYSTROKE_MAX_EVENTS", "10000"))
 KEYSTROKE_BATCH_SIZE = int(os.getenv("LUCID_KEYSTROKE_BATCH_SIZE", "100"))
 KEYSTROKE_FLUSH_INTERVAL = int(os.getenv("LUCID_KEYSTROKE_FLUSH_INTERVAL", "30"))
+KEYSTROKE_BLOCK_FILENAME = "keystrokes.ltb"
 
 
 class KeystrokeEventType(Enum):
@@ -163,6 +165,63 @@ class KeystrokeEvent:
             metadata=data.get("metadata", {}),
             hash=data.get("hash")
         )
+    
+    @staticmethod
+    def to_block(events: List[KeystrokeEvent]) -> bytes:
+        """Encode events as one columnar telemetry block"""
+        try:
+            event_ids = [uuid.UUID(e.event_id).bytes for e in events]
+            event_id_type = tc.UUID
+        except ValueError:
+            event_ids = [e.event_id for e in events]
+            event_id_type = tc.STRING
+        
+        return tc.encode_block(tc.KIND_KEYSTROKES, [
+            ("event_id", event_id_type, event_ids),
+            ("session_id", tc.STRING, [e.session_id for e in events]),
+            ("timestamp", tc.TIMESTAMP, [tc.to_micros(e.timestamp) for e in events]),
+            ("event_type", tc.STRING, [e.event_type.value for e in events]),
+            ("key_code", tc.INT, [e.key_code for e in events]),
+            ("key_name", tc.STRING, [e.key_name for e in events]),
+            ("key_char", tc.STRING, [e.key_char for e in events]),
+            ("modifiers", tc.STRING, ["+".join(e.modifiers) for e in events]),
+            ("window_title", tc.STRING, [e.window_title for e in events]),
+            ("window_class", tc.STRING, [e.window_class for e in events]),
+            ("application_name", tc.STRING, [e.application_name for e in events]),
+            ("process_id", tc.INT, [e.process_id for e in events]),
+            ("thread_id", tc.INT, [e.thread_id for e in events]),
+            ("duration_ms", tc.INT, [e.duration_ms for e in events]),
+            ("is_sensitive", tc.INT, [int(e.is_sensitive) for e in events]),
+            ("is_filtered", tc.INT, [int(e.is_filtered) for e in events]),
+            ("metadata", tc.STRING, [json.dumps(e.metadata, sort_keys=True) if e.metadata else "{}" for e in events]),
+        ])
+    
+    @classmethod
+    def from_block(cls, columns: Dict[str, List[Any]]) -> List[KeystrokeEvent]:
+        """Rebuild events from a decoded telemetry block; hashes are not stored"""
+        events = []
+        for i, timestamp in enumerate(columns["timestamp"]):
+            event_id = columns["event_id"][i]
+            events.append(cls(
+                event_id=str(uuid.UUID(bytes=event_id)) if isinstance(event_id, bytes) else event_id,
+                session_id=columns["session_id"][i],
+                timestamp=tc.from_micros(timestamp),
+                event_type=KeystrokeEventType(columns["event_type"][i]),
+                key_code=columns["key_code"][i],
+                key_name=columns["key_name"][i],
+                key_char=columns["key_char"][i],
+                modifiers=columns["modifiers"][i].split("+") if columns["modifiers"][i] else [],
+                window_title=columns["window_title"][i],
+                window_class=columns["window_class"][i],
+                application_name=columns["application_name"][i],
+                process_id=columns["process_id"][i],
+                thread_id=columns["thread_id"][i],
+                duration_ms=columns["duration_ms"][i],
+                is_sensitive=bool(columns["is_sensitive"][i]),
+                is_filtered=bool(columns["is_filtered"][i]),
+                metadata=json.loads(columns["metadata"][i])
+            ))
+        return events
 
 
 @dataclass
@@ -714,24 +773,33 @@ class KeystrokeMonitor:
             logger.error(f"Failed to flush keystroke events: {e}")
     
     async def _save_events_to_file(self, events: List[KeystrokeEvent]) -> None:
-        """Save events to file"""
+        """Append events to the session's columnar block stream"""
         try:
             if not events:
                 return
             
-            # Create events data
-            events_data = [event.to_dict() for event in events]
+            block = KeystrokeEvent.to_block(events)
             
-            # Save to JSON file
-            log_file = KEYSTROKE_LOG_PATH / self.config.session_id / f"keystrokes_{int(time.time())}.json"
-            with open(log_file, 'w') as f:
-                json.dump(events_data, f, indent=2)
+            log_file = KEYSTROKE_LOG_PATH / self.config.session_id / KEYSTROKE_BLOCK_FILENAME
+            with open(log_file, 'ab') as f:
+                f.write(block)
             
             logger.debug(f"Saved {len(events)} keystroke events to {log_file}")
             
         except Exception as e:
             logger.error(f"Failed to save keystroke events: {e}")
     
+    def _load_block_events(self, log_file: Path) -> List[KeystrokeEvent]:
+        """Decode every block in a keystroke block stream"""
+        events = []
+        for kind, columns in tc.read_blocks(log_file.read_bytes()):
+            if kind != tc.KIND_KEYSTROKES:
+                continue
+            for event in KeystrokeEvent.from_block(columns):
+                event.hash = self._calculate_event_hash(event)
+                events.append(event)
+        return events
+    
     async def get_events(
         self,
         start_time: Optional[datetime] = None,
@@ -742,17 +810,21 @@ class KeystrokeMonitor:
         try:
             events = []
             
-            # Load from files
+            # Load from files; JSON batches predate the block stream
             log_dir = KEYSTROKE_LOG_PATH / self.config.session_id
             if log_dir.exists():
-                for log_file in log_dir.glob("keystrokes_*.json"):
+                log_files = sorted(log_dir.glob("keystrokes_*.json")) + [log_dir / KEYSTROKE_BLOCK_FILENAME]
+                for log_file in log_files:
+                    if not log_file.exists():
+                        continue
                     try:
-                        with open(log_file, 'r') as f:
-                            file_events = json.load(f)
+                        if log_file.suffix == ".json":
+                            with open(log_file, 'r') as f:
+                                file_events = [KeystrokeEvent.from_dict(data) for data in json.load(f)]
+                        else:
+                            file_events = self._load_block_events(log_file)
                         
-                        for event_data in file_events:
-                            event = KeystrokeEvent.from_dict(event_data)
-                            
+                        for event in file_events:
                             # Apply time filters
                             if start_time and event.timestamp < start_time:
                                 continue
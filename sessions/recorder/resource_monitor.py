@@ -28,6 +28,7 @@ import subprocess
 import socket
 import netifaces  # pyright: ignore[reportMissingModuleSource]
 from sessions.recorder.config import RecorderConfig, RecorderSettings
+from sessions.recorder import telemetry_codec as tc
 import os
 CONFIG = os.getenv("SESSIONS_CONFIG":-RecorderConfig())
 INFO = os.getenv("SESSIONS_INFO", env=".env.sessions")
@@ -45,6 +46,23 @@ RESOURCE_CACHE_PATH = Path(os.getenv("LUCID_RESOURCE_CACHE_PATH", "/tmp/lucid/re
 RESOURCE_MONITOR_INTERVAL = float(os.getenv("LUCID_RESOURCE_MONITOR_INTERVAL", "5.0"))
 RESOURCE_MAX_EVENTS = int(os.getenv("LUCID_RESOURCE_MAX_EVENTS", "10000"))
 RESOURCE_BATCH_SIZE = int(os.getenv("LUCID_RESOURCE_BATCH_SIZE", "100"))
+RESOURCE_SAMPLE_BATCH_SIZE = int(os.getenv("LUCID_RESOURCE_SAMPLE_BATCH_SIZE", "120"))
+RESOURCE_SAMPLE_FILENAME = "resources.ltb"
+
+# Per-tick sample series: column name, codec type, resource_cache section and key
+RESOURCE_SAMPLE_COLUMNS = [
+    ("cpu_percent", tc.FLOAT, "cpu", "percent"),
+    ("cpu_frequency", tc.FLOAT, "cpu", "frequency"),
+    ("memory_percent", tc.FLOAT, "memory", "percent"),
+    ("memory_used", tc.INT, "memory", "used"),
+    ("swap_used", tc.INT, "memory", "swap_used"),
+    ("disk_percent", tc.FLOAT, "disk", "percent"),
+    ("disk_read_bytes", tc.INT, "disk", "read_bytes"),
+    ("disk_write_bytes", tc.INT, "disk", "write_bytes"),
+    ("net_bytes_sent", tc.INT, "network", "bytes_sent"),
+    ("net_bytes_recv", tc.INT, "network", "bytes_recv"),
+    ("net_connections", tc.INT, "network", "connections"),
+]
 
 
 class ResourceType(Enum):
@@ -281,6 +299,11 @@ class ResourceMonitor:
             "network_bandwidth": 1000000000  # 1GB/s
         }
         
+        # Sample series, written as columnar blocks from the monitor thread
+        self.sample_buffer: List[tuple[int, Dict[str, Any]]] = []
+        self.sample_lock = threading.Lock()
+        self.sample_count = 0
+        
         # Statistics
         self.event_count = 0
         self.filtered_count = 0
@@ -334,6 +357,7 @@ class ResourceMonitor:
             
             # Flush remaining events
             await self._flush_events()
+            self._flush_samples()
             
             logger.info("Resource Monitor stopped")
             return True
@@ -428,6 +452,8 @@ class ResourceMonitor:
                     if self.config.monitor_microphone:
                         self._monitor_microphone()
                     
+                    self._record_sample()
+                    
                     time.sleep(self.config.monitor_interval)
                     
                 except Exception as e:
@@ -553,6 +579,77 @@ class ResourceMonitor:
         except Exception as e:
             logger.error(f"Network monitoring error: {e}")
     
+    def _record_sample(self) -> None:
+        """Append this tick's resource_cache readings to the sample series"""
+        try:
+            sample = {}
+            for name, column_type, section, key in RESOURCE_SAMPLE_COLUMNS:
+                value = self.resource_cache.get(section, {}).get(key)
+                sample[name] = None if value is None else (float(value) if column_type == tc.FLOAT else int(value))
+            
+            with self.sample_lock:
+                self.sample_buffer.append((tc.to_micros(datetime.now(timezone.utc)), sample))
+                full = len(self.sample_buffer) >= RESOURCE_SAMPLE_BATCH_SIZE
+            
+            if full:
+                self._flush_samples()
+            
+        except Exception as e:
+            logger.error(f"Resource sample error: {e}")
+    
+    def _flush_samples(self) -> None:
+        """Append buffered samples to the session's block stream"""
+        try:
+            with self.sample_lock:
+                samples, self.sample_buffer = self.sample_buffer, []
+            if not samples:
+                return
+            
+            columns = [("timestamp", tc.TIMESTAMP, [timestamp for timestamp, _ in samples])]
+            for name, column_type, _, _ in RESOURCE_SAMPLE_COLUMNS:
+                columns.append((name, column_type, [sample[name] for _, sample in samples]))
+            block = tc.encode_block(tc.KIND_RESOURCE_SAMPLES, columns)
+            
+            log_file = RESOURCE_LOG_PATH / self.config.session_id / RESOURCE_SAMPLE_FILENAME
+            with open(log_file, 'ab') as f:
+                f.write(block)
+            self.sample_count += len(samples)
+            
+        except Exception as e:
+            logger.error(f"Failed to save resource samples: {e}")
+    
+    async def get_samples(
+        self,
+        start_time: Optional[datetime] = None,
+        end_time: Optional[datetime] = None
+    ) -> List[Dict[str, Any]]:
+        """Get stored resource samples, oldest first"""
+        try:
+            samples = []
+            log_file = RESOURCE_LOG_PATH / self.config.session_id / RESOURCE_SAMPLE_FILENAME
+            if not log_file.exists():
+                return samples
+            
+            for kind, columns in tc.read_blocks(log_file.read_bytes()):
+                if kind != tc.KIND_RESOURCE_SAMPLES:
+                    continue
+                for i, micros in enumerate(columns["timestamp"]):
+                    timestamp = tc.from_micros(micros)
+                    if start_time and timestamp < start_time:
+                        continue
+                    if end_time and timestamp > end_time:
+                        continue
+                    sample = {"timestamp": timestamp}
+                    for name, _, _, _ in RESOURCE_SAMPLE_COLUMNS:
+                        sample[name] = columns[name][i] if name in columns else None
+                    samples.append(sample)
+            
+            return samples
+            
+        except Exception as e:
+            logger.error(f"Failed to get resource samples: {e}")
+            return []
+    
     def _monitor_processes(self) -> None:
         """Monitor running processes"""
         try:
@@ -1124,6 +1221,7 @@ class ResourceMonitor:
             "sensitive_count": self.sensitive_count,
             "threshold_violations": self.threshold_violations,
             "buffer_size": len(self.event_buffer),
+            "sample_count": self.sample_count,
             "monitoring": self.monitor_running,
             "monitor_cpu": self.config.monitor_cpu,
             "monitor_memory": self.config.monitor_memory,
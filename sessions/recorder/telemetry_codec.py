@@ -0,0 +1,466 @@
+# Path: sessions/recorder/telemetry_codec.py
+# Lucid RDP Telemetry Codec - Columnar blocks for recorder telemetry
+# Shared by the keystroke, window focus and resource monitors
+
+"""
+File: /app/sessions/recorder/telemetry_codec.py
+x-lucid-file-path: /app/sessions/recorder/telemetry_codec.py
+x-lucid-file-type: python
+
+Columnar telemetry blocks.
+
+A block is a 20-byte header (magic, version, kind, column and row counts,
+body length, CRC-32 of the body) followed by named, typed columns:
+delta-of-delta varint timestamps, bit-packed integers (frame of reference
+over the values or their deltas, whichever is smaller),
+Gorilla XOR floats, dictionary-encoded strings and raw 16-byte UUIDs, each
+with an optional null bitmap. Blocks carry their own length, so a stream
+of them can be chunked and stored like any other payload and split again
+with read_blocks().
+"""
+
+from __future__ import annotations
+
+import logging
+import struct
+import zlib
+from datetime import datetime, timedelta, timezone
+from typing import Any, Dict, Iterator, List, Optional, Sequence, Tuple
+
+logger = logging.getLogger(__name__)
+
+try:
+    import telemetry_codec_native
+    TELEMETRY_CODEC_NATIVE_AVAILABLE = True
+except ImportError:
+    TELEMETRY_CODEC_NATIVE_AVAILABLE = False
+    logger.warning("telemetry_codec_native not available, using Python telemetry codec")
+
+# The Python codec checksums block bodies with the chunker's folded CRC-32
+# kernel when it is built; the value is the same as zlib.crc32
+try:
+    from chunker_native import crc32 as _crc32
+except ImportError:
+    _crc32 = zlib.crc32
+
+# Column types
+TIMESTAMP = 1
+INT = 2
+FLOAT = 3
+STRING = 4
+UUID = 5
+
+# Block kinds
+KIND_KEYSTROKES = 1
+KIND_WINDOW_EVENTS = 2
+KIND_RESOURCE_SAMPLES = 3
+
+BLOCK_HEADER_SIZE = 20
+
+_MAGIC = 0x3142544C
+_VERSION = 1
+_MAX_ROWS = 1 << 24
+_FLAG_NULLS = 0x01
+_INT_FRAME = 0
+_INT_DELTA = 1
+_HEADER = struct.Struct("<IBBHIII")
+_MASK64 = (1 << 64) - 1
+_EPOCH = datetime(1970, 1, 1, tzinfo=timezone.utc)
+
+Column = Tuple[str, int, List[Any]]
+
+
+def _zigzag(value: int) -> int:
+    value = (value + (1 << 63)) % (1 << 64) - (1 << 63)
+    return ((value << 1) ^ (value >> 63)) & _MASK64
+
+
+def _unzigzag(value: int) -> int:
+    return (value >> 1) ^ -(value & 1)
+
+
+def _to_signed(value: int) -> int:
+    value &= _MASK64
+    return value - (1 << 64) if value >> 63 else value
+
+
+def _varint(value: int) -> bytes:
+    out = bytearray()
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+    return bytes(out)
+
+
+def _read_varint(data, pos: int, end: int) -> Tuple[int, int]:
+    value = shift = 0
+    for i in range(pos, min(end, pos + 10)):
+        value |= (data[i] & 0x7F) << shift
+        if not data[i] & 0x80:
+            return value, i + 1
+        shift += 7
+    raise ValueError("Malformed varint")
+
+
+class _BitWriter:
+    """LSB-first bit packing into one integer."""
+
+    def __init__(self) -> None:
+        self.acc = 0
+        self.count = 0
+
+    def put(self, value: int, nbits: int) -> None:
+        self.acc |= (value & ((1 << nbits) - 1)) << self.count
+        self.count += nbits
+
+    def getvalue(self) -> bytes:
+        return self.acc.to_bytes((self.count + 7) // 8, "little")
+
+
+class _BitReader:
+    def __init__(self, data: bytes) -> None:
+        self.acc = int.from_bytes(data, "little")
+        self.limit = len(data) * 8
+        self.pos = 0
+
+    def get(self, nbits: int) -> int:
+        if self.pos + nbits > self.limit:
+            raise ValueError("Truncated bit stream")
+        value = (self.acc >> self.pos) & ((1 << nbits) - 1)
+        self.pos += nbits
+        return value
+
+    @property
+    def used(self) -> int:
+        return (self.pos + 7) // 8
+
+
+def _pack(values: Sequence[int], width: int) -> bytes:
+    writer = _BitWriter()
+    for value in values:
+        writer.put(value, width)
+    return writer.getvalue()
+
+
+def _encode_timestamps(values: Sequence[int]) -> bytes:
+    out, prev, prev_delta = [], 0, 0
+    for i, value in enumerate(values):
+        delta = value - prev
+        out.append(_varint(_zigzag(value if i == 0 else delta if i == 1 else delta - prev_delta)))
+        prev, prev_delta = value, delta
+    return b"".join(out)
+
+
+def _decode_timestamps(data, pos: int, end: int, count: int) -> Tuple[List[int], int]:
+    values, prev, prev_delta = [], 0, 0
+    for i in range(count):
+        raw, pos = _read_varint(data, pos, end)
+        v = _unzigzag(raw)
+        delta = v if i < 2 else prev_delta + v
+        prev, prev_delta = _to_signed(v if i == 0 else prev + delta), delta
+        values.append(prev)
+    return values, pos
+
+
+def _put_frame(values: Sequence[int], low: int, width: int) -> bytes:
+    return _varint(_zigzag(low)) + bytes([width]) + _pack([v - low for v in values], width)
+
+
+def _read_frame(data, pos: int, end: int, count: int) -> Tuple[List[int], int]:
+    raw, pos = _read_varint(data, pos, end)
+    if pos >= end or data[pos] > 64:
+        raise ValueError("Malformed integer column")
+    low, width = _unzigzag(raw), data[pos]
+    packed = (count * width + 7) // 8
+    if end - pos - 1 < packed:
+        raise ValueError("Truncated integer column")
+    reader = _BitReader(bytes(data[pos + 1:pos + 1 + packed]))
+    return [low + reader.get(width) for _ in range(count)], pos + 1 + packed
+
+
+def _encode_ints(values: Sequence[int]) -> bytes:
+    if not values:
+        return b""
+    values = [_to_signed(v) for v in values]
+    deltas = [_to_signed(b - a) for a, b in zip(values, values[1:])]
+    width = (max(values) - min(values)).bit_length()
+    delta_width = (max(deltas) - min(deltas)).bit_length() if deltas else 0
+
+    # Counters and slow-moving series pack tighter as deltas
+    if len(values) > 1 and len(deltas) * delta_width + 80 < len(values) * width:
+        return bytes([_INT_DELTA]) + _varint(_zigzag(values[0])) + _put_frame(deltas, min(deltas), delta_width)
+    return bytes([_INT_FRAME]) + _put_frame(values, min(values), width)
+
+
+def _decode_ints(data, pos: int, end: int, count: int) -> Tuple[List[int], int]:
+    if not count:
+        return [], pos
+    if pos >= end or data[pos] > _INT_DELTA:
+        raise ValueError("Malformed integer column")
+    if data[pos] == _INT_FRAME:
+        values, pos = _read_frame(data, pos + 1, end, count)
+        return [_to_signed(v) for v in values], pos
+
+    raw, pos = _read_varint(data, pos + 1, end)
+    deltas, pos = _read_frame(data, pos, end, count - 1)
+    values = [_to_signed(_unzigzag(raw))]
+    for delta in deltas:
+        values.append(_to_signed(values[-1] + delta))
+    return values, pos
+
+
+def _encode_floats(values: Sequence[float]) -> bytes:
+    writer = _BitWriter()
+    prev, prev_lead, prev_trail = 0, 65, 0
+    for i, value in enumerate(values):
+        bits = struct.unpack("<Q", struct.pack("<d", value))[0]
+        if i == 0:
+            writer.put(bits, 64)
+            prev = bits
+            continue
+        x, prev = bits ^ prev, bits
+        if not x:
+            writer.put(0, 1)
+            continue
+        lead = 64 - x.bit_length()
+        trail = (x & -x).bit_length() - 1
+        if prev_lead <= 64 and lead >= prev_lead and trail >= prev_trail:
+            writer.put(1, 2)
+            writer.put(x >> prev_trail, 64 - prev_lead - prev_trail)
+        else:
+            size = 64 - lead - trail
+            writer.put(3, 2)
+            writer.put(lead, 6)
+            writer.put(size - 1, 6)
+            writer.put(x >> trail, size)
+            prev_lead, prev_trail = lead, trail
+    return writer.getvalue()
+
+
+def _decode_floats(data, pos: int, end: int, count: int) -> Tuple[List[float], int]:
+    reader = _BitReader(bytes(data[pos:end]))
+    values, prev, lead, trail, have_window = [], 0, 0, 0, False
+    for i in range(count):
+        if i == 0:
+            prev = reader.get(64)
+        elif reader.get(1):
+            if reader.get(1):
+                lead, size = reader.get(6), reader.get(6) + 1
+                if lead + size > 64:
+                    raise ValueError("Malformed float column")
+                trail, have_window = 64 - lead - size, True
+            elif not have_window:
+                raise ValueError("Malformed float column")
+            prev ^= reader.get(64 - lead - trail) << trail
+        values.append(struct.unpack("<d", struct.pack("<Q", prev))[0])
+    return values, pos + reader.used
+
+
+def _encode_strings(values: Sequence[str]) -> bytes:
+    index: Dict[str, int] = {}
+    indices = []
+    for value in values:
+        if not isinstance(value, str):
+            raise TypeError("string column values must be str or None")
+        indices.append(index.setdefault(value, len(index)))
+    out = [_varint(len(index))]
+    for value in index:
+        encoded = value.encode("utf-8")
+        out += [_varint(len(encoded)), encoded]
+    if indices:
+        width = (len(index) - 1).bit_length()
+        out += [bytes([width]), _pack(indices, width)]
+    return b"".join(out)
+
+
+def _decode_strings(data, pos: int, end: int, count: int) -> Tuple[List[str], int]:
+    ndict, pos = _read_varint(data, pos, end)
+    if ndict > count:
+        raise ValueError("Malformed string dictionary")
+    entries = []
+    for _ in range(ndict):
+        length, pos = _read_varint(data, pos, end)
+        if length > end - pos:
+            raise ValueError("Malformed string column")
+        entries.append(bytes(data[pos:pos + length]).decode("utf-8"))
+        pos += length
+    if not count:
+        return [], pos
+    if pos >= end or data[pos] > 32:
+        raise ValueError("Malformed string column")
+    width = data[pos]
+    packed = (count * width + 7) // 8
+    if end - pos - 1 < packed:
+        raise ValueError("Malformed string column")
+    reader = _BitReader(bytes(data[pos + 1:pos + 1 + packed]))
+    values = []
+    for _ in range(count):
+        slot = reader.get(width)
+        if slot >= ndict:
+            raise ValueError("Malformed string column")
+        values.append(entries[slot])
+    return values, pos + 1 + packed
+
+
+def _encode_uuids(values: Sequence[bytes]) -> bytes:
+    for value in values:
+        if not isinstance(value, bytes) or len(value) != 16:
+            raise TypeError("uuid column values must be 16 bytes or None")
+    return b"".join(values)
+
+
+def _decode_uuids(data, pos: int, end: int, count: int) -> Tuple[List[bytes], int]:
+    if end - pos != count * 16:
+        raise ValueError("Malformed uuid column")
+    return [bytes(data[pos + 16 * i:pos + 16 * i + 16]) for i in range(count)], end
+
+
+_ENCODERS = {
+    TIMESTAMP: lambda values: _encode_timestamps([int(v) for v in values]),
+    INT: lambda values: _encode_ints([int(v) for v in values]),
+    FLOAT: lambda values: _encode_floats([float(v) for v in values]),
+    STRING: _encode_strings,
+    UUID: _encode_uuids,
+}
+
+_DECODERS = {
+    TIMESTAMP: _decode_timestamps,
+    INT: _decode_ints,
+    FLOAT: _decode_floats,
+    STRING: _decode_strings,
+    UUID: _decode_uuids,
+}
+
+
+def _py_encode_block(kind: int, columns: Sequence[Tuple[str, int, Sequence[Any]]]) -> bytes:
+    if not 0 <= kind <= 255:
+        raise ValueError("kind must fit in 8 bits")
+    if len(columns) > 255:
+        raise ValueError("Too many columns")
+
+    body, nrows = [], None
+    for name, column_type, values in columns:
+        encoded_name = name.encode("utf-8")
+        if len(encoded_name) > 255:
+            raise ValueError("Column name too long")
+        if column_type not in _ENCODERS:
+            raise ValueError("Unknown column type")
+        values = list(values)
+        if len(values) > _MAX_ROWS:
+            raise ValueError("Too many rows for one block")
+        if nrows is not None and len(values) != nrows:
+            raise ValueError("Columns must all have the same length")
+        nrows = len(values)
+
+        data, flags = b"", 0
+        if any(v is None for v in values):
+            flags = _FLAG_NULLS
+            bitmap = 0
+            for i, value in enumerate(values):
+                if value is None:
+                    bitmap |= 1 << i
+            data = bitmap.to_bytes((len(values) + 7) // 8, "little")
+            values = [v for v in values if v is not None]
+        data += _ENCODERS[column_type](values)
+        body += [bytes([len(encoded_name)]), encoded_name, struct.pack("<BBI", column_type, flags, len(data)), data]
+
+    body = b"".join(body)
+    header = _HEADER.pack(_MAGIC, _VERSION, kind, len(columns), nrows or 0, len(body), _crc32(body))
+    return header + body
+
+
+def _py_decode_block(data, offset: int = 0) -> Tuple[int, List[Column], int]:
+    data = memoryview(data).cast("B")
+    if offset < 0 or len(data) - offset < BLOCK_HEADER_SIZE:
+        raise ValueError("Truncated block header")
+    magic, version, kind, ncols, nrows, body_len, crc = _HEADER.unpack_from(data, offset)
+    if magic != _MAGIC or version != _VERSION:
+        raise ValueError("Not a telemetry block")
+    start = offset + BLOCK_HEADER_SIZE
+    end = start + body_len
+    if nrows > _MAX_ROWS or end > len(data):
+        raise ValueError("Truncated block")
+    if _crc32(data[start:end]) != crc:
+        raise ValueError("Telemetry block checksum mismatch")
+
+    columns, pos = [], start
+    for _ in range(ncols):
+        if pos >= end or end - pos - 1 < data[pos] + 6:
+            raise ValueError("Truncated column header")
+        name_end = pos + 1 + data[pos]
+        name = bytes(data[pos + 1:name_end]).decode("utf-8")
+        column_type, flags, data_len = struct.unpack_from("<BBI", data, name_end)
+        if column_type not in _DECODERS:
+            raise ValueError("Unknown column type")
+        pos = name_end + 6
+        column_end = pos + data_len
+        if column_end > end:
+            raise ValueError("Truncated column data")
+
+        nulls = None
+        if flags & _FLAG_NULLS:
+            bitmap_len = (nrows + 7) // 8
+            if data_len < bitmap_len:
+                raise ValueError("Truncated null bitmap")
+            bitmap = int.from_bytes(data[pos:pos + bitmap_len], "little")
+            nulls = [bool(bitmap >> i & 1) for i in range(nrows)]
+            pos += bitmap_len
+        count = nrows - (sum(nulls) if nulls else 0)
+
+        dense, used = _DECODERS[column_type](data, pos, column_end, count)
+        if used != column_end:
+            raise ValueError("Malformed column")
+        if nulls:
+            dense_iter = iter(dense)
+            dense = [None if null else next(dense_iter) for null in nulls]
+        columns.append((name, column_type, dense))
+        pos = column_end
+
+    if pos != end:
+        raise ValueError("Trailing bytes in block body")
+    return kind, columns, end
+
+
+if TELEMETRY_CODEC_NATIVE_AVAILABLE:
+    encode_block = telemetry_codec_native.encode_block
+    decode_block = telemetry_codec_native.decode_block
+else:
+    encode_block = _py_encode_block
+    decode_block = _py_decode_block
+
+
+def read_blocks(data) -> Iterator[Tuple[int, Dict[str, List[Any]]]]:
+    """
+    Yield (kind, {column name: values}) for each block in a stream.
+
+    Blocks are appended one at a time, so a crash can leave a torn block
+    at the end of a file; reading stops at the first block that does not
+    decode and keeps everything before it.
+    """
+    offset, size = 0, len(data)
+    while offset < size:
+        try:
+            kind, columns, next_offset = decode_block(data, offset)
+        except ValueError as e:
+            logger.warning(f"Telemetry stream unreadable from byte {offset} of {size}: {e}")
+            return
+        offset = next_offset
+        yield kind, {name: values for name, _, values in columns}
+
+
+def to_micros(timestamp: datetime) -> int:
+    """Microseconds since the Unix epoch"""
+    if timestamp.tzinfo is None:
+        timestamp = timestamp.replace(tzinfo=timezone.utc)
+    return (timestamp - _EPOCH) // timedelta(microseconds=1)
+
+
+def from_micros(micros: int) -> datetime:
+    """UTC datetime from microseconds since the Unix epoch"""
+    return _EPOCH + timedelta(microseconds=micros)
+
+
+def optional_int(value: Optional[Any]) -> Optional[int]:
+    """Column value for an optional integer or flag"""
+    return None if value is None else int(value)
@@ -39,6 +39,13 @@ except ImportError:
     import logging
     logger = logging.getLogger(settings="SETTINGS", log_level="INFO", config_logger="CONFIG")
 
+try:
+    import frame_ring_native
+    FRAME_RING_NATIVE_AVAILABLE = True
+except ImportError:
+    FRAME_RING_NATIVE_AVAILABLE = False
+    logger.warning("frame_ring_native not available, using in-process frame queue")
+
 # Configuration from environment
 VIDEO_CAPTURE_PATH = Path(os.getenv("LUCID_VIDEO_CAPTURE_PATH", "/data/video_capture"))
 FFMPEG_PATH = os.getenv("LUCID_FFMPEG_PATH", "/usr/bin/ffmpeg")
@@ -48,6 +55,8 @@ BITRATE = os.getenv("LUCID_BITRATE", "2000k")
 FPS = int(os.getenv("LUCID_FPS", "30"))
 RESOLUTION = os.getenv("LUCID_RESOLUTION", "1920x1080")
 XRDP_DISPLAY = os.getenv("LUCID_XRDP_DISPLAY", ":10")
+FRAME_RING_ENABLED = os.getenv("LUCID_FRAME_RING", "true").lower() == "true"
+FRAME_RING_SLOTS = int(os.getenv("LUCID_FRAME_RING_SLOTS", "8"))
 
 
 class CaptureStatus(Enum):
@@ -84,6 +93,8 @@ class CaptureSession:
     ffmpeg_process: Optional[subprocess.Popen] = None
     frame_queue: Optional[queue.Queue] = None
     capture_thread: Optional[threading.Thread] = None
+    frame_ring: Optional[Any] = None     # Shared-memory ring the capture thread writes raw frames into
+    frame_reader: Optional[Any] = None   # FFmpeg feeder's cursor on frame_ring
     metadata: Dict[str, Any] = field(default_factory=dict)
     frame_count: int = 0
 
@@ -291,6 +302,13 @@ class VideoCapture:
         try:
             logger.info(f"Running video capture session: {capture.session_id}")
             
+            # Raw frames go through shared memory when the ring is available
+            if FRAME_RING_NATIVE_AVAILABLE and FRAME_RING_ENABLED:
+                self._open_frame_ring(capture)
+            
+            # Update status before the thread starts, its loop runs while CAPTURING
+            capture.status = CaptureStatus.CAPTURING
+            
             # Start capture thread
             capture.capture_thread = threading.Thread(
                 target=self._capture_frames,
@@ -299,9 +317,6 @@ class VideoCapture:
             )
             capture.capture_thread.start()
             
-            # Update status
-            capture.status = CaptureStatus.CAPTURING
-            
             # Start FFmpeg encoding process
             await self._start_ffmpeg_encoding(capture)
             
@@ -322,21 +337,47 @@ class VideoCapture:
             logger.error(f"Video capture error: {e}")
             capture.status = CaptureStatus.ERROR
     
+    def _frame_size(self) -> tuple[int, int]:
+        """Configured capture width and height"""
+        width, height = RESOLUTION.lower().split("x")
+        return int(width), int(height)
+    
+    def _open_frame_ring(self, capture: CaptureSession) -> None:
+        """Create the session's frame ring and attach the FFmpeg feeder to it"""
+        try:
+            width, height = self._frame_size()
+            capture.frame_ring = frame_ring_native.FrameRingWriter(
+                f"lucid-frames-{capture.session_id}",
+                width * height * 3,
+                slot_count=FRAME_RING_SLOTS
+            )
+            capture.frame_reader = frame_ring_native.FrameRingReader(capture.frame_ring.name)
+            logger.info(f"Frame ring {capture.frame_ring.name} opened for session: {capture.session_id}")
+            
+        except Exception as e:
+            logger.error(f"Frame ring setup failed, using frame queue: {e}")
+            if capture.frame_ring:
+                capture.frame_ring.close()
+            capture.frame_ring = None
+            capture.frame_reader = None
+    
     def _capture_frames(self, capture: CaptureSession) -> None:
         """Capture video frames in separate thread"""
         try:
+            width, height = self._frame_size()
+            
             # Initialize OpenCV capture
             if HARDWARE_ACCELERATION and self.capture_devices:
                 # Use X11 grab for hardware acceleration
                 cap = cv2.VideoCapture(0)  # Use first available device
-                cap.set(cv2.CAP_PROP_FRAME_WIDTH, 1920)
-                cap.set(cv2.CAP_PROP_FRAME_HEIGHT, 1080)
+                cap.set(cv2.CAP_PROP_FRAME_WIDTH, width)
+                cap.set(cv2.CAP_PROP_FRAME_HEIGHT, height)
                 cap.set(cv2.CAP_PROP_FPS, FPS)
             else:
                 # Use screen capture
                 cap = cv2.VideoCapture(0)
-                cap.set(cv2.CAP_PROP_FRAME_WIDTH, 1920)
-                cap.set(cv2.CAP_PROP_FRAME_HEIGHT, 1080)
+                cap.set(cv2.CAP_PROP_FRAME_WIDTH, width)
+                cap.set(cv2.CAP_PROP_FRAME_HEIGHT, height)
                 cap.set(cv2.CAP_PROP_FPS, FPS)
             
             if not cap.isOpened():
@@ -344,6 +385,11 @@ class VideoCapture:
             
             logger.info(f"Video capture device opened for session: {capture.session_id}")
             
+            if capture.frame_ring:
+                self._capture_frames_to_ring(capture, cap, width, height)
+                cap.release()
+                return
+            
             frame_count = 0
             while capture.status == CaptureStatus.CAPTURING:
                 ret, frame = cap.read()
@@ -384,6 +430,64 @@ class VideoCapture:
         except Exception as e:
             logger.error(f"Video capture thread error: {e}")
             capture.status = CaptureStatus.ERROR
+        finally:
+            # Readers drain what was published, then see the ring closed
+            if capture.frame_ring:
+                capture.frame_ring.close()
+    
+    def _capture_frames_to_ring(self, capture: CaptureSession, cap: Any, width: int, height: int) -> None:
+        """Decode frames straight into frame ring slots as raw BGR24"""
+        ring = capture.frame_ring
+        frame_count = 0
+        
+        while capture.status == CaptureStatus.CAPTURING:
+            slot = ring.reserve()
+            if slot is None:
+                # Every slot is still held by a consumer; skip this frame
+                if not cap.grab():
+                    logger.warning(f"Failed to read frame for session: {capture.session_id}")
+                    break
+                logger.warning(f"Frame ring full, dropping frame: {capture.session_id}")
+                continue
+            
+            image = np.frombuffer(slot, dtype=np.uint8, count=width * height * 3).reshape(height, width, 3)
+            ret, frame = cap.read(image)
+            if not ret:
+                logger.warning(f"Failed to read frame for session: {capture.session_id}")
+                break
+            
+            # The device may ignore the requested size and hand back its own
+            # array; FFmpeg reads rawvideo at the configured geometry, so
+            # scale into the slot rather than commit a differently sized frame
+            if frame is not image:
+                try:
+                    self._fit_frame(frame, image)
+                except cv2.error as e:
+                    logger.warning(f"Frame {frame.shape} cannot be converted, dropping: {e}")
+                    continue
+            
+            ring.commit(
+                image.nbytes,
+                timestamp_us=int(time.time() * 1_000_000),
+                width=width,
+                height=height,
+                format=frame_ring_native.FORMAT_BGR24
+            )
+            del image, frame, slot
+            frame_count += 1
+            capture.frame_count = frame_count
+    
+    @staticmethod
+    def _fit_frame(frame: np.ndarray, image: np.ndarray) -> None:
+        """Write a device frame into a BGR24 slot of a different shape"""
+        if frame.ndim == 2:
+            frame = cv2.cvtColor(frame, cv2.COLOR_GRAY2BGR)
+        elif frame.shape[2] == 4:
+            frame = cv2.cvtColor(frame, cv2.COLOR_BGRA2BGR)
+        if frame.shape == image.shape:
+            image[...] = frame
+        else:
+            cv2.resize(frame, (image.shape[1], image.shape[0]), dst=image, interpolation=cv2.INTER_AREA)
     
     async def _start_ffmpeg_encoding(self, capture: CaptureSession) -> None:
         """Start FFmpeg encoding process"""
@@ -416,6 +520,10 @@ class VideoCapture:
     
     def _feed_frames_to_ffmpeg(self, capture: CaptureSession) -> None:
         """Feed frames to FFmpeg process"""
+        if capture.frame_reader:
+            self._feed_ring_to_ffmpeg(capture)
+            return
+        
         try:
             while capture.status == CaptureStatus.CAPTURING and capture.ffmpeg_process:
                 try:
@@ -445,16 +553,56 @@ class VideoCapture:
         except Exception as e:
             logger.error(f"Frame feeding thread error: {e}")
     
+    def _feed_ring_to_ffmpeg(self, capture: CaptureSession) -> None:
+        """Write frames from the shared ring to FFmpeg without copying them first"""
+        reader = capture.frame_reader
+        try:
+            while capture.ffmpeg_process and capture.ffmpeg_process.stdin:
+                try:
+                    frame = reader.next(timeout=1.0)
+                except EOFError:
+                    break
+                
+                if frame is None:
+                    if capture.status not in (CaptureStatus.STARTING, CaptureStatus.CAPTURING):
+                        break
+                    continue
+                
+                capture.ffmpeg_process.stdin.write(frame[5])
+                del frame
+            
+            reader.release()
+            if capture.ffmpeg_process and capture.ffmpeg_process.stdin:
+                capture.ffmpeg_process.stdin.close()
+            
+            logger.info(f"Frame feeding completed for session: {capture.session_id}")
+            
+        except Exception as e:
+            logger.error(f"Frame feeding thread error: {e}")
+        finally:
+            reader.close()
+    
     def _build_ffmpeg_command(self, capture: CaptureSession) -> List[str]:
         """Build FFmpeg command for hardware encoding"""
         cmd = [FFMPEG_PATH]
         
-        # Input from stdin (JPEG frames)
-        cmd.extend([
-            "-f", "image2pipe",
-            "-vcodec", "mjpeg",
-            "-i", "-"
-        ])
+        if capture.frame_reader:
+            # Input from stdin (raw BGR24 frames out of the frame ring)
+            width, height = self._frame_size()
+            cmd.extend([
+                "-f", "rawvideo",
+                "-pix_fmt", "bgr24",
+                "-s", f"{width}x{height}",
+                "-r", str(FPS),
+                "-i", "-"
+            ])
+        else:
+            # Input from stdin (JPEG frames)
+            cmd.extend([
+                "-f", "image2pipe",
+                "-vcodec", "mjpeg",
+                "-i", "-"
+            ])
         
         # Video encoding with hardware acceleration
         if HARDWARE_ACCELERATION and VIDEO_CODEC in self.hardware_codecs:
@@ -517,6 +665,8 @@ class VideoCapture:
             "stopped_at": capture.stopped_at.isoformat() if capture.stopped_at else None,
             "output_path": str(capture.output_path),
             "frame_count": capture.frame_count,
+            "frame_ring": capture.frame_ring.name if capture.frame_ring else None,
+            "frames_dropped": capture.frame_ring.dropped if capture.frame_ring else 0,
             "hardware_acceleration": HARDWARE_ACCELERATION,
             "codec": VIDEO_CODEC
         }
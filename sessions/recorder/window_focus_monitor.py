@@ -23,6 +23,7 @@ import json
 import uuid
 import hashlib
 from sessions.recorder.config import RecorderConfig, RecorderSettings
+from sessions.recorder import telemetry_codec as tc
 import os
 CONFIG = os.getenv("SESSIONS_CONFIG":-RecorderConfig())
 INFO = os.getenv("SESSIONS_INFO", env=".env.sessions")
@@ -81,6 +82,7 @@ WINDOW_CACHE_PATH = Path(os.getenv("LUCID_WINDOW_CACHE_PATH", "/tmp/lucid/window
 WINDOW_MONITOR_INTERVAL = float(os.getenv("LUCID_WINDOW_MONITOR_INTERVAL", "1.0"))
 WINDOW_MAX_EVENTS = int(os.getenv("LUCID_WINDOW_MAX_EVENTS", "10000"))
 WINDOW_BATCH_SIZE = int(os.getenv("LUCID_WINDOW_BATCH_SIZE", "100"))
+WINDOW_BLOCK_FILENAME = "windows.ltb"
 
 
 class WindowEventType(Enum):
@@ -223,6 +225,96 @@ class WindowEvent:
             metadata=data.get("metadata", {}),
             hash=data.get("hash")
         )
+    
+    @staticmethod
+    def to_block(events: List[WindowEvent]) -> bytes:
+        """Encode events as one columnar telemetry block, window info flattened"""
+        try:
+            event_ids = [uuid.UUID(e.event_id).bytes for e in events]
+            event_id_type = tc.UUID
+        except ValueError:
+            event_ids = [e.event_id for e in events]
+            event_id_type = tc.STRING
+        
+        windows = [e.window_info for e in events]
+        previous = [e.previous_window for e in events]
+        return tc.encode_block(tc.KIND_WINDOW_EVENTS, [
+            ("event_id", event_id_type, event_ids),
+            ("session_id", tc.STRING, [e.session_id for e in events]),
+            ("timestamp", tc.TIMESTAMP, [tc.to_micros(e.timestamp) for e in events]),
+            ("event_type", tc.STRING, [e.event_type.value for e in events]),
+            ("window_id", tc.INT, [w.window_id for w in windows]),
+            ("window_title", tc.STRING, [w.window_title for w in windows]),
+            ("window_class", tc.STRING, [w.window_class for w in windows]),
+            ("application_name", tc.STRING, [w.application_name for w in windows]),
+            ("process_id", tc.INT, [w.process_id for w in windows]),
+            ("process_name", tc.STRING, [w.process_name for w in windows]),
+            ("window_state", tc.STRING, [w.window_state.value for w in windows]),
+            ("x", tc.INT, [w.position[0] for w in windows]),
+            ("y", tc.INT, [w.position[1] for w in windows]),
+            ("width", tc.INT, [w.size[0] for w in windows]),
+            ("height", tc.INT, [w.size[1] for w in windows]),
+            ("is_visible", tc.INT, [int(w.is_visible) for w in windows]),
+            ("is_focused", tc.INT, [int(w.is_focused) for w in windows]),
+            ("desktop_number", tc.INT, [w.desktop_number for w in windows]),
+            ("workspace_name", tc.STRING, [w.workspace_name for w in windows]),
+            ("window_metadata", tc.STRING, [json.dumps(w.metadata, sort_keys=True) if w.metadata else "{}" for w in windows]),
+            ("has_previous", tc.INT, [int(p is not None) for p in previous]),
+            ("previous_window_id", tc.INT, [p.window_id if p else None for p in previous]),
+            ("previous_window_title", tc.STRING, [p.window_title if p else None for p in previous]),
+            ("previous_application_name", tc.STRING, [p.application_name if p else None for p in previous]),
+            ("previous_process_id", tc.INT, [p.process_id if p else None for p in previous]),
+            ("duration_ms", tc.INT, [e.duration_ms for e in events]),
+            ("is_sensitive", tc.INT, [int(e.is_sensitive) for e in events]),
+            ("is_filtered", tc.INT, [int(e.is_filtered) for e in events]),
+            ("metadata", tc.STRING, [json.dumps(e.metadata, sort_keys=True) if e.metadata else "{}" for e in events]),
+        ])
+    
+    @classmethod
+    def from_block(cls, columns: Dict[str, List[Any]]) -> List[WindowEvent]:
+        """Rebuild events from a decoded telemetry block; hashes are not stored"""
+        events = []
+        for i, timestamp in enumerate(columns["timestamp"]):
+            window_info = WindowInfo(
+                window_id=columns["window_id"][i],
+                window_title=columns["window_title"][i],
+                window_class=columns["window_class"][i],
+                application_name=columns["application_name"][i],
+                process_id=columns["process_id"][i],
+                process_name=columns["process_name"][i],
+                window_state=WindowState(columns["window_state"][i]),
+                position=(columns["x"][i], columns["y"][i]),
+                size=(columns["width"][i], columns["height"][i]),
+                is_visible=bool(columns["is_visible"][i]),
+                is_focused=bool(columns["is_focused"][i]),
+                desktop_number=columns["desktop_number"][i],
+                workspace_name=columns["workspace_name"][i],
+                metadata=json.loads(columns["window_metadata"][i])
+            )
+            
+            previous_window = None
+            if columns["has_previous"][i]:
+                previous_window = WindowInfo(
+                    window_id=columns["previous_window_id"][i],
+                    window_title=columns["previous_window_title"][i],
+                    application_name=columns["previous_application_name"][i],
+                    process_id=columns["previous_process_id"][i]
+                )
+            
+            event_id = columns["event_id"][i]
+            events.append(cls(
+                event_id=str(uuid.UUID(bytes=event_id)) if isinstance(event_id, bytes) else event_id,
+                session_id=columns["session_id"][i],
+                timestamp=tc.from_micros(timestamp),
+                event_type=WindowEventType(columns["event_type"][i]),
+                window_info=window_info,
+                previous_window=previous_window,
+                duration_ms=columns["duration_ms"][i],
+                is_sensitive=bool(columns["is_sensitive"][i]),
+                is_filtered=bool(columns["is_filtered"][i]),
+                metadata=json.loads(columns["metadata"][i])
+            ))
+        return events
 
 
 @dataclass
@@ -737,24 +829,33 @@ class WindowFocusMonitor:
             logger.error(f"Failed to flush window events: {e}")
     
     async def _save_events_to_file(self, events: List[WindowEvent]) -> None:
-        """Save events to file"""
+        """Append events to the session's columnar block stream"""
         try:
             if not events:
                 return
             
-            # Create events data
-            events_data = [event.to_dict() for event in events]
+            block = WindowEvent.to_block(events)
             
-            # Save to JSON file
-            log_file = WINDOW_LOG_PATH / self.config.session_id / f"windows_{int(time.time())}.json"
-            with open(log_file, 'w') as f:
-                json.dump(events_data, f, indent=2)
+            log_file = WINDOW_LOG_PATH / self.config.session_id / WINDOW_BLOCK_FILENAME
+            with open(log_file, 'ab') as f:
+                f.write(block)
             
             logger.debug(f"Saved {len(events)} window events to {log_file}")
             
         except Exception as e:
             logger.error(f"Failed to save window events: {e}")
     
+    def _load_block_events(self, log_file: Path) -> List[WindowEvent]:
+        """Decode every block in a window event block stream"""
+        events = []
+        for kind, columns in tc.read_blocks(log_file.read_bytes()):
+            if kind != tc.KIND_WINDOW_EVENTS:
+                continue
+            for event in WindowEvent.from_block(columns):
+                event.hash = self._calculate_event_hash(event)
+                events.append(event)
+        return events
+    
     async def get_events(
         self,
         start_time: Optional[datetime] = None,
@@ -765,17 +866,21 @@ class WindowFocusMonitor:
         try:
             events = []
             
-            # Load from files
+            # Load from files; JSON batches predate the block stream
             log_dir = WINDOW_LOG_PATH / self.config.session_id
             if log_dir.exists():
-                for log_file in log_dir.glob("windows_*.json"):
+                log_files = sorted(log_dir.glob("windows_*.json")) + [log_dir / WINDOW_BLOCK_FILENAME]
+                for log_file in log_files:
+                    if not log_file.exists():
+                        continue
                     try:
-                        with open(log_file, 'r') as f:
-                            file_events = json.load(f)
+                        if log_file.suffix == ".json":
+                            with open(log_file, 'r') as f:
+                                file_events = [WindowEvent.from_dict(data) for data in json.load(f)]
+                        else:
+                            file_events = self._load_block_events(log_file)
                         
-                        for event_data in file_events:
-                            event = WindowEvent.from_dict(event_data)
-                            
+                        for event in file_events:
                             # Apply time filters
                             if start_time and event.timestamp < start_time:
                                 continue
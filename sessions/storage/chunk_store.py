@@ -42,12 +42,22 @@ except (ImportError, OSError) as e:
     logger.warning(f"Failed to import recorder module (will use graceful degradation): {e}")
     ChunkMetadata = None
 
+# Entropy estimation for adaptive compression
+try:
+    import chunker_native
+    CHUNKER_NATIVE_AVAILABLE = True
+except ImportError:
+    CHUNKER_NATIVE_AVAILABLE = False
+    logger.warning("chunker_native not available, compressing every chunk with the configured algorithm")
+
 @dataclass
 class ChunkStoreConfig:
     """Chunk store configuration"""
     base_path: str = "/app/data/chunks"  # Default should match config default (volume mount: /app/data)
     compression_algorithm: str = "zstd"  # zstd, lz4, gzip, none
     compression_level: int = 6
+    adaptive_compression: bool = True  # Store/LZ4/zstd per chunk from an entropy estimate
+    compression_target_mbps: float = 0.0  # Lower zstd levels to hold this rate; 0 disables
     chunk_size_mb: int = 10
     max_chunks_per_session: int = 100000
     cleanup_interval_hours: int = 24
@@ -107,6 +117,17 @@ class ChunkStore:
             "none": self._decompress_none
         }
         
+        # Encrypted chunks and JPEG frames arrive incompressible; the policy
+        # stores those as-is instead of spending a core to gain nothing
+        self._compression_policy = None
+        if (config.adaptive_compression and CHUNKER_NATIVE_AVAILABLE
+                and config.compression_algorithm != "none"):
+            self._compression_policy = chunker_native.CompressionPolicy(
+                target_mbps=config.compression_target_mbps,
+                low_level=1,
+                high_level=max(1, config.compression_level)
+            )
+        
         logger.info(f"ChunkStore initialized with base path: {self.base_path}")
     
     def _initialize_directories(self):
@@ -148,20 +169,22 @@ class ChunkStore:
         metadata_path.mkdir(parents=True, exist_ok=True)
         return metadata_path / f"{chunk_id}.json"
     
-    async def _compress_zstd(self, data: bytes) -> bytes:
+    async def _compress_zstd(self, data: bytes, level: int) -> bytes:
         """Compress data using Zstandard"""
-        return zstd.compress(data, level=self.config.compression_level)
+        return zstd.compress(data, level=level)
     
-    async def _compress_lz4(self, data: bytes) -> bytes:
+    async def _compress_lz4(self, data: bytes, level: int) -> bytes:
         """Compress data using LZ4"""
-        return lz4.frame.compress(data, compression_level=self.config.compression_level)
+        return lz4.frame.compress(data, compression_level=level)
     
-    async def _compress_gzip(self, data: bytes) -> bytes:
-        """Compress data using gzip"""
+    async def _compress_gzip(self, data: bytes, level: int) -> bytes:
+        """Compress data using gzip, across all cores when the native chunker is built"""
+        if CHUNKER_NATIVE_AVAILABLE:
+            return chunker_native.compress_parallel(data, level, format="gzip")
         import gzip
-        return gzip.compress(data, compresslevel=self.config.compression_level)
+        return gzip.compress(data, compresslevel=level)
     
-    async def _compress_none(self, data: bytes) -> bytes:
+    async def _compress_none(self, data: bytes, level: int) -> bytes:
         """No compression"""
         return data
     
@@ -175,6 +198,8 @@ class ChunkStore:
     
     async def _decompress_gzip(self, data: bytes) -> bytes:
         """Decompress gzip data"""
+        if CHUNKER_NATIVE_AVAILABLE:
+            return chunker_native.decompress_parallel(data)
         import gzip
         return gzip.decompress(data)
     
@@ -182,6 +207,18 @@ class ChunkStore:
         """No decompression"""
         return data
     
+    def _select_compression(self, data: bytes) -> Tuple[str, int]:
+        """Choose algorithm and level for a chunk"""
+        if self._compression_policy is None:
+            return self.config.compression_algorithm, self.config.compression_level
+        
+        tier, level = self._compression_policy.select(data)
+        if tier == chunker_native.TIER_STORE:
+            return "none", 0
+        if tier == chunker_native.TIER_FAST:
+            return "lz4", 0
+        return "zstd", level
+    
     async def store_chunk(
         self, 
         session_id: str, 
@@ -196,15 +233,20 @@ class ChunkStore:
         """
         try:
             # Get compression function
-            compress_func = self._compression_funcs.get(self.config.compression_algorithm)
+            algorithm, level = self._select_compression(chunk_data)
+            compress_func = self._compression_funcs.get(algorithm)
             if not compress_func:
-                raise ValueError(f"Unsupported compression algorithm: {self.config.compression_algorithm}")
+                raise ValueError(f"Unsupported compression algorithm: {algorithm}")
             
             # Compress data
             start_time = time.time()
-            compressed_data = await compress_func(chunk_data)
+            compressed_data = await compress_func(chunk_data, level)
             compression_time = time.time() - start_time
             
+            # Only compressed chunks say anything about the compressor's rate
+            if self._compression_policy is not None and algorithm != "none":
+                self._compression_policy.record(len(chunk_data), compression_time)
+            
             # Calculate compression ratio
             compression_ratio = len(compressed_data) / len(chunk_data) if chunk_data else 0.0
             
@@ -224,8 +266,8 @@ class ChunkStore:
                 "timestamp": chunk.timestamp.isoformat(),
                 "size_bytes": len(chunk_data),
                 "compressed_size_bytes": len(compressed_data),
-                "compression_algorithm": self.config.compression_algorithm,
-                "compression_level": self.config.compression_level,
+                "compression_algorithm": algorithm,
+                "compression_level": level,
                 "compression_ratio": compression_ratio,
                 "compression_time_ms": compression_time * 1000,
                 "hash_sha256": chunk.hash_sha256,
@@ -547,6 +589,8 @@ class ChunkStore:
                 "compression_healthy": compression_healthy,
                 "available_space_bytes": available_space,
                 "compression_algorithm": self.config.compression_algorithm,
+                "adaptive_compression": self._compression_policy is not None,
+                "compression_tier_counts": list(self._compression_policy.tier_counts) if self._compression_policy else [],
                 "timestamp": datetime.utcnow().isoformat()
             }
             
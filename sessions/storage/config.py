@@ -90,6 +90,8 @@ class StorageSettings(BaseSettings):
     LUCID_CHUNK_SIZE_MB: int = 10
     LUCID_COMPRESSION_LEVEL: int = 6
     LUCID_COMPRESSION_ALGORITHM: str = "zstd"  # zstd, lz4, gzip
+    LUCID_ADAPTIVE_COMPRESSION: bool = True  # Per-chunk store/lz4/zstd from an entropy estimate
+    LUCID_COMPRESSION_TARGET_MBPS: float = 0.0  # 0 disables the throughput controller
     LUCID_ENCRYPTION_ENABLED: bool = True
     
     # Session Configuration
@@ -267,6 +269,8 @@ class StorageConfig:
             "base_path": self.settings.LUCID_CHUNK_STORE_PATH,
             "compression_algorithm": self.settings.LUCID_COMPRESSION_ALGORITHM,
             "compression_level": self.settings.LUCID_COMPRESSION_LEVEL,
+            "adaptive_compression": self.settings.LUCID_ADAPTIVE_COMPRESSION,
+            "compression_target_mbps": self.settings.LUCID_COMPRESSION_TARGET_MBPS,
             "chunk_size_mb": self.settings.LUCID_CHUNK_SIZE_MB,
             "max_chunks_per_session": self.settings.LUCID_MAX_CHUNKS_PER_SESSION,
             "cleanup_interval_hours": self.settings.LUCID_CLEANUP_INTERVAL_HOURS,
@@ -294,6 +298,8 @@ class StorageConfig:
             "LUCID_CHUNK_SIZE_MB": str(self.settings.LUCID_CHUNK_SIZE_MB),
             "LUCID_COMPRESSION_LEVEL": str(self.settings.LUCID_COMPRESSION_LEVEL),
             "LUCID_COMPRESSION_ALGORITHM": self.settings.LUCID_COMPRESSION_ALGORITHM,
+            "LUCID_ADAPTIVE_COMPRESSION": str(self.settings.LUCID_ADAPTIVE_COMPRESSION),
+            "LUCID_COMPRESSION_TARGET_MBPS": str(self.settings.LUCID_COMPRESSION_TARGET_MBPS),
             "LUCID_ENCRYPTION_ENABLED": str(self.settings.LUCID_ENCRYPTION_ENABLED),
             "LUCID_RETENTION_DAYS": str(self.settings.LUCID_RETENTION_DAYS),
             "LUCID_MAX_SESSIONS": str(self.settings.LUCID_MAX_SESSIONS),
@@ -543,6 +549,8 @@ def create_default_config_file(config_path: str = "config.yaml"):
         "LUCID_CHUNK_SIZE_MB": 10,
         "LUCID_COMPRESSION_LEVEL": 6,
         "LUCID_COMPRESSION_ALGORITHM": "zstd",
+        "LUCID_ADAPTIVE_COMPRESSION": True,
+        "LUCID_COMPRESSION_TARGET_MBPS": 0.0,
         "LUCID_ENCRYPTION_ENABLED": True,
         "LUCID_RETENTION_DAYS": 30,
         "LUCID_MAX_SESSIONS": 1000,
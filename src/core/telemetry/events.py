@@ -30,6 +30,14 @@ from collections import defaultdict, deque
 # Configure logging
 logger = logging.get_logger(__name__)
 
+# Native event bus, aggregation window and correlation index
+try:
+    import event_bus_native
+    EVENT_BUS_NATIVE_AVAILABLE = True
+except ImportError:
+    EVENT_BUS_NATIVE_AVAILABLE = False
+    logger.warning("event_bus_native not available, using Python event bus and windows")
+
 # Context variables for correlation
 correlation_id: ContextVar[Optional[str]] = ContextVar('correlation_id', default=None)
 request_id: ContextVar[Optional[str]] = ContextVar('request_id', default=None)
@@ -58,6 +66,19 @@ class EventCategory(Enum):
     AUTHENTICATION = "authentication"
     AUTHORIZATION = "authorization"
 
+# Small integer codes carried by fixed-layout records, in declaration order
+LEVEL_CODES = {level: code for code, level in enumerate(EventLevel)}
+CATEGORY_CODES = {category: code for code, category in enumerate(EventCategory)}
+LEVELS_BY_CODE = list(EventLevel)
+CATEGORIES_BY_CODE = list(EventCategory)
+
+# Resolved once; hashing an Enum member costs more than emitting a record
+PERFORMANCE_LEVEL_CODE = LEVEL_CODES[EventLevel.INFO]
+PERFORMANCE_CATEGORY_CODE = CATEGORY_CODES[EventCategory.PERFORMANCE]
+
+# Context ids indexed by the correlator, in key-kind order
+CORRELATION_KEYS = ('correlation_id', 'session_id', 'user_id', 'request_id')
+
 class EventStatus(Enum):
     """Event processing status."""
     PENDING = "pending"
@@ -364,122 +385,320 @@ class FileEventHandler(EventHandler):
         
         self.current_size = 0
 
+class _EventRing:
+    """Python counterpart of event_bus_native.EventBus; records are tuples."""
+    
+    def __init__(self, capacity: int = 65536):
+        self.capacity = capacity
+        self.records: deque = deque()
+        self.emitted = 0
+        self.dropped = 0
+        self.drained = 0
+    
+    def emit(self, level: int, category: int, code: int = 0, value: float = 0.0,
+             session: Optional[str] = None, trace: Optional[str] = None,
+             payload: Optional[Union[str, bytes]] = None) -> bool:
+        """Queue a record; False if the ring was full and it was dropped."""
+        if len(self.records) >= self.capacity:
+            self.dropped += 1
+            return False
+        self.records.append((time.time_ns(), session, trace, value or 0.0, code or 0,
+                             level, category, payload))
+        self.emitted += 1
+        return True
+    
+    def drain(self, max_events: int = 4096) -> List[tuple]:
+        """Records in emit order, up to max_events of them."""
+        count = min(max_events, len(self.records))
+        batch = [self.records.popleft() for _ in range(count)]
+        self.drained += count
+        return batch
+    
+    def __len__(self) -> int:
+        return len(self.records)
+    
+    @property
+    def stats(self) -> Dict[str, int]:
+        """Emitted, dropped and drained record counts."""
+        return {
+            'emitted': self.emitted,
+            'dropped': self.dropped,
+            'drained': self.drained,
+            'pending': len(self.records),
+            'capacity': self.capacity
+        }
+
+class _BucketWindow:
+    """Python counterpart of event_bus_native.EventWindow."""
+    
+    def __init__(self, bucket_ms: int = 1000, buckets: int = 60):
+        self.bucket_ns = bucket_ms * 1_000_000
+        self.span = bucket_ms * buckets / 1000
+        # Per slot: [epoch, counts by (category, level), events, value sum, min, max]
+        self.buckets: List[Optional[list]] = [None] * buckets
+        self.latest = -1
+        self.late = 0
+    
+    def add(self, level: int, category: int, value: float = 0.0,
+            timestamp_ns: Optional[int] = None):
+        """Count one event."""
+        epoch = (timestamp_ns or time.time_ns()) // self.bucket_ns
+        if epoch <= self.latest - len(self.buckets):
+            self.late += 1
+            return
+        self.latest = max(self.latest, epoch)
+        
+        slot = epoch % len(self.buckets)
+        bucket = self.buckets[slot]
+        if bucket is None or bucket[0] != epoch:
+            bucket = self.buckets[slot] = [epoch, defaultdict(int), 0, 0.0, value, value]
+        bucket[1][(category, level)] += 1
+        bucket[2] += 1
+        bucket[3] += value
+        bucket[4] = min(bucket[4], value)
+        bucket[5] = max(bucket[5], value)
+    
+    def add_records(self, records: List[tuple]) -> int:
+        """Count every record of a drained batch."""
+        for record in records:
+            self.add(record[5], record[6], record[3], record[0])
+        return len(records)
+    
+    def stats(self, now_ns: Optional[int] = None) -> Dict[str, Any]:
+        """Counts and value summary over the window ending at now_ns."""
+        now_ns = now_ns or time.time_ns()
+        now = now_ns // self.bucket_ns
+        live = [bucket for bucket in self.buckets
+                if bucket is not None and now - len(self.buckets) < bucket[0] <= now]
+        
+        counts: Dict[Tuple[int, int], int] = defaultdict(int)
+        for bucket in live:
+            for key, count in bucket[1].items():
+                counts[key] += count
+        first = min((bucket[0] for bucket in live), default=None)
+        return {
+            'events': sum(bucket[2] for bucket in live),
+            'value_sum': sum(bucket[3] for bucket in live),
+            'value_min': min((bucket[4] for bucket in live), default=0.0),
+            'value_max': max((bucket[5] for bucket in live), default=0.0),
+            'span': (now_ns - first * self.bucket_ns) / 1e9 if first is not None else 0.0,
+            'late': self.late,
+            'counts': dict(counts)
+        }
+
+class _CorrelationIndex:
+    """Python counterpart of event_bus_native.Correlator, keyed by the raw ids."""
+    
+    def __init__(self, capacity: int = 16384, window: float = 300.0):
+        self.capacity = capacity
+        self.window_ns = int(window * 1e9)
+        self.log: deque = deque()  # (seq, timestamp_ns, keys)
+        # Per (kind, key): deque of (seq, timestamp_ns), oldest first
+        self.chains: Dict[Tuple[int, Any], deque] = {}
+        self.head = 0
+        self.expired = 0
+        self.evicted = 0
+    
+    def _pop_oldest(self):
+        # The oldest entry heads the chain of every key it carries
+        seq, _, keys = self.log.popleft()
+        for kind, key in enumerate(keys):
+            if key is not None:
+                chain = self.chains[(kind, key)]
+                chain.popleft()
+                if not chain:
+                    del self.chains[(kind, key)]
+    
+    def expire(self, now_ns: Optional[int] = None) -> int:
+        """Drop entries older than the window."""
+        cutoff = (now_ns or time.time_ns()) - self.window_ns
+        count = 0
+        while self.log and self.log[0][1] <= cutoff:
+            self._pop_oldest()
+            count += 1
+        self.expired += count
+        return count
+    
+    def add(self, trace=None, session=None, user=None, request=None,
+            level: int = 0, category: int = 0, timestamp_ns: Optional[int] = None) -> int:
+        """Index one event by its ids; returns its sequence number."""
+        self.expire()
+        if len(self.log) >= self.capacity:
+            self._pop_oldest()
+            self.evicted += 1
+        
+        seq = self.head
+        self.head += 1
+        timestamp_ns = timestamp_ns or time.time_ns()
+        keys = (trace, session, user, request)
+        self.log.append((seq, timestamp_ns, keys))
+        for kind, key in enumerate(keys):
+            if key is not None:
+                self.chains.setdefault((kind, key), deque()).append((seq, timestamp_ns))
+        return seq
+    
+    def add_records(self, records: List[tuple]) -> int:
+        """Index a drained batch by session and trace."""
+        added = 0
+        for record in records:
+            if record[1] is not None or record[2] is not None:
+                self.add(trace=record[2], session=record[1], timestamp_ns=record[0])
+                added += 1
+        return added
+    
+    def lookup(self, kind: int, key, now_ns: Optional[int] = None) -> List[int]:
+        """Live sequence numbers with the key, oldest first."""
+        cutoff = (now_ns or time.time_ns()) - self.window_ns
+        return [seq for seq, timestamp_ns in self.chains.get((kind, key), ())
+                if timestamp_ns > cutoff]
+    
+    def __contains__(self, seq: int) -> bool:
+        return bool(self.log) and self.log[0][0] <= seq < self.head
+    
+    def __len__(self) -> int:
+        return len(self.log)
+    
+    @property
+    def stats(self) -> Dict[str, int]:
+        """Live entries and keys, expired and evicted counts."""
+        return {
+            'entries': len(self.log),
+            'keys': len(self.chains),
+            'expired': self.expired,
+            'evicted': self.evicted,
+            'capacity': self.capacity
+        }
+
 class EventAggregator:
     """Event aggregator for batch processing and analytics."""
     
-    def __init__(self, window_size: int = 100, window_time: int = 60):
+    def __init__(self, window_size: int = 100, window_time: int = 60, bucket_ms: int = 1000):
         self.window_size = window_size
         self.window_time = window_time
         self.events: deque = deque(maxlen=window_size)
         self.window_start = time.time()
-        self.aggregated_stats: Dict[str, Any] = defaultdict(int)
+        # Counts slide over window_time in bucket_ms steps instead of being
+        # recounted, so adding an event is O(1)
+        buckets = max(1, int(window_time * 1000 // bucket_ms))
+        if EVENT_BUS_NATIVE_AVAILABLE:
+            self.window = event_bus_native.EventWindow(bucket_ms, buckets)
+        else:
+            self.window = _BucketWindow(bucket_ms, buckets)
     
     def add_event(self, event: TelemetryEvent):
         """Add event to aggregation window."""
         self.events.append(event)
-        self._update_stats(event)
+        self.window.add(LEVEL_CODES[event.level], CATEGORY_CODES[event.category], 0.0,
+                        int(event.timestamp.timestamp() * 1e9))
     
-    def _update_stats(self, event: TelemetryEvent):
-        """Update aggregation statistics."""
-        key = f"{event.category.value}:{event.level.value}"
-        self.aggregated_stats[key] += 1
-        self.aggregated_stats[f"total_{event.category.value}"] += 1
-        self.aggregated_stats[f"total_{event.level.value}"] += 1
-        self.aggregated_stats['total_events'] += 1
+    def add_records(self, records) -> int:
+        """Add a drained bus batch to the aggregation window."""
+        return self.window.add_records(records)
+    
+    def _format_stats(self, counts: Dict[Tuple[int, int], int]) -> Dict[str, int]:
+        """Aggregation statistics keyed by category and level names."""
+        stats: Dict[str, int] = defaultdict(int)
+        for (category, level), count in counts.items():
+            category_name = (CATEGORIES_BY_CODE[category].value
+                             if category < len(CATEGORIES_BY_CODE) else str(category))
+            level_name = LEVELS_BY_CODE[level].value if level < len(LEVELS_BY_CODE) else str(level)
+            stats[f"{category_name}:{level_name}"] += count
+            stats[f"total_{category_name}"] += count
+            stats[f"total_{level_name}"] += count
+            stats['total_events'] += count
+        return dict(stats)
     
     def get_window_stats(self) -> Dict[str, Any]:
         """Get current window statistics."""
         current_time = time.time()
-        window_duration = current_time - self.window_start
+        window = self.window.stats()
+        window_duration = min(window['span'], float(self.window_time))
         
         stats = {
             'window_duration': window_duration,
-            'event_count': len(self.events),
-            'events_per_second': len(self.events) / window_duration if window_duration > 0 else 0,
-            'stats': dict(self.aggregated_stats)
+            'event_count': window['events'],
+            'events_per_second': window['events'] / window_duration if window_duration > 0 else 0,
+            'late_events': window['late'],
+            'stats': self._format_stats(window['counts'])
         }
         
-        # Reset window if time exceeded
-        if window_duration >= self.window_time:
+        # Start a new flush window; the counts keep sliding
+        if current_time - self.window_start >= self.window_time:
             self.events.clear()
-            self.aggregated_stats.clear()
             self.window_start = current_time
         
         return stats
     
     def should_flush(self) -> bool:
         """Check if aggregation window should be flushed."""
-        return (len(self.events) >= self.window_size or 
+        return (len(self.events) >= self.window_size or
                 time.time() - self.window_start >= self.window_time)
 
 class EventCorrelator:
     """Event correlator for finding related events."""
     
-    def __init__(self, correlation_window: int = 300):  # 5 minutes
+    def __init__(self, correlation_window: int = 300, capacity: int = 16384):  # 5 minutes
         self.correlation_window = correlation_window
-        self.events_by_correlation: Dict[str, List[TelemetryEvent]] = defaultdict(list)
-        self.events_by_user: Dict[str, List[TelemetryEvent]] = defaultdict(list)
-        self.events_by_session: Dict[str, List[TelemetryEvent]] = defaultdict(list)
-        self.events_by_request: Dict[str, List[TelemetryEvent]] = defaultdict(list)
+        # The index keeps entries in a ring log and expires them from its old
+        # end, so adding an event never scans the groups
+        if EVENT_BUS_NATIVE_AVAILABLE:
+            self.index = event_bus_native.Correlator(capacity, float(correlation_window))
+        else:
+            self.index = _CorrelationIndex(capacity, correlation_window)
+        # Event objects by log position; an entry is valid while its sequence
+        # number is still live in the index
+        self.slots: List[Optional[Tuple[int, TelemetryEvent]]] = [None] * self.index.stats['capacity']
+        self.seq_by_id: Dict[str, int] = {}
     
     def add_event(self, event: TelemetryEvent):
         """Add event for correlation."""
-        now = time.time()
-        
-        # Add to correlation groups
-        if event.context.correlation_id:
-            self.events_by_correlation[event.context.correlation_id].append(event)
-        
-        if event.context.user_id:
-            self.events_by_user[event.context.user_id].append(event)
-        
-        if event.context.session_id:
-            self.events_by_session[event.context.session_id].append(event)
+        ids = [getattr(event.context, key) for key in CORRELATION_KEYS]
+        if not any(ids):
+            return
         
-        if event.context.request_id:
-            self.events_by_request[event.context.request_id].append(event)
-        
-        # Clean up old events
-        self._cleanup_old_events(now)
+        seq = self.index.add(*ids, LEVEL_CODES[event.level], CATEGORY_CODES[event.category],
+                             int(event.timestamp.timestamp() * 1e9))
+        slot = seq % len(self.slots)
+        previous = self.slots[slot]
+        if previous is not None:
+            self.seq_by_id.pop(previous[1].id, None)
+        self.slots[slot] = (seq, event)
+        self.seq_by_id[event.id] = seq
+    
+    def add_records(self, records) -> int:
+        """Index a drained bus batch by session and trace."""
+        return self.index.add_records(records)
     
     def _cleanup_old_events(self, current_time: float):
         """Remove events older than correlation window."""
-        cutoff_time = current_time - self.correlation_window
-        
-        for event_list in [self.events_by_correlation, self.events_by_user, 
-                          self.events_by_session, self.events_by_request]:
-            for key, events in list(event_list.items()):
-                # Filter out old events
-                filtered_events = [
-                    event for event in events 
-                    if event.timestamp.timestamp() > cutoff_time
-                ]
-                if filtered_events:
-                    event_list[key] = filtered_events
-                else:
-                    del event_list[key]
+        self.index.expire(int(current_time * 1e9))
+    
+    def _events_for(self, kind: int, key: str) -> List[TelemetryEvent]:
+        """Live events with the key, oldest first."""
+        events = []
+        for seq in self.index.lookup(kind, key):
+            entry = self.slots[seq % len(self.slots)]
+            # Bus records hold log positions without event objects
+            if entry is not None and entry[0] == seq:
+                events.append(entry[1])
+        return events
+    
+    def find_event(self, event_id: str) -> Optional[TelemetryEvent]:
+        """Live event with the given ID."""
+        seq = self.seq_by_id.get(event_id)
+        if seq is None or seq not in self.index:
+            return None
+        entry = self.slots[seq % len(self.slots)]
+        return entry[1] if entry is not None and entry[0] == seq else None
     
     def get_correlated_events(self, event: TelemetryEvent) -> Dict[str, List[TelemetryEvent]]:
         """Get events correlated with the given event."""
         correlated = {}
         
-        if event.context.correlation_id:
-            correlated['correlation_id'] = self.events_by_correlation.get(
-                event.context.correlation_id, []
-            )
-        
-        if event.context.user_id:
-            correlated['user_id'] = self.events_by_user.get(event.context.user_id, [])
-        
-        if event.context.session_id:
-            correlated['session_id'] = self.events_by_session.get(
-                event.context.session_id, []
-            )
-        
-        if event.context.request_id:
-            correlated['request_id'] = self.events_by_request.get(
-                event.context.request_id, []
-            )
+        for kind, key in enumerate(CORRELATION_KEYS):
+            value = getattr(event.context, key)
+            if value:
+                correlated[key] = self._events_for(kind, value)
         
         return correlated
 
@@ -489,15 +708,22 @@ class EventProcessor:
     def __init__(self, 
                  metadata: Optional[EventMetadata] = None,
                  enable_correlation: bool = True,
-                 enable_aggregation: bool = True):
+                 enable_aggregation: bool = True,
+                 bus_capacity: int = 65536):
         self.metadata = metadata or self._create_default_metadata()
         self.handlers: List[EventHandler] = []
         self.correlator = EventCorrelator() if enable_correlation else None
         self.aggregator = EventAggregator() if enable_aggregation else None
+        # Fixed-layout records from hot paths; drained in batches
+        if EVENT_BUS_NATIVE_AVAILABLE:
+            self.bus = event_bus_native.EventBus(bus_capacity)
+        else:
+            self.bus = _EventRing(bus_capacity)
         self.processing_stats = {
             'total_events': 0,
             'processed_events': 0,
             'failed_events': 0,
+            'drained_records': 0,
             'start_time': datetime.now(timezone.utc)
         }
     
@@ -567,6 +793,58 @@ class EventProcessor:
         
         return event_id
     
+    def record(self,
+               level: EventLevel,
+               category: EventCategory,
+               value: float = 0.0,
+               code: int = 0,
+               session: Optional[str] = None,
+               trace: Optional[str] = None,
+               payload: Optional[Union[str, bytes]] = None) -> bool:
+        """Queue a fixed-layout record without blocking; False if the bus was full.
+        
+        Records skip the handlers. drain_records feeds them to the aggregator
+        and correlator in batches.
+        """
+        return self.bus.emit(LEVEL_CODES[level], CATEGORY_CODES[category], code, value,
+                             session or session_id.get(), trace or correlation_id.get(),
+                             payload)
+    
+    def record_performance(self, value: float, code: int = 0,
+                           session: Optional[str] = None,
+                           trace: Optional[str] = None,
+                           payload: Optional[Union[str, bytes]] = None) -> bool:
+        """Queue a performance measurement record; cheap enough for per-chunk paths."""
+        return self.bus.emit(PERFORMANCE_LEVEL_CODE, PERFORMANCE_CATEGORY_CODE, code, value,
+                             session or session_id.get(), trace or correlation_id.get(),
+                             payload)
+    
+    def drain_records(self, max_events: int = 4096) -> int:
+        """Move up to max_events queued records into the aggregator and correlator."""
+        batch = self.bus.drain(max_events)
+        if not batch:
+            return 0
+        
+        if self.aggregator:
+            self.aggregator.add_records(batch)
+        if self.correlator:
+            self.correlator.add_records(batch)
+        
+        if isinstance(batch, bytes):
+            count = len(batch) // event_bus_native.RECORD_SIZE
+        else:
+            count = len(batch)
+        self.processing_stats['drained_records'] += count
+        return count
+    
+    async def consume_records(self, interval: float = 0.1, max_events: int = 4096):
+        """Drain the bus until cancelled, in batches of up to max_events."""
+        while True:
+            # Keep draining while full batches come back, yielding in between
+            while self.drain_records(max_events) == max_events:
+                await asyncio.sleep(0)
+            await asyncio.sleep(interval)
+    
     async def _process_event(self, event: TelemetryEvent):
         """Process a telemetry event."""
         start_time = time.time()
@@ -607,14 +885,10 @@ class EventProcessor:
         if not self.correlator:
             return None
         
-        # Find the event by ID (simplified - in production, use proper storage)
-        for events in [self.correlator.events_by_correlation, self.correlator.events_by_user,
-                      self.correlator.events_by_session, self.correlator.events_by_request]:
-            for event_list in events.values():
-                for event in event_list:
-                    if event.id == event_id:
-                        return self.correlator.get_correlated_events(event)
-        return None
+        event = self.correlator.find_event(event_id)
+        if event is None:
+            return None
+        return self.correlator.get_correlated_events(event)
     
     def get_processing_stats(self) -> Dict[str, Any]:
         """Get processing statistics."""
@@ -627,8 +901,10 @@ class EventProcessor:
             'total_events': self.processing_stats['total_events'],
             'processed_events': self.processing_stats['processed_events'],
             'failed_events': self.processing_stats['failed_events'],
+            'drained_records': self.processing_stats['drained_records'],
             'events_per_second': events_per_second,
-            'handler_stats': [handler.get_stats() for handler in self.handlers]
+            'handler_stats': [handler.get_stats() for handler in self.handlers],
+            'bus_stats': self.bus.stats
         }
         
         if self.aggregator:
@@ -6,6 +6,7 @@ This package contains performance tests to validate system benchmarks:
 - Blockchain consensus: 1 block per 10 seconds
 - Session processing: <100ms per chunk
 - Database queries: <10ms p95 query latency
+- Native codecs: no regression against the stored baseline
 
 Tests use pytest, locust, and custom benchmarking utilities.
 """
@@ -18,7 +19,8 @@ PERFORMANCE_CATEGORIES = [
     "api_gateway_throughput",
     "blockchain_consensus", 
     "session_processing",
-    "database_queries"
+    "database_queries",
+    "native_codecs"
 ]
 
 # Benchmark thresholds
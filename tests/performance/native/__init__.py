@@ -0,0 +1,13 @@
+"""
+Native Codec Benchmarks
+
+Benchmarks and a regression gate for the chunker_native and
+encryptor_native extensions:
+- corpora: synthetic desktop frames, JSON telemetry and random data
+- bench_native: Python-level throughput, call overhead and thread scaling,
+  optionally merged with the standalone C benchmarks (setup.py bench)
+- compare_baseline: compares a results file against a stored baseline
+"""
+
+# Default location of the stored baseline
+BASELINE_FILE = "baseline.json"
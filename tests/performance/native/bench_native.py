@@ -0,0 +1,244 @@
+#!/usr/bin/env python3
+"""
+Python-level benchmark for the native chunker and encryptor.
+
+Measures what callers see through the extension boundary: per-call
+overhead on tiny inputs, chunk and encrypt throughput per corpus, the
+chunk -> encrypt pipeline, and how chunking scales across threads now
+that it runs without the GIL. With --c-bench the standalone C
+benchmarks are built and run through each app's `setup.py bench` and
+merged into the same results file.
+
+Usage:
+    python -m tests.performance.native.bench_native --quick -o results.json
+    python -m tests.performance.native.compare_baseline results.json
+"""
+
+import argparse
+import json
+import os
+import platform
+import subprocess
+import sys
+import threading
+import time
+from pathlib import Path
+from typing import Any, Callable, Dict, Optional
+
+from .corpora import load_corpora
+
+try:
+    import chunker_native
+except ImportError:
+    chunker_native = None
+
+try:
+    import encryptor_native
+except ImportError:
+    encryptor_native = None
+
+REPO_ROOT = Path(__file__).resolve().parents[3]
+RESULTS_VERSION = 1
+REPEATS = 3
+
+
+def machine_info() -> Dict[str, Any]:
+    """Enough to tell whether two result files are comparable"""
+    cpu = platform.processor()
+    try:
+        with open("/proc/cpuinfo") as f:
+            for line in f:
+                if line.startswith("model name"):
+                    cpu = line.split(":", 1)[1].strip()
+                    break
+    except OSError:
+        pass
+    return {
+        "cpu": cpu,
+        "cpu_count": os.cpu_count(),
+        "machine": platform.machine(),
+        "python": platform.python_version(),
+    }
+
+
+def best_time(fn: Callable[[], Any], min_time: float) -> float:
+    """Best-of-REPEATS seconds per call, each repeat running at least min_time"""
+    best = None
+    for _ in range(REPEATS):
+        calls = 0
+        started = time.perf_counter()
+        elapsed = 0.0
+        while elapsed < min_time:
+            fn()
+            calls += 1
+            elapsed = time.perf_counter() - started
+        per_call = elapsed / calls
+        best = per_call if best is None else min(best, per_call)
+    return best
+
+
+def throughput(nbytes: int, seconds: float) -> Dict[str, float]:
+    return {"mb_per_s": round(nbytes / seconds / 1e6, 2), "ns_per_op": round(seconds * 1e9)}
+
+
+def bench_overhead(results: Dict[str, Any], min_time: float):
+    """Call cost on inputs too small for the work itself to matter"""
+    tiny = b"x" * 64
+    chunker = chunker_native.Chunker(adaptive=False)
+    cases = {
+        "overhead/compress_data": lambda: chunker_native.compress_data(tiny),
+        "overhead/checksum": lambda: chunker_native.checksum(tiny),
+        "overhead/chunk": lambda: chunker.chunk(tiny),
+    }
+    if encryptor_native is not None:
+        encryptor = encryptor_native.Encryptor()
+        key = encryptor.generate_key()
+        cases["overhead/encrypt"] = lambda: encryptor.encrypt(tiny, key)
+    for name, fn in cases.items():
+        results[name] = {"ns_per_op": round(best_time(fn, min_time) * 1e9)}
+
+
+def bench_chunk(results: Dict[str, Any], corpora: Dict[str, bytes], min_time: float):
+    """Chunker.chunk throughput and ratio per corpus and chunk size"""
+    chunker = chunker_native.Chunker()
+    for corpus, data in corpora.items():
+        for size in (64 * 1024, 1024 * 1024):
+            blocks = [data[off:off + size] for off in range(0, len(data) - size + 1, size)]
+            stored = sum(len(chunker.chunk(block)["data"]) for block in blocks)
+            seconds = best_time(lambda: [chunker.chunk(block) for block in blocks], min_time)
+            entry = throughput(size, seconds / len(blocks))
+            entry["ratio"] = round(size * len(blocks) / stored, 4)
+            results["chunk/%s/chunk=%d" % (corpus, size)] = entry
+
+    data = corpora["random"][:1024 * 1024]
+    seconds = best_time(lambda: chunker_native.checksum(data), min_time)
+    results["checksum/size=1048576"] = throughput(len(data), seconds)
+
+
+def bench_encrypt(results: Dict[str, Any], corpora: Dict[str, bytes], min_time: float):
+    """Encryptor throughput and the chunk -> encrypt pipeline"""
+    encryptor = encryptor_native.Encryptor()
+    key = encryptor.generate_key()
+    data = corpora["random"]
+    for size in (16 * 1024, 1024 * 1024):
+        block = data[:size]
+        sealed = encryptor.encrypt(block, key)
+        results["encrypt/size=%d" % size] = throughput(size, best_time(lambda: encryptor.encrypt(block, key), min_time))
+        results["decrypt/size=%d" % size] = throughput(size, best_time(lambda: encryptor.decrypt(sealed, key), min_time))
+
+    chunker = chunker_native.Chunker()
+    size = 1024 * 1024
+    for corpus, data in corpora.items():
+        blocks = [data[off:off + size] for off in range(0, len(data) - size + 1, size)]
+
+        def pipeline():
+            for block in blocks:
+                encryptor.encrypt(chunker.chunk(block)["data"], key)
+
+        seconds = best_time(pipeline, min_time)
+        results["pipeline/%s/chunk=%d" % (corpus, size)] = {
+            "mb_per_s": round(size * len(blocks) / seconds / 1e6, 2)
+        }
+
+
+def bench_threads(results: Dict[str, Any], corpora: Dict[str, bytes], min_time: float):
+    """Aggregate Chunker.chunk throughput as threads are added"""
+    size = 256 * 1024
+    data = corpora["frames"]
+    blocks = [data[off:off + size] for off in range(0, len(data) - size + 1, size)]
+    counts = [n for n in (1, 2, 4, 8) if n <= (os.cpu_count() or 1)]
+    single = None
+
+    for count in counts:
+        best = None
+        for _ in range(REPEATS):
+            chunkers = [chunker_native.Chunker() for _ in range(count)]
+            barrier = threading.Barrier(count + 1)
+            done = [0] * count
+
+            def work(index):
+                barrier.wait()
+                started = time.perf_counter()
+                while time.perf_counter() - started < min_time:
+                    for block in blocks:
+                        chunkers[index].chunk(block)
+                    done[index] += len(blocks) * size
+
+            workers = [threading.Thread(target=work, args=(i,)) for i in range(count)]
+            for worker in workers:
+                worker.start()
+            barrier.wait()
+            started = time.perf_counter()
+            for worker in workers:
+                worker.join()
+            rate = sum(done) / (time.perf_counter() - started) / 1e6
+            best = rate if best is None else max(best, rate)
+
+        single = single or best
+        results["threads/chunk/frames/threads=%d" % count] = {
+            "mb_per_s": round(best, 2),
+            "speedup": round(best / single, 3),
+        }
+
+
+def run_c_bench(app: str, quick: bool) -> Optional[Dict[str, Any]]:
+    """Build and run an app's standalone C benchmark; None if it cannot build"""
+    command = [sys.executable, "setup.py", "-q", "bench"] + (["--quick"] if quick else [])
+    proc = subprocess.run(command, cwd=REPO_ROOT / "apps" / app,
+                          capture_output=True, text=True)
+    if proc.returncode != 0:
+        print("C benchmark for %s unavailable:\n%s" % (app, proc.stderr[-2000:]), file=sys.stderr)
+        return None
+    return json.loads(proc.stdout)
+
+
+def run(quick: bool = False, c_bench: bool = False) -> Dict[str, Any]:
+    """All suites as one results document"""
+    if chunker_native is None:
+        raise RuntimeError("chunker_native is not built")
+
+    corpus_size = (4 if quick else 16) * 1024 * 1024
+    min_time = 0.05 if quick else 0.3
+    corpora = load_corpora(corpus_size)
+    python_results: Dict[str, Any] = {}
+
+    bench_overhead(python_results, min_time)
+    bench_chunk(python_results, corpora, min_time)
+    if encryptor_native is not None:
+        bench_encrypt(python_results, corpora, min_time)
+    bench_threads(python_results, corpora, min_time)
+
+    suites = {"python": python_results}
+    if c_bench:
+        for app in ("chunker", "encryptor"):
+            output = run_c_bench(app, quick)
+            if output is not None:
+                suites[output["suite"]] = output["results"]
+
+    return {
+        "version": RESULTS_VERSION,
+        "created": time.strftime("%Y-%m-%dT%H:%M:%SZ", time.gmtime()),
+        "quick": quick,
+        "machine": machine_info(),
+        "suites": suites,
+    }
+
+
+def main(argv=None) -> int:
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("-o", "--output", help="write results JSON here instead of stdout")
+    parser.add_argument("--quick", action="store_true", help="smaller corpora and shorter timing loops")
+    parser.add_argument("--c-bench", action="store_true", help="also build and run the C benchmarks")
+    args = parser.parse_args(argv)
+
+    results = run(quick=args.quick, c_bench=args.c_bench)
+    text = json.dumps(results, indent=2, sort_keys=True)
+    if args.output:
+        Path(args.output).write_text(text + "\n")
+    else:
+        print(text)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
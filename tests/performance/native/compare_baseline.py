@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+"""
+Regression gate for native codec benchmark results.
+
+Compares a results file from bench_native against a stored baseline.
+Every metric the two share is checked against a relative threshold in
+its own direction: throughput, ratio and speedup must not drop, ns_per_op
+must not rise. Cases missing from either side are reported but do not
+fail the gate. Exits 1 when any metric regresses past its threshold.
+
+Usage:
+    python -m tests.performance.native.compare_baseline results.json
+    python -m tests.performance.native.compare_baseline results.json --update
+"""
+
+import argparse
+import json
+import sys
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Dict, List, Optional
+
+from . import BASELINE_FILE
+
+# Relative change allowed before a metric counts as regressed
+DEFAULT_THRESHOLDS = {
+    "mb_per_s": 0.10,
+    "ops_per_s": 0.10,
+    "ns_per_op": 0.15,   # Short calls are noisier than bulk throughput
+    "speedup": 0.15,
+    "ratio": 0.01,       # Deterministic for a given zlib build
+}
+
+HIGHER_IS_BETTER = {"mb_per_s", "ops_per_s", "speedup", "ratio"}
+LOWER_IS_BETTER = {"ns_per_op"}
+
+DEFAULT_BASELINE = Path(__file__).resolve().parent / BASELINE_FILE
+
+
+@dataclass
+class Change:
+    """One metric compared against the baseline"""
+    suite: str
+    case: str
+    metric: str
+    baseline: float
+    current: float
+    threshold: float
+
+    @property
+    def delta(self) -> float:
+        """Relative change, positive when better"""
+        if self.baseline == 0:
+            return 0.0
+        change = (self.current - self.baseline) / self.baseline
+        return change if self.metric in HIGHER_IS_BETTER else -change
+
+    @property
+    def regressed(self) -> bool:
+        return self.delta < -self.threshold
+
+    def __str__(self) -> str:
+        return "%s %s %s: %g -> %g (%+.1f%%, limit -%.0f%%)" % (
+            self.suite, self.case, self.metric, self.baseline, self.current,
+            self.delta * 100, self.threshold * 100)
+
+
+@dataclass
+class Comparison:
+    """Outcome of comparing two results documents"""
+    changes: List[Change]
+    missing: List[str]
+    added: List[str]
+    warnings: List[str]
+
+    @property
+    def regressions(self) -> List[Change]:
+        return [c for c in self.changes if c.regressed]
+
+    @property
+    def passed(self) -> bool:
+        return not self.regressions
+
+
+def compare(baseline: Dict, current: Dict,
+            thresholds: Optional[Dict[str, float]] = None) -> Comparison:
+    """Compare every shared suite, case and metric"""
+    limits = dict(DEFAULT_THRESHOLDS)
+    limits.update(baseline.get("thresholds", {}))
+    limits.update(thresholds or {})
+
+    warnings = []
+    base_machine = baseline.get("machine", {})
+    machine = current.get("machine", {})
+    for key in ("cpu", "cpu_count"):
+        if base_machine.get(key) != machine.get(key):
+            warnings.append("baseline %s %r differs from %r; throughput is not comparable"
+                            % (key, base_machine.get(key), machine.get(key)))
+    if baseline.get("quick") != current.get("quick"):
+        warnings.append("baseline and results were taken with different --quick settings")
+
+    changes, missing, added = [], [], []
+    base_suites = baseline.get("suites", {})
+    suites = current.get("suites", {})
+    for suite, cases in base_suites.items():
+        for case, metrics in cases.items():
+            measured = suites.get(suite, {}).get(case)
+            if measured is None:
+                missing.append("%s %s" % (suite, case))
+                continue
+            for metric, value in metrics.items():
+                if metric not in limits or metric not in measured:
+                    continue
+                changes.append(Change(suite, case, metric, float(value),
+                                      float(measured[metric]), limits[metric]))
+    for suite, cases in suites.items():
+        for case in cases:
+            if case not in base_suites.get(suite, {}):
+                added.append("%s %s" % (suite, case))
+
+    return Comparison(changes, missing, added, warnings)
+
+
+def main(argv=None) -> int:
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("results", help="results JSON from bench_native")
+    parser.add_argument("--baseline", default=str(DEFAULT_BASELINE), help="stored baseline JSON")
+    parser.add_argument("--threshold", action="append", default=[], metavar="METRIC=FRACTION",
+                        help="override a relative threshold, e.g. mb_per_s=0.05")
+    parser.add_argument("--update", action="store_true", help="store the results as the new baseline")
+    args = parser.parse_args(argv)
+
+    current = json.loads(Path(args.results).read_text())
+    baseline_path = Path(args.baseline)
+
+    if args.update:
+        # Keep any per-baseline threshold overrides across updates
+        if baseline_path.exists():
+            thresholds = json.loads(baseline_path.read_text()).get("thresholds")
+            if thresholds:
+                current["thresholds"] = thresholds
+        baseline_path.write_text(json.dumps(current, indent=2, sort_keys=True) + "\n")
+        print("Baseline written to %s" % baseline_path)
+        return 0
+
+    if not baseline_path.exists():
+        print("No baseline at %s; record one with --update" % baseline_path, file=sys.stderr)
+        return 2
+
+    overrides = {}
+    for item in args.threshold:
+        metric, _, value = item.partition("=")
+        overrides[metric] = float(value)
+
+    result = compare(json.loads(baseline_path.read_text()), current, overrides)
+    for warning in result.warnings:
+        print("warning: %s" % warning)
+    for name in result.missing:
+        print("missing: %s" % name)
+    for name in result.added:
+        print("new: %s" % name)
+    for change in result.regressions:
+        print("REGRESSION: %s" % change)
+
+    print("%d metrics compared, %d regressed" % (len(result.changes), len(result.regressions)))
+    return 0 if result.passed else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
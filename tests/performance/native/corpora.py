@@ -0,0 +1,84 @@
+"""
+Benchmark corpora for the native codecs.
+
+Each generator is deterministic for a given size so results compare
+across runs. They mirror the C benchmark's corpora:
+- frames: BGRA desktop captures, flat backgrounds with glyph noise
+- telemetry: recorder events serialized as JSON lines
+- random: stands in for ciphertext and already compressed media
+"""
+
+import json
+import random
+
+import numpy as np
+
+FRAME_WIDTH = 1920
+FRAME_HEIGHT = 1080
+
+
+def desktop_frames(size: int) -> bytes:
+    """Raw BGRA frames: title bar gradient, sidebar, text rows"""
+    rng = np.random.default_rng(0)
+    frame = np.full((FRAME_HEIGHT, FRAME_WIDTH, 4), 0xF0, dtype=np.uint8)
+    frame[:, :, 3] = 0xFF
+    frame[:, :320, :3] = (0x2B, 0x2B, 0x30)
+    frame[:32, :, 0] = (np.arange(FRAME_WIDTH) * 255 // FRAME_WIDTH).astype(np.uint8)
+    frame[:32, :, 1:3] = (0x60, 0x30)
+
+    # Glyph-like noise in every third band of 18 rows
+    for top in range(32 + 18, FRAME_HEIGHT, 54):
+        band = frame[top:top + 18, :, :3]
+        ink = rng.integers(0, 64, size=band.shape[:2], dtype=np.uint8)
+        mask = (rng.random(band.shape[:2]) < 0.25) & ((np.arange(FRAME_WIDTH) % 240) < 180)
+        band[mask] = ink[mask][:, None]
+
+    # Later frames differ only where the cursor and a clock moved
+    frames = []
+    total = 0
+    index = 0
+    while total < size:
+        current = frame.copy()
+        current[8:24, FRAME_WIDTH - 120:FRAME_WIDTH - 20, :3] = index % 256
+        frames.append(current.tobytes())
+        total += current.nbytes
+        index += 1
+    return b"".join(frames)[:size]
+
+
+def json_telemetry(size: int) -> bytes:
+    """Keystroke and resource events as JSON lines"""
+    rng = random.Random(42)
+    windows = ["editor", "terminal", "browser", "mail"]
+    lines = []
+    total = 0
+    ts = 1_700_000_000_000
+    while total < size:
+        ts += rng.randrange(40)
+        line = json.dumps({
+            "ts": ts,
+            "type": rng.choice(["key", "window", "resource"]),
+            "code": rng.randrange(128),
+            "window": rng.choice(windows),
+            "cpu": round(rng.random() * 100, 1),
+        }, separators=(",", ":")).encode() + b"\n"
+        lines.append(line)
+        total += len(line)
+    return b"".join(lines)[:size]
+
+
+def random_data(size: int) -> bytes:
+    """Incompressible bytes"""
+    return random.Random(7).randbytes(size)
+
+
+CORPORA = {
+    "frames": desktop_frames,
+    "telemetry": json_telemetry,
+    "random": random_data,
+}
+
+
+def load_corpora(size: int) -> dict:
+    """Every corpus at the given size"""
+    return {name: make(size) for name, make in CORPORA.items()}
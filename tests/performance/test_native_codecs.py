@@ -0,0 +1,95 @@
+"""
+Native Codec Performance Tests
+
+Tests the chunker_native / encryptor_native benchmark and its regression gate:
+- Comparison: direction-aware relative thresholds per metric
+- Benchmark: quick Python-level run produces every suite and case
+- Regression gate: quick run against the stored baseline, when one exists
+
+Record a baseline on the reference machine with:
+    python -m tests.performance.native.bench_native -o results.json
+    python -m tests.performance.native.compare_baseline results.json --update
+"""
+
+import json
+
+import pytest
+
+from tests.performance.native.compare_baseline import DEFAULT_BASELINE, compare
+
+
+def results(**cases):
+    """Results document with one python suite"""
+    return {
+        "machine": {"cpu": "test", "cpu_count": 4},
+        "quick": True,
+        "suites": {"python": cases},
+    }
+
+
+class TestCompareBaseline:
+    """Test the baseline comparison"""
+
+    def test_each_metric_regresses_in_its_own_direction(self):
+        """Throughput must not drop and latency must not rise"""
+        baseline = results(a={"mb_per_s": 100.0, "ns_per_op": 1000.0})
+        slower = results(a={"mb_per_s": 85.0, "ns_per_op": 1300.0})
+        faster = results(a={"mb_per_s": 130.0, "ns_per_op": 700.0})
+
+        regressed = compare(baseline, slower).regressions
+        assert {c.metric for c in regressed} == {"mb_per_s", "ns_per_op"}
+        assert compare(baseline, faster).passed
+
+    def test_thresholds_from_baseline_and_overrides(self):
+        """Baseline thresholds replace defaults and explicit overrides win"""
+        baseline = results(a={"mb_per_s": 100.0})
+        current = results(a={"mb_per_s": 93.0})
+        assert compare(baseline, current).passed
+
+        baseline["thresholds"] = {"mb_per_s": 0.05}
+        assert not compare(baseline, current).passed
+        assert compare(baseline, current, {"mb_per_s": 0.2}).passed
+
+    def test_missing_and_new_cases_are_reported(self):
+        """Cases on only one side are listed without failing the gate"""
+        comparison = compare(results(a={"ratio": 2.0}), results(b={"ratio": 1.0}))
+        assert comparison.missing == ["python a"]
+        assert comparison.added == ["python b"]
+        assert comparison.passed
+
+    def test_machine_mismatch_warns(self):
+        """Throughput from another machine is flagged"""
+        current = results(a={"mb_per_s": 1.0})
+        current["machine"]["cpu"] = "other"
+        assert compare(results(a={"mb_per_s": 1.0}), current).warnings
+
+
+@pytest.fixture(scope="module")
+def quick_results():
+    """One quick benchmark run shared by the tests below"""
+    pytest.importorskip("chunker_native")
+    from tests.performance.native import bench_native
+    return bench_native.run(quick=True)
+
+
+class TestNativeBenchmark:
+    """Test the native codec benchmark against the stored baseline"""
+
+    def test_quick_run_covers_suites(self, quick_results):
+        """Every corpus and the thread scaling cases are measured"""
+        cases = quick_results["suites"]["python"]
+        for corpus in ("frames", "telemetry", "random"):
+            assert cases["chunk/%s/chunk=65536" % corpus]["mb_per_s"] > 0
+        assert cases["chunk/random/chunk=65536"]["ratio"] == 1.0
+        assert cases["threads/chunk/frames/threads=1"]["speedup"] == 1.0
+        json.dumps(quick_results)
+
+    def test_no_regression_against_baseline(self, quick_results):
+        """Quick run stays within thresholds of the stored baseline"""
+        if not DEFAULT_BASELINE.exists():
+            pytest.skip("no stored baseline at %s" % DEFAULT_BASELINE)
+        baseline = json.loads(DEFAULT_BASELINE.read_text())
+        comparison = compare(baseline, quick_results)
+        if comparison.warnings:
+            pytest.skip("; ".join(comparison.warnings))
+        assert comparison.passed, "\n".join(str(c) for c in comparison.regressions)
@@ -0,0 +1,6 @@
+"""
+Unit tests for Lucid components.
+
+Kept a package so pytest imports the test modules as tests.unit.*, leaving
+the real blockchain package importable from the repository root.
+"""
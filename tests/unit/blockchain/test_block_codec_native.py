@@ -0,0 +1,169 @@
+"""
+Unit tests for the native block codec.
+
+Blocks hash over a fixed-layout binary header, sizes come from field
+lengths without serializing, and encoded blocks decode back to their fields.
+Runs of blocks are rechecked on a worker pool, stopping at the first bad one.
+"""
+
+import hashlib
+from datetime import datetime, timedelta, timezone
+from types import SimpleNamespace
+
+import pytest
+
+block_codec_native = pytest.importorskip("block_codec_native")
+
+GENESIS_TIME = datetime(2024, 1, 1, 12, 30, 15, 250, tzinfo=timezone.utc)
+
+
+def make_tx(tx_id, data="payload", signature="sig"):
+    """Transaction with the attributes the block manager uses."""
+    return SimpleNamespace(id=tx_id, from_address="alice", to_address="bob", value=2.5,
+                           data=data, timestamp=GENESIS_TIME, signature=signature)
+
+
+def make_block(transactions, timestamp=GENESIS_TIME):
+    """Block whose Merkle root matches its transactions."""
+    return SimpleNamespace(height=7, previous_hash="ab" * 32, timestamp=timestamp,
+                           transactions=transactions, producer="node-1",
+                           merkle_root=block_codec_native.merkle_root(transactions))
+
+
+def make_chain(length):
+    """Linked blocks from genesis with matching hashes."""
+    blocks = []
+    previous_hash = "0" * 64
+    for height in range(length):
+        block = make_block([make_tx(f"h{height}t{i}") for i in range(height % 4)])
+        block.height = height
+        block.previous_hash = previous_hash
+        block.signature = ""
+        block.hash = previous_hash = block_codec_native.block_hash(block)
+        blocks.append(block)
+    return blocks
+
+
+class TestBlockCodec:
+    """Test header hashing, sizing, Merkle roots and round trips."""
+
+    def test_header_layout(self):
+        """The header is fixed fields followed by the producer."""
+        block = make_block([make_tx("t1"), make_tx("t2")])
+        header = block_codec_native.encode_header(block)
+
+        assert len(header) == block_codec_native.HEADER_FIXED_SIZE + 1 + len("node-1")
+        assert header[0] == block_codec_native.FORMAT_VERSION
+        assert int.from_bytes(header[1:9], "little") == 7
+        assert int.from_bytes(header[17:21], "little") == 2
+        assert header[21:53] == bytes.fromhex("ab" * 32)
+
+    def test_block_hash_covers_header_fields(self):
+        """Changing any header field changes the hash."""
+        block = make_block([make_tx("t1")])
+        original = block_codec_native.block_hash(block)
+
+        assert len(original) == 64
+        block.height = 8
+        assert block_codec_native.block_hash(block) != original
+        block.height = 7
+        block.producer = "node-2"
+        assert block_codec_native.block_hash(block) != original
+
+    def test_timestamps_hash_as_utc(self):
+        """Naive, UTC and offset datetimes for one instant hash the same."""
+        naive = make_block([], GENESIS_TIME.replace(tzinfo=None))
+        aware = make_block([], GENESIS_TIME.astimezone(timezone(timedelta(hours=-5))))
+        micros = make_block([], int(GENESIS_TIME.timestamp()) * 1_000_000 + 250)
+
+        expected = block_codec_native.block_hash(make_block([]))
+        assert block_codec_native.block_hash(naive) == expected
+        assert block_codec_native.block_hash(aware) == expected
+        assert block_codec_native.block_hash(micros) == expected
+
+    def test_merkle_root(self):
+        """Hex ids are leaves as is and odd levels repeat the last node."""
+        ids = ["%064x" % i for i in range(3)]
+        leaves = [bytes.fromhex(i) for i in ids]
+        left = hashlib.sha256(leaves[0] + leaves[1]).digest()
+        right = hashlib.sha256(leaves[2] + leaves[2]).digest()
+
+        assert block_codec_native.merkle_root(ids) == hashlib.sha256(left + right).hexdigest()
+        assert block_codec_native.merkle_root([make_tx(i) for i in ids]) == block_codec_native.merkle_root(ids)
+        assert block_codec_native.merkle_root(["t1"]) == hashlib.sha256(b"t1").hexdigest()
+        assert block_codec_native.merkle_root([]) == "0" * 64
+
+    def test_round_trip(self):
+        """Encoded blocks decode to their fields and match block_size."""
+        block = make_block([make_tx("t1"), make_tx("t2", data=None, signature=None)])
+        encoded = block_codec_native.encode_block(block)
+
+        assert block_codec_native.block_size(block) == len(encoded)
+        header, transactions = block_codec_native.decode_block(encoded)
+        assert header == (7, int(GENESIS_TIME.timestamp()) * 1_000_000 + 250, 2,
+                          "ab" * 32, block.merkle_root, "node-1")
+        assert transactions[1] == ("t2", "alice", "bob", 2.5, header[1], "", "")
+
+        with pytest.raises(ValueError):
+            block_codec_native.decode_block(encoded[:-1])
+        with pytest.raises(ValueError):
+            block_codec_native.decode_block(encoded + b"\x00")
+
+    def test_rejects_malformed_hashes(self):
+        """Previous hash and Merkle root must be 64 hex digits."""
+        block = make_block([])
+        block.previous_hash = "xyz"
+        with pytest.raises(ValueError):
+            block_codec_native.block_hash(block)
+
+    def test_matches_python_codec(self):
+        """The native codec and the Python stand-in produce the same bytes."""
+        codec = pytest.importorskip("blockchain.core.block_codec")
+        block = make_block([make_tx(f"tx{i}", data="x" * i) for i in range(50)])
+
+        assert block_codec_native.encode_block(block) == codec._py_encode_block(block)
+        assert block_codec_native.block_hash(block) == codec._py_block_hash(block)
+        assert block_codec_native.merkle_root(block.transactions) == codec._py_merkle_root(block.transactions)
+
+
+class TestChainVerifier:
+    """Test batch rechecking of linked blocks."""
+
+    def test_valid_chain(self):
+        """A linked run passes whole, also when anchored mid-chain."""
+        chain = make_chain(100)
+
+        assert block_codec_native.verify_blocks(chain, threads=4) == (100, None, None)
+        assert block_codec_native.verify_blocks(chain[40:], (39, chain[39].hash)) == (60, None, None)
+
+    def test_reports_first_bad_height(self):
+        """Verification stops at the earliest failing block."""
+        chain = make_chain(100)
+        chain[70].hash = "0" * 64
+        chain[30].transactions = chain[30].transactions[:1]
+
+        assert block_codec_native.verify_blocks(chain, threads=4) == (30, 30, "Merkle root mismatch")
+
+    def test_linkage_across_batches(self):
+        """The anchor from the previous batch must match."""
+        chain = make_chain(20)
+
+        assert block_codec_native.verify_blocks(chain[10:], (9, "f" * 64)) == (0, 10, "Previous hash mismatch")
+        assert block_codec_native.verify_blocks(chain[11:], (9, chain[9].hash)) == (
+            0, 10, "Missing block at height 10")
+
+    def test_producer_signatures(self):
+        """Blocks from producers with known keys need a valid signature."""
+        ed25519 = pytest.importorskip("cryptography.hazmat.primitives.asymmetric.ed25519")
+        from cryptography.hazmat.primitives import serialization
+
+        key = ed25519.Ed25519PrivateKey.generate()
+        public_key = key.public_key().public_bytes(serialization.Encoding.Raw, serialization.PublicFormat.Raw)
+        chain = make_chain(10)
+        for block in chain:
+            block.signature = key.sign(bytes.fromhex(block.hash)).hex()
+        chain[6].signature = chain[5].signature
+
+        assert block_codec_native.verify_blocks(chain, producer_keys={"node-1": public_key}) == (
+            6, 6, "Invalid block signature")
+        assert block_codec_native.verify_blocks(chain, producer_keys={"other": public_key}) == (10, None, None)
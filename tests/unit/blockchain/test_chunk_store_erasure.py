@@ -0,0 +1,149 @@
+"""
+Unit tests for Reed-Solomon erasure coding in the Lucid chunk store client.
+
+Storage nodes are stood in for by local directories (file:// node addresses),
+so shards are really written, lost and rebuilt on disk.
+"""
+
+import importlib.util
+import os
+import random
+import sys
+from pathlib import Path
+
+import pytest
+
+erasure_native = pytest.importorskip("erasure_native")
+pytest_asyncio = pytest.importorskip("pytest_asyncio")
+pytest.importorskip("cryptography")
+pytest.importorskip("aiohttp")
+pytest.importorskip("aiofiles")
+
+# The chain_client package imports every client and their services; load
+# only the chunk store client, which stands on its own
+_spec = importlib.util.spec_from_file_location(
+    "lucid_chunk_store_client",
+    Path(__file__).resolve().parents[3] / "blockchain" / "chain_client" / "lucid_chunk_store_client.py",
+)
+chunk_store = sys.modules[_spec.name] = importlib.util.module_from_spec(_spec)
+_spec.loader.exec_module(chunk_store)
+
+LucidChunkStoreClient = chunk_store.LucidChunkStoreClient
+ChunkStatus = chunk_store.ChunkStatus
+
+
+class TestReedSolomonCodec:
+    """Test the native Reed-Solomon codec."""
+
+    @pytest.mark.parametrize("data_shards,parity_shards", [(8, 3), (4, 2), (1, 1)])
+    def test_decode_from_any_k_shards(self, data_shards, parity_shards):
+        """Any k of the k+m shards recover the payload."""
+        codec = erasure_native.ReedSolomon(data_shards=data_shards, parity_shards=parity_shards)
+        payload = os.urandom(100_003)
+        shards = [bytes(shard) for shard in codec.encode(payload)]
+
+        assert len(shards) == data_shards + parity_shards
+        for _ in range(10):
+            available = list(shards)
+            for i in random.sample(range(len(shards)), parity_shards):
+                available[i] = None
+            assert codec.decode(available, len(payload)) == payload
+
+    def test_reconstruct_rebuilds_missing_shards(self):
+        """Missing data and parity shards are rebuilt bit-exact."""
+        codec = erasure_native.ReedSolomon(data_shards=8, parity_shards=3)
+        shards = [bytes(shard) for shard in codec.encode(os.urandom(65_536))]
+
+        damaged = list(shards)
+        damaged[0] = damaged[5] = damaged[9] = None
+        rebuilt = codec.reconstruct(damaged)
+
+        assert [bytes(shard) for shard in rebuilt] == shards
+
+    def test_too_few_shards(self):
+        """Fewer than k shards is an error."""
+        codec = erasure_native.ReedSolomon(data_shards=4, parity_shards=2)
+        shards = list(codec.encode(b"lucid" * 100))
+        shards[0] = shards[1] = shards[2] = None
+
+        with pytest.raises(ValueError):
+            codec.decode(shards, 500)
+
+
+class TestChunkStoreErasureCoding:
+    """Test erasure-coded storage against local directory nodes."""
+
+    @pytest_asyncio.fixture
+    async def client(self, tmp_path):
+        """Chunk store client with eleven local directory nodes."""
+        client = LucidChunkStoreClient(rpc_url="http://localhost:0", output_dir=str(tmp_path / "store"))
+        for i in range(11):
+            node_dir = tmp_path / f"node_{i:03d}"
+            await client.add_storage_node(f"node_{i:03d}", f"file://{node_dir}", 1_000_000_000)
+        return client
+
+    @pytest.mark.asyncio
+    async def test_store_and_retrieve(self, client):
+        """Chunk round-trips through 8+3 shards."""
+        payload = os.urandom(200_000)
+        assert await client.store_chunk("chunk_ec", "session_1", payload,
+                                        encrypt=False, erasure_coding=True)
+
+        metadata = await client.get_chunk_metadata("chunk_ec")
+        assert metadata.erasure_coded
+        assert len(metadata.storage_paths) == 11
+        assert await client.retrieve_chunk("chunk_ec") == payload
+
+    @pytest.mark.asyncio
+    async def test_repair_moves_only_missing_shards(self, client):
+        """Lost shards are rebuilt and the chunk stays retrievable."""
+        payload = os.urandom(150_000)
+        assert await client.store_chunk("chunk_rep", "session_1", payload,
+                                        encrypt=False, erasure_coding=True)
+        metadata = await client.get_chunk_metadata("chunk_rep")
+
+        for i in (1, 4, 10):
+            os.remove(metadata.storage_paths[i][len("file://"):])
+
+        assert await client.verify_chunk_storage("chunk_rep")
+        assert metadata.status == ChunkStatus.CORRUPTED
+        assert await client.retrieve_chunk("chunk_rep") == payload
+
+        assert await client.repair_chunk("chunk_rep")
+        assert await client.verify_chunk_storage("chunk_rep")
+        assert metadata.status == ChunkStatus.VERIFIED
+
+    @pytest.mark.asyncio
+    async def test_repair_charges_replacement_node(self, client, tmp_path):
+        """A shard rebuilt on a new node takes that node's capacity, not the old one's."""
+        payload = os.urandom(150_000)
+        assert await client.store_chunk("chunk_cap", "session_1", payload,
+                                        encrypt=False, erasure_coding=True)
+        metadata = await client.get_chunk_metadata("chunk_cap")
+        lost_node = client._node_for_path(metadata.storage_paths[3])
+        await client.add_storage_node("node_spare", f"file://{tmp_path / 'node_spare'}", 1_000_000_000)
+        spare = await client.get_storage_node("node_spare")
+        lost_capacity = lost_node.available_capacity
+
+        os.remove(metadata.storage_paths[3][len("file://"):])
+        assert await client.repair_chunk("chunk_cap")
+
+        shard_size = os.path.getsize(metadata.storage_paths[3][len("file://"):])
+        assert client._node_for_path(metadata.storage_paths[3]) is spare
+        assert spare.available_capacity == 1_000_000_000 - shard_size
+        assert lost_node.available_capacity == lost_capacity + shard_size
+
+    @pytest.mark.asyncio
+    async def test_failed_store_removes_stored_shards(self, client, tmp_path):
+        """A shard that cannot be placed rolls back the ones already written."""
+        small = await client.get_storage_node("node_010")
+        small.available_capacity = 10
+        capacities = {node.node_id: node.available_capacity for node in await client.list_storage_nodes()}
+
+        assert not await client.store_chunk("chunk_fail", "session_1", os.urandom(100_000),
+                                            encrypt=False, erasure_coding=True)
+
+        assert not list(tmp_path.glob("node_*/chunks/chunk_fail_*"))
+        for node in await client.list_storage_nodes():
+            assert node.available_capacity == capacities[node.node_id]
+            assert "chunk_fail" not in node.chunks_stored
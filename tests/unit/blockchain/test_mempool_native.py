@@ -0,0 +1,129 @@
+"""
+Unit tests for the native fee-indexed mempool.
+
+The pool evicts by fee rate in O(log n) and builds block templates that
+never take a sender's nonce before its predecessor.
+"""
+
+import asyncio
+import random
+
+import pytest
+
+mempool_native = pytest.importorskip("mempool_native")
+
+
+class TestMempoolIndex:
+    """Test admission, eviction and block template selection."""
+
+    def test_full_pool_evicts_lowest_fee_rate(self):
+        """A better paying transaction displaces the cheapest one."""
+        pool = mempool_native.Mempool(max_size=3)
+        pool.add("a", "alice", 0, 10.0, 100)
+        pool.add("b", "bob", 0, 1.0, 100)
+        pool.add("c", "carol", 0, 5.0, 100)
+
+        assert pool.lowest() == "b"
+        assert pool.add("d", "dave", 0, 2.0, 100) == ["b"]
+        assert "b" not in pool and "d" in pool
+        assert len(pool) == 3
+
+    def test_full_pool_rejects_cheap_transaction(self):
+        """Spam at or below the floor fee rate is turned away untouched."""
+        pool = mempool_native.Mempool(max_size=2)
+        pool.add("a", "alice", 0, 4.0, 100)
+        pool.add("b", "bob", 0, 2.0, 100)
+
+        with pytest.raises(ValueError):
+            pool.add("spam", "mallory", 0, 2.0, 100)
+        assert sorted(pool.select_for_block(10_000)) == ["a", "b"]
+
+    def test_eviction_drops_dependent_nonces(self):
+        """Evicting a nonce also drops the sender's later nonces."""
+        pool = mempool_native.Mempool(max_size=4)
+        pool.add("a0", "alice", 0, 9.0, 100)
+        pool.add("a1", "alice", 1, 1.0, 100)
+        pool.add("a2", "alice", 2, 9.0, 100)
+        pool.add("b0", "bob", 0, 5.0, 100)
+
+        assert sorted(pool.add("c0", "carol", 0, 3.0, 100)) == ["a1", "a2"]
+        assert pool.sender_keys("alice") == ["a0"]
+        assert pool.next_nonce("alice") == 1
+
+    def test_replacement_needs_fee_bump(self):
+        """Same sender and nonce replaces only with a higher fee rate."""
+        pool = mempool_native.Mempool(replace_bump=0.10)
+        pool.add("old", "alice", 7, 10.0, 100)
+
+        with pytest.raises(ValueError):
+            pool.add("cheap", "alice", 7, 10.5, 100)
+        assert pool.add("new", "alice", 7, 12.0, 100) == ["old"]
+        assert pool.sender_keys("alice") == ["new"]
+
+    def test_select_respects_nonce_order(self):
+        """A high fee child waits for its low fee parent."""
+        pool = mempool_native.Mempool()
+        pool.add("a0", "alice", 0, 1.0, 100)
+        pool.add("a1", "alice", 1, 50.0, 100)
+        pool.add("b0", "bob", 0, 10.0, 100)
+        pool.add("c5", "carol", 5, 99.0, 100)
+        pool.add("c7", "carol", 7, 99.0, 100)
+
+        template = pool.select_for_block(10_000)
+
+        assert template.index("a0") < template.index("a1")
+        assert template[0] == "c5"
+        assert "c7" not in template  # Nonce 6 is missing
+
+    def test_select_fills_bytes_limit(self):
+        """Templates stop at max_bytes and max_count."""
+        pool = mempool_native.Mempool()
+        for i in range(100):
+            pool.add(f"tx{i}", f"sender{i}", 0, float(i), 250)
+
+        template = pool.select_for_block(1000)
+        assert template == ["tx99", "tx98", "tx97", "tx96"]
+        assert len(pool.select_for_block(1 << 30, 10)) == 10
+        assert pool.total_bytes == 25_000
+
+    def test_matches_python_index(self):
+        """The native pool and the Python stand-in agree."""
+        mempool = pytest.importorskip("blockchain.core.mempool")
+        native = mempool_native.Mempool(max_size=50)
+        python = mempool._MempoolIndex(max_size=50)
+        rng = random.Random(7)
+
+        for i in range(2000):
+            args = (f"tx{i}", f"s{rng.randrange(20)}", rng.randrange(10),
+                    float(rng.randrange(1000)), rng.randrange(100, 400))
+            results = []
+            for pool in (native, python):
+                try:
+                    results.append(sorted(pool.add(*args)))
+                except ValueError:
+                    results.append(None)
+            assert results[0] == results[1]
+            if i % 10 == 0:
+                key = native.lowest()
+                assert key == python.lowest()
+                native.remove(key)
+                python.remove(key)
+
+        assert native.select_for_block(20_000) == python.select_for_block(20_000)
+        assert native.total_bytes == python.total_bytes
+
+    def test_pool_readd_is_idempotent(self):
+        """Mempool.add keeps accepting a transaction it already holds."""
+        mempool = pytest.importorskip("blockchain.core.mempool")
+        from blockchain.core.transaction import Transaction
+
+        async def run():
+            pool = mempool.Mempool(max_size=1)
+            tx = Transaction(sender="alice", recipient="bob", amount=1, nonce=0, data={"fee": 2.0})
+            assert await pool.add(tx) == []
+            assert await pool.add(tx) == []
+            with pytest.raises(ValueError):
+                await pool.add(Transaction(sender="carol", recipient="bob", amount=1, nonce=0))
+            assert await pool.size() == 1
+
+        asyncio.run(run())
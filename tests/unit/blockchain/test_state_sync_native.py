@@ -0,0 +1,236 @@
+"""
+Unit tests for the native operator state digest and reconciliation.
+
+The digest keeps a count and a hash sum for every subtree of the sorted
+key space, so range fingerprints are cheap and writes update it in place;
+the root commits to the state through a Merkle hash over the same tree.
+Two operators exchange range fingerprints until only the differing keys
+remain, and a lagging operator then fetches just those keys.
+"""
+
+import hashlib
+import multiprocessing
+import random
+
+import pytest
+
+state_sync_native = pytest.importorskip("state_sync_native")
+
+
+def make_state(seed, n):
+    """Deterministic operator state of n keys."""
+    rng = random.Random(seed)
+    return {b"key/%08d" % rng.randrange(10 ** 8): b"value-%d" % i for i in range(n)}
+
+
+def build_digest(state):
+    """Digest over every entry of a state dict."""
+    digest = state_sync_native.StateDigest()
+    for key, value in state.items():
+        digest.put(key, value)
+    return digest
+
+
+def merkle_root(state):
+    """Root as specified: a Merkle hash over the treap with key-derived priorities."""
+    def priority(key):
+        return int.from_bytes(hashlib.sha256(key).digest()[:8], "little")
+
+    def subtree(keys):
+        if not keys:
+            return bytes(32)
+        # Highest priority on top; a tie goes to the smaller key
+        top = max(range(len(keys)), key=lambda i: (priority(keys[i]), -i))
+        key = keys[top]
+        entry = hashlib.sha256(len(key).to_bytes(4, "little") + key + state[key]).digest()
+        return hashlib.sha256(subtree(keys[:top]) + entry + subtree(keys[top + 1:])).digest()
+
+    return hashlib.sha256(len(state).to_bytes(8, "little") + subtree(sorted(state))).digest()
+
+
+def diverge(state, rng, d):
+    """Copy of state with d random changes, insertions and deletions."""
+    other = dict(state)
+    keys = sorted(state)
+    for i in range(d):
+        kind = i % 3 if keys else 1
+        if kind == 0:
+            other[rng.choice(keys)] = b"changed-%d" % i
+        elif kind == 1:
+            other[b"new/%08d" % rng.randrange(10 ** 8)] = b"added"
+        else:
+            other.pop(rng.choice(keys), None)
+    return other
+
+
+def run_session(local, remote):
+    """Reconcile in-process; returns local's (missing, extra, changed) and message count."""
+    found = (set(), set(), set())
+    message = local.initiate()
+    sides = [remote, local]
+    messages = 1
+    turn = 0
+    while message:
+        side = sides[turn % 2]
+        message, missing, extra, changed = side.reconcile(message)
+        if side is local:
+            for bucket, keys in zip(found, (missing, extra, changed)):
+                bucket.update(keys)
+        messages += message is not None
+        turn += 1
+    return found, messages
+
+
+def serve_authoritative(conn, seed, n):
+    """Child process: the up-to-date operator, answering reconcile and fetch requests."""
+    state = diverge(make_state(seed, n), random.Random(seed + 1), 60)
+    digest = build_digest(state)
+    while True:
+        request, arg = conn.recv()
+        if request == "reconcile":
+            conn.send(digest.reconcile(arg)[0])
+        elif request == "fetch":
+            conn.send({key: state[key] for key in arg})
+        elif request == "root":
+            conn.send(digest.root)
+        else:
+            conn.close()
+            return
+
+
+class TestStateDigest:
+    """Test the incrementally maintained digest."""
+
+    def test_root_is_order_independent(self):
+        """The same entries give the same root whatever the write order."""
+        state = make_state(1, 2000)
+        items = list(state.items())
+        random.Random(2).shuffle(items)
+        digest = state_sync_native.StateDigest()
+        for key, value in items:
+            digest.put(key, value)
+        assert digest.root == build_digest(state).root
+        assert len(digest) == len(state)
+
+    def test_incremental_updates_match_rebuild(self):
+        """Puts and deletes leave the digest equal to one built from scratch."""
+        state = make_state(3, 1000)
+        digest = build_digest(state)
+        rng = random.Random(4)
+        for key in rng.sample(sorted(state), 100):
+            assert digest.delete(key)
+            del state[key]
+        for key in rng.sample(sorted(state), 100):
+            state[key] = b"rewritten"
+            assert digest.put(key, b"rewritten")
+        assert not digest.put(key, b"rewritten")
+        assert not digest.delete(b"absent")
+        assert digest.root == build_digest(state).root
+
+    def test_root_is_merkle_commitment(self):
+        """The root hashes the tree, not the additive sums the fingerprints use."""
+        assert state_sync_native.StateDigest().root == merkle_root({})
+        state = make_state(5, 300)
+        digest = build_digest(state)
+        assert digest.root == merkle_root(state)
+        for key in sorted(state)[::7]:
+            digest.delete(key)
+            del state[key]
+        assert digest.root == merkle_root(state)
+
+    def test_entries_and_ranges(self):
+        """Entry hashes, membership, range counts and key listings."""
+        digest = build_digest({b"a": b"1", b"b": b"2", b"c": b"3"})
+        assert digest.get(b"b") == state_sync_native.entry_hash(b"b", b"2")
+        assert digest.get(b"z") is None
+        assert b"a" in digest and b"z" not in digest
+        assert digest.fingerprint(b"b")[0] == 2
+        assert digest.fingerprint(b"a", b"c")[0] == 2
+        assert digest.fingerprint(b"c", b"a")[0] == 0
+        assert digest.keys(b"b") == [b"b", b"c"]
+        assert digest.fingerprint(b"a", b"b") == build_digest({b"a": b"1"}).fingerprint()
+
+
+class TestReconcile:
+    """Test range reconciliation between two digests."""
+
+    @pytest.mark.parametrize("n, d", [(0, 3), (40, 5), (5000, 0), (5000, 1), (5000, 200)])
+    def test_finds_exact_differences(self, n, d):
+        """Missing, extra and changed keys match the true difference."""
+        local_state = make_state(5, n)
+        remote_state = diverge(local_state, random.Random(6), d)
+        (missing, extra, changed), _ = run_session(build_digest(local_state), build_digest(remote_state))
+        assert missing == set(remote_state) - set(local_state)
+        assert extra == set(local_state) - set(remote_state)
+        assert changed == {k for k in set(local_state) & set(remote_state) if local_state[k] != remote_state[k]}
+
+    def test_identical_states_take_one_message(self):
+        """Matching fingerprints end the session without a reply."""
+        digest = build_digest(make_state(7, 5000))
+        reply, missing, extra, changed = build_digest(make_state(7, 5000)).reconcile(digest.initiate())
+        assert reply is None
+        assert missing == extra == changed == []
+
+    def test_traffic_scales_with_differences(self):
+        """A few differences in a large state cost a small fraction of the state."""
+        state = make_state(8, 50000)
+        local = build_digest(state)
+        remote = build_digest(diverge(state, random.Random(9), 5))
+        _, messages = run_session(local, remote)
+        assert messages <= 12
+        sent = local.stats["bytes_out"] + remote.stats["bytes_out"]
+        assert sent < sum(len(k) + len(v) for k, v in state.items()) // 20
+
+    def test_malformed_messages(self):
+        """Truncated or out-of-order messages are rejected."""
+        digest = build_digest(make_state(10, 100))
+        for message in (b"\x09", b"\x01\x01\x01\xff\xff\xff\xff", b"\x01\x00\x00\x00\x00\x00\x01"):
+            with pytest.raises(ValueError):
+                digest.reconcile(message)
+        assert digest.reconcile(b"") == (None, [], [], [])
+
+
+class TestTwoProcessResync:
+    """Two-process harness: a lagging operator pulls from an authoritative one."""
+
+    def test_lagging_operator_catches_up(self):
+        """Only the differing keys cross the pipe and the roots converge."""
+        seed, n = 11, 20000
+        context = multiprocessing.get_context("fork")
+        parent, child = context.Pipe()
+        server = context.Process(target=serve_authoritative, args=(child, seed, n))
+        server.start()
+        try:
+            state = make_state(seed, n)
+            digest = build_digest(state)
+            missing, extra, changed = [], [], []
+
+            message = digest.initiate()
+            round_trips = 0
+            while message:
+                parent.send(("reconcile", message))
+                reply = parent.recv()
+                round_trips += 1
+                if reply is None:
+                    break
+                message, m, e, c = digest.reconcile(reply)
+                missing += m
+                extra += e
+                changed += c
+
+            parent.send(("fetch", missing + changed))
+            fetched = parent.recv()
+            for key, value in fetched.items():
+                state[key] = value
+                digest.put(key, value)
+            for key in extra:
+                del state[key]
+                digest.delete(key)
+
+            parent.send(("root", None))
+            assert digest.root == parent.recv()
+            assert 0 < len(fetched) + len(extra) <= 60
+            assert round_trips <= 8
+        finally:
+            parent.send(("stop", None))
+            server.join(timeout=10)
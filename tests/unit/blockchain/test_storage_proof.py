@@ -0,0 +1,75 @@
+"""
+Unit tests for the native proof-of-storage challenge engine.
+
+Verifiers keep only a Merkle root per stored object and check random block
+challenges against it instead of reading whole chunks back.
+"""
+
+import os
+
+import pytest
+
+storage_proof_native = pytest.importorskip("storage_proof_native")
+
+BLOCK_SIZE = 4096
+
+
+def answer_challenge(tree, data, indices):
+    """Answer a challenge the way a storage holder does."""
+    blocks = [data[i * BLOCK_SIZE:(i + 1) * BLOCK_SIZE] for i in indices]
+    return tree.prove(indices, blocks)
+
+
+class TestStorageProof:
+    """Test challenge generation, proofs and verification."""
+
+    @pytest.mark.parametrize("size", [0, 1, BLOCK_SIZE, BLOCK_SIZE + 1, 1_000_003])
+    def test_honest_holder_passes(self, size):
+        """Proofs from the original data verify against the root."""
+        data = os.urandom(size)
+        tree = storage_proof_native.StorageTree(data, BLOCK_SIZE)
+        indices = storage_proof_native.challenge_indices(os.urandom(16), tree.block_count, 16)
+
+        proof = answer_challenge(tree, data, indices)
+
+        assert storage_proof_native.verify_proof(tree.root, size, BLOCK_SIZE, indices, proof)
+
+    def test_holder_tree_round_trip(self):
+        """A holder can persist its tree and answer later."""
+        data = os.urandom(64 * BLOCK_SIZE)
+        tree = storage_proof_native.StorageTree(data, BLOCK_SIZE)
+        restored = storage_proof_native.load_tree(tree.to_bytes())
+
+        assert restored.root == tree.root
+        assert restored.block_count == 64
+        indices = [0, 17, 63]
+        proof = answer_challenge(restored, data, indices)
+        assert storage_proof_native.verify_proof(tree.root, len(data), BLOCK_SIZE, indices, proof)
+
+    def test_corrupted_block_fails(self):
+        """A holder that lost data cannot answer for the damaged block."""
+        data = os.urandom(32 * BLOCK_SIZE)
+        tree = storage_proof_native.StorageTree(data, BLOCK_SIZE)
+        damaged = bytearray(data)
+        damaged[5 * BLOCK_SIZE + 7] ^= 0xFF
+
+        proof = answer_challenge(tree, bytes(damaged), [5])
+
+        assert not storage_proof_native.verify_proof(tree.root, len(data), BLOCK_SIZE, [5], proof)
+
+    def test_proof_for_other_indices_fails(self):
+        """A response must answer exactly the challenged indices."""
+        data = os.urandom(32 * BLOCK_SIZE)
+        tree = storage_proof_native.StorageTree(data, BLOCK_SIZE)
+
+        proof = answer_challenge(tree, data, [1, 2])
+
+        assert not storage_proof_native.verify_proof(tree.root, len(data), BLOCK_SIZE, [1, 3], proof)
+
+    def test_challenges_are_deterministic(self):
+        """Both sides derive the same indices from a seed."""
+        seed = b"lucid-audit-seed"
+        first = storage_proof_native.challenge_indices(seed, 1000, 32)
+
+        assert first == storage_proof_native.challenge_indices(seed, 1000, 32)
+        assert all(0 <= i < 1000 for i in first)
@@ -0,0 +1,146 @@
+"""
+Unit tests for the native batch transaction validator.
+
+Signatures are verified across threads and nonces and balances are checked
+against an in-memory snapshot, with a sender's transactions in a batch
+spending from one running balance.
+"""
+
+import os
+
+import pytest
+
+tx_validator_native = pytest.importorskip("tx_validator_native")
+
+# RFC 8032 section 7.1, test 2
+RFC_PUBLIC_KEY = bytes.fromhex("3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c")
+RFC_SIGNATURE = bytes.fromhex(
+    "92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223ebdb69da"
+    "085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00d291612bb0c00"
+)
+RFC_MESSAGE = b"\x72"
+
+
+def unsigned(sender, nonce, cost):
+    """Batch entry whose signature was checked by the caller."""
+    return (sender, nonce, cost, None, None, None)
+
+
+class TestBatchValidator:
+    """Test signature verdicts and snapshot state checks."""
+
+    def test_rfc8032_vector(self):
+        """The known-answer signature verifies and a changed message does not."""
+        assert tx_validator_native.verify_ed25519(RFC_PUBLIC_KEY, RFC_SIGNATURE, RFC_MESSAGE)
+        assert not tx_validator_native.verify_ed25519(RFC_PUBLIC_KEY, RFC_SIGNATURE, b"\x73")
+
+    def test_signed_batch(self):
+        """Every signature in a large batch is checked."""
+        ed25519 = pytest.importorskip("cryptography.hazmat.primitives.asymmetric.ed25519")
+        from cryptography.hazmat.primitives import serialization
+
+        snapshot = tx_validator_native.StateSnapshot()
+        batch = []
+        for i in range(500):
+            key = ed25519.Ed25519PrivateKey.generate()
+            public_key = key.public_key().public_bytes(serialization.Encoding.Raw, serialization.PublicFormat.Raw)
+            message = os.urandom(100)
+            snapshot.update(f"sender{i}", 10.0, 0)
+            batch.append((f"sender{i}", 0, 1.0, public_key, key.sign(message), message))
+
+        tampered = list(batch[7])
+        tampered[5] = b"x" + tampered[5][1:]
+        batch[7] = tuple(tampered)
+
+        verdicts = tx_validator_native.validate_batch(batch, snapshot, threads=4)
+
+        assert len(verdicts) == 500
+        assert verdicts[7] == tx_validator_native.VERDICT_BAD_SIGNATURE
+        assert verdicts.count(tx_validator_native.VERDICT_OK) == 499
+
+    def test_running_balance_and_nonce(self):
+        """Later transactions of a sender see earlier ones in the batch."""
+        snapshot = tx_validator_native.StateSnapshot()
+        snapshot.load([("alice", 10.0, 3), ("bob", 1.0, 0)])
+
+        verdicts = tx_validator_native.validate_batch([
+            unsigned("alice", 3, 4.0),
+            unsigned("alice", 4, 4.0),
+            unsigned("alice", 5, 4.0),    # Only 2.0 left
+            unsigned("alice", 7, 1.0),    # Expected nonce 5
+            unsigned("bob", None, 1.0),
+            unsigned("carol", 0, 1.0),
+        ], snapshot)
+
+        assert list(verdicts) == [
+            tx_validator_native.VERDICT_OK,
+            tx_validator_native.VERDICT_OK,
+            tx_validator_native.VERDICT_INSUFFICIENT_BALANCE,
+            tx_validator_native.VERDICT_BAD_NONCE,
+            tx_validator_native.VERDICT_OK,
+            tx_validator_native.VERDICT_UNKNOWN_SENDER,
+        ]
+
+    def test_batches_start_from_snapshot(self):
+        """A batch does not change the snapshot the next one sees."""
+        snapshot = tx_validator_native.StateSnapshot()
+        snapshot.update("alice", 5.0, 0)
+
+        for _ in range(3):
+            verdicts = tx_validator_native.validate_batch([unsigned("alice", 0, 5.0)], snapshot)
+            assert verdicts[0] == tx_validator_native.VERDICT_OK
+        assert snapshot.get("alice") == (5.0, 0)
+
+    def test_malformed_signature_lengths(self):
+        """Short keys or signatures are rejected without verifying."""
+        snapshot = tx_validator_native.StateSnapshot()
+        snapshot.update("alice", 1.0, 0)
+
+        verdicts = tx_validator_native.validate_batch([
+            ("alice", 0, 0.0, RFC_PUBLIC_KEY[:31], RFC_SIGNATURE, RFC_MESSAGE),
+            ("alice", 0, 0.0, RFC_PUBLIC_KEY, RFC_SIGNATURE[:63], RFC_MESSAGE),
+            ("alice", 0, 0.0, RFC_PUBLIC_KEY, RFC_SIGNATURE, RFC_MESSAGE),
+        ], snapshot)
+
+        assert list(verdicts) == [
+            tx_validator_native.VERDICT_BAD_SIGNATURE,
+            tx_validator_native.VERDICT_BAD_SIGNATURE,
+            tx_validator_native.VERDICT_OK,
+        ]
+
+    def test_transaction_documents_keep_signing_fields(self):
+        """Stored transactions still reach the Ed25519 batch path when reloaded."""
+        models = pytest.importorskip("blockchain.core.models")
+
+        tx = models.Transaction(
+            id="tx1", from_address="0x" + "1" * 40, to_address="0x" + "2" * 40, value=1.0,
+            signature=RFC_SIGNATURE.hex(), fee=0.01, nonce=4, public_key=RFC_PUBLIC_KEY.hex()
+        )
+        restored = models.Transaction.from_dict(tx.to_dict())
+
+        assert restored == tx
+        assert restored.public_key is not None
+
+    def test_pending_transactions_extend_snapshot(self):
+        """Nonces queue behind pending ones and pending spends count against the balance."""
+        mempool = pytest.importorskip("blockchain.core.mempool")
+
+        snapshot = tx_validator_native.StateSnapshot()
+        index = mempool.create_mempool_index()
+        pending = []
+
+        def submit(nonce, cost):
+            # Each submission refreshes the snapshot like TransactionProcessor does
+            accounts = mempool.overlay_pending({"alice": (10.0, 0)}, index, pending)
+            snapshot.clear()
+            snapshot.load((address, balance, next_nonce) for address, (balance, next_nonce) in accounts.items())
+            verdict = tx_validator_native.validate_batch([unsigned("alice", nonce, cost)], snapshot)[0]
+            if verdict == tx_validator_native.VERDICT_OK:
+                index.add(f"tx{nonce}", "alice", nonce, 1.0, 100)
+                pending.append(("alice", cost))
+            return verdict
+
+        assert submit(0, 4.0) == tx_validator_native.VERDICT_OK
+        assert submit(1, 4.0) == tx_validator_native.VERDICT_OK
+        assert submit(1, 1.0) == tx_validator_native.VERDICT_BAD_NONCE
+        assert submit(2, 4.0) == tx_validator_native.VERDICT_INSUFFICIENT_BALANCE
@@ -0,0 +1,95 @@
+"""
+Unit tests for the native VRF extension.
+
+Proofs follow ECVRF-EDWARDS25519-SHA512-TAI from RFC 9381, and candidate
+tables turn a VRF output into the same weighted leader draw on every peer.
+"""
+
+import os
+
+import pytest
+
+vrf_native = pytest.importorskip("vrf_native")
+
+# RFC 9381 appendix B.3, example 16
+RFC_SECRET_KEY = bytes.fromhex("9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60")
+RFC_PUBLIC_KEY = bytes.fromhex("d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a")
+RFC_PROOF = bytes.fromhex(
+    "8657106690b5526245a92b003bb079ccd1a92130477671f6fc01ad16f26f723f"
+    "26f8a57ccaed74ee1b190bed1f479d9727d2d0f9b005a6e456a35d4fb0daab12"
+    "68a1b0db10836d9826a528ca76567805"
+)
+RFC_OUTPUT = bytes.fromhex(
+    "90cf1df3b703cce59e2a35b925d411164068269d7b2d29f3301c03dd757876ff"
+    "66b71dda49d2de59d03450451af026798e8f81cd2e333de5cdf4f3e140fdd8ae"
+)
+
+
+class TestECVRF:
+    """Test proving, verifying and output derivation."""
+
+    def test_rfc9381_vector(self):
+        """The known-answer key, proof and output are reproduced."""
+        assert vrf_native.public_key(RFC_SECRET_KEY) == RFC_PUBLIC_KEY
+        assert vrf_native.prove(RFC_SECRET_KEY, b"") == RFC_PROOF
+        assert vrf_native.proof_to_hash(RFC_PROOF) == RFC_OUTPUT
+        assert vrf_native.verify(RFC_PUBLIC_KEY, RFC_PROOF, b"") == RFC_OUTPUT
+
+    def test_rejects_tampering(self):
+        """Changed proofs, inputs, keys and small-order keys do not verify."""
+        secret_key = os.urandom(32)
+        public_key = vrf_native.public_key(secret_key)
+        proof = vrf_native.prove(secret_key, b"slot 7")
+
+        assert vrf_native.verify(public_key, proof, b"slot 7") == vrf_native.proof_to_hash(proof)
+        assert vrf_native.verify(public_key, proof, b"slot 8") is None
+        assert vrf_native.verify(RFC_PUBLIC_KEY, proof, b"slot 7") is None
+        assert vrf_native.verify(bytes([1]) + bytes(31), proof, b"slot 7") is None
+        assert vrf_native.verify(public_key, proof[:79], b"slot 7") is None
+        for i in (0, 40, 79):
+            tampered = bytearray(proof)
+            tampered[i] ^= 0x01
+            assert vrf_native.verify(public_key, bytes(tampered), b"slot 7") is None
+
+        with pytest.raises(ValueError):
+            vrf_native.prove(secret_key[:31], b"slot 7")
+
+
+class TestCandidateTable:
+    """Test weighted draws and exclusion."""
+
+    def test_draws_follow_weights(self):
+        """Pick frequencies track candidate weights."""
+        table = vrf_native.CandidateTable([("a", 1.0), ("b", 2.0), ("c", 7.0)])
+        counts = {"a": 0, "b": 0, "c": 0}
+        for i in range(20000):
+            counts[table.pick(i.to_bytes(8, "little"))] += 1
+
+        assert 1600 < counts["a"] < 2400
+        assert 3400 < counts["b"] < 4600
+        assert 13300 < counts["c"] < 14700
+
+    def test_order_independent(self):
+        """Tables built from the same candidates in any order draw the same leaders."""
+        candidates = [(f"node{i}", 1.0 + i % 5) for i in range(50)]
+        forward = vrf_native.CandidateTable(candidates)
+        backward = vrf_native.CandidateTable(candidates[::-1])
+
+        for i in range(100):
+            beta = os.urandom(64)
+            assert forward.select(beta, count=6) == backward.select(beta, count=6)
+            assert forward.select(beta)[0] == forward.pick(beta)
+
+    def test_select_excludes(self):
+        """Selections are distinct, skip excluded ids and stop when candidates run out."""
+        table = vrf_native.CandidateTable([("a", 1.0), ("b", 1.0), ("c", 1e-6), ("d", 1.0)])
+
+        leaders = table.select(os.urandom(64), count=6, exclude={"a", "missing"})
+        assert sorted(leaders) == ["b", "c", "d"]
+        assert table.select(os.urandom(64), count=2, exclude=["a", "b", "c", "d"]) == []
+
+    def test_invalid_candidates(self):
+        """Empty tables, duplicates and non-positive weights are rejected."""
+        for candidates in ([], [("a", 1.0), ("a", 2.0)], [("a", 0.0)], [("a", float("inf"))]):
+            with pytest.raises(ValueError):
+                vrf_native.CandidateTable(candidates)
@@ -0,0 +1,87 @@
+"""
+Unit tests for the native work credits aggregator.
+
+Proofs are added to per-entity day buckets, whole days expire as the
+window slides and entities stay ranked by live score without a rescan.
+"""
+
+import pytest
+
+work_credits_native = pytest.importorskip("work_credits_native")
+
+DAY = 86400
+START = 1000 * DAY
+
+
+def aggregator(**kwargs):
+    """Aggregator at the default 7-day window that starts on a fixed day."""
+    agg = work_credits_native.WorkAggregator(**kwargs)
+    agg.advance(START)
+    return agg
+
+
+class TestWorkAggregator:
+    """Test window expiry, scoring and ranking."""
+
+    def test_scores_match_formula(self):
+        """Live score is credits scaled by the uptime share of the window."""
+        agg = aggregator()
+        agg.add("node", START, relay=10, storage=4, validation=5, uptime=7 * DAY // 2)
+
+        relay, storage, validation, uptime, uptime_score, live_score = agg.get("node")
+        assert (relay, storage, validation, uptime) == (10, 4, 5, 7 * DAY // 2)
+        assert uptime_score == 0.5
+        assert live_score == 19 * 0.5
+        assert agg.rank("node") == 1
+
+    def test_minimum_uptime_and_credits(self):
+        """Entities below the uptime threshold or without credits are not ranked."""
+        agg = aggregator()
+        agg.add("idle", START, uptime=7 * DAY)
+        agg.add("flaky", START, relay=100, uptime=DAY)
+        agg.add("steady", START, relay=1, uptime=2 * DAY)
+
+        assert len(agg) == 3
+        assert agg.ranked == 1
+        assert agg.rank("idle") is None
+        assert agg.rank("flaky") is None
+        assert agg.top() == [("steady", 1, pytest.approx(2 / 7))]
+
+    def test_window_expiry(self):
+        """Buckets leave the window a day at a time and empty entities are dropped."""
+        agg = aggregator()
+        agg.add("old", START, relay=5, uptime=7 * DAY)
+        agg.add("new", START + 3 * DAY, relay=1, uptime=7 * DAY)
+        agg.add("new", START + 3 * DAY + 60, relay=1)
+
+        assert agg.rank("old") == 1
+        assert agg.advance(START + 6 * DAY) == 0
+        assert agg.advance(START + 7 * DAY) == 1
+        assert agg.get("old") is None
+        assert agg.rank("new") == 1
+        assert not agg.add("late", START + DAY - 1, relay=1)
+        assert agg.advance(START + 30 * DAY) == 1
+        assert len(agg) == 0
+
+    def test_ranking_order(self):
+        """Ranks follow live score with ties broken by entity id."""
+        agg = aggregator()
+        for i in range(200):
+            agg.add(f"n{i:03d}", START + i, relay=i % 20 + 1, uptime=7 * DAY)
+
+        snapshot = agg.snapshot()
+        expected = sorted(snapshot, key=lambda entry: (-entry[6], entry[0]))
+        assert snapshot == expected
+        for rank, entry in enumerate(snapshot, 1):
+            assert agg.rank(entry[0]) == rank
+        assert [entry[0] for entry in agg.top(3)] == [entry[0] for entry in snapshot[:3]]
+
+    def test_invalid_input(self):
+        """Negative amounts and bad parameters are rejected."""
+        agg = aggregator()
+        with pytest.raises(ValueError):
+            agg.add("node", START, relay=-1)
+        with pytest.raises(ValueError):
+            agg.add("node", float("nan"))
+        with pytest.raises(ValueError):
+            work_credits_native.WorkAggregator(window_days=0)
@@ -0,0 +1,7 @@
+"""
+Unit tests for RDP components.
+
+Tests the session host and recorder building blocks.
+"""
+
+__version__ = "0.1.0"
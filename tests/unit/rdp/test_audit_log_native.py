@@ -0,0 +1,143 @@
+"""
+Unit tests for the native session audit log.
+
+Records are chained by SHA-256, written a batch at a time with one fsync,
+and read back through a memory-mapped range index.
+"""
+
+import errno
+import hashlib
+import os
+
+import pytest
+
+audit_log_native = pytest.importorskip("audit_log_native")
+
+HEADER_SIZE = audit_log_native.HEADER_SIZE
+
+
+@pytest.fixture
+def log_path(tmp_path):
+    """Path of a fresh audit log file."""
+    return str(tmp_path / "audit.log")
+
+
+def write_records(path, batches):
+    """Append each batch and return every record hash in order."""
+    writer = audit_log_native.AuditLogWriter(path, sync=False)
+    hashes = []
+    for batch in batches:
+        hashes += writer.append(batch)
+    writer.close()
+    return hashes
+
+
+class TestAuditLogWriter:
+    """Test chained appends."""
+
+    def test_chain_layout(self, log_path):
+        """Each record hash covers its header prefix and body, and links to the one before."""
+        hashes = write_records(log_path, [[(10, 1, "s1", b"a"), (20, 2, "s1", b"bc")], [(30, 3, "s2", b"")]])
+        data = open(log_path, "rb").read()
+
+        offset, prev = 0, bytes(32)
+        for record_hash in hashes:
+            session_len = int.from_bytes(data[offset + 32:offset + 34], "little")
+            payload_len = int.from_bytes(data[offset + 36:offset + 40], "little")
+            end = offset + HEADER_SIZE + session_len + payload_len
+
+            assert data[offset + 40:offset + 72] == prev
+            assert hashlib.sha256(data[offset:offset + 72] + data[offset + HEADER_SIZE:end]).hexdigest() == record_hash
+            offset, prev = end, bytes.fromhex(record_hash)
+        assert offset == len(data)
+
+    def test_reopen_continues_chain(self, log_path):
+        """A reopened writer picks up the sequence and hash of the last record."""
+        hashes = write_records(log_path, [[(i, 1, "s1", b"x") for i in range(5)]])
+
+        writer = audit_log_native.AuditLogWriter(log_path)
+        assert writer.sequence == 5
+        assert writer.last_hash == hashes[-1]
+        writer.append([(99, 1, "s1", b"y")])
+        writer.close()
+
+        assert audit_log_native.AuditLogReader(log_path).verify() is None
+
+    def test_torn_tail_is_cut(self, log_path):
+        """A partial record left by a crash is dropped on reopen."""
+        write_records(log_path, [[(i, 1, "s1", b"payload") for i in range(3)]])
+        with open(log_path, "r+b") as f:
+            f.truncate(os.path.getsize(log_path) - 4)
+
+        writer = audit_log_native.AuditLogWriter(log_path)
+        assert writer.sequence == 2
+        writer.close()
+
+    def test_zero_filled_tail_is_cut(self, log_path):
+        """Zeros left where the file grew before a crash are dropped on reopen."""
+        write_records(log_path, [[(i, 1, "s1", b"payload") for i in range(3)]])
+        with open(log_path, "ab") as f:
+            f.write(bytes(4096))
+
+        writer = audit_log_native.AuditLogWriter(log_path)
+        assert writer.sequence == 3
+        writer.close()
+        assert audit_log_native.AuditLogReader(log_path).verify() is None
+
+    def test_unparseable_tail_fails_open(self, log_path):
+        """Bytes that are not an interrupted append are reported, not overwritten."""
+        write_records(log_path, [[(i, 1, "s1", b"payload") for i in range(3)]])
+        with open(log_path, "ab") as f:
+            f.write(b"\x01" * 200)
+        size = os.path.getsize(log_path)
+
+        with pytest.raises(OSError) as excinfo:
+            audit_log_native.AuditLogWriter(log_path)
+        assert excinfo.value.errno == errno.EBADMSG
+        assert os.path.getsize(log_path) == size
+
+    def test_rejects_bad_records(self, log_path):
+        """Malformed records fail the whole batch and leave the log untouched."""
+        writer = audit_log_native.AuditLogWriter(log_path, sync=False)
+
+        with pytest.raises(TypeError):
+            writer.append([(1, 1, "s1", b"ok"), (2, 1, b"s1", b"bad")])
+        with pytest.raises(ValueError):
+            writer.append([(1, 1 << 16, "s1", b"")])
+
+        assert writer.sequence == 0
+        assert writer.size == 0
+        writer.close()
+        with pytest.raises(ValueError):
+            writer.append([(1, 1, "s1", b"")])
+
+
+class TestAuditLogReader:
+    """Test range queries and verification."""
+
+    def test_range_by_time_and_session(self, log_path):
+        """Ranges are inclusive and can be narrowed to one session."""
+        write_records(log_path, [[(t, 1, "s1" if t % 2 else "s2", str(t).encode()) for t in range(100)]])
+        reader = audit_log_native.AuditLogReader(log_path)
+
+        assert len(reader) == 100
+        assert [r[1] for r in reader.range(10, 20)] == list(range(10, 21))
+        assert [r[4] for r in reader.range(10, 20, "s1")] == [str(t).encode() for t in range(11, 21, 2)]
+        assert reader.range(start_us=200) == []
+
+    def test_timestamps_never_decrease(self, log_path):
+        """Out-of-order timestamps are raised to keep the file sorted."""
+        write_records(log_path, [[(50, 1, "s1", b""), (40, 1, "s1", b"")], [(30, 1, "s1", b"")]])
+
+        records = audit_log_native.AuditLogReader(log_path).range()
+        assert [(r[0], r[1]) for r in records] == [(0, 50), (1, 50), (2, 50)]
+
+    def test_verify_detects_tampering(self, log_path):
+        """Flipping a payload byte breaks the chain at that record."""
+        write_records(log_path, [[(i, 1, "s1", b"payload") for i in range(4)]])
+        record_size = HEADER_SIZE + 2 + 7
+        data = bytearray(open(log_path, "rb").read())
+        data[2 * record_size + HEADER_SIZE + 3] ^= 0x01
+        open(log_path, "wb").write(data)
+
+        assert audit_log_native.AuditLogReader(log_path).verify() == 2
@@ -0,0 +1,524 @@
+"""
+Unit tests for adaptive compression in the native chunker.
+
+A sampled byte histogram and 4-byte repeat probe place each block in a
+store, fast, low or high tier; a controller steps the high-tier level
+against a throughput target. Compress, decompress and hash calls are
+timed into per-thread histograms that snapshot() and prometheus() fold.
+chunk_async() runs the same work on a native pool and resolves an asyncio
+future when the loop sees the pool's eventfd. The module uses multi-phase
+init with heap types and per-module state, so each interpreter or fresh
+module instance gets its own types and pool. Output buffers come from a
+process-wide pool of reused mappings and pooled=True hands them to Python
+as PooledBuffer objects without a copy. Large buffers can be deflated
+pigz-style across threads into one standard zlib or gzip stream.
+"""
+
+import asyncio
+import gzip
+import hashlib
+import importlib.util
+import os
+import threading
+import zlib
+
+import pytest
+
+chunker_native = pytest.importorskip("chunker_native")
+
+TEXT = b"".join(
+    b'{"ts":%d,"key":"%s","window":"editor"}\n' % (i, bytes([97 + i % 26]))
+    for i in range(20000)
+)
+
+
+class TestEstimator:
+    """Test the compressibility estimate."""
+
+    def test_random_data_is_stored(self):
+        """Random bytes, like ciphertext, read as 8 bits per byte."""
+        entropy, match_ratio, tier = chunker_native.estimate_compressibility(os.urandom(1 << 20))
+        assert entropy > 7.9
+        assert match_ratio < 0.01
+        assert tier == chunker_native.TIER_STORE
+
+    def test_short_random_block_is_stored(self):
+        """The small-sample correction keeps short ciphertext out of the compressors."""
+        _, _, tier = chunker_native.estimate_compressibility(os.urandom(600))
+        assert tier == chunker_native.TIER_STORE
+
+    def test_text_gets_high_tier(self):
+        """Low-entropy, repetitive input is worth the expensive level."""
+        entropy, match_ratio, tier = chunker_native.estimate_compressibility(TEXT)
+        assert entropy < 5.5
+        assert match_ratio > 0.5
+        assert tier == chunker_native.TIER_HIGH
+
+    def test_repeated_random_block_is_not_stored(self):
+        """Long repeats compress even when the byte histogram is flat."""
+        _, match_ratio, tier = chunker_native.estimate_compressibility(os.urandom(2000) * 500)
+        assert match_ratio > 0.25
+        assert tier != chunker_native.TIER_STORE
+
+
+class TestChunker:
+    """Test tier selection inside Chunker.chunk."""
+
+    def test_incompressible_chunk_passes_through(self):
+        """Stored chunks are returned unchanged with algorithm none."""
+        chunker = chunker_native.Chunker(compression_level=9)
+        data = os.urandom(256 * 1024)
+        result = chunker.chunk(data)
+        assert result["algorithm"] == "none"
+        assert result["data"] == data
+        assert chunker.tier_counts == (1, 0, 0, 0)
+
+    def test_stored_chunks_do_not_feed_controller(self):
+        """Copying a stored chunk is not a compression rate to step the level on."""
+        chunker = chunker_native.Chunker(compression_level=3, target_mbps=1000)
+        while chunker.level > 1:
+            chunker.chunk(TEXT)
+        for _ in range(8 * 4):
+            chunker.chunk(os.urandom(1 << 20))
+        assert chunker.level == 1
+
+    def test_compressible_chunk_round_trips(self):
+        """Compressible chunks use zlib at the configured level."""
+        chunker = chunker_native.Chunker(compression_level=9)
+        result = chunker.chunk(TEXT)
+        assert result["algorithm"] == "zlib"
+        assert result["level"] == 9
+        assert zlib.decompress(result["data"]) == TEXT
+
+    def test_adaptive_can_be_disabled(self):
+        """With adaptive off every chunk is deflated."""
+        chunker = chunker_native.Chunker(adaptive=False)
+        result = chunker.chunk(os.urandom(4096))
+        assert result["algorithm"] == "zlib"
+        assert chunker.tier_counts == (0, 0, 0, 0)
+
+
+class TestCompressionPolicy:
+    """Test the throughput feedback controller."""
+
+    def test_slow_windows_lower_level_then_degrade(self):
+        """Missing the target steps the level down, then shifts tiers."""
+        policy = chunker_native.CompressionPolicy(target_mbps=100, low_level=1, high_level=5)
+        for _ in range(8 * 4):
+            policy.record(1_000_000, 0.1)
+        assert policy.level == 1
+        assert not policy.degraded
+        assert policy.throughput_mbps == pytest.approx(10.0)
+
+        for _ in range(8):
+            policy.record(1_000_000, 0.1)
+        assert policy.degraded
+        assert policy.select(TEXT) == (chunker_native.TIER_LOW, 1)
+
+    def test_fast_windows_recover(self):
+        """Beating the target clears degradation before raising the level."""
+        policy = chunker_native.CompressionPolicy(target_mbps=100, low_level=1, high_level=3)
+        for _ in range(8 * 3):
+            policy.record(1_000_000, 0.1)
+        assert policy.degraded
+
+        for _ in range(8):
+            policy.record(1_000_000, 0.001)
+        assert not policy.degraded
+        assert policy.level == 1
+
+        for _ in range(8 * 4):
+            policy.record(1_000_000, 0.001)
+        assert policy.level == 3
+        assert policy.select(TEXT) == (chunker_native.TIER_HIGH, 3)
+
+    def test_no_target_keeps_level(self):
+        """Without a target the controller only reports throughput."""
+        policy = chunker_native.CompressionPolicy(high_level=7)
+        for _ in range(8 * 4):
+            policy.record(1_000, 1.0)
+        assert policy.level == 7
+        assert not policy.degraded
+
+    def test_invalid_arguments(self):
+        """Bad ranges and negative measurements are rejected."""
+        with pytest.raises(ValueError):
+            chunker_native.CompressionPolicy(low_level=5, high_level=2)
+        with pytest.raises(ValueError):
+            chunker_native.CompressionPolicy(target_mbps=-1)
+        with pytest.raises(ValueError):
+            chunker_native.CompressionPolicy().record(-1, 0.1)
+        with pytest.raises(ValueError):
+            chunker_native.Chunker(target_mbps=-1)
+
+
+class TestOpStats:
+    """Test the native latency histograms and counters."""
+
+    def test_operations_are_counted(self):
+        """Each call adds one sample and its bytes; failures count as errors."""
+        # decompress_data sizes its output at 4x the input
+        data = os.urandom(16384) + TEXT[:16384]
+        before = chunker_native.snapshot()
+        compressed = chunker_native.compress_data(data)
+        chunker_native.decompress_data(compressed)
+        with pytest.raises(RuntimeError):
+            chunker_native.decompress_data(b"not zlib")
+        after = chunker_native.snapshot()
+
+        assert after["compress"]["count"] - before["compress"]["count"] == 1
+        assert after["compress"]["bytes_in"] - before["compress"]["bytes_in"] == len(data)
+        assert after["compress"]["bytes_out"] - before["compress"]["bytes_out"] == len(compressed)
+        assert after["decompress"]["count"] - before["decompress"]["count"] == 2
+        assert after["decompress"]["errors"] - before["decompress"]["errors"] == 1
+        assert after["allocations"] > before["allocations"]
+        assert after["allocated_bytes"] > before["allocated_bytes"]
+
+    def test_checksums_are_hashed_natively(self):
+        """Chunk checksums are SHA-256 of the stored bytes and feed the hash histogram."""
+        before = chunker_native.snapshot()["hash"]["count"]
+        result = chunker_native.Chunker().chunk(TEXT)
+        assert result["checksum"] == hashlib.sha256(result["data"]).hexdigest()
+        assert chunker_native.checksum(b"abc") == hashlib.sha256(b"abc").hexdigest()
+        assert chunker_native.snapshot()["hash"]["count"] - before == 2
+
+    def test_quantiles_within_bucket_error(self):
+        """Percentiles come back within the 1/32 relative bucket width."""
+        before = chunker_native.snapshot(buckets=True)["hash"]
+        # 1..1000 us, observed from several threads at once
+        samples = [i * 1e-6 for i in range(1, 1001)]
+
+        def observe(part):
+            for seconds in part:
+                chunker_native.observe(chunker_native.OP_HASH, seconds, 10, 20)
+
+        workers = [threading.Thread(target=observe, args=(samples[t::4],)) for t in range(4)]
+        for worker in workers:
+            worker.start()
+        for worker in workers:
+            worker.join()
+        after = chunker_native.snapshot(buckets=True)["hash"]
+
+        assert after["count"] - before["count"] == 1000
+        assert after["bytes_in"] - before["bytes_in"] == 10000
+        added = {k: v - before["buckets"].get(k, 0) for k, v in after["buckets"].items()}
+        assert sum(added.values()) == 1000
+        # Quantiles of only the observed samples, walked from the bucket deltas
+        seen = 0
+        for upper in sorted(added):
+            seen += added[upper]
+            if seen >= 990:
+                assert abs(upper - 990_000) <= 990_000 / 32
+                break
+
+    def test_observe_rejects_bad_input(self):
+        """Unknown operations and negative values are refused."""
+        with pytest.raises(ValueError):
+            chunker_native.observe(99, 0.1)
+        with pytest.raises(ValueError):
+            chunker_native.observe(chunker_native.OP_COMPRESS, -1.0)
+
+    def test_prometheus_histogram_is_cumulative(self):
+        """Bucket counts never decrease and +Inf matches the sample count."""
+        chunker_native.compress_data(TEXT)
+        text = chunker_native.prometheus(prefix="test_chunker")
+        assert "# TYPE test_chunker_op_duration_seconds histogram" in text
+        assert 'test_chunker_op_bytes_total{op="compress",direction="in"}' in text
+        assert "test_chunker_allocations_total " in text
+
+        counts = [
+            int(line.rsplit(" ", 1)[1]) for line in text.splitlines()
+            if line.startswith('test_chunker_op_duration_seconds_bucket{op="compress"')
+        ]
+        assert counts == sorted(counts)
+        total = chunker_native.snapshot()["compress"]["count"]
+        assert counts[-1] == total
+
+
+class TestCpuDispatch:
+    """Test the kernels selected from detected CPU features."""
+
+    def test_features_report_selected_kernels(self):
+        """Every kernel reports a name and the AEAD follows the AES flags."""
+        info = chunker_native.cpu_features()
+        assert info["arch"] in ("x86_64", "aarch64", "generic")
+        assert all(isinstance(v, bool) for v in info["features"].values())
+        assert set(info["kernels"]) == {"crc32", "sha256_expected", "aead"}
+
+        features = info["features"]
+        hardware_aes = ((features["aes"] and features["pclmul"])
+                        or (features["arm_aes"] and features["pmull"]))
+        assert (info["kernels"]["aead"] == "aes256-gcm") == hardware_aes
+
+    def test_crc32_matches_zlib(self):
+        """Fold boundaries, unaligned starts and chaining agree with zlib."""
+        data = os.urandom(1 << 16)
+        for size in (0, 1, 15, 16, 63, 64, 65, 127, 128, 4103, 1 << 16):
+            for offset in (0, 3):
+                block = data[offset:offset + size]
+                assert chunker_native.crc32(block) == zlib.crc32(block)
+                half = len(block) // 2
+                chained = chunker_native.crc32(block[half:], chunker_native.crc32(block[:half]))
+                assert chained == zlib.crc32(block)
+
+
+class TestChunkAsync:
+    """Test chunking on the native worker pool."""
+
+    def test_results_match_sync_chunk(self):
+        """More submissions than the in-flight bound all resolve in order."""
+        chunker = chunker_native.Chunker(adaptive=False)
+        blocks = [TEXT[i * 1000:] for i in range(24)]
+
+        async def run():
+            return await asyncio.gather(*(chunker.chunk_async(b) for b in blocks))
+
+        results = asyncio.run(run())
+        assert [r["checksum"] for r in results] == [chunker.chunk(b)["checksum"] for b in blocks]
+        stats = chunker_native.pool_stats()
+        assert stats["started"] and stats["inflight"] == 0 and stats["waiting"] == 0
+        assert stats["completed"] >= len(blocks)
+
+    def test_loop_keeps_running_during_chunk(self):
+        """Timers fire while a large block is compressed."""
+        chunker = chunker_native.Chunker(chunk_size=64 * 1024 * 1024)
+        data = TEXT * 40
+
+        async def run():
+            ticks = 0
+            future = chunker.chunk_async(data)
+            while not future.done():
+                await asyncio.sleep(0)
+                ticks += 1
+            return ticks, future.result()
+
+        ticks, result = asyncio.run(run())
+        assert ticks > 1
+        assert result["checksum"] == hashlib.sha256(result["data"]).hexdigest()
+
+    def test_errors_and_cancellation(self):
+        """Bad input raises at submit; a cancelled future is skipped on delivery."""
+        chunker = chunker_native.Chunker()
+        with pytest.raises(RuntimeError):
+            chunker.chunk_async(b"no running loop")
+
+        async def run():
+            cancelled = chunker.chunk_async(TEXT)
+            cancelled.cancel()
+            result = await chunker.chunk_async(b"after")
+            while chunker_native.pool_stats()["inflight"]:
+                await asyncio.sleep(0.001)
+            return result
+
+        before = chunker_native.pool_stats()["cancelled"]
+        assert asyncio.run(run())["data"]
+        assert chunker_native.pool_stats()["cancelled"] == before + 1
+        with pytest.raises(RuntimeError):
+            chunker_native.configure_pool(workers=2)
+
+    def test_waiting_jobs_are_bounded(self):
+        """Submissions past the waiting bound raise QueueFull instead of queueing."""
+        module = TestModuleState.fresh_module()
+        module.configure_pool(workers=1, max_inflight=1, max_waiting=2)
+        chunker = module.Chunker()
+
+        async def run():
+            # Nothing is delivered until the loop runs, so none of these drain
+            futures = [chunker.chunk_async(TEXT) for _ in range(3)]
+            with pytest.raises(asyncio.QueueFull):
+                chunker.chunk_async(TEXT)
+            results = await asyncio.gather(*futures)
+            results.append(await chunker.chunk_async(TEXT))
+            return results
+
+        assert len(asyncio.run(run())) == 4
+        stats = module.pool_stats()
+        assert stats["max_waiting"] == 2 and stats["submitted"] == 4
+        with pytest.raises(ValueError):
+            TestModuleState.fresh_module().configure_pool(max_waiting=-1)
+
+
+class TestModuleState:
+    """Test module isolation and concurrent use without relying on the GIL."""
+
+    @staticmethod
+    def fresh_module():
+        spec = importlib.util.find_spec("chunker_native")
+        module = importlib.util.module_from_spec(spec)
+        spec.loader.exec_module(module)
+        return module
+
+    def test_instances_have_own_types_and_pool(self):
+        """A second module instance gets new heap types and an idle pool."""
+        other = self.fresh_module()
+        assert other.Chunker is not chunker_native.Chunker
+        assert chunker_native.Chunker.__flags__ & (1 << 9)  # Py_TPFLAGS_HEAPTYPE
+
+        async def run():
+            return await other.Chunker().chunk_async(TEXT)
+
+        before = chunker_native.pool_stats()["submitted"]
+        assert asyncio.run(run())["algorithm"] == "zlib"
+        assert other.pool_stats()["submitted"] == 1
+        assert chunker_native.pool_stats()["submitted"] == before
+
+    def test_import_in_subinterpreter(self):
+        """The module loads and runs inside a sub-interpreter."""
+        try:
+            import _interpreters as interpreters
+        except ImportError:
+            interpreters = pytest.importorskip("_xxsubinterpreters")
+        interp = interpreters.create()
+        try:
+            interpreters.run_string(interp, (
+                "import asyncio, chunker_native\n"
+                "chunker = chunker_native.Chunker(adaptive=False)\n"
+                "async def run():\n"
+                "    return await chunker.chunk_async(b'sub' * 1000)\n"
+                "assert asyncio.run(run())['algorithm'] == 'zlib'\n"
+            ))
+        finally:
+            interpreters.destroy(interp)
+
+    def test_shared_chunker_across_threads(self):
+        """Concurrent chunk calls on one chunker keep its counters consistent."""
+        chunker = chunker_native.Chunker(compression_level=1)
+        blocks = [TEXT, os.urandom(8192)]
+
+        def work():
+            for i in range(50):
+                result = chunker.chunk(blocks[i % 2])
+                assert result["checksum"] == hashlib.sha256(result["data"]).hexdigest()
+
+        workers = [threading.Thread(target=work) for _ in range(4)]
+        for worker in workers:
+            worker.start()
+        for worker in workers:
+            worker.join()
+        assert chunker.tier_counts[chunker_native.TIER_STORE] == 100
+        assert sum(chunker.tier_counts) == 200
+
+
+class TestBufferPool:
+    """Test pooled output buffers."""
+
+    def test_pooled_chunk_round_trips(self):
+        """A pooled result works wherever bytes-like input is accepted."""
+        result = chunker_native.Chunker(adaptive=False).chunk(TEXT, pooled=True)
+        data = result["data"]
+        assert isinstance(data, chunker_native.PooledBuffer)
+        assert data.capacity >= len(data)
+        assert zlib.decompress(data) == TEXT
+        assert chunker_native.checksum(data) == result["checksum"]
+        assert chunker_native.crc32(data) == zlib.crc32(data)
+
+        view = memoryview(data)
+        with pytest.raises(BufferError):
+            data.release()
+        view.release()
+        data.release()
+        assert data.released and len(data) == 0
+        with pytest.raises(BufferError):
+            memoryview(data)
+
+    def test_blocks_are_reused(self):
+        """Repeated chunks of one size map no new memory."""
+        chunker = chunker_native.Chunker(adaptive=False)
+        block = os.urandom(2 << 20)
+        chunker.chunk(block)
+        before = chunker_native.buffer_pool_stats()
+        for _ in range(10):
+            chunker.chunk(block, pooled=True)["data"].release()
+        after = chunker_native.buffer_pool_stats()
+        assert after["maps"] == before["maps"]
+        hits = (after["thread_hits"] + after["shared_hits"]) - (before["thread_hits"] + before["shared_hits"])
+        assert hits == 10
+
+    def test_alloc_configure_and_trim(self):
+        """Fresh buffers are zeroed and writable; trimming empties the caches."""
+        buf = chunker_native.alloc_buffer(100000)
+        assert buf == bytes(100000)
+        memoryview(buf)[:4] = b"abcd"
+        assert buf.tobytes()[:4] == b"abcd"
+        del buf
+
+        with pytest.raises(ValueError):
+            chunker_native.configure_buffer_pool(hugepages="sometimes")
+        with pytest.raises(TypeError):
+            chunker_native.PooledBuffer()
+        chunker_native.configure_buffer_pool(hugepages="off")
+        chunker_native.trim_buffer_pool()
+        assert chunker_native.buffer_pool_stats()["hugepages"] == "off"
+        assert chunker_native.buffer_pool_stats()["cached_bytes"] == 0
+        chunker_native.configure_buffer_pool(hugepages="thp")
+
+
+class TestParallelDeflate:
+    """Test block-split compression on helper threads."""
+
+    BLOCK = 64 * 1024
+    DATA = TEXT * 6 + os.urandom(200000) + TEXT
+
+    def test_single_stream_for_any_thread_count(self):
+        """Output is one standard stream, identical however many threads ran."""
+        single = chunker_native.compress_parallel(self.DATA, 6, 1, self.BLOCK)
+        assert chunker_native.compress_parallel(self.DATA, 6, 4, self.BLOCK) == single
+        assert zlib.decompress(single) == self.DATA
+        # Dictionaries carry the window across splits
+        assert len(single) < len(zlib.compress(self.DATA, 6)) * 1.01
+
+        packed = chunker_native.compress_parallel(self.DATA, 6, 4, self.BLOCK, "gzip")
+        assert gzip.decompress(packed) == self.DATA
+        with pytest.raises(ValueError):
+            chunker_native.compress_parallel(self.DATA, format="zstd")
+        with pytest.raises(ValueError):
+            chunker_native.compress_parallel(self.DATA, block_size=1024)
+
+    def test_indexed_gzip_decompresses_in_parallel(self):
+        """Independent gzip blocks inflate apart; other streams fall back."""
+        packed = chunker_native.compress_parallel(self.DATA, 6, 4, self.BLOCK, "gzip", True)
+        assert gzip.decompress(packed) == self.DATA
+        assert chunker_native.decompress_parallel(packed, 4) == self.DATA
+
+        damaged = bytearray(packed)
+        damaged[-20] ^= 0xFF
+        with pytest.raises(RuntimeError):
+            chunker_native.decompress_parallel(bytes(damaged))
+
+        zeros = bytes(8 << 20)
+        result = chunker_native.decompress_parallel(zlib.compress(zeros), pooled=True)
+        assert isinstance(result, chunker_native.PooledBuffer)
+        assert result == zeros
+
+    def test_concatenated_gzip_members(self):
+        """Members after the first are inflated, as gzip -d does; garbage is not."""
+        members = gzip.compress(TEXT) + gzip.compress(self.DATA)
+        assert chunker_native.decompress_parallel(members) == TEXT + self.DATA
+        with pytest.raises(RuntimeError):
+            chunker_native.decompress_parallel(gzip.compress(TEXT) + b"junk")
+        with pytest.raises(RuntimeError):
+            chunker_native.decompress_parallel(zlib.compress(TEXT) + zlib.compress(TEXT))
+
+    def test_max_output_caps_decompression(self):
+        """A bomb stops at the cap instead of inflating fully."""
+        zeros = bytes(8 << 20)
+        bomb = zlib.compress(zeros, 9)
+        with pytest.raises(ValueError):
+            chunker_native.decompress_parallel(bomb, max_output=1 << 20)
+        assert chunker_native.decompress_parallel(bomb, max_output=len(zeros)) == zeros
+
+        # Indexed streams are held to the same cap
+        packed = chunker_native.compress_parallel(self.DATA, 6, 4, self.BLOCK, "gzip", True)
+        with pytest.raises(ValueError):
+            chunker_native.decompress_parallel(packed, max_output=len(self.DATA) - 1)
+        with pytest.raises(ValueError):
+            chunker_native.decompress_parallel(packed, max_output=-1)
+
+    def test_chunker_splits_large_blocks(self):
+        """A threaded chunker still emits zlib data with a matching checksum."""
+        chunker = chunker_native.Chunker(adaptive=False, threads=4, block_size=self.BLOCK)
+        result = chunker.chunk(self.DATA)
+        assert zlib.decompress(result["data"]) == self.DATA
+        assert result["checksum"] == hashlib.sha256(result["data"]).hexdigest()
+        with pytest.raises(ValueError):
+            chunker_native.Chunker(threads=-1)
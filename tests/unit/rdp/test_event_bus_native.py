@@ -0,0 +1,232 @@
+"""
+Unit tests for the native telemetry event bus.
+
+Producers push fixed 64-byte records into a lock-free ring and never wait:
+a full ring drops the record and counts it. The consumer drains packed
+batches that feed a time-bucketed aggregation window and a correlation
+index keyed by trace, session, user and request id.
+"""
+
+import ctypes
+import random
+import struct
+import threading
+
+import pytest
+
+event_bus_native = pytest.importorskip("event_bus_native")
+
+SECOND = 1_000_000_000
+
+
+class Record(ctypes.Structure):
+    """ctypes mirror of the fixed record layout."""
+    _fields_ = [
+        ("timestamp_ns", ctypes.c_uint64),
+        ("session", ctypes.c_uint64),
+        ("trace", ctypes.c_uint64),
+        ("value", ctypes.c_double),
+        ("code", ctypes.c_uint32),
+        ("level", ctypes.c_uint8),
+        ("category", ctypes.c_uint8),
+        ("payload_len", ctypes.c_uint16),
+        ("payload", ctypes.c_uint8 * 24),
+    ]
+
+
+EmitFunc = ctypes.CFUNCTYPE(ctypes.c_int, ctypes.c_void_p, ctypes.POINTER(Record))
+
+
+class CApi(ctypes.Structure):
+    """ctypes mirror of the exported C API table."""
+    _fields_ = [("version", ctypes.c_int), ("emit", EmitFunc)]
+
+
+def load_capi():
+    """C API table from the module capsule."""
+    get_pointer = ctypes.pythonapi.PyCapsule_GetPointer
+    get_pointer.restype = ctypes.c_void_p
+    get_pointer.argtypes = [ctypes.py_object, ctypes.c_char_p]
+    address = get_pointer(event_bus_native._C_API, b"event_bus_native._C_API")
+    return CApi.from_address(address)
+
+
+def unpack(batch):
+    """Drained batch as record tuples."""
+    return list(struct.iter_unpack(event_bus_native.RECORD_FORMAT, batch))
+
+
+class TestEventBus:
+    """Test the ring and its record layout."""
+
+    def test_record_layout(self):
+        """Fields, key hashes and payload land where the format says."""
+        bus = event_bus_native.EventBus(64)
+        before = event_bus_native.now_ns()
+        assert bus.emit(3, 5, 42, 1.5, "session-1", "trace-1", b"chunk-7")
+        ((ts, session, trace, value, code, level, category, plen, payload),) = unpack(bus.drain())
+        assert before <= ts <= event_bus_native.now_ns()
+        assert session == event_bus_native.key_hash("session-1")
+        assert trace == event_bus_native.key_hash("trace-1")
+        assert (value, code, level, category) == (1.5, 42, 3, 5)
+        assert payload[:plen] == b"chunk-7"
+        assert struct.calcsize(event_bus_native.RECORD_FORMAT) == event_bus_native.RECORD_SIZE
+
+    def test_optional_fields_and_truncation(self):
+        """Missing ids hash to 0 and long payloads are cut to the record size."""
+        bus = event_bus_native.EventBus(64)
+        bus.emit(0, 0)
+        bus.emit(1, 1, None, None, None, 99, "x" * 100)
+        first, second = unpack(bus.drain())
+        assert first[1:3] == (0, 0)
+        assert second[2] == 99
+        assert second[7] == event_bus_native.PAYLOAD_SIZE
+        with pytest.raises(TypeError):
+            bus.emit(1)
+        with pytest.raises(ValueError):
+            bus.emit(300, 0)
+
+    def test_full_ring_drops_without_blocking(self):
+        """Emits past capacity are dropped and counted; draining frees slots."""
+        bus = event_bus_native.EventBus(16)
+        results = [bus.emit(1, 1, i) for i in range(20)]
+        assert results == [True] * 16 + [False] * 4
+        assert bus.stats["dropped"] == 4
+        assert len(bus) == 16
+        assert [r[4] for r in unpack(bus.drain(10))] == list(range(10))
+        assert bus.emit(1, 1, 100)
+        assert [r[4] for r in unpack(bus.drain())] == list(range(10, 16)) + [100]
+        assert bus.drain() == b""
+
+    def test_concurrent_native_producers(self):
+        """Threads emitting through the C API without the GIL lose nothing."""
+        capi = load_capi()
+        assert capi.version == event_bus_native.CAPI_VERSION
+        bus = event_bus_native.EventBus(1 << 16)
+        threads, per_thread = 8, 4000
+
+        def produce(tid):
+            record = Record(level=1, category=tid)
+            for i in range(per_thread):
+                record.code = i
+                while capi.emit(id(bus), ctypes.byref(record)) != 0:
+                    pass
+
+        workers = [threading.Thread(target=produce, args=(t,)) for t in range(threads)]
+        for worker in workers:
+            worker.start()
+        seen = {t: [] for t in range(threads)}
+        while any(worker.is_alive() for worker in workers) or len(bus):
+            for record in unpack(bus.drain()):
+                assert record[0] > 0
+                seen[record[6]].append(record[4])
+        for worker in workers:
+            worker.join()
+        for record in unpack(bus.drain()):
+            seen[record[6]].append(record[4])
+
+        # Every producer's records arrive once each and in its own order
+        for codes in seen.values():
+            assert codes == list(range(per_thread))
+        assert bus.stats["emitted"] == threads * per_thread
+
+
+class TestEventWindow:
+    """Test the time-bucketed sliding window."""
+
+    def test_counts_slide_with_time(self):
+        """Buckets leave the window as time moves past them."""
+        window = event_bus_native.EventWindow(bucket_ms=1000, buckets=10)
+        base = 1_000 * SECOND
+        for t in range(20):
+            window.add(1, 2, float(t), base + t * SECOND)
+        stats = window.stats(base + 19 * SECOND)
+        assert stats["events"] == 10
+        assert stats["counts"] == {(2, 1): 10}
+        assert (stats["value_min"], stats["value_max"]) == (10.0, 19.0)
+        assert stats["value_sum"] == sum(range(10, 20))
+        assert window.stats(base + 100 * SECOND)["events"] == 0
+        assert window.span == 10.0
+
+    def test_late_events_and_batches(self):
+        """Records older than the window are counted as late, not added."""
+        window = event_bus_native.EventWindow(bucket_ms=100, buckets=5)
+        now = event_bus_native.now_ns()
+        window.add(0, 0, 0.0, now)
+        window.add(0, 0, 0.0, now - 10 * SECOND)
+        assert window.stats(now)["late"] == 1
+
+        bus = event_bus_native.EventBus(64)
+        for level in range(4):
+            bus.emit(level, 7, 0, 2.0)
+        assert window.add_records(bus.drain()) == 4
+        stats = window.stats()
+        assert stats["events"] == 5
+        assert stats["counts"][(7, 3)] == 1
+        with pytest.raises(ValueError):
+            window.add_records(b"\x00" * 10)
+
+
+class TestCorrelator:
+    """Test the correlation index."""
+
+    def test_lookup_by_each_key(self):
+        """Entries are found by any of their ids, in arrival order."""
+        correlator = event_bus_native.Correlator(capacity=64, window=300.0)
+        a = correlator.add(trace="t1", session="s1", user="u1")
+        b = correlator.add(session="s1", request="r1")
+        c = correlator.add(trace="t1", user="u2")
+        assert correlator.lookup(event_bus_native.KEY_SESSION, "s1") == [a, b]
+        assert correlator.lookup(event_bus_native.KEY_TRACE, "t1") == [a, c]
+        assert correlator.lookup(event_bus_native.KEY_USER, "u2") == [c]
+        assert correlator.lookup(event_bus_native.KEY_REQUEST, "r1") == [b]
+        assert correlator.lookup(event_bus_native.KEY_USER, "s1") == []
+        assert a in correlator and 1000 not in correlator
+
+    def test_expiry_and_eviction(self):
+        """Entries age out of the window and a full log drops its oldest."""
+        correlator = event_bus_native.Correlator(capacity=64, window=10.0)
+        now = event_bus_native.now_ns()
+        old = correlator.add(session="s", timestamp_ns=now - 20 * SECOND)
+        fresh = correlator.add(session="s", timestamp_ns=now)
+        assert correlator.lookup(event_bus_native.KEY_SESSION, "s") == [fresh]
+        assert old not in correlator
+        assert correlator.stats["expired"] == 1
+
+        seqs = [correlator.add(session="k%d" % (i % 3)) for i in range(200)]
+        assert len(correlator) == 64
+        assert correlator.stats["evicted"] > 0
+        assert correlator.lookup(event_bus_native.KEY_SESSION, "k0") == [s for s in seqs[-64:] if s % 3 == seqs[0] % 3]
+        assert correlator.expire(now + 60 * SECOND) == 64
+        assert correlator.stats["keys"] == 0
+
+    def test_matches_reference_model(self):
+        """Random traffic with expiry agrees with a straightforward model."""
+        rng = random.Random(1)
+        correlator = event_bus_native.Correlator(capacity=256, window=5.0)
+        base = event_bus_native.now_ns()
+        log = []
+        for step in range(5000):
+            ts = base + step * SECOND // 10
+            ids = [rng.choice([None] + ["id%d" % i for i in range(40)]) for _ in range(4)]
+            seq = correlator.add(*ids, timestamp_ns=ts)
+            log.append((seq, ts, ids))
+            correlator.expire(ts)
+            if step % 50 == 0:
+                live = [e for e in log[-256:] if e[1] + 5 * SECOND > ts]
+                for kind in range(4):
+                    for key in {"id%d" % i for i in range(40)}:
+                        expected = [s for s, _, k in live if k[kind] == key]
+                        assert correlator.lookup(kind, key, ts) == expected
+
+    def test_indexes_drained_records(self):
+        """Drained batches are indexed by session and trace."""
+        bus = event_bus_native.EventBus(64)
+        bus.emit(1, 1, 0, 0.0, "sess", None)
+        bus.emit(1, 1, 0, 0.0, None, None)
+        bus.emit(1, 1, 0, 0.0, "sess", "tr")
+        correlator = event_bus_native.Correlator()
+        assert correlator.add_records(bus.drain()) == 2
+        first, second = correlator.lookup(event_bus_native.KEY_SESSION, "sess")
+        assert correlator.lookup(event_bus_native.KEY_TRACE, "tr") == [second]
+        assert unpack(correlator.record(second))[0][2] == event_bus_native.key_hash("tr")
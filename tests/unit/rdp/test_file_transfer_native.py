@@ -0,0 +1,114 @@
+"""
+Unit tests for the native file transfer engine.
+
+Copies run in the kernel and the SHA-256 is taken from the same pass, so a
+transfer reads the source once.
+"""
+
+import errno
+import hashlib
+import os
+import shutil
+
+import pytest
+
+file_transfer_native = pytest.importorskip("file_transfer_native")
+
+
+@pytest.fixture
+def source(tmp_path):
+    """A source file spanning several kernel copy chunks."""
+    data = os.urandom(file_transfer_native.CHUNK_SIZE * 2 + 12_345)
+    path = tmp_path / "source.bin"
+    path.write_bytes(data)
+    return path, data
+
+
+class TestCopyFile:
+    """Test kernel-side copies."""
+
+    def test_copy_with_hash(self, source, tmp_path):
+        """Copied bytes and digest match the source."""
+        path, data = source
+        target = tmp_path / "target.bin"
+
+        copied, digest, method = file_transfer_native.copy_file(str(path), str(target))
+
+        assert copied == len(data)
+        assert digest == hashlib.sha256(data).hexdigest()
+        assert target.read_bytes() == data
+        assert method in ("splice", "read_write")
+
+    def test_copy_without_hash(self, source, tmp_path):
+        """Plain copies skip the digest."""
+        path, data = source
+        target = tmp_path / "target.bin"
+
+        copied, digest, _ = file_transfer_native.copy_file(path, target, hash=False)
+
+        assert copied == len(data)
+        assert digest is None
+        assert target.read_bytes() == data
+
+    def test_empty_file(self, tmp_path):
+        """Empty files copy and hash like any other."""
+        path = tmp_path / "empty"
+        path.write_bytes(b"")
+
+        copied, digest, _ = file_transfer_native.copy_file(path, tmp_path / "copy")
+
+        assert copied == 0
+        assert digest == hashlib.sha256(b"").hexdigest()
+
+    def test_missing_source(self, tmp_path):
+        """Errors carry errno and the offending path."""
+        with pytest.raises(FileNotFoundError) as excinfo:
+            file_transfer_native.copy_file(tmp_path / "missing", tmp_path / "copy")
+        assert excinfo.value.filename == str(tmp_path / "missing")
+
+    def test_same_file_is_refused(self, source, tmp_path):
+        """Copying onto the source, even through a link, leaves it intact."""
+        path, data = source
+        link = tmp_path / "link.bin"
+        link.symlink_to(path)
+
+        for target in (path, link):
+            with pytest.raises(shutil.SameFileError):
+                file_transfer_native.copy_file(path, target)
+        assert path.read_bytes() == data
+
+    def test_short_source_fails(self, tmp_path):
+        """A source yielding fewer bytes than its size is not a copy."""
+        path = "/sys/kernel/uevent_seqnum"  # sysfs reports 4096 bytes
+        if not os.path.exists(path) or os.path.getsize(path) <= len(open(path, "rb").read()):
+            pytest.skip("no short-reading file available")
+
+        with pytest.raises(OSError) as excinfo:
+            file_transfer_native.copy_file(path, tmp_path / "copy")
+        assert excinfo.value.errno == errno.EIO
+
+
+class TestTransferProgress:
+    """Test the shared progress counter."""
+
+    def test_progress_reaches_total(self, source, tmp_path):
+        """The counter ends at the file size."""
+        path, data = source
+        progress = file_transfer_native.TransferProgress()
+
+        file_transfer_native.copy_file(path, tmp_path / "target.bin", progress=progress)
+
+        assert progress.total == len(data)
+        assert progress.bytes_done == len(data)
+        assert not progress.cancelled
+
+    def test_cancel(self, source, tmp_path):
+        """A cancelled counter stops the copy with ECANCELED."""
+        path, _ = source
+        progress = file_transfer_native.TransferProgress()
+        progress.cancel()
+
+        with pytest.raises(OSError) as excinfo:
+            file_transfer_native.copy_file(path, tmp_path / "target.bin", progress=progress)
+        assert excinfo.value.errno == errno.ECANCELED
+        assert progress.bytes_done == 0
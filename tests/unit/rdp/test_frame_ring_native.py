@@ -0,0 +1,220 @@
+"""
+Unit tests for the native shared-memory frame ring.
+
+One producer publishes frames into slots of a POSIX shared memory segment;
+each consumer reads them in place and the producer drops frames rather than
+overwrite a slot a consumer still holds. Cursors are kept alive by a
+heartbeat rather than by pid, since consumers may run in another PID
+namespace.
+"""
+
+import multiprocessing
+import os
+import signal
+import threading
+import time
+import uuid
+
+import pytest
+
+frame_ring_native = pytest.importorskip("frame_ring_native")
+
+
+@pytest.fixture
+def ring_name():
+    """Unique segment name, unlinked again if a test leaves it behind."""
+    name = f"lucid-test-{uuid.uuid4().hex}"
+    yield name
+    path = f"/dev/shm/{name}"
+    if os.path.exists(path):
+        os.unlink(path)
+
+
+def read_frames(name, count, queue):
+    """Child process: attach, signal, then read count frames."""
+    reader = frame_ring_native.FrameRingReader(name)
+    queue.put("ready")
+    frames = []
+    for _ in range(count):
+        seq, timestamp_us, width, height, fmt, view = reader.next(timeout=10)
+        frames.append((seq, timestamp_us, width, height, fmt, bytes(view)))
+        del view
+    reader.close()
+    queue.put(frames)
+
+
+def hold_then_release(name, queue, go):
+    """Child process: hold a frame, then try to move on once told to."""
+    reader = frame_ring_native.FrameRingReader(name)
+    queue.put("attached")
+    queue.put("holding" if reader.next(timeout=10) is not None else "empty")
+    go.wait(10)
+    try:
+        reader.release()
+        queue.put("released")
+    except Exception as e:
+        queue.put(type(e).__name__)
+
+
+class TestFrameRing:
+    """Test publishing and consuming frames."""
+
+    def test_reserve_commit_round_trip(self, ring_name):
+        """A frame written into a reserved slot reads back with its descriptor."""
+        writer = frame_ring_native.FrameRingWriter(ring_name, 1024, slot_count=4)
+        reader = frame_ring_native.FrameRingReader(ring_name)
+
+        slot = writer.reserve()
+        slot[:5] = b"frame"
+        del slot
+        assert writer.commit(5, timestamp_us=42, width=2, height=1, format=frame_ring_native.FORMAT_BGR24) == 0
+
+        seq, timestamp_us, width, height, fmt, view = reader.next(timeout=1)
+        assert (seq, timestamp_us, width, height, fmt) == (0, 42, 2, 1, frame_ring_native.FORMAT_BGR24)
+        assert bytes(view) == b"frame"
+        assert view.readonly
+        del view
+        reader.close()
+        writer.close()
+
+    def test_held_slots_drop_new_frames(self, ring_name):
+        """The producer drops frames instead of overwriting slots a consumer holds."""
+        writer = frame_ring_native.FrameRingWriter(ring_name, 16, slot_count=2)
+        reader = frame_ring_native.FrameRingReader(ring_name)
+
+        assert writer.publish(b"a") == 0
+        assert writer.publish(b"b") == 1
+        assert writer.publish(b"c") is None
+        assert writer.dropped == 1
+
+        frame = reader.next(timeout=1)
+        assert bytes(frame[5]) == b"a"
+        del frame
+        reader.release()
+        assert writer.publish(b"c") == 2
+        assert reader.lag == 2
+        reader.close()
+        writer.close()
+
+    def test_cross_process_consumers(self, ring_name):
+        """Consumers in other processes each see every frame."""
+        writer = frame_ring_native.FrameRingWriter(ring_name, 1 << 20, slot_count=8)
+        context = multiprocessing.get_context("fork")
+        queue = context.Queue()
+        children = [context.Process(target=read_frames, args=(ring_name, 20, queue)) for _ in range(2)]
+        for child in children:
+            child.start()
+        for _ in children:
+            assert queue.get(timeout=10) == "ready"
+        assert writer.consumers == 2
+
+        sent = 0
+        while sent < 20:
+            if writer.publish(bytes([sent]) * (1 << 20), timestamp_us=sent) is not None:
+                sent += 1
+        for _ in children:
+            frames = queue.get(timeout=10)
+            assert [f[0] for f in frames] == list(range(20))
+            assert all(f[5] == bytes([f[1]]) * (1 << 20) for f in frames)
+        for child in children:
+            child.join(timeout=10)
+        writer.close()
+
+    def test_close_wakes_reader(self, ring_name):
+        """A blocked reader drains what was published and then gets EOFError."""
+        writer = frame_ring_native.FrameRingWriter(ring_name, 16)
+        reader = frame_ring_native.FrameRingReader(ring_name)
+        writer.publish(b"last")
+
+        assert bytes(reader.next(timeout=1)[5]) == b"last"
+        threading.Timer(0.05, writer.close).start()
+        with pytest.raises(EOFError):
+            reader.next()
+        assert reader.producer_closed
+        assert not os.path.exists(f"/dev/shm/{ring_name}")
+        reader.close()
+
+    def test_views_pin_mapping(self, ring_name):
+        """close() refuses while slot views are alive."""
+        writer = frame_ring_native.FrameRingWriter(ring_name, 16)
+        slot = writer.reserve()
+        with pytest.raises(BufferError):
+            writer.close()
+        del slot
+        writer.close()
+        assert writer.closed
+
+    def test_dead_consumer_reclaimed(self, ring_name):
+        """A consumer that exits without detaching stops holding slots once its heartbeat stalls."""
+        writer = frame_ring_native.FrameRingWriter(ring_name, 16, slot_count=2, consumer_timeout=0.3)
+        pid = os.fork()
+        if pid == 0:
+            reader = frame_ring_native.FrameRingReader(ring_name)  # noqa: F841 - never closed
+            os._exit(0)
+        os.waitpid(pid, 0)
+        assert writer.consumers == 1
+
+        assert [writer.publish(b"x") for _ in range(3)] == [0, 1, None]
+        time.sleep(0.4)
+        assert writer.publish(b"x") == 2
+        assert writer.consumers == 0
+        writer.close()
+
+    def test_slow_consumer_kept_and_reclaimed_cursor_fenced(self, ring_name):
+        """A live consumer keeps its frame however long it works; a reclaimed one cannot move a new cursor."""
+        writer = frame_ring_native.FrameRingWriter(ring_name, 16, slot_count=2, consumer_timeout=0.3)
+        slow = frame_ring_native.FrameRingReader(ring_name)
+        writer.publish(b"a")
+        writer.publish(b"b")
+        frame = slow.next(timeout=1)
+        time.sleep(0.5)
+        assert writer.publish(b"c") is None
+        assert bytes(frame[5]) == b"a"
+
+        # A view that outlives its frame must not be released under it
+        with pytest.raises(BufferError):
+            slow.next(timeout=0)
+        del frame
+        slow.release()
+
+        context = multiprocessing.get_context("fork")
+        queue = context.Queue()
+        go = context.Event()
+        child = context.Process(target=hold_then_release, args=(ring_name, queue, go))
+        child.start()
+        assert queue.get(timeout=10) == "attached"
+        assert writer.publish(b"c") is not None
+        assert queue.get(timeout=10) == "holding"
+        slow.close()
+
+        # Stopped, the child's heartbeat stalls and its cursor is reclaimed
+        os.kill(child.pid, signal.SIGSTOP)
+        assert writer.publish(b"d") is not None
+        assert writer.publish(b"e") is None
+        time.sleep(0.5)
+        assert writer.publish(b"e") is not None
+        fresh = frame_ring_native.FrameRingReader(ring_name)
+        lag = fresh.lag
+        os.kill(child.pid, signal.SIGCONT)
+        go.set()
+        assert queue.get(timeout=10) == "RuntimeError"
+        assert fresh.lag == lag
+        child.join(timeout=10)
+        fresh.close()
+        writer.close()
+
+    def test_invalid_arguments(self, ring_name):
+        """Bad names, geometry and missing segments are reported."""
+        with pytest.raises(ValueError):
+            frame_ring_native.FrameRingWriter("a/b", 16)
+        with pytest.raises(ValueError):
+            frame_ring_native.FrameRingWriter(ring_name, 16, slot_count=0)
+        with pytest.raises(FileNotFoundError):
+            frame_ring_native.FrameRingReader(ring_name)
+
+        writer = frame_ring_native.FrameRingWriter(ring_name, 16)
+        with pytest.raises(FileExistsError):
+            frame_ring_native.FrameRingWriter(ring_name, 16)
+        with pytest.raises(ValueError):
+            writer.publish(b"x" * 17)
+        writer.close()
@@ -0,0 +1,159 @@
+"""
+Unit tests for the native PII scanner.
+
+Every PrivacyShield pattern is tried from one pass over the input; spans
+never overlap, cards must pass Luhn, and the streaming redactor produces
+the same bytes as redacting the whole input at once.
+"""
+
+import asyncio
+import random
+import re
+
+import pytest
+
+pii_scanner_native = pytest.importorskip("pii_scanner_native")
+
+SAMPLE = (
+    "Contact Jane Doe at jane.doe@example.com or (555) 123-4567. "
+    "SSN 123-45-6789, card 4111 1111 1111 1111, host 10.0.0.12, "
+    "nic 00:1A:2B:3C:4D:5E, born 12/25/1990, passport AB1234567, DL D1234567."
+)
+
+
+def spans_by_type(data):
+    """Map each detected span to (type name, matched text)."""
+    return [
+        (pii_scanner_native.TYPE_NAMES[t], data[start:end])
+        for t, start, end in pii_scanner_native.scan(data)
+    ]
+
+
+class TestScan:
+    """Test span detection."""
+
+    def test_all_types_detected(self):
+        """Each pattern family is found with the expected extent."""
+        assert spans_by_type(SAMPLE) == [
+            ("name", "Contact Jane Doe"),
+            ("email", "jane.doe@example.com"),
+            ("phone", "(555) 123-4567"),
+            ("ssn", "123-45-6789"),
+            ("credit_card", "4111 1111 1111 1111"),
+            ("ip_address", "10.0.0.12"),
+            ("mac_address", "00:1A:2B:3C:4D:5E"),
+            ("date_of_birth", "12/25/1990"),
+            ("passport", "AB1234567"),
+            ("driver_license", "D1234567"),
+        ]
+
+    def test_luhn_failure_is_not_a_card(self):
+        """Card-shaped numbers with a bad check digit are not cards."""
+        assert "credit_card" not in [t for t, _ in spans_by_type("4111 1111 1111 1112")]
+        assert spans_by_type("4111111111111111") == [("credit_card", "4111111111111111")]
+
+    def test_email_backtracks_to_word_boundary(self):
+        """The TLD shrinks until a boundary follows, as the regex does."""
+        assert spans_by_type("a@b.co.uk_ x") == [("email", "a@b.co")]
+
+    def test_spans_do_not_overlap(self):
+        """An SSN-shaped prefix inside a card is reported once, as the card."""
+        spans = pii_scanner_native.scan("4111-1111-1111-1111 and 123456789")
+        assert [pii_scanner_native.TYPE_NAMES[t] for t, _, _ in spans] == ["credit_card", "ssn"]
+        for (_, _, end), (_, start, _) in zip(spans, spans[1:]):
+            assert end <= start
+
+    def test_type_filter(self):
+        """Only the requested types are reported."""
+        spans = pii_scanner_native.scan(SAMPLE, types=1 << pii_scanner_native.EMAIL)
+        assert [t for t, _, _ in spans] == [pii_scanner_native.EMAIL]
+        with pytest.raises(ValueError):
+            pii_scanner_native.scan(SAMPLE, types=1 << 20)
+
+    def test_str_offsets_are_characters(self):
+        """Non-ASCII text before a match does not shift str offsets."""
+        text = "Grüße, Zoë: write to zoe@example.org"
+        ((t, start, end),) = pii_scanner_native.scan(text)
+        assert text[start:end] == "zoe@example.org"
+        ((_, bstart, bend),) = pii_scanner_native.scan(text.encode())
+        assert text.encode()[bstart:bend] == b"zoe@example.org"
+
+    @pytest.mark.parametrize("pattern, pii_type", [
+        (r"\b\d{3}-?\d{2}-?\d{4}\b", "SSN"),
+        (r"\b(?:[0-9]{1,3}\.){3}[0-9]{1,3}\b", "IP_ADDRESS"),
+        (r"\b(?:[0-9A-Fa-f]{2}[:-]){5}(?:[0-9A-Fa-f]{2})\b", "MAC_ADDRESS"),
+    ])
+    def test_matches_regex(self, pattern, pii_type):
+        """Single-type scans agree with the PrivacyShield regex on random text."""
+        rng = random.Random(41)
+        alphabet = "0123456789abcdefABCDEF-:. x"
+        for _ in range(200):
+            text = "".join(rng.choice(alphabet) for _ in range(80))
+            expected = [(m.start(), m.end()) for m in re.finditer(pattern, text)]
+            found = [(s, e) for _, s, e in
+                     pii_scanner_native.scan(text, types=1 << getattr(pii_scanner_native, pii_type))]
+            assert found == expected, text
+
+
+class TestRedact:
+    """Test one-shot and streaming masking."""
+
+    def test_redact_preserves_length(self):
+        """Masking keeps offsets valid for str and bytes."""
+        masked = pii_scanner_native.redact(SAMPLE)
+        assert len(masked) == len(SAMPLE)
+        assert "jane.doe" not in masked and "4111" not in masked
+        assert pii_scanner_native.redact(SAMPLE.encode(), mask="#").count(b"#") > 0
+
+    def test_redact_into_masks_in_place(self):
+        """A writable buffer is masked without a copy."""
+        buf = bytearray(SAMPLE.encode())
+        count = pii_scanner_native.redact_into(buf)
+        assert count == len(pii_scanner_native.scan(SAMPLE))
+        assert bytes(buf) == pii_scanner_native.redact(SAMPLE.encode())
+        with pytest.raises(TypeError):
+            pii_scanner_native.redact_into(SAMPLE.encode())
+
+    def test_stream_matches_one_shot(self):
+        """Any chunking of the stream yields the same bytes as one redact call."""
+        data = (SAMPLE.encode() + b" ") * 200
+        expected = pii_scanner_native.redact(data)
+        rng = random.Random(7)
+        for _ in range(20):
+            redactor = pii_scanner_native.Redactor()
+            out = []
+            pos = 0
+            while pos < len(data):
+                step = rng.randint(1, 64)
+                out.append(redactor.feed(data[pos:pos + step]))
+                pos += step
+            out.append(redactor.finish())
+            assert b"".join(out) == expected
+            assert redactor.matches == len(pii_scanner_native.scan(data))
+            assert redactor.pending == 0
+
+    def test_bad_mask(self):
+        """The mask must be one ASCII character."""
+        with pytest.raises(ValueError):
+            pii_scanner_native.redact(SAMPLE, mask="é")
+        with pytest.raises(ValueError):
+            pii_scanner_native.Redactor(mask="\x00")
+
+
+class TestPrivacyShield:
+    """Test the PrivacyShield's choice between the native scan and regex."""
+
+    def test_edited_patterns_take_regex_path(self):
+        """Runtime pattern edits apply even though the native tables are compiled in."""
+        from common.security.privacy_shield import PrivacyShield, PIIType
+
+        shield = PrivacyShield()
+        assert shield._native_scan_available()
+        assert "Jane Doe" not in asyncio.run(shield.mask_text(SAMPLE))
+
+        shield.name_patterns = []
+        shield.pii_patterns[PIIType.EMAIL].append(r'\bticket-\d+\b')
+        assert not shield._native_scan_available()
+        masked = asyncio.run(shield.mask_text(SAMPLE + " ticket-42"))
+        assert "Jane Doe" in masked and "ticket-42" not in masked
+        assert len(masked) == len(SAMPLE) + len(" ticket-42")
@@ -0,0 +1,174 @@
+"""
+Unit tests for the native RDP framing codec.
+
+Frames are >HHHH (length, type, channel, sequence) followed by the payload;
+the decoder must cope with any split of the byte stream across reads. Channel
+payloads may be bulk compressed with a history that spans packets.
+"""
+
+import os
+import socket
+import struct
+import zlib
+
+import pytest
+
+rdp_codec_native = pytest.importorskip("rdp_codec_native")
+
+
+def encode(frames):
+    """Reference encoder."""
+    return b"".join(
+        struct.pack(">HHHH", 8 + len(data), frame_type, channel, sequence) + data
+        for frame_type, channel, sequence, data in frames
+    )
+
+
+def sample_frames(count=200):
+    return [
+        (5, i % 7, i, os.urandom(i * 37 % 3000))
+        for i in range(count)
+    ]
+
+
+def as_bytes(decoded):
+    return [(t, c, s, bytes(d)) for t, c, s, d in decoded]
+
+
+class TestFrameDecoder:
+    """Test batch parsing and partial reads."""
+
+    def test_batch(self):
+        """One buffer with many frames yields all of them as views."""
+        frames = sample_frames()
+        decoder = rdp_codec_native.FrameDecoder()
+
+        decoded = decoder.feed(encode(frames))
+
+        assert as_bytes(decoded) == frames
+        assert all(isinstance(frame[3], memoryview) for frame in decoded)
+        assert decoder.pending == 0
+        assert decoder.frames_decoded == len(frames)
+
+    @pytest.mark.parametrize("read_size", [1, 3, 8, 9, 1000, 4096])
+    def test_split_reads(self, read_size):
+        """Frames split at any byte boundary come out whole and in order."""
+        frames = sample_frames(50)
+        stream = encode(frames)
+        decoder = rdp_codec_native.FrameDecoder()
+
+        decoded = []
+        for pos in range(0, len(stream), read_size):
+            decoded.extend(as_bytes(decoder.feed(stream[pos:pos + read_size])))
+
+        assert decoded == frames
+        assert decoder.pending == 0
+
+    def test_bad_length(self):
+        """A length shorter than the header is a protocol error."""
+        decoder = rdp_codec_native.FrameDecoder()
+        with pytest.raises(ValueError):
+            decoder.feed(struct.pack(">HHHH", 4, 5, 1, 0))
+        assert decoder.pending == 0
+
+
+class TestSendFrames:
+    """Test vectored sends."""
+
+    def test_round_trip(self):
+        """Frames written with sendmsg decode on the other end."""
+        frames = sample_frames(30)
+        left, right = socket.socketpair()
+        try:
+            total = len(encode(frames))
+            assert rdp_codec_native.send_frames(left.fileno(), frames) == total
+
+            decoder = rdp_codec_native.FrameDecoder()
+            decoded = []
+            while len(decoded) < len(frames):
+                decoded.extend(as_bytes(decoder.feed(right.recv(65536))))
+            assert decoded == frames
+        finally:
+            left.close()
+            right.close()
+
+    def test_partial_writes_resume_at_offset(self):
+        """A full socket buffer yields short writes that resume exactly."""
+        frames = [(5, 2, i, os.urandom(60_000)) for i in range(20)]
+        stream = encode(frames)
+        left, right = socket.socketpair()
+        left.setblocking(False)
+        try:
+            offset = 0
+            received = bytearray()
+            while offset < len(stream):
+                offset += rdp_codec_native.send_frames(left.fileno(), frames, offset)
+                received += right.recv(1 << 20)
+            while len(received) < len(stream):
+                received += right.recv(1 << 20)
+            assert bytes(received) == stream
+        finally:
+            left.close()
+            right.close()
+
+    def test_payload_too_large(self):
+        """Payloads must fit the 16-bit length field."""
+        with pytest.raises(ValueError):
+            rdp_codec_native.send_frames(0, [(5, 1, 0, b"x" * 70_000)])
+
+
+class TestBulkCompression:
+    """Test per-channel compression streams."""
+
+    def test_history_spans_packets(self):
+        """A repeat of an earlier packet compresses to back-references."""
+        compressor = rdp_codec_native.BulkCompressor()
+        decompressor = rdp_codec_native.BulkDecompressor()
+        packet = os.urandom(2000)
+
+        first = compressor.compress(packet)
+        second = compressor.compress(packet)
+
+        assert len(second) < len(first) // 10
+        assert decompressor.decompress(first) == packet
+        assert decompressor.decompress(second) == packet
+        assert compressor.packets == decompressor.packets == 2
+        assert compressor.bytes_in == decompressor.bytes_out == 4000
+
+    def test_wire_format_matches_zlib(self):
+        """Packets are raw deflate sync flushes without the 00 00 ff ff tail."""
+        compressor = rdp_codec_native.BulkCompressor(level=6)
+        reference = zlib.decompressobj(-15)
+
+        for i in range(20):
+            packet = b"clipboard entry %d " % (i % 3) * 40
+            compressed = compressor.compress(packet)
+            assert reference.decompress(compressed + b"\x00\x00\xff\xff") == packet
+
+    def test_expansion_limit(self):
+        """Packets that inflate past max_length are rejected."""
+        compressed = rdp_codec_native.BulkCompressor().compress(b"\0" * 60_000)
+
+        with pytest.raises(ValueError):
+            rdp_codec_native.BulkDecompressor().decompress(compressed, max_length=1000)
+        assert len(rdp_codec_native.BulkDecompressor().decompress(compressed)) == 60_000
+
+    def test_empty_packet_round_trip(self):
+        """Empty packets keep the stream in sync with zlib and the native decoder."""
+        compressor = rdp_codec_native.BulkCompressor()
+        decompressor = rdp_codec_native.BulkDecompressor()
+        reference = zlib.decompressobj(-15)
+
+        for packet in (b"", b"first" * 20, b"", b"", b"second" * 20, b""):
+            compressed = compressor.compress(packet)
+            assert compressed
+            assert decompressor.decompress(compressed) == packet
+            assert reference.decompress(compressed + b"\x00\x00\xff\xff") == packet
+
+        with pytest.raises(ValueError):
+            decompressor.decompress(b"")
+
+    def test_corrupt_packet(self):
+        """Garbage input is a ValueError, not a crash."""
+        with pytest.raises(ValueError):
+            rdp_codec_native.BulkDecompressor().decompress(b"\xff\xff\xff not deflate")
@@ -0,0 +1,131 @@
+"""
+Unit tests for the native telemetry codec.
+
+Blocks hold named, typed columns: delta-of-delta timestamps, bit-packed
+integers, Gorilla floats, dictionary strings and raw UUIDs, each with an
+optional null bitmap, behind a header with the body length and CRC-32.
+"""
+
+import importlib.util
+import math
+import struct
+import uuid
+import zlib
+from pathlib import Path
+
+import pytest
+
+telemetry_codec_native = pytest.importorskip("telemetry_codec_native")
+
+HEADER_SIZE = telemetry_codec_native.BLOCK_HEADER_SIZE
+TIMESTAMP = telemetry_codec_native.TIMESTAMP
+INT = telemetry_codec_native.INT
+FLOAT = telemetry_codec_native.FLOAT
+STRING = telemetry_codec_native.STRING
+UUID = telemetry_codec_native.UUID
+
+
+def round_trip(columns, kind=1):
+    """Encode columns and decode them back."""
+    block = telemetry_codec_native.encode_block(kind, columns)
+    decoded_kind, decoded, end = telemetry_codec_native.decode_block(block)
+    assert decoded_kind == kind
+    assert end == len(block)
+    return decoded
+
+
+class TestColumns:
+    """Test each column type."""
+
+    def test_all_types_with_nulls(self):
+        """Every type survives a round trip, nulls included."""
+        columns = [
+            ("ts", TIMESTAMP, [1_700_000_000_000_000, None, 1_700_000_000_100_000, 1_700_000_000_150_000]),
+            ("code", INT, [65, 66, None, -1]),
+            ("cpu", FLOAT, [12.5, 12.5, None, math.inf]),
+            ("app", STRING, ["code", None, "code", "bash"]),
+            ("id", UUID, [uuid.uuid4().bytes, uuid.uuid4().bytes, None, uuid.uuid4().bytes]),
+        ]
+        assert round_trip(columns) == columns
+
+    def test_extreme_integers(self):
+        """Integer and timestamp columns cover the full int64 range."""
+        values = [-(2 ** 63), 2 ** 63 - 1, 0, -1, 2 ** 63 - 1]
+        assert round_trip([("a", INT, values), ("b", TIMESTAMP, values)]) == [("a", INT, values), ("b", TIMESTAMP, values)]
+
+    def test_float_bits_preserved(self):
+        """Gorilla coding is lossless, down to NaN payloads and negative zero."""
+        values = [0.0, -0.0, 1e-300, struct.unpack("<d", struct.pack("<Q", 0x7FF8000000000123))[0], 3.14159]
+        _, _, decoded = round_trip([("f", FLOAT, values)])[0]
+        assert [struct.pack("<d", v) for v in decoded] == [struct.pack("<d", v) for v in values]
+
+    def test_regular_series_compact(self):
+        """Fixed-interval timestamps, counters and repeated names cost well under a byte each."""
+        n = 1000
+        block = telemetry_codec_native.encode_block(1, [
+            ("ts", TIMESTAMP, [1_700_000_000_000_000 + i * 100_000 for i in range(n)]),
+            ("bytes", INT, [10 ** 12 + i * 4096 for i in range(n)]),
+            ("app", STRING, ["code"] * n),
+            ("load", FLOAT, [0.5] * n),
+        ])
+        assert len(block) < 2 * n
+
+    def test_empty_block(self):
+        """Zero rows and zero columns both encode."""
+        assert round_trip([]) == []
+        assert round_trip([("a", INT, []), ("b", STRING, [])]) == [("a", INT, []), ("b", STRING, [])]
+
+
+class TestBlocks:
+    """Test block framing and validation."""
+
+    def test_concatenated_stream(self):
+        """decode_block returns the offset of the next block in a stream."""
+        first = telemetry_codec_native.encode_block(1, [("a", INT, [1, 2])])
+        second = telemetry_codec_native.encode_block(2, [("b", STRING, ["x"])])
+        stream = first + second
+
+        kind, columns, offset = telemetry_codec_native.decode_block(stream)
+        assert (kind, columns, offset) == (1, [("a", INT, [1, 2])], len(first))
+        kind, columns, offset = telemetry_codec_native.decode_block(stream, offset)
+        assert (kind, columns, offset) == (2, [("b", STRING, ["x"])], len(stream))
+
+    def test_read_blocks_stops_at_torn_block(self):
+        """A torn trailing block drops only itself, not the blocks before it."""
+        path = Path(__file__).resolve().parents[3] / "sessions" / "recorder" / "telemetry_codec.py"
+        spec = importlib.util.spec_from_file_location("telemetry_codec", path)
+        telemetry_codec = importlib.util.module_from_spec(spec)
+        spec.loader.exec_module(telemetry_codec)
+
+        blocks = [telemetry_codec_native.encode_block(1, [("a", INT, [i, i + 1])]) for i in range(3)]
+        stream = b"".join(blocks)
+
+        for cut in (1, HEADER_SIZE - 1, HEADER_SIZE + 1):
+            decoded = list(telemetry_codec.read_blocks(stream[:-cut]))
+            assert decoded == [(1, {"a": [0, 1]}), (1, {"a": [1, 2]})]
+        assert len(list(telemetry_codec.read_blocks(stream + bytes(64)))) == 3
+
+    def test_header_layout(self):
+        """The header carries the row count, body length and body CRC."""
+        block = telemetry_codec_native.encode_block(3, [("a", INT, [7, 8, 9])])
+        magic, version, kind, ncols, nrows, body_len, crc = struct.unpack_from("<IBBHIII", block)
+        assert (magic, version, kind, ncols, nrows) == (0x3142544C, 1, 3, 1, 3)
+        assert body_len == len(block) - HEADER_SIZE
+        assert crc == zlib.crc32(block[HEADER_SIZE:])
+
+    def test_corruption_rejected(self):
+        """Flipped bits and truncation raise ValueError."""
+        block = telemetry_codec_native.encode_block(1, [("a", STRING, ["abc", "def"])])
+        damaged = bytearray(block)
+        damaged[-1] ^= 0x01
+        with pytest.raises(ValueError):
+            telemetry_codec_native.decode_block(bytes(damaged))
+        with pytest.raises(ValueError):
+            telemetry_codec_native.decode_block(block[:-1])
+
+    def test_invalid_columns(self):
+        """Mismatched lengths and wrong value types are refused."""
+        with pytest.raises(ValueError):
+            telemetry_codec_native.encode_block(1, [("a", INT, [1]), ("b", INT, [1, 2])])
+        with pytest.raises(TypeError):
+            telemetry_codec_native.encode_block(1, [("a", UUID, [b"short"])])